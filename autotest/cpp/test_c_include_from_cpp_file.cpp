@@ -34,6 +34,7 @@ extern "C"
 #include "cpl_hash_set.h"
 #include "cpl_list.h"
 #include "cpl_minixml.h"
+#include "cpl_packed_rtree.h"
 #include "cpl_port.h"
 #include "cpl_progress.h"
 #include "cpl_quad_tree.h"
@@ -26,14 +26,19 @@
 
 #include "gdal_unit_test.h"
 
+#include <cpl_csv.h>
 #include <cpl_error.h>
 #include <cpl_hash_set.h>
 #include <cpl_list.h>
+#include <cpl_packed_rtree.h>
 #include <cpl_sha256.h>
 #include <cpl_string.h>
+#include <cpl_vsi.h>
 
 #include <fstream>
+#include <set>
 #include <string>
+#include <vector>
 
 static bool gbGotError = false;
 static void CPL_STDCALL myErrorHandler(CPLErr, CPLErrorNum, const char*)
@@ -1058,4 +1063,446 @@ namespace tut
         ensure_equals ( CPLString("abc",1).c_str(), "a" );
     }
 
+/************************************************************************/
+/*                Persistent index of archive content                  */
+/************************************************************************/
+    template<>
+    template<>
+    void object::test<22>()
+    {
+        // Create a zip with two files
+        VSILFILE* fpZip = VSIFOpenL("/vsizip//vsimem/test_cpl_22.zip", "wb");
+        ensure( fpZip != NULL );
+        const char* const apszFiles[] = { "a.txt", "subdir/b.txt" };
+        for( int i = 0; i < 2; i++ )
+        {
+            VSILFILE* fp = VSIFOpenL(
+                CPLSPrintf("/vsizip//vsimem/test_cpl_22.zip/%s",
+                           apszFiles[i]), "wb");
+            ensure( fp != NULL );
+            VSIFWriteL("foo", 1, 3, fp);
+            VSIFCloseL(fp);
+        }
+        VSIFCloseL(fpZip);
+
+        VSIMkdir("/vsimem/test_cpl_22_index", 0755);
+        CPLSetConfigOption("CPL_VSIL_ARCHIVE_INDEX_DIR",
+                           "/vsimem/test_cpl_22_index");
+
+        // Listing the archive saves its index
+        char** papszList = VSIReadDir("/vsizip//vsimem/test_cpl_22.zip");
+        ensure_equals( CSLCount(papszList), 2 );
+        CSLDestroy(papszList);
+
+        papszList = VSIReadDir("/vsimem/test_cpl_22_index");
+        ensure_equals( CSLCount(papszList), 1 );
+        const CPLString osIndex(
+            CPLFormFilename("/vsimem/test_cpl_22_index", papszList[0], NULL));
+        CSLDestroy(papszList);
+
+        // Reuse the saved index for a copy of the archive, after having
+        // patched its header and renamed an entry, to check that the
+        // archive is not scanned again.
+        vsi_l_offset nIndexSize = 0;
+        GByte* pabyIndex = VSIGetMemFileBuffer(osIndex, &nIndexSize, FALSE);
+        CPLString osContent(reinterpret_cast<const char*>(pabyIndex),
+                            static_cast<size_t>(nIndexSize));
+        ensure( osContent.find("subdir/b.txt\n") != std::string::npos );
+        osContent.replaceAll("/vsimem/test_cpl_22.zip",
+                             "/vsimem/test_cpl_22_copy.zip");
+        osContent.replaceAll(" a.txt\n", " renamed.txt\n");
+
+        vsi_l_offset nZipSize = 0;
+        GByte* pabyZip = VSIGetMemFileBuffer("/vsimem/test_cpl_22.zip",
+                                             &nZipSize, FALSE);
+        VSIFCloseL(VSIFileFromMemBuffer("/vsimem/test_cpl_22_copy.zip",
+                                        pabyZip, nZipSize, FALSE));
+
+        // The fourth line of the index is the modification time.
+        VSIStatBufL sStat;
+        ensure_equals( VSIStatL("/vsimem/test_cpl_22_copy.zip", &sStat), 0 );
+        char** papszLines = CSLTokenizeString2(osContent, "\n", 0);
+        ensure( CSLCount(papszLines) > 4 );
+        CPLFree(papszLines[3]);
+        papszLines[3] = CPLStrdup(
+            CPLSPrintf(CPL_FRMT_GIB, static_cast<GIntBig>(sStat.st_mtime)));
+        osContent.clear();
+        for( int i = 0; papszLines[i] != NULL; i++ )
+        {
+            osContent += papszLines[i];
+            osContent += "\n";
+        }
+        CSLDestroy(papszLines);
+
+        GByte abyHash[CPL_SHA256_HASH_SIZE];
+        const char* pszKey = "/vsizip//vsimem/test_cpl_22_copy.zip";
+        CPL_SHA256(pszKey, strlen(pszKey), abyHash);
+        CPLString osHash;
+        for( int i = 0; i < CPL_SHA256_HASH_SIZE; i++ )
+            osHash += CPLSPrintf("%02x", abyHash[i]);
+        VSILFILE* fp = VSIFOpenL(
+            CPLFormFilename("/vsimem/test_cpl_22_index", osHash, "idx"), "wb");
+        ensure( fp != NULL );
+        VSIFWriteL(osContent.data(), 1, osContent.size(), fp);
+        VSIFCloseL(fp);
+
+        ensure_equals( VSIStatL("/vsizip//vsimem/test_cpl_22_copy.zip/renamed.txt",
+                                &sStat), 0 );
+        ensure_equals( static_cast<int>(sStat.st_size), 3 );
+        ensure( VSIStatL("/vsizip//vsimem/test_cpl_22_copy.zip/a.txt",
+                         &sStat) != 0 );
+        fp = VSIFOpenL("/vsizip//vsimem/test_cpl_22_copy.zip/renamed.txt",
+                       "rb");
+        ensure( fp != NULL );
+        char szBuffer[4] = { 0 };
+        ensure_equals( static_cast<int>(VSIFReadL(szBuffer, 1, 3, fp)), 3 );
+        ensure_equals( std::string(szBuffer), std::string("foo") );
+        VSIFCloseL(fp);
+
+        CPLSetConfigOption("CPL_VSIL_ARCHIVE_INDEX_DIR", NULL);
+        VSIUnlink("/vsimem/test_cpl_22.zip");
+        VSIUnlink("/vsimem/test_cpl_22_copy.zip");
+        VSIUnlink(osIndex);
+        VSIUnlink(CPLFormFilename("/vsimem/test_cpl_22_index", osHash, "idx"));
+        VSIRmdir("/vsimem/test_cpl_22_index");
+    }
+
+/************************************************************************/
+/*                           CPLPackedRTree                            */
+/************************************************************************/
+    template<>
+    template<>
+    void object::test<23>()
+    {
+        // Grid of 100x100 unit squares, plus a few degenerate ones
+        const int nRects = 100 * 100 + 3;
+        std::vector<CPLRectObj> asRects(nRects);
+        for( int i = 0; i < 100 * 100; i++ )
+        {
+            asRects[i].minx = i % 100;
+            asRects[i].miny = i / 100;
+            asRects[i].maxx = asRects[i].minx + 1;
+            asRects[i].maxy = asRects[i].miny + 1;
+        }
+        for( int i = 100 * 100; i < nRects; i++ )
+        {
+            asRects[i].minx = asRects[i].maxx = 50.5;
+            asRects[i].miny = asRects[i].maxy = 50.5;
+        }
+
+        CPLPackedRTree* hTree = CPLPackedRTreeCreate(&asRects[0], nRects, 4);
+        ensure( hTree != NULL );
+        ensure_equals( CPLPackedRTreeGetFeatureCount(hTree), nRects );
+        CPLRectObj sExtent;
+        CPLPackedRTreeGetExtent(hTree, &sExtent);
+        ensure_equals( sExtent.maxx, 100.0 );
+
+        CPLRectObj asAois[3];
+        asAois[0].minx = 10.5; asAois[0].miny = 20.5;
+        asAois[0].maxx = 12.5; asAois[0].maxy = 20.7;
+        asAois[1].minx = 50.2; asAois[1].miny = 50.2;
+        asAois[1].maxx = 50.8; asAois[1].maxy = 50.8;
+        asAois[2].minx = -10; asAois[2].miny = -10;
+        asAois[2].maxx = -5; asAois[2].maxy = -5;
+
+        // Compare with a brute force search
+        for( int iAoi = 0; iAoi < 3; iAoi++ )
+        {
+            std::set<int> oExpected;
+            for( int i = 0; i < nRects; i++ )
+            {
+                if( !(asRects[i].minx > asAois[iAoi].maxx ||
+                      asRects[i].maxx < asAois[iAoi].minx ||
+                      asRects[i].miny > asAois[iAoi].maxy ||
+                      asRects[i].maxy < asAois[iAoi].miny) )
+                {
+                    oExpected.insert(i);
+                }
+            }
+            int nCount = 0;
+            int* panRes = CPLPackedRTreeSearch(hTree, &asAois[iAoi], &nCount);
+            std::set<int> oGot(panRes, panRes + nCount);
+            CPLFree(panRes);
+            ensure( oGot == oExpected );
+        }
+        int nCount = 0;
+        int* panRes = CPLPackedRTreeSearch(hTree, &asAois[0], &nCount);
+        ensure_equals( nCount, 3 );
+        CPLFree(panRes);
+
+        // Batch search
+        int* panFeatures = NULL;
+        int* panOffsets = NULL;
+        ensure( CPLPackedRTreeSearchBatch(hTree, asAois, 3,
+                                          &panFeatures, &panOffsets) );
+        ensure_equals( panOffsets[0], 0 );
+        ensure_equals( panOffsets[1], 3 );
+        ensure_equals( panOffsets[2], 3 + 4 );
+        ensure_equals( panOffsets[3], panOffsets[2] );
+        CPLFree(panFeatures);
+        CPLFree(panOffsets);
+
+        // Save and reload
+        ensure( CPLPackedRTreeSave(hTree, "/vsimem/test_cpl_23.bin") );
+        CPLPackedRTreeDestroy(hTree);
+        hTree = CPLPackedRTreeLoad("/vsimem/test_cpl_23.bin");
+        ensure( hTree != NULL );
+        panRes = CPLPackedRTreeSearch(hTree, &asAois[1], &nCount);
+        ensure_equals( nCount, 4 );
+        CPLFree(panRes);
+        CPLPackedRTreeDestroy(hTree);
+
+        // Truncated file: must be rejected from the header counts
+        VSILFILE* fp = VSIFOpenL("/vsimem/test_cpl_23.bin", "rb+");
+        ensure( fp != NULL );
+        ensure_equals( VSIFTruncateL(fp, 8 + 4 * 4 + 4), 0 );
+        VSIFCloseL(fp);
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        hTree = CPLPackedRTreeLoad("/vsimem/test_cpl_23.bin");
+        CPLPopErrorHandler();
+        ensure( hTree == NULL );
+        VSIUnlink("/vsimem/test_cpl_23.bin");
+
+        // Empty tree
+        hTree = CPLPackedRTreeCreate(NULL, 0, 0);
+        ensure( hTree != NULL );
+        ensure( CPLPackedRTreeSearch(hTree, &asAois[0], &nCount) == NULL );
+        ensure_equals( nCount, 0 );
+        CPLPackedRTreeDestroy(hTree);
+    }
+
+/************************************************************************/
+/*          CPLHashSet with colliding hashes and deferred rehash        */
+/************************************************************************/
+
+    static unsigned long badHashFunc(const void* elt)
+    {
+        // Only 16 different hash values to force long probe sequences
+        return static_cast<unsigned long>(*static_cast<const int*>(elt) % 16);
+    }
+
+    static int intEqualFunc(const void* elt1, const void* elt2)
+    {
+        return *static_cast<const int*>(elt1) == *static_cast<const int*>(elt2);
+    }
+
+    template<>
+    template<>
+    void object::test<24>()
+    {
+        const int HASH_SET_SIZE = 2000;
+        std::vector<int> data(HASH_SET_SIZE);
+        for( int i = 0; i < HASH_SET_SIZE; ++i )
+            data[i] = i;
+
+        CPLHashSet* set = CPLHashSetNew(badHashFunc, intEqualFunc, NULL);
+        CPLHashSetReserve(set, HASH_SET_SIZE);
+        for( int i = 0; i < HASH_SET_SIZE; i++ )
+            ensure( CPLHashSetInsert(set, &data[i]) == TRUE );
+        ensure_equals( CPLHashSetSize(set), HASH_SET_SIZE );
+
+        // Remove every third element, then check that all the other ones
+        // are still reachable.
+        for( int i = 0; i < HASH_SET_SIZE; i += 3 )
+            ensure( CPLHashSetRemoveDeferRehash(set, &data[i]) == TRUE );
+        for( int i = 0; i < HASH_SET_SIZE; i++ )
+        {
+            const int nVal = i;
+            ensure_equals( CPLHashSetLookup(set, &nVal) != NULL,
+                           (i % 3) != 0 );
+        }
+
+        // Remove almost everything to trigger shrinking
+        for( int i = 0; i < HASH_SET_SIZE - 5; i++ )
+            CPLHashSetRemove(set, &data[i]);
+        ensure_equals( CPLHashSetSize(set), 3 );
+        for( int i = HASH_SET_SIZE - 5; i < HASH_SET_SIZE; i++ )
+        {
+            ensure_equals( CPLHashSetLookup(set, &data[i]) != NULL,
+                           (i % 3) != 0 );
+        }
+
+        CPLHashSetClear(set);
+        ensure_equals( CPLHashSetSize(set), 0 );
+        ensure( CPLHashSetInsert(set, &data[1]) == TRUE );
+        ensure( CPLHashSetLookup(set, &data[1]) == &data[1] );
+
+        CPLHashSetDestroy(set);
+    }
+
+    // Test CSVSplitLineInPlace()
+    template<>
+    template<>
+    void object::test<25>()
+    {
+        struct TestCase
+        {
+            const char* pszLine;
+            bool bKeepQuotes;
+            bool bMergeDelimiter;
+            const char* apszExpected[6];
+        };
+        const TestCase asTestCases[] = {
+            { "", false, false, { NULL } },
+            { "a", false, false, { "a", NULL } },
+            { "a,b,,c,", false, false, { "a", "b", "", "c", "", NULL } },
+            { "a,,,b", false, true, { "a", "b", NULL } },
+            { "a,,", false, true, { "a", "", NULL } },
+            { "\"x,y\",z", false, false, { "x,y", "z", NULL } },
+            { "\"x,y\",z", true, false, { "\"x,y\"", "z", NULL } },
+            { "\"a \"\"quoted\"\" word\"", false, false,
+              { "a \"quoted\" word", NULL } },
+            { "1234567890123456789,\"12345678901234567,\"\"\"", false, false,
+              { "1234567890123456789", "12345678901234567,\"", NULL } },
+        };
+        for( size_t i = 0; i < CPL_ARRAYSIZE(asTestCases); i++ )
+        {
+            const TestCase& sCase = asTestCases[i];
+            std::vector<char> abyLine(sCase.pszLine,
+                                      sCase.pszLine + strlen(sCase.pszLine) + 1);
+            std::vector<char*> apszTokens;
+            const int nTokens = CSVSplitLineInPlace(
+                &abyLine[0], ',', sCase.bKeepQuotes, sCase.bMergeDelimiter,
+                apszTokens);
+            int nExpected = 0;
+            while( sCase.apszExpected[nExpected] != NULL )
+                nExpected++;
+            ensure_equals( sCase.pszLine, nTokens, nExpected );
+            ensure( apszTokens[nTokens] == NULL );
+            for( int j = 0; j < nTokens; j++ )
+            {
+                ensure_equals( sCase.pszLine,
+                               std::string(apszTokens[j]),
+                               std::string(sCase.apszExpected[j]) );
+            }
+        }
+    }
+
+    static void CPL_STDCALL CountingErrorHandler( CPLErr eErr, CPLErrorNum,
+                                                  const char* pszMsg )
+    {
+        std::vector<std::string>* paosMessages =
+            static_cast<std::vector<std::string>*>(
+                CPLGetErrorHandlerUserData());
+        paosMessages->push_back(
+            std::string(eErr == CE_Warning ? "W:" : "E:") + pszMsg);
+    }
+
+    // Test CPL_MAX_REPEATED_ERROR_REPORTS
+    template<>
+    template<>
+    void object::test<26>()
+    {
+        std::vector<std::string> aosMessages;
+        CPLSetThreadLocalConfigOption("CPL_MAX_REPEATED_ERROR_REPORTS", "2");
+        CPLPushErrorHandlerEx(CountingErrorHandler, &aosMessages);
+        for( int i = 0; i < 10; i++ )
+        {
+            CPLError(CE_Warning, CPLE_AppDefined, "Feature %d truncated", i);
+            ensure_equals( CPLGetLastErrorMsg(),
+                           std::string(CPLSPrintf("Feature %d truncated", i)) );
+        }
+        CPLError(CE_Failure, CPLE_AppDefined, "Other error");
+        CPLError(CE_Failure, CPLE_AppDefined, "Other error");
+        CPLPopErrorHandler();
+        CPLSetThreadLocalConfigOption("CPL_MAX_REPEATED_ERROR_REPORTS", NULL);
+        CPLErrorReset();
+
+        ensure_equals( aosMessages.size(), 5U );
+        ensure_equals( aosMessages[0], std::string("W:Feature 0 truncated") );
+        ensure_equals( aosMessages[1], std::string("W:Feature 1 truncated") );
+        ensure_equals( aosMessages[2], std::string(
+            "W:8 other message(s) similar to the previous one "
+            "were not reported.") );
+        ensure_equals( aosMessages[3], std::string("E:Other error") );
+        ensure_equals( aosMessages[4], std::string("E:Other error") );
+
+        // A run of repeated errors ending with CPLErrorReset() or with the
+        // pop of the error handler is still summarized.
+        aosMessages.clear();
+        CPLSetThreadLocalConfigOption("CPL_MAX_REPEATED_ERROR_REPORTS", "1");
+        CPLPushErrorHandlerEx(CountingErrorHandler, &aosMessages);
+        for( int i = 0; i < 3; i++ )
+            CPLError(CE_Warning, CPLE_AppDefined, "Feature %d truncated", i);
+        CPLErrorReset();
+        for( int i = 0; i < 4; i++ )
+            CPLError(CE_Failure, CPLE_AppDefined, "Feature %d invalid", i);
+        CPLPopErrorHandler();
+        CPLSetThreadLocalConfigOption("CPL_MAX_REPEATED_ERROR_REPORTS", NULL);
+        CPLErrorReset();
+
+        ensure_equals( aosMessages.size(), 4U );
+        ensure_equals( aosMessages[0], std::string("W:Feature 0 truncated") );
+        ensure_equals( aosMessages[1], std::string(
+            "W:2 other message(s) similar to the previous one "
+            "were not reported.") );
+        ensure_equals( aosMessages[2], std::string("E:Feature 0 invalid") );
+        ensure_equals( aosMessages[3], std::string(
+            "E:3 other message(s) similar to the previous one "
+            "were not reported.") );
+    }
+
+    // Test hashed key indexes of CSVScanFile() / CSVGetField()
+    template<>
+    template<>
+    void object::test<27>()
+    {
+        const char* pszFilename = "/vsimem/test_cpl_27.csv";
+        const char szContent[] =
+            "CODE,NAME,OTHER_CODE\n"
+            "10,First,300\n"
+            "20,\"Second, quoted\",100\n"
+            "# comment line\n"
+            "5,third,200\n"
+            "20,Duplicate,100\n"
+            "30,Short\n";
+        VSILFILE* fp = VSIFileFromMemBuffer(
+            pszFilename,
+            reinterpret_cast<GByte*>(const_cast<char*>(szContent)),
+            strlen(szContent), FALSE );
+        ensure( fp != NULL );
+        VSIFCloseL(fp);
+
+        // First column, on a table not sorted on it.
+        ensure_equals( std::string(CSVGetField( pszFilename, "CODE", "5",
+                                                CC_Integer, "NAME" )),
+                       std::string("third") );
+        ensure_equals( std::string(CSVGetField( pszFilename, "CODE", "20",
+                                                CC_Integer, "NAME" )),
+                       std::string("Second, quoted") );
+        // Non unique key: next line continues after the first match.
+        char** papszLine = CSVGetNextLine( pszFilename );
+        ensure( papszLine != NULL );
+        ensure_equals( std::string(papszLine[1]), std::string("third") );
+        ensure_equals( std::string(CSVGetField( pszFilename, "CODE", "7",
+                                                CC_Integer, "NAME" )),
+                       std::string("") );
+
+        // Other columns.
+        ensure_equals( std::string(CSVGetField( pszFilename, "OTHER_CODE",
+                                                "200", CC_Integer, "CODE" )),
+                       std::string("5") );
+        ensure_equals( std::string(CSVGetField( pszFilename, "OTHER_CODE",
+                                                "100", CC_Integer, "NAME" )),
+                       std::string("Second, quoted") );
+        ensure_equals( std::string(CSVGetField( pszFilename, "NAME",
+                                                "Third", CC_ExactString,
+                                                "CODE" )),
+                       std::string("") );
+        ensure_equals( std::string(CSVGetField( pszFilename, "NAME",
+                                                "Third", CC_ApproxString,
+                                                "CODE" )),
+                       std::string("5") );
+        ensure_equals( std::string(CSVGetField( pszFilename, "NAME",
+                                                "Short", CC_ExactString,
+                                                "CODE" )),
+                       std::string("30") );
+        ensure_equals( std::string(CSVGetField( pszFilename, "OTHER_CODE",
+                                                "0", CC_Integer, "CODE" )),
+                       std::string("") );
+
+        CSVDeaccess( pszFilename );
+        VSIUnlink( pszFilename );
+    }
+
 } // namespace tut
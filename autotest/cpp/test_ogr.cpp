@@ -26,8 +26,10 @@
 #include "gdal_unit_test.h"
 
 #include <ogrsf_frmts.h>
+#include "ogr_p.h"
 
 #include <string>
+#include <vector>
 
 namespace tut
 {
@@ -480,4 +482,907 @@ namespace tut
       OGR_SM_Destroy(hSM);
     }
 
+    // Compare a feature of a batch with a reference feature
+    static void ensure_batch_feature_equals( const OGRFeatureBatch& oBatch,
+                                             int iFeature,
+                                             OGRFeature* poRef )
+    {
+        ensure_equals( oBatch.GetFIDs()[iFeature], poRef->GetFID() );
+        OGRFeature* poGot = oBatch.GetFeature(iFeature);
+        for( int j = 0; j < poRef->GetFieldCount(); j++ )
+        {
+            ensure_equals( poGot->IsFieldSetAndNotNull(j) != FALSE,
+                           poRef->IsFieldSetAndNotNull(j) != FALSE );
+            ensure_equals( std::string(poGot->GetFieldAsString(j)),
+                           std::string(poRef->GetFieldAsString(j)) );
+        }
+        for( int j = 0; j < poRef->GetGeomFieldCount(); j++ )
+        {
+            OGRGeometry* poRefGeom = poRef->GetGeomFieldRef(j);
+            OGRGeometry* poGotGeom = poGot->GetGeomFieldRef(j);
+            ensure_equals( poGotGeom == NULL, poRefGeom == NULL );
+            if( poRefGeom != NULL )
+                ensure( poGotGeom->Equals(poRefGeom) );
+        }
+        delete poGot;
+    }
+
+    // Compare the features read with GetNextFeatureBatch() with the ones
+    // read with GetNextFeature()
+    static void ensure_batch_equals_features( OGRLayer* poLayer,
+                                              int nBatchSize )
+    {
+        std::vector<OGRFeature*> apoFeatures;
+        poLayer->ResetReading();
+        OGRFeature* poFeature = NULL;
+        while( (poFeature = poLayer->GetNextFeature()) != NULL )
+            apoFeatures.push_back(poFeature);
+
+        poLayer->ResetReading();
+        OGRFeatureBatch oBatch(poLayer->GetLayerDefn());
+        size_t iFeature = 0;
+        int nRead = 0;
+        while( (nRead = poLayer->GetNextFeatureBatch(&oBatch,
+                                                     nBatchSize)) > 0 )
+        {
+            ensure( nRead <= nBatchSize );
+            for( int i = 0; i < nRead; i++ )
+            {
+                ensure( iFeature < apoFeatures.size() );
+                ensure_batch_feature_equals(oBatch, i,
+                                            apoFeatures[iFeature++]);
+            }
+        }
+        ensure_equals( iFeature, apoFeatures.size() );
+
+        for( size_t i = 0; i < apoFeatures.size(); i++ )
+            delete apoFeatures[i];
+    }
+
+    // Test OGRFeatureBatch and OGRLayer::GetNextFeatureBatch()
+    template<>
+    template<>
+    void object::test<8>()
+    {
+        GDALDriver* poMemDrv =
+            GetGDALDriverManager()->GetDriverByName("Memory");
+        ensure( poMemDrv != NULL );
+        GDALDataset* poDS = poMemDrv->Create("", 0, 0, 0, GDT_Unknown, NULL);
+        OGRLayer* poLayer = poDS->CreateLayer("test", NULL, wkbUnknown, NULL);
+        const OGRFieldType aeTypes[] = { OFTInteger, OFTInteger64, OFTReal,
+                                         OFTString, OFTDate, OFTIntegerList,
+                                         OFTStringList, OFTBinary };
+        for( size_t i = 0; i < sizeof(aeTypes) / sizeof(aeTypes[0]); i++ )
+        {
+            OGRFieldDefn oField(CPLSPrintf("field%d", static_cast<int>(i)),
+                                aeTypes[i]);
+            ensure_equals( poLayer->CreateField(&oField), OGRERR_NONE );
+        }
+
+        OGRFeature* poFeature = new OGRFeature(poLayer->GetLayerDefn());
+        poFeature->SetField(0, 1);
+        poFeature->SetField(1, static_cast<GIntBig>(1234567890123LL));
+        poFeature->SetField(2, 1.5);
+        poFeature->SetField(3, "foo");
+        poFeature->SetField(4, 2018, 1, 2);
+        int anValues[] = { 1, 2, 3 };
+        poFeature->SetField(5, 3, anValues);
+        char** papszValues = CSLAddString(NULL, "a");
+        papszValues = CSLAddString(papszValues, "bc");
+        poFeature->SetField(6, papszValues);
+        CSLDestroy(papszValues);
+        GByte abyBinary[] = { 0x01, 0xFF };
+        poFeature->SetField(7, 2, abyBinary);
+        OGRPoint oPoint(1, 2);
+        poFeature->SetGeometry(&oPoint);
+        ensure_equals( poLayer->CreateFeature(poFeature), OGRERR_NONE );
+        delete poFeature;
+
+        poFeature = new OGRFeature(poLayer->GetLayerDefn());
+        poFeature->SetFieldNull(3);
+        ensure_equals( poLayer->CreateFeature(poFeature), OGRERR_NONE );
+        delete poFeature;
+
+        poFeature = new OGRFeature(poLayer->GetLayerDefn());
+        poFeature->SetField(0, 3);
+        poFeature->SetField(3, "");
+        OGRLineString oLS;
+        oLS.addPoint(0, 0);
+        oLS.addPoint(1, 1);
+        poFeature->SetGeometry(&oLS);
+        ensure_equals( poLayer->CreateFeature(poFeature), OGRERR_NONE );
+        delete poFeature;
+
+        {
+            OGRFeatureBatch oBatch(poLayer->GetLayerDefn());
+            ensure_equals( poLayer->GetNextFeatureBatch(&oBatch, 10), 3 );
+
+            ensure_equals( oBatch.GetFieldValidity(0)[0], 0x5 );
+            const int* panInt = static_cast<const int*>(oBatch.GetFieldData(0));
+            ensure_equals( panInt[0], 1 );
+            ensure_equals( panInt[1], 0 );
+            ensure_equals( panInt[2], 3 );
+            ensure_equals( static_cast<const GIntBig*>(
+                                oBatch.GetFieldData(1))[0], 1234567890123LL );
+            ensure_equals( static_cast<const double*>(
+                                oBatch.GetFieldData(2))[0], 1.5 );
+            ensure( oBatch.GetFieldOffsets(0) == NULL );
+
+            // Null and empty strings
+            ensure_equals( oBatch.GetFieldValidity(3)[0], 0x5 );
+            const size_t* panOffsets = oBatch.GetFieldOffsets(3);
+            ensure_equals( panOffsets[0], 0U );
+            ensure_equals( panOffsets[1], 3U );
+            ensure_equals( panOffsets[2], 3U );
+            ensure_equals( panOffsets[3], 3U );
+            ensure( memcmp(oBatch.GetFieldBytes(3), "foo", 3) == 0 );
+            ensure( oBatch.GetFieldData(3) == NULL );
+
+            const OGRField* psDate =
+                static_cast<const OGRField*>(oBatch.GetFieldData(4));
+            ensure_equals( psDate[0].Date.Year, 2018 );
+            ensure_equals( psDate[0].Date.Day, 2 );
+
+            ensure_equals( oBatch.GetFieldOffsets(5)[1], 3 * sizeof(int) );
+            ensure_equals( reinterpret_cast<const int*>(
+                                oBatch.GetFieldBytes(5))[2], 3 );
+            ensure_equals( oBatch.GetFieldOffsets(6)[1], 5U );
+            ensure( memcmp(oBatch.GetFieldBytes(6), "a\0bc\0", 5) == 0 );
+            ensure_equals( oBatch.GetFieldOffsets(7)[1], 2U );
+
+            ensure_equals( oBatch.GetGeomFieldValidity(0)[0], 0x5 );
+            panOffsets = oBatch.GetGeomFieldOffsets(0);
+            ensure_equals( panOffsets[1], 21U );
+            ensure_equals( panOffsets[2], 21U );
+            ensure_equals( panOffsets[3], 21U + 41U );
+            ensure_equals( oBatch.GetGeomFieldWKB(0)[0], wkbNDR );
+
+            ensure_equals( poLayer->GetNextFeatureBatch(&oBatch, 10), 0 );
+            ensure_equals( oBatch.GetFeatureCount(), 0 );
+        }
+
+        // Overwriting values and conversions
+        {
+            OGRFeatureBatch oBatch(poLayer->GetLayerDefn());
+            oBatch.AddFeature();
+            oBatch.SetField(3, "first");
+            oBatch.SetField(3, "xy");
+            oBatch.AddFeature();
+            oBatch.SetField(3, "z");
+            oBatch.SetField(0, "12");
+            oBatch.SetField(2, 5);
+            oBatch.AddFeature();
+            oBatch.SetField(3, "ignored");
+            oBatch.SetField(3, static_cast<const char*>(NULL));
+            ensure_equals( oBatch.GetFeatureCount(), 3 );
+            ensure_equals( oBatch.GetFieldOffsets(3)[2], 3U );
+            ensure_equals( oBatch.GetFieldOffsets(3)[3], 3U );
+            ensure( memcmp(oBatch.GetFieldBytes(3), "xyz", 3) == 0 );
+            ensure_equals( oBatch.GetFieldValidity(3)[0], 0x3 );
+            ensure_equals( oBatch.GetFieldValidity(0)[0], 0x2 );
+            ensure_equals( static_cast<const int*>(
+                                oBatch.GetFieldData(0))[1], 12 );
+            ensure_equals( static_cast<const double*>(
+                                oBatch.GetFieldData(2))[1], 5.0 );
+            ensure_equals( oBatch.GetGeomFieldValidity(0)[0], 0 );
+            oBatch.Reset();
+            ensure_equals( oBatch.GetFeatureCount(), 0 );
+
+            // Rows can be read as soon as they are added
+            oBatch.AddFeature();
+            const OGRFeatureBatch& oConstBatch = oBatch;
+            ensure_equals( oConstBatch.GetFieldValidity(0)[0], 0 );
+            ensure_equals( oConstBatch.GetFieldOffsets(3)[1], 0U );
+            ensure_equals( oConstBatch.GetGeomFieldOffsets(0)[1], 0U );
+            oBatch.SetField(3, "abc");
+            ensure_equals( oConstBatch.GetFieldValidity(3)[0], 0x1 );
+            ensure_equals( oConstBatch.GetFieldOffsets(3)[1], 3U );
+        }
+
+        ensure_batch_equals_features(poLayer, 2);
+
+        // GeoPackage
+        GDALDriver* poGPKGDrv = GetGDALDriverManager()->GetDriverByName("GPKG");
+        if( poGPKGDrv != NULL )
+        {
+            GDALDataset* poGPKGDS = poGPKGDrv->Create(
+                "/vsimem/test_ogr_8.gpkg", 0, 0, 0, GDT_Unknown, NULL);
+            ensure( poGPKGDS != NULL );
+            OGRLayer* poGPKGLayer = poGPKGDS->CopyLayer(poLayer, "test");
+            ensure( poGPKGLayer != NULL );
+            ensure_batch_equals_features(poGPKGLayer, 1);
+            ensure_batch_equals_features(poGPKGLayer, 100);
+            GDALClose(poGPKGDS);
+            poGPKGDrv->Delete("/vsimem/test_ogr_8.gpkg");
+        }
+
+        GDALClose(poDS);
+
+        // Shapefile
+        std::string osShp(tut::common::data_basedir);
+        osShp += SEP;
+        osShp += "poly.shp";
+        poDS = static_cast<GDALDataset*>(
+            GDALOpenEx(osShp.c_str(), GDAL_OF_VECTOR, NULL, NULL, NULL));
+        ensure( poDS != NULL );
+        ensure_batch_equals_features(poDS->GetLayer(0), 3);
+        ensure_batch_equals_features(poDS->GetLayer(0), 10);
+        GDALClose(poDS);
+
+        // OpenFileGDB
+        poDS = static_cast<GDALDataset*>(
+            GDALOpenEx("../ogr/data/testopenfilegdb.gdb.zip", GDAL_OF_VECTOR,
+                       NULL, NULL, NULL));
+        if( poDS != NULL )
+        {
+            for( int i = 0; i < poDS->GetLayerCount(); i++ )
+                ensure_batch_equals_features(poDS->GetLayer(i), 4);
+            GDALClose(poDS);
+        }
+    }
+
+    // Test OGRFeature::Reset() and growth of OGRSimpleCurve point arrays
+    template<>
+    template<>
+    void object::test<9>()
+    {
+        OGRFeatureDefn* poDefn = new OGRFeatureDefn();
+        poDefn->Reference();
+        OGRFieldDefn oFieldStr("str", OFTString);
+        poDefn->AddFieldDefn(&oFieldStr);
+        OGRFieldDefn oFieldIntList("intlist", OFTIntegerList);
+        poDefn->AddFieldDefn(&oFieldIntList);
+        {
+            OGRFeature oFeature(poDefn);
+            oFeature.SetFID(1);
+            oFeature.SetField(0, "foo");
+            int anVals[] = { 1, 2 };
+            oFeature.SetField(1, 2, anVals);
+            oFeature.SetGeometryDirectly(new OGRPoint(1, 2));
+            oFeature.SetStyleString("PEN(c:#FF0000)");
+            oFeature.SetNativeData("{}");
+            oFeature.SetNativeMediaType("application/json");
+            oFeature.Reset();
+            ensure_equals( oFeature.GetFID(), OGRNullFID );
+            ensure( !oFeature.IsFieldSet(0) );
+            ensure( !oFeature.IsFieldSet(1) );
+            ensure( oFeature.GetGeometryRef() == NULL );
+            ensure( oFeature.GetStyleString() == NULL );
+            ensure( oFeature.GetNativeData() == NULL );
+            ensure( oFeature.GetNativeMediaType() == NULL );
+            ensure( oFeature.GetDefnRef() == poDefn );
+            oFeature.SetField(0, "bar");
+            ensure_equals( std::string(oFeature.GetFieldAsString(0)),
+                           std::string("bar") );
+        }
+        poDefn->Release();
+
+        OGRLineString oLS;
+        for( int i = 0; i < 1000; i++ )
+            oLS.addPoint(i, -i);
+        ensure_equals( oLS.getNumPoints(), 1000 );
+        for( int i = 0; i < 1000; i++ )
+        {
+            ensure_equals( oLS.getX(i), i );
+            ensure_equals( oLS.getY(i), -i );
+        }
+        // Shrinking then growing again must zero the new points.
+        oLS.setNumPoints(10);
+        oLS.setNumPoints(20);
+        ensure_equals( oLS.getX(15), 0.0 );
+        // Z and M arrays added after the capacity has grown must cover it.
+        oLS.addPoint(1, 2, 3);
+        oLS.setMeasured(TRUE);
+        oLS.setNumPoints(900);
+        oLS.setPointM(899, 4, 5, 6);
+        ensure_equals( oLS.getZ(20), 3.0 );
+        ensure_equals( oLS.getZ(899), 0.0 );
+        ensure_equals( oLS.getM(899), 6.0 );
+        OGRLineString* poClone = static_cast<OGRLineString*>(oLS.clone());
+        ensure( poClone->Equals(&oLS) );
+        delete poClone;
+    }
+
+    // Test OGRGeometryFactory::organizePolygons() with many parts
+    template<>
+    template<>
+    void object::test<10>()
+    {
+        std::string osRef;
+        const char* const apszThreads[] = { "1", "4" };
+        for( int iRun = 0; iRun < 2; iRun++ )
+        {
+            // A grid of 20x20 squares, each with a hole, with an island
+            // inside the holes of the even ones.
+            std::vector<OGRGeometry*> apoRings;
+            for( int i = 0; i < 400; i++ )
+            {
+                const double dfX = (i % 20) * 10;
+                const double dfY = (i / 20) * 10;
+                for( int iRing = 0; iRing < ((i % 2) == 0 ? 3 : 2); iRing++ )
+                {
+                    const double dfMargin = 1 + 2 * iRing;
+                    OGRLinearRing* poLR = new OGRLinearRing();
+                    poLR->addPoint(dfX + dfMargin, dfY + dfMargin);
+                    poLR->addPoint(dfX + dfMargin, dfY + 10 - dfMargin);
+                    poLR->addPoint(dfX + 10 - dfMargin, dfY + 10 - dfMargin);
+                    poLR->addPoint(dfX + 10 - dfMargin, dfY + dfMargin);
+                    poLR->addPoint(dfX + dfMargin, dfY + dfMargin);
+                    OGRPolygon* poPoly = new OGRPolygon();
+                    poPoly->addRingDirectly(poLR);
+                    apoRings.push_back(poPoly);
+                }
+            }
+            CPLSetConfigOption("OGR_ORGANIZE_POLYGONS_NUM_THREADS",
+                               apszThreads[iRun]);
+            const char* apszOptions[] = { "METHOD=DEFAULT", NULL };
+            int bIsValid = FALSE;
+            OGRGeometry* poGeom = OGRGeometryFactory::organizePolygons(
+                &apoRings[0], static_cast<int>(apoRings.size()), &bIsValid,
+                apszOptions);
+            CPLSetConfigOption("OGR_ORGANIZE_POLYGONS_NUM_THREADS", NULL);
+            ensure( bIsValid != FALSE );
+            ensure_equals( wkbFlatten(poGeom->getGeometryType()),
+                           wkbMultiPolygon );
+            OGRMultiPolygon* poMP = static_cast<OGRMultiPolygon*>(poGeom);
+            ensure_equals( poMP->getNumGeometries(), 600 );
+            ensure_equals( static_cast<OGRPolygon*>(
+                poMP->getGeometryRef(0))->getNumInteriorRings(), 1 );
+            ensure_equals( static_cast<OGRPolygon*>(
+                poMP->getGeometryRef(1))->getNumInteriorRings(), 0 );
+            char* pszWKT = NULL;
+            poGeom->exportToWkt(&pszWKT);
+            if( iRun == 0 )
+                osRef = pszWKT;
+            else
+                ensure( osRef == pszWKT );
+            CPLFree(pszWKT);
+            delete poGeom;
+        }
+    }
+
+    // Simple transformation used to test
+    // OGRGeometryFactory::transformGeometries(): points with negative X
+    // fail to transform. With bFailAll, the whole call fails when a point
+    // fails, as PROJ does for some errors.
+    class OGRTestShiftCT : public OGRCoordinateTransformation
+    {
+        bool m_bFailAll;
+
+      public:
+        explicit OGRTestShiftCT( bool bFailAll = false ) :
+            m_bFailAll(bFailAll) {}
+
+        virtual OGRSpatialReference *GetSourceCS() override { return NULL; }
+        virtual OGRSpatialReference *GetTargetCS() override { return NULL; }
+        virtual int Transform( int nCount, double *x, double *y,
+                               double *z = NULL ) override
+        {
+            std::vector<int> abSuccess(nCount + 1);
+            TransformEx(nCount, x, y, z, &abSuccess[0]);
+            for( int i = 0; i < nCount; i++ )
+            {
+                if( !abSuccess[i] )
+                    return FALSE;
+            }
+            return TRUE;
+        }
+        virtual int TransformEx( int nCount, double *x, double *y,
+                                 double *z = NULL,
+                                 int *pabSuccess = NULL ) override
+        {
+            for( int i = 0; i < nCount; i++ )
+            {
+                const bool bOK = x[i] >= 0;
+                if( bOK )
+                {
+                    x[i] += 1000;
+                    y[i] *= 2;
+                    if( z )
+                        z[i] += 10;
+                }
+                else
+                {
+                    x[i] = HUGE_VAL;
+                    y[i] = HUGE_VAL;
+                }
+                if( pabSuccess )
+                    pabSuccess[i] = bOK;
+                if( !bOK && m_bFailAll )
+                {
+                    if( pabSuccess )
+                        memset(pabSuccess, 0, sizeof(int) * nCount);
+                    return FALSE;
+                }
+            }
+            return TRUE;
+        }
+        virtual OGRCoordinateTransformation *Clone() const override
+        {
+            return new OGRTestShiftCT(m_bFailAll);
+        }
+    };
+
+    static OGRGeometry* CreateGeometryFromWkt( const char* pszWKT )
+    {
+        char* pszWKTTmp = const_cast<char*>(pszWKT);
+        OGRGeometry* poGeom = NULL;
+        OGRGeometryFactory::createFromWkt(&pszWKTTmp, NULL, &poGeom);
+        return poGeom;
+    }
+
+    // Test OGRGeometryFactory::transformGeometries()
+    template<>
+    template<>
+    void object::test<11>()
+    {
+        const char* const apszWKT[] = {
+            "POINT (1 2)",
+            "POINT Z (1 2 3)",
+            "LINESTRING (0 0,1 1,2 0)",
+            "LINESTRING Z (0 0 1,1 1 2)",
+            "LINESTRING EMPTY",
+            "POLYGON ((0 0,0 10,10 10,10 0,0 0),(1 1,1 2,2 2,2 1,1 1))",
+            "MULTIPOLYGON (((0 0,0 1,1 1,0 0)),((5 5,5 6,6 6,5 5)))",
+            "GEOMETRYCOLLECTION (POINT (1 1),LINESTRING (2 2,3 3))",
+            "LINESTRING (0 0,-1 1,2 0)",
+            "GEOMETRYCOLLECTION (POINT (1 1),POINT (-1 1))",
+            "CIRCULARSTRING (0 0,1 1,2 0)",
+            "COMPOUNDCURVE ((0 0,1 1),CIRCULARSTRING (1 1,2 2,3 1))",
+        };
+        const int nWKT = static_cast<int>(CPL_ARRAYSIZE(apszWKT));
+        const int nRepeat = 1000;
+
+        const char* const apszThreads[] = { "1", "3", "1", "3" };
+        for( size_t iRun = 0; iRun < CPL_ARRAYSIZE(apszThreads); iRun++ )
+        {
+            const bool bFailAll = iRun >= 2;
+            std::vector<OGRGeometry*> apoGeoms;
+            for( int i = 0; i < nRepeat * nWKT; i++ )
+            {
+                OGRGeometry* poGeom = NULL;
+                if( i % 97 != 0 )
+                {
+                    poGeom = CreateGeometryFromWkt(apszWKT[i % nWKT]);
+                    ensure( poGeom != NULL );
+                }
+                apoGeoms.push_back(poGeom);
+            }
+
+            OGRTestShiftCT oCT(bFailAll);
+            std::vector<int> abSuccess(apoGeoms.size());
+            CPLStringList aosOptions;
+            aosOptions.SetNameValue("NUM_THREADS", apszThreads[iRun]);
+            const int bRet = OGRGeometryFactory::transformGeometries(
+                &apoGeoms[0], static_cast<int>(apoGeoms.size()), &oCT,
+                &abSuccess[0], aosOptions.List());
+            ensure_equals( bRet, FALSE );
+
+            for( size_t i = 0; i < apoGeoms.size(); i++ )
+            {
+                if( apoGeoms[i] == NULL )
+                {
+                    ensure_equals( abSuccess[i], FALSE );
+                    continue;
+                }
+                OGRGeometry* poExpected =
+                    CreateGeometryFromWkt(apszWKT[i % nWKT]);
+                CPLPushErrorHandler(CPLQuietErrorHandler);
+                const bool bExpectSuccess =
+                    poExpected->transform(&oCT) == OGRERR_NONE;
+                CPLPopErrorHandler();
+                ensure_equals( abSuccess[i] != FALSE, bExpectSuccess );
+                if( !bExpectSuccess )
+                {
+                    delete poExpected;
+                    poExpected = CreateGeometryFromWkt(apszWKT[i % nWKT]);
+                }
+                ensure( CPL_TO_BOOL(apoGeoms[i]->Equals(poExpected)) );
+                ensure_equals( apoGeoms[i]->getCoordinateDimension(),
+                               poExpected->getCoordinateDimension() );
+                delete poExpected;
+                delete apoGeoms[i];
+            }
+        }
+    }
+
+    // Test OGRIndexedPreparedGeometry
+    template<>
+    template<>
+    void object::test<12>()
+    {
+        struct Case
+        {
+            const char* pszFilter;
+            const char* pszGeom;
+            int         nExpected;
+        };
+        const Case asCases[] = {
+            // Segment crossing the rectangle without vertex inside it.
+            { "POLYGON ((0 0,0 10,10 10,10 0,0 0))",
+              "LINESTRING (-1 5,11 6)", TRUE },
+            { "POLYGON ((0 0,0 10,10 10,10 0,0 0))",
+              "LINESTRING (-1 11,11 12)", FALSE },
+            // Candidate polygon containing the rectangle.
+            { "POLYGON ((0 0,0 10,10 10,10 0,0 0))",
+              "POLYGON ((-1 -1,-1 11,11 11,11 -1,-1 -1))", TRUE },
+            // Triangle: envelopes intersect, but not geometries.
+            { "POLYGON ((0 0,10 10,10 0,0 0))",
+              "POINT (1 9)", FALSE },
+            { "POLYGON ((0 0,10 10,10 0,0 0))",
+              "POINT (9 1)", TRUE },
+            // Point on the boundary.
+            { "POLYGON ((0 0,10 10,10 0,0 0))",
+              "POINT (5 5)", TRUE },
+            // Polygon with a hole.
+            { "POLYGON ((0 0,0 10,10 10,0 0),(1 3,1 8,6 8,1 3))",
+              "POINT (2 7)", FALSE },
+            { "POLYGON ((0 0,0 10,10 10,0 0),(1 3,1 8,6 8,1 3))",
+              "LINESTRING (2 7,0.5 7)", TRUE },
+            { "POLYGON ((0 0,0 10,10 10,0 0),(1 3,1 8,6 8,1 3))",
+              "POLYGON ((2 6,2 7,3 7,2 6))", FALSE },
+            // Filter inside the candidate polygon.
+            { "POLYGON ((0 0,10 10,10 0,0 0))",
+              "POLYGON ((-5 -5,-5 20,20 20,20 -5,-5 -5))", TRUE },
+            { "POLYGON ((0 0,10 10,10 0,0 0))",
+              "POLYGON ((-5 -5,-5 20,20 20,20 -5,-5 -5),"
+              "(-2 -1,12 13,12 -1,-2 -1))", FALSE },
+            // Multi geometries.
+            { "MULTIPOLYGON (((0 0,0 1,1 1,1 0,0 0)),"
+              "((10 10,10 11,11 11,11 10,10 10)))",
+              "POINT (5 5)", FALSE },
+            { "MULTIPOLYGON (((0 0,0 1,1 1,1 0,0 0)),"
+              "((10 10,10 11,11 11,11 10,10 10)))",
+              "MULTIPOINT (5 5,10.5 10.5)", TRUE },
+            { "MULTILINESTRING ((0 0,10 10),(0 10,1 9))",
+              "LINESTRING (5 0,6 1)", FALSE },
+            { "MULTILINESTRING ((0 0,10 10),(0 10,1 9))",
+              "LINESTRING (0 9,2 9)", TRUE },
+            { "LINESTRING (0 0,10 10)",
+              "POLYGON ((1 0,1 5,9 5,9 0,1 0))", TRUE },
+            { "LINESTRING (0 0,10 10)",
+              "POLYGON ((5 0,5 4,9 4,9 0,5 0))", FALSE },
+            // Curve geometries are linearized.
+            { "CURVEPOLYGON (CIRCULARSTRING (0 0,10 0,0 0))",
+              "POINT (5 0)", TRUE },
+            { "CURVEPOLYGON (CIRCULARSTRING (0 0,10 0,0 0))",
+              "POINT (9 4.9)", FALSE },
+        };
+        for( size_t i = 0; i < CPL_ARRAYSIZE(asCases); i++ )
+        {
+            OGRGeometry* poFilter = CreateGeometryFromWkt(asCases[i].pszFilter);
+            OGRGeometry* poGeom = CreateGeometryFromWkt(asCases[i].pszGeom);
+            ensure( poFilter != NULL && poGeom != NULL );
+            OGRIndexedPreparedGeometry* poPrepared =
+                OGRIndexedPreparedGeometry::Create(poFilter);
+            ensure( poPrepared != NULL );
+            ensure_equals( std::string(asCases[i].pszFilter) + " / " +
+                               asCases[i].pszGeom,
+                           poPrepared->Intersects(poGeom),
+                           asCases[i].nExpected );
+            delete poPrepared;
+            delete poGeom;
+            delete poFilter;
+        }
+
+        // Rectangle filter.
+        {
+            OGRGeometry* poFilter =
+                CreateGeometryFromWkt("POLYGON ((0 0,0 10,10 10,10 0,0 0))");
+            OGRIndexedPreparedGeometry* poPrepared =
+                OGRIndexedPreparedGeometry::Create(poFilter, true);
+            ensure( poPrepared != NULL );
+            OGRGeometry* poGeom =
+                CreateGeometryFromWkt("LINESTRING (-1 5,5 -1)");
+            ensure_equals( poPrepared->Intersects(poGeom), TRUE );
+            delete poGeom;
+            poGeom = CreateGeometryFromWkt("LINESTRING (-1 1,1 -1.5)");
+            ensure_equals( poPrepared->Intersects(poGeom), FALSE );
+            delete poGeom;
+            delete poPrepared;
+            delete poFilter;
+        }
+
+        // Unhandled geometry types.
+        {
+            OGRGeometry* poFilter =
+                CreateGeometryFromWkt("POLYGON ((0 0,0 10,10 10,10 0,0 0))");
+            OGRIndexedPreparedGeometry* poPrepared =
+                OGRIndexedPreparedGeometry::Create(poFilter);
+            OGRGeometry* poGeom = CreateGeometryFromWkt(
+                "TIN (((0 0,0 1,1 1,0 0)))");
+            ensure_equals( poPrepared->Intersects(poGeom), -1 );
+            delete poGeom;
+            delete poPrepared;
+            delete poFilter;
+            poFilter = CreateGeometryFromWkt("POINT EMPTY");
+            ensure( OGRIndexedPreparedGeometry::Create(poFilter) == NULL );
+            delete poFilter;
+        }
+
+        // Layer spatial filter.
+        GDALDriver* poDrv =
+            GetGDALDriverManager()->GetDriverByName("Memory");
+        ensure( poDrv != NULL );
+        GDALDataset* poDS = poDrv->Create("", 0, 0, 0, GDT_Unknown, NULL);
+        OGRLayer* poLayer = poDS->CreateLayer("test");
+        for( int i = 0; i < 10; i++ )
+        {
+            for( int j = 0; j < 10; j++ )
+            {
+                OGRFeature* poFeature =
+                    new OGRFeature(poLayer->GetLayerDefn());
+                poFeature->SetGeometryDirectly(
+                    new OGRPoint(i + 0.5, j + 0.5));
+                ensure_equals( poLayer->CreateFeature(poFeature),
+                               OGRERR_NONE );
+                delete poFeature;
+            }
+        }
+        OGRGeometry* poFilter =
+            CreateGeometryFromWkt("POLYGON ((0 0,10 10,10 0,0 0))");
+        poLayer->SetSpatialFilter(poFilter);
+        // Without GEOS the filter used to only test envelopes.
+        ensure_equals( poLayer->GetFeatureCount(), 55 );
+        delete poFilter;
+        poFilter = CreateGeometryFromWkt("POLYGON ((2 2,2 4,4 4,4 2,2 2))");
+        poLayer->SetSpatialFilter(poFilter);
+        ensure_equals( poLayer->GetFeatureCount(), 4 );
+        delete poFilter;
+        GDALClose(poDS);
+    }
+
+    // Test OGRWKBGeometryView
+    template<>
+    template<>
+    void object::test<13>()
+    {
+        const char* const apszWKT[] = {
+            "POINT (1 2)",
+            "POINT ZM (1 2 3 4)",
+            "POINT EMPTY",
+            "LINESTRING Z (1 2 3,3 -4 -5)",
+            "POLYGON ((0 0,0 1,1 1,0 0),(0.1 0.1,0.2 0.1,0.1 0.2,0.1 0.1))",
+            "MULTIPOINT (1 2,-3 4)",
+            "MULTIPOLYGON EMPTY",
+            "GEOMETRYCOLLECTION (POINT EMPTY,"
+                "GEOMETRYCOLLECTION (LINESTRING (5 5,6 -6)))",
+            "COMPOUNDCURVE ((0 0,1 1),CIRCULARSTRING (1 1,2 2,3 1))",
+            "CURVEPOLYGON (CIRCULARSTRING (0 0,10 0,0 0))",
+            "TIN Z (((0 0 1,0 1 2,1 1 3,0 0 1)))",
+        };
+        for( size_t i = 0; i < CPL_ARRAYSIZE(apszWKT); i++ )
+        {
+            OGRGeometry* poGeom = CreateGeometryFromWkt(apszWKT[i]);
+            ensure( poGeom != NULL );
+            for( int iOrder = 0; iOrder < 2; iOrder++ )
+            {
+                std::vector<GByte> abyWKB(poGeom->WkbSize() + 10);
+                ensure_equals( poGeom->exportToWkb(
+                                   iOrder == 0 ? wkbNDR : wkbXDR,
+                                   &abyWKB[0], wkbVariantIso),
+                               OGRERR_NONE );
+
+                OGRWKBGeometryView oView;
+                ensure_equals( oView.Init(&abyWKB[0], abyWKB.size()),
+                               OGRERR_NONE );
+                ensure_equals( apszWKT[i], oView.getGeometryType(),
+                               poGeom->getGeometryType() );
+                ensure_equals( apszWKT[i], oView.WkbSize(),
+                               static_cast<size_t>(poGeom->WkbSize()) );
+                ensure_equals( apszWKT[i], oView.IsEmpty(),
+                               poGeom->IsEmpty() );
+                if( !poGeom->IsEmpty() )
+                {
+                    OGREnvelope3D sExpected;
+                    poGeom->getEnvelope(&sExpected);
+                    OGREnvelope3D sEnvelope;
+                    oView.getEnvelope(&sEnvelope);
+                    ensure_equals( apszWKT[i], sEnvelope.MinX, sExpected.MinX );
+                    ensure_equals( apszWKT[i], sEnvelope.MinY, sExpected.MinY );
+                    ensure_equals( apszWKT[i], sEnvelope.MinZ, sExpected.MinZ );
+                    ensure_equals( apszWKT[i], sEnvelope.MaxX, sExpected.MaxX );
+                    ensure_equals( apszWKT[i], sEnvelope.MaxY, sExpected.MaxY );
+                    ensure_equals( apszWKT[i], sEnvelope.MaxZ, sExpected.MaxZ );
+                }
+
+                GUIntBig nPoints = 0;
+                double dfX = 0.0;
+                double dfY = 0.0;
+                double dfZ = 0.0;
+                double dfM = 0.0;
+                while( oView.GetNextPoint(&dfX, &dfY, &dfZ, &dfM) )
+                {
+                    if( nPoints == 0 && i == 1 )
+                    {
+                        ensure_equals( dfX, 1.0 );
+                        ensure_equals( dfY, 2.0 );
+                        ensure_equals( dfZ, 3.0 );
+                        ensure_equals( dfM, 4.0 );
+                    }
+                    nPoints++;
+                }
+                ensure_equals( apszWKT[i], nPoints, oView.getNumPoints() );
+
+                // Truncated buffers are rejected.
+                for( size_t nSize = 0; nSize < oView.WkbSize(); nSize++ )
+                {
+                    OGRWKBGeometryView oTruncatedView;
+                    ensure( oTruncatedView.Init(&abyWKB[0], nSize) !=
+                                                            OGRERR_NONE );
+                }
+            }
+            delete poGeom;
+        }
+
+        // The lowest point of the second arc must not replace the one of
+        // the first arc.
+        {
+            OGRGeometry* poGeom = CreateGeometryFromWkt(
+                "CIRCULARSTRING (0 0,5 -100,10 0,11 -1,12 0)");
+            ensure( poGeom != NULL );
+            OGREnvelope sEnvelope;
+            poGeom->getEnvelope(&sEnvelope);
+            ensure( sEnvelope.MinY <= -100 );
+            std::vector<GByte> abyWKB(poGeom->WkbSize());
+            poGeom->exportToWkb(wkbNDR, &abyWKB[0], wkbVariantIso);
+            OGRWKBGeometryView oView;
+            ensure_equals( oView.Init(&abyWKB[0], abyWKB.size()),
+                           OGRERR_NONE );
+            OGREnvelope sViewEnvelope;
+            oView.getEnvelope(&sViewEnvelope);
+            ensure_equals( sViewEnvelope.MinY, sEnvelope.MinY );
+            delete poGeom;
+        }
+
+        // Unknown geometry type.
+        const GByte abyWKB[] = { wkbNDR, 99, 0, 0, 0 };
+        OGRWKBGeometryView oView;
+        ensure_equals( oView.Init(abyWKB, sizeof(abyWKB)),
+                       OGRERR_CORRUPT_DATA );
+    }
+
+    // Test OGRFeatureQuery::EvaluateBatch() and OGRFeatureBatch::Compact()
+    template<>
+    template<>
+    void object::test<14>()
+    {
+        OGRFeatureDefn* poDefn = new OGRFeatureDefn("test");
+        poDefn->Reference();
+        OGRFieldDefn oFieldInt("int", OFTInteger);
+        poDefn->AddFieldDefn(&oFieldInt);
+        OGRFieldDefn oFieldInt64("int64", OFTInteger64);
+        poDefn->AddFieldDefn(&oFieldInt64);
+        OGRFieldDefn oFieldReal("real", OFTReal);
+        poDefn->AddFieldDefn(&oFieldReal);
+        OGRFieldDefn oFieldStr("str", OFTString);
+        poDefn->AddFieldDefn(&oFieldStr);
+        OGRFieldDefn oFieldDate("date", OFTDate);
+        poDefn->AddFieldDefn(&oFieldDate);
+
+        // Features with unset, null and set fields.
+        const int nFeatures = 40;
+        std::vector<OGRFeature*> apoFeatures;
+        OGRFeatureBatch oBatch(poDefn);
+        for( int i = 0; i < nFeatures; i++ )
+        {
+            OGRFeature* poFeature = new OGRFeature(poDefn);
+            poFeature->SetFID(100 + i);
+            for( int j = 0; j < poDefn->GetFieldCount(); j++ )
+            {
+                if( (i + j) % 7 == 0 )
+                    continue;
+                if( (i + j) % 5 == 0 )
+                {
+                    poFeature->SetFieldNull(j);
+                    continue;
+                }
+                switch( j )
+                {
+                    case 0: poFeature->SetField(j, i % 10); break;
+                    case 1: poFeature->SetField(j,
+                                static_cast<GIntBig>(i) * 1000000000); break;
+                    case 2: poFeature->SetField(j, i * 0.25); break;
+                    case 3: poFeature->SetField(j,
+                                CPLSPrintf("%c%d", 'a' + i % 3, i)); break;
+                    default: poFeature->SetField(j, 2018, 1, 1 + i % 28);
+                             break;
+                }
+            }
+            ensure_equals( oBatch.AddFeature(poFeature), OGRERR_NONE );
+            apoFeatures.push_back(poFeature);
+        }
+
+        const char* const apszExpr[] = {
+            "int = 3",
+            "int <> 3",
+            "int IN (1, 5, 7)",
+            "int NOT IN (1, 5, 7)",
+            "str IN ('a3', 'b4', 'c5')",
+            "str LIKE 'a%'",
+            "str NOT LIKE '%1_'",
+            "str ILIKE 'B%'",
+            "real BETWEEN 1.5 AND 5",
+            "int64 BETWEEN 3000000000 AND 20000000000",
+            "int IS NULL",
+            "str IS NOT NULL",
+            "date > '2018/01/10'",
+            "int > 2 AND (str LIKE 'c%' OR real < 3)",
+            "NOT (int >= 5) OR int64 < 2000000000",
+            "int + 1 > 4",
+            "FID >= 120",
+        };
+        std::vector<GByte> abyResults(nFeatures);
+        // Comparisons of null dates emit errors.
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        for( size_t i = 0; i < CPL_ARRAYSIZE(apszExpr); i++ )
+        {
+            OGRFeatureQuery oQuery;
+            ensure_equals( apszExpr[i], oQuery.Compile(poDefn, apszExpr[i]),
+                           OGRERR_NONE );
+
+            int nExpected = 0;
+            for( int j = 0; j < nFeatures; j++ )
+                nExpected += oQuery.Evaluate(apoFeatures[j]) ? 1 : 0;
+            ensure_equals( apszExpr[i],
+                           oQuery.EvaluateBatch(&oBatch, &abyResults[0]),
+                           nExpected );
+            for( int j = 0; j < nFeatures; j++ )
+            {
+                ensure_equals( CPLSPrintf("%s, feature %d", apszExpr[i], j),
+                               abyResults[j] != FALSE,
+                               oQuery.Evaluate(apoFeatures[j]) != FALSE );
+            }
+
+            // Only the features after the first one are evaluated.
+            std::fill(abyResults.begin(), abyResults.end(), 2);
+            oQuery.EvaluateBatch(&oBatch, &abyResults[0], 30);
+            ensure_equals( abyResults[29], 2 );
+            ensure_equals( abyResults[30] != FALSE,
+                           oQuery.Evaluate(apoFeatures[30]) != FALSE );
+        }
+        CPLPopErrorHandler();
+
+        // Remove the features that do not match a filter.
+        OGRFeatureQuery oQuery;
+        ensure_equals( oQuery.Compile(poDefn, "str LIKE 'a%' OR int IS NULL"),
+                       OGRERR_NONE );
+        const int nMatching = oQuery.EvaluateBatch(&oBatch, &abyResults[0]);
+        ensure( nMatching > 0 && nMatching < nFeatures );
+        ensure_equals( oBatch.Compact(&abyResults[0]), nMatching );
+        ensure_equals( oBatch.GetFeatureCount(), nMatching );
+        int iBatch = 0;
+        for( int j = 0; j < nFeatures; j++ )
+        {
+            if( !oQuery.Evaluate(apoFeatures[j]) )
+                continue;
+            ensure_batch_feature_equals(oBatch, iBatch, apoFeatures[j]);
+            iBatch++;
+        }
+        ensure_equals( iBatch, nMatching );
+
+        // Features added after a compaction.
+        ensure_equals( oBatch.AddFeature(apoFeatures[0]), OGRERR_NONE );
+        ensure_batch_feature_equals(oBatch, nMatching, apoFeatures[0]);
+
+        for( int j = 0; j < nFeatures; j++ )
+            delete apoFeatures[j];
+        poDefn->Release();
+
+        // Attribute filter evaluated on the batches read from a shapefile.
+        std::string osShp(tut::common::data_basedir);
+        osShp += SEP;
+        osShp += "poly.shp";
+        GDALDataset* poDS = static_cast<GDALDataset*>(
+            GDALOpenEx(osShp.c_str(), GDAL_OF_VECTOR, NULL, NULL, NULL));
+        ensure( poDS != NULL );
+        OGRLayer* poLayer = poDS->GetLayer(0);
+        ensure_equals( poLayer->SetAttributeFilter(
+                        "EAS_ID > 170 OR PRFEDEA LIKE '%4_'"), OGRERR_NONE );
+        ensure_batch_equals_features(poLayer, 1);
+        ensure_batch_equals_features(poLayer, 3);
+        ensure_batch_equals_features(poLayer, 100);
+        GDALClose(poDS);
+    }
+
 } // namespace tut
@@ -349,4 +349,35 @@ namespace tut
     }
 
 
+    // Test OSRImportFromDict()
+    template<>
+    template<>
+    void object::test<8>()
+    {
+        ensure("SRS handle is NULL", NULL != srs_);
+
+        // Definition from esri_extra.wkt, included by epsg.wkt
+        err_ = OSRImportFromDict(srs_, "epsg.wkt", "37001");
+        ensure_equals("OSRImportFromDict failed", err_, OGRERR_NONE);
+        ensure_equals(std::string(OSRGetAttrValue(srs_, "GEOGCS", 0)),
+                      std::string("GCS_WGS_1966"));
+
+        // Second lookup in the same dictionary, case insensitive
+        err_ = OSRImportFromDict(srs_, "ecw_cs.wkt", "alalask2");
+        ensure_equals("OSRImportFromDict failed", err_, OGRERR_NONE);
+        ensure_equals(std::string(OSRGetAttrValue(srs_, "PROJCS", 0)),
+                      std::string("ALALASK2"));
+        err_ = OSRImportFromDict(srs_, "ecw_cs.wkt", "ALALASK3");
+        ensure_equals("OSRImportFromDict failed", err_, OGRERR_NONE);
+        ensure_equals(std::string(OSRGetAttrValue(srs_, "PROJCS", 0)),
+                      std::string("ALALASK3"));
+
+        err_ = OSRImportFromDict(srs_, "ecw_cs.wkt", "ALALASK");
+        ensure_equals(err_, OGRERR_UNSUPPORTED_SRS);
+        err_ = OSRImportFromDict(srs_, "epsg.wkt", "");
+        ensure_equals(err_, OGRERR_UNSUPPORTED_SRS);
+        err_ = OSRImportFromDict(srs_, "non_existing.wkt", "37001");
+        ensure_equals(err_, OGRERR_UNSUPPORTED_SRS);
+    }
+
 } // namespace tut
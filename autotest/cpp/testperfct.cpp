@@ -0,0 +1,150 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OGR
+ * Purpose:  Compare performance of per-geometry and bulk coordinate
+ *           transformation.
+ * Author:   agent, <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "ogr_geometry.h"
+#include "ogr_spatialref.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+static void Usage()
+{
+    printf("Usage: testperfct [-n num_geometries] [-v num_vertices]\n"
+           "                  [-s_srs srs_def] [-t_srs srs_def]\n"
+           "                  [-threads num_threads|ALL_CPUS]\n");
+    exit(1);
+}
+
+static double RandUnit()
+{
+    return static_cast<double>(rand()) / RAND_MAX;
+}
+
+static std::vector<OGRGeometry*> CreateGeometries( int nGeoms, int nVertices )
+{
+    // Short linestrings randomly spread over western Europe.
+    srand(1);
+    std::vector<OGRGeometry*> apoGeoms;
+    for( int i = 0; i < nGeoms; i++ )
+    {
+        OGRLineString* poLS = new OGRLineString();
+        const double dfX = -5 + RandUnit() * 15;
+        const double dfY = 40 + RandUnit() * 15;
+        for( int j = 0; j < nVertices; j++ )
+            poLS->addPoint(dfX + j * 1e-3, dfY + RandUnit() * 1e-3);
+        apoGeoms.push_back(poLS);
+    }
+    return apoGeoms;
+}
+
+static void DestroyGeometries( std::vector<OGRGeometry*>& apoGeoms )
+{
+    for( size_t i = 0; i < apoGeoms.size(); i++ )
+        delete apoGeoms[i];
+    apoGeoms.clear();
+}
+
+static double GetElapsed( std::chrono::steady_clock::time_point start )
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    int nGeoms = 1000 * 1000;
+    int nVertices = 5;
+    const char* pszSrcSRS = "EPSG:4326";
+    const char* pszDstSRS = "EPSG:32631";
+    const char* pszThreads = "ALL_CPUS";
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-n") && i + 1 < argc )
+            nGeoms = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-v") && i + 1 < argc )
+            nVertices = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-s_srs") && i + 1 < argc )
+            pszSrcSRS = argv[++i];
+        else if( EQUAL(argv[i], "-t_srs") && i + 1 < argc )
+            pszDstSRS = argv[++i];
+        else if( EQUAL(argv[i], "-threads") && i + 1 < argc )
+            pszThreads = argv[++i];
+        else
+            Usage();
+    }
+    if( nGeoms <= 0 || nVertices <= 0 )
+        Usage();
+
+    OGRSpatialReference oSrcSRS;
+    OGRSpatialReference oDstSRS;
+    if( oSrcSRS.SetFromUserInput(pszSrcSRS) != OGRERR_NONE ||
+        oDstSRS.SetFromUserInput(pszDstSRS) != OGRERR_NONE )
+    {
+        fprintf(stderr, "Invalid SRS definition.\n");
+        return 1;
+    }
+    OGRCoordinateTransformation* poCT =
+        OGRCreateCoordinateTransformation(&oSrcSRS, &oDstSRS);
+    if( poCT == NULL )
+        return 1;
+
+    // One transform() call per geometry.
+    std::vector<OGRGeometry*> apoGeoms = CreateGeometries(nGeoms, nVertices);
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    for( int i = 0; i < nGeoms; i++ )
+        apoGeoms[i]->transform(poCT);
+    printf("OGRGeometry::transform() (%d geometries of %d vertices) : "
+           "%.2f s\n", nGeoms, nVertices, GetElapsed(start));
+    DestroyGeometries(apoGeoms);
+
+    // Bulk transformation, single-threaded, then multi-threaded.
+    const char* const apszThreads[] = { "1", pszThreads };
+    for( size_t iRun = 0; iRun < CPL_ARRAYSIZE(apszThreads); iRun++ )
+    {
+        apoGeoms = CreateGeometries(nGeoms, nVertices);
+        CPLStringList aosOptions;
+        aosOptions.SetNameValue("NUM_THREADS", apszThreads[iRun]);
+        start = std::chrono::steady_clock::now();
+        OGRGeometryFactory::transformGeometries(&apoGeoms[0], nGeoms, poCT,
+                                                NULL, aosOptions.List());
+        printf("OGRGeometryFactory::transformGeometries(NUM_THREADS=%s) : "
+               "%.2f s\n", apszThreads[iRun], GetElapsed(start));
+        DestroyGeometries(apoGeoms);
+    }
+
+    OGRCoordinateTransformation::DestroyCT(poCT);
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  CPL
+ * Purpose:  Test performance of CPLHashSet on a block cache like workload.
+ * Author:   agent, <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_hash_set.h"
+#include "cpl_string.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+// Same key and hash function as GDALHashSetBandBlockCache
+typedef struct
+{
+    int nXOff;
+    int nYOff;
+} BlockKey;
+
+static unsigned long BlockKeyHashFunc( const void * const elt )
+{
+    const BlockKey* psKey = static_cast<const BlockKey*>(elt);
+#if SIZEOF_UNSIGNED_LONG == 8
+    return static_cast<unsigned long>(
+        psKey->nXOff | (static_cast<unsigned long>(psKey->nYOff) << 32));
+#else
+    return static_cast<unsigned long>(
+        ((psKey->nXOff & 0xFFFF) ^ (psKey->nYOff >> 16)) |
+        (((psKey->nYOff & 0xFFFF) ^ (psKey->nXOff >> 16)) << 16));
+#endif
+}
+
+static int BlockKeyEqualFunc( const void * const elt1,
+                              const void * const elt2 )
+{
+    const BlockKey* psKey1 = static_cast<const BlockKey*>(elt1);
+    const BlockKey* psKey2 = static_cast<const BlockKey*>(elt2);
+    return psKey1->nXOff == psKey2->nXOff && psKey1->nYOff == psKey2->nYOff;
+}
+
+int main(int argc, char* argv[])
+{
+    int nBlocks = 1000 * 1000;
+    int nLookups = 10 * 1000 * 1000;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-blocks") && i + 1 < argc )
+            nBlocks = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-lookups") && i + 1 < argc )
+            nLookups = atoi(argv[++i]);
+        else
+        {
+            printf("Usage: testperfhashset [-blocks n] [-lookups n]\n");
+            return 1;
+        }
+    }
+
+    // Sparse blocks of a 100000 x 100000 blocks raster
+    srand(1);
+    BlockKey* pasKeys = static_cast<BlockKey*>(
+        CPLMalloc(sizeof(BlockKey) * nBlocks));
+    for( int i = 0; i < nBlocks; i++ )
+    {
+        pasKeys[i].nXOff = rand() % 100000;
+        pasKeys[i].nYOff = rand() % 100000;
+    }
+
+    CPLHashSet* hSet = CPLHashSetNew(BlockKeyHashFunc, BlockKeyEqualFunc,
+                                     NULL);
+    clock_t start = clock();
+    for( int i = 0; i < nBlocks; i++ )
+        CPLHashSetInsert(hSet, &pasKeys[i]);
+    clock_t end = clock();
+    printf("%d insertions : %.2f s\n", nBlocks,
+           (end - start) * 1.0 / CLOCKS_PER_SEC);
+
+    start = clock();
+    int nFound = 0;
+    for( int i = 0; i < nLookups; i++ )
+    {
+        // Half of the lookups are for existing blocks.
+        BlockKey sKey;
+        if( (i % 2) == 0 )
+            sKey = pasKeys[rand() % nBlocks];
+        else
+        {
+            sKey.nXOff = rand() % 100000;
+            sKey.nYOff = rand() % 100000;
+        }
+        if( CPLHashSetLookup(hSet, &sKey) != NULL )
+            nFound++;
+    }
+    end = clock();
+    printf("%d lookups (%d found) : %.2f s\n", nLookups, nFound,
+           (end - start) * 1.0 / CLOCKS_PER_SEC);
+
+    start = clock();
+    for( int i = 0; i < nBlocks; i++ )
+        CPLHashSetRemoveDeferRehash(hSet, &pasKeys[i]);
+    end = clock();
+    printf("%d removals : %.2f s\n", nBlocks,
+           (end - start) * 1.0 / CLOCKS_PER_SEC);
+
+    CPLHashSetDestroy(hSet);
+    CPLFree(pasKeys);
+    return 0;
+}
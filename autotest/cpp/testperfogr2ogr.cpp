@@ -0,0 +1,231 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Utilities
+ * Purpose:  Measure time and number of heap allocations per feature of
+ *           a Shapefile to GeoPackage conversion with GDALVectorTranslate().
+ * Author:   agent, <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "gdal_utils.h"
+#include "ogrsf_frmts.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+/************************************************************************/
+/*                        Allocation counting                           */
+/************************************************************************/
+
+// With glibc, the allocator entry points of the executable take precedence
+// over the ones of the C library, including for calls made from libgdal.
+#if defined(__GLIBC__)
+extern "C" void* __libc_malloc(size_t);
+extern "C" void* __libc_calloc(size_t, size_t);
+extern "C" void* __libc_realloc(void*, size_t);
+
+static GIntBig nAllocCount = 0;
+
+extern "C" void* malloc(size_t nSize)
+{
+    nAllocCount ++;
+    return __libc_malloc(nSize);
+}
+
+extern "C" void* calloc(size_t nCount, size_t nSize)
+{
+    nAllocCount ++;
+    return __libc_calloc(nCount, nSize);
+}
+
+extern "C" void* realloc(void* pOld, size_t nSize)
+{
+    nAllocCount ++;
+    return __libc_realloc(pOld, nSize);
+}
+
+#define HAVE_ALLOC_COUNT
+#endif
+
+static void Usage()
+{
+    printf("Usage: testperfogr2ogr [-n num_features] [-v num_vertices]\n"
+           "                       [-loops n] [src_filename]\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                           CreateSource()                             */
+/************************************************************************/
+
+static void CreateSource( const char* pszFilename, int nFeatures,
+                          int nVertices )
+{
+    GDALDriver* poDriver = GetGDALDriverManager()->GetDriverByName(
+                                                        "ESRI Shapefile");
+    GDALDataset* poDS = poDriver->Create(pszFilename, 0, 0, 0,
+                                         GDT_Unknown, NULL);
+    OGRLayer* poLayer = poDS->CreateLayer("test", NULL, wkbPolygon, NULL);
+    OGRFieldDefn oFieldId("id", OFTInteger);
+    poLayer->CreateField(&oFieldId);
+    OGRFieldDefn oFieldVal("val", OFTReal);
+    poLayer->CreateField(&oFieldVal);
+    OGRFieldDefn oFieldName("name", OFTString);
+    oFieldName.SetWidth(40);
+    poLayer->CreateField(&oFieldName);
+    OGRFieldDefn oFieldComment("comment", OFTString);
+    oFieldComment.SetWidth(80);
+    poLayer->CreateField(&oFieldComment);
+
+    for( int i = 0; i < nFeatures; i++ )
+    {
+        OGRFeature* poFeature = new OGRFeature(poLayer->GetLayerDefn());
+        poFeature->SetField(0, i);
+        poFeature->SetField(1, i * 0.5);
+        poFeature->SetField(2, CPLSPrintf("feature %d", i));
+        poFeature->SetField(3, CPLSPrintf("a somewhat longer comment %d", i));
+        OGRLinearRing* poRing = new OGRLinearRing();
+        const double dfX = (i % 1000) * 10.0;
+        const double dfY = (i / 1000) * 10.0;
+        for( int j = 0; j < nVertices; j++ )
+        {
+            const double dfAngle = -2 * M_PI * j / nVertices;
+            poRing->addPoint(dfX + 4 * cos(dfAngle), dfY + 4 * sin(dfAngle));
+        }
+        poRing->closeRings();
+        OGRPolygon* poPoly = new OGRPolygon();
+        poPoly->addRingDirectly(poRing);
+        poFeature->SetGeometryDirectly(poPoly);
+        CPL_IGNORE_RET_VAL(poLayer->CreateFeature(poFeature));
+        delete poFeature;
+    }
+    GDALClose(poDS);
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main(int argc, char* argv[])
+{
+    int nFeatures = 100 * 1000;
+    int nVertices = 20;
+    int nLoops = 1;
+    const char* pszSrcFilename = NULL;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-n") && i + 1 < argc )
+            nFeatures = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-v") && i + 1 < argc )
+            nVertices = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-loops") && i + 1 < argc )
+            nLoops = atoi(argv[++i]);
+        else if( argv[i][0] != '-' && pszSrcFilename == NULL )
+            pszSrcFilename = argv[i];
+        else
+            Usage();
+    }
+    if( nFeatures <= 0 || nVertices < 3 || nLoops <= 0 )
+        Usage();
+
+    GDALAllRegister();
+
+    CPLString osSrcFilename;
+    if( pszSrcFilename == NULL )
+    {
+        osSrcFilename = "/vsimem/testperfogr2ogr/src.shp";
+        CreateSource(osSrcFilename, nFeatures, nVertices);
+    }
+    else
+    {
+        osSrcFilename = pszSrcFilename;
+    }
+
+    GDALDatasetH hSrcDS = GDALOpenEx(osSrcFilename, GDAL_OF_VECTOR,
+                                     NULL, NULL, NULL);
+    if( hSrcDS == NULL )
+        return 1;
+    GIntBig nFeatureCount = 0;
+    for( int i = 0; i < GDALDatasetGetLayerCount(hSrcDS); i++ )
+    {
+        nFeatureCount += OGR_L_GetFeatureCount(
+                                GDALDatasetGetLayer(hSrcDS, i), TRUE);
+    }
+    if( nFeatureCount == 0 )
+        nFeatureCount = 1;
+
+    // Second mode emulates the previous behaviour of creating and
+    // destroying a target feature for each source feature.
+    const char* const apszModes[] = { "YES", "NO" };
+    for( int iMode = 0; iMode < 2; iMode++ )
+    {
+        CPLSetConfigOption("OGR2OGR_REUSE_FEATURE", apszModes[iMode]);
+        for( int iLoop = 0; iLoop < nLoops; iLoop++ )
+        {
+            char** papszArgv = NULL;
+            papszArgv = CSLAddString(papszArgv, "-f");
+            papszArgv = CSLAddString(papszArgv, "GPKG");
+            GDALVectorTranslateOptions* psOptions =
+                GDALVectorTranslateOptionsNew(papszArgv, NULL);
+            CSLDestroy(papszArgv);
+
+#ifdef HAVE_ALLOC_COUNT
+            const GIntBig nAllocCountBefore = nAllocCount;
+#endif
+            const clock_t start = clock();
+            GDALDatasetH hDstDS = GDALVectorTranslate(
+                "/vsimem/testperfogr2ogr/out.gpkg", NULL,
+                1, &hSrcDS, psOptions, NULL);
+            GDALClose(hDstDS);
+            const clock_t end = clock();
+            GDALVectorTranslateOptionsFree(psOptions);
+            VSIUnlink("/vsimem/testperfogr2ogr/out.gpkg");
+
+            printf("OGR2OGR_REUSE_FEATURE=%s: " CPL_FRMT_GIB " features, "
+                   "%.2f s",
+                   apszModes[iMode], nFeatureCount,
+                   (end - start) * 1.0 / CLOCKS_PER_SEC);
+#ifdef HAVE_ALLOC_COUNT
+            printf(", %.1f allocations per feature",
+                   static_cast<double>(nAllocCount - nAllocCountBefore) /
+                                                            nFeatureCount);
+#endif
+            printf("\n");
+        }
+    }
+    CPLSetConfigOption("OGR2OGR_REUSE_FEATURE", NULL);
+
+    GDALClose(hSrcDS);
+    if( pszSrcFilename == NULL )
+    {
+        GDALDeleteDataset(GDALGetDriverByName("ESRI Shapefile"),
+                          osSrcFilename);
+    }
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  CPL
+ * Purpose:  Compare performance of CPLPackedRTree and CPLQuadTree.
+ * Author:   agent, <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_packed_rtree.h"
+#include "cpl_quad_tree.h"
+#include "cpl_string.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+static void Usage()
+{
+    printf("Usage: testperfpackedrtree [-n num_rects] [-q num_queries]\n");
+    exit(1);
+}
+
+static double RandUnit()
+{
+    return static_cast<double>(rand()) / RAND_MAX;
+}
+
+int main(int argc, char* argv[])
+{
+    int nRects = 10 * 1000 * 1000;
+    int nQueries = 100 * 1000;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-n") && i + 1 < argc )
+            nRects = atoi(argv[++i]);
+        else if( EQUAL(argv[i], "-q") && i + 1 < argc )
+            nQueries = atoi(argv[++i]);
+        else
+            Usage();
+    }
+
+    // Small rectangles randomly spread over a 1000x1000 area.
+    srand(1);
+    CPLRectObj* pasRects = static_cast<CPLRectObj*>(
+        CPLMalloc(sizeof(CPLRectObj) * nRects));
+    for( int i = 0; i < nRects; i++ )
+    {
+        pasRects[i].minx = RandUnit() * 1000;
+        pasRects[i].miny = RandUnit() * 1000;
+        pasRects[i].maxx = pasRects[i].minx + RandUnit();
+        pasRects[i].maxy = pasRects[i].miny + RandUnit();
+    }
+    CPLRectObj* pasAois = static_cast<CPLRectObj*>(
+        CPLMalloc(sizeof(CPLRectObj) * nQueries));
+    for( int i = 0; i < nQueries; i++ )
+    {
+        pasAois[i].minx = RandUnit() * 1000;
+        pasAois[i].miny = RandUnit() * 1000;
+        pasAois[i].maxx = pasAois[i].minx + RandUnit() * 5;
+        pasAois[i].maxy = pasAois[i].miny + RandUnit() * 5;
+    }
+
+    // Quad tree
+    clock_t start = clock();
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = 0;
+    sGlobalBounds.miny = 0;
+    sGlobalBounds.maxx = 1001;
+    sGlobalBounds.maxy = 1001;
+    CPLQuadTree* hQuadTree = CPLQuadTreeCreate(&sGlobalBounds, NULL);
+    CPLQuadTreeSetMaxDepth(hQuadTree,
+                           CPLQuadTreeGetAdvisedMaxDepth(nRects));
+    for( int i = 0; i < nRects; i++ )
+    {
+        CPLQuadTreeInsertWithBounds(
+            hQuadTree, reinterpret_cast<void*>(static_cast<size_t>(i)),
+            &pasRects[i]);
+    }
+    clock_t end = clock();
+    printf("CPLQuadTree build (%d rectangles) : %.2f s\n",
+           nRects, (end - start) * 1.0 / CLOCKS_PER_SEC);
+
+    start = clock();
+    GIntBig nTotalQuadTree = 0;
+    for( int i = 0; i < nQueries; i++ )
+    {
+        int nCount = 0;
+        void** pahRes = CPLQuadTreeSearch(hQuadTree, &pasAois[i], &nCount);
+        nTotalQuadTree += nCount;
+        CPLFree(pahRes);
+    }
+    end = clock();
+    printf("CPLQuadTreeSearch (%d queries, " CPL_FRMT_GIB " results) : %.2f s\n",
+           nQueries, nTotalQuadTree, (end - start) * 1.0 / CLOCKS_PER_SEC);
+    CPLQuadTreeDestroy(hQuadTree);
+
+    // Packed R-tree
+    start = clock();
+    CPLPackedRTree* hRTree = CPLPackedRTreeCreate(pasRects, nRects, 0);
+    end = clock();
+    printf("CPLPackedRTree build (%d rectangles) : %.2f s\n",
+           nRects, (end - start) * 1.0 / CLOCKS_PER_SEC);
+
+    start = clock();
+    GIntBig nTotalRTree = 0;
+    for( int i = 0; i < nQueries; i++ )
+    {
+        int nCount = 0;
+        int* panRes = CPLPackedRTreeSearch(hRTree, &pasAois[i], &nCount);
+        nTotalRTree += nCount;
+        CPLFree(panRes);
+    }
+    end = clock();
+    printf("CPLPackedRTreeSearch (%d queries, " CPL_FRMT_GIB " results) : %.2f s\n",
+           nQueries, nTotalRTree, (end - start) * 1.0 / CLOCKS_PER_SEC);
+
+    start = clock();
+    int* panFeatures = NULL;
+    int* panOffsets = NULL;
+    CPLPackedRTreeSearchBatch(hRTree, pasAois, nQueries,
+                              &panFeatures, &panOffsets);
+    end = clock();
+    printf("CPLPackedRTreeSearchBatch (%d queries, %d results) : %.2f s\n",
+           nQueries, panOffsets ? panOffsets[nQueries] : 0,
+           (end - start) * 1.0 / CLOCKS_PER_SEC);
+    CPLFree(panFeatures);
+    CPLFree(panOffsets);
+
+    CPLPackedRTreeDestroy(hRTree);
+    CPLFree(pasRects);
+    CPLFree(pasAois);
+
+    if( nTotalRTree != nTotalQuadTree )
+    {
+        fprintf(stderr, "Results differ !\n");
+        return 1;
+    }
+    return 0;
+}
@@ -3568,6 +3568,129 @@ def ogr_geojson_63():
     lyr = ds.GetLayer(0)
     return ogrtest.compare_layers(lyr, lyr_ref)
 
+###############################################################################
+# Test reading big files in streaming mode
+
+def ogr_geojson_64():
+
+    for filename in [ 'data/test_type_promotion.json',
+                      'data/ogr_geojson_14.geojson' ]:
+        ds_ref = ogr.Open(filename)
+        lyr_ref = ds_ref.GetLayer(0)
+
+        gdal.SetConfigOption('OGR_GEOJSON_MAX_OBJ_SIZE', '0')
+        ds = ogr.Open(filename)
+        gdal.SetConfigOption('OGR_GEOJSON_MAX_OBJ_SIZE', None)
+        lyr = ds.GetLayer(0)
+
+        if lyr.GetName() != lyr_ref.GetName() or \
+           lyr.GetGeomType() != lyr_ref.GetGeomType() or \
+           lyr.GetFeatureCount() != lyr_ref.GetFeatureCount() or \
+           lyr.GetSpatialRef().IsSame(lyr_ref.GetSpatialRef()) == 0 or \
+           lyr.TestCapability(ogr.OLCSequentialWrite) != 0:
+            gdaltest.post_reason('fail')
+            print(filename)
+            return 'fail'
+
+        lyr_defn = lyr.GetLayerDefn()
+        lyr_ref_defn = lyr_ref.GetLayerDefn()
+        if lyr_defn.GetFieldCount() != lyr_ref_defn.GetFieldCount():
+            gdaltest.post_reason('fail')
+            print(filename)
+            return 'fail'
+        for i in range(lyr_defn.GetFieldCount()):
+            if lyr_defn.GetFieldDefn(i).GetName() != \
+                    lyr_ref_defn.GetFieldDefn(i).GetName() or \
+               lyr_defn.GetFieldDefn(i).GetType() != \
+                    lyr_ref_defn.GetFieldDefn(i).GetType():
+                gdaltest.post_reason('fail')
+                print(filename)
+                return 'fail'
+
+        # Read twice to check ResetReading()
+        for i in range(2):
+            lyr_ref.ResetReading()
+            lyr.ResetReading()
+            if ogrtest.compare_layers(lyr, lyr_ref) != 'success':
+                gdaltest.post_reason('fail')
+                print(filename)
+                return 'fail'
+
+    # Not a FeatureCollection: regular code path
+    gdal.SetConfigOption('OGR_GEOJSON_MAX_OBJ_SIZE', '0')
+    ds = ogr.Open('data/point.geojson')
+    gdal.SetConfigOption('OGR_GEOJSON_MAX_OBJ_SIZE', None)
+    if ds is None or ds.GetLayer(0).GetFeatureCount() != 1:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    # FIDs must be the same as in the regular code path
+    features = [
+        # Feature ids not in increasing order
+        """{ "type": "Feature", "id": 2, "properties": { "a": 1 }, "geometry": null },
+{ "type": "Feature", "id": 1, "properties": { "a": 2 }, "geometry": null }""",
+        # Duplicate feature ids
+        """{ "type": "Feature", "id": 1, "properties": { "a": 1 }, "geometry": null },
+{ "type": "Feature", "properties": { "a": 2 }, "geometry": null },
+{ "type": "Feature", "id": 1, "properties": { "a": 3 }, "geometry": null },
+{ "type": "Feature", "id": 0, "properties": { "a": 4 }, "geometry": null }""",
+        # Integer "id" property used as FID column
+        """{ "type": "Feature", "properties": { "id": 10, "a": 1 }, "geometry": null },
+{ "type": "Feature", "properties": { "id": 5, "a": 2 }, "geometry": null },
+{ "type": "Feature", "properties": { "id": 5, "a": 3 }, "geometry": null }""",
+        # 3D geometries
+        """{ "type": "Feature", "id": 3, "properties": {}, "geometry": { "type": "LineString", "coordinates": [[1,2],[3,4,5]] } },
+{ "type": "Feature", "id": 4, "properties": {}, "geometry": { "type": "LineString", "coordinates": [[1,2,3],[3,4,5]] } }""" ]
+    for feature_text in features:
+        gdal.FileFromMemBuffer('/vsimem/ogr_geojson_64.json',
+            '{ "type": "FeatureCollection", "features": [\n' + feature_text + ' ] }')
+        for attributes_skip in [ None, 'YES' ]:
+            gdal.SetConfigOption('ATTRIBUTES_SKIP', attributes_skip)
+            with gdaltest.error_handler():
+                ds_ref = ogr.Open('/vsimem/ogr_geojson_64.json')
+                gdal.SetConfigOption('OGR_GEOJSON_MAX_OBJ_SIZE', '0')
+                ds = ogr.Open('/vsimem/ogr_geojson_64.json')
+                gdal.SetConfigOption('OGR_GEOJSON_MAX_OBJ_SIZE', None)
+            gdal.SetConfigOption('ATTRIBUTES_SKIP', None)
+            lyr_ref = ds_ref.GetLayer(0)
+            lyr = ds.GetLayer(0)
+            # Features are returned in file order by the streaming reader
+            fids_ref = sorted([ (f.GetFID(), [ f.GetField(i) for i in range(f.GetFieldCount()) ]) for f in lyr_ref ])
+            fids = sorted([ (f.GetFID(), [ f.GetField(i) for i in range(f.GetFieldCount()) ]) for f in lyr ])
+            if fids != fids_ref or \
+               lyr.GetFIDColumn() != lyr_ref.GetFIDColumn() or \
+               lyr.GetGeomType() != lyr_ref.GetGeomType() or \
+               lyr.GetFeatureCount() != lyr_ref.GetFeatureCount():
+                gdaltest.post_reason('fail')
+                print(feature_text, attributes_skip)
+                print(fids, fids_ref)
+                print(lyr.GetFIDColumn(), lyr_ref.GetFIDColumn())
+                print(lyr.GetGeomType(), lyr_ref.GetGeomType())
+                return 'fail'
+            ds = None
+            ds_ref = None
+        gdal.Unlink('/vsimem/ogr_geojson_64.json')
+
+    # Parse error of a feature while reading: coordinates are not parsed
+    # by the first pass
+    gdal.FileFromMemBuffer('/vsimem/ogr_geojson_64.json',
+"""{ "type": "FeatureCollection", "features": [
+{ "type": "Feature", "properties": { "a": 1 }, "geometry": { "type": "Point", "coordinates": [1,nul] } } ] }""")
+    gdal.SetConfigOption('OGR_GEOJSON_MAX_OBJ_SIZE', '0')
+    ds = ogr.Open('/vsimem/ogr_geojson_64.json')
+    gdal.SetConfigOption('OGR_GEOJSON_MAX_OBJ_SIZE', None)
+    lyr = ds.GetLayer(0)
+    gdal.ErrorReset()
+    with gdaltest.error_handler():
+        f = lyr.GetNextFeature()
+    if f is not None or gdal.GetLastErrorType() != gdal.CE_Failure:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    ds = None
+    gdal.Unlink('/vsimem/ogr_geojson_64.json')
+
+    return 'success'
+
 gdaltest_list = [
     ogr_geojson_1,
     ogr_geojson_2,
@@ -3632,6 +3755,7 @@ gdaltest_list = [
     ogr_geojson_61,
     ogr_geojson_62,
     ogr_geojson_63,
+    ogr_geojson_64,
     ogr_geojson_cleanup ]
 
 if __name__ == '__main__':
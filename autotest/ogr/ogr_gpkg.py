@@ -1163,6 +1163,28 @@ def ogr_gpkg_15():
         gdaltest.gpkg_ds.ReleaseResultSet(sql_lyr)
 
 
+    # Blob without envelope in its header: LINESTRING (1 2,3 -4)
+    blob = "x'4750000100000000010200000002000000000000000000F03F0000000000000040000000000000084000000000000010C0'"
+    sql_lyr = gdaltest.gpkg_ds.ExecuteSQL("SELECT ST_MinX(%s), ST_MinY(%s), ST_MaxX(%s), ST_MaxY(%s)" % (blob, blob, blob, blob))
+    feat = sql_lyr.GetNextFeature()
+    if feat.GetField(0) != 1 or feat.GetField(1) != -4 or \
+       feat.GetField(2) != 3 or feat.GetField(3) != 2:
+        gdaltest.post_reason('fail')
+        feat.DumpReadable()
+        return 'fail'
+    feat = None
+    gdaltest.gpkg_ds.ReleaseResultSet(sql_lyr)
+
+    # Error case: truncated WKB in a blob without envelope
+    sql_lyr = gdaltest.gpkg_ds.ExecuteSQL("SELECT ST_MinX(x'4750000100000000010200000002000000000000000000F03F')")
+    feat = sql_lyr.GetNextFeature()
+    if feat.IsFieldSetAndNotNull(0):
+        gdaltest.post_reason('fail')
+        feat.DumpReadable()
+        return 'fail'
+    feat = None
+    gdaltest.gpkg_ds.ReleaseResultSet(sql_lyr)
+
     # Error case: less than 8 bytes
     sql_lyr = gdaltest.gpkg_ds.ExecuteSQL("SELECT ST_MinX(x'00')")
     feat = sql_lyr.GetNextFeature()
@@ -4318,6 +4340,262 @@ def ogr_gpkg_50():
 
     return 'success'
 
+###############################################################################
+# Test bulk loading of the RTree, and deferred RTree update when appending
+# in a transaction
+
+def ogr_gpkg_51_check(ds, lyr, expected_count):
+
+    sql_lyr = ds.ExecuteSQL('SELECT COUNT(*) FROM rtree_test_geom')
+    f = sql_lyr.GetNextFeature()
+    count = f.GetField(0)
+    ds.ReleaseResultSet(sql_lyr)
+    if count != expected_count:
+        gdaltest.post_reason('fail')
+        print(count)
+        return False
+
+    # rtreecheck() is available from SQLite 3.24
+    gdal.PushErrorHandler()
+    sql_lyr = ds.ExecuteSQL("SELECT rtreecheck('rtree_test_geom')")
+    gdal.PopErrorHandler()
+    if sql_lyr is not None:
+        f = sql_lyr.GetNextFeature()
+        res = f.GetField(0)
+        ds.ReleaseResultSet(sql_lyr)
+        if res != 'ok':
+            gdaltest.post_reason('fail')
+            print(res)
+            return False
+
+    for (minx, miny, maxx, maxy) in [ (0, 0, 10, 10), (-0.5, -0.5, 0.5, 0.5),
+                                      (100.25, 10.25, 120.75, 30.75),
+                                      (-1000, -1000, 1000, 1000) ]:
+        lyr.SetSpatialFilterRect(minx, miny, maxx, maxy)
+        got = sorted([f.GetFID() for f in lyr])
+        lyr.SetSpatialFilter(None)
+        expected = []
+        for f in lyr:
+            x = f.GetGeometryRef().GetX()
+            y = f.GetGeometryRef().GetY()
+            if x >= minx and x <= maxx and y >= miny and y <= maxy:
+                expected.append(f.GetFID())
+        if got != sorted(expected):
+            gdaltest.post_reason('fail')
+            print(minx, miny, maxx, maxy)
+            print(len(got), len(expected))
+            return False
+
+    return True
+
+def ogr_gpkg_51():
+
+    if gdaltest.gpkg_dr is None:
+        return 'skip'
+
+    ds = gdaltest.gpkg_dr.CreateDataSource('/vsimem/ogr_gpkg_51.gpkg')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbPoint)
+    lyr.StartTransaction()
+    # Enough features to get a RTree of depth 2
+    for i in range(10000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i % 100 != 0:
+            f.SetGeometry(ogr.CreateGeometryFromWkt(
+                'POINT(%f %f)' % ((i % 173) * 1.5, (i // 173) * 0.5)))
+        lyr.CreateFeature(f)
+    lyr.CommitTransaction()
+    ds = None
+
+    ds = ogr.Open('/vsimem/ogr_gpkg_51.gpkg', update = 1)
+    lyr = ds.GetLayer(0)
+    if not ogr_gpkg_51_check(ds, lyr, 9900):
+        return 'fail'
+
+    # Append less features than existing ones: inserted one at a time
+    lyr.StartTransaction()
+    for i in range(100):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (-i, -i)))
+        lyr.CreateFeature(f)
+    lyr.CommitTransaction()
+    if not ogr_gpkg_51_check(ds, lyr, 10000):
+        return 'fail'
+
+    # Append more features than existing ones: RTree rebuilt.
+    # Reading in the middle of the insertions must take them into account.
+    lyr.StartTransaction()
+    for i in range(20000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i % 400, i // 400)))
+        lyr.CreateFeature(f)
+        if i == 15000:
+            lyr.SetSpatialFilterRect(-0.5, -0.5, 0.5, 0.5)
+            if lyr.GetFeatureCount() != 3:
+                gdaltest.post_reason('fail')
+                print(lyr.GetFeatureCount())
+                return 'fail'
+            lyr.SetSpatialFilter(None)
+    lyr.CommitTransaction()
+    if not ogr_gpkg_51_check(ds, lyr, 30000):
+        return 'fail'
+
+    # Rollback must leave the RTree consistent
+    lyr.StartTransaction()
+    for i in range(10):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i, i)))
+        lyr.CreateFeature(f)
+    lyr.RollbackTransaction()
+    if not ogr_gpkg_51_check(ds, lyr, 30000):
+        return 'fail'
+
+    ds = None
+
+    if not validate('/vsimem/ogr_gpkg_51.gpkg'):
+        gdaltest.post_reason('validation failed')
+        return 'fail'
+
+    gdaltest.gpkg_dr.DeleteDataSource('/vsimem/ogr_gpkg_51.gpkg')
+
+    return 'success'
+
+###############################################################################
+# Test multi-threaded reading and rejection of features from the envelope
+# in the geometry blob header
+
+def ogr_gpkg_52_read(lyr):
+
+    ret = []
+    for f in lyr:
+        g = f.GetGeometryRef()
+        if g is not None:
+            g = g.ExportToIsoWkt()
+        ret.append((f.GetFID(),
+                    [ f.GetField(i) for i in range(f.GetFieldCount()) ], g))
+    return ret
+
+def ogr_gpkg_52():
+
+    if gdaltest.gpkg_dr is None:
+        return 'skip'
+
+    ds = gdaltest.gpkg_dr.CreateDataSource('/vsimem/ogr_gpkg_52.gpkg')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbUnknown,
+                         options = ['SPATIAL_INDEX=NO'])
+    lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('int64', ogr.OFTInteger64))
+    lyr.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('str', ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn('date', ogr.OFTDate))
+    lyr.CreateField(ogr.FieldDefn('datetime', ogr.OFTDateTime))
+    lyr.CreateField(ogr.FieldDefn('binary', ogr.OFTBinary))
+    lyr.StartTransaction()
+    for i in range(3000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i % 7 != 0:
+            f.SetField('int', i)
+            f.SetField('int64', i * 10000000000)
+            f.SetField('real', i * 0.5)
+            f.SetField('str', 'foo%d' % i)
+            f.SetField('date', '2018/01/%02d' % (1 + i % 28))
+            f.SetField('datetime', '2018/01/%02d 12:34:56' % (1 + i % 28))
+            f.SetFieldBinaryFromHexString('binary', '%04X' % i)
+        x = i % 100
+        y = i // 100
+        if i % 3 == 0:
+            f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (x, y)))
+        elif i % 3 == 1:
+            f.SetGeometry(ogr.CreateGeometryFromWkt(
+                'POLYGON((%d %d,%d %d,%f %f,%d %d))' % (x, y, x, y + 1, x + 0.5, y + 0.5, x, y)))
+        elif i % 11 == 0:
+            f.SetGeometry(ogr.CreateGeometryFromWkt('POINT EMPTY'))
+        lyr.CreateFeature(f)
+    lyr.CommitTransaction()
+    ds = None
+
+    ds = ogr.Open('/vsimem/ogr_gpkg_52.gpkg')
+    lyr = ds.GetLayer(0)
+    sql_lyr = ds.ExecuteSQL('SELECT * FROM test WHERE int % 2 = 0')
+    ref = []
+    for filter_rect in [ None, (10.2, 5.2, 20.7, 8.7) ]:
+        for attr_filter in [ None, 'int64 > 5000000000000' ]:
+            if filter_rect is not None:
+                lyr.SetSpatialFilterRect(filter_rect[0], filter_rect[1], filter_rect[2], filter_rect[3])
+            else:
+                lyr.SetSpatialFilter(None)
+            lyr.SetAttributeFilter(attr_filter)
+            ref.append(ogr_gpkg_52_read(lyr))
+    lyr.SetSpatialFilter(None)
+    lyr.SetAttributeFilter(None)
+    ref_sql = ogr_gpkg_52_read(sql_lyr)
+    ds.ReleaseResultSet(sql_lyr)
+    ds = None
+
+    if len(ref[0]) != 3000:
+        gdaltest.post_reason('fail')
+        print(len(ref[0]))
+        return 'fail'
+    if len(ref[2]) == 0 or len(ref[2]) == 3000:
+        gdaltest.post_reason('fail')
+        print(len(ref[2]))
+        return 'fail'
+
+    gdal.SetConfigOption('OGR_GPKG_NUM_THREADS', '4')
+    ds = ogr.Open('/vsimem/ogr_gpkg_52.gpkg')
+    lyr = ds.GetLayer(0)
+    sql_lyr = ds.ExecuteSQL('SELECT * FROM test WHERE int % 2 = 0')
+    got = []
+    for filter_rect in [ None, (10.2, 5.2, 20.7, 8.7) ]:
+        for attr_filter in [ None, 'int64 > 5000000000000' ]:
+            if filter_rect is not None:
+                lyr.SetSpatialFilterRect(filter_rect[0], filter_rect[1], filter_rect[2], filter_rect[3])
+            else:
+                lyr.SetSpatialFilter(None)
+            lyr.SetAttributeFilter(attr_filter)
+            got.append(ogr_gpkg_52_read(lyr))
+    lyr.SetSpatialFilter(None)
+    lyr.SetAttributeFilter(None)
+    got_sql = ogr_gpkg_52_read(sql_lyr)
+    ds.ReleaseResultSet(sql_lyr)
+
+    # Interrupted reading
+    lyr.ResetReading()
+    for i in range(1000):
+        lyr.GetNextFeature()
+    lyr.ResetReading()
+    f = lyr.GetNextFeature()
+    if f.GetFID() != 1:
+        gdaltest.post_reason('fail')
+        f.DumpReadable()
+        return 'fail'
+    if lyr.GetFeature(2000).GetFID() != 2000:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    # Ignored fields
+    lyr.SetIgnoredFields(['str', 'OGR_GEOMETRY'])
+    lyr.ResetReading()
+    f = lyr.GetNextFeature()
+    f = lyr.GetNextFeature()
+    if f.IsFieldSet('str') or f.GetGeometryRef() is not None or \
+       f.GetField('int') != 1:
+        gdaltest.post_reason('fail')
+        f.DumpReadable()
+        return 'fail'
+    ds = None
+    gdal.SetConfigOption('OGR_GPKG_NUM_THREADS', None)
+
+    if got != ref:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    if got_sql != ref_sql:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    gdaltest.gpkg_dr.DeleteDataSource('/vsimem/ogr_gpkg_52.gpkg')
+
+    return 'success'
+
 ###############################################################################
 # Remove the test db from the tmp directory
 
@@ -4393,6 +4671,8 @@ gdaltest_list = [
     ogr_gpkg_48,
     ogr_gpkg_49,
     ogr_gpkg_50,
+    ogr_gpkg_51,
+    ogr_gpkg_52,
     ogr_gpkg_test_ogrsf,
     ogr_gpkg_cleanup,
 ]
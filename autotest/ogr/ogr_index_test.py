@@ -234,55 +234,48 @@ def ogr_index_9():
 
     gdaltest.s_ds.Release()
 
-    # After dataset closing, check that the index files do not exist after
+    # After dataset closing, check that the index file does not exist after
     # dropping the index
-    for filename in ['join_t.idm','join_t.ind']:
-        try:
-            os.stat(filename)
-            gdaltest.post_reason("%s should not exist" % filename)
-            return 'fail'
-        except:
-            pass
+    try:
+        os.stat('join_t.oix')
+        gdaltest.post_reason("join_t.oix should not exist")
+        return 'fail'
+    except:
+        pass
 
     # Re-create an index
     gdaltest.s_ds = ogr.OpenShared( 'join_t.dbf', update = 1 )
     gdaltest.s_ds.ExecuteSQL( 'CREATE INDEX ON join_t USING value' )
     gdaltest.s_ds.Release()
 
-    for filename in ['join_t.idm','join_t.ind']:
-        try:
-            os.stat(filename)
-        except:
-            gdaltest.post_reason("%s should exist" % filename)
-            return 'fail'
-            pass
+    try:
+        os.stat('join_t.oix')
+    except:
+        gdaltest.post_reason("join_t.oix should exist")
+        return 'fail'
 
-    f = open('join_t.idm', 'rt')
-    xml = f.read()
+    f = open('join_t.oix', 'rb')
+    header = f.read(4096)
     f.close()
-    if xml.find('VALUE') == -1:
+    if header.find('VALUE'.encode('ascii')) == -1:
         gdaltest.post_reason('VALUE column is not indexed (1)')
-        print(xml)
         return 'fail'
 
     # Close the dataset and re-open
     gdaltest.s_ds = ogr.OpenShared( 'join_t.dbf', update = 1 )
-    # At this point the .ind was opened in read-only. Now it
-    # will be re-opened in read-write mode
+    # Add a second index to the existing file
     gdaltest.s_ds.ExecuteSQL( 'CREATE INDEX ON join_t USING skey' )
 
     gdaltest.s_ds.Release()
 
-    f = open('join_t.idm', 'rt')
-    xml = f.read()
+    f = open('join_t.oix', 'rb')
+    header = f.read(4096)
     f.close()
-    if xml.find('VALUE') == -1:
+    if header.find('VALUE'.encode('ascii')) == -1:
         gdaltest.post_reason('VALUE column is not indexed (2)')
-        print(xml)
         return 'fail'
-    if xml.find('SKEY') == -1:
+    if header.find('SKEY'.encode('ascii')) == -1:
         gdaltest.post_reason('SKEY column is not indexed (2)')
-        print(xml)
         return 'fail'
 
     return 'success'
@@ -493,6 +486,236 @@ def ogr_index_11():
 
     return 'success'
 
+###############################################################################
+# Test range, BETWEEN, LIKE and date queries against the B-tree attribute
+# indexes (.oix file) of the Shapefile, CSV and GeoJSON drivers.
+
+def ogr_index_12_check(lyr, where, expected_fids):
+
+    lyr.SetAttributeFilter(where)
+    fids = []
+    for feat in lyr:
+        fids.append(feat.GetFID())
+    lyr.SetAttributeFilter(None)
+    if sorted(fids) != expected_fids:
+        gdaltest.post_reason('failed')
+        print(where)
+        print(fids)
+        print(expected_fids)
+        return 'fail'
+
+    return 'success'
+
+def ogr_index_12_create(lyr):
+
+    lyr.CreateField(ogr.FieldDefn('intfield', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('realfield', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('strfield', ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn('datefield', ogr.OFTDate))
+
+    for i in range(100):
+        feat = ogr.Feature(lyr.GetLayerDefn())
+        if i != 50:
+            feat.SetField('intfield', i)
+            feat.SetField('realfield', i * 0.5 - 10)
+            if (i % 2) == 0:
+                feat.SetField('strfield', 'foo%d' % i)
+            else:
+                feat.SetField('strfield', 'BAR%d' % i)
+            feat.SetField('datefield', '2018/01/%02d' % (1 + (i % 28)))
+        lyr.CreateFeature(feat)
+
+def ogr_index_12_run(filename, fid_offset):
+
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    for field in [ 'intfield', 'realfield', 'strfield', 'datefield' ]:
+        ds.ExecuteSQL('CREATE INDEX ON %s USING %s' % (lyr.GetName(), field))
+
+    if lyr.GetLayerDefn().GetFieldDefn(
+            lyr.GetLayerDefn().GetFieldIndex('datefield')).GetType() \
+                                                        != ogr.OFTDate:
+        gdaltest.post_reason('failed')
+        return 'fail'
+
+    tests = [
+        ( 'intfield > 95', [ 96, 97, 98, 99 ] ),
+        ( 'intfield >= 48 AND intfield < 53', [ 48, 49, 51, 52 ] ),
+        ( 'intfield BETWEEN 10 AND 12', [ 10, 11, 12 ] ),
+        ( '3 > intfield', [ 0, 1, 2 ] ),
+        ( 'intfield < 2.5', [ 0, 1, 2 ] ),
+        ( 'intfield IN (5, 7, 5)', [ 5, 7 ] ),
+        ( 'realfield <= -9', [ 0, 1, 2 ] ),
+        ( 'realfield = 0', [ 20 ] ),
+        ( "strfield LIKE 'bar9%'", [ 9, 91, 93, 95, 97, 99 ] ),
+        ( "strfield LIKE 'FOO1_'",
+          [ 10, 12, 14, 16, 18 ] ),
+        ( "strfield > 'foo96'", [ 98 ] ),
+        ( "strfield = 'foo4' OR intfield = 99", [ 4, 99 ] ),
+        ( "datefield < '2018/01/02'", [ 0, 28, 56, 84 ] ),
+        ( "datefield BETWEEN '2018/01/27' AND '2018/01/28'",
+          [ 26, 27, 54, 55, 82, 83 ] ),
+        ( "datefield = '2018/01/05' AND intfield > 40", [ 60, 88 ] ),
+    ]
+    for (where, expected_fids) in tests:
+        expected_fids = [ fid + fid_offset for fid in expected_fids ]
+        ret = ogr_index_12_check(lyr, where, expected_fids)
+        if ret != 'success':
+            return ret
+
+    ds = None
+
+    # Reopen to check that the index file is reused
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    if lyr.GetLayerDefn().GetFieldCount() != 4:
+        gdaltest.post_reason('failed')
+        return 'fail'
+    for (where, expected_fids) in tests:
+        expected_fids = [ fid + fid_offset for fid in expected_fids ]
+        ret = ogr_index_12_check(lyr, where, expected_fids)
+        if ret != 'success':
+            return ret
+    ds = None
+
+    return 'success'
+
+def ogr_index_12():
+
+    ds = ogr.GetDriverByName( 'ESRI Shapefile' ).CreateDataSource('tmp/ogr_index_12.dbf')
+    lyr = ds.CreateLayer('ogr_index_12', geom_type = ogr.wkbNone)
+    ogr_index_12_create(lyr)
+    ds = None
+
+    ret = ogr_index_12_run('tmp/ogr_index_12.dbf', 0)
+    if ret != 'success':
+        return ret
+    try:
+        os.stat('tmp/ogr_index_12.oix')
+    except:
+        gdaltest.post_reason("tmp/ogr_index_12.oix should exist")
+        return 'fail'
+
+    ds = ogr.GetDriverByName( 'CSV' ).CreateDataSource('tmp/ogr_index_12_csv.csv')
+    lyr = ds.CreateLayer('ogr_index_12_csv', geom_type = ogr.wkbNone,
+                         options = [ 'CREATE_CSVT=YES' ])
+    ogr_index_12_create(lyr)
+    ds = None
+
+    # FIDs of the CSV driver start at 1
+    ret = ogr_index_12_run('tmp/ogr_index_12_csv.csv', 1)
+    if ret != 'success':
+        return ret
+
+    ds = ogr.GetDriverByName( 'GeoJSON' ).CreateDataSource('tmp/ogr_index_12_json.geojson')
+    lyr = ds.CreateLayer('ogr_index_12_json', geom_type = ogr.wkbNone)
+    ogr_index_12_create(lyr)
+    ds = None
+
+    ret = ogr_index_12_run('tmp/ogr_index_12_json.geojson', 0)
+    if ret != 'success':
+        return ret
+
+    return 'success'
+
+###############################################################################
+# Test that the MapInfo .idm/.ind index format can still be selected.
+
+def ogr_index_13():
+
+    ds = ogr.GetDriverByName( 'ESRI Shapefile' ).CreateDataSource('tmp/ogr_index_13.dbf')
+    lyr = ds.CreateLayer('ogr_index_13', geom_type = ogr.wkbNone)
+    lyr.CreateField(ogr.FieldDefn('intfield', ogr.OFTInteger))
+    for i in range(10):
+        ogrtest.quick_create_feature(lyr, [i], None)
+    ds = None
+
+    from osgeo import gdal
+    gdal.SetConfigOption('OGR_ATTRIBUTE_INDEX_FORMAT', 'MAPINFO')
+    ds = ogr.Open('tmp/ogr_index_13.dbf', update = 1)
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_13 USING intfield')
+    gdal.SetConfigOption('OGR_ATTRIBUTE_INDEX_FORMAT', None)
+    ds = None
+
+    for filename in ['tmp/ogr_index_13.idm','tmp/ogr_index_13.ind']:
+        try:
+            os.stat(filename)
+        except:
+            gdaltest.post_reason("%s should exist" % filename)
+            return 'fail'
+    try:
+        os.stat('tmp/ogr_index_13.oix')
+        gdaltest.post_reason("tmp/ogr_index_13.oix should not exist")
+        return 'fail'
+    except:
+        pass
+
+    # The existing .idm file is picked up without the configuration option
+    ds = ogr.Open('tmp/ogr_index_13.dbf')
+    lyr = ds.GetLayer(0)
+    lyr.SetAttributeFilter('intfield = 5')
+    ret = ogr_index_11_check(lyr, [ 5 ])
+    if ret != 'success':
+        return ret
+    ds = None
+
+    return 'success'
+
+###############################################################################
+# Test that the .oix index is dropped when the layer is modified, and
+# ignored when the data file has been modified behind its back.
+
+def ogr_index_14():
+
+    ds = ogr.GetDriverByName( 'ESRI Shapefile' ).CreateDataSource('tmp/ogr_index_14.dbf')
+    lyr = ds.CreateLayer('ogr_index_14', geom_type = ogr.wkbNone)
+    lyr.CreateField(ogr.FieldDefn('intfield', ogr.OFTInteger))
+    for i in range(10):
+        ogrtest.quick_create_feature(lyr, [i], None)
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_14 USING intfield')
+
+    lyr.SetAttributeFilter('intfield = 5')
+    ret = ogr_index_11_check(lyr, [ 5 ])
+    if ret != 'success':
+        return ret
+
+    feat = lyr.GetFeature(5)
+    feat.SetField('intfield', 100)
+    lyr.SetFeature(feat)
+
+    lyr.SetAttributeFilter('intfield = 100')
+    ret = ogr_index_11_check(lyr, [ 5 ])
+    if ret != 'success':
+        return ret
+    ds = None
+
+    try:
+        os.stat('tmp/ogr_index_14.oix')
+        gdaltest.post_reason("tmp/ogr_index_14.oix should not exist")
+        return 'fail'
+    except:
+        pass
+
+    ds = ogr.Open('tmp/ogr_index_14.dbf', update = 1)
+    ds.ExecuteSQL('CREATE INDEX ON ogr_index_14 USING intfield')
+    ds = None
+
+    # Modify the .dbf file without going through OGR, so that the .oix
+    # file is out of date.
+    f = open('tmp/ogr_index_14.dbf', 'ab')
+    f.write(' '.encode('ascii'))
+    f.close()
+
+    ds = ogr.Open('tmp/ogr_index_14.dbf')
+    lyr = ds.GetLayer(0)
+    lyr.SetAttributeFilter('intfield = 100')
+    ret = ogr_index_11_check(lyr, [ 5 ])
+    if ret != 'success':
+        return ret
+    ds = None
+
+    return 'success'
+
 ###############################################################################
 
 def ogr_index_cleanup():
@@ -510,18 +733,31 @@ def ogr_index_cleanup():
     ogr.GetDriverByName( 'MapInfo File' ).DeleteDataSource( 'index_p.mif' )
     ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource( 'join_t.dbf' )
 
-    for filename in ['join_t.idm','join_t.ind']:
-        try:
-            os.stat(filename)
-            gdaltest.post_reason("%s should not exist" % filename)
-            return 'fail'
-        except:
-            pass
+    try:
+        os.stat('join_t.oix')
+        gdaltest.post_reason("join_t.oix should not exist")
+        return 'fail'
+    except:
+        pass
 
     ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource(
         'tmp/ogr_index_10.shp' )
     ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource(
         'tmp/ogr_index_11.dbf' )
+    ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource(
+        'tmp/ogr_index_12.dbf' )
+    ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource(
+        'tmp/ogr_index_14.dbf' )
+    ogr.GetDriverByName( 'ESRI Shapefile' ).DeleteDataSource(
+        'tmp/ogr_index_13.dbf' )
+    for filename in [ 'tmp/ogr_index_12_csv.csv', 'tmp/ogr_index_12_csv.csvt',
+                      'tmp/ogr_index_12_csv.oix',
+                      'tmp/ogr_index_12_json.geojson',
+                      'tmp/ogr_index_12_json.oix' ]:
+        try:
+            os.unlink(filename)
+        except:
+            pass
 
     return 'success'
 
@@ -537,6 +773,9 @@ gdaltest_list = [
     ogr_index_9,
     ogr_index_10,
     ogr_index_11,
+    ogr_index_12,
+    ogr_index_13,
+    ogr_index_14,
     ogr_index_cleanup ]
 
 if __name__ == '__main__':
@@ -549,6 +549,97 @@ def ogr_join_23():
 
     return 'success'
 
+###############################################################################
+# Test that the hash join, in memory or spilled to disk, gives the same result
+# as the join evaluated with an attribute filter on the secondary layer
+
+def ogr_join_24_get_result(ds, sql):
+
+    sql_lyr = ds.ExecuteSQL(sql)
+    ret = []
+    for f in sql_lyr:
+        ret.append([f.GetField(i) for i in range(f.GetFieldCount())])
+    ds.ReleaseResultSet(sql_lyr)
+    return ret
+
+def ogr_join_24():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('first')
+    lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('str', ogr.OFTString))
+    for i in range(100):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i % 10 != 0:
+            f['int'] = i % 40
+            f['real'] = (i % 40) + 0.5
+            f['str'] = 'key%d' % (i % 40)
+        lyr.CreateFeature(f)
+
+    lyr = ds.CreateLayer('second')
+    lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger64))
+    lyr.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('str', ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn('val', ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn('list', ogr.OFTIntegerList))
+    lyr.CreateField(ogr.FieldDefn('dt', ogr.OFTDateTime))
+    for i in range(60):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i % 7 != 0:
+            f['int'] = i % 30
+            f['real'] = (i % 30) + 0.5
+            f['str'] = 'KEY%d' % (i % 30)
+        f['val'] = 'val%d' % i
+        f['list'] = [i, i + 1]
+        f['dt'] = '2018/01/%02d 12:34:56' % (1 + i % 28)
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i, i)))
+        lyr.CreateFeature(f)
+
+    for key in ['int', 'real', 'str']:
+        sql = 'SELECT first.%s, second.val, second.list, second.dt ' % key + \
+              'FROM first LEFT JOIN second ON first.%s = second.%s' % (key, key)
+        gdal.SetConfigOption('OGR_SQL_JOIN_HASH', 'NO')
+        expected = ogr_join_24_get_result(ds, sql)
+        gdal.SetConfigOption('OGR_SQL_JOIN_HASH', None)
+        got = ogr_join_24_get_result(ds, sql)
+        if got != expected:
+            gdaltest.post_reason('fail')
+            print(key)
+            print(got)
+            print(expected)
+            return 'fail'
+        gdal.SetConfigOption('OGR_SQL_JOIN_MAX_MEMORY', '0')
+        got = ogr_join_24_get_result(ds, sql)
+        gdal.SetConfigOption('OGR_SQL_JOIN_MAX_MEMORY', None)
+        if got != expected:
+            gdaltest.post_reason('fail')
+            print(key)
+            print(got)
+            print(expected)
+            return 'fail'
+
+    if expected[1] != ['key1', 'val1', [1, 2], '2018/01/02 12:34:56']:
+        gdaltest.post_reason('fail')
+        print(expected[1])
+        return 'fail'
+
+    # Numeric keys of different types
+    sql = 'SELECT second.val FROM first LEFT JOIN second ON first.int = second.real'
+    gdal.SetConfigOption('OGR_SQL_JOIN_HASH', 'NO')
+    expected = ogr_join_24_get_result(ds, sql)
+    gdal.SetConfigOption('OGR_SQL_JOIN_HASH', None)
+    got = ogr_join_24_get_result(ds, sql)
+    if got != expected:
+        gdaltest.post_reason('fail')
+        print(got)
+        print(expected)
+        return 'fail'
+
+    ds = None
+
+    return 'success'
+
 ###############################################################################
 
 def ogr_join_cleanup():
@@ -581,6 +672,7 @@ gdaltest_list = [
     ogr_join_21,
     ogr_join_22,
     ogr_join_23,
+    ogr_join_24,
     ogr_join_cleanup ]
 
 if __name__ == '__main__':
@@ -1104,6 +1104,15 @@ def get_spi_state(ds, lyr):
 
 def ogr_openfilegdb_11():
 
+    # Those tests are about the in-memory spatial index, which is not used
+    # when the .spx file is
+    gdal.SetConfigOption('OPENFILEGDB_USE_SPATIAL_INDEX', 'NO')
+    ret = ogr_openfilegdb_11_internal()
+    gdal.SetConfigOption('OPENFILEGDB_USE_SPATIAL_INDEX', None)
+    return ret
+
+def ogr_openfilegdb_11_internal():
+
     # Test building spatial index with GetFeatureCount()
     ds = ogr.Open('data/testopenfilegdb.gdb.zip')
     lyr = ds.GetLayerByName('several_polygons')
@@ -1289,6 +1298,60 @@ def ogr_openfilegdb_11():
     ds = None
     return 'success'
 
+###############################################################################
+# Test spatial filtering with the .spx spatial index
+
+def ogr_openfilegdb_11bis():
+
+    # Make sure the comparison is done with a sequential scan
+    gdal.SetConfigOption('OPENFILEGDB_IN_MEMORY_SPI', 'NO')
+    ret = ogr_openfilegdb_11bis_internal()
+    gdal.SetConfigOption('OPENFILEGDB_IN_MEMORY_SPI', None)
+    return ret
+
+def ogr_openfilegdb_11bis_internal():
+
+    ds = ogr.Open('data/testopenfilegdb.gdb.zip')
+    for lyr_name in [ 'several_polygons', 'multipolygon', 'linestring',
+                      'polygon', 'multilinestring' ]:
+        lyr = ds.GetLayerByName(lyr_name)
+        minx, maxx, miny, maxy = lyr.GetExtent()
+        for (x0, y0, x1, y1) in [ (0.25, 0.25, 0.5, 0.5),
+                                  (minx, miny, (minx + maxx) / 2, (miny + maxy) / 2),
+                                  ((minx + maxx) / 2, miny, maxx, (miny + maxy) / 2),
+                                  (maxx + 1, maxy + 1, maxx + 2, maxy + 2) ]:
+            res = []
+            for use_spx in [ 'YES', 'NO' ]:
+                gdal.SetConfigOption('OPENFILEGDB_USE_SPATIAL_INDEX', use_spx)
+                lyr.SetSpatialFilterRect(x0, y0, x1, y1)
+                gdal.SetConfigOption('OPENFILEGDB_USE_SPATIAL_INDEX', None)
+                fids = [ f.GetFID() for f in lyr ]
+                res.append((fids, lyr.GetFeatureCount()))
+                lyr.SetSpatialFilter(None)
+            if res[0] != res[1] or len(res[0][0]) != res[0][1]:
+                gdaltest.post_reason('failure')
+                print(lyr_name, x0, y0, x1, y1, res)
+                return 'fail'
+
+    # SetNextByIndex() on the candidates returned by the spatial index
+    lyr = ds.GetLayerByName('several_polygons')
+    lyr.SetSpatialFilterRect(0.25,0.25,0.5,0.5)
+    if lyr.TestCapability(ogr.OLCFastSetNextByIndex) != 0:
+        gdaltest.post_reason('failure')
+        return 'fail'
+    if lyr.SetNextByIndex(0) != 0:
+        gdaltest.post_reason('failure')
+        return 'fail'
+    feat = lyr.GetNextFeature()
+    if feat.GetFID() != 1:
+        gdaltest.post_reason('failure')
+        return 'fail'
+    if lyr.GetNextFeature() is not None:
+        gdaltest.post_reason('failure')
+        return 'fail'
+
+    return 'success'
+
 ###############################################################################
 # Test opening a FGDB with both SRID and LatestSRID set (#5638)
 
@@ -1532,6 +1595,7 @@ gdaltest_list = [
     ogr_openfilegdb_9,
     ogr_openfilegdb_10,
     ogr_openfilegdb_11,
+    ogr_openfilegdb_11bis,
     ogr_openfilegdb_12,
     ogr_openfilegdb_13,
     ogr_openfilegdb_14,
@@ -939,6 +939,38 @@ def ogr_osm_17():
 
     return 'success'
 
+###############################################################################
+# Test multi-threaded decoding of PBF blocks (OSM_NUM_THREADS)
+
+def ogr_osm_18_get_features(filename):
+
+    ds = ogr.Open(filename)
+    res = []
+    for i in range(ds.GetLayerCount()):
+        lyr = ds.GetLayer(i)
+        for f in lyr:
+            res.append(f.ExportToJson())
+    ds = None
+    return res
+
+def ogr_osm_18():
+
+    if ogrtest.osm_drv is None:
+        return 'skip'
+
+    for filename in [ 'data/test.pbf',
+                      'data/test_uncompressed_dense_false.pbf' ]:
+        ref = ogr_osm_18_get_features(filename)
+        gdal.SetConfigOption('OSM_NUM_THREADS', '4')
+        got = ogr_osm_18_get_features(filename)
+        gdal.SetConfigOption('OSM_NUM_THREADS', None)
+        if got != ref:
+            gdaltest.post_reason('fail')
+            print(filename)
+            return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     ogr_osm_1,
     ogr_osm_2,
@@ -962,6 +994,7 @@ gdaltest_list = [
     ogr_osm_15,
     ogr_osm_16,
     ogr_osm_17,
+    ogr_osm_18,
     ]
 
 if __name__ == '__main__':
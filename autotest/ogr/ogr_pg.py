@@ -1450,7 +1450,7 @@ def ogr_pg_25():
 ###############################################################################
 # Test with PGB: connection
 
-def ogr_pg_26_DISABLED_AS_BINARY_CURSOR_NO_LONGER_SUPPORTED():
+def ogr_pg_26():
 
     if gdaltest.pg_ds is None:
         return 'skip'
@@ -1486,7 +1486,7 @@ def ogr_pg_26_DISABLED_AS_BINARY_CURSOR_NO_LONGER_SUPPORTED():
 ###############################################################################
 # Test with PGB: connection and SELECT query
 
-def ogr_pg_27_DISABLED_AS_BINARY_CURSOR_NO_LONGER_SUPPORTED():
+def ogr_pg_27():
 
     if gdaltest.pg_ds is None:
         return 'skip'
@@ -5448,6 +5448,187 @@ def ogr_pg_86():
 
     return 'success'
 
+###############################################################################
+# Test reading with the prefetching of the next cursor page, interleaved
+# with other requests, in text and binary cursor modes
+
+def ogr_pg_87():
+
+    if gdaltest.pg_ds is None:
+        return 'skip'
+
+    lyr = gdaltest.pg_ds.CreateLayer('ogr_pg_87', geom_type = ogr.wkbPoint,
+                                     options = ['OVERWRITE=YES'])
+    lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('str', ogr.OFTString))
+    lyr.StartTransaction()
+    for i in range(20):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetField('int', i)
+        f.SetField('real', i + 0.5)
+        f.SetField('str', 'foo%d' % i)
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i, -i)))
+        lyr.CreateFeature(f)
+    lyr.CommitTransaction()
+
+    for (prefix, prefetch) in [ ('PG:', 'YES'), ('PGB:', 'YES'),
+                                ('PG:', 'NO') ]:
+        gdal.SetConfigOption('OGR_PG_CURSOR_PREFETCH', prefetch)
+        gdal.SetConfigOption('OGR_PG_CURSOR_PAGE', '3')
+        ds = ogr.Open(prefix + gdaltest.pg_connection_string)
+        gdal.SetConfigOption('OGR_PG_CURSOR_PAGE', None)
+        lyr1 = ds.GetLayerByName('ogr_pg_87')
+        lyr2 = ds.ExecuteSQL('SELECT * FROM ogr_pg_87 ORDER BY int DESC')
+        for i in range(20):
+            f = lyr1.GetNextFeature()
+            if f is None or f['int'] != i or f['real'] != i + 0.5 or \
+               f['str'] != 'foo%d' % i or \
+               f.GetGeometryRef().ExportToWkt() != 'POINT (%d %d)' % (i, -i):
+                gdaltest.post_reason('fail')
+                print(prefix)
+                if f is not None:
+                    f.DumpReadable()
+                return 'fail'
+            f = lyr2.GetNextFeature()
+            if f is None or f['int'] != 19 - i:
+                gdaltest.post_reason('fail')
+                print(prefix)
+                return 'fail'
+            if i == 10:
+                sql_lyr = ds.ExecuteSQL('SELECT COUNT(*) FROM ogr_pg_87')
+                f = sql_lyr.GetNextFeature()
+                if f.GetField(0) != 20:
+                    gdaltest.post_reason('fail')
+                    return 'fail'
+                ds.ReleaseResultSet(sql_lyr)
+                f = lyr1.GetFeature(3)
+                if f is None or f['int'] != 2:
+                    gdaltest.post_reason('fail')
+                    return 'fail'
+        if lyr1.GetNextFeature() is not None or \
+           lyr2.GetNextFeature() is not None:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        ds.ReleaseResultSet(lyr2)
+
+        lyr1.SetNextByIndex(7)
+        f = lyr1.GetNextFeature()
+        if f is None or f['int'] != 7:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        lyr1.ResetReading()
+        f = lyr1.GetNextFeature()
+        if f is None or f['int'] != 0:
+            gdaltest.post_reason('fail')
+            return 'fail'
+        ds = None
+        gdal.SetConfigOption('OGR_PG_CURSOR_PREFETCH', None)
+
+    return 'success'
+
+###############################################################################
+# Test that binary and text COPY give the same results
+
+def ogr_pg_88():
+
+    if gdaltest.pg_ds is None:
+        return 'skip'
+
+    # Naive datetimes are interpreted in the time zone of the session, so
+    # also test with a time zone that is not UTC
+    for time_zone in ['UTC', 'Europe/Paris']:
+        gdaltest.pg_ds.ExecuteSQL("SET TIME ZONE '%s'" % time_zone)
+        for datetime_type in ['timestamp', 'timestamp with time zone']:
+            ret = ogr_pg_88_compare(datetime_type)
+            if ret != 'success':
+                print(time_zone, datetime_type)
+                gdaltest.pg_ds.ExecuteSQL('SET TIME ZONE DEFAULT')
+                return ret
+    gdaltest.pg_ds.ExecuteSQL('SET TIME ZONE DEFAULT')
+
+    return 'success'
+
+def ogr_pg_88_compare(datetime_type):
+
+    for copy_binary in ['YES', 'NO']:
+        layer_name = 'ogr_pg_88_' + copy_binary.lower()
+        lyr = gdaltest.pg_ds.CreateLayer(layer_name, geom_type = ogr.wkbPoint,
+                                         options = ['OVERWRITE=YES',
+                                                    'COLUMN_TYPES=datetime=' + datetime_type])
+        lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger))
+        fld_defn = ogr.FieldDefn('bool', ogr.OFTInteger)
+        fld_defn.SetSubType(ogr.OFSTBoolean)
+        lyr.CreateField(fld_defn)
+        lyr.CreateField(ogr.FieldDefn('int64', ogr.OFTInteger64))
+        lyr.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+        fld_defn = ogr.FieldDefn('numeric', ogr.OFTReal)
+        fld_defn.SetWidth(15)
+        fld_defn.SetPrecision(4)
+        lyr.CreateField(fld_defn)
+        fld_defn = ogr.FieldDefn('str', ogr.OFTString)
+        fld_defn.SetWidth(5)
+        lyr.CreateField(fld_defn)
+        lyr.CreateField(ogr.FieldDefn('longstr', ogr.OFTString))
+        lyr.CreateField(ogr.FieldDefn('date', ogr.OFTDate))
+        lyr.CreateField(ogr.FieldDefn('time', ogr.OFTTime))
+        lyr.CreateField(ogr.FieldDefn('datetime', ogr.OFTDateTime))
+        lyr.CreateField(ogr.FieldDefn('binary', ogr.OFTBinary))
+        lyr.CreateField(ogr.FieldDefn('intlist', ogr.OFTIntegerList))
+        lyr.CreateField(ogr.FieldDefn('int64list', ogr.OFTInteger64List))
+        lyr.CreateField(ogr.FieldDefn('reallist', ogr.OFTRealList))
+        lyr.CreateField(ogr.FieldDefn('strlist', ogr.OFTStringList))
+
+        # More than 1 MB of data to have several batches sent
+        gdal.SetConfigOption('PG_USE_COPY', 'YES')
+        gdal.SetConfigOption('PG_USE_COPY_BINARY', copy_binary)
+        lyr.StartTransaction()
+        for i in range(5000):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            if i % 10 != 0:
+                f.SetField('int', i - 2500)
+                f.SetField('bool', i % 2)
+                f.SetField('int64', 1234567890123 * (i - 2500))
+                f.SetField('real', (i - 2500) * 1.25e-3)
+                f.SetField('numeric', (i - 2500) * 1.5 + 0.0625)
+                f.SetField('str', 'abcdefgh'[i % 4:])
+                f.SetField('longstr', ('%05d' % i) * 50)
+                f.SetField('date', '%04d/%02d/%02d' % (1900 + i % 200, 1 + i % 12, 1 + i % 28))
+                f.SetField('time', '%02d:%02d:%02d' % (i % 24, i % 60, (i * 7) % 60))
+                # Without time zone, in UTC, and with an offset
+                f.SetField('datetime', '%04d/%02d/%02d %02d:%02d:%06.3f%s' % (1900 + i % 200, 1 + i % 12, 1 + i % 28, i % 24, i % 60, (i * 7) % 60 + 0.125, ['', '+00', '+05:30'][i % 3]))
+                f.SetFieldBinaryFromHexString('binary', '0001FF%04X' % i)
+                f.SetFieldIntegerList(f.GetFieldIndex('intlist'), [i, -i])
+                f.SetFieldInteger64List(f.GetFieldIndex('int64list'), [1234567890123 * i])
+                f.SetFieldDoubleList(f.GetFieldIndex('reallist'), [i + 0.5, -1.5])
+                f.SetFieldStringList(f.GetFieldIndex('strlist'), ['a%d' % i, 'b,"c'])
+                f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i, -i)))
+            lyr.CreateFeature(f)
+        lyr.CommitTransaction()
+        gdal.SetConfigOption('PG_USE_COPY', None)
+        gdal.SetConfigOption('PG_USE_COPY_BINARY', None)
+
+    lyr_binary = gdaltest.pg_ds.GetLayerByName('ogr_pg_88_yes')
+    lyr_text = gdaltest.pg_ds.GetLayerByName('ogr_pg_88_no')
+    lyr_binary.ResetReading()
+    lyr_text.ResetReading()
+    if lyr_binary.GetFeatureCount() != 5000:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    for i in range(5000):
+        f_binary = lyr_binary.GetNextFeature()
+        f_text = lyr_text.GetNextFeature()
+        if f_binary.Equal(f_text) == 0:
+            gdaltest.post_reason('fail')
+            f_binary.DumpReadable()
+            f_text.DumpReadable()
+            return 'fail'
+    if lyr_binary.GetNextFeature() is not None:
+        gdaltest.post_reason('fail')
+        return 'fail'
+
+    return 'success'
+
 ###############################################################################
 #
 
@@ -5463,7 +5644,7 @@ def ogr_pg_table_cleanup():
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:datetest' )
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:testgeom' )
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:datatypetest' )
-    #gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:datatypetest_withouttimestamptz' )
+    gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:datatypetest_withouttimestamptz' )
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:datatypetest2' )
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:testsrtext' )
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:testsrtext2' )
@@ -5515,6 +5696,9 @@ def ogr_pg_table_cleanup():
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_85_1' )
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_85_2' )
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_86' )
+    gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_87' )
+    gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_88_yes' )
+    gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_88_no' )
 
     # Drop second 'tpoly' from schema 'AutoTest-schema' (do NOT quote names here)
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:AutoTest-schema.tpoly' )
@@ -5571,8 +5755,8 @@ gdaltest_list_internal = [
     ogr_pg_23,
     ogr_pg_24,
     ogr_pg_25,
-    #ogr_pg_26,
-    #ogr_pg_27,
+    ogr_pg_26,
+    ogr_pg_27,
     ogr_pg_28,
     ogr_pg_29,
     ogr_pg_30,
@@ -5635,6 +5819,8 @@ gdaltest_list_internal = [
     ogr_pg_84,
     ogr_pg_85,
     ogr_pg_86,
+    ogr_pg_87,
+    ogr_pg_88,
     ogr_pg_cleanup
 ]
 
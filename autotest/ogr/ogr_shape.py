@@ -5124,6 +5124,109 @@ def ogr_shape_106():
 
     return 'success'
 
+###############################################################################
+# Test spatial filtering without .qix, with the in-memory spatial index and
+# with the record header bounding box prefilter.
+
+def ogr_shape_107_get_fids(lyr):
+
+    ret = []
+    for f in lyr:
+        ret.append(f.GetFID())
+    return ret
+
+def ogr_shape_107():
+
+    shape_drv = ogr.GetDriverByName('ESRI Shapefile')
+    for geom_type in [ogr.wkbPoint, ogr.wkbLineString]:
+        ds = shape_drv.CreateDataSource('/vsimem/ogr_shape_107.shp')
+        lyr = ds.CreateLayer('ogr_shape_107', geom_type = geom_type)
+        for i in range(1000):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            x = i % 40
+            y = i // 40
+            if i % 3 == 0:
+                pass
+            elif geom_type == ogr.wkbPoint:
+                f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (x, y)))
+            elif i % 3 == 1:
+                f.SetGeometry(ogr.CreateGeometryFromWkt(
+                    'LINESTRING(%d %d,%d %d)' % (x, y, x + 1, y + 1)))
+            else:
+                # Degenerate bounding box
+                f.SetGeometry(ogr.CreateGeometryFromWkt(
+                    'LINESTRING(%d %d,%d %d)' % (x, y, x + 1, y)))
+            lyr.CreateFeature(f)
+        ds = None
+
+        ds = ogr.Open('/vsimem/ogr_shape_107.shp')
+        lyr = ds.GetLayer(0)
+        expected = []
+        for f in lyr:
+            g = f.GetGeometryRef()
+            if g is None:
+                expected.append(f.GetFID())
+                continue
+            (minx, maxx, miny, maxy) = g.GetEnvelope()
+            if maxx >= 10.5 and minx <= 20.5 and maxy >= 5.5 and miny <= 10.5:
+                expected.append(f.GetFID())
+        ds = None
+
+        for option in ['YES', 'NO']:
+            gdal.SetConfigOption('SHAPE_IN_MEMORY_SPATIAL_INDEX', option)
+            ds = ogr.Open('/vsimem/ogr_shape_107.shp')
+            gdal.SetConfigOption('SHAPE_IN_MEMORY_SPATIAL_INDEX', None)
+            lyr = ds.GetLayer(0)
+            lyr.SetSpatialFilterRect(10.5, 5.5, 20.5, 10.5)
+            got = ogr_shape_107_get_fids(lyr)
+            if got != expected:
+                gdaltest.post_reason('fail')
+                print(geom_type, option)
+                print(got)
+                print(expected)
+                return 'fail'
+            if lyr.GetFeatureCount() != len(expected):
+                gdaltest.post_reason('fail')
+                print(geom_type, option)
+                return 'fail'
+            lyr.SetAttributeFilter('FID >= 500')
+            got = ogr_shape_107_get_fids(lyr)
+            if got != [fid for fid in expected if fid >= 500]:
+                gdaltest.post_reason('fail')
+                print(geom_type, option)
+                print(got)
+                return 'fail'
+            ds = None
+
+        shape_drv.DeleteDataSource( '/vsimem/ogr_shape_107.shp' )
+
+    # The in-memory spatial index must take into account new features
+    ds = shape_drv.CreateDataSource('/vsimem/ogr_shape_107.shp')
+    lyr = ds.CreateLayer('ogr_shape_107', geom_type = ogr.wkbPoint)
+    for i in range(10):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%d %d)' % (i, i)))
+        lyr.CreateFeature(f)
+    ds = None
+    ds = ogr.Open('/vsimem/ogr_shape_107.shp', update = 1)
+    lyr = ds.GetLayer(0)
+    lyr.SetSpatialFilterRect(1.5, 1.5, 20, 20)
+    if lyr.GetFeatureCount() != 8:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(15 15)'))
+    lyr.CreateFeature(f)
+    lyr.SetSpatialFilterRect(1.5, 1.5, 20, 20)
+    if ogr_shape_107_get_fids(lyr) != [2, 3, 4, 5, 6, 7, 8, 9, 10]:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    ds = None
+
+    shape_drv.DeleteDataSource( '/vsimem/ogr_shape_107.shp' )
+
+    return 'success'
+
 ###############################################################################
 def ogr_shape_cleanup():
 
@@ -5274,6 +5377,7 @@ gdaltest_list = [
     ogr_shape_104,
     ogr_shape_105,
     ogr_shape_106,
+    ogr_shape_107,
     ogr_shape_cleanup ]
 
 # gdaltest_list = [ ogr_shape_106 ]
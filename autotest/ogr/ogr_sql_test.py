@@ -1541,6 +1541,152 @@ def ogr_sql_48():
 
     return 'success'
 
+###############################################################################
+# Test sorting with sorted runs spilled to disk, with several threads, and
+# with LIMIT
+
+def ogr_sql_49_get_result(ds, sql):
+
+    sql_lyr = ds.ExecuteSQL(sql)
+    ret = []
+    for f in sql_lyr:
+        ret.append((f.GetFID(), f['int_field'], f['str_field'], f['date_field']))
+    ds.ReleaseResultSet(sql_lyr)
+    return ret
+
+def ogr_sql_49():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbNone)
+    lyr.CreateField( ogr.FieldDefn( 'int_field', ogr.OFTInteger) )
+    lyr.CreateField( ogr.FieldDefn( 'str_field', ogr.OFTString) )
+    lyr.CreateField( ogr.FieldDefn( 'date_field', ogr.OFTDate) )
+    for i in range(30000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if (i % 11) != 0:
+            f['int_field'] = (i * 7919) % 1000
+        if (i % 13) != 0:
+            f['str_field'] = 'val%d' % ((i * 104729) % 500)
+        f['date_field'] = '2018/%02d/%02d' % (1 + i % 12, 1 + i % 28)
+        lyr.CreateFeature(f)
+
+    sql = 'SELECT * FROM test ORDER BY str_field DESC, date_field, int_field'
+    expected = ogr_sql_49_get_result(ds, sql)
+    if len(expected) != 30000:
+        gdaltest.post_reason('fail')
+        return 'fail'
+    for i in range(1, len(expected)):
+        prev = expected[i-1]
+        cur = expected[i]
+        if prev[2] is not None and cur[2] is not None and prev[2] < cur[2]:
+            gdaltest.post_reason('fail')
+            print(prev, cur)
+            return 'fail'
+
+    for (max_memory, num_threads) in [ ('0.01', None), (None, '4'),
+                                       ('0.5', '3') ]:
+        gdal.SetConfigOption('OGR_SQL_SORT_MAX_MEMORY', max_memory)
+        gdal.SetConfigOption('OGR_SQL_SORT_NUM_THREADS', num_threads)
+        got = ogr_sql_49_get_result(ds, sql)
+        got_limit = ogr_sql_49_get_result(ds, sql + ' LIMIT 1000 OFFSET 5')
+        gdal.SetConfigOption('OGR_SQL_SORT_MAX_MEMORY', None)
+        gdal.SetConfigOption('OGR_SQL_SORT_NUM_THREADS', None)
+        if got != expected:
+            gdaltest.post_reason('fail')
+            print(max_memory, num_threads)
+            return 'fail'
+        if got_limit != expected[5:1005]:
+            gdaltest.post_reason('fail')
+            print(max_memory, num_threads)
+            return 'fail'
+
+    for limit in [1, 10, 29999, 30000, 40000]:
+        got = ogr_sql_49_get_result(ds, sql + ' LIMIT %d' % limit)
+        if got != expected[0:limit]:
+            gdaltest.post_reason('fail')
+            print(limit)
+            return 'fail'
+
+    # Already sorted
+    got = ogr_sql_49_get_result(ds, 'SELECT * FROM test ORDER BY FID LIMIT 10 OFFSET 3')
+    if [x[0] for x in got] != [i for i in range(3, 13)]:
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    return 'success'
+
+
+###############################################################################
+# Test that compiled WHERE expressions give the same results as the
+# evaluation of the expression tree
+
+def ogr_sql_50_get_fids(lyr, where):
+
+    lyr.SetAttributeFilter(where)
+    ret = [f.GetFID() for f in lyr]
+    lyr.SetAttributeFilter(None)
+    return ret
+
+def ogr_sql_50():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbNone)
+    lyr.CreateField( ogr.FieldDefn( 'int_field', ogr.OFTInteger) )
+    lyr.CreateField( ogr.FieldDefn( 'int64_field', ogr.OFTInteger64) )
+    lyr.CreateField( ogr.FieldDefn( 'real_field', ogr.OFTReal) )
+    lyr.CreateField( ogr.FieldDefn( 'str_field', ogr.OFTString) )
+    lyr.CreateField( ogr.FieldDefn( 'date_field', ogr.OFTDate) )
+    strs = [ 'foo', 'FOO', 'bar', '', 'foobar', 'a_b',
+             '2018/01/01 10:00:00+00', '2018/01/01 10:00:00' ]
+    for i in range(300):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if (i % 5) != 0:
+            f['int_field'] = i % 13 - 6
+        if (i % 7) != 0:
+            f['int64_field'] = (i % 11 - 5) * 10000000000
+        if (i % 3) != 0:
+            f['real_field'] = (i % 9) * 0.5 - 2
+        if (i % 4) != 0:
+            f['str_field'] = strs[i % len(strs)]
+        if (i % 6) != 0:
+            f['date_field'] = '2018/01/%02d' % (1 + i % 20)
+        lyr.CreateFeature(f)
+
+    wheres = [ 'int_field = 3', 'int_field <> 3', 'int_field >= 2.5',
+               'int64_field > 0', 'int64_field < int_field',
+               'int64_field = 2 * 10000000000',
+               'real_field <= int_field', 'real_field IN (0.5, 1.5)',
+               'int_field IN (1, 2, 3)', 'int_field NOT IN (1, 2.5)',
+               'int_field BETWEEN -2 AND 2', 'real_field BETWEEN -1 AND 1.5',
+               "str_field = 'foo'", "str_field > 'bar'",
+               "str_field IN ('foo', 'bar')", "str_field BETWEEN 'a' AND 'fz'",
+               "str_field LIKE 'f%'", "str_field NOT LIKE 'a#_b' ESCAPE '#'",
+               "str_field = '2018/01/01 10:00:00'",
+               "str_field = '2018/01/01 10:00:00+00'",
+               'int_field IS NULL', 'str_field IS NOT NULL',
+               'date_field IS NULL', "date_field > '2018/01/10'",
+               "int_field > 0 AND (real_field > 0 OR str_field = 'bar')",
+               'NOT (int_field > 0 AND real_field > 0) OR str_field IS NULL',
+               "(int_field > 0 OR int_field < -3) AND date_field > '2018/01/05'",
+               'int_field > 1 + 1', 'int_field + 1 > 3', 'int_field = NULL',
+               'int_field > 0 AND 1 = 1', 'int_field > 0 OR 1 = 1',
+               'NOT (1 = 0) AND int_field < 0', 'int_field > 0 AND NULL',
+               'FID > 100', 'FID IN (1, 2, 3, 150)' ]
+    for where in wheres:
+        gdal.SetConfigOption('OGR_SQL_COMPILE_WHERE', 'NO')
+        expected = ogr_sql_50_get_fids(lyr, where)
+        gdal.SetConfigOption('OGR_SQL_COMPILE_WHERE', None)
+        got = ogr_sql_50_get_fids(lyr, where)
+        if got != expected:
+            gdaltest.post_reason('fail')
+            print(where)
+            print(got)
+            print(expected)
+            return 'fail'
+
+    return 'success'
+
 
 def ogr_sql_cleanup():
     gdaltest.lyr = None
@@ -1599,6 +1745,8 @@ gdaltest_list = [
     ogr_sql_46,
     ogr_sql_47,
     ogr_sql_48,
+    ogr_sql_49,
+    ogr_sql_50,
     ogr_sql_cleanup ]
 
 if __name__ == '__main__':
@@ -322,6 +322,53 @@ def osr_ct_8():
 
     return 'success'
 
+###############################################################################
+# Test that transformations created after destroying a transformation between
+# the same SRS, which reuse its PROJ.4 objects, behave identically.
+
+def osr_ct_9():
+
+    if gdaltest.have_proj4 == 0:
+        return 'skip'
+
+    src_srs = osr.SpatialReference()
+    src_srs.ImportFromEPSG( 4326 )
+
+    dst_srs = osr.SpatialReference()
+    dst_srs.ImportFromEPSG( 32631 )
+
+    expected_result = None
+    for cache_size in [ None, '0' ]:
+        gdal.SetConfigOption('OGR_CT_CACHE_SIZE', cache_size)
+        for i in range(3):
+            ct = osr.CoordinateTransformation( src_srs, dst_srs )
+            # Keep several transformations alive at the same time
+            ct2 = osr.CoordinateTransformation( src_srs, dst_srs )
+            result = ct.TransformPoint( 2, 49, 0 )
+            result2 = ct2.TransformPoint( 2, 49, 0 )
+            if expected_result is None:
+                expected_result = result
+            if result != expected_result or result2 != expected_result:
+                gdaltest.post_reason('fail')
+                print(result)
+                print(result2)
+                print(expected_result)
+                gdal.SetConfigOption('OGR_CT_CACHE_SIZE', None)
+                return 'fail'
+            ct = None
+            ct2 = None
+        gdal.SetConfigOption('OGR_CT_CACHE_SIZE', None)
+
+    # Reverse transformation must not get the cached direct one
+    ct = osr.CoordinateTransformation( dst_srs, src_srs )
+    result = ct.TransformPoint( expected_result[0], expected_result[1], 0 )
+    if abs(result[0] - 2) > 1e-8 or abs(result[1] - 49) > 1e-8:
+        gdaltest.post_reason('fail')
+        print(result)
+        return 'fail'
+
+    return 'success'
+
 ###############################################################################
 # Cleanup
 
@@ -343,6 +390,7 @@ gdaltest_list = [
     osr_ct_6,
     osr_ct_7,
     osr_ct_8,
+    osr_ct_9,
     osr_ct_cleanup,
     None ]
 
@@ -35,6 +35,7 @@ import sys
 sys.path.append( '../pymod' )
 
 import gdaltest
+from osgeo import gdal
 from osgeo import osr
 
 ###############################################################################
@@ -287,6 +288,51 @@ def osr_epsg_11():
 
     return 'success'
 
+###############################################################################
+# Test that importing the same code several times, which uses the EPSG import
+# cache, gives the same result as without the cache.
+
+def osr_epsg_12():
+
+    for code in [ 4326, 4979, 32631, 2065, 3857, 7401 ]:
+        srs = osr.SpatialReference()
+        srs.ImportFromEPSG( code )
+        wkt_ref = srs.ExportToWkt()
+
+        for cache_size in [ None, '0' ]:
+            gdal.SetConfigOption('OSR_EPSG_CACHE_SIZE', cache_size)
+            srs = osr.SpatialReference()
+            srs.ImportFromEPSG( code )
+            gdal.SetConfigOption('OSR_EPSG_CACHE_SIZE', None)
+            if srs.ExportToWkt() != wkt_ref:
+                gdaltest.post_reason('fail')
+                print(code)
+                print(cache_size)
+                print(srs.ExportToWkt())
+                print(wkt_ref)
+                return 'fail'
+
+        # Modifying the SRS must not alter the cached definition
+        srs.SetAuthority('GEOGCS', 'FOO', 1)
+        srs = osr.SpatialReference()
+        srs.ImportFromEPSG( code )
+        if srs.ExportToWkt() != wkt_ref:
+            gdaltest.post_reason('fail')
+            print(code)
+            return 'fail'
+
+    # Failures are not cached
+    for i in range(2):
+        srs = osr.SpatialReference()
+        with gdaltest.error_handler():
+            ret = srs.ImportFromEPSG( 123456789 )
+        if ret == 0 or gdal.GetLastErrorMsg().find('123456789') < 0:
+            gdaltest.post_reason('fail')
+            print(gdal.GetLastErrorMsg())
+            return 'fail'
+
+    return 'success'
+
 ###############################################################################
 
 gdaltest_list = [
@@ -301,6 +347,7 @@ gdaltest_list = [
     osr_epsg_9,
     osr_epsg_10,
     osr_epsg_11,
+    osr_epsg_12,
     None ]
 
 if __name__ == '__main__':
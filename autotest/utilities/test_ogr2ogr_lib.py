@@ -33,7 +33,7 @@ import sys
 
 sys.path.append( '../pymod' )
 
-from osgeo import gdal, ogr
+from osgeo import gdal, ogr, osr
 import gdaltest
 import ogrtest
 
@@ -408,6 +408,66 @@ def test_ogr2ogr_lib_18():
 
     return 'success'
 
+###############################################################################
+# Test reprojection of features by batches, with points failing to reproject
+
+def test_ogr2ogr_lib_19():
+
+    src_srs = osr.SpatialReference()
+    src_srs.SetWellKnownGeogCS('WGS84')
+    dst_srs = osr.SpatialReference()
+    dst_srs.ImportFromEPSG(3857)
+    try:
+        gdal.PushErrorHandler('CPLQuietErrorHandler')
+        ct = osr.CoordinateTransformation(src_srs, dst_srs)
+        gdal.PopErrorHandler()
+    except ValueError:
+        gdal.PopErrorHandler()
+        ct = None
+    if ct is None or ct.this is None:
+        gdaltest.post_reason('PROJ.4 missing, transforms not available.')
+        return 'skip'
+
+    src_ds = gdal.GetDriverByName('Memory').Create('', 0, 0, 0)
+    src_lyr = src_ds.CreateLayer('test', srs = src_srs)
+    src_lyr.CreateField(ogr.FieldDefn('id', ogr.OFTInteger))
+    for i in range(50):
+        f = ogr.Feature(src_lyr.GetLayerDefn())
+        f.SetField('id', i)
+        if i % 7 == 3:
+            # Cannot be reprojected to Web Mercator
+            wkt = 'LINESTRING (%d 10,%d 90)' % (i, i)
+        else:
+            wkt = 'POLYGON ((%d 0,%d 1,%d 1,%d 0))' % (i, i, i + 1, i)
+        f.SetGeometry(ogr.CreateGeometryFromWkt(wkt))
+        src_lyr.CreateFeature(f)
+
+    results = []
+    for batch_size in ['0', '3', '1000']:
+        gdal.SetConfigOption('OGR2OGR_REPROJECTION_BATCH_SIZE', batch_size)
+        with gdaltest.error_handler():
+            ds = gdal.VectorTranslate('', src_ds, format = 'Memory',
+                                      dstSRS = 'EPSG:3857',
+                                      skipFailures = True)
+        gdal.SetConfigOption('OGR2OGR_REPROJECTION_BATCH_SIZE', None)
+        lyr = ds.GetLayer(0)
+        results.append([(f.GetField('id'), f.GetGeometryRef().ExportToWkt())
+                        for f in lyr])
+        ds = None
+
+    if len(results[0]) == 0 or len(results[0]) == 50:
+        gdaltest.post_reason('fail')
+        print(len(results[0]))
+        return 'fail'
+    for i in range(1, len(results)):
+        if results[i] != results[0]:
+            gdaltest.post_reason('fail')
+            print(results[i])
+            print(results[0])
+            return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     test_ogr2ogr_lib_1,
     test_ogr2ogr_lib_2,
@@ -426,7 +486,8 @@ gdaltest_list = [
     test_ogr2ogr_lib_15,
     test_ogr2ogr_lib_16,
     test_ogr2ogr_lib_17,
-    test_ogr2ogr_lib_18
+    test_ogr2ogr_lib_18,
+    test_ogr2ogr_lib_19
     ]
 
 if __name__ == '__main__':
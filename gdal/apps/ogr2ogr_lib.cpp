@@ -354,6 +354,7 @@ typedef struct
     int          iSrcFIDField;
     int          iRequestedSrcGeomField;
     bool         bPreserveFID;
+    OGRFeature  *poReusableDstFeature; // kept between features, or NULL
 } TargetLayerInfo;
 
 typedef struct
@@ -422,6 +423,7 @@ public:
     bool                          m_bExplodeCollections;
     bool                          m_bNativeData;
     GIntBig                       m_nLimit;
+    bool                          m_bReuseDstFeature;
 
     int                 Translate(OGRFeature* poFeatureIn,
                                   TargetLayerInfo* psInfo,
@@ -2386,6 +2388,11 @@ GDALDatasetH GDALVectorTranslate( const char *pszDest, GDALDatasetH hDstDS, int
     oTranslator.m_bExplodeCollections = psOptions->bExplodeCollections;
     oTranslator.m_bNativeData = psOptions->bNativeData;
     oTranslator.m_nLimit = psOptions->nLimit;
+    // Resetting the target feature instead of destroying and recreating it
+    // for each source feature saves a few allocations per feature.
+    // OGR2OGR_REUSE_FEATURE=NO is only meant for benchmarking.
+    oTranslator.m_bReuseDstFeature =
+        CPLTestBool(CPLGetConfigOption("OGR2OGR_REUSE_FEATURE", "YES"));
 
     if( psOptions->nGroupTransactions )
     {
@@ -3988,6 +3995,7 @@ TargetLayerInfo* SetupTargetLayer::Setup(OGRLayer* poSrcLayer,
     else
         psInfo->iRequestedSrcGeomField = -1;
     psInfo->bPreserveFID = bPreserveFID;
+    psInfo->poReusableDstFeature = NULL;
 
     return psInfo;
 }
@@ -4008,6 +4016,7 @@ static void FreeTargetLayerInfo(TargetLayerInfo* psInfo)
     CPLFree(psInfo->papoCT);
     CPLFree(psInfo->papapszTransformOptions);
     CPLFree(psInfo->panMap);
+    OGRFeature::DestroyFeature(psInfo->poReusableDstFeature);
     CPLFree(psInfo);
 }
 
@@ -4175,6 +4184,100 @@ static bool SetupCT( TargetLayerInfo* psInfo,
     return true;
 }
 
+/************************************************************************/
+/*                          ReprojectionQueue                           */
+/*                                                                      */
+/*      Source features read ahead by LayerTranslator::Translate(),    */
+/*      whose geometry has been reprojected in bulk with                */
+/*      OGRGeometryFactory::transformGeometries(). This avoids          */
+/*      invoking the coordinate transformation on the few points of    */
+/*      each individual geometry, and allows reprojecting with several  */
+/*      threads when GDAL_NUM_THREADS is set.                           */
+/************************************************************************/
+
+class ReprojectionQueue
+{
+    std::vector<OGRFeature*> m_apoFeatures;
+    std::vector<int>         m_abReprojected;
+    size_t                   m_nNext;
+    bool                     m_bSourceExhausted;
+
+  public:
+    ReprojectionQueue() : m_nNext(0), m_bSourceExhausted(false) {}
+    ~ReprojectionQueue();
+
+    bool        IsEmpty() const { return m_nNext == m_apoFeatures.size(); }
+    bool        IsSourceExhausted() const { return m_bSourceExhausted; }
+    OGRFeature *Pop( bool& bReprojected );
+    void        Fill( OGRFeature* poFirstFeature, OGRLayer* poSrcLayer,
+                      int nBatchSize, OGRCoordinateTransformation* poCT );
+
+    static bool CanReproject( OGRCoordinateTransformation* poCT );
+};
+
+ReprojectionQueue::~ReprojectionQueue()
+{
+    for( ; m_nNext < m_apoFeatures.size(); m_nNext++ )
+        OGRFeature::DestroyFeature(m_apoFeatures[m_nNext]);
+}
+
+OGRFeature* ReprojectionQueue::Pop( bool& bReprojected )
+{
+    if( IsEmpty() )
+        return NULL;
+    bReprojected = m_abReprojected[m_nNext] != FALSE;
+    return m_apoFeatures[m_nNext++];
+}
+
+void ReprojectionQueue::Fill( OGRFeature* poFirstFeature,
+                              OGRLayer* poSrcLayer,
+                              int nBatchSize,
+                              OGRCoordinateTransformation* poCT )
+{
+    CPLAssert( IsEmpty() );
+    m_apoFeatures.resize(0);
+    m_nNext = 0;
+
+    m_apoFeatures.push_back(poFirstFeature);
+    while( static_cast<int>(m_apoFeatures.size()) < nBatchSize )
+    {
+        OGRFeature* poFeature = poSrcLayer->GetNextFeature();
+        if( poFeature == NULL )
+        {
+            m_bSourceExhausted = true;
+            break;
+        }
+        m_apoFeatures.push_back(poFeature);
+    }
+
+    std::vector<OGRGeometry*> apoGeoms;
+    for( size_t i = 0; i < m_apoFeatures.size(); i++ )
+        apoGeoms.push_back(m_apoFeatures[i]->GetGeometryRef());
+    m_abReprojected.resize(apoGeoms.size());
+    OGRGeometryFactory::transformGeometries(
+        &apoGeoms[0], static_cast<int>(apoGeoms.size()), poCT,
+        &m_abReprojected[0]);
+}
+
+/* Whether transforming with OGRGeometryFactory::transformWithOptions() */
+/* without options is equivalent to OGRGeometry::transform(). That is */
+/* not the case when GEOS is available and the target SRS is WGS84, */
+/* since polar and antimeridian corrections are then applied. */
+bool ReprojectionQueue::CanReproject( OGRCoordinateTransformation* poCT )
+{
+    if( poCT == NULL )
+        return false;
+    if( OGRGeometryFactory::haveGEOS() &&
+        poCT->GetSourceCS() != NULL && poCT->GetTargetCS() != NULL )
+    {
+        OGRSpatialReference oSRSWGS84;
+        oSRSWGS84.SetWellKnownGeogCS( "WGS84" );
+        if( poCT->GetTargetCS()->IsSame(&oSRSWGS84) )
+            return false;
+    }
+    return true;
+}
+
 /************************************************************************/
 /*                     LayerTranslator::Translate()                     */
 /************************************************************************/
@@ -4232,15 +4335,42 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
         }
     }
 
+/* -------------------------------------------------------------------- */
+/*      Read features ahead and reproject them in bulk, in the simple   */
+/*      cases where the geometry of the target feature is the one of    */
+/*      the source feature, only reprojected.                           */
+/* -------------------------------------------------------------------- */
+    ReprojectionQueue oReprojectionQueue;
+    int nReprojectionBatchSize = 0;
+    if( poFeatureIn == NULL && psOptions->nFIDToFetch == OGRNullFID &&
+        m_nLimit < 0 && m_poSrcDS != m_poODS &&
+        nSrcGeomFieldCount == 1 && nDstGeomFieldCount == 1 &&
+        !bExplodeCollections && iSrcZField == -1 &&
+        m_nCoordDim == COORD_DIM_UNCHANGED && m_eGeomOp == GEOMOP_NONE &&
+        m_poClipSrc == NULL )
+    {
+        nReprojectionBatchSize = atoi(
+            CPLGetConfigOption("OGR2OGR_REPROJECTION_BATCH_SIZE", "0"));
+    }
+
     bool bRet = true;
     while( true )
     {
         OGRFeature      *poDstFeature = NULL;
+        bool             bFromReprojectionQueue = false;
+        bool             bGeomReprojected = false;
 
         if( poFeatureIn != NULL )
             poFeature = poFeatureIn;
         else if( psOptions->nFIDToFetch != OGRNullFID )
             poFeature = poSrcLayer->GetFeature(psOptions->nFIDToFetch);
+        else if( !oReprojectionQueue.IsEmpty() )
+        {
+            poFeature = oReprojectionQueue.Pop(bGeomReprojected);
+            bFromReprojectionQueue = true;
+        }
+        else if( oReprojectionQueue.IsSourceExhausted() )
+            poFeature = NULL;
         else
             poFeature = poSrcLayer->GetNextFeature();
         if( m_nLimit >= 0 && psInfo->nFeaturesRead >= m_nLimit )
@@ -4260,6 +4390,24 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
             }
         }
 
+        if( nReprojectionBatchSize > 1 && !bFromReprojectionQueue &&
+            !psInfo->bPerFeatureCT &&
+            psInfo->papapszTransformOptions[0] == NULL )
+        {
+            OGRCoordinateTransformation* poCT =
+                m_bTransform ? psInfo->papoCT[0] : m_poGCPCoordTrans;
+            if( ReprojectionQueue::CanReproject(poCT) )
+            {
+                oReprojectionQueue.Fill(poFeature, poSrcLayer,
+                                        nReprojectionBatchSize, poCT);
+                poFeature = oReprojectionQueue.Pop(bGeomReprojected);
+            }
+            else
+            {
+                nReprojectionBatchSize = 0;
+            }
+        }
+
         psInfo->nFeaturesRead ++;
 
         int nParts = 0;
@@ -4309,7 +4457,20 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
             }
 
             CPLErrorReset();
-            poDstFeature = OGRFeature::CreateFeature( poDstLayer->GetLayerDefn() );
+            if( psInfo->poReusableDstFeature != NULL &&
+                psInfo->poReusableDstFeature->GetDefnRef() ==
+                                            poDstLayer->GetLayerDefn() )
+            {
+                poDstFeature = psInfo->poReusableDstFeature;
+                psInfo->poReusableDstFeature = NULL;
+            }
+            else
+            {
+                OGRFeature::DestroyFeature( psInfo->poReusableDstFeature );
+                psInfo->poReusableDstFeature = NULL;
+                poDstFeature =
+                    OGRFeature::CreateFeature( poDstLayer->GetLayerDefn() );
+            }
 
             /* Optimization to avoid duplicating the source geometry in the */
             /* target feature : we steal it from the source feature for now... */
@@ -4450,7 +4611,11 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
                     poCT = m_poGCPCoordTrans;
                 char** papszTransformOptions = psInfo->papapszTransformOptions[iGeom];
 
-                if( poCT != NULL || papszTransformOptions != NULL)
+                if( bGeomReprojected )
+                {
+                    // Already reprojected by oReprojectionQueue.
+                }
+                else if( poCT != NULL || papszTransformOptions != NULL)
                 {
                     OGRGeometry* poReprojectedGeom =
                         OGRGeometryFactory::transformWithOptions(poDstGeometry, poCT, papszTransformOptions);
@@ -4574,7 +4739,15 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
             }
 
 end_loop:
-            OGRFeature::DestroyFeature( poDstFeature );
+            if( m_bReuseDstFeature )
+            {
+                poDstFeature->Reset();
+                psInfo->poReusableDstFeature = poDstFeature;
+            }
+            else
+            {
+                OGRFeature::DestroyFeature( poDstFeature );
+            }
         }
 
         OGRFeature::DestroyFeature( poFeature );
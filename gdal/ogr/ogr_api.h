@@ -294,6 +294,8 @@ typedef void *OGRStyleTableH;
 #endif
 /** Opaque type for a geometry field definition (OGRGeomFieldDefn) */
 typedef struct OGRGeomFieldDefnHS *OGRGeomFieldDefnH;
+/** Opaque type for a batch of features (OGRFeatureBatch) */
+typedef struct OGRFeatureBatchHS *OGRFeatureBatchH;
 
 /* OGRFieldDefn */
 
@@ -484,6 +486,22 @@ void   CPL_DLL OGR_F_FillUnsetWithDefault( OGRFeatureH hFeat,
                                            char** papszOptions );
 int    CPL_DLL OGR_F_Validate( OGRFeatureH, int nValidateFlags, int bEmitError );
 
+/* OGRFeatureBatch */
+
+OGRFeatureBatchH CPL_DLL OGR_FB_Create( OGRFeatureDefnH ) CPL_WARN_UNUSED_RESULT;
+void   CPL_DLL OGR_FB_Destroy( OGRFeatureBatchH );
+void   CPL_DLL OGR_FB_Reset( OGRFeatureBatchH );
+int    CPL_DLL OGR_FB_GetFeatureCount( OGRFeatureBatchH );
+const GIntBig CPL_DLL *OGR_FB_GetFIDs( OGRFeatureBatchH );
+const GByte CPL_DLL *OGR_FB_GetFieldValidity( OGRFeatureBatchH, int );
+const void CPL_DLL *OGR_FB_GetFieldData( OGRFeatureBatchH, int );
+const size_t CPL_DLL *OGR_FB_GetFieldOffsets( OGRFeatureBatchH, int );
+const GByte CPL_DLL *OGR_FB_GetFieldBytes( OGRFeatureBatchH, int );
+const GByte CPL_DLL *OGR_FB_GetGeomFieldValidity( OGRFeatureBatchH, int );
+const size_t CPL_DLL *OGR_FB_GetGeomFieldOffsets( OGRFeatureBatchH, int );
+const GByte CPL_DLL *OGR_FB_GetGeomFieldWKB( OGRFeatureBatchH, int );
+OGRFeatureH CPL_DLL OGR_FB_GetFeature( OGRFeatureBatchH, int ) CPL_WARN_UNUSED_RESULT;
+
 /* -------------------------------------------------------------------- */
 /*      ogrsf_frmts.h                                                   */
 /* -------------------------------------------------------------------- */
@@ -517,6 +535,8 @@ void     CPL_DLL OGR_L_SetSpatialFilterRectEx( OGRLayerH, int iGeomField,
 OGRErr CPL_DLL OGR_L_SetAttributeFilter( OGRLayerH, const char * );
 void   CPL_DLL OGR_L_ResetReading( OGRLayerH );
 OGRFeatureH CPL_DLL OGR_L_GetNextFeature( OGRLayerH ) CPL_WARN_UNUSED_RESULT;
+int    CPL_DLL OGR_L_GetNextFeatureBatch( OGRLayerH, OGRFeatureBatchH,
+                                          int nMaxFeatures );
 OGRErr CPL_DLL OGR_L_SetNextByIndex( OGRLayerH, GIntBig );
 OGRFeatureH CPL_DLL OGR_L_GetFeature( OGRLayerH, GIntBig )  CPL_WARN_UNUSED_RESULT;
 OGRErr CPL_DLL OGR_L_SetFeature( OGRLayerH, OGRFeatureH ) CPL_WARN_UNUSED_RESULT;
@@ -302,6 +302,8 @@ class CPL_DLL OGRFeature
 
     OGRFeatureDefn     *GetDefnRef() { return poDefn; }
 
+    void                Reset();
+
     OGRErr              SetGeometryDirectly( OGRGeometry * );
     OGRErr              SetGeometry( const OGRGeometry * );
     OGRGeometry        *GetGeometryRef();
@@ -477,6 +479,108 @@ class CPL_DLL OGRFeature
     CPL_DISALLOW_COPY_ASSIGN(OGRFeature)
 };
 
+/************************************************************************/
+/*                           OGRFeatureBatch                            */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+struct OGRFeatureBatchColumn;
+//! @endcond
+
+/**
+ * A batch of features stored column by column.
+ *
+ * Each attribute field is stored as a validity bitmap (bit i, least
+ * significant bit first, is set when the field of the i-th feature is set
+ * and not null) and either a contiguous array of fixed size values
+ * (int for OFTInteger, GIntBig for OFTInteger64, double for OFTReal, and
+ * OGRField for OFTDate, OFTTime and OFTDateTime) or, for variable size
+ * types, an array of nFeatureCount+1 offsets into a byte buffer.
+ * String and binary values are stored without terminating nul character,
+ * list values are stored as packed arrays of their elements, and string
+ * list elements are stored one after the other with their terminating nul
+ * character. Geometry fields are stored as ISO WKB in little endian order,
+ * with a validity bitmap and offsets.
+ *
+ * The buffers are kept between calls to Reset(), so that reading a layer
+ * with OGRLayer::GetNextFeatureBatch() does not cause any allocation once
+ * the buffers have reached their final size.
+ *
+ * @since GDAL 2.3
+ */
+
+class CPL_DLL OGRFeatureBatch
+{
+  private:
+    OGRFeatureDefn         *poDefn;
+    int                     nFieldCount;
+    int                     nGeomFieldCount;
+    int                     nFeatureCount;
+    GIntBig                *panFIDs;
+    int                     nFIDsAlloc;
+    OGRFeatureBatchColumn  *pasFields;
+    OGRFeatureBatchColumn  *pasGeomFields;
+    OGRFeature             *poScratchFeature;
+
+    OGRFeatureBatchColumn  *GetColumn( int iField ) const;
+    OGRFeatureBatchColumn  *GetGeomColumn( int iGeomField ) const;
+    void                    SetFieldFromScratch( int iField );
+
+  public:
+    explicit                OGRFeatureBatch( OGRFeatureDefn * );
+                            ~OGRFeatureBatch();
+
+    /** Return the feature definition of the batch.
+     * @return feature definition.
+     */
+    OGRFeatureDefn         *GetDefnRef() { return poDefn; }
+    int                     IsCompatibleWith( OGRFeatureDefn *poOtherDefn )
+                                                                    const;
+
+    void                    Reset();
+    int                     Compact( const GByte *pabyKeep );
+    /** Return the number of features in the batch.
+     * @return feature count.
+     */
+    int                     GetFeatureCount() const { return nFeatureCount; }
+
+    const GIntBig          *GetFIDs() const;
+    const GByte            *GetFieldValidity( int iField ) const;
+    int                     IsFieldSetAndNotNull( int iFeature,
+                                                  int iField ) const;
+    const void             *GetFieldData( int iField ) const;
+    const size_t           *GetFieldOffsets( int iField ) const;
+    const GByte            *GetFieldBytes( int iField ) const;
+    const GByte            *GetGeomFieldValidity( int iGeomField ) const;
+    const size_t           *GetGeomFieldOffsets( int iGeomField ) const;
+    const GByte            *GetGeomFieldWKB( int iGeomField ) const;
+
+    OGRFeature             *GetFeature( int iFeature ) const
+                                                    CPL_WARN_UNUSED_RESULT;
+
+    int                     AddFeature();
+    OGRErr                  AddFeature( OGRFeature *poFeature );
+
+    void                    SetFID( GIntBig nFID );
+    void                    SetField( int iField, int nValue );
+    void                    SetField( int iField, GIntBig nValue );
+    void                    SetField( int iField, double dfValue );
+    void                    SetField( int iField, const char *pszValue );
+    void                    SetField( int iField, int nBytes,
+                                      const GByte *pabyData );
+    void                    SetField( int iField, const OGRField *psField );
+    void                    SetFieldString( int iField, const char *pszValue,
+                                            size_t nLen );
+    void                    SetGeomFieldWKB( int iGeomField,
+                                             const GByte *pabyWKB,
+                                             size_t nWKBSize );
+    OGRErr                  SetGeomField( int iGeomField,
+                                          const OGRGeometry *poGeom );
+
+  private:
+    CPL_DISALLOW_COPY_ASSIGN(OGRFeatureBatch)
+};
+
 /************************************************************************/
 /*                           OGRFeatureQuery                            */
 /************************************************************************/
@@ -485,12 +589,14 @@ class CPL_DLL OGRFeature
 class OGRLayer;
 class swq_expr_node;
 class swq_custom_func_registrar;
+class OGRFeatureQueryProgram;
 
 class CPL_DLL OGRFeatureQuery
 {
   private:
     OGRFeatureDefn *poTargetDefn;
     void           *pSWQExpr;
+    OGRFeatureQueryProgram *poProgram;
 
     char      **FieldCollector( void *, char ** );
 
@@ -508,6 +614,8 @@ class CPL_DLL OGRFeatureQuery
                          swq_custom_func_registrar*
                          poCustomFuncRegistrar = NULL );
     int         Evaluate( OGRFeature * );
+    int         EvaluateBatch( OGRFeatureBatch *, GByte *,
+                               int iFirstFeature = 0 );
 
     GIntBig    *EvaluateAgainstIndices( OGRLayer *, OGRErr * );
 
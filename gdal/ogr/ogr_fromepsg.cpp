@@ -31,19 +31,24 @@
 #include "cpl_port.h"
 #include "ogr_srs_api.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <list>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <limits>
 
 #include "cpl_conv.h"
 #include "cpl_csv.h"
 #include "cpl_error.h"
+#include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "ogr_core.h"
 #include "ogr_p.h"
@@ -2088,6 +2093,107 @@ static OGRErr SetEPSGGeocCS( OGRSpatialReference * poSRS, int nGCSCode )
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                          EPSG import cache                           */
+/*                                                                      */
+/*      importFromEPSGA() does many lookups in the EPSG .csv tables,    */
+/*      which is slow compared to copying the resulting SRS. So the     */
+/*      results of successful imports are kept in a process-wide LRU    */
+/*      cache of at most OSR_EPSG_CACHE_SIZE (default 256) entries,     */
+/*      keyed by the EPSG code and the location of the tables.          */
+/************************************************************************/
+
+typedef std::list< std::pair<CPLString, OGRSpatialReference*> >
+                                                        OSREPSGCacheList;
+
+static CPLMutex *hEPSGCacheMutex = NULL;
+static OSREPSGCacheList *poEPSGCacheList = NULL;
+static std::map<CPLString, OSREPSGCacheList::iterator> *poEPSGCacheMap = NULL;
+
+static size_t OSRGetEPSGCacheSize()
+{
+    return static_cast<size_t>(
+        std::max(0, atoi(CPLGetConfigOption("OSR_EPSG_CACHE_SIZE", "256"))));
+}
+
+/************************************************************************/
+/*                       OSRGetFromEPSGCache()                          */
+/************************************************************************/
+
+static bool OSRGetFromEPSGCache( const CPLString& osKey,
+                                 OGRSpatialReference* poSRS )
+{
+    CPLMutexHolderD( &hEPSGCacheMutex );
+    if( poEPSGCacheMap == NULL )
+        return false;
+    std::map<CPLString, OSREPSGCacheList::iterator>::iterator oIter =
+        poEPSGCacheMap->find(osKey);
+    if( oIter == poEPSGCacheMap->end() )
+        return false;
+
+    // Move to front of the LRU list.
+    poEPSGCacheList->splice(poEPSGCacheList->begin(), *poEPSGCacheList,
+                            oIter->second);
+    *poSRS = *(oIter->second->second);
+    return true;
+}
+
+/************************************************************************/
+/*                        OSRPutInEPSGCache()                           */
+/************************************************************************/
+
+static void OSRPutInEPSGCache( const CPLString& osKey,
+                               const OGRSpatialReference* poSRS )
+{
+    const size_t nMaxSize = OSRGetEPSGCacheSize();
+    if( nMaxSize == 0 )
+        return;
+
+    CPLMutexHolderD( &hEPSGCacheMutex );
+    if( poEPSGCacheMap == NULL )
+    {
+        poEPSGCacheList = new OSREPSGCacheList();
+        poEPSGCacheMap =
+            new std::map<CPLString, OSREPSGCacheList::iterator>();
+    }
+    if( poEPSGCacheMap->find(osKey) != poEPSGCacheMap->end() )
+        return;
+
+    poEPSGCacheList->push_front(
+        std::pair<CPLString, OGRSpatialReference*>(osKey, poSRS->Clone()));
+    (*poEPSGCacheMap)[osKey] = poEPSGCacheList->begin();
+    while( poEPSGCacheList->size() > nMaxSize )
+    {
+        poEPSGCacheMap->erase(poEPSGCacheList->back().first);
+        delete poEPSGCacheList->back().second;
+        poEPSGCacheList->pop_back();
+    }
+}
+
+/************************************************************************/
+/*                        OSRCleanupEPSGCache()                         */
+/************************************************************************/
+
+void OSRCleanupEPSGCache()
+{
+    if( hEPSGCacheMutex == NULL )
+        return;
+    if( poEPSGCacheList != NULL )
+    {
+        for( OSREPSGCacheList::iterator oIter = poEPSGCacheList->begin();
+             oIter != poEPSGCacheList->end(); ++oIter )
+        {
+            delete oIter->second;
+        }
+        delete poEPSGCacheList;
+        delete poEPSGCacheMap;
+        poEPSGCacheList = NULL;
+        poEPSGCacheMap = NULL;
+    }
+    CPLDestroyMutex(hEPSGCacheMutex);
+    hEPSGCacheMutex = NULL;
+}
+
 /************************************************************************/
 /*                           importFromEPSG()                           */
 /************************************************************************/
@@ -2206,6 +2312,14 @@ OGRErr OGRSpatialReference::importFromEPSGA( int nCode )
         poRoot = NULL;
     }
 
+/* -------------------------------------------------------------------- */
+/*      Check if we have already imported this code.                    */
+/* -------------------------------------------------------------------- */
+    CPLString osCacheKey;
+    osCacheKey.Printf("%d|%s", nCodeIn, CSVFilename( "gcs.csv" ));
+    if( OSRGetFromEPSGCache(osCacheKey, this) )
+        return OGRERR_NONE;
+
 /* -------------------------------------------------------------------- */
 /*      Verify that we can find the required filename(s).               */
 /* -------------------------------------------------------------------- */
@@ -2302,6 +2416,9 @@ OGRErr OGRSpatialReference::importFromEPSGA( int nCode )
         eErr = FixupOrdering();
     }
 
+    if( eErr == OGRERR_NONE )
+        OSRPutInEPSGCache(osCacheKey, this);
+
     return eErr;
 }
 
@@ -495,6 +495,7 @@ class CPL_DLL OGRSimpleCurve: public OGRCurve
     friend class OGRGeometry;
 
     int         nPointCount;
+    int         m_nPointCapacity;
     OGRRawPoint *paoPoints;
     double      *padfZ;
     double      *padfM;
@@ -1764,6 +1765,11 @@ class CPL_DLL OGRGeometryFactory
                                               OGRCoordinateTransformation *poCT,
                                               char** papszOptions );
 
+    static int transformGeometries( OGRGeometry** papoGeoms, int nGeomCount,
+                                    OGRCoordinateTransformation *poCT,
+                                    int* pabSuccess = NULL,
+                                    const char* const* papszOptions = NULL );
+
     static OGRGeometry*
         approximateArcAngles( double dfX, double dfY, double dfZ,
                               double dfPrimaryRadius, double dfSecondaryAxis,
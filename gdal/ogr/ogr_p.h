@@ -136,6 +136,8 @@ extern const swq_field_type SpecialFieldTypes[SPECIAL_FIELD_COUNT];
 /************************************************************************/
 
 OGRErr CPL_DLL OSRGetEllipsoidInfo( int, char **, double *, double *);
+void OSRCleanupEPSGCache();
+void OSRCleanupDictIndexes();
 
 /* Fast atof function */
 double OGRFastAtof(const char* pszStr);
@@ -171,10 +173,109 @@ OGRErr OGRReadWKBGeometryType( unsigned char * pabyData,
                                OGRwkbVariant wkbVariant,
                                OGRwkbGeometryType *eGeometryType );
 
+/************************************************************************/
+/*                      OGRIndexedPreparedGeometry                      */
+/************************************************************************/
+
+/* Geometry prepared for repeated Intersects() tests without GEOS, with */
+/* its segments indexed in a packed R-tree.  Used for spatial filters.  */
+class CPL_DLL OGRIndexedPreparedGeometry
+{
+    struct Private;
+    Private     *m_poPrivate;
+
+                 OGRIndexedPreparedGeometry();
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRIndexedPreparedGeometry)
+
+  public:
+                ~OGRIndexedPreparedGeometry();
+
+    static OGRIndexedPreparedGeometry *Create( const OGRGeometry* poGeom,
+                                               bool bGeomIsEnvelope = false );
+
+    // Returns TRUE, FALSE, or -1 for unhandled geometry types.
+    int          Intersects( const OGRGeometry* poOtherGeom ) const;
+};
+
+/************************************************************************/
+/*                          OGRWKBGeometryView                          */
+/************************************************************************/
+
+/* Read-only view over a WKB geometry: type, envelope and iteration over */
+/* its points, without building an OGRGeometry nor allocating memory.    */
+class CPL_DLL OGRWKBGeometryView
+{
+    // Same nesting limit as OGRGeometryFactory::createFromWkb().
+    static const int MAX_DEPTH = 32;
+
+    struct Level
+    {
+        GUInt32     nRemaining;
+        bool        bRings;
+        bool        bHasZ;
+        bool        bHasM;
+        bool        bSwap;
+        int         nDim;
+    };
+
+    const GByte        *m_pabyData;
+    size_t              m_nSize;
+    size_t              m_nWkbSize;
+    OGRwkbGeometryType  m_eGeomType;
+    GUIntBig            m_nPointCount;
+
+    // Reading state.
+    size_t              m_nOffset;
+    int                 m_nDepth;
+    Level               m_asLevels[MAX_DEPTH];
+    bool                m_bError;
+    const GByte        *m_pabyCoords;
+    GUInt32             m_nPointsLeft;
+    int                 m_nDim;
+    bool                m_bHasZ;
+    bool                m_bHasM;
+    bool                m_bSwap;
+    bool                m_bIsPoint;
+    bool                m_bIsCircular;
+
+    bool                ReadUInt32( bool bSwap, GUInt32& nVal );
+    bool                SetPointArray( GUInt32 nCount, int nDim, bool bHasZ,
+                                       bool bHasM, bool bSwap,
+                                       bool bIsPoint );
+    bool                NextPointArray();
+    bool                IsEmptyPoint() const;
+    void                ComputeEnvelope( OGREnvelope3D* psEnvelope,
+                                         bool b3D ) const;
+
+  public:
+                        OGRWKBGeometryView();
+
+    OGRErr              Init( const GByte* pabyData, size_t nSize );
+
+    OGRwkbGeometryType  getGeometryType() const { return m_eGeomType; }
+    size_t              WkbSize() const { return m_nWkbSize; }
+    GUIntBig            getNumPoints() const { return m_nPointCount; }
+    OGRBoolean          IsEmpty() const;
+    void                getEnvelope( OGREnvelope* psEnvelope ) const;
+    void                getEnvelope( OGREnvelope3D* psEnvelope ) const;
+
+    void                ResetReading();
+    bool                GetNextPoint( double* pdfX, double* pdfY,
+                                      double* pdfZ = NULL,
+                                      double* pdfM = NULL );
+};
+
 /************************************************************************/
 /*                            Other                                     */
 /************************************************************************/
 
+/* Used by OGRCircularString and OGRWKBGeometryView */
+void OGRExtendEnvelopeWithCircularArc( double x0, double y0,
+                                       double x1, double y1,
+                                       double x2, double y2,
+                                       OGREnvelope * psEnvelope );
+
 void CPL_DLL OGRUpdateFieldType( OGRFieldDefn* poFDefn,
                                  OGRFieldType eNewType,
                                  OGRFieldSubType eNewSubType );
@@ -609,6 +609,17 @@ public:
     /** Set if the transformer must emit CPLError */
     virtual void SetEmitErrors(bool /*bEmitErrors*/) {}
 
+    /** Clone the transformation.
+     *
+     * The returned object is independent from this one and can be used
+     * concurrently with it from another thread.
+     *
+     * @return a new transformation to destroy with DestroyCT(), or NULL if
+     * the implementation does not support cloning.
+     * @since GDAL 2.3
+     */
+    virtual OGRCoordinateTransformation *Clone() const { return NULL; }
+
     // From CT_MathTransform
 
     /**
@@ -31,15 +31,152 @@
 #include "ogr_spatialref.h"
 
 #include <cstring>
+#include <map>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_multiproc.h"
+#include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "ogr_core.h"
+#include "ogr_p.h"
 #include "ogr_srs_api.h"
 
 CPL_CVSID("$Id$");
 
+/************************************************************************/
+/*                        Dictionary indexes                            */
+/*                                                                      */
+/*      Each dictionary file is read once, with its included files,     */
+/*      into a process-wide index from the upper-cased code to the      */
+/*      WKT definition, so that lookups do not scan the file again.     */
+/************************************************************************/
+
+typedef std::map<CPLString, CPLString> OSRDictIndex;
+
+static CPLMutex *hDictIndexMutex = NULL;
+static std::map<CPLString, OSRDictIndex*> *poDictIndexes = NULL;
+
+static const int MAX_DICT_INCLUDE_DEPTH = 32;
+
+/************************************************************************/
+/*                          OSRIndexDictFile()                          */
+/*                                                                      */
+/*      Add the definitions of a dictionary file to an index.  The      */
+/*      first definition of a code wins, as with a sequential scan.     */
+/************************************************************************/
+
+static void OSRIndexDictFile( const char *pszFilename, OSRDictIndex& oIndex,
+                              int nRecLevel )
+
+{
+    if( nRecLevel == MAX_DICT_INCLUDE_DEPTH )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Too many nested includes in dictionary file %s.",
+                  pszFilename );
+        return;
+    }
+
+    VSILFILE *fp = VSIFOpenL( pszFilename, "rb" );
+    if( fp == NULL )
+        return;
+
+    const char *pszLine = NULL;
+    while( (pszLine = CPLReadLineL(fp)) != NULL )
+    {
+        if( pszLine[0] == '#' )
+            continue;
+
+        if( STARTS_WITH_CI(pszLine, "include ") )
+        {
+            const char *pszIncludedFile = CPLFindFile( "gdal", pszLine + 8 );
+            if( pszIncludedFile != NULL )
+            {
+                // CPLReadLineL() buffer is reused by the nested reads.
+                const CPLString osIncludedFile(pszIncludedFile);
+                OSRIndexDictFile( osIncludedFile, oIndex, nRecLevel + 1 );
+            }
+            continue;
+        }
+
+        const char *pszComma = strchr(pszLine, ',');
+        if( pszComma == NULL )
+            continue;
+
+        CPLString osCode(pszLine, pszComma - pszLine);
+        osCode.toupper();
+        if( oIndex.find(osCode) == oIndex.end() )
+            oIndex[osCode] = pszComma + 1;
+    }
+
+    VSIFCloseL( fp );
+}
+
+/************************************************************************/
+/*                          OSRLookupInDict()                           */
+/*                                                                      */
+/*      Fetch the WKT definition of an upper-cased code, indexing the   */
+/*      dictionary file if this is the first lookup in it.              */
+/************************************************************************/
+
+static bool OSRLookupInDict( const char *pszDictFile, const CPLString& osCode,
+                             CPLString& osWKT )
+
+{
+    const char *pszFilename = CPLFindFile( "gdal", pszDictFile );
+    if( pszFilename == NULL )
+        return false;
+    const CPLString osFilename(pszFilename);
+
+    CPLMutexHolderD( &hDictIndexMutex );
+    if( poDictIndexes == NULL )
+        poDictIndexes = new std::map<CPLString, OSRDictIndex*>();
+
+    OSRDictIndex *poIndex = NULL;
+    std::map<CPLString, OSRDictIndex*>::iterator oIter =
+        poDictIndexes->find(osFilename);
+    if( oIter != poDictIndexes->end() )
+    {
+        poIndex = oIter->second;
+    }
+    else
+    {
+        poIndex = new OSRDictIndex();
+        OSRIndexDictFile( osFilename, *poIndex, 0 );
+        (*poDictIndexes)[osFilename] = poIndex;
+    }
+
+    OSRDictIndex::const_iterator oCodeIter = poIndex->find(osCode);
+    if( oCodeIter == poIndex->end() )
+        return false;
+    osWKT = oCodeIter->second;
+    return true;
+}
+
+/************************************************************************/
+/*                       OSRCleanupDictIndexes()                        */
+/************************************************************************/
+
+void OSRCleanupDictIndexes()
+{
+    if( hDictIndexMutex == NULL )
+        return;
+    if( poDictIndexes != NULL )
+    {
+        for( std::map<CPLString, OSRDictIndex*>::iterator oIter =
+                 poDictIndexes->begin();
+             oIter != poDictIndexes->end(); ++oIter )
+        {
+            delete oIter->second;
+        }
+        delete poDictIndexes;
+        poDictIndexes = NULL;
+    }
+    CPLDestroyMutex( hDictIndexMutex );
+    hDictIndexMutex = NULL;
+}
+
 /************************************************************************/
 /*                           importFromDict()                           */
 /************************************************************************/
@@ -55,6 +192,8 @@ CPL_CVSID("$Id$");
  * be found in the epsg.wkt file in the GDAL data tree.  The dictionary
  * files are searched for in the "GDAL" domain using CPLFindFile().  Normally
  * this results in searching /usr/local/share/gdal or somewhere similar.
+ * A dictionary file is read only once, on its first lookup, and its
+ * definitions are then kept in memory until OSRCleanup() is called.
  *
  * This method is the same as the C function OSRImportFromDict().
  *
@@ -71,55 +210,21 @@ OGRErr OGRSpatialReference::importFromDict( const char *pszDictFile,
 
 {
 /* -------------------------------------------------------------------- */
-/*      Find and open file.                                             */
+/*      Find the code in the index of the dictionary file.  Codes       */
+/*      cannot contain a comma as it separates them from the WKT.       */
 /* -------------------------------------------------------------------- */
-    const char *pszFilename = CPLFindFile( "gdal", pszDictFile );
-    if( pszFilename == NULL )
+    if( strchr(pszCode, ',') != NULL )
         return OGRERR_UNSUPPORTED_SRS;
 
-    VSILFILE *fp = VSIFOpenL( pszFilename, "rb" );
-    if( fp == NULL )
-        return OGRERR_UNSUPPORTED_SRS;
-
-/* -------------------------------------------------------------------- */
-/*      Process lines.                                                  */
-/* -------------------------------------------------------------------- */
-    OGRErr eErr = OGRERR_UNSUPPORTED_SRS;
-    const char *pszLine = NULL;
-
-    while( (pszLine = CPLReadLineL(fp)) != NULL )
-
-    {
-        if( pszLine[0] == '#' )
-            continue;
-
-        if( STARTS_WITH_CI(pszLine, "include ") )
-        {
-            eErr = importFromDict( pszLine + 8, pszCode );
-            if( eErr != OGRERR_UNSUPPORTED_SRS )
-                break;
-            continue;
-        }
+    CPLString osCode(pszCode);
+    osCode.toupper();
 
-        if( strstr(pszLine, ",") == NULL )
-            continue;
-
-        if( EQUALN(pszLine, pszCode, strlen(pszCode))
-            && pszLine[strlen(pszCode)] == ',' )
-        {
-            char *pszWKT = const_cast<char *>(pszLine) + strlen(pszCode)+1;
-
-            eErr = importFromWkt( &pszWKT );
-            break;
-        }
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Cleanup                                                         */
-/* -------------------------------------------------------------------- */
-    VSIFCloseL( fp );
+    CPLString osWKT;
+    if( !OSRLookupInDict( pszDictFile, osCode, osWKT ) )
+        return OGRERR_UNSUPPORTED_SRS;
 
-    return eErr;
+    char *pszWKT = &osWKT[0];
+    return importFromWkt( &pszWKT );
 }
 
 /************************************************************************/
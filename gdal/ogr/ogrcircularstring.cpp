@@ -253,6 +253,62 @@ double OGRCircularString::get_Length() const
     return dfLength;
 }
 
+/************************************************************************/
+/*                  OGRExtendEnvelopeWithCircularArc()                  */
+/*                                                                      */
+/*      Extend an envelope, which already contains the points of an     */
+/*      arc, with the extremities of its circle that the arc goes       */
+/*      through.                                                        */
+/************************************************************************/
+
+void OGRExtendEnvelopeWithCircularArc( double x0, double y0,
+                                       double x1, double y1,
+                                       double x2, double y2,
+                                       OGREnvelope * psEnvelope )
+{
+    double R = 0.0;
+    double cx = 0.0;
+    double cy = 0.0;
+    double alpha0 = 0.0;
+    double alpha1 = 0.0;
+    double alpha2 = 0.0;
+    if( !OGRGeometryFactory::GetCurveParmeters(x0, y0, x1, y1, x2, y2,
+                                               R, cx, cy,
+                                               alpha0, alpha1, alpha2) )
+    {
+        return;
+    }
+
+    int quadrantStart = static_cast<int>(std::floor(alpha0 / (M_PI / 2)));
+    int quadrantEnd = static_cast<int>(std::floor(alpha2 / (M_PI / 2)));
+    if( quadrantStart > quadrantEnd )
+    {
+        std::swap(quadrantStart, quadrantEnd);
+    }
+    // Transition through quadrants in counter-clock wise direction.
+    for( int j = quadrantStart + 1; j <= quadrantEnd; ++j )
+    {
+        switch( (j + 8) % 4 )
+        {
+            case 0:
+                psEnvelope->MaxX = std::max(psEnvelope->MaxX, cx + R);
+                break;
+            case 1:
+                psEnvelope->MaxY = std::max(psEnvelope->MaxY, cy + R);
+                break;
+            case 2:
+                psEnvelope->MinX = std::min(psEnvelope->MinX, cx - R);
+                break;
+            case 3:
+                psEnvelope->MinY = std::min(psEnvelope->MinY, cy - R);
+                break;
+            default:
+                CPLAssert(false);
+                break;
+        }
+    }
+}
+
 /************************************************************************/
 /*                       ExtendEnvelopeWithCircular()                   */
 /************************************************************************/
@@ -267,52 +323,10 @@ void OGRCircularString::ExtendEnvelopeWithCircular(
     // extremities of the circle.
     for( int i = 0; i < nPointCount - 2; i += 2 )
     {
-        double x0 = paoPoints[i].x;
-        const double y0 = paoPoints[i].y;
-        const double x1 = paoPoints[i+1].x;
-        const double y1 = paoPoints[i+1].y;
-        const double x2 = paoPoints[i+2].x;
-        const double y2 = paoPoints[i+2].y;
-        double R = 0.0;
-        double cx = 0.0;
-        double cy = 0.0;
-        double alpha0 = 0.0;
-        double alpha1 = 0.0;
-        double alpha2 = 0.0;
-        if( OGRGeometryFactory::GetCurveParmeters(x0, y0, x1, y1, x2, y2,
-                                                  R, cx, cy,
-                                                  alpha0, alpha1, alpha2))
-        {
-            int quadrantStart =
-                static_cast<int>(std::floor(alpha0 / (M_PI / 2)));
-            int quadrantEnd = static_cast<int>(std::floor(alpha2 / (M_PI / 2)));
-            if( quadrantStart > quadrantEnd )
-            {
-                std::swap(quadrantStart, quadrantEnd);
-            }
-            // Transition trough quadrants in counter-clock wise direction.
-            for( int j = quadrantStart + 1; j <= quadrantEnd; ++j )
-            {
-                switch( (j + 8) % 4 )
-                {
-                    case 0:
-                        psEnvelope->MaxX = std::max(psEnvelope->MaxX, cx + R);
-                        break;
-                    case 1:
-                        psEnvelope->MaxY = std::max(psEnvelope->MaxY, cy + R);
-                        break;
-                    case 2:
-                        psEnvelope->MinX = std::min(psEnvelope->MinX, cx - R);
-                        break;
-                    case 3:
-                        psEnvelope->MinY = std::min(psEnvelope->MaxY, cy - R);
-                        break;
-                    default:
-                        CPLAssert(false);
-                        break;
-                }
-            }
-        }
+        OGRExtendEnvelopeWithCircularArc(paoPoints[i].x, paoPoints[i].y,
+                                         paoPoints[i+1].x, paoPoints[i+1].y,
+                                         paoPoints[i+2].x, paoPoints[i+2].y,
+                                         psEnvelope);
     }
 }
 
@@ -503,6 +517,7 @@ void OGRCircularString::segmentize( double dfMaxLength )
     if( nPointCount < static_cast<int>(aoRawPoint.size()) )
     {
         nPointCount = static_cast<int>(aoRawPoint.size());
+        m_nPointCapacity = nPointCount;
         paoPoints = static_cast<OGRRawPoint *>(
                 CPLRealloc(paoPoints, sizeof(OGRRawPoint) * nPointCount));
         memcpy(paoPoints, &aoRawPoint[0], sizeof(OGRRawPoint) * nPointCount);
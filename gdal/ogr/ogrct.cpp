@@ -32,6 +32,9 @@
 
 #include <cmath>
 #include <cstring>
+#include <algorithm>
+#include <list>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -109,8 +112,11 @@ static bool      bProjLocaleSafe = false;
 /*                         OCTCleanupProjMutex()                        */
 /************************************************************************/
 
+static void OGRProj4CTCacheClear();
+
 void OCTCleanupProjMutex()
 {
+    OGRProj4CTCacheClear();
     if( hPROJMutex != NULL )
     {
         CPLDestroyMutex(hPROJMutex);
@@ -163,6 +169,11 @@ class OGRProj4CT : public OGRCoordinateTransformation
 
     bool        bNoTransform;
 
+    // Key of the PROJ.4 objects in the OGRProj4CT cache, or empty.
+    CPLString   osCacheKey;
+
+    bool        CanSkipTransform() const;
+
 public:
                 OGRProj4CT();
     virtual     ~OGRProj4CT();
@@ -182,6 +193,8 @@ public:
     virtual bool GetEmitErrors() override { return m_bEmitErrors; }
     virtual void SetEmitErrors( bool bEmitErrors ) override
         { m_bEmitErrors = bEmitErrors; }
+
+    virtual OGRCoordinateTransformation *Clone() const override;
 };
 
 /************************************************************************/
@@ -362,6 +375,192 @@ char *OCTProj4Normalize( const char *pszProj4Src )
     }
 }
 
+/************************************************************************/
+/*                       OGRProj4CT object cache                        */
+/*                                                                      */
+/*      Setting up a transformation (exporting both SRS to PROJ.4       */
+/*      strings, parsing them with pj_init_plus() and loading datum     */
+/*      grids) is expensive compared to transforming a few points,      */
+/*      and applications often repeatedly create and destroy            */
+/*      transformations between the same coordinate systems. So when a  */
+/*      OGRProj4CT is destroyed, its PROJ.4 context and objects are     */
+/*      kept in a process-wide pool, keyed by the WKT of its source     */
+/*      and target SRS, from which the next transformation between the  */
+/*      same SRS will take them.                                        */
+/*                                                                      */
+/*      An entry is owned exclusively either by the pool or by a live   */
+/*      transformation, so concurrent transformations between the same  */
+/*      SRS always get distinct PROJ.4 contexts. The pool keeps at most */
+/*      OGR_CT_CACHE_SIZE (default 64) idle entries, the least recently */
+/*      released ones being discarded first.                            */
+/************************************************************************/
+
+typedef struct
+{
+    CPLString osKey;
+    projCtx   pjctx;
+    projPJ    psPJSource;
+    projPJ    psPJTarget;
+    bool      bWebMercatorToWGS84;
+    bool      bIdentityTransform;
+} OGRProj4CTCacheEntry;
+
+static CPLMutex *hCTCacheMutex = NULL;
+static std::list<OGRProj4CTCacheEntry> *poCTCache = NULL;
+
+/************************************************************************/
+/*                        OGRProj4CTFreeEntry()                         */
+/************************************************************************/
+
+static void OGRProj4CTFreeEntry( const OGRProj4CTCacheEntry& sEntry )
+{
+    if( sEntry.pjctx != NULL )
+    {
+        pfn_pj_ctx_free(sEntry.pjctx);
+
+        if( sEntry.psPJSource != NULL )
+            pfn_pj_free( sEntry.psPJSource );
+
+        if( sEntry.psPJTarget != NULL )
+            pfn_pj_free( sEntry.psPJTarget );
+    }
+    else
+    {
+        CPLMutexHolderD( &hPROJMutex );
+
+        if( sEntry.psPJSource != NULL )
+            pfn_pj_free( sEntry.psPJSource );
+
+        if( sEntry.psPJTarget != NULL )
+            pfn_pj_free( sEntry.psPJTarget );
+    }
+}
+
+/************************************************************************/
+/*                      OGRProj4CTGetCacheSize()                        */
+/************************************************************************/
+
+static size_t OGRProj4CTGetCacheSize()
+{
+    return static_cast<size_t>(
+        std::max(0, atoi(CPLGetConfigOption("OGR_CT_CACHE_SIZE", "64"))));
+}
+
+/************************************************************************/
+/*                       OGRProj4CTGetCacheKey()                        */
+/*                                                                      */
+/*      Returns an empty string if the transformation must not be       */
+/*      cached.                                                         */
+/************************************************************************/
+
+static CPLString OGRProj4CTGetCacheKey( const OGRSpatialReference* poSource,
+                                        const OGRSpatialReference* poTarget )
+{
+    if( OGRProj4CTGetCacheSize() == 0 )
+        return CPLString();
+
+    char *pszSrcWKT = NULL;
+    char *pszDstWKT = NULL;
+    CPLString osKey;
+    if( poSource->exportToWkt(&pszSrcWKT) == OGRERR_NONE &&
+        poTarget->exportToWkt(&pszDstWKT) == OGRERR_NONE )
+    {
+        // Configuration options that affect exportToProj4().
+        osKey = pszSrcWKT;
+        osKey += '\n';
+        osKey += pszDstWKT;
+        osKey += '\n';
+        osKey += CPLGetConfigOption("OSR_USE_ETMERC", "");
+        osKey += '\n';
+        osKey += CPLGetConfigOption("OVERRIDE_PROJ_DATUM_WITH_TOWGS84", "");
+    }
+    CPLFree(pszSrcWKT);
+    CPLFree(pszDstWKT);
+    return osKey;
+}
+
+/************************************************************************/
+/*                         OGRProj4CTCacheTake()                        */
+/************************************************************************/
+
+static bool OGRProj4CTCacheTake( const CPLString& osKey,
+                                 OGRProj4CTCacheEntry& sEntry )
+{
+    if( osKey.empty() )
+        return false;
+
+    CPLMutexHolderD( &hCTCacheMutex );
+    if( poCTCache == NULL )
+        return false;
+    for( std::list<OGRProj4CTCacheEntry>::iterator oIter = poCTCache->begin();
+         oIter != poCTCache->end(); ++oIter )
+    {
+        if( oIter->osKey == osKey )
+        {
+            sEntry = *oIter;
+            poCTCache->erase(oIter);
+            return true;
+        }
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                         OGRProj4CTCachePut()                         */
+/*                                                                      */
+/*      Takes ownership of the PROJ.4 objects of sEntry.                */
+/************************************************************************/
+
+static void OGRProj4CTCachePut( const OGRProj4CTCacheEntry& sEntry )
+{
+    std::vector<OGRProj4CTCacheEntry> asEvicted;
+    {
+        CPLMutexHolderD( &hCTCacheMutex );
+        if( poCTCache == NULL )
+            poCTCache = new std::list<OGRProj4CTCacheEntry>();
+        poCTCache->push_front(sEntry);
+        const size_t nMaxSize = OGRProj4CTGetCacheSize();
+        while( poCTCache->size() > nMaxSize )
+        {
+            asEvicted.push_back(poCTCache->back());
+            poCTCache->pop_back();
+        }
+    }
+
+    // Freed outside of hCTCacheMutex, since this may take hPROJMutex,
+    // which is held by Initialize() when calling OGRProj4CTCacheTake().
+    for( size_t i = 0; i < asEvicted.size(); i++ )
+        OGRProj4CTFreeEntry(asEvicted[i]);
+}
+
+/************************************************************************/
+/*                        OGRProj4CTCacheClear()                        */
+/************************************************************************/
+
+static void OGRProj4CTCacheClear()
+{
+    std::list<OGRProj4CTCacheEntry> *poCache = NULL;
+    {
+        CPLMutexHolderD( &hCTCacheMutex );
+        poCache = poCTCache;
+        poCTCache = NULL;
+    }
+    if( poCache != NULL )
+    {
+        for( std::list<OGRProj4CTCacheEntry>::iterator oIter =
+                poCache->begin(); oIter != poCache->end(); ++oIter )
+        {
+            OGRProj4CTFreeEntry(*oIter);
+        }
+        delete poCache;
+    }
+    if( hCTCacheMutex != NULL )
+    {
+        CPLDestroyMutex(hCTCacheMutex);
+        hCTCacheMutex = NULL;
+    }
+}
+
 /************************************************************************/
 /*                 OCTDestroyCoordinateTransformation()                 */
 /************************************************************************/
@@ -543,26 +742,17 @@ OGRProj4CT::~OGRProj4CT()
             delete poSRSTarget;
     }
 
-    if( pjctx != NULL )
-    {
-        pfn_pj_ctx_free(pjctx);
-
-        if( psPJSource != NULL )
-            pfn_pj_free( psPJSource );
-
-        if( psPJTarget != NULL )
-            pfn_pj_free( psPJTarget );
-    }
+    OGRProj4CTCacheEntry sEntry;
+    sEntry.osKey = osCacheKey;
+    sEntry.pjctx = pjctx;
+    sEntry.psPJSource = psPJSource;
+    sEntry.psPJTarget = psPJTarget;
+    sEntry.bWebMercatorToWGS84 = bWebMercatorToWGS84;
+    sEntry.bIdentityTransform = bIdentityTransform;
+    if( !osCacheKey.empty() )
+        OGRProj4CTCachePut( sEntry );
     else
-    {
-        CPLMutexHolderD( &hPROJMutex );
-
-        if( psPJSource != NULL )
-            pfn_pj_free( psPJSource );
-
-        if( psPJTarget != NULL )
-            pfn_pj_free( psPJTarget );
-    }
+        OGRProj4CTFreeEntry( sEntry );
 
     CPLFree(padfOriX);
     CPLFree(padfOriY);
@@ -692,6 +882,26 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
     // means debug output could be one "increment" late.
     static int nDebugReportCount = 0;
 
+/* -------------------------------------------------------------------- */
+/*      Reuse the PROJ.4 objects of a previously destroyed              */
+/*      transformation between the same coordinate systems, if any.     */
+/* -------------------------------------------------------------------- */
+    const CPLString osKey = OGRProj4CTGetCacheKey(poSRSSource, poSRSTarget);
+    OGRProj4CTCacheEntry sEntry;
+    if( OGRProj4CTCacheTake(osKey, sEntry) )
+    {
+        if( pjctx != NULL )
+            pfn_pj_ctx_free(pjctx);
+        pjctx = sEntry.pjctx;
+        psPJSource = sEntry.psPJSource;
+        psPJTarget = sEntry.psPJTarget;
+        bWebMercatorToWGS84 = sEntry.bWebMercatorToWGS84;
+        bIdentityTransform = sEntry.bIdentityTransform;
+        bNoTransform = CanSkipTransform();
+        osCacheKey = osKey;
+        return TRUE;
+    }
+
     char *pszSrcProj4Defn = NULL;
 
     if( poSRSSource->exportToProj4( &pszSrcProj4Defn ) != OGRERR_NONE )
@@ -889,19 +1099,64 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
     // (but we may have a unit transformation to do)
     bIdentityTransform = strcmp(pszSrcProj4Defn, pszDstProj4Defn) == 0;
 
-    // Determine if we can skip the transformation completely.
-    // Assume that source and target units are defined with at least
-    // 10 correct significant digits; hence the 1E-9 tolerance used.
-    bNoTransform = bIdentityTransform && bSourceLatLong && !bSourceWrap &&
-                    bTargetLatLong && !bTargetWrap &&
-                    fabs(dfSourceToRadians * dfTargetFromRadians - 1.0) < 1E-9;
+    bNoTransform = CanSkipTransform();
 
     CPLFree( pszSrcProj4Defn );
     CPLFree( pszDstProj4Defn );
 
+    osCacheKey = osKey;
+
     return TRUE;
 }
 
+/************************************************************************/
+/*                         CanSkipTransform()                           */
+/************************************************************************/
+
+bool OGRProj4CT::CanSkipTransform() const
+{
+    // Determine if we can skip the transformation completely.
+    // Assume that source and target units are defined with at least
+    // 10 correct significant digits; hence the 1E-9 tolerance used.
+    return bIdentityTransform && bSourceLatLong && !bSourceWrap &&
+           bTargetLatLong && !bTargetWrap &&
+           fabs(dfSourceToRadians * dfTargetFromRadians - 1.0) < 1E-9;
+}
+
+/************************************************************************/
+/*                               Clone()                                */
+/*                                                                      */
+/*      The clone gets its own PROJ context (when available) and its    */
+/*      own scratch buffers, so that it can be used from another        */
+/*      thread without contending on hPROJMutex. Initialize() derives   */
+/*      the PROJ definitions again, so configuration options such as    */
+/*      OSR_USE_ETMERC are re-read; only the wrap, threshold and error  */
+/*      reporting settings are then copied from this object.            */
+/************************************************************************/
+
+OGRCoordinateTransformation *OGRProj4CT::Clone() const
+
+{
+    OGRProj4CT *poCT = new OGRProj4CT();
+
+    if( !poCT->Initialize( poSRSSource, poSRSTarget ) )
+    {
+        delete poCT;
+        return NULL;
+    }
+
+    poCT->bSourceWrap = bSourceWrap;
+    poCT->dfSourceWrapLong = dfSourceWrapLong;
+    poCT->bTargetWrap = bTargetWrap;
+    poCT->dfTargetWrapLong = dfTargetWrapLong;
+    poCT->bCheckWithInvertProj = bCheckWithInvertProj;
+    poCT->dfThreshold = dfThreshold;
+    poCT->bNoTransform = bNoTransform;
+    poCT->m_bEmitErrors = m_bEmitErrors;
+
+    return poCT;
+}
+
 /************************************************************************/
 /*                            GetSourceCS()                             */
 /************************************************************************/
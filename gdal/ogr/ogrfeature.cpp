@@ -283,6 +283,73 @@ void OGRFeature::DestroyFeature( OGRFeature *poFeature )
     delete poFeature;
 }
 
+/************************************************************************/
+/*                               Reset()                                */
+/************************************************************************/
+
+/**
+ * \brief Reset the state of a OGRFeature to its state after construction.
+ *
+ * All fields are unset, geometries are destroyed, and the FID, style
+ * string, style table and native data are cleared.  The feature definition
+ * is kept, as well as the internal arrays holding field values and
+ * geometries, which makes this cheaper than destroying the feature and
+ * creating a new one when many features of the same layer are processed.
+ *
+ * The feature definition must not have been modified since the feature
+ * was created.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGRFeature::Reset()
+{
+    nFID = OGRNullFID;
+
+    if( pauFields != NULL )
+    {
+        const int nFieldcount = poDefn->GetFieldCount();
+        for( int i = 0; i < nFieldcount; i++ )
+        {
+            UnsetField(i);
+        }
+    }
+
+    if( papoGeometries != NULL )
+    {
+        const int nGeomFieldCount = poDefn->GetGeomFieldCount();
+        for( int i = 0; i < nGeomFieldCount; i++ )
+        {
+            delete papoGeometries[i];
+            papoGeometries[i] = NULL;
+        }
+    }
+
+    if( m_pszStyleString )
+    {
+        CPLFree(m_pszStyleString);
+        m_pszStyleString = NULL;
+    }
+
+    if( m_poStyleTable )
+    {
+        delete m_poStyleTable;
+        m_poStyleTable = NULL;
+    }
+
+    if( m_pszNativeData )
+    {
+        CPLFree(m_pszNativeData);
+        m_pszNativeData = NULL;
+    }
+
+    if( m_pszNativeMediaType )
+    {
+        CPLFree(m_pszNativeMediaType);
+        m_pszNativeMediaType = NULL;
+    }
+}
+
 /************************************************************************/
 /*                             GetDefnRef()                             */
 /************************************************************************/
@@ -0,0 +1,1565 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  The OGRFeatureBatch class implementation.
+ * Author:   agent, <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "ogr_api.h"
+#include "ogr_feature.h"
+
+#include <cstring>
+
+#include <string>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "ogr_core.h"
+#include "ogr_geometry.h"
+
+CPL_CVSID("$Id$");
+
+/************************************************************************/
+/*                        OGRFeatureBatchColumn                         */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+struct OGRFeatureBatchColumn
+{
+    OGRFieldType        eType;
+    size_t              nValueSize;     // 0 for variable size values.
+    int                 nRows;
+    std::vector<GByte>  abyValidity;
+    std::vector<GByte>  abyData;
+    std::vector<size_t> anOffsets;
+    std::vector<GByte>  abyBytes;
+
+    OGRFeatureBatchColumn() : eType(OFTBinary), nValueSize(0), nRows(0),
+                              anOffsets(1, 0) {}
+};
+//! @endcond
+
+/************************************************************************/
+/*                          GetValueSize()                              */
+/************************************************************************/
+
+static size_t GetValueSize( OGRFieldType eType )
+{
+    switch( eType )
+    {
+        case OFTInteger:
+            return sizeof(int);
+        case OFTInteger64:
+            return sizeof(GIntBig);
+        case OFTReal:
+            return sizeof(double);
+        case OFTDate:
+        case OFTTime:
+        case OFTDateTime:
+            return sizeof(OGRField);
+        default:
+            return 0;
+    }
+}
+
+/************************************************************************/
+/*                            PadColumn()                               */
+/*                                                                      */
+/*      Add invalid values to a column until it has nTargetRows rows.   */
+/************************************************************************/
+
+static void PadColumn( OGRFeatureBatchColumn* psCol, int nTargetRows )
+{
+    if( psCol->nRows >= nTargetRows )
+        return;
+    psCol->abyValidity.resize( (nTargetRows + 7) / 8, 0 );
+    if( psCol->nValueSize )
+        psCol->abyData.resize( nTargetRows * psCol->nValueSize, 0 );
+    else
+        psCol->anOffsets.resize( nTargetRows + 1, psCol->abyBytes.size() );
+    psCol->nRows = nTargetRows;
+}
+
+/************************************************************************/
+/*                          InvalidateValue()                           */
+/*                                                                      */
+/*      Make the value of the last row of the batch invalid.            */
+/************************************************************************/
+
+static void InvalidateValue( OGRFeatureBatchColumn* psCol, int nFeatureCount )
+{
+    if( psCol->nRows < nFeatureCount )
+    {
+        PadColumn( psCol, nFeatureCount );
+        return;
+    }
+
+    const int iRow = nFeatureCount - 1;
+    psCol->abyValidity[iRow / 8] &= static_cast<GByte>(~(1 << (iRow % 8)));
+    if( psCol->nValueSize )
+    {
+        memset( &psCol->abyData[iRow * psCol->nValueSize], 0,
+                psCol->nValueSize );
+    }
+    else
+    {
+        psCol->abyBytes.resize( psCol->anOffsets[iRow] );
+        psCol->anOffsets[iRow + 1] = psCol->anOffsets[iRow];
+    }
+}
+
+/************************************************************************/
+/*                            BeginValue()                              */
+/*                                                                      */
+/*      Mark the value of the last row of the batch as valid, and       */
+/*      return a buffer of nSize bytes where to write it.               */
+/************************************************************************/
+
+static GByte* BeginValue( OGRFeatureBatchColumn* psCol, int nFeatureCount,
+                          size_t nSize )
+{
+    const int iRow = nFeatureCount - 1;
+    PadColumn( psCol, iRow );
+
+    if( psCol->nRows == nFeatureCount )
+    {
+        // Row already added: overwrite its value.
+        if( !psCol->nValueSize )
+        {
+            psCol->abyBytes.resize( psCol->anOffsets[iRow] + nSize );
+            psCol->anOffsets[iRow + 1] = psCol->abyBytes.size();
+        }
+    }
+    else
+    {
+        psCol->nRows = nFeatureCount;
+        psCol->abyValidity.resize( (nFeatureCount + 7) / 8, 0 );
+        if( psCol->nValueSize )
+        {
+            psCol->abyData.resize( nFeatureCount * psCol->nValueSize );
+        }
+        else
+        {
+            psCol->abyBytes.resize( psCol->abyBytes.size() + nSize );
+            psCol->anOffsets.push_back( psCol->abyBytes.size() );
+        }
+    }
+    psCol->abyValidity[iRow / 8] |= static_cast<GByte>(1 << (iRow % 8));
+
+    if( psCol->nValueSize )
+        return &psCol->abyData[iRow * psCol->nValueSize];
+    if( psCol->abyBytes.empty() )
+        return NULL;
+    return &psCol->abyBytes[0] + psCol->anOffsets[iRow];
+}
+
+/************************************************************************/
+/*                          OGRFeatureBatch()                           */
+/************************************************************************/
+
+/**
+ * \brief Constructor
+ *
+ * The batch takes a reference on the feature definition, and builds one
+ * column per attribute and geometry field of it. If the definition is
+ * later modified, a new batch must be created.
+ *
+ * This method is the same as the C function OGR_FB_Create().
+ *
+ * @param poDefnIn feature class (layer) definition to which the features of
+ * the batch will adhere.
+ */
+
+OGRFeatureBatch::OGRFeatureBatch( OGRFeatureDefn * poDefnIn ) :
+    poDefn(poDefnIn),
+    nFieldCount(poDefnIn->GetFieldCount()),
+    nGeomFieldCount(poDefnIn->GetGeomFieldCount()),
+    nFeatureCount(0),
+    panFIDs(NULL),
+    nFIDsAlloc(0),
+    pasFields(new OGRFeatureBatchColumn[nFieldCount]),
+    pasGeomFields(new OGRFeatureBatchColumn[nGeomFieldCount]),
+    poScratchFeature(NULL)
+{
+    poDefn->Reference();
+
+    for( int iField = 0; iField < nFieldCount; iField++ )
+    {
+        pasFields[iField].eType = poDefn->GetFieldDefn(iField)->GetType();
+        pasFields[iField].nValueSize = GetValueSize(pasFields[iField].eType);
+    }
+}
+
+/************************************************************************/
+/*                          ~OGRFeatureBatch()                          */
+/************************************************************************/
+
+OGRFeatureBatch::~OGRFeatureBatch()
+
+{
+    delete poScratchFeature;
+    delete[] pasFields;
+    delete[] pasGeomFields;
+    CPLFree(panFIDs);
+    poDefn->Release();
+}
+
+/************************************************************************/
+/*                          IsCompatibleWith()                          */
+/************************************************************************/
+
+/**
+ * \brief Test if the batch can hold features of a feature definition.
+ *
+ * This is the case if the feature definition is the one of the batch, and
+ * it has not been modified since the creation of the batch.
+ *
+ * @param poOtherDefn feature definition.
+ * @return TRUE if the batch can hold the features of poOtherDefn.
+ */
+
+int OGRFeatureBatch::IsCompatibleWith( OGRFeatureDefn *poOtherDefn ) const
+{
+    if( poOtherDefn != poDefn ||
+        poDefn->GetFieldCount() != nFieldCount ||
+        poDefn->GetGeomFieldCount() != nGeomFieldCount )
+        return FALSE;
+    for( int iField = 0; iField < nFieldCount; iField++ )
+    {
+        if( poDefn->GetFieldDefn(iField)->GetType() != pasFields[iField].eType )
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                               Reset()                                */
+/************************************************************************/
+
+/**
+ * \brief Remove all features from the batch.
+ *
+ * The memory used by the columns is kept, to be reused by the next features
+ * added to the batch.
+ *
+ * This method is the same as the C function OGR_FB_Reset().
+ */
+
+void OGRFeatureBatch::Reset()
+
+{
+    nFeatureCount = 0;
+    for( int i = 0; i < nFieldCount + nGeomFieldCount; i++ )
+    {
+        OGRFeatureBatchColumn* psCol = (i < nFieldCount) ?
+            &pasFields[i] : &pasGeomFields[i - nFieldCount];
+        psCol->nRows = 0;
+        psCol->abyValidity.clear();
+        psCol->abyData.clear();
+        psCol->anOffsets.resize(1);
+        psCol->abyBytes.clear();
+    }
+}
+
+/************************************************************************/
+/*                           CompactColumn()                            */
+/*                                                                      */
+/*      Move the values of the rows to keep to the start of a column.   */
+/************************************************************************/
+
+static void CompactColumn( OGRFeatureBatchColumn* psCol, int nFeatureCount,
+                           const GByte *pabyKeep )
+{
+    int iDst = 0;
+    size_t nDstBytes = 0;
+    for( int iSrc = 0; iSrc < nFeatureCount; iSrc++ )
+    {
+        if( !pabyKeep[iSrc] )
+            continue;
+
+        const GByte nMask = static_cast<GByte>(1 << (iDst % 8));
+        if( psCol->abyValidity[iSrc / 8] & (1 << (iSrc % 8)) )
+            psCol->abyValidity[iDst / 8] |= nMask;
+        else
+            psCol->abyValidity[iDst / 8] &= static_cast<GByte>(~nMask);
+
+        if( psCol->nValueSize )
+        {
+            if( iDst != iSrc )
+                memcpy( &psCol->abyData[iDst * psCol->nValueSize],
+                        &psCol->abyData[iSrc * psCol->nValueSize],
+                        psCol->nValueSize );
+        }
+        else
+        {
+            const size_t nStart = psCol->anOffsets[iSrc];
+            const size_t nLen = psCol->anOffsets[iSrc + 1] - nStart;
+            if( nLen && nDstBytes != nStart )
+                memmove( &psCol->abyBytes[nDstBytes],
+                         &psCol->abyBytes[nStart], nLen );
+            psCol->anOffsets[iDst] = nDstBytes;
+            nDstBytes += nLen;
+        }
+        iDst++;
+    }
+
+    psCol->nRows = iDst;
+    psCol->abyValidity.resize( (iDst + 7) / 8 );
+    // Bits after the last row must be cleared, as PadColumn() relies on it.
+    if( iDst % 8 )
+        psCol->abyValidity.back() &= static_cast<GByte>((1 << (iDst % 8)) - 1);
+    if( psCol->nValueSize )
+    {
+        psCol->abyData.resize( iDst * psCol->nValueSize );
+    }
+    else
+    {
+        psCol->anOffsets.resize( iDst + 1 );
+        psCol->anOffsets[iDst] = nDstBytes;
+        psCol->abyBytes.resize( nDstBytes );
+    }
+}
+
+/************************************************************************/
+/*                              Compact()                               */
+/************************************************************************/
+
+/**
+ * \brief Remove features from the batch.
+ *
+ * The features to keep are moved to the start of the batch, in the same
+ * order. This is typically used with the results of
+ * OGRFeatureQuery::EvaluateBatch().
+ *
+ * @param pabyKeep array of GetFeatureCount() values, TRUE for the features
+ * to keep, FALSE for the features to remove.
+ *
+ * @return the new number of features.
+ */
+
+int OGRFeatureBatch::Compact( const GByte *pabyKeep )
+
+{
+    int iDst = 0;
+    for( int iSrc = 0; iSrc < nFeatureCount; iSrc++ )
+    {
+        if( pabyKeep[iSrc] )
+            panFIDs[iDst++] = panFIDs[iSrc];
+    }
+    for( int i = 0; i < nFieldCount + nGeomFieldCount; i++ )
+    {
+        OGRFeatureBatchColumn* psCol = (i < nFieldCount) ?
+            &pasFields[i] : &pasGeomFields[i - nFieldCount];
+        CompactColumn( psCol, nFeatureCount, pabyKeep );
+    }
+    nFeatureCount = iDst;
+    return nFeatureCount;
+}
+
+/************************************************************************/
+/*                             GetColumn()                              */
+/************************************************************************/
+
+OGRFeatureBatchColumn* OGRFeatureBatch::GetColumn( int iField ) const
+{
+    if( iField < 0 || iField >= nFieldCount )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Invalid field index: %d", iField);
+        return NULL;
+    }
+    return &pasFields[iField];
+}
+
+/************************************************************************/
+/*                           GetGeomColumn()                            */
+/************************************************************************/
+
+OGRFeatureBatchColumn* OGRFeatureBatch::GetGeomColumn( int iGeomField ) const
+{
+    if( iGeomField < 0 || iGeomField >= nGeomFieldCount )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Invalid geometry field index: %d", iGeomField);
+        return NULL;
+    }
+    return &pasGeomFields[iGeomField];
+}
+
+/************************************************************************/
+/*                              GetFIDs()                               */
+/************************************************************************/
+
+/**
+ * \brief Return the array of the feature identifiers of the batch.
+ *
+ * This method is the same as the C function OGR_FB_GetFIDs().
+ *
+ * @return an array of GetFeatureCount() identifiers, owned by the batch.
+ */
+
+const GIntBig* OGRFeatureBatch::GetFIDs() const
+{
+    return panFIDs;
+}
+
+/************************************************************************/
+/*                          GetFieldValidity()                          */
+/************************************************************************/
+
+/**
+ * \brief Return the validity bitmap of a field.
+ *
+ * Bit (i % 8) of byte (i / 8) is set if the field of the i-th feature is
+ * set and not null.
+ *
+ * This method is the same as the C function OGR_FB_GetFieldValidity().
+ *
+ * @param iField the field index.
+ * @return a bitmap owned by the batch, or NULL if the batch is empty.
+ */
+
+const GByte* OGRFeatureBatch::GetFieldValidity( int iField ) const
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || nFeatureCount == 0 )
+        return NULL;
+    return &psCol->abyValidity[0];
+}
+
+/************************************************************************/
+/*                        IsFieldSetAndNotNull()                        */
+/************************************************************************/
+
+/**
+ * \brief Test if the field of a feature of the batch is set and not null.
+ *
+ * @param iFeature the feature index in the batch.
+ * @param iField the field index.
+ * @return TRUE if the field is set and not null.
+ */
+
+int OGRFeatureBatch::IsFieldSetAndNotNull( int iFeature, int iField ) const
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || iFeature < 0 || iFeature >= psCol->nRows )
+        return FALSE;
+    return (psCol->abyValidity[iFeature / 8] & (1 << (iFeature % 8))) != 0;
+}
+
+/************************************************************************/
+/*                            GetFieldData()                            */
+/************************************************************************/
+
+/**
+ * \brief Return the array of values of a fixed size field.
+ *
+ * The array contains int values for OFTInteger fields, GIntBig values for
+ * OFTInteger64 fields, double values for OFTReal fields and OGRField values
+ * for OFTDate, OFTTime and OFTDateTime fields. The values of invalid fields
+ * are set to zero.
+ *
+ * This method is the same as the C function OGR_FB_GetFieldData().
+ *
+ * @param iField the field index.
+ * @return an array of GetFeatureCount() values owned by the batch, or NULL
+ * if the field has a variable size type or the batch is empty.
+ */
+
+const void* OGRFeatureBatch::GetFieldData( int iField ) const
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || psCol->nValueSize == 0 || nFeatureCount == 0 )
+        return NULL;
+    return &psCol->abyData[0];
+}
+
+/************************************************************************/
+/*                          GetFieldOffsets()                           */
+/************************************************************************/
+
+/**
+ * \brief Return the offsets of the values of a variable size field.
+ *
+ * The value of the i-th feature is made of the bytes of GetFieldBytes()
+ * between offsets i (included) and i+1 (excluded).
+ *
+ * This method is the same as the C function OGR_FB_GetFieldOffsets().
+ *
+ * @param iField the field index.
+ * @return an array of GetFeatureCount()+1 offsets owned by the batch, or
+ * NULL if the field has a fixed size type.
+ */
+
+const size_t* OGRFeatureBatch::GetFieldOffsets( int iField ) const
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || psCol->nValueSize != 0 )
+        return NULL;
+    return &psCol->anOffsets[0];
+}
+
+/************************************************************************/
+/*                           GetFieldBytes()                            */
+/************************************************************************/
+
+/**
+ * \brief Return the buffer of the values of a variable size field.
+ *
+ * This method is the same as the C function OGR_FB_GetFieldBytes().
+ *
+ * @param iField the field index.
+ * @return a buffer owned by the batch, or NULL if the field has a fixed size
+ * type or if no value of the field takes any byte.
+ */
+
+const GByte* OGRFeatureBatch::GetFieldBytes( int iField ) const
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || psCol->nValueSize != 0 || psCol->abyBytes.empty() )
+        return NULL;
+    return &psCol->abyBytes[0];
+}
+
+/************************************************************************/
+/*                        GetGeomFieldValidity()                        */
+/************************************************************************/
+
+/**
+ * \brief Return the validity bitmap of a geometry field.
+ *
+ * This method is the same as the C function OGR_FB_GetGeomFieldValidity().
+ *
+ * @param iGeomField the geometry field index.
+ * @return a bitmap owned by the batch, or NULL if the batch is empty.
+ */
+
+const GByte* OGRFeatureBatch::GetGeomFieldValidity( int iGeomField ) const
+{
+    OGRFeatureBatchColumn* psCol = GetGeomColumn(iGeomField);
+    if( psCol == NULL || nFeatureCount == 0 )
+        return NULL;
+    return &psCol->abyValidity[0];
+}
+
+/************************************************************************/
+/*                        GetGeomFieldOffsets()                         */
+/************************************************************************/
+
+/**
+ * \brief Return the offsets of the WKB geometries of a geometry field.
+ *
+ * This method is the same as the C function OGR_FB_GetGeomFieldOffsets().
+ *
+ * @param iGeomField the geometry field index.
+ * @return an array of GetFeatureCount()+1 offsets owned by the batch.
+ */
+
+const size_t* OGRFeatureBatch::GetGeomFieldOffsets( int iGeomField ) const
+{
+    OGRFeatureBatchColumn* psCol = GetGeomColumn(iGeomField);
+    if( psCol == NULL )
+        return NULL;
+    return &psCol->anOffsets[0];
+}
+
+/************************************************************************/
+/*                          GetGeomFieldWKB()                           */
+/************************************************************************/
+
+/**
+ * \brief Return the buffer of the WKB geometries of a geometry field.
+ *
+ * This method is the same as the C function OGR_FB_GetGeomFieldWKB().
+ *
+ * @param iGeomField the geometry field index.
+ * @return a buffer owned by the batch, or NULL if there is no geometry.
+ */
+
+const GByte* OGRFeatureBatch::GetGeomFieldWKB( int iGeomField ) const
+{
+    OGRFeatureBatchColumn* psCol = GetGeomColumn(iGeomField);
+    if( psCol == NULL || psCol->abyBytes.empty() )
+        return NULL;
+    return &psCol->abyBytes[0];
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/************************************************************************/
+
+/**
+ * \brief Build a feature from a row of the batch.
+ *
+ * Invalid fields are left unset in the returned feature.
+ *
+ * This method is the same as the C function OGR_FB_GetFeature().
+ *
+ * @param iFeature the feature index in the batch.
+ * @return a new feature to destroy with OGRFeature::DestroyFeature(), or
+ * NULL if iFeature is out of range.
+ */
+
+OGRFeature* OGRFeatureBatch::GetFeature( int iFeature ) const
+{
+    if( iFeature < 0 || iFeature >= nFeatureCount )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Invalid feature index: %d", iFeature);
+        return NULL;
+    }
+    OGRFeature* poFeature = new OGRFeature(poDefn);
+    poFeature->SetFID(panFIDs[iFeature]);
+
+    for( int iField = 0; iField < nFieldCount; iField++ )
+    {
+        if( !IsFieldSetAndNotNull(iFeature, iField) )
+            continue;
+
+        OGRFeatureBatchColumn* psCol = &pasFields[iField];
+        if( psCol->nValueSize )
+        {
+            const GByte* pabyValue =
+                &psCol->abyData[iFeature * psCol->nValueSize];
+            switch( psCol->eType )
+            {
+                case OFTInteger:
+                {
+                    int nValue = 0;
+                    memcpy(&nValue, pabyValue, sizeof(nValue));
+                    poFeature->SetField(iField, nValue);
+                    break;
+                }
+                case OFTInteger64:
+                {
+                    GIntBig nValue = 0;
+                    memcpy(&nValue, pabyValue, sizeof(nValue));
+                    poFeature->SetField(iField, nValue);
+                    break;
+                }
+                case OFTReal:
+                {
+                    double dfValue = 0.0;
+                    memcpy(&dfValue, pabyValue, sizeof(dfValue));
+                    poFeature->SetField(iField, dfValue);
+                    break;
+                }
+                default:
+                {
+                    OGRField sField;
+                    memcpy(&sField, pabyValue, sizeof(sField));
+                    poFeature->SetField(iField, &sField);
+                    break;
+                }
+            }
+            continue;
+        }
+
+        const size_t nOffset = psCol->anOffsets[iFeature];
+        const size_t nSize = psCol->anOffsets[iFeature + 1] - nOffset;
+        GByte* pabyValue = psCol->abyBytes.empty() ? NULL :
+                                        &psCol->abyBytes[0] + nOffset;
+        switch( psCol->eType )
+        {
+            case OFTString:
+            {
+                const std::string osValue(
+                    nSize ? reinterpret_cast<const char*>(pabyValue) : "",
+                    nSize );
+                poFeature->SetField(iField, osValue.c_str());
+                break;
+            }
+            case OFTBinary:
+                poFeature->SetField(iField, static_cast<int>(nSize),
+                                    pabyValue);
+                break;
+            case OFTIntegerList:
+                poFeature->SetField(iField,
+                                    static_cast<int>(nSize / sizeof(int)),
+                                    reinterpret_cast<int*>(pabyValue));
+                break;
+            case OFTInteger64List:
+                poFeature->SetField(iField,
+                                    static_cast<int>(nSize / sizeof(GIntBig)),
+                                    reinterpret_cast<GIntBig*>(pabyValue));
+                break;
+            case OFTRealList:
+                poFeature->SetField(iField,
+                                    static_cast<int>(nSize / sizeof(double)),
+                                    reinterpret_cast<double*>(pabyValue));
+                break;
+            case OFTStringList:
+            {
+                std::vector<char*> apszValues;
+                size_t i = 0;
+                while( i < nSize )
+                {
+                    char* pszValue = reinterpret_cast<char*>(pabyValue + i);
+                    apszValues.push_back(pszValue);
+                    i += strlen(pszValue) + 1;
+                }
+                apszValues.push_back(NULL);
+                poFeature->SetField(iField, &apszValues[0]);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    for( int iField = 0; iField < nGeomFieldCount; iField++ )
+    {
+        OGRFeatureBatchColumn* psCol = &pasGeomFields[iField];
+        if( !(psCol->abyValidity[iFeature / 8] & (1 << (iFeature % 8))) )
+            continue;
+
+        const size_t nOffset = psCol->anOffsets[iFeature];
+        OGRGeometry* poGeom = NULL;
+        if( OGRGeometryFactory::createFromWkb(
+                &psCol->abyBytes[0] + nOffset,
+                poDefn->GetGeomFieldDefn(iField)->GetSpatialRef(),
+                &poGeom,
+                static_cast<int>(psCol->anOffsets[iFeature + 1] - nOffset))
+                                                            == OGRERR_NONE )
+        {
+            poFeature->SetGeomFieldDirectly(iField, poGeom);
+        }
+    }
+
+    return poFeature;
+}
+
+/************************************************************************/
+/*                             AddFeature()                             */
+/************************************************************************/
+
+/**
+ * \brief Append a new feature to the batch.
+ *
+ * The new feature has no FID and all its fields are invalid. Its fields can
+ * then be set with the SetFID(), SetField() and SetGeomField() methods, that
+ * all apply to the last feature of the batch.
+ *
+ * @return the index of the new feature in the batch.
+ */
+
+int OGRFeatureBatch::AddFeature()
+
+{
+    if( nFeatureCount == nFIDsAlloc )
+    {
+        nFIDsAlloc = nFIDsAlloc ? 2 * nFIDsAlloc : 64;
+        panFIDs = static_cast<GIntBig*>(
+            CPLRealloc(panFIDs, nFIDsAlloc * sizeof(GIntBig)));
+    }
+    panFIDs[nFeatureCount] = OGRNullFID;
+    nFeatureCount++;
+
+    // Start with invalid values in all columns, so that the batch is
+    // always complete when read: setting a field overwrites its value.
+    for( int iField = 0; iField < nFieldCount; iField++ )
+        PadColumn( &pasFields[iField], nFeatureCount );
+    for( int iField = 0; iField < nGeomFieldCount; iField++ )
+        PadColumn( &pasGeomFields[iField], nFeatureCount );
+
+    return nFeatureCount - 1;
+}
+
+/**
+ * \brief Append a copy of a feature to the batch.
+ *
+ * The feature must follow the feature definition of the batch.
+ * Fields set to null are stored as invalid, like unset fields.
+ *
+ * @param poFeature the feature to copy.
+ * @return OGRERR_NONE on success.
+ */
+
+OGRErr OGRFeatureBatch::AddFeature( OGRFeature *poFeature )
+
+{
+    if( poFeature->GetFieldCount() != nFieldCount ||
+        poFeature->GetGeomFieldCount() != nGeomFieldCount )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Feature does not follow the definition of the batch");
+        return OGRERR_FAILURE;
+    }
+
+    AddFeature();
+    SetFID(poFeature->GetFID());
+
+    for( int iField = 0; iField < nFieldCount; iField++ )
+    {
+        if( poFeature->IsFieldSetAndNotNull(iField) )
+            SetField(iField, poFeature->GetRawFieldRef(iField));
+    }
+
+    OGRErr eErr = OGRERR_NONE;
+    for( int iField = 0; iField < nGeomFieldCount; iField++ )
+    {
+        const OGRGeometry* poGeom = poFeature->GetGeomFieldRef(iField);
+        if( poGeom != NULL && SetGeomField(iField, poGeom) != OGRERR_NONE )
+            eErr = OGRERR_FAILURE;
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                               SetFID()                               */
+/************************************************************************/
+
+/**
+ * \brief Set the feature identifier of the last feature of the batch.
+ *
+ * @param nFID the feature identifier.
+ */
+
+void OGRFeatureBatch::SetFID( GIntBig nFID )
+
+{
+    if( nFeatureCount > 0 )
+        panFIDs[nFeatureCount - 1] = nFID;
+}
+
+/************************************************************************/
+/*                        SetFieldFromScratch()                         */
+/*                                                                      */
+/*      Copy the value of a field of the scratch feature, after it has  */
+/*      been converted to the type of the field by OGRFeature, so that  */
+/*      conversions behave exactly as with OGRFeature::SetField().      */
+/************************************************************************/
+
+void OGRFeatureBatch::SetFieldFromScratch( int iField )
+
+{
+    if( poScratchFeature->IsFieldSetAndNotNull(iField) )
+        SetField(iField, poScratchFeature->GetRawFieldRef(iField));
+    else
+        InvalidateValue(&pasFields[iField], nFeatureCount);
+    poScratchFeature->UnsetField(iField);
+}
+
+/************************************************************************/
+/*                              SetField()                              */
+/************************************************************************/
+
+/**
+ * \brief Set a field of the last feature of the batch to an integer value.
+ *
+ * OFTInteger64 and OFTReal fields are set directly, and other fields are
+ * converted as with OGRFeature::SetField().
+ *
+ * @param iField the field index.
+ * @param nValue the value.
+ */
+
+void OGRFeatureBatch::SetField( int iField, int nValue )
+
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || nFeatureCount == 0 )
+        return;
+
+    if( psCol->eType == OFTInteger &&
+        poDefn->GetFieldDefn(iField)->GetSubType() == OFSTNone )
+    {
+        memcpy(BeginValue(psCol, nFeatureCount, sizeof(int)),
+               &nValue, sizeof(int));
+    }
+    else if( psCol->eType == OFTInteger64 )
+    {
+        SetField(iField, static_cast<GIntBig>(nValue));
+    }
+    else if( psCol->eType == OFTReal )
+    {
+        SetField(iField, static_cast<double>(nValue));
+    }
+    else
+    {
+        if( poScratchFeature == NULL )
+            poScratchFeature = new OGRFeature(poDefn);
+        poScratchFeature->SetField(iField, nValue);
+        SetFieldFromScratch(iField);
+    }
+}
+
+/**
+ * \brief Set a field of the last feature of the batch to a 64 bit integer
+ * value.
+ *
+ * Fields of other types than OFTInteger64 are converted as with
+ * OGRFeature::SetField().
+ *
+ * @param iField the field index.
+ * @param nValue the value.
+ */
+
+void OGRFeatureBatch::SetField( int iField, GIntBig nValue )
+
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || nFeatureCount == 0 )
+        return;
+
+    if( psCol->eType == OFTInteger64 )
+    {
+        memcpy(BeginValue(psCol, nFeatureCount, sizeof(GIntBig)),
+               &nValue, sizeof(GIntBig));
+    }
+    else
+    {
+        if( poScratchFeature == NULL )
+            poScratchFeature = new OGRFeature(poDefn);
+        poScratchFeature->SetField(iField, nValue);
+        SetFieldFromScratch(iField);
+    }
+}
+
+/**
+ * \brief Set a field of the last feature of the batch to a real value.
+ *
+ * Fields of other types than OFTReal are converted as with
+ * OGRFeature::SetField().
+ *
+ * @param iField the field index.
+ * @param dfValue the value.
+ */
+
+void OGRFeatureBatch::SetField( int iField, double dfValue )
+
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || nFeatureCount == 0 )
+        return;
+
+    if( psCol->eType == OFTReal )
+    {
+        memcpy(BeginValue(psCol, nFeatureCount, sizeof(double)),
+               &dfValue, sizeof(double));
+    }
+    else
+    {
+        if( poScratchFeature == NULL )
+            poScratchFeature = new OGRFeature(poDefn);
+        poScratchFeature->SetField(iField, dfValue);
+        SetFieldFromScratch(iField);
+    }
+}
+
+/**
+ * \brief Set a field of the last feature of the batch to a string value.
+ *
+ * Fields of other types than OFTString are converted as with
+ * OGRFeature::SetField(), so for example a numeric string can be used to
+ * set a numeric field.
+ *
+ * @param iField the field index.
+ * @param pszValue the value.
+ */
+
+void OGRFeatureBatch::SetField( int iField, const char *pszValue )
+
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || nFeatureCount == 0 )
+        return;
+
+    if( pszValue == NULL )
+    {
+        InvalidateValue(psCol, nFeatureCount);
+    }
+    else if( psCol->eType == OFTString )
+    {
+        SetFieldString(iField, pszValue, strlen(pszValue));
+    }
+    else
+    {
+        if( poScratchFeature == NULL )
+            poScratchFeature = new OGRFeature(poDefn);
+        poScratchFeature->SetField(iField, pszValue);
+        SetFieldFromScratch(iField);
+    }
+}
+
+/**
+ * \brief Set a field of the last feature of the batch to a binary value.
+ *
+ * Fields of other types than OFTBinary are converted as with
+ * OGRFeature::SetField().
+ *
+ * @param iField the field index.
+ * @param nBytes the number of bytes of the value.
+ * @param pabyData the value.
+ */
+
+void OGRFeatureBatch::SetField( int iField, int nBytes,
+                                const GByte *pabyData )
+
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || nFeatureCount == 0 )
+        return;
+
+    if( psCol->eType == OFTBinary )
+    {
+        GByte* pabyDst = BeginValue(psCol, nFeatureCount, nBytes);
+        if( nBytes > 0 )
+            memcpy(pabyDst, pabyData, nBytes);
+    }
+    else
+    {
+        if( poScratchFeature == NULL )
+            poScratchFeature = new OGRFeature(poDefn);
+        poScratchFeature->SetField(iField, nBytes,
+                                   const_cast<GByte*>(pabyData));
+        SetFieldFromScratch(iField);
+    }
+}
+
+/**
+ * \brief Set a field of the last feature of the batch from a raw field.
+ *
+ * The raw field must be of the type of the field. If it is unset or null,
+ * the field is made invalid.
+ *
+ * @param iField the field index.
+ * @param psField the raw field.
+ */
+
+void OGRFeatureBatch::SetField( int iField, const OGRField *psField )
+
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || nFeatureCount == 0 )
+        return;
+
+    if( OGR_RawField_IsUnset(psField) || OGR_RawField_IsNull(psField) )
+    {
+        InvalidateValue(psCol, nFeatureCount);
+        return;
+    }
+
+    switch( psCol->eType )
+    {
+        case OFTInteger:
+            memcpy(BeginValue(psCol, nFeatureCount, sizeof(int)),
+                   &psField->Integer, sizeof(int));
+            break;
+
+        case OFTInteger64:
+            memcpy(BeginValue(psCol, nFeatureCount, sizeof(GIntBig)),
+                   &psField->Integer64, sizeof(GIntBig));
+            break;
+
+        case OFTReal:
+            memcpy(BeginValue(psCol, nFeatureCount, sizeof(double)),
+                   &psField->Real, sizeof(double));
+            break;
+
+        case OFTDate:
+        case OFTTime:
+        case OFTDateTime:
+            memcpy(BeginValue(psCol, nFeatureCount, sizeof(OGRField)),
+                   psField, sizeof(OGRField));
+            break;
+
+        case OFTString:
+            SetFieldString(iField, psField->String, strlen(psField->String));
+            break;
+
+        case OFTBinary:
+            SetField(iField, psField->Binary.nCount, psField->Binary.paData);
+            break;
+
+        case OFTIntegerList:
+        case OFTInteger64List:
+        case OFTRealList:
+        {
+            const size_t nSize =
+                static_cast<size_t>(psField->IntegerList.nCount) *
+                (psCol->eType == OFTIntegerList ? sizeof(int) :
+                 psCol->eType == OFTInteger64List ? sizeof(GIntBig) :
+                                                    sizeof(double));
+            GByte* pabyDst = BeginValue(psCol, nFeatureCount, nSize);
+            if( nSize )
+            {
+                const void* pSrc =
+                    psCol->eType == OFTIntegerList ?
+                        static_cast<const void*>(psField->IntegerList.paList) :
+                    psCol->eType == OFTInteger64List ?
+                        static_cast<const void*>(
+                            psField->Integer64List.paList) :
+                        static_cast<const void*>(psField->RealList.paList);
+                memcpy(pabyDst, pSrc, nSize);
+            }
+            break;
+        }
+
+        case OFTStringList:
+        {
+            size_t nSize = 0;
+            for( int i = 0; i < psField->StringList.nCount; i++ )
+                nSize += strlen(psField->StringList.paList[i]) + 1;
+            GByte* pabyDst = BeginValue(psCol, nFeatureCount, nSize);
+            for( int i = 0; i < psField->StringList.nCount; i++ )
+            {
+                const size_t nLen = strlen(psField->StringList.paList[i]) + 1;
+                memcpy(pabyDst, psField->StringList.paList[i], nLen);
+                pabyDst += nLen;
+            }
+            break;
+        }
+
+        default:
+            InvalidateValue(psCol, nFeatureCount);
+            break;
+    }
+}
+
+/************************************************************************/
+/*                           SetFieldString()                           */
+/************************************************************************/
+
+/**
+ * \brief Set a OFTString field of the last feature of the batch.
+ *
+ * Contrary to SetField(), the string does not need to be nul terminated,
+ * which avoids copies when it comes from a buffer of the driver.
+ *
+ * @param iField the field index.
+ * @param pszValue the string, that does not need to be nul terminated.
+ * @param nLen the number of bytes of the string.
+ */
+
+void OGRFeatureBatch::SetFieldString( int iField, const char *pszValue,
+                                      size_t nLen )
+
+{
+    OGRFeatureBatchColumn* psCol = GetColumn(iField);
+    if( psCol == NULL || nFeatureCount == 0 )
+        return;
+
+    if( psCol->eType != OFTString )
+    {
+        const std::string osValue(pszValue, nLen);
+        SetField(iField, osValue.c_str());
+        return;
+    }
+
+    GByte* pabyDst = BeginValue(psCol, nFeatureCount, nLen);
+    if( nLen )
+        memcpy(pabyDst, pszValue, nLen);
+}
+
+/************************************************************************/
+/*                          SetGeomFieldWKB()                           */
+/************************************************************************/
+
+/**
+ * \brief Set a geometry field of the last feature of the batch from WKB.
+ *
+ * The WKB must be ISO WKB in little endian order.
+ *
+ * @param iGeomField the geometry field index.
+ * @param pabyWKB the WKB geometry, or NULL to make the geometry invalid.
+ * @param nWKBSize the number of bytes of the WKB geometry.
+ */
+
+void OGRFeatureBatch::SetGeomFieldWKB( int iGeomField, const GByte *pabyWKB,
+                                       size_t nWKBSize )
+
+{
+    OGRFeatureBatchColumn* psCol = GetGeomColumn(iGeomField);
+    if( psCol == NULL || nFeatureCount == 0 )
+        return;
+
+    if( pabyWKB == NULL || nWKBSize == 0 )
+    {
+        InvalidateValue(psCol, nFeatureCount);
+        return;
+    }
+
+    memcpy(BeginValue(psCol, nFeatureCount, nWKBSize), pabyWKB, nWKBSize);
+}
+
+/************************************************************************/
+/*                            SetGeomField()                            */
+/************************************************************************/
+
+/**
+ * \brief Set a geometry field of the last feature of the batch.
+ *
+ * The geometry is directly exported as WKB into the buffer of the batch.
+ *
+ * @param iGeomField the geometry field index.
+ * @param poGeom the geometry, or NULL to make the geometry invalid.
+ * @return OGRERR_NONE on success.
+ */
+
+OGRErr OGRFeatureBatch::SetGeomField( int iGeomField,
+                                      const OGRGeometry *poGeom )
+
+{
+    OGRFeatureBatchColumn* psCol = GetGeomColumn(iGeomField);
+    if( psCol == NULL || nFeatureCount == 0 )
+        return OGRERR_FAILURE;
+
+    if( poGeom == NULL )
+    {
+        InvalidateValue(psCol, nFeatureCount);
+        return OGRERR_NONE;
+    }
+
+    const OGRErr eErr = poGeom->exportToWkb(
+        wkbNDR, BeginValue(psCol, nFeatureCount, poGeom->WkbSize()),
+        wkbVariantIso);
+    if( eErr != OGRERR_NONE )
+        InvalidateValue(psCol, nFeatureCount);
+    return eErr;
+}
+
+/************************************************************************/
+/*                           OGR_FB_Create()                            */
+/************************************************************************/
+
+/**
+ * \brief Create a batch of features.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::OGRFeatureBatch().
+ *
+ * @param hDefn handle to the feature class (layer) definition to which the
+ * features of the batch will adhere.
+ * @return a handle to the new batch, to destroy with OGR_FB_Destroy().
+ *
+ * @since GDAL 2.3
+ */
+
+OGRFeatureBatchH OGR_FB_Create( OGRFeatureDefnH hDefn )
+
+{
+    VALIDATE_POINTER1( hDefn, "OGR_FB_Create", NULL );
+
+    return reinterpret_cast<OGRFeatureBatchH>(
+        new OGRFeatureBatch(reinterpret_cast<OGRFeatureDefn *>(hDefn)));
+}
+
+/************************************************************************/
+/*                           OGR_FB_Destroy()                           */
+/************************************************************************/
+
+/**
+ * \brief Destroy a batch of features.
+ *
+ * @param hBatch handle to the batch to destroy.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGR_FB_Destroy( OGRFeatureBatchH hBatch )
+
+{
+    delete reinterpret_cast<OGRFeatureBatch *>(hBatch);
+}
+
+/************************************************************************/
+/*                            OGR_FB_Reset()                            */
+/************************************************************************/
+
+/**
+ * \brief Remove all features from the batch.
+ *
+ * This function is the same as the C++ method OGRFeatureBatch::Reset().
+ *
+ * @param hBatch handle to the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGR_FB_Reset( OGRFeatureBatchH hBatch )
+
+{
+    VALIDATE_POINTER0( hBatch, "OGR_FB_Reset" );
+
+    reinterpret_cast<OGRFeatureBatch *>(hBatch)->Reset();
+}
+
+/************************************************************************/
+/*                       OGR_FB_GetFeatureCount()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the number of features in the batch.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFeatureCount().
+ *
+ * @param hBatch handle to the batch.
+ * @return feature count.
+ *
+ * @since GDAL 2.3
+ */
+
+int OGR_FB_GetFeatureCount( OGRFeatureBatchH hBatch )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFeatureCount", 0 );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->GetFeatureCount();
+}
+
+/************************************************************************/
+/*                           OGR_FB_GetFIDs()                           */
+/************************************************************************/
+
+/**
+ * \brief Return the array of the feature identifiers of the batch.
+ *
+ * This function is the same as the C++ method OGRFeatureBatch::GetFIDs().
+ *
+ * @param hBatch handle to the batch.
+ * @return an array of feature identifiers owned by the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+const GIntBig* OGR_FB_GetFIDs( OGRFeatureBatchH hBatch )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFIDs", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->GetFIDs();
+}
+
+/************************************************************************/
+/*                      OGR_FB_GetFieldValidity()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the validity bitmap of a field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldValidity().
+ *
+ * @param hBatch handle to the batch.
+ * @param iField the field index.
+ * @return a bitmap owned by the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+const GByte* OGR_FB_GetFieldValidity( OGRFeatureBatchH hBatch, int iField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldValidity", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->
+                                                    GetFieldValidity(iField);
+}
+
+/************************************************************************/
+/*                        OGR_FB_GetFieldData()                         */
+/************************************************************************/
+
+/**
+ * \brief Return the array of values of a fixed size field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldData().
+ *
+ * @param hBatch handle to the batch.
+ * @param iField the field index.
+ * @return an array of values owned by the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+const void* OGR_FB_GetFieldData( OGRFeatureBatchH hBatch, int iField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldData", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->GetFieldData(iField);
+}
+
+/************************************************************************/
+/*                       OGR_FB_GetFieldOffsets()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the offsets of the values of a variable size field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldOffsets().
+ *
+ * @param hBatch handle to the batch.
+ * @param iField the field index.
+ * @return an array of offsets owned by the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+const size_t* OGR_FB_GetFieldOffsets( OGRFeatureBatchH hBatch, int iField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldOffsets", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->
+                                                    GetFieldOffsets(iField);
+}
+
+/************************************************************************/
+/*                        OGR_FB_GetFieldBytes()                        */
+/************************************************************************/
+
+/**
+ * \brief Return the buffer of the values of a variable size field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldBytes().
+ *
+ * @param hBatch handle to the batch.
+ * @param iField the field index.
+ * @return a buffer owned by the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+const GByte* OGR_FB_GetFieldBytes( OGRFeatureBatchH hBatch, int iField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldBytes", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->GetFieldBytes(iField);
+}
+
+/************************************************************************/
+/*                    OGR_FB_GetGeomFieldValidity()                     */
+/************************************************************************/
+
+/**
+ * \brief Return the validity bitmap of a geometry field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetGeomFieldValidity().
+ *
+ * @param hBatch handle to the batch.
+ * @param iGeomField the geometry field index.
+ * @return a bitmap owned by the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+const GByte* OGR_FB_GetGeomFieldValidity( OGRFeatureBatchH hBatch,
+                                          int iGeomField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetGeomFieldValidity", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->
+                                            GetGeomFieldValidity(iGeomField);
+}
+
+/************************************************************************/
+/*                     OGR_FB_GetGeomFieldOffsets()                     */
+/************************************************************************/
+
+/**
+ * \brief Return the offsets of the WKB geometries of a geometry field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetGeomFieldOffsets().
+ *
+ * @param hBatch handle to the batch.
+ * @param iGeomField the geometry field index.
+ * @return an array of offsets owned by the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+const size_t* OGR_FB_GetGeomFieldOffsets( OGRFeatureBatchH hBatch,
+                                          int iGeomField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetGeomFieldOffsets", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->
+                                            GetGeomFieldOffsets(iGeomField);
+}
+
+/************************************************************************/
+/*                       OGR_FB_GetGeomFieldWKB()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the buffer of the WKB geometries of a geometry field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetGeomFieldWKB().
+ *
+ * @param hBatch handle to the batch.
+ * @param iGeomField the geometry field index.
+ * @return a buffer owned by the batch.
+ *
+ * @since GDAL 2.3
+ */
+
+const GByte* OGR_FB_GetGeomFieldWKB( OGRFeatureBatchH hBatch, int iGeomField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetGeomFieldWKB", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->
+                                                GetGeomFieldWKB(iGeomField);
+}
+
+/************************************************************************/
+/*                         OGR_FB_GetFeature()                          */
+/************************************************************************/
+
+/**
+ * \brief Build a feature from a row of the batch.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFeature().
+ *
+ * @param hBatch handle to the batch.
+ * @param iFeature the feature index in the batch.
+ * @return a new feature to destroy with OGR_F_Destroy(), or NULL.
+ *
+ * @since GDAL 2.3
+ */
+
+OGRFeatureH OGR_FB_GetFeature( OGRFeatureBatchH hBatch, int iFeature )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFeature", NULL );
+
+    return reinterpret_cast<OGRFeatureH>(
+        reinterpret_cast<OGRFeatureBatch *>(hBatch)->GetFeature(iFeature));
+}
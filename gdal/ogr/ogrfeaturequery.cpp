@@ -32,9 +32,15 @@
 #include "ogr_feature.h"
 #include "swq.h"
 
+#include <cctype>
+#include <climits>
+#include <cmath>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
+#include <string>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -57,13 +63,1134 @@ const char *const SpecialFieldNames[SPECIAL_FIELD_COUNT] = {
 const swq_field_type SpecialFieldTypes[SPECIAL_FIELD_COUNT] = {
     SWQ_INTEGER, SWQ_STRING, SWQ_STRING, SWQ_STRING, SWQ_FLOAT};
 
+static swq_expr_node *OGRFeatureFetcher( swq_expr_node *op, void *pFeatureIn );
+
+/************************************************************************/
+/*                        OGRFeatureQueryProgram                        */
+/*                                                                      */
+/*      Flat form of a checked expression, evaluated without            */
+/*      allocating intermediate swq_expr_node objects.                  */
+/*                                                                      */
+/*      Comparisons, IN, BETWEEN, LIKE and IS NULL on fields and        */
+/*      constants become instructions specialized on the type the       */
+/*      swq_op_general.cpp evaluator would use for them, AND and OR     */
+/*      become conditional jumps on the current result, and boolean     */
+/*      sub-expressions that do not depend on the feature are folded    */
+/*      into constants. Other boolean sub-expressions are evaluated     */
+/*      with swq_expr_node::Evaluate().                                 */
+/************************************************************************/
+
+namespace {
+
+typedef enum
+{
+    OFQ_CONSTANT,           // nValue is the result.
+    OFQ_COMPARE,            // eOp between operands 0 and 1.
+    OFQ_IN,
+    OFQ_BETWEEN,
+    OFQ_LIKE,               // nValue is the escape character.
+    OFQ_ISNULL,
+    OFQ_NOT,
+    OFQ_JUMP_IF_FALSE,      // nValue is the offset of the target.
+    OFQ_JUMP_IF_TRUE,
+    OFQ_EXPRESSION          // poExpr evaluated with the generic evaluator.
+} OGRFeatureQueryOpcode;
+
+typedef enum
+{
+    OFQ_INTEGER,
+    OFQ_FLOAT,
+    OFQ_STRING
+} OGRFeatureQueryValueType;
+
+typedef enum
+{
+    OFQ_VALUE,
+    OFQ_FIELD_INTEGER,
+    OFQ_FIELD_INTEGER64,
+    OFQ_FIELD_REAL,
+    OFQ_FIELD_STRING,
+    OFQ_FIELD_OTHER,        // Only used by IS NULL.
+    OFQ_FID
+} OGRFeatureQueryOperandKind;
+
+struct OGRFeatureQueryOperand
+{
+    OGRFeatureQueryOperandKind eKind;
+    int                        iField;
+    GIntBig                    nValue;
+    double                     dfValue;
+    const char                *pszValue;
+    size_t                     nValueLen;
+};
+
+struct OGRFeatureQueryInstruction
+{
+    OGRFeatureQueryOpcode      eOpcode;
+    OGRFeatureQueryValueType   eType;
+    swq_op                     eOp;
+    int                        iFirstOperand;
+    int                        nOperandCount;
+    int                        nValue;
+    swq_expr_node             *poExpr;
+};
+
+/************************************************************************/
+/*                   OGRFeatureQueryFeatureAccessor                     */
+/*                                                                      */
+/*      Field values of an OGRFeature, as OGRFeatureFetcher() would     */
+/*      return them, but without copying strings.                       */
+/************************************************************************/
+
+class OGRFeatureQueryFeatureAccessor
+{
+    OGRFeature *m_poFeature;
+
+  public:
+    explicit OGRFeatureQueryFeatureAccessor( OGRFeature *poFeature ) :
+        m_poFeature(poFeature) {}
+
+    bool IsNull( const OGRFeatureQueryOperand& sOp ) const
+    {
+        if( sOp.eKind == OFQ_VALUE )
+            return false;
+        if( sOp.eKind == OFQ_FID )
+            return m_poFeature->GetFID() == OGRNullFID;
+        return !m_poFeature->IsFieldSetAndNotNull(sOp.iField);
+    }
+
+    GIntBig GetInteger( const OGRFeatureQueryOperand& sOp ) const
+    {
+        switch( sOp.eKind )
+        {
+            case OFQ_FIELD_INTEGER:
+                return m_poFeature->GetFieldAsInteger(sOp.iField);
+            case OFQ_FIELD_INTEGER64:
+                return m_poFeature->GetFieldAsInteger64(sOp.iField);
+            case OFQ_FID:
+                return m_poFeature->GetFID();
+            default:
+                return sOp.nValue;
+        }
+    }
+
+    double GetFloat( const OGRFeatureQueryOperand& sOp ) const
+    {
+        if( sOp.eKind == OFQ_FIELD_REAL )
+            return m_poFeature->GetFieldAsDouble(sOp.iField);
+        if( sOp.eKind == OFQ_VALUE )
+            return sOp.dfValue;
+        return static_cast<double>(GetInteger(sOp));
+    }
+
+    const char *GetString( const OGRFeatureQueryOperand& sOp,
+                           size_t& nLen ) const
+    {
+        if( sOp.eKind == OFQ_VALUE )
+        {
+            nLen = sOp.nValueLen;
+            return sOp.pszValue;
+        }
+        const char *pszValue = m_poFeature->GetFieldAsString(sOp.iField);
+        nLen = strlen(pszValue);
+        return pszValue;
+    }
+
+    const char *GetTerminatedString( const OGRFeatureQueryOperand& sOp,
+                                     int /* iSlot */ )
+    {
+        size_t nLen = 0;
+        return GetString(sOp, nLen);
+    }
+
+    swq_expr_node *EvaluateExpression( swq_expr_node *poExpr )
+    {
+        return poExpr->Evaluate(OGRFeatureFetcher, m_poFeature);
+    }
+};
+
+/************************************************************************/
+/*                    OGRFeatureQueryBatchAccessor                      */
+/*                                                                      */
+/*      Field values of a feature of an OGRFeatureBatch, read from      */
+/*      the column arrays of the batch.                                 */
+/************************************************************************/
+
+struct OGRFeatureQueryBatchColumn
+{
+    const GByte  *pabyValidity;
+    const void   *pData;
+    const size_t *panOffsets;
+    const GByte  *pabyBytes;
+};
+
+class OGRFeatureQueryBatchAccessor
+{
+    OGRFeatureBatch                        *m_poBatch;
+    const GIntBig                          *m_panFIDs;
+    std::vector<OGRFeatureQueryBatchColumn> m_asColumns;
+    int                                     m_iRow;
+    OGRFeature                             *m_poFeature;
+    std::string                             m_aosScratch[2];
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRFeatureQueryBatchAccessor)
+
+  public:
+    explicit OGRFeatureQueryBatchAccessor( OGRFeatureBatch *poBatch ) :
+        m_poBatch(poBatch),
+        m_panFIDs(NULL),
+        m_asColumns(poBatch->GetDefnRef()->GetFieldCount()),
+        m_iRow(0),
+        m_poFeature(NULL)
+    {}
+
+    ~OGRFeatureQueryBatchAccessor() { delete m_poFeature; }
+
+    void AddOperand( const OGRFeatureQueryOperand& sOp )
+    {
+        if( sOp.eKind == OFQ_VALUE )
+            return;
+        if( sOp.eKind == OFQ_FID )
+        {
+            m_panFIDs = m_poBatch->GetFIDs();
+            return;
+        }
+        OGRFeatureQueryBatchColumn& sCol = m_asColumns[sOp.iField];
+        if( sCol.pabyValidity != NULL )
+            return;
+        sCol.pabyValidity = m_poBatch->GetFieldValidity(sOp.iField);
+        if( sOp.eKind == OFQ_FIELD_STRING )
+        {
+            sCol.panOffsets = m_poBatch->GetFieldOffsets(sOp.iField);
+            sCol.pabyBytes = m_poBatch->GetFieldBytes(sOp.iField);
+        }
+        else if( sOp.eKind != OFQ_FIELD_OTHER )
+        {
+            sCol.pData = m_poBatch->GetFieldData(sOp.iField);
+        }
+    }
+
+    void SetRow( int iRow )
+    {
+        m_iRow = iRow;
+        delete m_poFeature;
+        m_poFeature = NULL;
+    }
+
+    bool IsNull( const OGRFeatureQueryOperand& sOp ) const
+    {
+        if( sOp.eKind == OFQ_VALUE )
+            return false;
+        if( sOp.eKind == OFQ_FID )
+            return m_panFIDs[m_iRow] == OGRNullFID;
+        const GByte *pabyValidity = m_asColumns[sOp.iField].pabyValidity;
+        return (pabyValidity[m_iRow / 8] & (1 << (m_iRow % 8))) == 0;
+    }
+
+    GIntBig GetInteger( const OGRFeatureQueryOperand& sOp ) const
+    {
+        switch( sOp.eKind )
+        {
+            case OFQ_FIELD_INTEGER:
+                return static_cast<const int *>(
+                    m_asColumns[sOp.iField].pData)[m_iRow];
+            case OFQ_FIELD_INTEGER64:
+                return static_cast<const GIntBig *>(
+                    m_asColumns[sOp.iField].pData)[m_iRow];
+            case OFQ_FID:
+                return m_panFIDs[m_iRow];
+            default:
+                return sOp.nValue;
+        }
+    }
+
+    double GetFloat( const OGRFeatureQueryOperand& sOp ) const
+    {
+        if( sOp.eKind == OFQ_FIELD_REAL )
+            return static_cast<const double *>(
+                m_asColumns[sOp.iField].pData)[m_iRow];
+        if( sOp.eKind == OFQ_VALUE )
+            return sOp.dfValue;
+        return static_cast<double>(GetInteger(sOp));
+    }
+
+    const char *GetString( const OGRFeatureQueryOperand& sOp,
+                           size_t& nLen ) const
+    {
+        if( sOp.eKind == OFQ_VALUE )
+        {
+            nLen = sOp.nValueLen;
+            return sOp.pszValue;
+        }
+        const OGRFeatureQueryBatchColumn& sCol = m_asColumns[sOp.iField];
+        nLen = sCol.panOffsets[m_iRow + 1] - sCol.panOffsets[m_iRow];
+        if( nLen == 0 )
+            return "";
+        return reinterpret_cast<const char *>(sCol.pabyBytes) +
+               sCol.panOffsets[m_iRow];
+    }
+
+    // Batch strings are not nul terminated: copy them in a buffer that is
+    // reused from one feature to the other.
+    const char *GetTerminatedString( const OGRFeatureQueryOperand& sOp,
+                                     int iSlot )
+    {
+        size_t nLen = 0;
+        const char *pszValue = GetString(sOp, nLen);
+        if( sOp.eKind == OFQ_VALUE )
+            return pszValue;
+        m_aosScratch[iSlot].assign(pszValue, nLen);
+        return m_aosScratch[iSlot].c_str();
+    }
+
+    swq_expr_node *EvaluateExpression( swq_expr_node *poExpr )
+    {
+        if( m_poFeature == NULL )
+            m_poFeature = m_poBatch->GetFeature(m_iRow);
+        if( m_poFeature == NULL )
+            return NULL;
+        return poExpr->Evaluate(OGRFeatureFetcher, m_poFeature);
+    }
+};
+
+/************************************************************************/
+/*                       OGRFeatureQueryCompare()                       */
+/************************************************************************/
+
+template<class T> bool OGRFeatureQueryCompare( swq_op eOp, T a, T b )
+{
+    switch( eOp )
+    {
+        case SWQ_EQ: return a == b;
+        case SWQ_NE: return a != b;
+        case SWQ_GT: return a > b;
+        case SWQ_LT: return a < b;
+        case SWQ_GE: return a >= b;
+        case SWQ_LE: return a <= b;
+        default: return false;
+    }
+}
+
+/************************************************************************/
+/*                      OGRFeatureQueryStrCaseCmp()                     */
+/*                                                                      */
+/*      strcasecmp() on strings that are not nul terminated.            */
+/************************************************************************/
+
+int OGRFeatureQueryStrCaseCmp( const char *pszA, size_t nLenA,
+                               const char *pszB, size_t nLenB )
+{
+    const size_t nLen = std::min(nLenA, nLenB);
+    for( size_t i = 0; i < nLen; i++ )
+    {
+        const int chA = tolower(static_cast<unsigned char>(pszA[i]));
+        const int chB = tolower(static_cast<unsigned char>(pszB[i]));
+        if( chA != chB )
+            return chA - chB;
+    }
+    if( nLenA == nLenB )
+        return 0;
+    return nLenA < nLenB ? -1 : 1;
+}
+
+/************************************************************************/
+/*                      OGRFeatureQueryStringEqual()                    */
+/*                                                                      */
+/*      Same as the SWQ_EQ string evaluator, including the handling     */
+/*      of the +00 time zone at the end of timestamps.                  */
+/************************************************************************/
+
+bool OGRFeatureQueryStringEqual( const char *pszA, size_t nLenA,
+                                 const char *pszB, size_t nLenB )
+{
+    if( nLenA > 3 && nLenB > 3 )
+    {
+        if( memcmp(pszA + nLenA - 3, "+00", 3) == 0 &&
+            pszB[nLenB - 3] == ':' )
+        {
+            return nLenA >= nLenB &&
+                   OGRFeatureQueryStrCaseCmp(pszA, nLenB, pszB, nLenB) == 0;
+        }
+        if( pszA[nLenA - 3] == ':' &&
+            memcmp(pszB + nLenB - 3, "+00", 3) == 0 )
+        {
+            return nLenB >= nLenA &&
+                   OGRFeatureQueryStrCaseCmp(pszA, nLenA, pszB, nLenA) == 0;
+        }
+    }
+    return nLenA == nLenB &&
+           OGRFeatureQueryStrCaseCmp(pszA, nLenA, pszB, nLenB) == 0;
+}
+
+} // namespace
+
+class OGRFeatureQueryProgram
+{
+    OGRFeatureDefn                         *m_poDefn;
+    std::vector<OGRFeatureQueryInstruction> m_asInstructions;
+    std::vector<OGRFeatureQueryOperand>     m_asOperands;
+    std::vector<swq_expr_node *>            m_apoFoldedNodes;
+
+    static bool IsBooleanOperation( const swq_expr_node *poNode );
+    static bool IsConstantExpression( const swq_expr_node *poNode );
+
+    void        Emit( OGRFeatureQueryOpcode eOpcode, int nValue = 0 );
+    bool        IsConstantBlock( size_t iStart, size_t iEnd ) const;
+    bool        GetOperand( swq_expr_node *poNode,
+                            OGRFeatureQueryOperand& sOp,
+                            swq_field_type& eType, bool& bIsNull );
+    bool        CompileBoolean( swq_expr_node *poNode );
+    bool        CompileLogicalOperand( swq_expr_node *poNode );
+    bool        CompileOperation( swq_expr_node *poNode );
+    bool        CompileLogical( swq_expr_node *poNode );
+    bool        CompileComparison( swq_expr_node *poNode );
+
+    template<class Accessor> bool Run( Accessor& oAccessor ) const;
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRFeatureQueryProgram)
+
+  public:
+    explicit OGRFeatureQueryProgram( OGRFeatureDefn *poDefn ) :
+        m_poDefn(poDefn) {}
+    ~OGRFeatureQueryProgram();
+
+    bool        Compile( swq_expr_node *poExpr );
+
+    int         Evaluate( OGRFeature *poFeature ) const;
+    int         EvaluateBatch( OGRFeatureBatch *poBatch,
+                               GByte *pabyResults,
+                               int iFirstFeature ) const;
+};
+
+/************************************************************************/
+/*                       ~OGRFeatureQueryProgram()                      */
+/************************************************************************/
+
+OGRFeatureQueryProgram::~OGRFeatureQueryProgram()
+{
+    for( size_t i = 0; i < m_apoFoldedNodes.size(); i++ )
+        delete m_apoFoldedNodes[i];
+}
+
+/************************************************************************/
+/*                         IsBooleanOperation()                         */
+/*                                                                      */
+/*      Operations whose result is never null, so that they can be      */
+/*      combined with short-circuit AND and OR.                         */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::IsBooleanOperation( const swq_expr_node *poNode )
+{
+    if( poNode->eNodeType != SNT_OPERATION ||
+        poNode->field_type != SWQ_BOOLEAN )
+        return false;
+
+    switch( poNode->nOperation )
+    {
+        case SWQ_AND:
+        case SWQ_OR:
+        case SWQ_NOT:
+        case SWQ_EQ:
+        case SWQ_NE:
+        case SWQ_GT:
+        case SWQ_LT:
+        case SWQ_GE:
+        case SWQ_LE:
+        case SWQ_IN:
+        case SWQ_BETWEEN:
+        case SWQ_LIKE:
+        case SWQ_ISNULL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/************************************************************************/
+/*                        IsConstantExpression()                        */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::IsConstantExpression(
+                                                const swq_expr_node *poNode )
+{
+    if( poNode->eNodeType == SNT_CONSTANT )
+        return true;
+    if( poNode->eNodeType != SNT_OPERATION ||
+        (poNode->nOperation >= SWQ_AVG && poNode->nOperation <= SWQ_SUM) ||
+        poNode->nOperation >= SWQ_CUSTOM_FUNC )
+        return false;
+    for( int i = 0; i < poNode->nSubExprCount; i++ )
+    {
+        if( !IsConstantExpression(poNode->papoSubExpr[i]) )
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                                Emit()                                */
+/************************************************************************/
+
+void OGRFeatureQueryProgram::Emit( OGRFeatureQueryOpcode eOpcode,
+                                   int nValue )
+{
+    OGRFeatureQueryInstruction sInstr;
+    sInstr.eOpcode = eOpcode;
+    sInstr.eType = OFQ_INTEGER;
+    sInstr.eOp = SWQ_EQ;
+    sInstr.iFirstOperand = 0;
+    sInstr.nOperandCount = 0;
+    sInstr.nValue = nValue;
+    sInstr.poExpr = NULL;
+    m_asInstructions.push_back(sInstr);
+}
+
+/************************************************************************/
+/*                          IsConstantBlock()                           */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::IsConstantBlock( size_t iStart,
+                                              size_t iEnd ) const
+{
+    return iEnd == iStart + 1 &&
+           m_asInstructions[iStart].eOpcode == OFQ_CONSTANT;
+}
+
+/************************************************************************/
+/*                             GetOperand()                             */
+/*                                                                      */
+/*      Turn a field or a constant expression into an operand. eType    */
+/*      is set to the type of the value the generic evaluator would     */
+/*      see for it.                                                     */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::GetOperand( swq_expr_node *poNode,
+                                         OGRFeatureQueryOperand& sOp,
+                                         swq_field_type& eType,
+                                         bool& bIsNull )
+{
+    sOp.eKind = OFQ_VALUE;
+    sOp.iField = -1;
+    sOp.nValue = 0;
+    sOp.dfValue = 0.0;
+    sOp.pszValue = NULL;
+    sOp.nValueLen = 0;
+    bIsNull = false;
+
+    if( poNode->eNodeType == SNT_COLUMN )
+    {
+        if( poNode->table_index != 0 )
+            return false;
+
+        const int iField = poNode->field_index;
+        sOp.iField = iField;
+        if( iField == m_poDefn->GetFieldCount() + SPF_FID )
+        {
+            sOp.eKind = OFQ_FID;
+            eType = SWQ_INTEGER64;
+            return true;
+        }
+        if( iField < 0 || iField >= m_poDefn->GetFieldCount() )
+            return false;
+
+        const OGRFieldType eFieldType =
+            m_poDefn->GetFieldDefn(iField)->GetType();
+        if( eFieldType == OFTInteger &&
+            (poNode->field_type == SWQ_INTEGER ||
+             poNode->field_type == SWQ_BOOLEAN) )
+        {
+            sOp.eKind = OFQ_FIELD_INTEGER;
+            eType = SWQ_INTEGER;
+        }
+        else if( eFieldType == OFTInteger64 &&
+                 poNode->field_type == SWQ_INTEGER64 )
+        {
+            sOp.eKind = OFQ_FIELD_INTEGER64;
+            eType = SWQ_INTEGER64;
+        }
+        else if( eFieldType == OFTReal && poNode->field_type == SWQ_FLOAT )
+        {
+            sOp.eKind = OFQ_FIELD_REAL;
+            eType = SWQ_FLOAT;
+        }
+        else if( eFieldType == OFTString &&
+                 poNode->field_type == SWQ_STRING )
+        {
+            sOp.eKind = OFQ_FIELD_STRING;
+            eType = SWQ_STRING;
+        }
+        else
+        {
+            sOp.eKind = OFQ_FIELD_OTHER;
+            eType = SWQ_OTHER;
+        }
+        return true;
+    }
+
+    swq_expr_node *poValue = poNode;
+    if( poNode->eNodeType == SNT_OPERATION )
+    {
+        if( !IsConstantExpression(poNode) )
+            return false;
+        poValue = poNode->Evaluate(OGRFeatureFetcher, NULL);
+        if( poValue == NULL )
+            return false;
+        m_apoFoldedNodes.push_back(poValue);
+    }
+    else if( poNode->eNodeType != SNT_CONSTANT )
+    {
+        return false;
+    }
+
+    eType = poValue->field_type;
+    bIsNull = CPL_TO_BOOL(poValue->is_null);
+    sOp.nValue = poValue->int_value;
+    sOp.dfValue = eType == SWQ_FLOAT ?
+        poValue->float_value : static_cast<double>(poValue->int_value);
+    if( eType == SWQ_STRING && poValue->string_value != NULL )
+    {
+        sOp.pszValue = poValue->string_value;
+        sOp.nValueLen = strlen(poValue->string_value);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                           CompileBoolean()                           */
+/*                                                                      */
+/*      Append the instructions of a boolean operation. Returns false   */
+/*      if the node is not such an operation.                           */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::CompileBoolean( swq_expr_node *poNode )
+{
+    if( !IsBooleanOperation(poNode) )
+        return false;
+
+    const size_t iStart = m_asInstructions.size();
+    const size_t iStartOperands = m_asOperands.size();
+
+    if( IsConstantExpression(poNode) )
+    {
+        swq_expr_node *poResult = poNode->Evaluate(OGRFeatureFetcher, NULL);
+        if( poResult != NULL )
+        {
+            Emit(OFQ_CONSTANT, poResult->int_value != 0);
+            delete poResult;
+            return true;
+        }
+    }
+    else if( CompileOperation(poNode) )
+    {
+        return true;
+    }
+
+    m_asInstructions.resize(iStart);
+    m_asOperands.resize(iStartOperands);
+    Emit(OFQ_EXPRESSION);
+    m_asInstructions.back().poExpr = poNode;
+    return true;
+}
+
+/************************************************************************/
+/*                        CompileLogicalOperand()                       */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::CompileLogicalOperand( swq_expr_node *poNode )
+{
+    if( poNode->eNodeType == SNT_CONSTANT )
+    {
+        if( poNode->is_null ||
+            !(SWQ_IS_INTEGER(poNode->field_type) ||
+              poNode->field_type == SWQ_BOOLEAN) )
+            return false;
+        Emit(OFQ_CONSTANT, poNode->int_value != 0);
+        return true;
+    }
+    return CompileBoolean(poNode);
+}
+
+/************************************************************************/
+/*                          CompileOperation()                          */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::CompileOperation( swq_expr_node *poNode )
+{
+    switch( poNode->nOperation )
+    {
+        case SWQ_AND:
+        case SWQ_OR:
+        case SWQ_NOT:
+            return CompileLogical(poNode);
+        default:
+            return CompileComparison(poNode);
+    }
+}
+
+/************************************************************************/
+/*                           CompileLogical()                           */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::CompileLogical( swq_expr_node *poNode )
+{
+    const size_t iStart = m_asInstructions.size();
+
+    // A null operand makes the result false, whatever the other operand is.
+    for( int i = 0; i < poNode->nSubExprCount; i++ )
+    {
+        if( poNode->papoSubExpr[i]->eNodeType == SNT_CONSTANT &&
+            poNode->papoSubExpr[i]->is_null )
+        {
+            Emit(OFQ_CONSTANT, FALSE);
+            return true;
+        }
+    }
+
+    if( poNode->nOperation == SWQ_NOT )
+    {
+        if( poNode->nSubExprCount != 1 ||
+            !CompileLogicalOperand(poNode->papoSubExpr[0]) )
+            return false;
+        if( IsConstantBlock(iStart, m_asInstructions.size()) )
+            m_asInstructions[iStart].nValue = !m_asInstructions[iStart].nValue;
+        else
+            Emit(OFQ_NOT);
+        return true;
+    }
+
+    if( poNode->nSubExprCount != 2 ||
+        !CompileLogicalOperand(poNode->papoSubExpr[0]) )
+        return false;
+    const size_t iRight = m_asInstructions.size();
+    if( !CompileLogicalOperand(poNode->papoSubExpr[1]) )
+        return false;
+    const size_t iEnd = m_asInstructions.size();
+
+    // With AND, a false operand gives the result, and a true one can be
+    // dropped. The reverse holds for OR.
+    const int bAbsorbing = poNode->nOperation == SWQ_OR;
+    if( IsConstantBlock(iStart, iRight) )
+    {
+        if( m_asInstructions[iStart].nValue == bAbsorbing )
+            m_asInstructions.resize(iStart + 1);
+        else
+            m_asInstructions.erase(m_asInstructions.begin() + iStart);
+    }
+    else if( IsConstantBlock(iRight, iEnd) )
+    {
+        if( m_asInstructions[iRight].nValue == bAbsorbing )
+        {
+            m_asInstructions.resize(iStart);
+            Emit(OFQ_CONSTANT, bAbsorbing);
+        }
+        else
+        {
+            m_asInstructions.resize(iRight);
+        }
+    }
+    else
+    {
+        // Jumping to the end of the right operand leaves the result of
+        // the left operand as the result of the operation.
+        Emit(bAbsorbing ? OFQ_JUMP_IF_TRUE : OFQ_JUMP_IF_FALSE,
+             static_cast<int>(iEnd - iRight) + 1);
+        const OGRFeatureQueryInstruction sJump = m_asInstructions.back();
+        m_asInstructions.pop_back();
+        m_asInstructions.insert(m_asInstructions.begin() + iRight, sJump);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                         CompileComparison()                          */
+/*                                                                      */
+/*      Comparison operators, IN, BETWEEN, LIKE and IS NULL. The type   */
+/*      of the comparison follows the dispatching done by               */
+/*      SWQGeneralEvaluator().                                          */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::CompileComparison( swq_expr_node *poNode )
+{
+    const int eOp = poNode->nOperation;
+    const int nSubExprCount = poNode->nSubExprCount;
+    switch( eOp )
+    {
+        case SWQ_EQ:
+        case SWQ_NE:
+        case SWQ_GT:
+        case SWQ_LT:
+        case SWQ_GE:
+        case SWQ_LE:
+            if( nSubExprCount != 2 )
+                return false;
+            break;
+        case SWQ_IN:
+            if( nSubExprCount < 2 )
+                return false;
+            break;
+        case SWQ_BETWEEN:
+            if( nSubExprCount != 3 )
+                return false;
+            break;
+        case SWQ_LIKE:
+            if( nSubExprCount != 2 && nSubExprCount != 3 )
+                return false;
+            break;
+        case SWQ_ISNULL:
+            if( nSubExprCount != 1 )
+                return false;
+            break;
+        default:
+            return false;
+    }
+
+    // The escape character of LIKE is not an operand.
+    const int nOperandCount =
+        (eOp == SWQ_LIKE && nSubExprCount == 3) ? 2 : nSubExprCount;
+    const int iFirstOperand = static_cast<int>(m_asOperands.size());
+    std::vector<swq_field_type> aeTypes;
+    bool bHasNull = false;
+    for( int i = 0; i < nOperandCount; i++ )
+    {
+        OGRFeatureQueryOperand sOp;
+        swq_field_type eType = SWQ_OTHER;
+        bool bIsNull = false;
+        if( !GetOperand(poNode->papoSubExpr[i], sOp, eType, bIsNull) )
+            return false;
+        if( sOp.eKind == OFQ_FIELD_OTHER && eOp != SWQ_ISNULL )
+            return false;
+        bHasNull |= bIsNull;
+        aeTypes.push_back(eType);
+        m_asOperands.push_back(sOp);
+    }
+
+    int nValue = 0;
+    if( eOp == SWQ_LIKE && nSubExprCount == 3 )
+    {
+        const swq_expr_node *poEscape = poNode->papoSubExpr[2];
+        if( poEscape->eNodeType != SNT_CONSTANT ||
+            poEscape->field_type != SWQ_STRING )
+            return false;
+        if( poEscape->is_null )
+            bHasNull = true;
+        else
+            nValue = poEscape->string_value[0];
+    }
+
+    if( eOp == SWQ_ISNULL )
+    {
+        // Null constants have been folded by CompileBoolean().
+        if( m_asOperands[iFirstOperand].eKind == OFQ_VALUE )
+            return false;
+        Emit(OFQ_ISNULL);
+    }
+    else if( bHasNull )
+    {
+        Emit(OFQ_CONSTANT, FALSE);
+        return true;
+    }
+    else
+    {
+        OGRFeatureQueryValueType eValueType = OFQ_INTEGER;
+        if( aeTypes[0] == SWQ_FLOAT || aeTypes[1] == SWQ_FLOAT )
+        {
+            // Only the first two values are converted to floating point.
+            for( int i = 0; i < nOperandCount; i++ )
+            {
+                if( aeTypes[i] != SWQ_FLOAT &&
+                    (i >= 2 || !SWQ_IS_INTEGER(aeTypes[i])) )
+                    return false;
+            }
+            eValueType = OFQ_FLOAT;
+        }
+        else if( SWQ_IS_INTEGER(aeTypes[0]) || aeTypes[0] == SWQ_BOOLEAN )
+        {
+            for( int i = 0; i < nOperandCount; i++ )
+            {
+                if( !SWQ_IS_INTEGER(aeTypes[i]) &&
+                    aeTypes[i] != SWQ_BOOLEAN )
+                    return false;
+            }
+            eValueType = OFQ_INTEGER;
+        }
+        else if( aeTypes[0] == SWQ_STRING )
+        {
+            for( int i = 0; i < nOperandCount; i++ )
+            {
+                if( aeTypes[i] != SWQ_STRING )
+                    return false;
+            }
+            eValueType = OFQ_STRING;
+        }
+        else
+        {
+            return false;
+        }
+
+        if( eOp == SWQ_LIKE && eValueType != OFQ_STRING )
+            return false;
+
+        Emit(eOp == SWQ_IN ? OFQ_IN :
+             eOp == SWQ_BETWEEN ? OFQ_BETWEEN :
+             eOp == SWQ_LIKE ? OFQ_LIKE : OFQ_COMPARE, nValue);
+        m_asInstructions.back().eType = eValueType;
+    }
+
+    m_asInstructions.back().eOp = static_cast<swq_op>(eOp);
+    m_asInstructions.back().iFirstOperand = iFirstOperand;
+    m_asInstructions.back().nOperandCount = nOperandCount;
+    return true;
+}
+
+/************************************************************************/
+/*                              Compile()                               */
+/*                                                                      */
+/*      Returns false if the expression would not be evaluated faster   */
+/*      than by swq_expr_node::Evaluate().                              */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::Compile( swq_expr_node *poExpr )
+{
+    if( !CompileBoolean(poExpr) )
+        return false;
+
+    return !(m_asInstructions.size() == 1 &&
+             m_asInstructions[0].eOpcode == OFQ_EXPRESSION);
+}
+
+/************************************************************************/
+/*                                Run()                                 */
+/************************************************************************/
+
+template<class Accessor>
+bool OGRFeatureQueryProgram::Run( Accessor& oAccessor ) const
+{
+    const int nInstructions = static_cast<int>(m_asInstructions.size());
+    const OGRFeatureQueryOperand *pasOperands =
+        m_asOperands.empty() ? NULL : &m_asOperands[0];
+    bool bResult = false;
+
+    for( int i = 0; i < nInstructions; i++ )
+    {
+        const OGRFeatureQueryInstruction& sInstr = m_asInstructions[i];
+        const OGRFeatureQueryOperand *pasOp =
+            pasOperands + sInstr.iFirstOperand;
+
+        switch( sInstr.eOpcode )
+        {
+            case OFQ_CONSTANT:
+                bResult = sInstr.nValue != 0;
+                break;
+
+            case OFQ_NOT:
+                bResult = !bResult;
+                break;
+
+            case OFQ_JUMP_IF_FALSE:
+                if( !bResult )
+                    i += sInstr.nValue - 1;
+                break;
+
+            case OFQ_JUMP_IF_TRUE:
+                if( bResult )
+                    i += sInstr.nValue - 1;
+                break;
+
+            case OFQ_ISNULL:
+                bResult = oAccessor.IsNull(pasOp[0]);
+                break;
+
+            case OFQ_EXPRESSION:
+            {
+                swq_expr_node *poResult =
+                    oAccessor.EvaluateExpression(sInstr.poExpr);
+                if( poResult == NULL )
+                    return false;
+                bResult = poResult->int_value != 0;
+                delete poResult;
+                break;
+            }
+
+            default:
+            {
+                // Comparisons with a null value are false.
+                bResult = false;
+                int iOp = 0;
+                for( ; iOp < sInstr.nOperandCount; iOp++ )
+                {
+                    if( oAccessor.IsNull(pasOp[iOp]) )
+                        break;
+                }
+                if( iOp < sInstr.nOperandCount )
+                    break;
+
+                if( sInstr.eOpcode == OFQ_LIKE )
+                {
+                    const char *pszInput =
+                        oAccessor.GetTerminatedString(pasOp[0], 0);
+                    const char *pszPattern =
+                        oAccessor.GetTerminatedString(pasOp[1], 1);
+                    bResult = CPL_TO_BOOL(swq_test_like(
+                        pszInput, pszPattern,
+                        static_cast<char>(sInstr.nValue)));
+                }
+                else if( sInstr.eType == OFQ_INTEGER )
+                {
+                    const GIntBig nValue = oAccessor.GetInteger(pasOp[0]);
+                    if( sInstr.eOpcode == OFQ_COMPARE )
+                    {
+                        bResult = OGRFeatureQueryCompare(
+                            sInstr.eOp, nValue,
+                            oAccessor.GetInteger(pasOp[1]));
+                    }
+                    else if( sInstr.eOpcode == OFQ_BETWEEN )
+                    {
+                        bResult =
+                            nValue >= oAccessor.GetInteger(pasOp[1]) &&
+                            nValue <= oAccessor.GetInteger(pasOp[2]);
+                    }
+                    else
+                    {
+                        for( iOp = 1; iOp < sInstr.nOperandCount; iOp++ )
+                        {
+                            if( nValue == oAccessor.GetInteger(pasOp[iOp]) )
+                            {
+                                bResult = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+                else if( sInstr.eType == OFQ_FLOAT )
+                {
+                    const double dfValue = oAccessor.GetFloat(pasOp[0]);
+                    if( sInstr.eOpcode == OFQ_COMPARE )
+                    {
+                        bResult = OGRFeatureQueryCompare(
+                            sInstr.eOp, dfValue,
+                            oAccessor.GetFloat(pasOp[1]));
+                    }
+                    else if( sInstr.eOpcode == OFQ_BETWEEN )
+                    {
+                        bResult = dfValue >= oAccessor.GetFloat(pasOp[1]) &&
+                                  dfValue <= oAccessor.GetFloat(pasOp[2]);
+                    }
+                    else
+                    {
+                        for( iOp = 1; iOp < sInstr.nOperandCount; iOp++ )
+                        {
+                            if( dfValue == oAccessor.GetFloat(pasOp[iOp]) )
+                            {
+                                bResult = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+                else
+                {
+                    size_t nLen = 0;
+                    const char *pszValue =
+                        oAccessor.GetString(pasOp[0], nLen);
+                    size_t nOtherLen = 0;
+                    if( sInstr.eOpcode == OFQ_COMPARE )
+                    {
+                        const char *pszOther =
+                            oAccessor.GetString(pasOp[1], nOtherLen);
+                        if( sInstr.eOp == SWQ_EQ )
+                            bResult = OGRFeatureQueryStringEqual(
+                                pszValue, nLen, pszOther, nOtherLen);
+                        else
+                            bResult = OGRFeatureQueryCompare(
+                                sInstr.eOp,
+                                OGRFeatureQueryStrCaseCmp(
+                                    pszValue, nLen, pszOther, nOtherLen),
+                                0);
+                    }
+                    else if( sInstr.eOpcode == OFQ_BETWEEN )
+                    {
+                        const char *pszMin =
+                            oAccessor.GetString(pasOp[1], nOtherLen);
+                        bResult = OGRFeatureQueryStrCaseCmp(
+                            pszValue, nLen, pszMin, nOtherLen) >= 0;
+                        if( bResult )
+                        {
+                            const char *pszMax =
+                                oAccessor.GetString(pasOp[2], nOtherLen);
+                            bResult = OGRFeatureQueryStrCaseCmp(
+                                pszValue, nLen, pszMax, nOtherLen) <= 0;
+                        }
+                    }
+                    else
+                    {
+                        for( iOp = 1; iOp < sInstr.nOperandCount; iOp++ )
+                        {
+                            const char *pszOther =
+                                oAccessor.GetString(pasOp[iOp], nOtherLen);
+                            if( OGRFeatureQueryStrCaseCmp(
+                                    pszValue, nLen,
+                                    pszOther, nOtherLen) == 0 )
+                            {
+                                bResult = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    return bResult;
+}
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/************************************************************************/
+
+int OGRFeatureQueryProgram::Evaluate( OGRFeature *poFeature ) const
+{
+    OGRFeatureQueryFeatureAccessor oAccessor(poFeature);
+    return Run(oAccessor);
+}
+
+/************************************************************************/
+/*                           EvaluateBatch()                            */
+/************************************************************************/
+
+int OGRFeatureQueryProgram::EvaluateBatch( OGRFeatureBatch *poBatch,
+                                           GByte *pabyResults,
+                                           int iFirstFeature ) const
+{
+    const int nFeatureCount = poBatch->GetFeatureCount();
+    if( iFirstFeature >= nFeatureCount )
+        return 0;
+
+    OGRFeatureQueryBatchAccessor oAccessor(poBatch);
+    for( size_t i = 0; i < m_asOperands.size(); i++ )
+        oAccessor.AddOperand(m_asOperands[i]);
+
+    int nMatching = 0;
+    for( int iRow = iFirstFeature; iRow < nFeatureCount; iRow++ )
+    {
+        oAccessor.SetRow(iRow);
+        const bool bResult = Run(oAccessor);
+        pabyResults[iRow] = bResult ? TRUE : FALSE;
+        if( bResult )
+            nMatching++;
+    }
+    return nMatching;
+}
+
 /************************************************************************/
 /*                          OGRFeatureQuery()                           */
 /************************************************************************/
 
 OGRFeatureQuery::OGRFeatureQuery() :
     poTargetDefn(NULL),
-    pSWQExpr(NULL)
+    pSWQExpr(NULL),
+    poProgram(NULL)
 {}
 
 /************************************************************************/
@@ -73,6 +1200,7 @@ OGRFeatureQuery::OGRFeatureQuery() :
 OGRFeatureQuery::~OGRFeatureQuery()
 
 {
+    delete poProgram;
     delete static_cast<swq_expr_node *>(pSWQExpr);
 }
 
@@ -88,6 +1216,8 @@ OGRFeatureQuery::Compile( OGRFeatureDefn *poDefn,
 
 {
     // Clear any existing expression.
+    delete poProgram;
+    poProgram = NULL;
     if( pSWQExpr != NULL )
     {
         delete static_cast<swq_expr_node *>(pSWQExpr);
@@ -188,6 +1318,17 @@ OGRFeatureQuery::Compile( OGRFeatureDefn *poDefn,
         eErr = OGRERR_CORRUPT_DATA;
         pSWQExpr = NULL;
     }
+    // The types of the nodes are only known once the expression is checked.
+    else if( bCheck &&
+             CPLTestBool(CPLGetConfigOption("OGR_SQL_COMPILE_WHERE", "YES")) )
+    {
+        poProgram = new OGRFeatureQueryProgram(poDefn);
+        if( !poProgram->Compile(static_cast<swq_expr_node *>(pSWQExpr)) )
+        {
+            delete poProgram;
+            poProgram = NULL;
+        }
+    }
 
     CPLFree(papszFieldNames);
     CPLFree(paeFieldTypes);
@@ -260,6 +1401,9 @@ int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
     if( pSWQExpr == NULL )
         return FALSE;
 
+    if( poProgram != NULL && poFeature->GetDefnRef() == poTargetDefn )
+        return poProgram->Evaluate(poFeature);
+
     swq_expr_node *poResult =
         static_cast<swq_expr_node *>(pSWQExpr)->
             Evaluate(OGRFeatureFetcher, poFeature);
@@ -278,6 +1422,306 @@ int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
     return bLogicalResult;
 }
 
+/************************************************************************/
+/*                           EvaluateBatch()                            */
+/*                                                                      */
+/*      Evaluate the expression on the features of a batch, starting    */
+/*      at iFirstFeature, reading the field values from its columns.    */
+/*      pabyResults must have room for poBatch->GetFeatureCount()       */
+/*      values, of which the ones of the evaluated features are set to  */
+/*      TRUE or FALSE.  Returns the number of evaluated features        */
+/*      matching the expression.                                        */
+/************************************************************************/
+
+int OGRFeatureQuery::EvaluateBatch( OGRFeatureBatch *poBatch,
+                                    GByte *pabyResults,
+                                    int iFirstFeature )
+
+{
+    if( pSWQExpr != NULL && poProgram != NULL &&
+        poBatch->IsCompatibleWith(poTargetDefn) )
+        return poProgram->EvaluateBatch(poBatch, pabyResults, iFirstFeature);
+
+    int nMatching = 0;
+    for( int iRow = iFirstFeature; iRow < poBatch->GetFeatureCount(); iRow++ )
+    {
+        OGRFeature *poFeature = poBatch->GetFeature(iRow);
+        pabyResults[iRow] =
+            (poFeature != NULL && Evaluate(poFeature)) ? TRUE : FALSE;
+        nMatching += pabyResults[iRow];
+        delete poFeature;
+    }
+    return nMatching;
+}
+
+/************************************************************************/
+/*                          OGRGetIndexKey()                            */
+/*                                                                      */
+/*      Convert the constant of a comparison to a value of the type of  */
+/*      the indexed field.  Non integral values compared to integer     */
+/*      fields are rounded down if nRound < 0 and up otherwise, so      */
+/*      that the resulting range is a superset of the exact matches.    */
+/************************************************************************/
+
+static bool OGRGetIndexKey( OGRFieldType eType, swq_expr_node *poValue,
+                            int nRound, OGRField *psKey )
+{
+    if( poValue->eNodeType != SNT_CONSTANT || poValue->is_null )
+        return false;
+
+    switch( eType )
+    {
+      case OFTInteger:
+      case OFTInteger64:
+      {
+        GIntBig nValue = 0;
+        if( poValue->field_type == SWQ_FLOAT )
+        {
+            // Beyond 2^53, the evaluator compares values which are not
+            // exactly representable.
+            const double dfValue = poValue->float_value;
+            if( CPLIsNan(dfValue) || fabs(dfValue) >= 9007199254740992.0 )
+                return false;
+            nValue = static_cast<GIntBig>(
+                nRound < 0 ? floor(dfValue) : ceil(dfValue));
+        }
+        else if( poValue->field_type == SWQ_INTEGER ||
+                 poValue->field_type == SWQ_INTEGER64 )
+        {
+            nValue = poValue->int_value;
+        }
+        else
+            return false;
+
+        if( eType == OFTInteger )
+            psKey->Integer = static_cast<int>(
+                std::max(static_cast<GIntBig>(INT_MIN),
+                         std::min(static_cast<GIntBig>(INT_MAX), nValue)));
+        else
+            psKey->Integer64 = nValue;
+        return true;
+      }
+
+      case OFTReal:
+        if( poValue->field_type == SWQ_FLOAT )
+            psKey->Real = poValue->float_value;
+        else if( poValue->field_type == SWQ_INTEGER ||
+                 poValue->field_type == SWQ_INTEGER64 )
+            psKey->Real = static_cast<double>(poValue->int_value);
+        else
+            return false;
+        return true;
+
+      case OFTString:
+        if( poValue->field_type != SWQ_STRING )
+            return false;
+        psKey->String = poValue->string_value;
+        return true;
+
+      case OFTDate:
+      case OFTTime:
+      case OFTDateTime:
+        if( poValue->field_type != SWQ_STRING &&
+            poValue->field_type != SWQ_TIMESTAMP &&
+            poValue->field_type != SWQ_DATE &&
+            poValue->field_type != SWQ_TIME )
+            return false;
+        return OGRParseDate(poValue->string_value, psKey, 0) == TRUE;
+
+      default:
+        return false;
+    }
+}
+
+/************************************************************************/
+/*                         OGRGetIndexRanges()                          */
+/*                                                                      */
+/*      Translate a comparison of an indexed field with constants to    */
+/*      the key ranges of the index to scan.  The ranges may match      */
+/*      more features than the comparison, which is evaluated again     */
+/*      on the returned features.  Returns NULL if the field has no     */
+/*      index supporting range queries, or if the comparison cannot     */
+/*      be expressed as ranges.                                         */
+/************************************************************************/
+
+namespace {
+struct OGRIndexRange
+{
+    bool        bHasMin;
+    bool        bMinIncluded;
+    OGRField    sMin;
+    bool        bHasMax;
+    bool        bMaxIncluded;
+    OGRField    sMax;
+    CPLString   osPrefix;   // Prefix match if not empty.
+
+    OGRIndexRange() : bHasMin(false), bMinIncluded(true),
+                      bHasMax(false), bMaxIncluded(true)
+    {
+        memset(&sMin, 0, sizeof(sMin));
+        memset(&sMax, 0, sizeof(sMax));
+    }
+};
+} // namespace
+
+static OGRAttrIndex *OGRGetIndexRanges( swq_expr_node *psExpr,
+                                        OGRLayer *poLayer,
+                                        std::vector<OGRIndexRange>& aoRanges )
+{
+    if( psExpr->nSubExprCount < 2 )
+        return NULL;
+
+    int nOperation = psExpr->nOperation;
+    swq_expr_node *poColumn = psExpr->papoSubExpr[0];
+    bool bSwapped = false;
+
+    // Put the column on the left of simple comparisons.
+    if( poColumn->eNodeType == SNT_CONSTANT && psExpr->nSubExprCount == 2 &&
+        psExpr->papoSubExpr[1]->eNodeType == SNT_COLUMN )
+    {
+        switch( nOperation )
+        {
+          case SWQ_EQ: break;
+          case SWQ_GT: nOperation = SWQ_LT; break;
+          case SWQ_GE: nOperation = SWQ_LE; break;
+          case SWQ_LT: nOperation = SWQ_GT; break;
+          case SWQ_LE: nOperation = SWQ_GE; break;
+          default: return NULL;
+        }
+        poColumn = psExpr->papoSubExpr[1];
+        bSwapped = true;
+    }
+
+    if( poColumn->eNodeType != SNT_COLUMN )
+        return NULL;
+    for( int i = 1; i < psExpr->nSubExprCount; i++ )
+    {
+        if( psExpr->papoSubExpr[bSwapped ? 0 : i]->eNodeType != SNT_CONSTANT )
+            return NULL;
+    }
+
+    OGRAttrIndex *poIndex =
+        poLayer->GetIndex()->GetFieldIndex(poColumn->field_index);
+    if( poIndex == NULL || !poIndex->SupportsRangeQueries() )
+        return NULL;
+
+    const OGRFieldType eType = poLayer->GetLayerDefn()->
+        GetFieldDefn(poColumn->field_index)->GetType();
+    const bool bIsDate =
+        eType == OFTDate || eType == OFTTime || eType == OFTDateTime;
+    swq_expr_node *poValue = psExpr->papoSubExpr[bSwapped ? 0 : 1];
+
+    // Dates are compared as dates by EQ, GT, GE, LT, LE and BETWEEN when
+    // their first operand is a timestamp, and as strings otherwise.
+    if( bIsDate && ((bSwapped && poValue->field_type != SWQ_TIMESTAMP) ||
+                    nOperation == SWQ_IN || nOperation == SWQ_LIKE) )
+        return NULL;
+
+    OGRIndexRange oRange;
+    switch( nOperation )
+    {
+      case SWQ_EQ:
+        if( eType == OFTString && poValue->field_type == SWQ_STRING &&
+            strlen(poValue->string_value) > 3 )
+        {
+            // Mirror the special handling of time zones by the evaluator.
+            const char *pszValue = poValue->string_value;
+            const size_t nLen = strlen(pszValue);
+            if( strcmp(pszValue + nLen - 3, "+00") == 0 )
+                return NULL;
+            if( pszValue[nLen - 3] == ':' )
+            {
+                oRange.osPrefix = pszValue;
+                aoRanges.push_back(oRange);
+                break;
+            }
+        }
+        CPL_FALLTHROUGH
+
+      case SWQ_IN:
+        for( int i = 1; i < psExpr->nSubExprCount; i++ )
+        {
+            swq_expr_node *poIN = psExpr->papoSubExpr[bSwapped ? 0 : i];
+            if( !OGRGetIndexKey(eType, poIN, -1, &oRange.sMin) ||
+                !OGRGetIndexKey(eType, poIN, 1, &oRange.sMax) )
+                return NULL;
+            oRange.bHasMin = true;
+            oRange.bHasMax = true;
+            aoRanges.push_back(oRange);
+        }
+        break;
+
+      case SWQ_GT:
+      case SWQ_GE:
+        if( !OGRGetIndexKey(eType, poValue, -1, &oRange.sMin) )
+            return NULL;
+        oRange.bHasMin = true;
+        oRange.bMinIncluded = nOperation == SWQ_GE ||
+                              poValue->field_type == SWQ_FLOAT;
+        aoRanges.push_back(oRange);
+        break;
+
+      case SWQ_LT:
+      case SWQ_LE:
+        if( !OGRGetIndexKey(eType, poValue, 1, &oRange.sMax) )
+            return NULL;
+        oRange.bHasMax = true;
+        oRange.bMaxIncluded = nOperation == SWQ_LE ||
+                              poValue->field_type == SWQ_FLOAT;
+        aoRanges.push_back(oRange);
+        break;
+
+      case SWQ_BETWEEN:
+        if( psExpr->nSubExprCount != 3 ||
+            !OGRGetIndexKey(eType, psExpr->papoSubExpr[1], -1,
+                            &oRange.sMin) ||
+            !OGRGetIndexKey(eType, psExpr->papoSubExpr[2], 1, &oRange.sMax) )
+            return NULL;
+        oRange.bHasMin = true;
+        oRange.bHasMax = true;
+        aoRanges.push_back(oRange);
+        break;
+
+      case SWQ_LIKE:
+      {
+        if( eType != OFTString || poValue->field_type != SWQ_STRING )
+            return NULL;
+
+        char chEscape = '\0';
+        if( psExpr->nSubExprCount == 3 )
+        {
+            if( psExpr->papoSubExpr[2]->field_type != SWQ_STRING )
+                return NULL;
+            chEscape = psExpr->papoSubExpr[2]->string_value[0];
+        }
+
+        // The literal characters before the first wildcard.
+        const char *pszPattern = poValue->string_value;
+        for( ; *pszPattern != '\0'; pszPattern++ )
+        {
+            if( *pszPattern == chEscape )
+            {
+                pszPattern++;
+                if( *pszPattern == '\0' )
+                    break;
+            }
+            else if( *pszPattern == '%' || *pszPattern == '_' )
+                break;
+            oRange.osPrefix += *pszPattern;
+        }
+        if( oRange.osPrefix.empty() )
+            return NULL;
+        aoRanges.push_back(oRange);
+        break;
+      }
+
+      default:
+        return NULL;
+    }
+
+    return poIndex;
+}
+
 /************************************************************************/
 /*                            CanUseIndex()                             */
 /************************************************************************/
@@ -300,13 +1744,24 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
     if( psExpr == NULL || psExpr->eNodeType != SNT_OPERATION )
         return FALSE;
 
-    if( (psExpr->nOperation == SWQ_OR || psExpr->nOperation == SWQ_AND) &&
-         psExpr->nSubExprCount == 2 )
+    if( psExpr->nOperation == SWQ_OR && psExpr->nSubExprCount == 2 )
     {
         return CanUseIndex(psExpr->papoSubExpr[0], poLayer) &&
                CanUseIndex(psExpr->papoSubExpr[1], poLayer);
     }
 
+    // The candidates of one side of an AND are evaluated against the
+    // whole expression.
+    if( psExpr->nOperation == SWQ_AND && psExpr->nSubExprCount == 2 )
+    {
+        return CanUseIndex(psExpr->papoSubExpr[0], poLayer) ||
+               CanUseIndex(psExpr->papoSubExpr[1], poLayer);
+    }
+
+    std::vector<OGRIndexRange> aoRanges;
+    if( OGRGetIndexRanges(psExpr, poLayer, aoRanges) != NULL )
+        return TRUE;
+
     if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN)
         || psExpr->nSubExprCount < 2 )
         return FALSE;
@@ -320,7 +1775,7 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
 
     OGRAttrIndex *poIndex =
         poLayer->GetIndex()->GetFieldIndex(poColumn->field_index);
-    if( poIndex == NULL )
+    if( poIndex == NULL || poIndex->SupportsRangeQueries() )
         return FALSE;
 
     // Have an index.
@@ -336,9 +1791,11 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
 /*      available indices, or an "OGRNullFID" terminated list of        */
 /*      FIDs if it can.                                                 */
 /*                                                                      */
-/*      For now we only support equality tests on a single indexed      */
-/*      attribute field.  Eventually we should make this support        */
-/*      multi-part queries with ranges.                                 */
+/*      Indexes supporting range queries are used for comparisons,      */
+/*      BETWEEN and LIKE 'prefix%' tests, and only equality tests are   */
+/*      handled otherwise.  The returned list may contain FIDs of       */
+/*      features not matching the query, which must still be            */
+/*      evaluated against each feature.                                 */
 /************************************************************************/
 
 static int CompareGIntBig( const void *pa, const void *pb )
@@ -512,7 +1969,7 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
         GIntBig* panFIDList1 =
             EvaluateAgainstIndices(psExpr->papoSubExpr[0], poLayer, nFIDCount1);
         GIntBig* panFIDList2 =
-            panFIDList1 == NULL ? NULL :
+            (panFIDList1 == NULL && psExpr->nOperation == SWQ_OR) ? NULL :
             EvaluateAgainstIndices(psExpr->papoSubExpr[1], poLayer, nFIDCount2);
         GIntBig* panFIDList = NULL;
         if( panFIDList1 != NULL && panFIDList2 != NULL )
@@ -524,11 +1981,65 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
                 panFIDList = OGRANDGIntBigArray(panFIDList1, nFIDCount1,
                                             panFIDList2, nFIDCount2, nFIDCount);
         }
+        else if( psExpr->nOperation == SWQ_AND )
+        {
+            // The candidates of the indexed side are a superset of the
+            // result.
+            if( panFIDList1 != NULL )
+            {
+                nFIDCount = nFIDCount1;
+                return panFIDList1;
+            }
+            if( panFIDList2 != NULL )
+            {
+                nFIDCount = nFIDCount2;
+                return panFIDList2;
+            }
+        }
         CPLFree(panFIDList1);
         CPLFree(panFIDList2);
         return panFIDList;
     }
 
+/* -------------------------------------------------------------------- */
+/*      Range and prefix queries.                                       */
+/* -------------------------------------------------------------------- */
+    std::vector<OGRIndexRange> aoRanges;
+    OGRAttrIndex *poRangeIndex =
+        OGRGetIndexRanges(psExpr, poLayer, aoRanges);
+    if( poRangeIndex != NULL )
+    {
+        int nLength = 0;
+        int nFIDCount32 = 0;
+        GIntBig *panFIDs = NULL;
+        for( size_t i = 0; i < aoRanges.size(); i++ )
+        {
+            const OGRIndexRange& oRange = aoRanges[i];
+            if( !oRange.osPrefix.empty() )
+                panFIDs = poRangeIndex->GetPrefixMatches(
+                    oRange.osPrefix, panFIDs, &nFIDCount32, &nLength);
+            else
+                panFIDs = poRangeIndex->GetRangeMatches(
+                    oRange.bHasMin ? &oRange.sMin : NULL, oRange.bMinIncluded,
+                    oRange.bHasMax ? &oRange.sMax : NULL, oRange.bMaxIncluded,
+                    panFIDs, &nFIDCount32, &nLength);
+            if( panFIDs == NULL )
+                return NULL;
+        }
+        nFIDCount = nFIDCount32;
+
+        if( nFIDCount > 1 )
+        {
+            // The returned FIDs are expected to be sorted and unique.
+            qsort(panFIDs, static_cast<size_t>(nFIDCount),
+                  sizeof(GIntBig), CompareGIntBig);
+            nFIDCount =
+                std::unique(panFIDs, panFIDs + nFIDCount) - panFIDs;
+            panFIDs[nFIDCount] = OGRNullFID;
+        }
+        return panFIDs;
+    }
+
     if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN)
         || psExpr->nSubExprCount < 2 )
         return NULL;
@@ -542,7 +2053,7 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
 
     OGRAttrIndex *poIndex =
         poLayer->GetIndex()->GetFieldIndex(poColumn->field_index);
-    if( poIndex == NULL )
+    if( poIndex == NULL || poIndex->SupportsRangeQueries() )
         return NULL;
 
     // Have an index, now we need to query it.
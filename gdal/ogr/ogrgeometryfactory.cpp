@@ -32,7 +32,10 @@
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_multiproc.h"
+#include "cpl_packed_rtree.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "ogr_geometry.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
@@ -52,6 +55,7 @@
 #include <cstddef>
 
 #include <algorithm>
+#include <functional>
 #include <new>
 #include <utility>
 #include <vector>
@@ -1290,6 +1294,233 @@ typedef enum
    METHOD_CCW_INNER_JUST_AFTER_CW_OUTER
 } OrganizePolygonMethod;
 
+// Minimum number of parts from which the envelopes are indexed, and from
+// which the containment tests can be spread over several threads.
+static const int N_MIN_PART_NUMBER_FOR_INDEX = 32;
+static const int N_MIN_PART_NUMBER_FOR_THREADS = 1000;
+
+/************************************************************************/
+/*                  OGRGeometryFactoryIsInside()                        */
+/*                                                                      */
+/*      Test whether polygon I is inside polygon J, which has a         */
+/*      greater area. bLastCandidate is set when J is the largest       */
+/*      polygon.                                                        */
+/************************************************************************/
+
+static bool OGRGeometryFactoryIsInside( const sPolyExtended& sPolyI,
+                                        const sPolyExtended& sPolyJ,
+                                        bool bLastCandidate,
+                                        OrganizePolygonMethod method,
+                                        bool bUseFastVersion )
+{
+    if( !sPolyJ.sEnvelope.Contains(sPolyI.sEnvelope) )
+        return false;
+
+    if( !bUseFastVersion )
+        return CPL_TO_BOOL(sPolyJ.poPolygon->Contains(sPolyI.poPolygon));
+
+    if( method == METHOD_ONLY_CCW && bLastCandidate )
+    {
+        // We are testing if a CCW ring is in the biggest CW
+        // ring It *must* be inside as this is the last
+        // candidate, otherwise the winding order rules is
+        // broken.
+        return true;
+    }
+
+    if( !sPolyI.bIsPolygon || !sPolyJ.bIsPolygon )
+        return false;
+
+    OGRLinearRing* poLR_i =
+        reinterpret_cast<OGRLinearRing*>(sPolyI.poExteriorRing);
+    OGRLinearRing* poLR_j =
+        reinterpret_cast<OGRLinearRing*>(sPolyJ.poExteriorRing);
+    if( poLR_j->isPointOnRingBoundary(&sPolyI.poAPoint, FALSE) )
+    {
+        // If the point of i is on the boundary of j, we will
+        // iterate over the other points of i.
+        const int nPoints = poLR_i->getNumPoints();
+        int k = 1;  // Used after for.
+        for( ; k < nPoints; k++ )
+        {
+            OGRPoint point;
+            poLR_i->getPoint(k, &point);
+            if( poLR_j->isPointOnRingBoundary(&point, FALSE) )
+            {
+                // If it is on the boundary of j, iterate again.
+            }
+            else if( poLR_j->isPointInRing(&point, FALSE) )
+            {
+                // If then point is strictly included in j, then
+                // i is considered inside j.
+                return true;
+            }
+            else
+            {
+                // If it is outside, then i cannot be inside j.
+                break;
+            }
+        }
+        if( k == nPoints && nPoints > 2 )
+        {
+            // All points of i are on the boundary of j.
+            // Take a point in the middle of a segment of i and
+            // test it against j.
+            for( k = 0; k < nPoints - 1; k++ )
+            {
+                OGRPoint point1;
+                OGRPoint point2;
+                OGRPoint pointMiddle;
+                poLR_i->getPoint(k, &point1);
+                poLR_i->getPoint(k+1, &point2);
+                pointMiddle.setX((point1.getX() + point2.getX()) / 2);
+                pointMiddle.setY((point1.getY() + point2.getY()) / 2);
+                if( poLR_j->isPointOnRingBoundary(&pointMiddle, FALSE) )
+                {
+                    // If it is on the boundary of j, iterate
+                    // again.
+                }
+                else if( poLR_j->isPointInRing(&pointMiddle, FALSE) )
+                {
+                    // If then point is strictly included in j,
+                    // then i is considered inside j.
+                    return true;
+                }
+                else
+                {
+                    // If it is outside, then i cannot be inside
+                    // j.
+                    break;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Note that isPointInRing only test strict inclusion in the
+    // ring.
+    return CPL_TO_BOOL(poLR_j->isPointInRing(&sPolyI.poAPoint, FALSE));
+}
+
+/************************************************************************/
+/*                  OGRGeometryFactoryFindEnclosing()                   */
+/*                                                                      */
+/*      Return the index of the smallest polygon of greater area than   */
+/*      polygon i, that contains it, or -1. If a polygon that overlaps  */
+/*      i is found first, its index is returned and *pbOverlapping is   */
+/*      set. asPolyEx must be sorted by decreasing area, and hTree, if  */
+/*      not NULL, must index the envelopes of asPolyEx.                 */
+/************************************************************************/
+
+static int OGRGeometryFactoryFindEnclosing( const sPolyExtended* asPolyEx,
+                                            int i,
+                                            const CPLPackedRTree* hTree,
+                                            OrganizePolygonMethod method,
+                                            bool bUseFastVersion,
+                                            bool* pbOverlapping )
+{
+    *pbOverlapping = false;
+
+    // Polygons whose envelope does not intersect the one of i can neither
+    // contain it nor overlap it, so with an index only the other ones are
+    // tested, in the same order.
+    std::vector<int> anCandidates;
+    if( hTree != NULL )
+    {
+        CPLRectObj sAoi;
+        sAoi.minx = asPolyEx[i].sEnvelope.MinX;
+        sAoi.miny = asPolyEx[i].sEnvelope.MinY;
+        sAoi.maxx = asPolyEx[i].sEnvelope.MaxX;
+        sAoi.maxy = asPolyEx[i].sEnvelope.MaxY;
+        int nCount = 0;
+        int* panIndices = CPLPackedRTreeSearch(hTree, &sAoi, &nCount);
+        for( int k = 0; k < nCount; k++ )
+        {
+            if( panIndices[k] < i )
+                anCandidates.push_back(panIndices[k]);
+        }
+        CPLFree(panIndices);
+        std::sort(anCandidates.begin(), anCandidates.end(),
+                  std::greater<int>());
+    }
+
+    const int nCandidates =
+        hTree != NULL ? static_cast<int>(anCandidates.size()) : i;
+    for( int k = 0; k < nCandidates; k++ )
+    {
+        const int j = hTree != NULL ? anCandidates[k] : i - 1 - k;
+
+        if( method == METHOD_ONLY_CCW && asPolyEx[j].bIsCW == FALSE )
+        {
+            // In that mode, i which is CCW if we reach here can only be
+            // included in a CW polygon.
+            continue;
+        }
+
+        if( OGRGeometryFactoryIsInside(asPolyEx[i], asPolyEx[j], j == 0,
+                                       method, bUseFastVersion) )
+        {
+            return j;
+        }
+
+        // Use Overlaps instead of Intersects to be more
+        // tolerant about touching polygons.
+        if( !bUseFastVersion &&
+            asPolyEx[i].sEnvelope.Intersects(asPolyEx[j].sEnvelope) &&
+            asPolyEx[i].poPolygon->Overlaps(asPolyEx[j].poPolygon) )
+        {
+            *pbOverlapping = true;
+            return j;
+        }
+    }
+
+    return -1;
+}
+
+/************************************************************************/
+/*                OGRGeometryFactoryOrganizePolygonsJob()               */
+/************************************************************************/
+
+typedef struct
+{
+    const sPolyExtended*  asPolyEx;
+    const CPLPackedRTree* hTree;
+    OrganizePolygonMethod method;
+    bool                  bUseFastVersion;
+    int                   nStart;
+    int                   nEnd;
+    int*                  panEnclosing;
+    bool*                 pabOverlapping;
+} OGROrganizePolygonsJob;
+
+static void OGRGeometryFactoryOrganizePolygonsJob( void* pData )
+{
+    OGROrganizePolygonsJob* psJob = static_cast<OGROrganizePolygonsJob*>(pData);
+    for( int i = psJob->nStart; i < psJob->nEnd; i++ )
+    {
+        if( psJob->method == METHOD_ONLY_CCW && psJob->asPolyEx[i].bIsCW )
+            continue;
+        psJob->panEnclosing[i] =
+            OGRGeometryFactoryFindEnclosing(psJob->asPolyEx, i, psJob->hTree,
+                                            psJob->method,
+                                            psJob->bUseFastVersion,
+                                            &psJob->pabOverlapping[i]);
+    }
+}
+
+/************************************************************************/
+/*                 OGRGeometryFactoryGetThreadCount()                   */
+/*                                                                      */
+/*      Number of threads set by the pszConfigOption configuration      */
+/*      option, defaulting to GDAL_NUM_THREADS.                         */
+/************************************************************************/
+
+static int OGRGeometryFactoryGetThreadCount( const char* pszConfigOption )
+{
+    return CPLGetNumThreadsOption(pszConfigOption,
+                            CPLGetNumThreadsOption("GDAL_NUM_THREADS", 1));
+}
+
 /**
  * \brief Organize polygons based on geometries.
  *
@@ -1329,6 +1560,13 @@ typedef enum
  * the value of the METHOD option of papszOptions (useful to modify the behaviour of the
  * shapefile driver)
  *
+ * Starting with GDAL 2.3, the envelopes of the polygons are indexed so that
+ * only polygons whose envelopes intersect are compared, and the
+ * OGR_ORGANIZE_POLYGONS_NUM_THREADS configuration option (defaulting to
+ * GDAL_NUM_THREADS) can be set to a number of threads, or ALL_CPUS, to
+ * spread that analysis when more than 1000 polygons are passed. The result
+ * does not depend on those settings.
+ *
  * @param papoPolygons array of geometry pointers - should all be OGRPolygons.
  * Ownership of the geometries is passed, but not of the array itself.
  * @param nPolygonCount number of items in papoPolygons
@@ -1625,7 +1863,10 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
           outer ring
        5) Add the top-level polygons to the multipolygon
 
-       Complexity : O(nPolygonCount^2)
+       Complexity : O(nPolygonCount^2) in the worst case, but only polygons
+       whose envelopes intersect are compared, thanks to a R-tree, so that
+       it is closer to O(nPolygonCount * log(nPolygonCount)) for polygons
+       that are well separated, or that are small holes of big polygons.
     */
 
     /* Compute how each polygon relate to the other ones
@@ -1664,6 +1905,86 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
     int nCountTopLevel = 1;
 
     // STEP 2.
+    // For each polygon, find the first polygon of greater area that
+    // contains it, or that overlaps it. This is independent of the result
+    // for the other polygons, so it can be spread over several threads,
+    // and a R-tree over the envelopes avoids testing polygons whose
+    // envelopes do not intersect: those are neither containing nor
+    // overlapping.
+    CPLPackedRTree* hTree = NULL;
+    if( !bMixedUpGeometries && nPolygonCount >= N_MIN_PART_NUMBER_FOR_INDEX )
+    {
+        CPLRectObj* pasRects = static_cast<CPLRectObj*>(
+            VSI_MALLOC2_VERBOSE(nPolygonCount, sizeof(CPLRectObj)));
+        bool bFinite = pasRects != NULL;
+        for( int i = 0; bFinite && i < nPolygonCount; i++ )
+        {
+            const OGREnvelope& sEnvelope = asPolyEx[i].sEnvelope;
+            pasRects[i].minx = sEnvelope.MinX;
+            pasRects[i].miny = sEnvelope.MinY;
+            pasRects[i].maxx = sEnvelope.MaxX;
+            pasRects[i].maxy = sEnvelope.MaxY;
+            bFinite = CPLIsFinite(sEnvelope.MinX) &&
+                      CPLIsFinite(sEnvelope.MinY) &&
+                      CPLIsFinite(sEnvelope.MaxX) &&
+                      CPLIsFinite(sEnvelope.MaxY);
+        }
+        if( bFinite )
+        {
+            hTree = CPLPackedRTreeCreate(pasRects, nPolygonCount,
+                                         CPL_PACKED_RTREE_DEFAULT_NODE_SIZE);
+        }
+        CPLFree(pasRects);
+    }
+
+    int* panEnclosing = NULL;
+    bool* pabOverlapping = NULL;
+    const int nThreads = nPolygonCount >= N_MIN_PART_NUMBER_FOR_THREADS &&
+                         !bMixedUpGeometries ?
+                            OGRGeometryFactoryGetThreadCount(
+                                "OGR_ORGANIZE_POLYGONS_NUM_THREADS") : 1;
+    if( nThreads > 1 )
+    {
+        CPLWorkerThreadPool oPool;
+        panEnclosing = static_cast<int*>(
+            VSI_MALLOC2_VERBOSE(nPolygonCount, sizeof(int)));
+        pabOverlapping = static_cast<bool*>(
+            VSI_MALLOC2_VERBOSE(nPolygonCount, sizeof(bool)));
+        if( panEnclosing == NULL || pabOverlapping == NULL ||
+            !oPool.Setup(nThreads, NULL, NULL) )
+        {
+            CPLFree(panEnclosing);
+            CPLFree(pabOverlapping);
+            panEnclosing = NULL;
+            pabOverlapping = NULL;
+        }
+        else
+        {
+            // Small chunks, as the cost of a polygon is very variable.
+            const int nJobs = std::min(nPolygonCount - 1, nThreads * 16);
+            std::vector<OGROrganizePolygonsJob> asJobs(nJobs);
+            std::vector<void*> apJobs;
+            for( int iJob = 0; iJob < nJobs; iJob++ )
+            {
+                OGROrganizePolygonsJob& sJob = asJobs[iJob];
+                sJob.asPolyEx = asPolyEx;
+                sJob.hTree = hTree;
+                sJob.method = method;
+                sJob.bUseFastVersion = bUseFastVersion;
+                sJob.nStart = 1 + static_cast<int>(
+                    static_cast<GIntBig>(nPolygonCount - 1) * iJob / nJobs);
+                sJob.nEnd = 1 + static_cast<int>(
+                    static_cast<GIntBig>(nPolygonCount - 1) * (iJob + 1) /
+                                                                    nJobs);
+                sJob.panEnclosing = panEnclosing;
+                sJob.pabOverlapping = pabOverlapping;
+                apJobs.push_back(&sJob);
+            }
+            oPool.SubmitJobs(OGRGeometryFactoryOrganizePolygonsJob, apJobs);
+            oPool.WaitCompletion();
+        }
+    }
+
     for( int i = 1;
          !bMixedUpGeometries && bValidTopology && i<nPolygonCount;
          i++ )
@@ -1676,176 +1997,42 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
             continue;
         }
 
-        int j = i - 1;  // Used after for.
-        for( ; bValidTopology && j >= 0; j-- )
+        int j = -1;
+        bool bOverlapping = false;
+        if( panEnclosing != NULL )
         {
-            bool b_i_inside_j = false;
-
-            if( method == METHOD_ONLY_CCW && asPolyEx[j].bIsCW == FALSE )
-            {
-                // In that mode, i which is CCW if we reach here can only be
-                // included in a CW polygon.
-                continue;
-            }
-
-            if( asPolyEx[j].sEnvelope.Contains(asPolyEx[i].sEnvelope) )
-            {
-                if( bUseFastVersion )
-                {
-                    if( method == METHOD_ONLY_CCW && j == 0 )
-                    {
-                        // We are testing if a CCW ring is in the biggest CW
-                        // ring It *must* be inside as this is the last
-                        // candidate, otherwise the winding order rules is
-                        // broken.
-                        b_i_inside_j = true;
-                    }
-                    else if( asPolyEx[i].bIsPolygon &&
-                             asPolyEx[j].bIsPolygon &&
-                             reinterpret_cast<OGRLinearRing*>(
-                                 asPolyEx[j].poExteriorRing)->
-                                     isPointOnRingBoundary(
-                                         &asPolyEx[i].poAPoint, FALSE) )
-                    {
-                        OGRLinearRing* poLR_i =
-                            reinterpret_cast<OGRLinearRing*>(
-                                asPolyEx[i].poExteriorRing);
-                        OGRLinearRing* poLR_j =
-                            reinterpret_cast<OGRLinearRing*>(
-                                asPolyEx[j].poExteriorRing);
-                        // If the point of i is on the boundary of j, we will
-                        // iterate over the other points of i.
-                        const int nPoints = poLR_i->getNumPoints();
-                        int k = 1;  // Used after for.
-                        for( ; k < nPoints; k++ )
-                        {
-                            OGRPoint point;
-                            poLR_i->getPoint(k, &point);
-                            if( poLR_j->isPointOnRingBoundary(&point, FALSE) )
-                            {
-                                // If it is on the boundary of j, iterate again.
-                            }
-                            else if( poLR_j->isPointInRing(&point, FALSE) )
-                            {
-                                // If then point is strictly included in j, then
-                                // i is considered inside j.
-                                b_i_inside_j = true;
-                                break;
-                            }
-                            else
-                            {
-                                // If it is outside, then i cannot be inside j.
-                                break;
-                            }
-                        }
-                        if( !b_i_inside_j && k == nPoints && nPoints > 2 )
-                        {
-                            // All points of i are on the boundary of j.
-                            // Take a point in the middle of a segment of i and
-                            // test it against j.
-                            for( k = 0; k < nPoints - 1; k++ )
-                            {
-                                OGRPoint point1;
-                                OGRPoint point2;
-                                OGRPoint pointMiddle;
-                                poLR_i->getPoint(k, &point1);
-                                poLR_i->getPoint(k+1, &point2);
-                                pointMiddle.setX((point1.getX() +
-                                                  point2.getX()) / 2);
-                                pointMiddle.setY((point1.getY() +
-                                                  point2.getY()) / 2);
-                                if( poLR_j->isPointOnRingBoundary(&pointMiddle,
-                                                                  FALSE) )
-                                {
-                                    // If it is on the boundary of j, iterate
-                                    // again.
-                                }
-                                else if( poLR_j->isPointInRing(&pointMiddle,
-                                                               FALSE) )
-                                {
-                                    // If then point is strictly included in j,
-                                    // then i is considered inside j.
-                                    b_i_inside_j = true;
-                                    break;
-                                }
-                                else
-                                {
-                                    // If it is outside, then i cannot be inside
-                                    // j.
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                    // Note that isPointInRing only test strict inclusion in the
-                    // ring.
-                    else if( asPolyEx[i].bIsPolygon &&
-                             asPolyEx[j].bIsPolygon &&
-                             reinterpret_cast<OGRLinearRing*>(
-                                 asPolyEx[j].poExteriorRing)->
-                                     isPointInRing(&asPolyEx[i].poAPoint,
-                                                   FALSE) )
-                    {
-                        b_i_inside_j = true;
-                    }
-                }
-                else if( asPolyEx[j].poPolygon->
-                             Contains(asPolyEx[i].poPolygon) )
-                {
-                    b_i_inside_j = true;
-                }
-            }
-
-            if( b_i_inside_j )
-            {
-                if( asPolyEx[j].bIsTopLevel )
-                {
-                    // We are a lake.
-                    asPolyEx[i].bIsTopLevel = false;
-                    asPolyEx[i].poEnclosingPolygon = asPolyEx[j].poPolygon;
-                }
-                else
-                {
-                    // We are included in a something not toplevel (a lake),
-                    // so in OGCSF we are considered as toplevel too.
-                    nCountTopLevel++;
-                    asPolyEx[i].bIsTopLevel = true;
-                    asPolyEx[i].poEnclosingPolygon = NULL;
-                }
-                break;
-            }
-            // Use Overlaps instead of Intersects to be more
-            // tolerant about touching polygons.
-            else if( bUseFastVersion ||
-                     !asPolyEx[i].sEnvelope.Intersects(asPolyEx[j].sEnvelope) ||
-                     !asPolyEx[i].poPolygon->Overlaps(asPolyEx[j].poPolygon) )
-            {
+            j = panEnclosing[i];
+            bOverlapping = pabOverlapping[i];
+        }
+        else
+        {
+            j = OGRGeometryFactoryFindEnclosing(asPolyEx, i, hTree, method,
+                                                bUseFastVersion,
+                                                &bOverlapping);
+        }
 
-            }
-            else
-            {
-                // Bad... The polygons are intersecting but no one is
-                // contained inside the other one. This is a really broken
-                // case. We just make a multipolygon with the whole set of
-                // polygons.
-                bValidTopology = false;
+        if( bOverlapping )
+        {
+            // Bad... The polygons are intersecting but no one is
+            // contained inside the other one. This is a really broken
+            // case. We just make a multipolygon with the whole set of
+            // polygons.
+            bValidTopology = false;
 #ifdef DEBUG
-                char* wkt1 = NULL;
-                char* wkt2 = NULL;
-                asPolyEx[i].poPolygon->exportToWkt(&wkt1);
-                asPolyEx[j].poPolygon->exportToWkt(&wkt2);
-                CPLDebug( "OGR",
-                          "Bad intersection for polygons %d and %d\n"
-                          "geom %d: %s\n"
-                          "geom %d: %s",
-                          i, j, i, wkt1, j, wkt2 );
-                CPLFree(wkt1);
-                CPLFree(wkt2);
+            char* wkt1 = NULL;
+            char* wkt2 = NULL;
+            asPolyEx[i].poPolygon->exportToWkt(&wkt1);
+            asPolyEx[j].poPolygon->exportToWkt(&wkt2);
+            CPLDebug( "OGR",
+                      "Bad intersection for polygons %d and %d\n"
+                      "geom %d: %s\n"
+                      "geom %d: %s",
+                      i, j, i, wkt1, j, wkt2 );
+            CPLFree(wkt1);
+            CPLFree(wkt2);
 #endif
-            }
         }
-
-        if( j < 0 )
+        else if( j < 0 )
         {
             // We come here because we are not included in anything.
             // We are toplevel.
@@ -1853,8 +2040,27 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
             asPolyEx[i].bIsTopLevel = true;
             asPolyEx[i].poEnclosingPolygon = NULL;
         }
+        else if( asPolyEx[j].bIsTopLevel )
+        {
+            // We are a lake.
+            asPolyEx[i].bIsTopLevel = false;
+            asPolyEx[i].poEnclosingPolygon = asPolyEx[j].poPolygon;
+        }
+        else
+        {
+            // We are included in a something not toplevel (a lake),
+            // so in OGCSF we are considered as toplevel too.
+            nCountTopLevel++;
+            asPolyEx[i].bIsTopLevel = true;
+            asPolyEx[i].poEnclosingPolygon = NULL;
+        }
     }
 
+    CPLFree(panEnclosing);
+    CPLFree(pabOverlapping);
+    if( hTree != NULL )
+        CPLPackedRTreeDestroy(hTree);
+
     if( pbIsValidGeometry )
         *pbIsValidGeometry = bValidTopology && !bMixedUpGeometries;
 
@@ -3724,6 +3930,394 @@ OGRGeometry* OGRGeometryFactory::transformWithOptions(
     return poDstGeom;
 }
 
+/************************************************************************/
+/*                        OGRGeometryFactoryBatchCT                     */
+/*                                                                      */
+/*      Pseudo transformation used by transformGeometries(). In         */
+/*      recording mode, it appends the coordinates it receives to its   */
+/*      arrays and leaves them unchanged. In replay mode, it hands      */
+/*      back the coordinates that have been transformed in bulk, in     */
+/*      the order they were recorded.                                   */
+/************************************************************************/
+
+namespace {
+class OGRGeometryFactoryBatchCT : public OGRCoordinateTransformation
+{
+    OGRCoordinateTransformation *m_poCT;
+    OGRSpatialReference         *m_poTargetSRS;
+
+  public:
+    bool                m_bReplay;
+    size_t              m_nCursor;
+    std::vector<double> m_adfX;
+    std::vector<double> m_adfY;
+    std::vector<double> m_adfZ;
+    std::vector<int>    m_abSuccess;
+
+    OGRGeometryFactoryBatchCT( OGRCoordinateTransformation* poCT,
+                               OGRSpatialReference* poTargetSRS ) :
+        m_poCT(poCT), m_poTargetSRS(poTargetSRS),
+        m_bReplay(false), m_nCursor(0) {}
+
+    virtual OGRSpatialReference *GetSourceCS() override
+        { return m_poCT->GetSourceCS(); }
+    virtual OGRSpatialReference *GetTargetCS() override
+        { return m_poTargetSRS; }
+
+    virtual int Transform( int nCount,
+                           double *x, double *y, double *z = NULL ) override;
+    virtual int TransformEx( int nCount,
+                             double *x, double *y, double *z = NULL,
+                             int *pabSuccess = NULL ) override;
+};
+
+int OGRGeometryFactoryBatchCT::Transform( int nCount,
+                                          double *x, double *y, double *z )
+{
+    const size_t nStart = m_nCursor;
+    TransformEx( nCount, x, y, z, NULL );
+    if( !m_bReplay )
+        return TRUE;
+    for( size_t i = nStart; i < m_nCursor; i++ )
+    {
+        if( !m_abSuccess[i] )
+            return FALSE;
+    }
+    return TRUE;
+}
+
+int OGRGeometryFactoryBatchCT::TransformEx( int nCount,
+                                            double *x, double *y, double *z,
+                                            int *pabSuccess )
+{
+    if( !m_bReplay )
+    {
+        for( int i = 0; i < nCount; i++ )
+        {
+            m_adfX.push_back(x[i]);
+            m_adfY.push_back(y[i]);
+            m_adfZ.push_back(z ? z[i] : 0.0);
+            if( pabSuccess )
+                pabSuccess[i] = TRUE;
+        }
+        return TRUE;
+    }
+
+    for( int i = 0; i < nCount; i++ )
+    {
+        const size_t j = m_nCursor + i;
+        x[i] = m_adfX[j];
+        y[i] = m_adfY[j];
+        if( z )
+            z[i] = m_adfZ[j];
+        if( pabSuccess )
+            pabSuccess[i] = m_abSuccess[j];
+    }
+    m_nCursor += nCount;
+    return TRUE;
+}
+} // namespace
+
+/************************************************************************/
+/*                  OGRGeometryFactoryTransformPoints()                 */
+/*                                                                      */
+/*      Transform an array of points. PROJ fails the whole array for    */
+/*      some errors on a single point, in which case the original       */
+/*      coordinates are restored and both halves of the array are       */
+/*      transformed separately, down to individual points, so that      */
+/*      only the points in error are reported as failed.                */
+/************************************************************************/
+
+static void OGRGeometryFactoryTransformPoints(
+    OGRCoordinateTransformation* poCT, int nCount,
+    double* padfX, double* padfY, double* padfZ, int* pabSuccess,
+    const double* padfXOri, const double* padfYOri, const double* padfZOri )
+{
+    if( poCT->TransformEx( nCount, padfX, padfY, padfZ, pabSuccess ) )
+        return;
+    if( nCount == 1 )
+    {
+        pabSuccess[0] = FALSE;
+        return;
+    }
+
+    memcpy( padfX, padfXOri, nCount * sizeof(double) );
+    memcpy( padfY, padfYOri, nCount * sizeof(double) );
+    memcpy( padfZ, padfZOri, nCount * sizeof(double) );
+    const int nHalf = nCount / 2;
+    OGRGeometryFactoryTransformPoints( poCT, nHalf,
+                                       padfX, padfY, padfZ, pabSuccess,
+                                       padfXOri, padfYOri, padfZOri );
+    OGRGeometryFactoryTransformPoints( poCT, nCount - nHalf,
+                                       padfX + nHalf, padfY + nHalf,
+                                       padfZ + nHalf, pabSuccess + nHalf,
+                                       padfXOri + nHalf, padfYOri + nHalf,
+                                       padfZOri + nHalf );
+}
+
+/************************************************************************/
+/*                OGRGeometryFactoryTransformGeometries()               */
+/*                                                                      */
+/*      Transform a run of geometries with a single transformation     */
+/*      object, in batches of about N_MAX_POINTS_PER_BATCH points.      */
+/*      Geometries are first walked with a recording pseudo            */
+/*      transformation to collect their coordinates, which are then     */
+/*      transformed with one TransformEx() call, and written back by    */
+/*      walking the geometries again with a replaying pseudo            */
+/*      transformation. Going through OGRGeometry::transform() for      */
+/*      both walks guarantees that the points are visited, and the      */
+/*      results applied, exactly as a direct transform() would do.      */
+/*      Geometries for which at least one point fails are left          */
+/*      untouched.                                                      */
+/*                                                                      */
+/*      poTargetSRS is the SRS to assign to the transformed geometries, */
+/*      so that geometries transformed with clones of the user          */
+/*      transformation get the same SRS object as with the original.    */
+/************************************************************************/
+
+static const size_t N_MAX_POINTS_PER_BATCH = 100000;
+
+static void OGRGeometryFactoryTransformGeometries(
+    OGRGeometry** papoGeoms, int nGeomCount,
+    OGRCoordinateTransformation* poCT, OGRSpatialReference* poTargetSRS,
+    int* pabSuccess )
+{
+    OGRGeometryFactoryBatchCT oBatchCT(poCT, poTargetSRS);
+    const size_t nNoGeom = static_cast<size_t>(-1);
+    std::vector<size_t> anStart;
+    std::vector<size_t> anEnd;
+    std::vector<double> adfXOri;
+    std::vector<double> adfYOri;
+    std::vector<double> adfZOri;
+    int iFirst = 0;
+
+    for( int i = 0; i < nGeomCount; i++ )
+    {
+        OGRGeometry* poGeom = papoGeoms[i];
+        pabSuccess[i] = FALSE;
+
+        // Recording pass: coordinates are unchanged, but transform()
+        // assigns the target SRS, so restore the original one.
+        const size_t nStart = oBatchCT.m_adfX.size();
+        size_t nEnd = nStart;
+        if( poGeom != NULL )
+        {
+            OGRSpatialReference* poSRS = poGeom->getSpatialReference();
+            if( poSRS )
+                poSRS->Reference();
+            if( poGeom->transform(&oBatchCT) == OGRERR_NONE )
+            {
+                nEnd = oBatchCT.m_adfX.size();
+            }
+            else
+            {
+                oBatchCT.m_adfX.resize(nStart);
+                oBatchCT.m_adfY.resize(nStart);
+                oBatchCT.m_adfZ.resize(nStart);
+                poGeom = NULL;
+            }
+            papoGeoms[i]->assignSpatialReference(poSRS);
+            if( poSRS )
+                poSRS->Release();
+        }
+        anStart.push_back(poGeom ? nStart : nNoGeom);
+        anEnd.push_back(nEnd);
+
+        if( oBatchCT.m_adfX.size() < N_MAX_POINTS_PER_BATCH &&
+            i + 1 < nGeomCount )
+            continue;
+
+        // Bulk transformation. Errors are not emitted, since failing
+        // geometries are left to the caller, which will typically
+        // transform them individually to get the appropriate error.
+        const size_t nPoints = oBatchCT.m_adfX.size();
+        oBatchCT.m_abSuccess.resize(nPoints);
+        if( nPoints > 0 )
+        {
+            adfXOri.assign(oBatchCT.m_adfX.begin(), oBatchCT.m_adfX.end());
+            adfYOri.assign(oBatchCT.m_adfY.begin(), oBatchCT.m_adfY.end());
+            adfZOri.assign(oBatchCT.m_adfZ.begin(), oBatchCT.m_adfZ.end());
+            const bool bBackupEmitErrors = poCT->GetEmitErrors();
+            poCT->SetEmitErrors(false);
+            OGRGeometryFactoryTransformPoints( poCT, static_cast<int>(nPoints),
+                                               &oBatchCT.m_adfX[0],
+                                               &oBatchCT.m_adfY[0],
+                                               &oBatchCT.m_adfZ[0],
+                                               &oBatchCT.m_abSuccess[0],
+                                               &adfXOri[0], &adfYOri[0],
+                                               &adfZOri[0] );
+            poCT->SetEmitErrors(bBackupEmitErrors);
+        }
+
+        // Replay pass.
+        oBatchCT.m_bReplay = true;
+        for( int j = iFirst; j <= i; j++ )
+        {
+            const size_t nGeomStart = anStart[j - iFirst];
+            const size_t nGeomEnd = anEnd[j - iFirst];
+            if( nGeomStart == nNoGeom )
+                continue;
+            bool bAllSucceeded = true;
+            for( size_t k = nGeomStart; k < nGeomEnd; k++ )
+            {
+                if( !oBatchCT.m_abSuccess[k] )
+                {
+                    bAllSucceeded = false;
+                    break;
+                }
+            }
+            if( !bAllSucceeded )
+                continue;
+            oBatchCT.m_nCursor = nGeomStart;
+            pabSuccess[j] =
+                papoGeoms[j]->transform(&oBatchCT) == OGRERR_NONE;
+        }
+
+        oBatchCT.m_bReplay = false;
+        oBatchCT.m_nCursor = 0;
+        oBatchCT.m_adfX.resize(0);
+        oBatchCT.m_adfY.resize(0);
+        oBatchCT.m_adfZ.resize(0);
+        anStart.resize(0);
+        anEnd.resize(0);
+        iFirst = i + 1;
+    }
+}
+
+/************************************************************************/
+/*               OGRGeometryFactoryTransformGeometriesJob()             */
+/************************************************************************/
+
+typedef struct
+{
+    OGRGeometry**                papoGeoms;
+    int                          nGeomCount;
+    OGRCoordinateTransformation* poCT;
+    OGRSpatialReference*         poTargetSRS;
+    int*                         pabSuccess;
+} OGRTransformGeometriesJob;
+
+static void OGRGeometryFactoryTransformGeometriesJob( void* pData )
+{
+    OGRTransformGeometriesJob* psJob =
+        static_cast<OGRTransformGeometriesJob*>(pData);
+    OGRGeometryFactoryTransformGeometries(psJob->papoGeoms, psJob->nGeomCount,
+                                          psJob->poCT, psJob->poTargetSRS,
+                                          psJob->pabSuccess);
+}
+
+/************************************************************************/
+/*                         transformGeometries()                        */
+/************************************************************************/
+
+/**
+ * \brief Transform an array of geometries in bulk.
+ *
+ * This is equivalent to calling OGRGeometry::transform() on each geometry,
+ * but the coordinates of many geometries are gathered into large arrays
+ * so that the coordinate transformation is invoked a few times on many
+ * points, rather than once per geometry part on a few points. This is
+ * much faster when transforming lots of small geometries.
+ *
+ * If the NUM_THREADS option (or the GDAL_NUM_THREADS configuration option)
+ * is greater than one, and the transformation can be cloned with
+ * OGRCoordinateTransformation::Clone(), the geometries are split among
+ * several threads, each one working with its own clone of the
+ * transformation (and thus its own PROJ context).
+ *
+ * Unlike OGRGeometry::transform(), a geometry for which at least one point
+ * fails to transform is left untouched, and no error is emitted for it.
+ * Callers that need the exact behaviour and error reporting of
+ * OGRGeometry::transform() in that case (for example with
+ * OGR_ENABLE_PARTIAL_REPROJECTION) can call it on those geometries.
+ *
+ * @param papoGeoms array of nGeomCount geometries, transformed in place.
+ * NULL entries are ignored.
+ * @param nGeomCount number of geometries.
+ * @param poCT coordinate transformation object.
+ * @param pabSuccess array of nGeomCount values, set to TRUE for each
+ * geometry that has been transformed, FALSE otherwise. May be NULL.
+ * @param papszOptions NULL terminated list of options, or NULL. Currently
+ * NUM_THREADS=number_of_threads/ALL_CPUS is supported.
+ *
+ * @return TRUE if all non-NULL geometries have been transformed.
+ * @since GDAL 2.3
+ */
+int OGRGeometryFactory::transformGeometries(
+    OGRGeometry** papoGeoms, int nGeomCount,
+    OGRCoordinateTransformation *poCT,
+    int* pabSuccess,
+    const char* const* papszOptions )
+{
+    if( nGeomCount <= 0 )
+        return TRUE;
+
+    std::vector<int> abSuccess(nGeomCount);
+    OGRSpatialReference* poTargetSRS = poCT->GetTargetCS();
+
+    int nThreads = std::min(nGeomCount,
+        CPLParseNumThreads(CSLFetchNameValue(papszOptions, "NUM_THREADS"),
+                           CPLGetNumThreadsOption("GDAL_NUM_THREADS", 1)));
+
+    std::vector<OGRCoordinateTransformation*> apoCT;
+    CPLWorkerThreadPool oPool;
+    if( nThreads > 1 )
+    {
+        for( int i = 0; i < nThreads; i++ )
+        {
+            OGRCoordinateTransformation* poClone = poCT->Clone();
+            if( poClone == NULL )
+                break;
+            apoCT.push_back(poClone);
+        }
+        if( static_cast<int>(apoCT.size()) != nThreads ||
+            !oPool.Setup(nThreads, NULL, NULL) )
+        {
+            nThreads = 1;
+        }
+    }
+
+    if( nThreads > 1 )
+    {
+        std::vector<OGRTransformGeometriesJob> asJobs(nThreads);
+        std::vector<void*> apJobs;
+        for( int iJob = 0; iJob < nThreads; iJob++ )
+        {
+            const int nStart = static_cast<int>(
+                static_cast<GIntBig>(nGeomCount) * iJob / nThreads);
+            const int nEnd = static_cast<int>(
+                static_cast<GIntBig>(nGeomCount) * (iJob + 1) / nThreads);
+            OGRTransformGeometriesJob& sJob = asJobs[iJob];
+            sJob.papoGeoms = papoGeoms + nStart;
+            sJob.nGeomCount = nEnd - nStart;
+            sJob.poCT = apoCT[iJob];
+            sJob.poTargetSRS = poTargetSRS;
+            sJob.pabSuccess = &abSuccess[nStart];
+            apJobs.push_back(&sJob);
+        }
+        oPool.SubmitJobs(OGRGeometryFactoryTransformGeometriesJob, apJobs);
+        oPool.WaitCompletion();
+    }
+    else
+    {
+        OGRGeometryFactoryTransformGeometries(papoGeoms, nGeomCount, poCT,
+                                              poTargetSRS, &abSuccess[0]);
+    }
+
+    for( size_t i = 0; i < apoCT.size(); i++ )
+        OGRCoordinateTransformation::DestroyCT(apoCT[i]);
+
+    int bRet = TRUE;
+    for( int i = 0; i < nGeomCount; i++ )
+    {
+        if( papoGeoms[i] != NULL && !abSuccess[i] )
+            bRet = FALSE;
+        if( pabSuccess )
+            pabSuccess[i] = abSuccess[i];
+    }
+    return bRet;
+}
+
 /************************************************************************/
 /*                       OGRGF_GetDefaultStepSize()                     */
 /************************************************************************/
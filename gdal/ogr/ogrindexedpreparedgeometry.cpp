@@ -0,0 +1,653 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  OGRIndexedPreparedGeometry: geometry prepared for repeated
+ *           intersects tests without GEOS.
+ * Author:   agent, <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "ogr_p.h"
+
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_packed_rtree.h"
+#include "ogr_core.h"
+#include "ogr_geometry.h"
+
+CPL_CVSID("$Id$");
+
+/*
+ * Two geometries intersect if their linework touches somewhere, or if a
+ * connected part of one is entirely inside the area of the other. So the
+ * segments of the prepared geometry are indexed in a packed R-tree, and
+ * the segments of the other geometry are searched in it. If none touches,
+ * one vertex of each part of a geometry is tested for inclusion in the
+ * polygons of the other one. Points are handled as degenerate segments.
+ *
+ * As with GEOS, polygons are assumed to be valid, and curves are tested
+ * through their linear approximation.
+ */
+
+/************************************************************************/
+/*                    OGRIndexedPreparedGeometry::Private               */
+/************************************************************************/
+
+struct OGRIndexedPreparedGeometry::Private
+{
+    bool                bIsEnvelope;
+    OGREnvelope         sEnvelope;
+
+    // Segments of the linework as (x1, y1, x2, y2) quadruplets, and
+    // whether each of them belongs to a polygon ring.
+    std::vector<double> adfSegments;
+    std::vector<GByte>  abyIsRingSegment;
+    bool                bHasArea;
+    CPLPackedRTree     *hSegmentTree;
+
+    // First vertex of each ring, line string and point, as (x, y) pairs.
+    std::vector<double> adfPartVertices;
+    CPLPackedRTree     *hPartVertexTree;
+
+    Private() : bIsEnvelope(false), bHasArea(false), hSegmentTree(NULL),
+                hPartVertexTree(NULL) {}
+};
+
+/************************************************************************/
+/*                          OGRIPGParts                                 */
+/************************************************************************/
+
+// Components of a geometry, once its collections are flattened.
+typedef struct
+{
+    std::vector<const OGRSimpleCurve*> apoCurves;    // Lines and rings.
+    std::vector<bool>                  abIsRing;
+    std::vector<const OGRPoint*>       apoPoints;
+    std::vector<const OGRPolygon*>     apoPolygons;
+} OGRIPGParts;
+
+/************************************************************************/
+/*                       OGRIPGCollectParts()                           */
+/*                                                                      */
+/*      Return false for geometry types that are not handled.           */
+/************************************************************************/
+
+static bool OGRIPGCollectParts( const OGRGeometry* poGeom,
+                                OGRIPGParts& sParts )
+{
+    switch( wkbFlatten(poGeom->getGeometryType()) )
+    {
+        case wkbPoint:
+        {
+            if( !poGeom->IsEmpty() )
+                sParts.apoPoints.push_back(
+                    static_cast<const OGRPoint*>(poGeom));
+            return true;
+        }
+
+        case wkbLineString:
+        {
+            sParts.apoCurves.push_back(
+                static_cast<const OGRSimpleCurve*>(poGeom));
+            sParts.abIsRing.push_back(false);
+            return true;
+        }
+
+        case wkbPolygon:
+        case wkbTriangle:
+        {
+            const OGRPolygon* poPoly = static_cast<const OGRPolygon*>(poGeom);
+            if( poPoly->IsEmpty() )
+                return true;
+            sParts.apoPolygons.push_back(poPoly);
+            sParts.apoCurves.push_back(poPoly->getExteriorRing());
+            sParts.abIsRing.push_back(true);
+            for( int i = 0; i < poPoly->getNumInteriorRings(); i++ )
+            {
+                sParts.apoCurves.push_back(poPoly->getInteriorRing(i));
+                sParts.abIsRing.push_back(true);
+            }
+            return true;
+        }
+
+        case wkbMultiPoint:
+        case wkbMultiLineString:
+        case wkbMultiPolygon:
+        case wkbGeometryCollection:
+        {
+            const OGRGeometryCollection* poGC =
+                static_cast<const OGRGeometryCollection*>(poGeom);
+            for( int i = 0; i < poGC->getNumGeometries(); i++ )
+            {
+                if( !OGRIPGCollectParts(poGC->getGeometryRef(i), sParts) )
+                    return false;
+            }
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+/************************************************************************/
+/*                         OGRIPGGetSegments()                          */
+/*                                                                      */
+/*      Append the segments of lines, rings and points of a geometry    */
+/*      as (x1, y1, x2, y2) quadruplets, and optionally whether each    */
+/*      of them belongs to a polygon ring.                              */
+/************************************************************************/
+
+static void OGRIPGGetSegments( const OGRIPGParts& sParts,
+                               std::vector<double>& adfSegments,
+                               std::vector<GByte>* pabyIsRingSegment = NULL )
+{
+    for( size_t i = 0; i < sParts.apoCurves.size(); i++ )
+    {
+        const OGRSimpleCurve* poCurve = sParts.apoCurves[i];
+        const int nPoints = poCurve->getNumPoints();
+        if( nPoints == 1 )
+        {
+            adfSegments.push_back(poCurve->getX(0));
+            adfSegments.push_back(poCurve->getY(0));
+            adfSegments.push_back(poCurve->getX(0));
+            adfSegments.push_back(poCurve->getY(0));
+        }
+        for( int j = 0; j + 1 < nPoints; j++ )
+        {
+            adfSegments.push_back(poCurve->getX(j));
+            adfSegments.push_back(poCurve->getY(j));
+            adfSegments.push_back(poCurve->getX(j+1));
+            adfSegments.push_back(poCurve->getY(j+1));
+        }
+        if( pabyIsRingSegment != NULL )
+            pabyIsRingSegment->resize(adfSegments.size() / 4,
+                                      sParts.abIsRing[i] ? 1 : 0);
+    }
+    for( size_t i = 0; i < sParts.apoPoints.size(); i++ )
+    {
+        const OGRPoint* poPoint = sParts.apoPoints[i];
+        adfSegments.push_back(poPoint->getX());
+        adfSegments.push_back(poPoint->getY());
+        adfSegments.push_back(poPoint->getX());
+        adfSegments.push_back(poPoint->getY());
+    }
+    if( pabyIsRingSegment != NULL )
+        pabyIsRingSegment->resize(adfSegments.size() / 4, 0);
+}
+
+/************************************************************************/
+/*                       OGRIPGGetPartVertices()                        */
+/************************************************************************/
+
+static void OGRIPGGetPartVertices( const OGRIPGParts& sParts,
+                                   std::vector<double>& adfVertices )
+{
+    for( size_t i = 0; i < sParts.apoCurves.size(); i++ )
+    {
+        const OGRSimpleCurve* poCurve = sParts.apoCurves[i];
+        if( poCurve->getNumPoints() > 0 )
+        {
+            adfVertices.push_back(poCurve->getX(0));
+            adfVertices.push_back(poCurve->getY(0));
+        }
+    }
+    for( size_t i = 0; i < sParts.apoPoints.size(); i++ )
+    {
+        adfVertices.push_back(sParts.apoPoints[i]->getX());
+        adfVertices.push_back(sParts.apoPoints[i]->getY());
+    }
+}
+
+/************************************************************************/
+/*                       OGRIPGSegmentToRect()                          */
+/************************************************************************/
+
+static void OGRIPGSegmentToRect( const double* padfSegment,
+                                 CPLRectObj* psRect )
+{
+    psRect->minx = std::min(padfSegment[0], padfSegment[2]);
+    psRect->miny = std::min(padfSegment[1], padfSegment[3]);
+    psRect->maxx = std::max(padfSegment[0], padfSegment[2]);
+    psRect->maxy = std::max(padfSegment[1], padfSegment[3]);
+}
+
+/************************************************************************/
+/*                         OGRIPGOrientation()                          */
+/************************************************************************/
+
+static inline double OGRIPGOrientation( double dfAX, double dfAY,
+                                        double dfBX, double dfBY,
+                                        double dfCX, double dfCY )
+{
+    return (dfBX - dfAX) * (dfCY - dfAY) - (dfBY - dfAY) * (dfCX - dfAX);
+}
+
+/************************************************************************/
+/*                      OGRIPGInSegmentEnvelope()                       */
+/************************************************************************/
+
+static inline bool OGRIPGInSegmentEnvelope( const double* padfSeg,
+                                            double dfX, double dfY )
+{
+    return std::min(padfSeg[0], padfSeg[2]) <= dfX &&
+           dfX <= std::max(padfSeg[0], padfSeg[2]) &&
+           std::min(padfSeg[1], padfSeg[3]) <= dfY &&
+           dfY <= std::max(padfSeg[1], padfSeg[3]);
+}
+
+/************************************************************************/
+/*                      OGRIPGSegmentsIntersect()                       */
+/*                                                                      */
+/*      Whether two closed segments, possibly degenerated to a point,   */
+/*      have at least one point in common.                              */
+/************************************************************************/
+
+static bool OGRIPGSegmentsIntersect( const double* padfA,
+                                     const double* padfB )
+{
+    const double dfD1 = OGRIPGOrientation(padfB[0], padfB[1],
+                                          padfB[2], padfB[3],
+                                          padfA[0], padfA[1]);
+    const double dfD2 = OGRIPGOrientation(padfB[0], padfB[1],
+                                          padfB[2], padfB[3],
+                                          padfA[2], padfA[3]);
+    const double dfD3 = OGRIPGOrientation(padfA[0], padfA[1],
+                                          padfA[2], padfA[3],
+                                          padfB[0], padfB[1]);
+    const double dfD4 = OGRIPGOrientation(padfA[0], padfA[1],
+                                          padfA[2], padfA[3],
+                                          padfB[2], padfB[3]);
+
+    if( ((dfD1 > 0 && dfD2 < 0) || (dfD1 < 0 && dfD2 > 0)) &&
+        ((dfD3 > 0 && dfD4 < 0) || (dfD3 < 0 && dfD4 > 0)) )
+        return true;
+
+    // Touching or collinear cases.
+    return (dfD1 == 0 && OGRIPGInSegmentEnvelope(padfB, padfA[0], padfA[1])) ||
+           (dfD2 == 0 && OGRIPGInSegmentEnvelope(padfB, padfA[2], padfA[3])) ||
+           (dfD3 == 0 && OGRIPGInSegmentEnvelope(padfA, padfB[0], padfB[1])) ||
+           (dfD4 == 0 && OGRIPGInSegmentEnvelope(padfA, padfB[2], padfB[3]));
+}
+
+/************************************************************************/
+/*                      OGRIPGSegmentCrossesRay()                       */
+/*                                                                      */
+/*      Whether a segment crosses the half-line going from a point      */
+/*      towards positive X, for even-odd point in polygon tests.        */
+/************************************************************************/
+
+static inline bool OGRIPGSegmentCrossesRay( double dfX1, double dfY1,
+                                            double dfX2, double dfY2,
+                                            double dfX, double dfY )
+{
+    if( (dfY1 > dfY) == (dfY2 > dfY) )
+        return false;
+    return dfX < dfX1 + (dfY - dfY1) * (dfX2 - dfX1) / (dfY2 - dfY1);
+}
+
+/************************************************************************/
+/*                       OGRIPGPointInPolygon()                         */
+/************************************************************************/
+
+static bool OGRIPGPointInPolygon( const OGRPolygon* poPoly,
+                                  double dfX, double dfY )
+{
+    bool bInside = false;
+    for( int iRing = -1; iRing < poPoly->getNumInteriorRings(); iRing++ )
+    {
+        const OGRLinearRing* poRing = iRing < 0 ?
+            poPoly->getExteriorRing() : poPoly->getInteriorRing(iRing);
+        const int nPoints = poRing->getNumPoints();
+        for( int i = 0; i + 1 < nPoints; i++ )
+        {
+            if( OGRIPGSegmentCrossesRay(poRing->getX(i), poRing->getY(i),
+                                        poRing->getX(i+1), poRing->getY(i+1),
+                                        dfX, dfY) )
+                bInside = !bInside;
+        }
+    }
+    return bInside;
+}
+
+/************************************************************************/
+/*                    OGRIndexedPreparedGeometry()                      */
+/************************************************************************/
+
+OGRIndexedPreparedGeometry::OGRIndexedPreparedGeometry() :
+    m_poPrivate(new Private())
+{}
+
+/************************************************************************/
+/*                   ~OGRIndexedPreparedGeometry()                      */
+/************************************************************************/
+
+OGRIndexedPreparedGeometry::~OGRIndexedPreparedGeometry()
+{
+    if( m_poPrivate->hSegmentTree )
+        CPLPackedRTreeDestroy(m_poPrivate->hSegmentTree);
+    if( m_poPrivate->hPartVertexTree )
+        CPLPackedRTreeDestroy(m_poPrivate->hPartVertexTree);
+    delete m_poPrivate;
+}
+
+/************************************************************************/
+/*                              Create()                                */
+/************************************************************************/
+
+/**
+ * Prepare a geometry for Intersects() tests.
+ *
+ * @param poGeom geometry to prepare. It is not referenced by the
+ *               returned object.
+ * @param bGeomIsEnvelope whether the geometry is known to be an axis
+ *                        aligned rectangle, in which case only its
+ *                        envelope is used.
+ * @return a new object, or NULL if the geometry is empty or of a type
+ *         that is not handled.
+ */
+
+OGRIndexedPreparedGeometry *
+OGRIndexedPreparedGeometry::Create( const OGRGeometry* poGeom,
+                                    bool bGeomIsEnvelope )
+{
+    if( poGeom == NULL || poGeom->IsEmpty() )
+        return NULL;
+
+    if( bGeomIsEnvelope )
+    {
+        OGRIndexedPreparedGeometry* poRet = new OGRIndexedPreparedGeometry();
+        poRet->m_poPrivate->bIsEnvelope = true;
+        poGeom->getEnvelope(&poRet->m_poPrivate->sEnvelope);
+        return poRet;
+    }
+
+    OGRGeometry* poLinearGeom = NULL;
+    if( poGeom->hasCurveGeometry() )
+    {
+        poLinearGeom = poGeom->getLinearGeometry();
+        if( poLinearGeom == NULL )
+            return NULL;
+        poGeom = poLinearGeom;
+    }
+
+    OGRIPGParts sParts;
+    // The even-odd rule on all rings only works if polygons do not
+    // overlap, as in a valid multipolygon.
+    if( !OGRIPGCollectParts(poGeom, sParts) ||
+        (sParts.apoPolygons.size() > 1 &&
+         wkbFlatten(poGeom->getGeometryType()) != wkbMultiPolygon) )
+    {
+        delete poLinearGeom;
+        return NULL;
+    }
+
+    OGRIndexedPreparedGeometry* poRet = new OGRIndexedPreparedGeometry();
+    Private* psPriv = poRet->m_poPrivate;
+    poGeom->getEnvelope(&psPriv->sEnvelope);
+    psPriv->bHasArea = !sParts.apoPolygons.empty();
+
+    OGRIPGGetSegments(sParts, psPriv->adfSegments,
+                      &psPriv->abyIsRingSegment);
+    OGRIPGGetPartVertices(sParts, psPriv->adfPartVertices);
+    delete poLinearGeom;
+
+    const size_t nSegments = psPriv->adfSegments.size() / 4;
+    if( nSegments == 0 ||
+        nSegments > static_cast<size_t>(INT_MAX) ||
+        psPriv->adfPartVertices.size() / 2 >
+                                        static_cast<size_t>(INT_MAX) )
+    {
+        delete poRet;
+        return NULL;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Index segments and part vertices.                               */
+/* -------------------------------------------------------------------- */
+    std::vector<CPLRectObj> asRects(nSegments);
+    for( size_t i = 0; i < nSegments; i++ )
+        OGRIPGSegmentToRect(&psPriv->adfSegments[4 * i], &asRects[i]);
+    psPriv->hSegmentTree = CPLPackedRTreeCreate(
+        &asRects[0], static_cast<int>(nSegments),
+        CPL_PACKED_RTREE_DEFAULT_NODE_SIZE);
+
+    const size_t nPartVertices = psPriv->adfPartVertices.size() / 2;
+    asRects.resize(nPartVertices);
+    for( size_t i = 0; i < nPartVertices; i++ )
+    {
+        asRects[i].minx = psPriv->adfPartVertices[2 * i];
+        asRects[i].maxx = psPriv->adfPartVertices[2 * i];
+        asRects[i].miny = psPriv->adfPartVertices[2 * i + 1];
+        asRects[i].maxy = psPriv->adfPartVertices[2 * i + 1];
+    }
+    psPriv->hPartVertexTree = CPLPackedRTreeCreate(
+        &asRects[0], static_cast<int>(nPartVertices),
+        CPL_PACKED_RTREE_DEFAULT_NODE_SIZE);
+
+    if( psPriv->hSegmentTree == NULL || psPriv->hPartVertexTree == NULL )
+    {
+        delete poRet;
+        return NULL;
+    }
+
+    return poRet;
+}
+
+/************************************************************************/
+/*                             Intersects()                             */
+/************************************************************************/
+
+/**
+ * Test whether the prepared geometry intersects another geometry.
+ *
+ * This is an exact test, with the same semantics as
+ * OGRGeometry::Intersects() with GEOS: geometries that only touch
+ * intersect.
+ *
+ * @param poOtherGeom the other geometry.
+ * @return TRUE or FALSE, or -1 if the other geometry is of a type that is
+ *         not handled.
+ */
+
+int OGRIndexedPreparedGeometry::Intersects(
+                                    const OGRGeometry* poOtherGeom ) const
+{
+    if( poOtherGeom == NULL || poOtherGeom->IsEmpty() )
+        return FALSE;
+
+    OGRGeometry* poLinearGeom = NULL;
+    if( poOtherGeom->hasCurveGeometry() )
+    {
+        poLinearGeom = poOtherGeom->getLinearGeometry();
+        if( poLinearGeom == NULL )
+            return -1;
+        poOtherGeom = poLinearGeom;
+    }
+
+    OGRIPGParts sParts;
+    if( !OGRIPGCollectParts(poOtherGeom, sParts) )
+    {
+        delete poLinearGeom;
+        return -1;
+    }
+
+    OGREnvelope sOtherEnvelope;
+    poOtherGeom->getEnvelope(&sOtherEnvelope);
+
+    std::vector<double> adfSegments;
+    OGRIPGGetSegments(sParts, adfSegments);
+    const size_t nSegments = adfSegments.size() / 4;
+
+    const Private* psPriv = m_poPrivate;
+    bool bIntersects = false;
+
+    if( psPriv->bIsEnvelope )
+    {
+/* -------------------------------------------------------------------- */
+/*      Rectangle: test the segments against its edges, and one         */
+/*      corner for inclusion in the polygons of the other geometry.     */
+/* -------------------------------------------------------------------- */
+        const OGREnvelope& sEnv = psPriv->sEnvelope;
+        const double adfEdges[16] = {
+            sEnv.MinX, sEnv.MinY, sEnv.MaxX, sEnv.MinY,
+            sEnv.MaxX, sEnv.MinY, sEnv.MaxX, sEnv.MaxY,
+            sEnv.MaxX, sEnv.MaxY, sEnv.MinX, sEnv.MaxY,
+            sEnv.MinX, sEnv.MaxY, sEnv.MinX, sEnv.MinY };
+        for( size_t i = 0; !bIntersects && i < nSegments; i++ )
+        {
+            const double* padfSeg = &adfSegments[4 * i];
+            if( (padfSeg[0] >= sEnv.MinX && padfSeg[0] <= sEnv.MaxX &&
+                 padfSeg[1] >= sEnv.MinY && padfSeg[1] <= sEnv.MaxY) ||
+                (padfSeg[2] >= sEnv.MinX && padfSeg[2] <= sEnv.MaxX &&
+                 padfSeg[3] >= sEnv.MinY && padfSeg[3] <= sEnv.MaxY) )
+            {
+                bIntersects = true;
+                break;
+            }
+            for( int j = 0; j < 4; j++ )
+            {
+                if( OGRIPGSegmentsIntersect(padfSeg, adfEdges + 4 * j) )
+                {
+                    bIntersects = true;
+                    break;
+                }
+            }
+        }
+        for( size_t i = 0; !bIntersects && i < sParts.apoPolygons.size();
+             i++ )
+        {
+            bIntersects = OGRIPGPointInPolygon(sParts.apoPolygons[i],
+                                               sEnv.MinX, sEnv.MinY);
+        }
+
+        delete poLinearGeom;
+        return bIntersects ? TRUE : FALSE;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Search the prepared segments that may touch the segments of     */
+/*      the other geometry.                                             */
+/* -------------------------------------------------------------------- */
+    if( nSegments > 0 && nSegments <= static_cast<size_t>(INT_MAX) )
+    {
+        std::vector<CPLRectObj> asAois(nSegments);
+        for( size_t i = 0; i < nSegments; i++ )
+            OGRIPGSegmentToRect(&adfSegments[4 * i], &asAois[i]);
+        int* panFeatures = NULL;
+        int* panOffsets = NULL;
+        if( CPLPackedRTreeSearchBatch(psPriv->hSegmentTree, &asAois[0],
+                                      static_cast<int>(nSegments),
+                                      &panFeatures, &panOffsets) )
+        {
+            for( size_t i = 0; !bIntersects && i < nSegments; i++ )
+            {
+                for( int j = panOffsets[i]; j < panOffsets[i+1]; j++ )
+                {
+                    if( OGRIPGSegmentsIntersect(
+                            &adfSegments[4 * i],
+                            &psPriv->adfSegments[4 * panFeatures[j]]) )
+                    {
+                        bIntersects = true;
+                        break;
+                    }
+                }
+            }
+        }
+        CPLFree(panFeatures);
+        CPLFree(panOffsets);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Otherwise, each part of the other geometry is either inside     */
+/*      or outside the prepared polygons.                               */
+/* -------------------------------------------------------------------- */
+    if( !bIntersects && psPriv->bHasArea )
+    {
+        std::vector<double> adfVertices;
+        OGRIPGGetPartVertices(sParts, adfVertices);
+        for( size_t i = 0; !bIntersects && i < adfVertices.size() / 2; i++ )
+        {
+            const double dfX = adfVertices[2 * i];
+            const double dfY = adfVertices[2 * i + 1];
+            CPLRectObj sRay;
+            sRay.minx = dfX;
+            sRay.miny = dfY;
+            sRay.maxx = std::max(dfX, psPriv->sEnvelope.MaxX);
+            sRay.maxy = dfY;
+            int nCount = 0;
+            int* panSegments = CPLPackedRTreeSearch(psPriv->hSegmentTree,
+                                                    &sRay, &nCount);
+            bool bInside = false;
+            for( int j = 0; j < nCount; j++ )
+            {
+                if( !psPriv->abyIsRingSegment[panSegments[j]] )
+                    continue;
+                const double* padfSeg =
+                    &psPriv->adfSegments[4 * panSegments[j]];
+                if( OGRIPGSegmentCrossesRay(padfSeg[0], padfSeg[1],
+                                            padfSeg[2], padfSeg[3],
+                                            dfX, dfY) )
+                    bInside = !bInside;
+            }
+            CPLFree(panSegments);
+            bIntersects = bInside;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      And each part of the prepared geometry is either inside or      */
+/*      outside the polygons of the other geometry.                     */
+/* -------------------------------------------------------------------- */
+    if( !bIntersects && !sParts.apoPolygons.empty() )
+    {
+        CPLRectObj sAoi;
+        sAoi.minx = sOtherEnvelope.MinX;
+        sAoi.miny = sOtherEnvelope.MinY;
+        sAoi.maxx = sOtherEnvelope.MaxX;
+        sAoi.maxy = sOtherEnvelope.MaxY;
+        int nCount = 0;
+        int* panVertices = CPLPackedRTreeSearch(psPriv->hPartVertexTree,
+                                                &sAoi, &nCount);
+        for( int j = 0; !bIntersects && j < nCount; j++ )
+        {
+            const double dfX = psPriv->adfPartVertices[2 * panVertices[j]];
+            const double dfY =
+                psPriv->adfPartVertices[2 * panVertices[j] + 1];
+            for( size_t i = 0; !bIntersects && i < sParts.apoPolygons.size();
+                 i++ )
+            {
+                bIntersects = OGRIPGPointInPolygon(sParts.apoPolygons[i],
+                                                   dfX, dfY);
+            }
+        }
+        CPLFree(panVertices);
+    }
+
+    delete poLinearGeom;
+    return bIntersects ? TRUE : FALSE;
+}
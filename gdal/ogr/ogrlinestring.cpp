@@ -43,6 +43,7 @@ CPL_CVSID("$Id$");
 /** Constructor */
 OGRSimpleCurve::OGRSimpleCurve() :
     nPointCount(0),
+    m_nPointCapacity(0),
     paoPoints(NULL),
     padfZ(NULL),
     padfM(NULL)
@@ -64,6 +65,7 @@ OGRSimpleCurve::OGRSimpleCurve() :
 OGRSimpleCurve::OGRSimpleCurve( const OGRSimpleCurve& other ) :
     OGRCurve(other),
     nPointCount(0),
+    m_nPointCapacity(0),
     paoPoints(NULL),
     padfZ(NULL),
     padfM(NULL)
@@ -224,12 +226,12 @@ void OGRSimpleCurve::Make3D()
 {
     if( padfZ == NULL )
     {
-        if( nPointCount == 0 )
+        if( m_nPointCapacity == 0 )
             padfZ =
                 static_cast<double *>(VSI_CALLOC_VERBOSE(sizeof(double), 1));
         else
             padfZ = static_cast<double *>(VSI_CALLOC_VERBOSE(
-                sizeof(double), nPointCount));
+                sizeof(double), m_nPointCapacity));
         if( padfZ == NULL )
         {
             flags &= ~OGR_G_3D;
@@ -265,12 +267,12 @@ void OGRSimpleCurve::AddM()
 {
     if( padfM == NULL )
     {
-        if( nPointCount == 0 )
+        if( m_nPointCapacity == 0 )
             padfM =
                 static_cast<double *>(VSI_CALLOC_VERBOSE(sizeof(double), 1));
         else
             padfM = static_cast<double *>(
-                VSI_CALLOC_VERBOSE(sizeof(double), nPointCount));
+                VSI_CALLOC_VERBOSE(sizeof(double), m_nPointCapacity));
         if( padfM == NULL )
         {
             flags &= ~OGR_G_MEASURED;
@@ -436,51 +438,65 @@ void OGRSimpleCurve::setNumPoints( int nNewPointCount, int bZeroizeNewContent )
         padfM = NULL;
 
         nPointCount = 0;
+        m_nPointCapacity = 0;
         return;
     }
 
-    if( nNewPointCount > nPointCount )
+    if( nNewPointCount > m_nPointCapacity )
     {
+        // Grow the arrays geometrically so that adding points one at a
+        // time does not cause a reallocation for each of them.
+        int nNewCapacity = nNewPointCount;
+        if( nPointCount > 0 && m_nPointCapacity <= INT_MAX / 3 )
+        {
+            nNewCapacity =
+                std::max(nNewCapacity, m_nPointCapacity + m_nPointCapacity / 2);
+        }
+
         OGRRawPoint* paoNewPoints = static_cast<OGRRawPoint *>(
             VSI_REALLOC_VERBOSE(paoPoints,
-                                sizeof(OGRRawPoint) * nNewPointCount));
+                                sizeof(OGRRawPoint) * nNewCapacity));
         if( paoNewPoints == NULL )
         {
             return;
         }
         paoPoints = paoNewPoints;
 
-        if( bZeroizeNewContent )
-            memset( paoPoints + nPointCount,
-                0, sizeof(OGRRawPoint) * (nNewPointCount - nPointCount) );
-
         if( flags & OGR_G_3D )
         {
             double* padfNewZ = static_cast<double *>(
-                VSI_REALLOC_VERBOSE(padfZ, sizeof(double) * nNewPointCount));
+                VSI_REALLOC_VERBOSE(padfZ, sizeof(double) * nNewCapacity));
             if( padfNewZ == NULL )
             {
                 return;
             }
             padfZ = padfNewZ;
-            if( bZeroizeNewContent )
-                memset( padfZ + nPointCount, 0,
-                    sizeof(double) * (nNewPointCount - nPointCount) );
         }
 
         if( flags & OGR_G_MEASURED )
         {
             double* padfNewM = static_cast<double *>(
-                VSI_REALLOC_VERBOSE(padfM, sizeof(double) * nNewPointCount));
+                VSI_REALLOC_VERBOSE(padfM, sizeof(double) * nNewCapacity));
             if( padfNewM == NULL )
             {
                 return;
             }
             padfM = padfNewM;
-            if( bZeroizeNewContent )
-                memset( padfM + nPointCount, 0,
-                    sizeof(double) * (nNewPointCount - nPointCount) );
         }
+
+        m_nPointCapacity = nNewCapacity;
+    }
+
+    if( nNewPointCount > nPointCount && bZeroizeNewContent )
+    {
+        memset( paoPoints + nPointCount,
+            0, sizeof(OGRRawPoint) * (nNewPointCount - nPointCount) );
+        if( flags & OGR_G_3D )
+            memset( padfZ + nPointCount, 0,
+                sizeof(double) * (nNewPointCount - nPointCount) );
+        if( flags & OGR_G_MEASURED )
+            memset( padfM + nPointCount, 0,
+                sizeof(double) * (nNewPointCount - nPointCount) );
     }
 
     nPointCount = nNewPointCount;
@@ -1704,6 +1720,7 @@ OGRErr OGRSimpleCurve::importFromWkt( char ** ppszInput )
     pszInput = OGRWktReadPointsM( pszInput, &paoPoints, &padfZ, &padfM,
                                   &flagsFromInput,
                                   &nMaxPoints, &nPointCount );
+    m_nPointCapacity = nMaxPoints;
     if( pszInput == NULL )
         return OGRERR_CORRUPT_DATA;
 
@@ -2545,6 +2562,7 @@ void OGRSimpleCurve::segmentize( double dfMaxLength )
     CPLFree(paoPoints);
     paoPoints = paoNewPoints;
     nPointCount = nNewPointCount;
+    m_nPointCapacity = nNewPointCount;
 
     if( nCoordinateDimension == 3 )
     {
@@ -2761,12 +2779,19 @@ OGRLineString* OGRLineString::TransferMembersAndDestroy(
     poDst->set3D(poSrc->Is3D());
     poDst->setMeasured(poSrc->IsMeasured());
     poDst->assignSpatialReference(poSrc->getSpatialReference());
+    CPLFree(poDst->paoPoints);
+    CPLFree(poDst->padfZ);
+    CPLFree(poDst->padfM);
     poDst->nPointCount = poSrc->nPointCount;
+    poDst->m_nPointCapacity = poSrc->m_nPointCapacity;
     poDst->paoPoints = poSrc->paoPoints;
     poDst->padfZ = poSrc->padfZ;
+    poDst->padfM = poSrc->padfM;
     poSrc->nPointCount = 0;
+    poSrc->m_nPointCapacity = 0;
     poSrc->paoPoints = NULL;
     poSrc->padfZ = NULL;
+    poSrc->padfM = NULL;
     delete poSrc;
     return poDst;
 }
@@ -33,6 +33,8 @@
 
 #include "ogrsf_frmts.h"
 
+#include <vector>
+
 typedef enum
 {
     OGR_CSV_GEOM_NONE,
@@ -120,8 +122,14 @@ class OGRCSVLayer : public OGRLayer
 
     bool                bEmptyStringNull;
 
+    std::vector<char>   abyLineBuffer;
+    std::vector<char *> apszLineTokens;
     char              **GetNextLineTokens();
 
+    bool                bCheckedForMatchingFIDs;
+    GIntBig            *panMatchingFIDs;
+    int                 iMatchingFID;
+
     static bool         Matches( const char *pszFieldName,
                                  char **papszPossibleNames );
 
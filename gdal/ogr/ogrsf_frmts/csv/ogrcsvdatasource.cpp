@@ -798,6 +798,16 @@ bool OGRCSVDataSource::OpenTable( const char *pszFilename,
     poCSVLayer->BuildFeatureDefn(pszNfdcRunwaysGeomField,
                                  pszGeonamesGeomFieldPrefix,
                                  papszOpenOptionsIn);
+
+    // Attribute indexes (CREATE INDEX) are supported for files opened in
+    // read-only mode, and holding a single layer.
+    if( !bUpdate && pszNfdcRunwaysGeomField == NULL &&
+        pszGeonamesGeomFieldPrefix == NULL &&
+        !EQUAL(pszFilename, "/vsistdin/") )
+    {
+        poCSVLayer->InitializeIndexSupport(pszFilename);
+    }
+
     OGRLayer *poLayer = poCSVLayer;
     if( bUpdate )
     {
@@ -41,6 +41,7 @@
 #endif
 #include <algorithm>
 #include <limits>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -60,99 +61,15 @@
 CPL_CVSID("$Id$");
 
 /************************************************************************/
-/*                            CSVSplitLine()                            */
+/*                          OGRCSVReadLineL()                           */
 /*                                                                      */
-/*      Tokenize a CSV line into fields in the form of a string         */
-/*      list.  This is used instead of the CPLTokenizeString()          */
-/*      because it provides correct CSV escaping and quoting            */
-/*      semantics.                                                      */
+/*      Read one CSV record into abyWorkLine, appending new lines as    */
+/*      long as the number of double quotes is odd.  Returns a          */
+/*      pointer to the modifiable record, or NULL at end of file.       */
 /************************************************************************/
 
-static char **CSVSplitLine( const char *pszString, char chDelimiter,
-                            bool bKeepLeadingAndClosingQuotes,
-                            bool bMergeDelimiter )
-
-{
-    char **papszRetList = NULL;
-
-    char *pszToken = static_cast<char *>(CPLCalloc(10, 1));
-    int nTokenMax = 10;
-
-    while( pszString != NULL && *pszString != '\0' )
-    {
-        bool bInString = false;
-
-        int nTokenLen = 0;
-
-        // Try to find the next delimiter, marking end of token.
-        for( ; *pszString != '\0'; pszString++ )
-        {
-            // End if this is a delimiter skip it and break.
-            if( !bInString && *pszString == chDelimiter )
-            {
-                pszString++;
-                if( bMergeDelimiter )
-                {
-                    while( *pszString == chDelimiter )
-                        pszString++;
-                }
-                break;
-            }
-
-            if( *pszString == '"' )
-            {
-                if( !bInString || pszString[1] != '"' )
-                {
-                    bInString = !bInString;
-                    if( !bKeepLeadingAndClosingQuotes )
-                        continue;
-                }
-                else  // Doubled quotes in string resolve to one quote.
-                {
-                    pszString++;
-                }
-            }
-
-            if( nTokenLen >= nTokenMax - 2 )
-            {
-                nTokenMax = nTokenMax * 2 + 10;
-                pszToken = static_cast<char *>(CPLRealloc(pszToken, nTokenMax));
-            }
-
-            pszToken[nTokenLen] = *pszString;
-            nTokenLen++;
-        }
-
-        pszToken[nTokenLen] = '\0';
-        papszRetList = CSLAddString(papszRetList, pszToken);
-
-        // If the last token is an empty token, then we have to catch
-        // it now, otherwise we won't reenter the loop and it will be lost.
-        if( *pszString == '\0' && *(pszString - 1) == chDelimiter )
-        {
-            papszRetList = CSLAddString(papszRetList, "");
-        }
-    }
-
-    if( papszRetList == NULL )
-        papszRetList = static_cast<char **>(CPLCalloc(sizeof(char *), 1));
-
-    CPLFree(pszToken);
-
-    return papszRetList;
-}
-
-/************************************************************************/
-/*                      OGRCSVReadParseLineL()                          */
-/*                                                                      */
-/*      Read one line, and return split into fields.  The return        */
-/*      result is a stringlist, in the sense of the CSL functions.      */
-/************************************************************************/
-
-char **OGRCSVReadParseLineL( VSILFILE *fp, char chDelimiter,
-                             bool bDontHonourStrings,
-                             bool bKeepLeadingAndClosingQuotes,
-                             bool bMergeDelimiter )
+static char *OGRCSVReadLineL( VSILFILE *fp, bool bHonourStrings,
+                              std::vector<char> &abyWorkLine )
 
 {
     const char *pszLine = CPLReadLineL(fp);
@@ -164,31 +81,25 @@ char **OGRCSVReadParseLineL( VSILFILE *fp, char chDelimiter,
     if( pabyData[0] == 0xEF && pabyData[1] == 0xBB && pabyData[2] == 0xBF )
         pszLine += 3;
 
-    // Special fix to read NdfcFacilities.xls with un-balanced double quotes.
-    if( chDelimiter == '\t' && bDontHonourStrings )
-    {
-        return CSLTokenizeStringComplex(pszLine, "\t", FALSE, TRUE);
-    }
+    size_t nWorkLineLength = strlen(pszLine);
+    abyWorkLine.resize(nWorkLineLength + 1);
+    memcpy(&abyWorkLine[0], pszLine, nWorkLineLength + 1);
 
     // If there are no quotes, then this is the simple case.
-    // Parse, and return tokens.
-    if( strchr(pszLine,'\"') == NULL )
-        return CSVSplitLine(pszLine, chDelimiter, bKeepLeadingAndClosingQuotes,
-                            bMergeDelimiter);
+    if( !bHonourStrings ||
+        memchr(pszLine, '\"', nWorkLineLength) == NULL )
+        return &abyWorkLine[0];
 
     // We must now count the quotes in our working string, and as
     // long as it is odd, keep adding new lines.
-    char *pszWorkLine = CPLStrdup(pszLine);
-
-    int i = 0;
+    size_t i = 0;
     int nCount = 0;
-    size_t nWorkLineLength = strlen(pszWorkLine);
 
     while( true )
     {
-        for( ; pszWorkLine[i] != '\0'; i++ )
+        for( ; i < nWorkLineLength; i++ )
         {
-            if( pszWorkLine[i] == '\"' )
+            if( abyWorkLine[i] == '\"' )
                 nCount++;
         }
 
@@ -201,26 +112,96 @@ char **OGRCSVReadParseLineL( VSILFILE *fp, char chDelimiter,
 
         const size_t nLineLen = strlen(pszLine);
 
-        char *pszWorkLineTmp = static_cast<char *>(
-            VSI_REALLOC_VERBOSE(pszWorkLine, nWorkLineLength + nLineLen + 2));
-        if( pszWorkLineTmp == NULL )
+        try
+        {
+            abyWorkLine.resize(nWorkLineLength + nLineLen + 2);
+        }
+        catch( const std::bad_alloc& )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate " CPL_FRMT_GUIB " bytes",
+                     static_cast<GUIntBig>(nWorkLineLength + nLineLen + 2));
             break;
-        pszWorkLine = pszWorkLineTmp;
+        }
 
         // The '\n' gets lost in CPLReadLine().
-        strcat(pszWorkLine + nWorkLineLength, "\n");
-        strcat(pszWorkLine + nWorkLineLength, pszLine);
+        abyWorkLine[nWorkLineLength] = '\n';
+        memcpy(&abyWorkLine[nWorkLineLength + 1], pszLine, nLineLen + 1);
 
         nWorkLineLength += nLineLen + 1;
     }
 
-    char **papszReturn =
-        CSVSplitLine(pszWorkLine, chDelimiter, bKeepLeadingAndClosingQuotes,
-                     bMergeDelimiter);
+    return &abyWorkLine[0];
+}
 
-    CPLFree(pszWorkLine);
+/************************************************************************/
+/*                       OGRCSVSplitLineInPlace()                       */
+/*                                                                      */
+/*      Split a record read by OGRCSVReadLineL() into fields, in        */
+/*      place.  apszTokens is NULL terminated.                          */
+/************************************************************************/
+
+static int OGRCSVSplitLineInPlace( char *pszLine, char chDelimiter,
+                                   bool bDontHonourStrings,
+                                   bool bKeepLeadingAndClosingQuotes,
+                                   bool bMergeDelimiter,
+                                   std::vector<char *> &apszTokens )
+
+{
+    // Special fix to read NdfcFacilities.xls with un-balanced double quotes.
+    if( chDelimiter == '\t' && bDontHonourStrings )
+    {
+        apszTokens.clear();
+        while( *pszLine != '\0' || !apszTokens.empty() )
+        {
+            apszTokens.push_back(pszLine);
+            char *pszTab = strchr(pszLine, '\t');
+            if( pszTab == NULL )
+                break;
+            *pszTab = '\0';
+            pszLine = pszTab + 1;
+        }
+        const int nTokens = static_cast<int>(apszTokens.size());
+        apszTokens.push_back(NULL);
+        return nTokens;
+    }
 
-    return papszReturn;
+    return CSVSplitLineInPlace(pszLine, chDelimiter,
+                               bKeepLeadingAndClosingQuotes, bMergeDelimiter,
+                               apszTokens);
+}
+
+/************************************************************************/
+/*                      OGRCSVReadParseLineL()                          */
+/*                                                                      */
+/*      Read one line, and return split into fields.  The return        */
+/*      result is a stringlist, in the sense of the CSL functions.      */
+/************************************************************************/
+
+char **OGRCSVReadParseLineL( VSILFILE *fp, char chDelimiter,
+                             bool bDontHonourStrings,
+                             bool bKeepLeadingAndClosingQuotes,
+                             bool bMergeDelimiter )
+
+{
+    std::vector<char> abyWorkLine;
+    char *pszLine = OGRCSVReadLineL(
+        fp, !(chDelimiter == '\t' && bDontHonourStrings), abyWorkLine);
+    if( pszLine == NULL )
+        return NULL;
+
+    std::vector<char *> apszTokens;
+    const int nTokens =
+        OGRCSVSplitLineInPlace(pszLine, chDelimiter, bDontHonourStrings,
+                               bKeepLeadingAndClosingQuotes, bMergeDelimiter,
+                               apszTokens);
+
+    char **papszRetList =
+        static_cast<char **>(CPLCalloc(sizeof(char *), nTokens + 1));
+    for( int i = 0; i < nTokens; i++ )
+        papszRetList[i] = CPLStrdup(apszTokens[i]);
+
+    return papszRetList;
 }
 
 /************************************************************************/
@@ -264,7 +245,10 @@ OGRCSVLayer::OGRCSVLayer( const char *pszLayerNameIn,
     bKeepSourceColumns(false),
     bKeepGeomColumns(true),
     bMergeDelimiter(false),
-    bEmptyStringNull(false)
+    bEmptyStringNull(false),
+    bCheckedForMatchingFIDs(false),
+    panMatchingFIDs(NULL),
+    iMatchingFID(0)
 {
     poFeatureDefn = new OGRFeatureDefn(pszLayerNameIn);
     SetDescription(poFeatureDefn->GetName());
@@ -1323,6 +1307,7 @@ OGRCSVLayer::~OGRCSVLayer()
         WriteHeader();
 
     CPLFree(panGeomFieldIndex);
+    CPLFree(panMatchingFIDs);
 
     poFeatureDefn->Release();
     CPLFree(pszFilename);
@@ -1348,27 +1333,34 @@ void OGRCSVLayer::ResetReading()
     bNeedRewindBeforeRead = false;
 
     nNextFID = 1;
+
+    CPLFree(panMatchingFIDs);
+    panMatchingFIDs = NULL;
+    iMatchingFID = 0;
+    bCheckedForMatchingFIDs = false;
 }
 
 /************************************************************************/
 /*                        GetNextLineTokens()                           */
 /************************************************************************/
 
+// The returned list points into abyLineBuffer and must not be freed. It is
+// only valid until the next call.
 char **OGRCSVLayer::GetNextLineTokens()
 {
     while( true )
     {
         // Read the CSV record.
-        char **papszTokens = OGRCSVReadParseLineL(
-            fpCSV, chDelimiter, bDontHonourStrings, false, bMergeDelimiter);
-
-        if( papszTokens == NULL )
+        char *pszLine = OGRCSVReadLineL(
+            fpCSV, !(chDelimiter == '\t' && bDontHonourStrings),
+            abyLineBuffer);
+        if( pszLine == NULL )
             return NULL;
 
-        if( papszTokens[0] != NULL )
-            return papszTokens;
-
-        CSLDestroy(papszTokens);
+        if( OGRCSVSplitLineInPlace(pszLine, chDelimiter, bDontHonourStrings,
+                                   false, bMergeDelimiter,
+                                   apszLineTokens) > 0 )
+            return &apszLineTokens[0];
     }
 }
 
@@ -1384,10 +1376,8 @@ OGRFeature *OGRCSVLayer::GetFeature(GIntBig nFID)
         ResetReading();
     while( nNextFID < nFID )
     {
-        char **papszTokens = GetNextLineTokens();
-        if( papszTokens == NULL )
+        if( GetNextLineTokens() == NULL )
             return NULL;
-        CSLDestroy(papszTokens);
         nNextFID++;
     }
     return GetNextUnfilteredFeature();
@@ -1721,8 +1711,6 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
         }
     }
 
-    CSLDestroy(papszTokens);
-
     // Translate the record id.
     poFeature->SetFID(nNextFID++);
 
@@ -1741,10 +1729,39 @@ OGRFeature *OGRCSVLayer::GetNextFeature()
     if( bNeedRewindBeforeRead )
         ResetReading();
 
+    // Use attribute indexes, if any, to only build the features of the
+    // records that may match the attribute filter.
+    if( !bCheckedForMatchingFIDs && nNextFID == 1 )
+    {
+        bCheckedForMatchingFIDs = true;
+        if( m_poAttrQuery != NULL && m_poAttrIndex != NULL )
+        {
+            panMatchingFIDs =
+                m_poAttrQuery->EvaluateAgainstIndices(this, NULL);
+            iMatchingFID = 0;
+        }
+    }
+
     // Read features till we find one that satisfies our current
     // spatial criteria.
     while( true )
     {
+        if( panMatchingFIDs != NULL )
+        {
+            const GIntBig nFID = panMatchingFIDs[iMatchingFID];
+            if( nFID == OGRNullFID )
+                return NULL;
+            iMatchingFID++;
+            if( nFID < nNextFID )
+                continue;
+            while( nNextFID < nFID )
+            {
+                if( GetNextLineTokens() == NULL )
+                    return NULL;
+                nNextFID++;
+            }
+        }
+
         OGRFeature *poFeature = GetNextUnfilteredFeature();
         if( poFeature == NULL )
             return NULL;
@@ -2505,13 +2522,10 @@ GIntBig OGRCSVLayer::GetFeatureCount( int bForce )
         nTotalFeatures = 0;
         while( true )
         {
-            char **papszTokens = GetNextLineTokens();
-            if( papszTokens == NULL )
+            if( GetNextLineTokens() == NULL )
                 break;
 
             nTotalFeatures++;
-
-            CSLDestroy(papszTokens);
         }
     }
 
@@ -59,6 +59,59 @@ OGRLayerAttrIndex::~OGRLayerAttrIndex()
     pszIndexPath = NULL;
 }
 
+/************************************************************************/
+/*                         InvalidateIndexes()                          */
+/*                                                                      */
+/*      Called by drivers when the layer content has been modified      */
+/*      in a way the indexes do not keep track of.  The default         */
+/*      implementation does nothing.                                    */
+/************************************************************************/
+
+void OGRLayerAttrIndex::InvalidateIndexes() {}
+
+/************************************************************************/
+/*                         ClearLayerFilters()                          */
+/*                                                                      */
+/*      Remove the attribute and spatial filters installed on the       */
+/*      layer, so that all its features can be indexed.  The saved      */
+/*      state must be given back to RestoreLayerFilters().              */
+/************************************************************************/
+
+void OGRLayerAttrIndex::ClearLayerFilters( char **ppszAttrQuery,
+                                           OGRGeometry **ppoFilterGeom,
+                                           int *piGeomField )
+
+{
+    *ppszAttrQuery = poLayer->m_pszAttrQueryString ?
+        CPLStrdup(poLayer->m_pszAttrQueryString) : NULL;
+    *ppoFilterGeom = poLayer->m_poFilterGeom != NULL ?
+        poLayer->m_poFilterGeom->clone() : NULL;
+    *piGeomField = poLayer->m_iGeomFieldFilter;
+
+    if( *ppszAttrQuery != NULL )
+        poLayer->SetAttributeFilter(NULL);
+    if( *ppoFilterGeom != NULL )
+        poLayer->SetSpatialFilter(*piGeomField, NULL);
+}
+
+/************************************************************************/
+/*                        RestoreLayerFilters()                         */
+/************************************************************************/
+
+void OGRLayerAttrIndex::RestoreLayerFilters( char *pszAttrQuery,
+                                             OGRGeometry *poFilterGeom,
+                                             int iGeomField )
+
+{
+    if( pszAttrQuery != NULL )
+        poLayer->SetAttributeFilter(pszAttrQuery);
+    if( poFilterGeom != NULL )
+        poLayer->SetSpatialFilter(iGeomField, poFilterGeom);
+
+    CPLFree(pszAttrQuery);
+    delete poFilterGeom;
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                             OGRAttrIndex                             */
@@ -77,4 +130,46 @@ OGRAttrIndex::OGRAttrIndex() {}
 
 OGRAttrIndex::~OGRAttrIndex() {}
 
+/************************************************************************/
+/*                        SupportsRangeQueries()                        */
+/*                                                                      */
+/*      Whether GetRangeMatches() and GetPrefixMatches() are            */
+/*      implemented.  They are not by default.                          */
+/************************************************************************/
+
+int OGRAttrIndex::SupportsRangeQueries()
+
+{
+    return FALSE;
+}
+
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/************************************************************************/
+
+GIntBig *OGRAttrIndex::GetRangeMatches( const OGRField * /* psMin */,
+                                        int /* bMinIncluded */,
+                                        const OGRField * /* psMax */,
+                                        int /* bMaxIncluded */,
+                                        GIntBig * /* panFIDList */,
+                                        int * /* nFIDCount */,
+                                        int * /* nLength */ )
+
+{
+    return NULL;
+}
+
+/************************************************************************/
+/*                          GetPrefixMatches()                          */
+/************************************************************************/
+
+GIntBig *OGRAttrIndex::GetPrefixMatches( const char * /* pszPrefix */,
+                                         GIntBig * /* panFIDList */,
+                                         int * /* nFIDCount */,
+                                         int * /* nLength */ )
+
+{
+    return NULL;
+}
+
 //! @endcond
@@ -0,0 +1,1735 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Implements a generic persistent B+-tree attribute index, stored
+ *           in a .oix file next to the indexed data file.
+ * Author:   agent, <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "ogr_attrind.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+#include "ogr_core.h"
+#include "ogr_feature.h"
+
+CPL_CVSID("$Id$");
+
+/************************************************************************/
+/*                            .oix layout                               */
+/*                                                                      */
+/*      The file is made of fixed size pages.  Page 0 is the header:    */
+/*                                                                      */
+/*        8 bytes   "OGRBTIDX"                                          */
+/*        uint32    version                                             */
+/*        uint32    page size                                           */
+/*        uint64    size of the data file when the index was built      */
+/*        int64     modification time of the data file                  */
+/*        string    base name of the data file                          */
+/*        uint32    number of indexes                                   */
+/*        then, for each index:                                         */
+/*          string  field name                                          */
+/*          uint32  OGRFieldType of the field                           */
+/*          uint32  key type, uint32 key size                           */
+/*          uint64  first page, uint64 page count                       */
+/*          uint32  depth, uint64 number of entries                     */
+/*                                                                      */
+/*      Integers are little endian, strings are a uint16 length         */
+/*      followed by the bytes.                                          */
+/*                                                                      */
+/*      Each index is a bulk loaded B+-tree occupying a contiguous      */
+/*      range of pages: the leaves come first, then each level of       */
+/*      internal nodes, the root being the last page.  Page numbers     */
+/*      stored in the tree are relative to its first page, so that a    */
+/*      tree can be moved within the file by a plain copy.  A tree      */
+/*      page starts with a 16 byte header (uint8 type, 3 bytes          */
+/*      padding, uint32 count, uint64 next leaf) followed by entries    */
+/*      made of a key and of a uint64 value: the FID in leaves, the     */
+/*      child page in internal nodes.                                   */
+/*                                                                      */
+/*      Keys are encoded so that comparing them with memcmp() gives     */
+/*      the ordering used by the OGR SQL evaluator: big endian integers */
+/*      with the sign bit flipped, doubles with their sign bit flipped  */
+/*      (all bits if negative), lower-cased zero-padded strings         */
+/*      truncated to the key size.  FIDs in leaves are encoded as       */
+/*      integer keys, so that (key, FID) records sort with memcmp()     */
+/*      as well.                                                        */
+/************************************************************************/
+
+static const char   OIX_SIGNATURE[] = "OGRBTIDX";
+static const int    OIX_SIGNATURE_SIZE = 8;
+static const GUInt32 OIX_VERSION = 1;
+static const int    OIX_PAGE_SIZE = 4096;
+static const int    OIX_PAGE_HEADER_SIZE = 16;
+static const int    OIX_VALUE_SIZE = 8;
+static const int    OIX_MAX_STRING_KEY_SIZE = 64;
+static const GUIntBig OIX_NO_PAGE = ~static_cast<GUIntBig>(0);
+
+static const GByte  OIX_LEAF_PAGE = 1;
+static const GByte  OIX_INTERNAL_PAGE = 2;
+
+typedef enum
+{
+    OIX_KEY_INTEGER = 1,
+    OIX_KEY_REAL = 2,
+    OIX_KEY_STRING = 3,
+    OIX_KEY_DATETIME = 4
+} OIXKeyType;
+
+/************************************************************************/
+/*                       Key and value encoding.                        */
+/************************************************************************/
+
+static void OIXEncodeInt64( GIntBig nValue, GByte *pabyOut )
+
+{
+    GUIntBig nBits =
+        static_cast<GUIntBig>(nValue) ^ (static_cast<GUIntBig>(1) << 63);
+    for( int i = 7; i >= 0; i-- )
+    {
+        pabyOut[i] = static_cast<GByte>(nBits & 0xff);
+        nBits >>= 8;
+    }
+}
+
+static GIntBig OIXDecodeInt64( const GByte *pabyIn )
+
+{
+    GUIntBig nBits = 0;
+    for( int i = 0; i < 8; i++ )
+        nBits = (nBits << 8) | pabyIn[i];
+    return static_cast<GIntBig>(nBits ^ (static_cast<GUIntBig>(1) << 63));
+}
+
+static void OIXEncodeDouble( double dfValue, GByte *pabyOut )
+
+{
+    // -0.0 and 0.0 compare equal.
+    if( dfValue == 0.0 )
+        dfValue = 0.0;
+
+    GUIntBig nBits = 0;
+    memcpy(&nBits, &dfValue, sizeof(nBits));
+    if( nBits >> 63 )
+        nBits = ~nBits;
+    else
+        nBits |= static_cast<GUIntBig>(1) << 63;
+
+    for( int i = 7; i >= 0; i-- )
+    {
+        pabyOut[i] = static_cast<GByte>(nBits & 0xff);
+        nBits >>= 8;
+    }
+}
+
+static void OIXEncodeString( const char *pszValue, int nKeySize,
+                             GByte *pabyOut )
+
+{
+    int i = 0;
+    for( ; i < nKeySize && pszValue[i] != '\0'; i++ )
+        pabyOut[i] = static_cast<GByte>(
+            tolower(static_cast<unsigned char>(pszValue[i])));
+    for( ; i < nKeySize; i++ )
+        pabyOut[i] = 0;
+}
+
+/* Maps a date to an integer with the same ordering as OGRCompareDate(),
+ * seconds being rounded to the millisecond. */
+static GIntBig OIXDateTimeToInt64( const OGRField *psField )
+
+{
+    GIntBig nValue = psField->Date.Year;
+    nValue = nValue * 13 + psField->Date.Month;
+    nValue = nValue * 32 + psField->Date.Day;
+    nValue = nValue * 24 + psField->Date.Hour;
+    nValue = nValue * 60 + psField->Date.Minute;
+    nValue = nValue * 62000 +
+        static_cast<GIntBig>(floor(psField->Date.Second * 1000.0 + 0.5));
+    return nValue;
+}
+
+static void OIXWriteUInt32( GByte *pabyOut, GUInt32 nValue )
+{
+    CPL_LSBPTR32(&nValue);
+    memcpy(pabyOut, &nValue, 4);
+}
+
+static GUInt32 OIXReadUInt32( const GByte *pabyIn )
+{
+    GUInt32 nValue = 0;
+    memcpy(&nValue, pabyIn, 4);
+    CPL_LSBPTR32(&nValue);
+    return nValue;
+}
+
+static void OIXWriteUInt64( GByte *pabyOut, GUIntBig nValue )
+{
+    CPL_LSBPTR64(&nValue);
+    memcpy(pabyOut, &nValue, 8);
+}
+
+static GUIntBig OIXReadUInt64( const GByte *pabyIn )
+{
+    GUIntBig nValue = 0;
+    memcpy(&nValue, pabyIn, 8);
+    CPL_LSBPTR64(&nValue);
+    return nValue;
+}
+
+/************************************************************************/
+/*                           OIXHeaderBuffer                            */
+/*                                                                      */
+/*      Bounds checked serialization of the header page.                */
+/************************************************************************/
+
+namespace {
+
+class OIXHeaderBuffer
+{
+    GByte      *pabyData;
+    int         nOffset;
+    bool        bOverflow;
+
+  public:
+    explicit OIXHeaderBuffer( GByte *pabyDataIn ) :
+        pabyData(pabyDataIn), nOffset(0), bOverflow(false) {}
+
+    bool        Overflow() const { return bOverflow; }
+
+    bool        Has( int nBytes )
+    {
+        if( bOverflow || nOffset + nBytes > OIX_PAGE_SIZE )
+            bOverflow = true;
+        return !bOverflow;
+    }
+
+    void        WriteBytes( const void *pData, int nBytes )
+    {
+        if( Has(nBytes) )
+        {
+            memcpy(pabyData + nOffset, pData, nBytes);
+            nOffset += nBytes;
+        }
+    }
+    void        WriteUInt32( GUInt32 nValue )
+    {
+        if( Has(4) )
+        {
+            OIXWriteUInt32(pabyData + nOffset, nValue);
+            nOffset += 4;
+        }
+    }
+    void        WriteUInt64( GUIntBig nValue )
+    {
+        if( Has(8) )
+        {
+            OIXWriteUInt64(pabyData + nOffset, nValue);
+            nOffset += 8;
+        }
+    }
+    void        WriteString( const char *pszValue )
+    {
+        const size_t nLen = strlen(pszValue);
+        if( nLen > 65535 )
+        {
+            bOverflow = true;
+            return;
+        }
+        GUInt16 nLen16 = static_cast<GUInt16>(nLen);
+        CPL_LSBPTR16(&nLen16);
+        WriteBytes(&nLen16, 2);
+        WriteBytes(pszValue, static_cast<int>(nLen));
+    }
+
+    void        ReadBytes( void *pData, int nBytes )
+    {
+        if( Has(nBytes) )
+        {
+            memcpy(pData, pabyData + nOffset, nBytes);
+            nOffset += nBytes;
+        }
+    }
+    GUInt32     ReadUInt32()
+    {
+        GUInt32 nValue = 0;
+        if( Has(4) )
+        {
+            nValue = OIXReadUInt32(pabyData + nOffset);
+            nOffset += 4;
+        }
+        return nValue;
+    }
+    GUIntBig    ReadUInt64()
+    {
+        GUIntBig nValue = 0;
+        if( Has(8) )
+        {
+            nValue = OIXReadUInt64(pabyData + nOffset);
+            nOffset += 8;
+        }
+        return nValue;
+    }
+    CPLString   ReadString()
+    {
+        GUInt16 nLen16 = 0;
+        ReadBytes(&nLen16, 2);
+        CPL_LSBPTR16(&nLen16);
+        CPLString osRet;
+        if( Has(nLen16) )
+        {
+            osRet.assign(reinterpret_cast<const char *>(pabyData + nOffset),
+                         nLen16);
+            nOffset += nLen16;
+        }
+        return osRet;
+    }
+};
+
+/************************************************************************/
+/*                          OIXRecordCompare                            */
+/*                                                                      */
+/*      Orders record offsets by the (key, FID) records they point to.  */
+/************************************************************************/
+
+class OIXRecordCompare
+{
+    const GByte *pabyRecords;
+    size_t       nRecordSize;
+
+  public:
+    OIXRecordCompare( const GByte *pabyRecordsIn, size_t nRecordSizeIn ) :
+        pabyRecords(pabyRecordsIn), nRecordSize(nRecordSizeIn) {}
+
+    bool operator()( size_t i, size_t j ) const
+    {
+        return memcmp(pabyRecords + i * nRecordSize,
+                      pabyRecords + j * nRecordSize, nRecordSize) < 0;
+    }
+};
+
+} // namespace
+
+class OGRBTreeLayerAttrIndex;
+
+/************************************************************************/
+/*                          OGRBTreeAttrIndex                           */
+/*                                                                      */
+/*      B+-tree index of one field.                                     */
+/************************************************************************/
+
+class OGRBTreeAttrIndex : public OGRAttrIndex
+{
+  public:
+    OGRBTreeLayerAttrIndex *poLIndex;
+    int          iField;
+    CPLString    osFieldName;
+    OGRFieldType eFieldType;
+    OIXKeyType   eKeyType;
+    int          nKeySize;
+
+    GUIntBig     nFirstPage;
+    GUIntBig     nPageCount;
+    int          nDepth;
+    GUIntBig     nEntryCount;
+
+    // False between CreateIndex() and IndexAllFeatures().
+    bool         bBuilt;
+
+    // (key, FID) records collected while building.
+    std::vector<GByte> abyRecords;
+
+                OGRBTreeAttrIndex( OGRBTreeLayerAttrIndex *poLIndexIn,
+                                   int iFieldIn, OGRFieldDefn *poFieldDefn );
+    virtual    ~OGRBTreeAttrIndex();
+
+    bool        EncodeKey( const OGRField *psKey, GByte *pabyKey ) const;
+    bool        EncodeFeatureKey( OGRFeature *poFeature,
+                                  GByte *pabyKey ) const;
+    GIntBig    *Search( const GByte *pabyMin, bool bMinIncluded,
+                        const GByte *pabyMax, bool bMaxIncluded,
+                        int nMaxCompareSize,
+                        GIntBig *panFIDList, int *pnFIDCount, int *pnLength );
+    OGRErr      WriteTree( VSILFILE *fp );
+
+    GIntBig     GetFirstMatch( OGRField *psKey ) override;
+    GIntBig    *GetAllMatches( OGRField *psKey ) override;
+    GIntBig    *GetAllMatches( OGRField *psKey, GIntBig* panFIDList,
+                               int* nFIDCount, int* nLength ) override;
+
+    OGRErr      AddEntry( OGRField *psKey, GIntBig nFID ) override;
+    OGRErr      RemoveEntry( OGRField *psKey, GIntBig nFID ) override;
+
+    OGRErr      Clear() override;
+
+    int         SupportsRangeQueries() override { return TRUE; }
+    GIntBig    *GetRangeMatches( const OGRField *psMin, int bMinIncluded,
+                                 const OGRField *psMax, int bMaxIncluded,
+                                 GIntBig* panFIDList, int* nFIDCount,
+                                 int* nLength ) override;
+    GIntBig    *GetPrefixMatches( const char *pszPrefix,
+                                  GIntBig* panFIDList, int* nFIDCount,
+                                  int* nLength ) override;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                        OGRBTreeLayerAttrIndex                        */
+/* ==================================================================== */
+/************************************************************************/
+
+class OGRBTreeLayerAttrIndex : public OGRLayerAttrIndex
+{
+  public:
+    CPLString   osIndexFilename;
+    VSILFILE   *fpIndex;
+
+    // The .oix file exists, but could not be used for this layer.
+    bool        bUnusableFile;
+    // The .oix file belongs to another data file, never overwrite it.
+    bool        bForeignFile;
+
+    std::vector<OGRBTreeAttrIndex *> apoIndexes;
+
+                OGRBTreeLayerAttrIndex();
+    virtual    ~OGRBTreeLayerAttrIndex();
+
+    /* base class virtual methods */
+    OGRErr      Initialize( const char *pszIndexPath, OGRLayer * ) override;
+    OGRErr      CreateIndex( int iField ) override;
+    OGRErr      DropIndex( int iField ) override;
+    OGRErr      IndexAllFeatures( int iField = -1 ) override;
+
+    OGRErr      AddToIndex( OGRFeature *poFeature, int iField = -1 ) override;
+    OGRErr      RemoveFromIndex( OGRFeature *poFeature ) override;
+
+    OGRAttrIndex *GetFieldIndex( int iField ) override;
+
+    void        InvalidateIndexes() override;
+
+    /* custom to OGRBTreeLayerAttrIndex */
+    bool        ReadHeader();
+    OGRErr      WriteHeader( VSILFILE *fp );
+    bool        ReadPage( GUIntBig nPage, GByte *pabyPage );
+    void        CloseIndexFile();
+    void        RemoveIndexFile();
+};
+
+/************************************************************************/
+/*                       OGRBTreeLayerAttrIndex()                       */
+/************************************************************************/
+
+OGRBTreeLayerAttrIndex::OGRBTreeLayerAttrIndex() :
+    fpIndex(NULL),
+    bUnusableFile(false),
+    bForeignFile(false)
+{}
+
+/************************************************************************/
+/*                      ~OGRBTreeLayerAttrIndex()                       */
+/************************************************************************/
+
+OGRBTreeLayerAttrIndex::~OGRBTreeLayerAttrIndex()
+
+{
+    CloseIndexFile();
+
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+        delete apoIndexes[i];
+}
+
+/************************************************************************/
+/*                           CloseIndexFile()                           */
+/************************************************************************/
+
+void OGRBTreeLayerAttrIndex::CloseIndexFile()
+
+{
+    if( fpIndex != NULL )
+    {
+        VSIFCloseL(fpIndex);
+        fpIndex = NULL;
+    }
+}
+
+/************************************************************************/
+/*                          RemoveIndexFile()                           */
+/************************************************************************/
+
+void OGRBTreeLayerAttrIndex::RemoveIndexFile()
+
+{
+    CloseIndexFile();
+    VSIUnlink(osIndexFilename);
+    bUnusableFile = false;
+}
+
+/************************************************************************/
+/*                             Initialize()                             */
+/*                                                                      */
+/*      pszIndexPathIn is the file holding the attributes of the        */
+/*      layer.  Its size and modification time are recorded in the      */
+/*      .oix file, so that indexes built before a modification of the   */
+/*      data file are ignored.                                          */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::Initialize( const char *pszIndexPathIn,
+                                           OGRLayer *poLayerIn )
+
+{
+    if( poLayerIn == poLayer )
+        return OGRERR_NONE;
+
+    poLayer = poLayerIn;
+    pszIndexPath = CPLStrdup( pszIndexPathIn );
+    osIndexFilename = CPLResetExtension( pszIndexPathIn, "oix" );
+
+    VSIStatBufL sStat;
+    if( VSIStatL( osIndexFilename, &sStat ) == 0 && !ReadHeader() )
+    {
+        bUnusableFile = true;
+        for( size_t i = 0; i < apoIndexes.size(); i++ )
+            delete apoIndexes[i];
+        apoIndexes.clear();
+        CloseIndexFile();
+    }
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             ReadHeader()                             */
+/************************************************************************/
+
+bool OGRBTreeLayerAttrIndex::ReadHeader()
+
+{
+    fpIndex = VSIFOpenL( osIndexFilename, "rb" );
+    if( fpIndex == NULL )
+        return false;
+
+    std::vector<GByte> abyPage(OIX_PAGE_SIZE);
+    if( VSIFReadL( &abyPage[0], 1, OIX_PAGE_SIZE, fpIndex ) !=
+            static_cast<size_t>(OIX_PAGE_SIZE) ||
+        memcmp(&abyPage[0], OIX_SIGNATURE, OIX_SIGNATURE_SIZE) != 0 )
+    {
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "%s is not a valid attribute index file.",
+                  osIndexFilename.c_str() );
+        return false;
+    }
+
+    OIXHeaderBuffer oBuffer(&abyPage[0]);
+    GByte abySignature[OIX_SIGNATURE_SIZE];
+    oBuffer.ReadBytes(abySignature, OIX_SIGNATURE_SIZE);
+    const GUInt32 nVersion = oBuffer.ReadUInt32();
+    const GUInt32 nPageSize = oBuffer.ReadUInt32();
+    if( nVersion != OIX_VERSION || nPageSize != OIX_PAGE_SIZE )
+    {
+        CPLError( CE_Warning, CPLE_NotSupported,
+                  "Unsupported version of attribute index file %s.",
+                  osIndexFilename.c_str() );
+        return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Check that the index matches the current data file.             */
+/* -------------------------------------------------------------------- */
+    const GUIntBig nDataSize = oBuffer.ReadUInt64();
+    const GIntBig nDataMTime = static_cast<GIntBig>(oBuffer.ReadUInt64());
+    const CPLString osDataFilename = oBuffer.ReadString();
+
+    if( !EQUAL(osDataFilename, CPLGetFilename(pszIndexPath)) )
+    {
+        CPLDebug( "OGR", "%s indexes %s, not %s.  Ignoring it.",
+                  osIndexFilename.c_str(), osDataFilename.c_str(),
+                  CPLGetFilename(pszIndexPath) );
+        bForeignFile = true;
+        return false;
+    }
+
+    VSIStatBufL sStat;
+    if( VSIStatL( pszIndexPath, &sStat ) != 0 ||
+        static_cast<GUIntBig>(sStat.st_size) != nDataSize ||
+        static_cast<GIntBig>(sStat.st_mtime) != nDataMTime )
+    {
+        CPLDebug( "OGR",
+                  "%s has been modified since %s was built.  Ignoring it.",
+                  pszIndexPath, osIndexFilename.c_str() );
+        return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Read the index directory.                                       */
+/* -------------------------------------------------------------------- */
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    const GUInt32 nIndexCount = oBuffer.ReadUInt32();
+
+    for( GUInt32 i = 0; i < nIndexCount && !oBuffer.Overflow(); i++ )
+    {
+        const CPLString osFieldName = oBuffer.ReadString();
+        const GUInt32 nFieldType = oBuffer.ReadUInt32();
+        const GUInt32 nKeyType = oBuffer.ReadUInt32();
+        const GUInt32 nKeySize = oBuffer.ReadUInt32();
+        const GUIntBig nFirstPage = oBuffer.ReadUInt64();
+        const GUIntBig nPageCount = oBuffer.ReadUInt64();
+        const GUInt32 nDepth = oBuffer.ReadUInt32();
+        const GUIntBig nEntryCount = oBuffer.ReadUInt64();
+        if( oBuffer.Overflow() )
+            break;
+
+        const int iField = poDefn->GetFieldIndex(osFieldName);
+        if( iField < 0 ||
+            poDefn->GetFieldDefn(iField)->GetType() !=
+                static_cast<OGRFieldType>(nFieldType) )
+        {
+            CPLDebug( "OGR",
+                      "Field %s indexed in %s does not match layer %s.  "
+                      "Ignoring the index file.",
+                      osFieldName.c_str(), osIndexFilename.c_str(),
+                      poDefn->GetName() );
+            return false;
+        }
+
+        OGRBTreeAttrIndex *poIndex =
+            new OGRBTreeAttrIndex(this, iField, poDefn->GetFieldDefn(iField));
+        apoIndexes.push_back(poIndex);
+        if( static_cast<GUInt32>(poIndex->eKeyType) != nKeyType ||
+            nKeySize < 1 || nKeySize > OIX_MAX_STRING_KEY_SIZE ||
+            nDepth > 64 || nFirstPage == 0 ||
+            (nEntryCount != 0 && (nPageCount == 0 || nDepth == 0)) )
+        {
+            CPLError( CE_Warning, CPLE_AppDefined,
+                      "Corrupted attribute index file %s.",
+                      osIndexFilename.c_str() );
+            return false;
+        }
+
+        poIndex->nKeySize = static_cast<int>(nKeySize);
+        poIndex->nFirstPage = nFirstPage;
+        poIndex->nPageCount = nPageCount;
+        poIndex->nDepth = static_cast<int>(nDepth);
+        poIndex->nEntryCount = nEntryCount;
+        poIndex->bBuilt = true;
+    }
+
+    if( oBuffer.Overflow() )
+    {
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "Corrupted attribute index file %s.",
+                  osIndexFilename.c_str() );
+        return false;
+    }
+
+    CPLDebug( "OGR", "Restored %d field indexes for layer %s from %s.",
+              static_cast<int>(apoIndexes.size()), poDefn->GetName(),
+              osIndexFilename.c_str() );
+
+    return true;
+}
+
+/************************************************************************/
+/*                            WriteHeader()                             */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::WriteHeader( VSILFILE *fp )
+
+{
+    VSIStatBufL sStat;
+    if( VSIStatL( pszIndexPath, &sStat ) != 0 )
+    {
+        CPLError( CE_Failure, CPLE_FileIO, "Cannot stat %s.", pszIndexPath );
+        return OGRERR_FAILURE;
+    }
+
+    std::vector<GByte> abyPage(OIX_PAGE_SIZE);
+    OIXHeaderBuffer oBuffer(&abyPage[0]);
+    oBuffer.WriteBytes(OIX_SIGNATURE, OIX_SIGNATURE_SIZE);
+    oBuffer.WriteUInt32(OIX_VERSION);
+    oBuffer.WriteUInt32(OIX_PAGE_SIZE);
+    oBuffer.WriteUInt64(static_cast<GUIntBig>(sStat.st_size));
+    oBuffer.WriteUInt64(static_cast<GUIntBig>(sStat.st_mtime));
+    oBuffer.WriteString(CPLGetFilename(pszIndexPath));
+
+    GUInt32 nBuiltCount = 0;
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        if( apoIndexes[i]->bBuilt )
+            nBuiltCount++;
+    }
+    oBuffer.WriteUInt32(nBuiltCount);
+
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        OGRBTreeAttrIndex *poIndex = apoIndexes[i];
+        if( !poIndex->bBuilt )
+            continue;
+        oBuffer.WriteString(poIndex->osFieldName);
+        oBuffer.WriteUInt32(static_cast<GUInt32>(poIndex->eFieldType));
+        oBuffer.WriteUInt32(static_cast<GUInt32>(poIndex->eKeyType));
+        oBuffer.WriteUInt32(static_cast<GUInt32>(poIndex->nKeySize));
+        oBuffer.WriteUInt64(poIndex->nFirstPage);
+        oBuffer.WriteUInt64(poIndex->nPageCount);
+        oBuffer.WriteUInt32(static_cast<GUInt32>(poIndex->nDepth));
+        oBuffer.WriteUInt64(poIndex->nEntryCount);
+    }
+
+    if( oBuffer.Overflow() )
+    {
+        CPLError( CE_Failure, CPLE_NotSupported,
+                  "Too many attribute indexes for %s.",
+                  osIndexFilename.c_str() );
+        return OGRERR_FAILURE;
+    }
+
+    if( VSIFSeekL( fp, 0, SEEK_SET ) != 0 ||
+        VSIFWriteL( &abyPage[0], 1, OIX_PAGE_SIZE, fp ) !=
+            static_cast<size_t>(OIX_PAGE_SIZE) )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Failed to write %s.", osIndexFilename.c_str() );
+        return OGRERR_FAILURE;
+    }
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                              ReadPage()                              */
+/************************************************************************/
+
+bool OGRBTreeLayerAttrIndex::ReadPage( GUIntBig nPage, GByte *pabyPage )
+
+{
+    if( fpIndex == NULL )
+    {
+        fpIndex = VSIFOpenL( osIndexFilename, "rb" );
+        if( fpIndex == NULL )
+        {
+            CPLError( CE_Failure, CPLE_OpenFailed,
+                      "Failed to open index file %s.",
+                      osIndexFilename.c_str() );
+            return false;
+        }
+    }
+
+    if( VSIFSeekL( fpIndex, static_cast<vsi_l_offset>(nPage) * OIX_PAGE_SIZE,
+                   SEEK_SET ) != 0 ||
+        VSIFReadL( pabyPage, 1, OIX_PAGE_SIZE, fpIndex ) !=
+            static_cast<size_t>(OIX_PAGE_SIZE) )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Failed to read page " CPL_FRMT_GUIB " of %s.",
+                  nPage, osIndexFilename.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                            CreateIndex()                             */
+/*                                                                      */
+/*      Register an index on the indicated field.  It is built and      */
+/*      saved by IndexAllFeatures().                                    */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::CreateIndex( int iField )
+
+{
+    OGRFieldDefn *poFldDefn = poLayer->GetLayerDefn()->GetFieldDefn(iField);
+
+    if( bForeignFile )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "%s is already used by the attribute indexes of another "
+                  "file.",
+                  osIndexFilename.c_str() );
+        return OGRERR_FAILURE;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Do we have this field indexed already?                          */
+/* -------------------------------------------------------------------- */
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        if( apoIndexes[i]->iField == iField )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "It seems we already have an index for field %d/%s\n"
+                      "of layer %s.",
+                      iField, poFldDefn->GetNameRef(),
+                      poLayer->GetLayerDefn()->GetName() );
+            return OGRERR_FAILURE;
+        }
+    }
+
+    switch( poFldDefn->GetType() )
+    {
+      case OFTInteger:
+      case OFTInteger64:
+      case OFTReal:
+      case OFTString:
+      case OFTDate:
+      case OFTTime:
+      case OFTDateTime:
+        break;
+
+      default:
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Indexing not support for the field type of field %s.",
+                  poFldDefn->GetNameRef() );
+        return OGRERR_FAILURE;
+    }
+
+    apoIndexes.push_back(new OGRBTreeAttrIndex(this, iField, poFldDefn));
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          IndexAllFeatures()                          */
+/*                                                                      */
+/*      Build the trees of the indexes not built yet, or of all         */
+/*      indexes if iField is -1, by sorting the keys of all             */
+/*      features, and save them.                                        */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::IndexAllFeatures( int iField )
+
+{
+    // Make sure pending changes are on disk, so that the state of the data
+    // file recorded in the header matches the indexed features.  This may
+    // invalidate the indexes already built.
+    OGRErr eErr = poLayer->SyncToDisk();
+    if( eErr != OGRERR_NONE )
+        return eErr;
+
+    std::vector<OGRBTreeAttrIndex *> apoTargets;
+    bool bRewrite = bUnusableFile;
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        if( iField == -1 || apoIndexes[i]->iField == iField )
+        {
+            apoTargets.push_back(apoIndexes[i]);
+            if( apoIndexes[i]->bBuilt )
+                bRewrite = true;
+        }
+    }
+    if( apoTargets.empty() )
+        return OGRERR_NONE;
+
+    if( bRewrite )
+    {
+        // Trees cannot be rebuilt in place: rewrite the whole file.
+        apoTargets = apoIndexes;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Collect the keys of all features, whatever the filters and      */
+/*      the ignored fields currently set on the layer.                  */
+/* -------------------------------------------------------------------- */
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    std::vector<int> abWasIgnored;
+    for( size_t i = 0; i < apoTargets.size(); i++ )
+    {
+        OGRFieldDefn *poFldDefn = poDefn->GetFieldDefn(apoTargets[i]->iField);
+        abWasIgnored.push_back(poFldDefn->IsIgnored());
+        poFldDefn->SetIgnored(FALSE);
+        apoTargets[i]->abyRecords.clear();
+    }
+
+    char *pszAttrQuery = NULL;
+    OGRGeometry *poFilterGeom = NULL;
+    int iGeomField = 0;
+    ClearLayerFilters( &pszAttrQuery, &poFilterGeom, &iGeomField );
+
+    GByte abyKey[OIX_MAX_STRING_KEY_SIZE + OIX_VALUE_SIZE];
+
+    poLayer->ResetReading();
+    OGRFeature *poFeature = NULL;
+    while( eErr == OGRERR_NONE &&
+           (poFeature = poLayer->GetNextFeature()) != NULL )
+    {
+        if( poFeature->GetFID() == OGRNullFID )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Attempt to index feature with no FID." );
+            eErr = OGRERR_FAILURE;
+        }
+
+        for( size_t i = 0; eErr == OGRERR_NONE && i < apoTargets.size();
+             i++ )
+        {
+            OGRBTreeAttrIndex *poIndex = apoTargets[i];
+            if( !poIndex->EncodeFeatureKey(poFeature, abyKey) )
+                continue;
+            OIXEncodeInt64(poFeature->GetFID(), abyKey + poIndex->nKeySize);
+            poIndex->abyRecords.insert(
+                poIndex->abyRecords.end(), abyKey,
+                abyKey + poIndex->nKeySize + OIX_VALUE_SIZE);
+        }
+
+        delete poFeature;
+    }
+
+    poLayer->ResetReading();
+    RestoreLayerFilters( pszAttrQuery, poFilterGeom, iGeomField );
+    for( size_t i = 0; i < apoTargets.size(); i++ )
+    {
+        poDefn->GetFieldDefn(apoTargets[i]->iField)->SetIgnored(
+            abWasIgnored[i]);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Write the trees after the existing ones, then the header.       */
+/* -------------------------------------------------------------------- */
+    VSILFILE *fp = NULL;
+    if( eErr == OGRERR_NONE )
+    {
+        CloseIndexFile();
+        VSIStatBufL sStat;
+        if( !bRewrite && VSIStatL( osIndexFilename, &sStat ) == 0 )
+            fp = VSIFOpenL( osIndexFilename, "rb+" );
+        else
+            fp = VSIFOpenL( osIndexFilename, "wb+" );
+        if( fp == NULL )
+        {
+            CPLError( CE_Failure, CPLE_OpenFailed,
+                      "Failed to create %s.", osIndexFilename.c_str() );
+            eErr = OGRERR_FAILURE;
+        }
+    }
+
+    if( eErr == OGRERR_NONE )
+    {
+        // Reserve the header page of a new file.
+        if( VSIFSeekL( fp, 0, SEEK_END ) != 0 )
+            eErr = OGRERR_FAILURE;
+        else if( VSIFTellL( fp ) == 0 )
+        {
+            std::vector<GByte> abyPage(OIX_PAGE_SIZE);
+            if( VSIFWriteL( &abyPage[0], 1, OIX_PAGE_SIZE, fp ) !=
+                    static_cast<size_t>(OIX_PAGE_SIZE) )
+                eErr = OGRERR_FAILURE;
+        }
+    }
+
+    for( size_t i = 0; eErr == OGRERR_NONE && i < apoTargets.size(); i++ )
+    {
+        eErr = apoTargets[i]->WriteTree( fp );
+        if( eErr == OGRERR_NONE )
+            apoTargets[i]->bBuilt = true;
+    }
+
+    for( size_t i = 0; i < apoTargets.size(); i++ )
+    {
+        std::vector<GByte> abyEmpty;
+        apoTargets[i]->abyRecords.swap(abyEmpty);
+    }
+
+    if( eErr == OGRERR_NONE )
+        eErr = WriteHeader( fp );
+
+    if( fp != NULL )
+        VSIFCloseL( fp );
+
+    if( eErr != OGRERR_NONE )
+    {
+        // Forget about the indexes that could not be built.
+        for( size_t i = 0; i < apoIndexes.size(); )
+        {
+            if( !apoIndexes[i]->bBuilt ||
+                std::find(apoTargets.begin(), apoTargets.end(),
+                          apoIndexes[i]) != apoTargets.end() )
+            {
+                delete apoIndexes[i];
+                apoIndexes.erase(apoIndexes.begin() + i);
+            }
+            else
+                i++;
+        }
+        if( bRewrite || apoIndexes.empty() )
+        {
+            for( size_t i = 0; i < apoIndexes.size(); i++ )
+                delete apoIndexes[i];
+            apoIndexes.clear();
+            RemoveIndexFile();
+        }
+        return eErr;
+    }
+
+    bUnusableFile = false;
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             DropIndex()                              */
+/*                                                                      */
+/*      The pages of the trees stored after the dropped one are moved   */
+/*      down, so that the file does not grow with successive index      */
+/*      creations and removals.                                         */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::DropIndex( int iField )
+
+{
+    OGRFieldDefn *poFldDefn = poLayer->GetLayerDefn()->GetFieldDefn(iField);
+
+    size_t iIndex = 0;
+    for( ; iIndex < apoIndexes.size(); iIndex++ )
+    {
+        if( apoIndexes[iIndex]->iField == iField )
+            break;
+    }
+
+    if( iIndex == apoIndexes.size() )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "DROP INDEX on field (%s) that doesn't have an index.",
+                  poFldDefn->GetNameRef() );
+        return OGRERR_FAILURE;
+    }
+
+    OGRBTreeAttrIndex *poDropped = apoIndexes[iIndex];
+    apoIndexes.erase(apoIndexes.begin() + iIndex);
+
+    bool bHasBuiltIndexes = false;
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        if( apoIndexes[i]->bBuilt )
+            bHasBuiltIndexes = true;
+    }
+
+    if( !poDropped->bBuilt )
+    {
+        delete poDropped;
+        return OGRERR_NONE;
+    }
+
+    if( !bHasBuiltIndexes )
+    {
+        delete poDropped;
+        RemoveIndexFile();
+        return OGRERR_NONE;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Move down the trees stored after the dropped one.               */
+/* -------------------------------------------------------------------- */
+    CloseIndexFile();
+    VSILFILE *fp = VSIFOpenL( osIndexFilename, "rb+" );
+    if( fp == NULL )
+    {
+        delete poDropped;
+        CPLError( CE_Failure, CPLE_OpenFailed,
+                  "Failed to open %s for update.", osIndexFilename.c_str() );
+        return OGRERR_FAILURE;
+    }
+
+    const GUIntBig nHoleStart = poDropped->nFirstPage;
+    const GUIntBig nHoleSize = poDropped->nPageCount;
+    delete poDropped;
+
+    OGRErr eErr = OGRERR_NONE;
+    GUIntBig nLastPage = 0;
+    std::vector<GByte> abyPage(OIX_PAGE_SIZE);
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        OGRBTreeAttrIndex *poIndex = apoIndexes[i];
+        if( !poIndex->bBuilt )
+            continue;
+        if( nHoleSize != 0 && poIndex->nFirstPage > nHoleStart )
+        {
+            for( GUIntBig iPage = 0;
+                 eErr == OGRERR_NONE && iPage < poIndex->nPageCount; iPage++ )
+            {
+                const GUIntBig nSrc = poIndex->nFirstPage + iPage;
+                const GUIntBig nDst = nSrc - nHoleSize;
+                if( VSIFSeekL( fp, static_cast<vsi_l_offset>(nSrc) *
+                                   OIX_PAGE_SIZE, SEEK_SET ) != 0 ||
+                    VSIFReadL( &abyPage[0], 1, OIX_PAGE_SIZE, fp ) !=
+                        static_cast<size_t>(OIX_PAGE_SIZE) ||
+                    VSIFSeekL( fp, static_cast<vsi_l_offset>(nDst) *
+                                   OIX_PAGE_SIZE, SEEK_SET ) != 0 ||
+                    VSIFWriteL( &abyPage[0], 1, OIX_PAGE_SIZE, fp ) !=
+                        static_cast<size_t>(OIX_PAGE_SIZE) )
+                {
+                    CPLError( CE_Failure, CPLE_FileIO,
+                              "Failed to update %s.",
+                              osIndexFilename.c_str() );
+                    eErr = OGRERR_FAILURE;
+                }
+            }
+            poIndex->nFirstPage -= nHoleSize;
+        }
+        nLastPage = std::max(nLastPage,
+                             poIndex->nFirstPage + poIndex->nPageCount);
+    }
+
+    if( eErr == OGRERR_NONE )
+        eErr = WriteHeader( fp );
+    if( eErr == OGRERR_NONE &&
+        VSIFTruncateL( fp, static_cast<vsi_l_offset>(
+                       std::max(nLastPage, static_cast<GUIntBig>(1))) *
+                       OIX_PAGE_SIZE ) != 0 )
+    {
+        eErr = OGRERR_FAILURE;
+    }
+    VSIFCloseL( fp );
+
+    if( eErr != OGRERR_NONE )
+    {
+        for( size_t i = 0; i < apoIndexes.size(); i++ )
+            delete apoIndexes[i];
+        apoIndexes.clear();
+        RemoveIndexFile();
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                         InvalidateIndexes()                          */
+/*                                                                      */
+/*      The trees are not updated by feature modifications, so we       */
+/*      remove them.  Indexes registered by CreateIndex() but not       */
+/*      built yet are kept.                                             */
+/************************************************************************/
+
+void OGRBTreeLayerAttrIndex::InvalidateIndexes()
+
+{
+    if( bForeignFile )
+        return;
+
+    bool bHasBuiltIndexes = false;
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        if( apoIndexes[i]->bBuilt )
+            bHasBuiltIndexes = true;
+    }
+    if( !bHasBuiltIndexes && !bUnusableFile )
+        return;
+
+    CPLDebug( "OGR",
+              "Layer %s modified: removing its attribute indexes from %s.",
+              poLayer->GetLayerDefn()->GetName(), osIndexFilename.c_str() );
+
+    for( size_t i = 0; i < apoIndexes.size(); )
+    {
+        if( apoIndexes[i]->bBuilt )
+        {
+            delete apoIndexes[i];
+            apoIndexes.erase(apoIndexes.begin() + i);
+        }
+        else
+            i++;
+    }
+
+    RemoveIndexFile();
+}
+
+/************************************************************************/
+/*                           GetFieldIndex()                            */
+/************************************************************************/
+
+OGRAttrIndex *OGRBTreeLayerAttrIndex::GetFieldIndex( int iField )
+
+{
+    for( size_t i = 0; i < apoIndexes.size(); i++ )
+    {
+        if( apoIndexes[i]->iField == iField && apoIndexes[i]->bBuilt )
+            return apoIndexes[i];
+    }
+
+    return NULL;
+}
+
+/************************************************************************/
+/*                             AddToIndex()                             */
+/*                                                                      */
+/*      Trees are bulk loaded by IndexAllFeatures() and are not         */
+/*      updated incrementally.                                          */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::AddToIndex( OGRFeature * /*poFeature*/,
+                                           int /*iField*/ )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                          RemoveFromIndex()                           */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::RemoveFromIndex( OGRFeature * /*poFeature*/ )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                      OGRCreateBTreeLayerIndex()                      */
+/************************************************************************/
+
+OGRLayerAttrIndex *OGRCreateBTreeLayerIndex()
+
+{
+    return new OGRBTreeLayerAttrIndex();
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          OGRBTreeAttrIndex                           */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                         OGRBTreeAttrIndex()                          */
+/************************************************************************/
+
+OGRBTreeAttrIndex::OGRBTreeAttrIndex( OGRBTreeLayerAttrIndex *poLIndexIn,
+                                      int iFieldIn,
+                                      OGRFieldDefn *poFieldDefn ) :
+    poLIndex(poLIndexIn),
+    iField(iFieldIn),
+    osFieldName(poFieldDefn->GetNameRef()),
+    eFieldType(poFieldDefn->GetType()),
+    eKeyType(OIX_KEY_INTEGER),
+    nKeySize(8),
+    nFirstPage(0),
+    nPageCount(0),
+    nDepth(0),
+    nEntryCount(0),
+    bBuilt(false)
+{
+    switch( eFieldType )
+    {
+      case OFTReal:
+        eKeyType = OIX_KEY_REAL;
+        break;
+
+      case OFTString:
+        eKeyType = OIX_KEY_STRING;
+        nKeySize = poFieldDefn->GetWidth() > 0 ?
+            std::min(poFieldDefn->GetWidth(), OIX_MAX_STRING_KEY_SIZE) :
+            OIX_MAX_STRING_KEY_SIZE;
+        break;
+
+      case OFTDate:
+      case OFTTime:
+      case OFTDateTime:
+        eKeyType = OIX_KEY_DATETIME;
+        break;
+
+      default:
+        break;
+    }
+}
+
+/************************************************************************/
+/*                         ~OGRBTreeAttrIndex()                         */
+/************************************************************************/
+
+OGRBTreeAttrIndex::~OGRBTreeAttrIndex() {}
+
+/************************************************************************/
+/*                             EncodeKey()                              */
+/*                                                                      */
+/*      Encode a value of the field type.  Returns false for values     */
+/*      that cannot match any comparison (NaN).                         */
+/************************************************************************/
+
+bool OGRBTreeAttrIndex::EncodeKey( const OGRField *psKey,
+                                   GByte *pabyKey ) const
+
+{
+    switch( eFieldType )
+    {
+      case OFTInteger:
+        OIXEncodeInt64(psKey->Integer, pabyKey);
+        return true;
+
+      case OFTInteger64:
+        OIXEncodeInt64(psKey->Integer64, pabyKey);
+        return true;
+
+      case OFTReal:
+        if( CPLIsNan(psKey->Real) )
+            return false;
+        OIXEncodeDouble(psKey->Real, pabyKey);
+        return true;
+
+      case OFTString:
+        OIXEncodeString(psKey->String, nKeySize, pabyKey);
+        return true;
+
+      case OFTDate:
+      case OFTTime:
+      case OFTDateTime:
+        OIXEncodeInt64(OIXDateTimeToInt64(psKey), pabyKey);
+        return true;
+
+      default:
+        return false;
+    }
+}
+
+/************************************************************************/
+/*                          EncodeFeatureKey()                          */
+/************************************************************************/
+
+bool OGRBTreeAttrIndex::EncodeFeatureKey( OGRFeature *poFeature,
+                                          GByte *pabyKey ) const
+
+{
+    if( !poFeature->IsFieldSetAndNotNull(iField) )
+        return false;
+
+    if( eKeyType == OIX_KEY_DATETIME )
+    {
+        // The OGR SQL evaluator compares the parsed string representation.
+        OGRField sField;
+        if( !OGRParseDate(poFeature->GetFieldAsString(iField), &sField, 0) )
+            return false;
+        OIXEncodeInt64(OIXDateTimeToInt64(&sField), pabyKey);
+        return true;
+    }
+
+    return EncodeKey(poFeature->GetRawFieldRef(iField), pabyKey);
+}
+
+/************************************************************************/
+/*                             WriteTree()                              */
+/*                                                                      */
+/*      Sort the collected records and write them as leaves, then       */
+/*      write the levels of internal nodes up to the root.              */
+/************************************************************************/
+
+OGRErr OGRBTreeAttrIndex::WriteTree( VSILFILE *fp )
+
+{
+    const size_t nRecordSize = nKeySize + OIX_VALUE_SIZE;
+    const size_t nRecords = abyRecords.size() / nRecordSize;
+    const int nCapacity = static_cast<int>(
+        (OIX_PAGE_SIZE - OIX_PAGE_HEADER_SIZE) / nRecordSize);
+
+    if( VSIFSeekL( fp, 0, SEEK_END ) != 0 )
+        return OGRERR_FAILURE;
+    nFirstPage = VSIFTellL( fp ) / OIX_PAGE_SIZE;
+    nPageCount = 0;
+    nDepth = 0;
+    nEntryCount = nRecords;
+
+    if( nRecords == 0 )
+        return OGRERR_NONE;
+
+    std::vector<size_t> anOrder(nRecords);
+    for( size_t i = 0; i < nRecords; i++ )
+        anOrder[i] = i;
+    std::sort(anOrder.begin(), anOrder.end(),
+              OIXRecordCompare(&abyRecords[0], nRecordSize));
+
+    std::vector<GByte> abyPage(OIX_PAGE_SIZE);
+    // First key and page of each node of the level being written.
+    std::vector<GByte> abyLevel;
+    std::vector<GByte> abyNextLevel;
+
+/* -------------------------------------------------------------------- */
+/*      Leaves.                                                         */
+/* -------------------------------------------------------------------- */
+    const GUIntBig nLeafCount = (nRecords + nCapacity - 1) / nCapacity;
+    for( GUIntBig iLeaf = 0; iLeaf < nLeafCount; iLeaf++ )
+    {
+        const size_t iStart = static_cast<size_t>(iLeaf * nCapacity);
+        const size_t nCount = std::min(static_cast<size_t>(nCapacity),
+                                       nRecords - iStart);
+
+        memset(&abyPage[0], 0, OIX_PAGE_SIZE);
+        abyPage[0] = OIX_LEAF_PAGE;
+        OIXWriteUInt32(&abyPage[4], static_cast<GUInt32>(nCount));
+        OIXWriteUInt64(&abyPage[8], iLeaf + 1 < nLeafCount ? iLeaf + 1 :
+                                                             OIX_NO_PAGE);
+        for( size_t i = 0; i < nCount; i++ )
+        {
+            memcpy(&abyPage[OIX_PAGE_HEADER_SIZE + i * nRecordSize],
+                   &abyRecords[anOrder[iStart + i] * nRecordSize],
+                   nRecordSize);
+        }
+
+        abyLevel.insert(abyLevel.end(), &abyPage[OIX_PAGE_HEADER_SIZE],
+                        &abyPage[OIX_PAGE_HEADER_SIZE] + nKeySize);
+        GByte abyChild[OIX_VALUE_SIZE];
+        OIXWriteUInt64(abyChild, nPageCount);
+        abyLevel.insert(abyLevel.end(), abyChild, abyChild + OIX_VALUE_SIZE);
+
+        if( VSIFWriteL( &abyPage[0], 1, OIX_PAGE_SIZE, fp ) !=
+                static_cast<size_t>(OIX_PAGE_SIZE) )
+            return OGRERR_FAILURE;
+        nPageCount++;
+    }
+    nDepth = 1;
+
+/* -------------------------------------------------------------------- */
+/*      Internal levels.                                                */
+/* -------------------------------------------------------------------- */
+    while( abyLevel.size() / nRecordSize > 1 )
+    {
+        const size_t nNodes = abyLevel.size() / nRecordSize;
+        abyNextLevel.clear();
+        for( size_t iStart = 0; iStart < nNodes; iStart += nCapacity )
+        {
+            const size_t nCount =
+                std::min(static_cast<size_t>(nCapacity), nNodes - iStart);
+
+            memset(&abyPage[0], 0, OIX_PAGE_SIZE);
+            abyPage[0] = OIX_INTERNAL_PAGE;
+            OIXWriteUInt32(&abyPage[4], static_cast<GUInt32>(nCount));
+            OIXWriteUInt64(&abyPage[8], OIX_NO_PAGE);
+            memcpy(&abyPage[OIX_PAGE_HEADER_SIZE],
+                   &abyLevel[iStart * nRecordSize], nCount * nRecordSize);
+
+            abyNextLevel.insert(abyNextLevel.end(),
+                                &abyPage[OIX_PAGE_HEADER_SIZE],
+                                &abyPage[OIX_PAGE_HEADER_SIZE] + nKeySize);
+            GByte abyChild[OIX_VALUE_SIZE];
+            OIXWriteUInt64(abyChild, nPageCount);
+            abyNextLevel.insert(abyNextLevel.end(), abyChild,
+                                abyChild + OIX_VALUE_SIZE);
+
+            if( VSIFWriteL( &abyPage[0], 1, OIX_PAGE_SIZE, fp ) !=
+                    static_cast<size_t>(OIX_PAGE_SIZE) )
+                return OGRERR_FAILURE;
+            nPageCount++;
+        }
+        abyLevel.swap(abyNextLevel);
+        nDepth++;
+    }
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                               Search()                               */
+/*                                                                      */
+/*      Append to panFIDList the FIDs of the entries whose key is       */
+/*      within [pabyMin, pabyMax] (bounds being optional).  Only the    */
+/*      first nMaxCompareSize bytes of the keys are compared to         */
+/*      pabyMax, which is used for prefix searches.  Returns NULL on    */
+/*      failure, after freeing panFIDList.                              */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::Search( const GByte *pabyMin, bool bMinIncluded,
+                                    const GByte *pabyMax, bool bMaxIncluded,
+                                    int nMaxCompareSize,
+                                    GIntBig *panFIDList, int *pnFIDCount,
+                                    int *pnLength )
+
+{
+    if( panFIDList == NULL )
+    {
+        panFIDList = static_cast<GIntBig *>(CPLMalloc(sizeof(GIntBig) * 2));
+        *pnFIDCount = 0;
+        *pnLength = 2;
+    }
+    panFIDList[*pnFIDCount] = OGRNullFID;
+
+    if( nEntryCount == 0 )
+        return panFIDList;
+
+    const int nRecordSize = nKeySize + OIX_VALUE_SIZE;
+    std::vector<GByte> abyPage(OIX_PAGE_SIZE);
+
+/* -------------------------------------------------------------------- */
+/*      Descend to the leaf holding the first candidate entry.          */
+/* -------------------------------------------------------------------- */
+    GUIntBig nPage = nPageCount - 1;
+    for( int iLevel = nDepth - 1; iLevel >= 0; iLevel-- )
+    {
+        if( nPage >= nPageCount ||
+            !poLIndex->ReadPage(nFirstPage + nPage, &abyPage[0]) )
+        {
+            CPLFree(panFIDList);
+            return NULL;
+        }
+        const int nCount = static_cast<int>(OIXReadUInt32(&abyPage[4]));
+        if( nCount < 1 || nCount > (OIX_PAGE_SIZE - OIX_PAGE_HEADER_SIZE) /
+                                   nRecordSize ||
+            abyPage[0] != (iLevel == 0 ? OIX_LEAF_PAGE : OIX_INTERNAL_PAGE) )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Corrupted attribute index file %s.",
+                      poLIndex->osIndexFilename.c_str() );
+            CPLFree(panFIDList);
+            return NULL;
+        }
+        if( iLevel == 0 )
+            break;
+
+        // Last child whose first key is strictly lower than the minimum.
+        int iChild = 0;
+        if( pabyMin != NULL )
+        {
+            int nLow = 1;
+            int nHigh = nCount;
+            while( nLow < nHigh )
+            {
+                const int nMid = (nLow + nHigh) / 2;
+                if( memcmp(&abyPage[OIX_PAGE_HEADER_SIZE + nMid * nRecordSize],
+                           pabyMin, nKeySize) < 0 )
+                    nLow = nMid + 1;
+                else
+                    nHigh = nMid;
+            }
+            iChild = nLow - 1;
+        }
+        nPage = OIXReadUInt64(
+            &abyPage[OIX_PAGE_HEADER_SIZE + iChild * nRecordSize + nKeySize]);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Scan the leaves.                                                */
+/* -------------------------------------------------------------------- */
+    while( true )
+    {
+        const int nCount = static_cast<int>(OIXReadUInt32(&abyPage[4]));
+        if( abyPage[0] != OIX_LEAF_PAGE ||
+            nCount > (OIX_PAGE_SIZE - OIX_PAGE_HEADER_SIZE) / nRecordSize )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Corrupted attribute index file %s.",
+                      poLIndex->osIndexFilename.c_str() );
+            CPLFree(panFIDList);
+            return NULL;
+        }
+
+        for( int i = 0; i < nCount; i++ )
+        {
+            const GByte *pabyEntry =
+                &abyPage[OIX_PAGE_HEADER_SIZE + i * nRecordSize];
+            if( pabyMin != NULL )
+            {
+                const int nCmp = memcmp(pabyEntry, pabyMin, nKeySize);
+                if( nCmp < 0 || (nCmp == 0 && !bMinIncluded) )
+                    continue;
+            }
+            if( pabyMax != NULL )
+            {
+                const int nCmp = memcmp(pabyEntry, pabyMax, nMaxCompareSize);
+                if( nCmp > 0 || (nCmp == 0 && !bMaxIncluded) )
+                {
+                    panFIDList[*pnFIDCount] = OGRNullFID;
+                    return panFIDList;
+                }
+            }
+
+            if( *pnFIDCount >= *pnLength - 1 )
+            {
+                if( *pnLength > INT_MAX / 2 - 10 )
+                {
+                    CPLError( CE_Failure, CPLE_OutOfMemory,
+                              "Too many matching features." );
+                    CPLFree(panFIDList);
+                    return NULL;
+                }
+                *pnLength = (*pnLength) * 2 + 10;
+                panFIDList = static_cast<GIntBig *>(
+                    CPLRealloc(panFIDList, sizeof(GIntBig) * (*pnLength)));
+            }
+            panFIDList[(*pnFIDCount)++] = OIXDecodeInt64(pabyEntry + nKeySize);
+        }
+        panFIDList[*pnFIDCount] = OGRNullFID;
+
+        nPage = OIXReadUInt64(&abyPage[8]);
+        if( nPage == OIX_NO_PAGE )
+            return panFIDList;
+        if( nPage >= nPageCount ||
+            !poLIndex->ReadPage(nFirstPage + nPage, &abyPage[0]) )
+        {
+            CPLFree(panFIDList);
+            return NULL;
+        }
+    }
+}
+
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/*                                                                      */
+/*      Bounds are values of the field type.  String bounds longer      */
+/*      than the key size are truncated, and then always included,      */
+/*      so that no match is missed.                                     */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetRangeMatches( const OGRField *psMin,
+                                             int bMinIncluded,
+                                             const OGRField *psMax,
+                                             int bMaxIncluded,
+                                             GIntBig* panFIDList,
+                                             int* nFIDCount, int* nLength )
+
+{
+    GByte abyMin[OIX_MAX_STRING_KEY_SIZE];
+    GByte abyMax[OIX_MAX_STRING_KEY_SIZE];
+
+    if( (psMin != NULL && !EncodeKey(psMin, abyMin)) ||
+        (psMax != NULL && !EncodeKey(psMax, abyMax)) )
+    {
+        // Nothing compares to NaN.
+        if( panFIDList == NULL )
+        {
+            panFIDList =
+                static_cast<GIntBig *>(CPLMalloc(sizeof(GIntBig) * 2));
+            *nFIDCount = 0;
+            *nLength = 2;
+        }
+        panFIDList[*nFIDCount] = OGRNullFID;
+        return panFIDList;
+    }
+
+    if( eKeyType == OIX_KEY_STRING )
+    {
+        if( psMin != NULL &&
+            static_cast<int>(strlen(psMin->String)) >= nKeySize )
+            bMinIncluded = TRUE;
+        if( psMax != NULL &&
+            static_cast<int>(strlen(psMax->String)) >= nKeySize )
+            bMaxIncluded = TRUE;
+    }
+    else if( eKeyType == OIX_KEY_DATETIME )
+    {
+        // Seconds are rounded to the millisecond in keys.
+        bMinIncluded = TRUE;
+        bMaxIncluded = TRUE;
+    }
+
+    return Search( psMin ? abyMin : NULL, CPL_TO_BOOL(bMinIncluded),
+                   psMax ? abyMax : NULL, CPL_TO_BOOL(bMaxIncluded),
+                   nKeySize, panFIDList, nFIDCount, nLength );
+}
+
+/************************************************************************/
+/*                          GetPrefixMatches()                          */
+/*                                                                      */
+/*      Case insensitive, as the LIKE operator.                         */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetPrefixMatches( const char *pszPrefix,
+                                              GIntBig* panFIDList,
+                                              int* nFIDCount, int* nLength )
+
+{
+    if( eKeyType != OIX_KEY_STRING )
+    {
+        CPLFree(panFIDList);
+        return NULL;
+    }
+
+    GByte abyPrefix[OIX_MAX_STRING_KEY_SIZE];
+    OIXEncodeString(pszPrefix, nKeySize, abyPrefix);
+    const int nPrefixLen =
+        std::min(static_cast<int>(strlen(pszPrefix)), nKeySize);
+
+    return Search( abyPrefix, true, abyPrefix, true, nPrefixLen,
+                   panFIDList, nFIDCount, nLength );
+}
+
+/************************************************************************/
+/*                           GetAllMatches()                            */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetAllMatches( OGRField *psKey,
+                                           GIntBig* panFIDList,
+                                           int* nFIDCount, int* nLength )
+
+{
+    return GetRangeMatches( psKey, TRUE, psKey, TRUE,
+                            panFIDList, nFIDCount, nLength );
+}
+
+GIntBig *OGRBTreeAttrIndex::GetAllMatches( OGRField *psKey )
+
+{
+    int nFIDCount = 0;
+    int nLength = 0;
+    return GetAllMatches( psKey, NULL, &nFIDCount, &nLength );
+}
+
+/************************************************************************/
+/*                           GetFirstMatch()                            */
+/************************************************************************/
+
+GIntBig OGRBTreeAttrIndex::GetFirstMatch( OGRField *psKey )
+
+{
+    GIntBig *panFIDs = GetAllMatches( psKey );
+    if( panFIDs == NULL )
+        return OGRNullFID;
+    const GIntBig nFID = panFIDs[0];
+    CPLFree(panFIDs);
+    return nFID;
+}
+
+/************************************************************************/
+/*                              AddEntry()                              */
+/************************************************************************/
+
+OGRErr OGRBTreeAttrIndex::AddEntry( OGRField * /*psKey*/, GIntBig /*nFID*/ )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                            RemoveEntry()                             */
+/************************************************************************/
+
+OGRErr OGRBTreeAttrIndex::RemoveEntry( OGRField * /*psKey*/,
+                                       GIntBig /*nFID*/ )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                               Clear()                                */
+/************************************************************************/
+
+OGRErr OGRBTreeAttrIndex::Clear()
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
@@ -33,6 +33,7 @@
 #include "cpl_string.h"
 #include "ogr_api.h"
 #include "cpl_time.h"
+#include "cpl_worker_thread_pool.h"
 #include <algorithm>
 #include <vector>
 
@@ -81,6 +82,732 @@ int OGRGenSQLResultsLayerHasSpecialField(swq_expr_node* expr,
     return FALSE;
 }
 
+/************************************************************************/
+/*                   OGRGenSQLSerializeFeature()                        */
+/*                                                                      */
+/*      Serialize a feature in a compact native-endian binary form,     */
+/*      only meant to be read back by the same process with             */
+/*      OGRGenSQLDeserializeFeature().                                  */
+/************************************************************************/
+
+static void OGRGenSQLAppendBytes( std::vector<GByte>& abyBuffer,
+                                  const void* pData, size_t nSize )
+{
+    const GByte* pabyData = static_cast<const GByte*>(pData);
+    abyBuffer.insert(abyBuffer.end(), pabyData, pabyData + nSize);
+}
+
+template<class T> static void OGRGenSQLAppendValue(
+                                std::vector<GByte>& abyBuffer, const T& value )
+{
+    OGRGenSQLAppendBytes(abyBuffer, &value, sizeof(T));
+}
+
+static void OGRGenSQLAppendString( std::vector<GByte>& abyBuffer,
+                                   const char* pszStr )
+{
+    const int nLen = static_cast<int>(strlen(pszStr));
+    OGRGenSQLAppendValue(abyBuffer, nLen);
+    OGRGenSQLAppendBytes(abyBuffer, pszStr, nLen);
+}
+
+static void OGRGenSQLSerializeFeature( OGRFeature* poFeature,
+                                       std::vector<GByte>& abyBuffer )
+{
+    abyBuffer.resize(0);
+    OGRGenSQLAppendValue(abyBuffer, poFeature->GetFID());
+
+    OGRFeatureDefn* poFDefn = poFeature->GetDefnRef();
+    const int nFieldCount = poFDefn->GetFieldCount();
+    for( int iField = 0; iField < nFieldCount; iField++ )
+    {
+        const OGRFieldType eType = poFDefn->GetFieldDefn(iField)->GetType();
+        const GByte byState = !poFeature->IsFieldSet(iField) ? 0 :
+                              poFeature->IsFieldNull(iField) ? 1 : 2;
+        if( byState == 2 &&
+            (eType == OFTWideString || eType == OFTWideStringList) )
+        {
+            OGRGenSQLAppendValue(abyBuffer, static_cast<GByte>(0));
+            continue;
+        }
+        OGRGenSQLAppendValue(abyBuffer, byState);
+        if( byState != 2 )
+            continue;
+
+        const OGRField* psField = poFeature->GetRawFieldRef(iField);
+        switch( eType )
+        {
+          case OFTInteger:
+            OGRGenSQLAppendValue(abyBuffer, psField->Integer);
+            break;
+
+          case OFTInteger64:
+            OGRGenSQLAppendValue(abyBuffer, psField->Integer64);
+            break;
+
+          case OFTReal:
+            OGRGenSQLAppendValue(abyBuffer, psField->Real);
+            break;
+
+          case OFTString:
+            OGRGenSQLAppendString(abyBuffer, psField->String);
+            break;
+
+          case OFTBinary:
+            OGRGenSQLAppendValue(abyBuffer, psField->Binary.nCount);
+            OGRGenSQLAppendBytes(abyBuffer, psField->Binary.paData,
+                                 psField->Binary.nCount);
+            break;
+
+          case OFTIntegerList:
+            OGRGenSQLAppendValue(abyBuffer, psField->IntegerList.nCount);
+            OGRGenSQLAppendBytes(abyBuffer, psField->IntegerList.paList,
+                                 sizeof(int) * psField->IntegerList.nCount);
+            break;
+
+          case OFTInteger64List:
+            OGRGenSQLAppendValue(abyBuffer, psField->Integer64List.nCount);
+            OGRGenSQLAppendBytes(abyBuffer, psField->Integer64List.paList,
+                                 sizeof(GIntBig) *
+                                    psField->Integer64List.nCount);
+            break;
+
+          case OFTRealList:
+            OGRGenSQLAppendValue(abyBuffer, psField->RealList.nCount);
+            OGRGenSQLAppendBytes(abyBuffer, psField->RealList.paList,
+                                 sizeof(double) * psField->RealList.nCount);
+            break;
+
+          case OFTStringList:
+            OGRGenSQLAppendValue(abyBuffer, psField->StringList.nCount);
+            for( int i = 0; i < psField->StringList.nCount; i++ )
+                OGRGenSQLAppendString(abyBuffer, psField->StringList.paList[i]);
+            break;
+
+          case OFTDate:
+          case OFTTime:
+          case OFTDateTime:
+            OGRGenSQLAppendBytes(abyBuffer, &(psField->Date),
+                                 sizeof(psField->Date));
+            break;
+
+          default:
+            break;
+        }
+    }
+
+    const int nGeomFieldCount = poFDefn->GetGeomFieldCount();
+    for( int iGeomField = 0; iGeomField < nGeomFieldCount; iGeomField++ )
+    {
+        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(iGeomField);
+        const int nWkbSize = poGeom ? poGeom->WkbSize() : 0;
+        OGRGenSQLAppendValue(abyBuffer, nWkbSize);
+        if( nWkbSize > 0 )
+        {
+            const size_t nOffset = abyBuffer.size();
+            abyBuffer.resize(nOffset + nWkbSize);
+            poGeom->exportToWkb(wkbNDR, &abyBuffer[nOffset], wkbVariantIso);
+        }
+    }
+
+    const char* pszStyle = poFeature->GetStyleString();
+    OGRGenSQLAppendString(abyBuffer, pszStyle ? pszStyle : "");
+}
+
+/************************************************************************/
+/*                   OGRGenSQLDeserializeFeature()                      */
+/************************************************************************/
+
+namespace {
+class OGRGenSQLBufferReader
+{
+    const GByte* m_pabyCur;
+    const GByte* m_pabyEnd;
+
+  public:
+    OGRGenSQLBufferReader( const GByte* pabyData, size_t nSize ) :
+        m_pabyCur(pabyData), m_pabyEnd(pabyData + nSize) {}
+
+    const GByte* Read( size_t nSize )
+    {
+        if( nSize > static_cast<size_t>(m_pabyEnd - m_pabyCur) )
+            return NULL;
+        const GByte* pabyRet = m_pabyCur;
+        m_pabyCur += nSize;
+        return pabyRet;
+    }
+
+    template<class T> bool ReadValue( T& value )
+    {
+        const GByte* pabyData = Read(sizeof(T));
+        if( pabyData == NULL )
+            return false;
+        memcpy(&value, pabyData, sizeof(T));
+        return true;
+    }
+
+    bool ReadCount( int& nCount, size_t nEltSize )
+    {
+        return ReadValue(nCount) && nCount >= 0 &&
+               static_cast<size_t>(nCount) <=
+                    static_cast<size_t>(m_pabyEnd - m_pabyCur) / nEltSize;
+    }
+
+    bool ReadString( CPLString& osStr )
+    {
+        int nLen = 0;
+        if( !ReadCount(nLen, 1) )
+            return false;
+        osStr.assign(reinterpret_cast<const char*>(Read(nLen)), nLen);
+        return true;
+    }
+};
+} // namespace
+
+static OGRFeature* OGRGenSQLDeserializeFeature( OGRFeatureDefn* poFDefn,
+                                                const GByte* pabyData,
+                                                size_t nSize )
+{
+    OGRGenSQLBufferReader oReader(pabyData, nSize);
+    OGRFeature* poFeature = new OGRFeature(poFDefn);
+
+    GIntBig nFID = OGRNullFID;
+    bool bOK = oReader.ReadValue(nFID);
+    poFeature->SetFID(nFID);
+
+    const int nFieldCount = poFDefn->GetFieldCount();
+    for( int iField = 0; bOK && iField < nFieldCount; iField++ )
+    {
+        GByte byState = 0;
+        if( !oReader.ReadValue(byState) )
+        {
+            bOK = false;
+            break;
+        }
+        if( byState == 1 )
+            poFeature->SetFieldNull(iField);
+        if( byState != 2 )
+            continue;
+
+        int nCount = 0;
+        switch( poFDefn->GetFieldDefn(iField)->GetType() )
+        {
+          case OFTInteger:
+          {
+            int nVal = 0;
+            bOK = oReader.ReadValue(nVal);
+            poFeature->SetField(iField, nVal);
+            break;
+          }
+
+          case OFTInteger64:
+          {
+            GIntBig nVal = 0;
+            bOK = oReader.ReadValue(nVal);
+            poFeature->SetField(iField, nVal);
+            break;
+          }
+
+          case OFTReal:
+          {
+            double dfVal = 0.0;
+            bOK = oReader.ReadValue(dfVal);
+            poFeature->SetField(iField, dfVal);
+            break;
+          }
+
+          case OFTString:
+          {
+            CPLString osVal;
+            bOK = oReader.ReadString(osVal);
+            poFeature->SetField(iField, osVal.c_str());
+            break;
+          }
+
+          case OFTBinary:
+            bOK = oReader.ReadCount(nCount, 1);
+            if( bOK )
+                poFeature->SetField(iField, nCount,
+                    const_cast<GByte*>(oReader.Read(nCount)));
+            break;
+
+          case OFTIntegerList:
+            bOK = oReader.ReadCount(nCount, sizeof(int));
+            if( bOK )
+            {
+                std::vector<int> anVals(nCount + 1);
+                memcpy(&anVals[0], oReader.Read(nCount * sizeof(int)),
+                       nCount * sizeof(int));
+                poFeature->SetField(iField, nCount, &anVals[0]);
+            }
+            break;
+
+          case OFTInteger64List:
+            bOK = oReader.ReadCount(nCount, sizeof(GIntBig));
+            if( bOK )
+            {
+                std::vector<GIntBig> anVals(nCount + 1);
+                memcpy(&anVals[0], oReader.Read(nCount * sizeof(GIntBig)),
+                       nCount * sizeof(GIntBig));
+                poFeature->SetField(iField, nCount, &anVals[0]);
+            }
+            break;
+
+          case OFTRealList:
+            bOK = oReader.ReadCount(nCount, sizeof(double));
+            if( bOK )
+            {
+                std::vector<double> adfVals(nCount + 1);
+                memcpy(&adfVals[0], oReader.Read(nCount * sizeof(double)),
+                       nCount * sizeof(double));
+                poFeature->SetField(iField, nCount, &adfVals[0]);
+            }
+            break;
+
+          case OFTStringList:
+          {
+            bOK = oReader.ReadCount(nCount, sizeof(int));
+            CPLStringList aosVals;
+            for( int i = 0; bOK && i < nCount; i++ )
+            {
+                CPLString osVal;
+                bOK = oReader.ReadString(osVal);
+                aosVals.AddString(osVal);
+            }
+            if( bOK )
+                poFeature->SetField(iField, aosVals.List());
+            break;
+          }
+
+          case OFTDate:
+          case OFTTime:
+          case OFTDateTime:
+          {
+            OGRField sField;
+            const GByte* pabyDate = oReader.Read(sizeof(sField.Date));
+            bOK = pabyDate != NULL;
+            if( bOK )
+            {
+                memcpy(&(sField.Date), pabyDate, sizeof(sField.Date));
+                poFeature->SetField(iField, &sField);
+            }
+            break;
+          }
+
+          default:
+            break;
+        }
+    }
+
+    const int nGeomFieldCount = poFDefn->GetGeomFieldCount();
+    for( int iGeomField = 0; bOK && iGeomField < nGeomFieldCount;
+         iGeomField++ )
+    {
+        int nWkbSize = 0;
+        bOK = oReader.ReadCount(nWkbSize, 1);
+        if( !bOK || nWkbSize == 0 )
+            continue;
+        OGRGeometry* poGeom = NULL;
+        OGRGeometryFactory::createFromWkb(
+            const_cast<GByte*>(oReader.Read(nWkbSize)),
+            poFDefn->GetGeomFieldDefn(iGeomField)->GetSpatialRef(),
+            &poGeom, nWkbSize, wkbVariantIso );
+        poFeature->SetGeomFieldDirectly(iGeomField, poGeom);
+    }
+
+    CPLString osStyle;
+    if( bOK && oReader.ReadString(osStyle) && !osStyle.empty() )
+        poFeature->SetStyleString(osStyle);
+
+    return poFeature;
+}
+
+/************************************************************************/
+/*                      OGRGenSQLJoinHashTable                          */
+/*                                                                      */
+/*      Hash table of the features of a secondary layer, keyed on the   */
+/*      value of the field used in a "primary.field = secondary.field"  */
+/*      join.  It is built once, and then probed for each primary       */
+/*      feature, instead of querying the secondary layer with an        */
+/*      attribute filter per primary feature.  Features beyond a        */
+/*      memory limit are serialized to a temporary file.                */
+/************************************************************************/
+
+typedef struct
+{
+    GIntBig      nKey;
+    double       dfKey;
+    char        *pszKey;
+    OGRFeature  *poFeature;
+    vsi_l_offset nOffset;
+    size_t       nSize;
+} OGRGenSQLJoinHashEntry;
+
+static unsigned long OGRGenSQLJoinHashInt( const void* elt )
+{
+    const GUIntBig nKey = static_cast<GUIntBig>(
+        static_cast<const OGRGenSQLJoinHashEntry*>(elt)->nKey);
+    return static_cast<unsigned long>(nKey ^ (nKey >> 32));
+}
+
+static int OGRGenSQLJoinEqualInt( const void* elt1, const void* elt2 )
+{
+    return static_cast<const OGRGenSQLJoinHashEntry*>(elt1)->nKey ==
+           static_cast<const OGRGenSQLJoinHashEntry*>(elt2)->nKey;
+}
+
+static unsigned long OGRGenSQLJoinHashReal( const void* elt )
+{
+    GUIntBig nKey = 0;
+    memcpy(&nKey, &(static_cast<const OGRGenSQLJoinHashEntry*>(elt)->dfKey),
+           sizeof(nKey));
+    return static_cast<unsigned long>(nKey ^ (nKey >> 32));
+}
+
+static int OGRGenSQLJoinEqualReal( const void* elt1, const void* elt2 )
+{
+    return static_cast<const OGRGenSQLJoinHashEntry*>(elt1)->dfKey ==
+           static_cast<const OGRGenSQLJoinHashEntry*>(elt2)->dfKey;
+}
+
+static unsigned long OGRGenSQLJoinHashStr( const void* elt )
+{
+    return CPLHashSetHashStr(
+        static_cast<const OGRGenSQLJoinHashEntry*>(elt)->pszKey);
+}
+
+static int OGRGenSQLJoinEqualStr( const void* elt1, const void* elt2 )
+{
+    return strcmp(static_cast<const OGRGenSQLJoinHashEntry*>(elt1)->pszKey,
+                  static_cast<const OGRGenSQLJoinHashEntry*>(elt2)->pszKey)
+                                                                    == 0;
+}
+
+static void OGRGenSQLJoinFreeEntry( void* elt )
+{
+    OGRGenSQLJoinHashEntry* psEntry =
+        static_cast<OGRGenSQLJoinHashEntry*>(elt);
+    CPLFree(psEntry->pszKey);
+    delete psEntry->poFeature;
+    delete psEntry;
+}
+
+class OGRGenSQLJoinHashTable
+{
+    OGRLayer       *m_poLayer;
+    int             m_iPrimaryField;
+    int             m_iSecondaryField;
+    OGRFieldType    m_eKeyType;
+    CPLHashSet     *m_hSet;
+    GIntBig         m_nMemoryUsage;
+    GIntBig         m_nMaxMemory;
+    CPLString       m_osSpillFilename;
+    VSILFILE       *m_fpSpill;
+    vsi_l_offset    m_nSpillSize;
+    std::vector<GByte> m_abyBuffer;
+    OGRFeature     *m_poSpilledFeature;
+
+                    OGRGenSQLJoinHashTable( OGRLayer* poLayer,
+                                            int iPrimaryField,
+                                            int iSecondaryField,
+                                            OGRFieldType eKeyType );
+
+    bool            GetKey( OGRFeature* poFeature, int iField,
+                            OGRGenSQLJoinHashEntry* psEntry,
+                            CPLString& osKey ) const;
+    bool            Insert( OGRFeature* poFeature );
+
+  public:
+                   ~OGRGenSQLJoinHashTable();
+
+    static OGRGenSQLJoinHashTable* Create( swq_join_def* psJoinDef,
+                                           OGRLayer* poPrimaryLayer,
+                                           OGRLayer* poSecondaryLayer );
+
+    bool            Build();
+    OGRFeature     *Lookup( OGRFeature* poSrcFeat );
+};
+
+/************************************************************************/
+/*                       OGRGenSQLJoinHashTable()                       */
+/************************************************************************/
+
+OGRGenSQLJoinHashTable::OGRGenSQLJoinHashTable( OGRLayer* poLayer,
+                                                int iPrimaryField,
+                                                int iSecondaryField,
+                                                OGRFieldType eKeyType ) :
+    m_poLayer(poLayer),
+    m_iPrimaryField(iPrimaryField),
+    m_iSecondaryField(iSecondaryField),
+    m_eKeyType(eKeyType),
+    m_hSet(CPLHashSetNew(
+        eKeyType == OFTInteger64 ? OGRGenSQLJoinHashInt :
+        eKeyType == OFTReal ? OGRGenSQLJoinHashReal : OGRGenSQLJoinHashStr,
+        eKeyType == OFTInteger64 ? OGRGenSQLJoinEqualInt :
+        eKeyType == OFTReal ? OGRGenSQLJoinEqualReal : OGRGenSQLJoinEqualStr,
+        OGRGenSQLJoinFreeEntry)),
+    m_nMemoryUsage(0),
+    m_nMaxMemory(static_cast<GIntBig>(
+        CPLAtoGIntBig(CPLGetConfigOption("OGR_SQL_JOIN_MAX_MEMORY", "100")))
+                                                        * 1024 * 1024),
+    m_fpSpill(NULL),
+    m_nSpillSize(0),
+    m_poSpilledFeature(NULL)
+{
+}
+
+/************************************************************************/
+/*                      ~OGRGenSQLJoinHashTable()                       */
+/************************************************************************/
+
+OGRGenSQLJoinHashTable::~OGRGenSQLJoinHashTable()
+{
+    CPLHashSetDestroy(m_hSet);
+    delete m_poSpilledFeature;
+    if( m_fpSpill != NULL )
+    {
+        VSIFCloseL(m_fpSpill);
+        VSIUnlink(m_osSpillFilename);
+    }
+}
+
+/************************************************************************/
+/*                               Create()                               */
+/*                                                                      */
+/*      Returns NULL if the join condition is not a simple equality     */
+/*      between fields of compatible types.                             */
+/************************************************************************/
+
+OGRGenSQLJoinHashTable* OGRGenSQLJoinHashTable::Create(
+                                            swq_join_def* psJoinDef,
+                                            OGRLayer* poPrimaryLayer,
+                                            OGRLayer* poSecondaryLayer )
+{
+    swq_expr_node* poExpr = psJoinDef->poExpr;
+    if( poSecondaryLayer == poPrimaryLayer ||
+        !CPLTestBool(CPLGetConfigOption("OGR_SQL_JOIN_HASH", "YES")) ||
+        poExpr == NULL ||
+        poExpr->eNodeType != SNT_OPERATION ||
+        poExpr->nOperation != SWQ_EQ ||
+        poExpr->nSubExprCount != 2 ||
+        poExpr->papoSubExpr[0]->eNodeType != SNT_COLUMN ||
+        poExpr->papoSubExpr[1]->eNodeType != SNT_COLUMN )
+    {
+        return NULL;
+    }
+
+    int iPrimaryField = -1;
+    int iSecondaryField = -1;
+    for( int i = 0; i < 2; i++ )
+    {
+        swq_expr_node* poColumn = poExpr->papoSubExpr[i];
+        if( poColumn->table_index == 0 )
+            iPrimaryField = poColumn->field_index;
+        else if( poColumn->table_index == psJoinDef->secondary_table )
+            iSecondaryField = poColumn->field_index;
+    }
+
+    OGRFeatureDefn* poPrimaryDefn = poPrimaryLayer->GetLayerDefn();
+    OGRFeatureDefn* poSecondaryDefn = poSecondaryLayer->GetLayerDefn();
+    if( iPrimaryField < 0 ||
+        iPrimaryField >= poPrimaryDefn->GetFieldCount() ||
+        iSecondaryField < 0 ||
+        iSecondaryField >= poSecondaryDefn->GetFieldCount() )
+    {
+        return NULL;
+    }
+
+    const OGRFieldType ePrimaryType =
+        poPrimaryDefn->GetFieldDefn(iPrimaryField)->GetType();
+    const OGRFieldType eSecondaryType =
+        poSecondaryDefn->GetFieldDefn(iSecondaryField)->GetType();
+    const bool bPrimaryNumeric = ePrimaryType == OFTInteger ||
+                                 ePrimaryType == OFTInteger64 ||
+                                 ePrimaryType == OFTReal;
+    const bool bSecondaryNumeric = eSecondaryType == OFTInteger ||
+                                   eSecondaryType == OFTInteger64 ||
+                                   eSecondaryType == OFTReal;
+
+    OGRFieldType eKeyType;
+    if( bPrimaryNumeric && bSecondaryNumeric )
+    {
+        eKeyType = (ePrimaryType == OFTReal || eSecondaryType == OFTReal) ?
+                                                    OFTReal : OFTInteger64;
+    }
+    else if( ePrimaryType == OFTString && eSecondaryType == OFTString )
+    {
+        eKeyType = OFTString;
+    }
+    else
+    {
+        return NULL;
+    }
+
+    return new OGRGenSQLJoinHashTable( poSecondaryLayer, iPrimaryField,
+                                       iSecondaryField, eKeyType );
+}
+
+/************************************************************************/
+/*                               GetKey()                               */
+/*                                                                      */
+/*      Fill the key of psEntry from a field.  Returns false for null   */
+/*      values, that never match.  String comparisons are case          */
+/*      insensitive, as in OGR SQL.                                     */
+/************************************************************************/
+
+bool OGRGenSQLJoinHashTable::GetKey( OGRFeature* poFeature, int iField,
+                                     OGRGenSQLJoinHashEntry* psEntry,
+                                     CPLString& osKey ) const
+{
+    if( !poFeature->IsFieldSetAndNotNull(iField) )
+        return false;
+
+    if( m_eKeyType == OFTInteger64 )
+    {
+        psEntry->nKey = poFeature->GetFieldAsInteger64(iField);
+    }
+    else if( m_eKeyType == OFTReal )
+    {
+        // + 0.0 to map -0.0 to 0.0
+        psEntry->dfKey = poFeature->GetFieldAsDouble(iField) + 0.0;
+        if( CPLIsNan(psEntry->dfKey) )
+            return false;
+    }
+    else
+    {
+        osKey = poFeature->GetFieldAsString(iField);
+        osKey.toupper();
+        psEntry->pszKey = const_cast<char*>(osKey.c_str());
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                               Insert()                               */
+/************************************************************************/
+
+bool OGRGenSQLJoinHashTable::Insert( OGRFeature* poFeature )
+{
+    OGRGenSQLJoinHashEntry sEntry;
+    memset(&sEntry, 0, sizeof(sEntry));
+    CPLString osKey;
+
+    // Only the first feature with a given key is used by the join.
+    if( !GetKey(poFeature, m_iSecondaryField, &sEntry, osKey) ||
+        CPLHashSetLookup(m_hSet, &sEntry) != NULL )
+    {
+        delete poFeature;
+        return true;
+    }
+
+    OGRGenSQLJoinHashEntry* psEntry = new OGRGenSQLJoinHashEntry(sEntry);
+    if( m_eKeyType == OFTString )
+        psEntry->pszKey = CPLStrdup(osKey);
+
+    OGRGenSQLSerializeFeature(poFeature, m_abyBuffer);
+    m_nMemoryUsage += sizeof(OGRGenSQLJoinHashEntry) +
+                      (psEntry->pszKey ? strlen(psEntry->pszKey) + 1 : 0);
+    if( m_nMemoryUsage + static_cast<GIntBig>(m_abyBuffer.size()) * 2 <=
+                                                                m_nMaxMemory )
+    {
+        m_nMemoryUsage += static_cast<GIntBig>(m_abyBuffer.size()) * 2;
+        psEntry->poFeature = poFeature;
+    }
+    else
+    {
+        delete poFeature;
+        if( m_fpSpill == NULL )
+        {
+            m_osSpillFilename = CPLGenerateTempFilename("ogr_sql_join");
+            m_fpSpill = VSIFOpenL(m_osSpillFilename, "wb+");
+            if( m_fpSpill == NULL )
+            {
+                CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s",
+                         m_osSpillFilename.c_str());
+                OGRGenSQLJoinFreeEntry(psEntry);
+                return false;
+            }
+            CPLDebug("GenSQL", "Spilling join features of %s to %s",
+                     m_poLayer->GetName(), m_osSpillFilename.c_str());
+        }
+        psEntry->nOffset = m_nSpillSize;
+        psEntry->nSize = m_abyBuffer.size();
+        if( VSIFWriteL(&m_abyBuffer[0], 1, m_abyBuffer.size(), m_fpSpill) !=
+                                                        m_abyBuffer.size() )
+        {
+            CPLError(CE_Failure, CPLE_FileIO, "Cannot write to %s",
+                     m_osSpillFilename.c_str());
+            OGRGenSQLJoinFreeEntry(psEntry);
+            return false;
+        }
+        m_nSpillSize += m_abyBuffer.size();
+    }
+
+    CPLHashSetInsert(m_hSet, psEntry);
+    return true;
+}
+
+/************************************************************************/
+/*                                Build()                               */
+/************************************************************************/
+
+bool OGRGenSQLJoinHashTable::Build()
+{
+    m_poLayer->SetAttributeFilter(NULL);
+    m_poLayer->ResetReading();
+
+    bool bOK = true;
+    OGRFeature* poFeature = NULL;
+    while( bOK && (poFeature = m_poLayer->GetNextFeature()) != NULL )
+        bOK = Insert(poFeature);
+
+    m_poLayer->ResetReading();
+
+    CPLDebug("GenSQL", "Join hash table on %s: %d keys",
+             m_poLayer->GetName(), CPLHashSetSize(m_hSet));
+    return bOK;
+}
+
+/************************************************************************/
+/*                               Lookup()                               */
+/*                                                                      */
+/*      Return the secondary feature matching the primary feature, or   */
+/*      NULL.  The returned feature is owned by the hash table, and     */
+/*      only valid until the next call.                                 */
+/************************************************************************/
+
+OGRFeature* OGRGenSQLJoinHashTable::Lookup( OGRFeature* poSrcFeat )
+{
+    OGRGenSQLJoinHashEntry sEntry;
+    memset(&sEntry, 0, sizeof(sEntry));
+    CPLString osKey;
+    if( !GetKey(poSrcFeat, m_iPrimaryField, &sEntry, osKey) )
+        return NULL;
+
+    const OGRGenSQLJoinHashEntry* psEntry =
+        static_cast<const OGRGenSQLJoinHashEntry*>(
+                                        CPLHashSetLookup(m_hSet, &sEntry));
+    if( psEntry == NULL )
+        return NULL;
+    if( psEntry->poFeature != NULL )
+        return psEntry->poFeature;
+
+    delete m_poSpilledFeature;
+    m_poSpilledFeature = NULL;
+    m_abyBuffer.resize(psEntry->nSize);
+    if( VSIFSeekL(m_fpSpill, psEntry->nOffset, SEEK_SET) != 0 ||
+        VSIFReadL(&m_abyBuffer[0], 1, psEntry->nSize, m_fpSpill) !=
+                                                            psEntry->nSize )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot read %s",
+                 m_osSpillFilename.c_str());
+        return NULL;
+    }
+    m_poSpilledFeature = OGRGenSQLDeserializeFeature(
+                m_poLayer->GetLayerDefn(), &m_abyBuffer[0], psEntry->nSize);
+    return m_poSpilledFeature;
+}
+
 /************************************************************************/
 /*                       OGRGenSQLResultsLayer()                        */
 /************************************************************************/
@@ -105,7 +832,8 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDSIn,
     iFIDFieldIndex(),
     nExtraDSCount(0),
     papoExtraDS(NULL),
-    nIteratedFeatures(-1)
+    nIteratedFeatures(-1),
+    m_bJoinHashTablesInitialized(false)
 {
     swq_select *psSelectInfo = (swq_select *) pSelectInfoIn;
 
@@ -505,6 +1233,9 @@ OGRGenSQLResultsLayer::~OGRGenSQLResultsLayer()
                   poDefn->GetName() );
     }
 
+    for( size_t i = 0; i < m_apoJoinHashTables.size(); i++ )
+        delete m_apoJoinHashTables[i];
+
     ClearFilters();
 
 /* -------------------------------------------------------------------- */
@@ -1267,6 +1998,35 @@ static CPLString GetFilterForJoin(swq_expr_node* poExpr, OGRFeature* poSrcFeat,
     return "";
 }
 
+/************************************************************************/
+/*                         InitJoinHashTables()                         */
+/*                                                                      */
+/*      Build, on first use, the hash tables of the secondary layers    */
+/*      whose join condition is a simple equality.                      */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::InitJoinHashTables()
+{
+    if( m_bJoinHashTablesInitialized )
+        return;
+    m_bJoinHashTablesInitialized = true;
+
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    for( int iJoin = 0; iJoin < psSelectInfo->join_count; iJoin++ )
+    {
+        swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
+        OGRGenSQLJoinHashTable* poHashTable = OGRGenSQLJoinHashTable::Create(
+            psJoinInfo, poSrcLayer,
+            papoTableLayers[psJoinInfo->secondary_table] );
+        if( poHashTable != NULL && !poHashTable->Build() )
+        {
+            delete poHashTable;
+            poHashTable = NULL;
+        }
+        m_apoJoinHashTables.push_back( poHashTable );
+    }
+}
+
 /************************************************************************/
 /*                          TranslateFeature()                          */
 /************************************************************************/
@@ -1287,6 +2047,8 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
 /* -------------------------------------------------------------------- */
 /*      Fetch the corresponding features from any jointed tables.       */
 /* -------------------------------------------------------------------- */
+    InitJoinHashTables();
+
     for( int iJoin = 0; iJoin < psSelectInfo->join_count; iJoin++ )
     {
         CPLString osFilter;
@@ -1300,6 +2062,13 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
 
         OGRLayer *poJoinLayer = papoTableLayers[psJoinInfo->secondary_table];
 
+        if( m_apoJoinHashTables[iJoin] != NULL )
+        {
+            apoFeatures.push_back(
+                m_apoJoinHashTables[iJoin]->Lookup( poSrcFeat ) );
+            continue;
+        }
+
         osFilter = GetFilterForJoin(psJoinInfo->poExpr, poSrcFeat, poJoinLayer,
                                     psJoinInfo->secondary_table);
         //CPLDebug("OGR", "Filter = %s\n", osFilter.c_str());
@@ -1540,7 +2309,9 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
             iRegularField ++;
         }
 
-        delete poJoinFeature;
+        // Features of the join hash tables are owned by them.
+        if( m_apoJoinHashTables[iJoin] == NULL )
+            delete poJoinFeature;
     }
 
     return poDstFeat;
@@ -1808,93 +2579,487 @@ void OGRGenSQLResultsLayer::FreeIndexFields(OGRField *pasIndexFields,
             continue;
         }
 
-        OGRFieldDefn *poFDefn =
-            poSrcLayer->GetLayerDefn()->GetFieldDefn( psKeyDef->field_index );
+        OGRFieldDefn *poFDefn =
+            poSrcLayer->GetLayerDefn()->GetFieldDefn( psKeyDef->field_index );
+
+        if( poFDefn->GetType() == OFTString )
+        {
+            for( size_t i = 0; i < l_nIndexSize; i++ )
+            {
+                OGRField *psField = pasIndexFields + iKey + i * nOrderItems;
+
+                if( !OGR_RawField_IsUnset(psField) &&
+                    !OGR_RawField_IsNull(psField) )
+                    CPLFree( psField->String );
+            }
+        }
+    }
+
+    if( bFreeArray )
+        VSIFree(pasIndexFields);
+}
+
+/************************************************************************/
+/*                         ReadIndexFields()                            */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::ReadIndexFields( OGRFeature* poSrcFeat,
+                                             int nOrderItems,
+                                             OGRField *pasIndexFields )
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    for( int iKey = 0; iKey < nOrderItems; iKey++ )
+    {
+        const swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
+        OGRField *psDstField = pasIndexFields + iKey;
+
+        if ( psKeyDef->field_index >= iFIDFieldIndex)
+        {
+            CPLAssert( psKeyDef->field_index <
+                                iFIDFieldIndex + SPECIAL_FIELD_COUNT );
+
+            switch (SpecialFieldTypes[
+                            psKeyDef->field_index - iFIDFieldIndex])
+            {
+                case SWQ_INTEGER:
+                case SWQ_INTEGER64:
+                // Yes, store Integer as Integer64.
+                // This is consistent with the test in Compare()
+                psDstField->Integer64 =
+                    poSrcFeat->GetFieldAsInteger64(
+                        psKeyDef->field_index);
+                break;
+
+                case SWQ_FLOAT:
+                psDstField->Real =
+                    poSrcFeat->GetFieldAsDouble(psKeyDef->field_index);
+                break;
+
+                default:
+                psDstField->String = CPLStrdup(
+                    poSrcFeat->GetFieldAsString(
+                        psKeyDef->field_index) );
+                break;
+            }
+
+            continue;
+        }
+
+        OGRFieldDefn *poFDefn = poSrcLayer->GetLayerDefn()->GetFieldDefn(
+            psKeyDef->field_index );
+
+        OGRField *psSrcField =
+            poSrcFeat->GetRawFieldRef( psKeyDef->field_index );
+
+        if( poFDefn->GetType() == OFTInteger
+            || poFDefn->GetType() == OFTInteger64
+            || poFDefn->GetType() == OFTReal
+            || poFDefn->GetType() == OFTDate
+            || poFDefn->GetType() == OFTTime
+            || poFDefn->GetType() == OFTDateTime)
+            memcpy( psDstField, psSrcField, sizeof(OGRField) );
+        else if( poFDefn->GetType() == OFTString )
+        {
+            if( poSrcFeat->IsFieldSetAndNotNull( psKeyDef->field_index ) )
+                psDstField->String = CPLStrdup( psSrcField->String );
+            else
+                memcpy( psDstField, psSrcField, sizeof(OGRField) );
+        }
+    }
+}
+
+/************************************************************************/
+/*                      Sort key serialization.                         */
+/*                                                                      */
+/*      Used to spill sorted runs of order-by key values, with their    */
+/*      FID and read sequence number, to a temporary file.              */
+/************************************************************************/
+
+typedef enum
+{
+    OGR_SORT_KEY_OTHER,
+    OGR_SORT_KEY_INTEGER,
+    OGR_SORT_KEY_INTEGER64,
+    OGR_SORT_KEY_REAL,
+    OGR_SORT_KEY_STRING,
+    OGR_SORT_KEY_SPECIAL_STRING,
+    OGR_SORT_KEY_DATE
+} OGRGenSQLSortKeyKind;
+
+static void OGRGenSQLSerializeIndexFields( const std::vector<int>& anKeyKinds,
+                                           const OGRField* pasIndexFields,
+                                           GIntBig nFID, GIntBig nSeq,
+                                           std::vector<GByte>& abyBuffer )
+{
+    const size_t nSizeOffset = abyBuffer.size();
+    OGRGenSQLAppendValue(abyBuffer, static_cast<GUInt32>(0));
+    OGRGenSQLAppendValue(abyBuffer, nFID);
+    OGRGenSQLAppendValue(abyBuffer, nSeq);
+
+    for( size_t iKey = 0; iKey < anKeyKinds.size(); iKey++ )
+    {
+        const OGRField* psField = pasIndexFields + iKey;
+        if( anKeyKinds[iKey] == OGR_SORT_KEY_SPECIAL_STRING )
+        {
+            OGRGenSQLAppendString(abyBuffer, psField->String);
+            continue;
+        }
+
+        const GByte byState = OGR_RawField_IsUnset(psField) ? 0 :
+                              OGR_RawField_IsNull(psField) ? 1 : 2;
+        OGRGenSQLAppendValue(abyBuffer, byState);
+        if( byState != 2 )
+            continue;
+
+        switch( anKeyKinds[iKey] )
+        {
+          case OGR_SORT_KEY_INTEGER:
+            OGRGenSQLAppendValue(abyBuffer, psField->Integer);
+            break;
+          case OGR_SORT_KEY_INTEGER64:
+            OGRGenSQLAppendValue(abyBuffer, psField->Integer64);
+            break;
+          case OGR_SORT_KEY_REAL:
+            OGRGenSQLAppendValue(abyBuffer, psField->Real);
+            break;
+          case OGR_SORT_KEY_STRING:
+            OGRGenSQLAppendString(abyBuffer, psField->String);
+            break;
+          case OGR_SORT_KEY_DATE:
+            OGRGenSQLAppendBytes(abyBuffer, &(psField->Date),
+                                 sizeof(psField->Date));
+            break;
+          default:
+            break;
+        }
+    }
+
+    const GUInt32 nSize =
+        static_cast<GUInt32>(abyBuffer.size() - nSizeOffset - sizeof(GUInt32));
+    memcpy(&abyBuffer[nSizeOffset], &nSize, sizeof(nSize));
+}
+
+static bool OGRGenSQLDeserializeIndexFields( const std::vector<int>& anKeyKinds,
+                                             const GByte* pabyData,
+                                             size_t nSize,
+                                             OGRField* pasIndexFields,
+                                             GIntBig& nFID, GIntBig& nSeq )
+{
+    OGRGenSQLBufferReader oReader(pabyData, nSize);
+    if( !oReader.ReadValue(nFID) || !oReader.ReadValue(nSeq) )
+        return false;
+
+    for( size_t iKey = 0; iKey < anKeyKinds.size(); iKey++ )
+    {
+        OGRField* psField = pasIndexFields + iKey;
+        CPLString osVal;
+        if( anKeyKinds[iKey] == OGR_SORT_KEY_SPECIAL_STRING )
+        {
+            if( !oReader.ReadString(osVal) )
+                return false;
+            psField->String = CPLStrdup(osVal);
+            continue;
+        }
+
+        GByte byState = 0;
+        if( !oReader.ReadValue(byState) )
+            return false;
+        if( byState == 0 )
+        {
+            OGR_RawField_SetUnset(psField);
+            continue;
+        }
+        if( byState == 1 )
+        {
+            OGR_RawField_SetNull(psField);
+            continue;
+        }
+
+        bool bOK = true;
+        switch( anKeyKinds[iKey] )
+        {
+          case OGR_SORT_KEY_INTEGER:
+            bOK = oReader.ReadValue(psField->Integer);
+            break;
+          case OGR_SORT_KEY_INTEGER64:
+            bOK = oReader.ReadValue(psField->Integer64);
+            break;
+          case OGR_SORT_KEY_REAL:
+            bOK = oReader.ReadValue(psField->Real);
+            break;
+          case OGR_SORT_KEY_STRING:
+            bOK = oReader.ReadString(osVal);
+            if( bOK )
+                psField->String = CPLStrdup(osVal);
+            break;
+          case OGR_SORT_KEY_DATE:
+          {
+            const GByte* pabyDate = oReader.Read(sizeof(psField->Date));
+            bOK = pabyDate != NULL;
+            if( bOK )
+                memcpy(&(psField->Date), pabyDate, sizeof(psField->Date));
+            break;
+          }
+          default:
+            break;
+        }
+        if( !bOK )
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                       OGRGenSQLSortRunReader                         */
+/*                                                                      */
+/*      Buffered sequential reader of the records of one of the sorted  */
+/*      runs, all stored in the same temporary file.                    */
+/************************************************************************/
+
+namespace {
+class OGRGenSQLSortRunReader
+{
+    VSILFILE           *m_fp;
+    vsi_l_offset        m_nOffset;
+    vsi_l_offset        m_nEnd;
+    std::vector<GByte>  m_abyBuffer;
+    size_t              m_nBufferPos;
+    size_t              m_nBufferSize;
+
+    bool Fill( size_t nNeeded )
+    {
+        if( m_nBufferSize - m_nBufferPos >= nNeeded )
+            return true;
+        memmove(&m_abyBuffer[0], &m_abyBuffer[m_nBufferPos],
+                m_nBufferSize - m_nBufferPos);
+        m_nBufferSize -= m_nBufferPos;
+        m_nBufferPos = 0;
+        if( nNeeded > m_abyBuffer.size() )
+            m_abyBuffer.resize(nNeeded);
+        const size_t nToRead = static_cast<size_t>(
+            std::min(static_cast<vsi_l_offset>(m_abyBuffer.size() -
+                                               m_nBufferSize),
+                     m_nEnd - m_nOffset));
+        if( nToRead == 0 ||
+            VSIFSeekL(m_fp, m_nOffset, SEEK_SET) != 0 ||
+            VSIFReadL(&m_abyBuffer[m_nBufferSize], 1, nToRead, m_fp) !=
+                                                                    nToRead )
+        {
+            return false;
+        }
+        m_nOffset += nToRead;
+        m_nBufferSize += nToRead;
+        return m_nBufferSize >= nNeeded;
+    }
+
+  public:
+    OGRGenSQLSortRunReader( VSILFILE* fp, vsi_l_offset nStart,
+                            vsi_l_offset nEnd ) :
+        m_fp(fp), m_nOffset(nStart), m_nEnd(nEnd),
+        m_abyBuffer(65536), m_nBufferPos(0), m_nBufferSize(0) {}
+
+    bool IsEOF() const
+    {
+        return m_nBufferPos == m_nBufferSize && m_nOffset == m_nEnd;
+    }
+
+    const GByte* Next( size_t& nSize )
+    {
+        GUInt32 nRecordSize = 0;
+        if( !Fill(sizeof(nRecordSize)) )
+            return NULL;
+        memcpy(&nRecordSize, &m_abyBuffer[m_nBufferPos], sizeof(nRecordSize));
+        m_nBufferPos += sizeof(nRecordSize);
+        if( !Fill(nRecordSize) )
+            return NULL;
+        const GByte* pabyRet = &m_abyBuffer[m_nBufferPos];
+        m_nBufferPos += nRecordSize;
+        nSize = nRecordSize;
+        return pabyRet;
+    }
+};
+} // namespace
+
+/************************************************************************/
+/*                        OGRGenSQLTopNComparator                       */
+/*                                                                      */
+/*      Orders the slots of the top-N heap by key values, and by read   */
+/*      order for equal keys, so that the result is the same as with    */
+/*      the (stable) merge sort.                                        */
+/************************************************************************/
+
+class OGRGenSQLTopNComparator
+{
+    OGRGenSQLResultsLayer *m_poLayer;
+    const OGRField        *m_pasIndexFields;
+    const GIntBig         *m_panSeq;
+    int                    m_nOrderItems;
+
+  public:
+    OGRGenSQLTopNComparator( OGRGenSQLResultsLayer* poLayer,
+                             const OGRField* pasIndexFields,
+                             const GIntBig* panSeq, int nOrderItems ) :
+        m_poLayer(poLayer), m_pasIndexFields(pasIndexFields),
+        m_panSeq(panSeq), m_nOrderItems(nOrderItems) {}
+
+    bool operator()( size_t i, size_t j ) const
+    {
+        const int nResult =
+            m_poLayer->Compare( m_pasIndexFields + i * m_nOrderItems,
+                                m_pasIndexFields + j * m_nOrderItems );
+        if( nResult != 0 )
+            return nResult < 0;
+        return m_panSeq[i] < m_panSeq[j];
+    }
+};
+
+/************************************************************************/
+/*                       CreateTopNOrderByIndex()                       */
+/*                                                                      */
+/*      Used for ORDER BY ... LIMIT, when only the OFFSET+LIMIT first   */
+/*      features are needed: their key values are kept in a max-heap   */
+/*      of nTopN elements, instead of sorting all key values.           */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::CreateTopNOrderByIndex( size_t nTopN )
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    const int nOrderItems = psSelectInfo->order_specs;
+
+    panFIDIndex = NULL;
+    nIndexSize = 0;
+    if( nTopN == 0 )
+        return;
+
+    // One more slot than nTopN for the key values of the current feature.
+    OGRField *pasIndexFields = static_cast<OGRField *>(
+        VSI_CALLOC_VERBOSE(sizeof(OGRField), nOrderItems * (nTopN + 1)));
+    if( pasIndexFields == NULL )
+        return;
+    std::vector<GIntBig> anFID(nTopN + 1);
+    std::vector<GIntBig> anSeq(nTopN + 1);
+    std::vector<size_t> anHeap;
+    OGRGenSQLTopNComparator oComparator(this, pasIndexFields, &anSeq[0],
+                                        nOrderItems);
+
+    size_t iCurSlot = 0;
+    GIntBig nSeq = 0;
+    OGRFeature *poSrcFeat = NULL;
+    while( (poSrcFeat = poSrcLayer->GetNextFeature()) != NULL )
+    {
+        OGRField* pasCurFields = pasIndexFields + iCurSlot * nOrderItems;
+        ReadIndexFields( poSrcFeat, nOrderItems, pasCurFields );
+        anFID[iCurSlot] = poSrcFeat->GetFID();
+        anSeq[iCurSlot] = nSeq++;
+        delete poSrcFeat;
+
+        if( anHeap.size() < nTopN )
+        {
+            anHeap.push_back(iCurSlot);
+            std::push_heap(anHeap.begin(), anHeap.end(), oComparator);
+            iCurSlot = anHeap.size();
+        }
+        else if( oComparator(iCurSlot, anHeap[0]) )
+        {
+            // Replace the last feature of the heap with the current one.
+            std::pop_heap(anHeap.begin(), anHeap.end(), oComparator);
+            const size_t iEvictedSlot = anHeap.back();
+            anHeap.back() = iCurSlot;
+            std::push_heap(anHeap.begin(), anHeap.end(), oComparator);
+
+            iCurSlot = iEvictedSlot;
+            pasCurFields = pasIndexFields + iCurSlot * nOrderItems;
+            FreeIndexFields( pasCurFields, 1, false );
+            memset( pasCurFields, 0, sizeof(OGRField) * nOrderItems );
+        }
+        else
+        {
+            FreeIndexFields( pasCurFields, 1, false );
+            memset( pasCurFields, 0, sizeof(OGRField) * nOrderItems );
+        }
+    }
+
+    std::sort_heap(anHeap.begin(), anHeap.end(), oComparator);
+
+    bool bAlreadySorted = true;
+    if( !anHeap.empty() )
+    {
+        panFIDIndex = static_cast<GIntBig *>(
+            VSI_MALLOC_VERBOSE(sizeof(GIntBig) * anHeap.size()));
+    }
+    if( panFIDIndex != NULL )
+    {
+        nIndexSize = anHeap.size();
+        for( size_t i = 0; i < nIndexSize; i++ )
+        {
+            if( anSeq[anHeap[i]] != static_cast<GIntBig>(i) )
+                bAlreadySorted = false;
+            panFIDIndex[i] = anFID[anHeap[i]];
+        }
+    }
+
+    FreeIndexFields( pasIndexFields, nTopN + 1 );
 
-        if( poFDefn->GetType() == OFTString )
-        {
-            for( size_t i = 0; i < l_nIndexSize; i++ )
-            {
-                OGRField *psField = pasIndexFields + iKey + i * nOrderItems;
+    // See CreateOrderByIndex()
+    if( bAlreadySorted )
+    {
+        CPLFree( panFIDIndex );
+        panFIDIndex = NULL;
 
-                if( !OGR_RawField_IsUnset(psField) &&
-                    !OGR_RawField_IsNull(psField) )
-                    CPLFree( psField->String );
-            }
-        }
+        nIndexSize = 0;
     }
 
-    if( bFreeArray )
-        VSIFree(pasIndexFields);
+    ResetReading();
 }
 
 /************************************************************************/
-/*                         ReadIndexFields()                            */
+/*                           WriteSortRun()                             */
+/*                                                                      */
+/*      Sort the key values read so far, and append them to the file   */
+/*      of sorted runs.                                                 */
 /************************************************************************/
 
-void OGRGenSQLResultsLayer::ReadIndexFields( OGRFeature* poSrcFeat,
-                                             int nOrderItems,
-                                             OGRField *pasIndexFields )
+bool OGRGenSQLResultsLayer::WriteSortRun( const OGRField *pasIndexFields,
+                                          const GIntBig *panFIDList,
+                                          size_t nEntries, GIntBig nSeqBase,
+                                          const std::vector<int>& anKeyKinds,
+                                          VSILFILE* fp,
+                                          CPLWorkerThreadPool* poPool )
 {
-    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
-    for( int iKey = 0; iKey < nOrderItems; iKey++ )
-    {
-        const swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
-        OGRField *psDstField = pasIndexFields + iKey;
-
-        if ( psKeyDef->field_index >= iFIDFieldIndex)
-        {
-            CPLAssert( psKeyDef->field_index <
-                                iFIDFieldIndex + SPECIAL_FIELD_COUNT );
+    const int nOrderItems = static_cast<int>(anKeyKinds.size());
 
-            switch (SpecialFieldTypes[
-                            psKeyDef->field_index - iFIDFieldIndex])
-            {
-                case SWQ_INTEGER:
-                case SWQ_INTEGER64:
-                // Yes, store Integer as Integer64.
-                // This is consistent with the test in Compare()
-                psDstField->Integer64 =
-                    poSrcFeat->GetFieldAsInteger64(
-                        psKeyDef->field_index);
-                break;
+    panFIDIndex = (GIntBig *) VSI_MALLOC_VERBOSE(sizeof(GIntBig) * nEntries);
+    if( panFIDIndex == NULL )
+        return false;
+    for( size_t i = 0; i < nEntries; i++ )
+        panFIDIndex[i] = static_cast<GIntBig>(i);
 
-                case SWQ_FLOAT:
-                psDstField->Real =
-                    poSrcFeat->GetFieldAsDouble(psKeyDef->field_index);
-                break;
+    bool bOK = SortIndex( pasIndexFields, nEntries, poPool );
 
-                default:
-                psDstField->String = CPLStrdup(
-                    poSrcFeat->GetFieldAsString(
-                        psKeyDef->field_index) );
-                break;
+    std::vector<GByte> abyBuffer;
+    for( size_t i = 0; bOK && i < nEntries; i++ )
+    {
+        const size_t iEntry = static_cast<size_t>(panFIDIndex[i]);
+        OGRGenSQLSerializeIndexFields( anKeyKinds,
+                                       pasIndexFields + iEntry * nOrderItems,
+                                       panFIDList[iEntry], nSeqBase + iEntry,
+                                       abyBuffer );
+        if( abyBuffer.size() >= 1024 * 1024 || i + 1 == nEntries )
+        {
+            if( VSIFWriteL(&abyBuffer[0], 1, abyBuffer.size(), fp) !=
+                                                            abyBuffer.size() )
+            {
+                CPLError(CE_Failure, CPLE_FileIO,
+                         "Cannot write sorted run to temporary file");
+                bOK = false;
             }
-
-            continue;
-        }
-
-        OGRFieldDefn *poFDefn = poSrcLayer->GetLayerDefn()->GetFieldDefn(
-            psKeyDef->field_index );
-
-        OGRField *psSrcField =
-            poSrcFeat->GetRawFieldRef( psKeyDef->field_index );
-
-        if( poFDefn->GetType() == OFTInteger
-            || poFDefn->GetType() == OFTInteger64
-            || poFDefn->GetType() == OFTReal
-            || poFDefn->GetType() == OFTDate
-            || poFDefn->GetType() == OFTTime
-            || poFDefn->GetType() == OFTDateTime)
-            memcpy( psDstField, psSrcField, sizeof(OGRField) );
-        else if( poFDefn->GetType() == OFTString )
-        {
-            if( poSrcFeat->IsFieldSetAndNotNull( psKeyDef->field_index ) )
-                psDstField->String = CPLStrdup( psSrcField->String );
-            else
-                memcpy( psDstField, psSrcField, sizeof(OGRField) );
+            abyBuffer.resize(0);
         }
     }
+
+    CPLFree( panFIDIndex );
+    panFIDIndex = NULL;
+    return bOK;
 }
 
 /************************************************************************/
@@ -1906,12 +3071,15 @@ void OGRGenSQLResultsLayer::ReadIndexFields( OGRFeature* poSrcFeat,
 /*                                                                      */
 /*      This is accomplished by making one pass through all the         */
 /*      eligible source features, and capturing the order by fields     */
-/*      of all records in memory.  A quick sort is then applied to      */
+/*      of all records in memory.  A merge sort is then applied to      */
 /*      this in memory copy of the order-by fields to create the        */
 /*      required index.                                                 */
 /*                                                                      */
-/*      Keeping all the key values in memory will *not* scale up to     */
-/*      very large input datasets.                                      */
+/*      When the key values take more than OGR_SQL_SORT_MAX_MEMORY,     */
+/*      they are sorted by runs written to a temporary file, that are   */
+/*      merged at the end, so that only the resulting index of FIDs is  */
+/*      kept in memory.  With a LIMIT, only the OFFSET+LIMIT first key  */
+/*      values are kept.                                                */
 /************************************************************************/
 
 void OGRGenSQLResultsLayer::CreateOrderByIndex()
@@ -1932,49 +3100,95 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
 
     ResetReading();
 
+    const GIntBig nMaxMemory = static_cast<GIntBig>(
+        std::max(0.0, CPLAtof(CPLGetConfigOption("OGR_SQL_SORT_MAX_MEMORY",
+                                                 "100"))) * 1024 * 1024);
+    // Key values, FID, index and merge buffer.
+    const size_t nRecordSize =
+        sizeof(OGRField) * nOrderItems + 3 * sizeof(GIntBig);
+
 /* -------------------------------------------------------------------- */
-/*      Optimize (memory-wise) ORDER BY ... LIMIT 1 [OFFSET 0] case.    */
+/*      Optimize ORDER BY ... LIMIT, if the first OFFSET+LIMIT key      */
+/*      values fit in memory.                                           */
 /* -------------------------------------------------------------------- */
-    if( psSelectInfo->offset == 0 && psSelectInfo->limit == 1 )
+    GIntBig nTopN = -1;
+    if( psSelectInfo->limit >= 0 &&
+        psSelectInfo->offset <= GINTBIG_MAX - psSelectInfo->limit )
     {
-        OGRFeature* poSrcFeat = poSrcLayer->GetNextFeature();
-        if( poSrcFeat == NULL )
-        {
-            panFIDIndex = NULL;
-            nIndexSize = 0;
-            return;
-        }
+        nTopN = psSelectInfo->offset + psSelectInfo->limit;
+    }
+    if( nTopN >= 0 &&
+        nTopN <= nMaxMemory / static_cast<GIntBig>(nRecordSize) )
+    {
+        CreateTopNOrderByIndex( static_cast<size_t>(nTopN) );
+        return;
+    }
 
-        OGRField *pasCurrentFields = static_cast<OGRField *>(
-                                    CPLCalloc(sizeof(OGRField), nOrderItems));
-        OGRField *pasBestFields = static_cast<OGRField *>(
-                                    CPLCalloc(sizeof(OGRField), nOrderItems));
-        GIntBig nBestFID = poSrcFeat->GetFID();
-        ReadIndexFields( poSrcFeat, nOrderItems, pasBestFields);
-        delete poSrcFeat;
-        while( (poSrcFeat = poSrcLayer->GetNextFeature()) != NULL )
+/* -------------------------------------------------------------------- */
+/*      Determine how key values are stored, to estimate their memory   */
+/*      usage and to write them in sorted runs.                         */
+/* -------------------------------------------------------------------- */
+    std::vector<int> anKeyKinds;
+    for( int iKey = 0; iKey < nOrderItems; iKey++ )
+    {
+        const swq_order_def *psKeyDef = psSelectInfo->order_defs + iKey;
+        int nKind = OGR_SORT_KEY_OTHER;
+        if( psKeyDef->field_index >= iFIDFieldIndex )
         {
-            ReadIndexFields( poSrcFeat, nOrderItems, pasCurrentFields);
-            if( Compare( pasCurrentFields, pasBestFields ) < 0 )
+            switch( SpecialFieldTypes[psKeyDef->field_index - iFIDFieldIndex] )
             {
-                nBestFID = poSrcFeat->GetFID();
-                FreeIndexFields( pasBestFields, 1, false);
-                memcpy( pasBestFields, pasCurrentFields,
-                        sizeof(OGRField) * nOrderItems );
+              case SWQ_INTEGER:
+              case SWQ_INTEGER64:
+                nKind = OGR_SORT_KEY_INTEGER64;
+                break;
+              case SWQ_FLOAT:
+                nKind = OGR_SORT_KEY_REAL;
+                break;
+              default:
+                nKind = OGR_SORT_KEY_SPECIAL_STRING;
+                break;
             }
-            else
+        }
+        else
+        {
+            switch( poSrcLayer->GetLayerDefn()->GetFieldDefn(
+                                        psKeyDef->field_index )->GetType() )
             {
-                FreeIndexFields( pasCurrentFields, 1, false);
+              case OFTInteger:
+                nKind = OGR_SORT_KEY_INTEGER;
+                break;
+              case OFTInteger64:
+                nKind = OGR_SORT_KEY_INTEGER64;
+                break;
+              case OFTReal:
+                nKind = OGR_SORT_KEY_REAL;
+                break;
+              case OFTString:
+                nKind = OGR_SORT_KEY_STRING;
+                break;
+              case OFTDate:
+              case OFTTime:
+              case OFTDateTime:
+                nKind = OGR_SORT_KEY_DATE;
+                break;
+              default:
+                break;
             }
-            memset( pasCurrentFields, 0, sizeof(OGRField) * nOrderItems );
-            delete poSrcFeat;
         }
-        VSIFree( pasCurrentFields );
-        FreeIndexFields( pasBestFields, 1 );
-        panFIDIndex = static_cast<GIntBig *>(CPLMalloc(sizeof(GIntBig)));
-        panFIDIndex[0] = nBestFID;
-        nIndexSize = 1;
-        return;
+        anKeyKinds.push_back(nKind);
+    }
+
+    CPLWorkerThreadPool* poPool = NULL;
+    const int nThreads = CPLGetNumThreadsOption("OGR_SQL_SORT_NUM_THREADS",
+                            CPLGetNumThreadsOption("GDAL_NUM_THREADS", 1));
+    if( nThreads > 1 )
+    {
+        poPool = new CPLWorkerThreadPool();
+        if( !poPool->Setup(nThreads, NULL, NULL) )
+        {
+            delete poPool;
+            poPool = NULL;
+        }
     }
 
 /* -------------------------------------------------------------------- */
@@ -1988,13 +3202,20 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
     GIntBig *panFIDList = static_cast<GIntBig *>(
         CPLMalloc(sizeof(GIntBig) * nFeaturesAlloc));
 
+    CPLString osRunsFilename;
+    VSILFILE* fpRuns = NULL;
+    std::vector<vsi_l_offset> anRunOffsets;
+    GIntBig nSeqBase = 0;
+    GIntBig nMemoryUsage = 0;
+    bool bOK = true;
+
 /* -------------------------------------------------------------------- */
 /*      Read in all the key values.                                     */
 /* -------------------------------------------------------------------- */
     OGRFeature *poSrcFeat = NULL;
     nIndexSize = 0;
 
-    while( (poSrcFeat = poSrcLayer->GetNextFeature()) != NULL )
+    while( bOK && (poSrcFeat = poSrcLayer->GetNextFeature()) != NULL )
     {
         if (nIndexSize == nFeaturesAlloc)
         {
@@ -2008,11 +3229,9 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
             {
                 CPLError(CE_Failure, CPLE_AppDefined,
                          "Cannot allocate pasIndexFields");
-                FreeIndexFields( pasIndexFields, nIndexSize );
-                VSIFree(panFIDList);
-                nIndexSize = 0;
                 delete poSrcFeat;
-                return;
+                bOK = false;
+                break;
             }
             OGRField* pasNewIndexFields = (OGRField *)
                 VSI_REALLOC_VERBOSE(pasIndexFields,
@@ -2022,11 +3241,9 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
             {
                 CPLError(CE_Failure, CPLE_AppDefined,
                          "Cannot allocate pasIndexFields");
-                FreeIndexFields( pasIndexFields, nIndexSize );
-                VSIFree(panFIDList);
-                nIndexSize = 0;
                 delete poSrcFeat;
-                return;
+                bOK = false;
+                break;
             }
             pasIndexFields = pasNewIndexFields;
 
@@ -2035,78 +3252,222 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
                                     static_cast<size_t>(nNewFeaturesAlloc));
             if (panNewFIDList == NULL)
             {
-                FreeIndexFields( pasIndexFields, nIndexSize );
-                VSIFree(panFIDList);
-                nIndexSize = 0;
                 delete poSrcFeat;
-                return;
+                bOK = false;
+                break;
             }
             panFIDList = panNewFIDList;
 
-            memset(pasIndexFields + nFeaturesAlloc, 0,
+            memset(pasIndexFields + nFeaturesAlloc * nOrderItems, 0,
                    sizeof(OGRField) * nOrderItems *
                    static_cast<size_t>(nNewFeaturesAlloc - nFeaturesAlloc));
 
             nFeaturesAlloc = static_cast<size_t>(nNewFeaturesAlloc);
         }
 
-        ReadIndexFields( poSrcFeat, nOrderItems,
-                         pasIndexFields + nIndexSize * nOrderItems );
+        OGRField* pasCurFields = pasIndexFields + nIndexSize * nOrderItems;
+        ReadIndexFields( poSrcFeat, nOrderItems, pasCurFields );
 
         panFIDList[nIndexSize] = poSrcFeat->GetFID();
         delete poSrcFeat;
 
         nIndexSize++;
+
+        nMemoryUsage += nRecordSize;
+        for( int iKey = 0; iKey < nOrderItems; iKey++ )
+        {
+            if( anKeyKinds[iKey] == OGR_SORT_KEY_SPECIAL_STRING ||
+                (anKeyKinds[iKey] == OGR_SORT_KEY_STRING &&
+                 !OGR_RawField_IsUnset(&pasCurFields[iKey]) &&
+                 !OGR_RawField_IsNull(&pasCurFields[iKey])) )
+            {
+                nMemoryUsage += strlen(pasCurFields[iKey].String) + 1;
+            }
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Spill a sorted run to disk if the memory limit is reached.      */
+/* -------------------------------------------------------------------- */
+        if( nMemoryUsage > nMaxMemory && nIndexSize >= 100 )
+        {
+            if( fpRuns == NULL )
+            {
+                osRunsFilename = CPLGenerateTempFilename("ogr_sql_sort");
+                fpRuns = VSIFOpenL(osRunsFilename, "wb+");
+                if( fpRuns == NULL )
+                {
+                    CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s",
+                             osRunsFilename.c_str());
+                    bOK = false;
+                    break;
+                }
+                CPLDebug("GenSQL", "Writing sorted runs to %s",
+                         osRunsFilename.c_str());
+                anRunOffsets.push_back(0);
+            }
+            bOK = WriteSortRun( pasIndexFields, panFIDList, nIndexSize,
+                                nSeqBase, anKeyKinds, fpRuns, poPool );
+            anRunOffsets.push_back(VSIFTellL(fpRuns));
+
+            FreeIndexFields( pasIndexFields, nIndexSize, false );
+            memset( pasIndexFields, 0,
+                    sizeof(OGRField) * nOrderItems * nIndexSize );
+            nSeqBase += nIndexSize;
+            nIndexSize = 0;
+            nMemoryUsage = 0;
+        }
     }
 
     //CPLDebug("GenSQL", "CreateOrderByIndex() = %d features", nIndexSize);
 
+    bool bAlreadySorted = true;
+
 /* -------------------------------------------------------------------- */
-/*      Initialize panFIDIndex                                          */
+/*      Merge the sorted runs (including the remaining key values).     */
 /* -------------------------------------------------------------------- */
-    panFIDIndex = (GIntBig *) VSI_MALLOC_VERBOSE(sizeof(GIntBig) * nIndexSize);
-    if( panFIDIndex == NULL )
+    if( fpRuns != NULL )
     {
+        if( bOK && nIndexSize > 0 )
+        {
+            bOK = WriteSortRun( pasIndexFields, panFIDList, nIndexSize,
+                                nSeqBase, anKeyKinds, fpRuns, poPool );
+            anRunOffsets.push_back(VSIFTellL(fpRuns));
+        }
         FreeIndexFields( pasIndexFields, nIndexSize );
-        VSIFree(panFIDList);
+        VSIFree( panFIDList );
+        pasIndexFields = NULL;
+        panFIDList = NULL;
         nIndexSize = 0;
-        return;
+
+        const size_t nRuns = anRunOffsets.size() - 1;
+        CPLDebug("GenSQL", "Merging %d sorted runs", static_cast<int>(nRuns));
+        std::vector<OGRGenSQLSortRunReader> aoRuns;
+        OGRField *pasRunFields = static_cast<OGRField *>(
+            CPLCalloc(sizeof(OGRField), nOrderItems * nRuns));
+        std::vector<GIntBig> anRunFID(nRuns);
+        std::vector<GIntBig> anRunSeq(nRuns);
+        std::vector<bool> abRunValid(nRuns);
+        for( size_t iRun = 0; bOK && iRun < nRuns; iRun++ )
+        {
+            aoRuns.push_back( OGRGenSQLSortRunReader(
+                fpRuns, anRunOffsets[iRun], anRunOffsets[iRun + 1]) );
+            size_t nSize = 0;
+            const GByte* pabyRecord = aoRuns.back().Next(nSize);
+            bOK = pabyRecord != NULL &&
+                  OGRGenSQLDeserializeIndexFields(anKeyKinds, pabyRecord, nSize,
+                                        pasRunFields + iRun * nOrderItems,
+                                        anRunFID[iRun], anRunSeq[iRun]);
+            abRunValid[iRun] = bOK;
+        }
+
+        size_t nIndexAlloc = 0;
+        while( bOK && (nTopN < 0 || static_cast<GIntBig>(nIndexSize) < nTopN) )
+        {
+            // Runs are contiguous sections of the source layer, so picking
+            // the first run for equal keys preserves the stability of the
+            // sort.
+            size_t iBestRun = nRuns;
+            for( size_t iRun = 0; iRun < nRuns; iRun++ )
+            {
+                if( abRunValid[iRun] &&
+                    (iBestRun == nRuns ||
+                     Compare( pasRunFields + iRun * nOrderItems,
+                              pasRunFields + iBestRun * nOrderItems ) < 0) )
+                {
+                    iBestRun = iRun;
+                }
+            }
+            if( iBestRun == nRuns )
+                break;
+
+            if( nIndexSize == nIndexAlloc )
+            {
+                nIndexAlloc = nIndexAlloc + nIndexAlloc / 3 + 100;
+                GIntBig* panNewFIDIndex = (GIntBig *)
+                    VSI_REALLOC_VERBOSE(panFIDIndex,
+                                        sizeof(GIntBig) * nIndexAlloc);
+                if( panNewFIDIndex == NULL )
+                {
+                    bOK = false;
+                    break;
+                }
+                panFIDIndex = panNewFIDIndex;
+            }
+            if( anRunSeq[iBestRun] != static_cast<GIntBig>(nIndexSize) )
+                bAlreadySorted = false;
+            panFIDIndex[nIndexSize++] = anRunFID[iBestRun];
+
+            OGRField* pasCurFields = pasRunFields + iBestRun * nOrderItems;
+            FreeIndexFields( pasCurFields, 1, false );
+            memset( pasCurFields, 0, sizeof(OGRField) * nOrderItems );
+            abRunValid[iBestRun] = false;
+            if( !aoRuns[iBestRun].IsEOF() )
+            {
+                size_t nSize = 0;
+                const GByte* pabyRecord = aoRuns[iBestRun].Next(nSize);
+                bOK = pabyRecord != NULL &&
+                      OGRGenSQLDeserializeIndexFields(anKeyKinds, pabyRecord,
+                                        nSize, pasCurFields,
+                                        anRunFID[iBestRun],
+                                        anRunSeq[iBestRun]);
+                abRunValid[iBestRun] = bOK;
+            }
+        }
+        if( !bOK )
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "Cannot merge sorted runs of temporary file");
+        }
+
+        FreeIndexFields( pasRunFields, nRuns );
+        VSIFCloseL( fpRuns );
+        VSIUnlink( osRunsFilename );
     }
-    for( size_t i = 0; i < nIndexSize; i++ )
-        panFIDIndex[i] = static_cast<GIntBig>(i);
 
 /* -------------------------------------------------------------------- */
-/*      Quick sort the records.                                         */
+/*      Otherwise sort the key values in memory.                        */
 /* -------------------------------------------------------------------- */
-
-    GIntBig *panMerged = (GIntBig *)
-        VSI_MALLOC_VERBOSE( sizeof(GIntBig) * nIndexSize );
-    if( panMerged == NULL )
+    else if( bOK )
     {
+        panFIDIndex = (GIntBig *)
+            VSI_MALLOC_VERBOSE(sizeof(GIntBig) * std::max(nIndexSize,
+                                                      static_cast<size_t>(1)));
+        bOK = panFIDIndex != NULL;
+        for( size_t i = 0; bOK && i < nIndexSize; i++ )
+            panFIDIndex[i] = static_cast<GIntBig>(i);
+
+        if( bOK )
+            bOK = SortIndex( pasIndexFields, nIndexSize, poPool );
+
         FreeIndexFields( pasIndexFields, nIndexSize );
-        VSIFree(panFIDList);
-        nIndexSize = 0;
-        VSIFree(panFIDIndex);
-        panFIDIndex = NULL;
-        return;
-    }
+        pasIndexFields = NULL;
 
-    SortIndexSection( pasIndexFields, panMerged, 0, nIndexSize );
-    VSIFree( panMerged );
+        if( bOK && nTopN >= 0 && static_cast<GIntBig>(nIndexSize) > nTopN )
+            nIndexSize = static_cast<size_t>(nTopN);
 
 /* -------------------------------------------------------------------- */
 /*      Rework the FID map to map to real FIDs.                         */
 /* -------------------------------------------------------------------- */
-    bool bAlreadySorted = true;
-    for( size_t i = 0; i < nIndexSize; i++ )
-    {
-        if (panFIDIndex[i] != static_cast<GIntBig>(i))
-            bAlreadySorted = false;
-        panFIDIndex[i] = panFIDList[panFIDIndex[i]];
+        for( size_t i = 0; bOK && i < nIndexSize; i++ )
+        {
+            if (panFIDIndex[i] != static_cast<GIntBig>(i))
+                bAlreadySorted = false;
+            panFIDIndex[i] = panFIDList[panFIDIndex[i]];
+        }
     }
 
+    if( pasIndexFields != NULL )
+        FreeIndexFields( pasIndexFields, nIndexSize );
     CPLFree( panFIDList );
-    FreeIndexFields( pasIndexFields, nIndexSize );
+    delete poPool;
+
+    if( !bOK )
+    {
+        CPLFree( panFIDIndex );
+        panFIDIndex = NULL;
+        nIndexSize = 0;
+        return;
+    }
 
     /* If it is already sorted, then free than panFIDIndex array */
     /* so that GetNextFeature() can call a sequential GetNextFeature() */
@@ -2125,7 +3486,118 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
 }
 
 /************************************************************************/
-/*                          SortIndexSection()                          */
+/*                            SortIndexJob()                            */
+/************************************************************************/
+
+typedef struct
+{
+    OGRGenSQLResultsLayer *poLayer;
+    const OGRField        *pasIndexFields;
+    GIntBig               *panMerged;
+    size_t                 nStart;
+    size_t                 nFirstGroup;
+    size_t                 nSecondGroup;
+} OGRGenSQLSortJob;
+
+void OGRGenSQLResultsLayer::SortIndexJob( void* pData )
+{
+    OGRGenSQLSortJob* psJob = static_cast<OGRGenSQLSortJob*>(pData);
+    if( psJob->nSecondGroup == 0 )
+        psJob->poLayer->SortIndexSection( psJob->pasIndexFields,
+                                          psJob->panMerged,
+                                          psJob->nStart, psJob->nFirstGroup );
+    else
+        psJob->poLayer->MergeIndexSections( psJob->pasIndexFields,
+                                            psJob->panMerged, psJob->nStart,
+                                            psJob->nFirstGroup,
+                                            psJob->nSecondGroup );
+}
+
+/************************************************************************/
+/*                              SortIndex()                             */
+/*                                                                      */
+/*      Sort the first nEntries of panFIDIndex.  With a thread pool,    */
+/*      sections are sorted in parallel, and then merged pairwise in    */
+/*      parallel.                                                       */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::SortIndex( const OGRField *pasIndexFields,
+                                       size_t nEntries,
+                                       CPLWorkerThreadPool* poPool )
+{
+    GIntBig *panMerged = (GIntBig *)
+        VSI_MALLOC_VERBOSE( sizeof(GIntBig) * std::max(nEntries,
+                                                   static_cast<size_t>(1)) );
+    if( panMerged == NULL )
+        return false;
+
+    const size_t nMinEntriesPerThread = 10000;
+    const size_t nSections = poPool == NULL ? 1 :
+        std::min(static_cast<size_t>(poPool->GetThreadCount()),
+                 nEntries / nMinEntriesPerThread);
+    if( nSections <= 1 )
+    {
+        SortIndexSection( pasIndexFields, panMerged, 0, nEntries );
+        VSIFree( panMerged );
+        return true;
+    }
+
+    std::vector<size_t> anStarts;
+    for( size_t i = 0; i <= nSections; i++ )
+        anStarts.push_back( nEntries / nSections * i +
+                            (i == nSections ? nEntries % nSections : 0) );
+
+    std::vector<OGRGenSQLSortJob> asJobs(nSections);
+    std::vector<void*> apJobs;
+    for( size_t i = 0; i < nSections; i++ )
+    {
+        asJobs[i].poLayer = this;
+        asJobs[i].pasIndexFields = pasIndexFields;
+        asJobs[i].panMerged = panMerged;
+        asJobs[i].nStart = anStarts[i];
+        asJobs[i].nFirstGroup = anStarts[i + 1] - anStarts[i];
+        asJobs[i].nSecondGroup = 0;
+        apJobs.push_back(&asJobs[i]);
+    }
+    poPool->SubmitJobs(SortIndexJob, apJobs);
+    poPool->WaitCompletion();
+
+    while( anStarts.size() > 2 )
+    {
+        std::vector<size_t> anNewStarts;
+        asJobs.resize(0);
+        for( size_t i = 0; i + 1 < anStarts.size(); i += 2 )
+        {
+            anNewStarts.push_back(anStarts[i]);
+            if( i + 2 < anStarts.size() )
+            {
+                OGRGenSQLSortJob sJob;
+                sJob.poLayer = this;
+                sJob.pasIndexFields = pasIndexFields;
+                sJob.panMerged = panMerged;
+                sJob.nStart = anStarts[i];
+                sJob.nFirstGroup = anStarts[i + 1] - anStarts[i];
+                sJob.nSecondGroup = anStarts[i + 2] - anStarts[i + 1];
+                asJobs.push_back(sJob);
+            }
+        }
+        anNewStarts.push_back(nEntries);
+
+        apJobs.resize(0);
+        for( size_t i = 0; i < asJobs.size(); i++ )
+            apJobs.push_back(&asJobs[i]);
+        poPool->SubmitJobs(SortIndexJob, apJobs);
+        poPool->WaitCompletion();
+
+        anStarts = anNewStarts;
+    }
+
+    VSIFree( panMerged );
+    return true;
+}
+
+/************************************************************************/
+/*                           SortIndexSection()                         */
 /*                                                                      */
 /*      Sort the records in a section of the index.                     */
 /************************************************************************/
@@ -2138,9 +3610,6 @@ void OGRGenSQLResultsLayer::SortIndexSection( const OGRField *pasIndexFields,
     if( nEntries < 2 )
         return;
 
-    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
-    const int   nOrderItems = psSelectInfo->order_specs;
-
     size_t nFirstGroup = nEntries / 2;
     size_t nFirstStart = nStart;
     size_t nSecondGroup = nEntries - nFirstGroup;
@@ -2151,6 +3620,30 @@ void OGRGenSQLResultsLayer::SortIndexSection( const OGRField *pasIndexFields,
     SortIndexSection( pasIndexFields, panMerged, nSecondStart,
                       nSecondGroup );
 
+    MergeIndexSections( pasIndexFields, panMerged, nStart,
+                        nFirstGroup, nSecondGroup );
+}
+
+/************************************************************************/
+/*                         MergeIndexSections()                         */
+/*                                                                      */
+/*      Merge two consecutive sorted sections of the index.             */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::MergeIndexSections( const OGRField *pasIndexFields,
+                                                GIntBig *panMerged,
+                                                size_t nStart,
+                                                size_t nFirstGroup,
+                                                size_t nSecondGroup )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+    const int   nOrderItems = psSelectInfo->order_specs;
+
+    const size_t nEntries = nFirstGroup + nSecondGroup;
+    size_t nFirstStart = nStart;
+    size_t nSecondStart = nStart + nFirstGroup;
+
     for( size_t iMerge = 0; iMerge < nEntries; ++iMerge )
     {
         int  nResult = 0;
@@ -2167,20 +3660,21 @@ void OGRGenSQLResultsLayer::SortIndexSection( const OGRField *pasIndexFields,
 
         if( nResult > 0 )
         {
-            panMerged[iMerge] = panFIDIndex[nSecondStart];
+            panMerged[nStart + iMerge] = panFIDIndex[nSecondStart];
             nSecondStart++;
             nSecondGroup--;
         }
         else
         {
-            panMerged[iMerge] = panFIDIndex[nFirstStart];
+            panMerged[nStart + iMerge] = panFIDIndex[nFirstStart];
             nFirstStart++;
             nFirstGroup--;
         }
     }
 
     /* Copy the merge list back into the main index */
-    memcpy( panFIDIndex + nStart, panMerged, sizeof(GIntBig) * nEntries );
+    memcpy( panFIDIndex + nStart, panMerged + nStart,
+            sizeof(GIntBig) * nEntries );
 }
 
 /************************************************************************/
@@ -50,6 +50,9 @@
 #define ALL_FIELD_INDEX_TO_GEOM_FIELD_INDEX(poFDefn, idx) \
     ((idx) - ((poFDefn)->GetFieldCount() + SPECIAL_FIELD_COUNT))
 
+class OGRGenSQLJoinHashTable;
+class CPLWorkerThreadPool;
+
 /************************************************************************/
 /*                        OGRGenSQLResultsLayer                         */
 /************************************************************************/
@@ -84,9 +87,13 @@ class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
     GIntBig     nIteratedFeatures;
     std::vector<CPLString> m_oDistinctList;
 
+    bool        m_bJoinHashTablesInitialized;
+    std::vector<OGRGenSQLJoinHashTable*> m_apoJoinHashTables;
+
     int         PrepareSummary();
 
     OGRFeature *TranslateFeature( OGRFeature * );
+    void        InitJoinHashTables();
     void        CreateOrderByIndex();
     void        ReadIndexFields( OGRFeature* poSrcFeat,
                                  int nOrderItems,
@@ -94,10 +101,23 @@ class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
     void        SortIndexSection( const OGRField *pasIndexFields,
                                   GIntBig *panMerged,
                                   size_t nStart, size_t nEntries );
+    void        MergeIndexSections( const OGRField *pasIndexFields,
+                                    GIntBig *panMerged, size_t nStart,
+                                    size_t nFirstGroup, size_t nSecondGroup );
+    bool        SortIndex( const OGRField *pasIndexFields, size_t nEntries,
+                           CPLWorkerThreadPool* poPool );
+    static void SortIndexJob( void* pData );
+    void        CreateTopNOrderByIndex( size_t nTopN );
+    bool        WriteSortRun( const OGRField *pasIndexFields,
+                              const GIntBig *panFIDList,
+                              size_t nEntries, GIntBig nSeqBase,
+                              const std::vector<int>& anKeyKinds,
+                              VSILFILE* fp, CPLWorkerThreadPool* poPool );
     void        FreeIndexFields(OGRField *pasIndexFields,
                                 size_t l_nIndexSize,
                                 bool bFreeArray = true);
     int         Compare( const OGRField *pasFirst, const OGRField *pasSecond );
+    friend class OGRGenSQLTopNComparator;
 
     void        ClearFilters();
     void        ApplyFiltersToSource();
@@ -44,6 +44,7 @@ OGRLayer::OGRLayer() :
     m_bFilterIsEnvelope(FALSE),
     m_poFilterGeom(NULL),
     m_pPreparedFilterGeom(NULL),
+    m_poIndexedFilterGeom(NULL),
     m_iGeomFieldFilter(0),
     m_poStyleTable(NULL),
     m_poAttrQuery(NULL),
@@ -91,6 +92,9 @@ OGRLayer::~OGRLayer()
         OGRDestroyPreparedGeometry(m_pPreparedFilterGeom);
         m_pPreparedFilterGeom = NULL;
     }
+
+    delete m_poIndexedFilterGeom;
+    m_poIndexedFilterGeom = NULL;
 }
 
 /************************************************************************/
@@ -549,6 +553,51 @@ OGRFeatureH OGR_L_GetNextFeature( OGRLayerH hLayer )
     return (OGRFeatureH) ((OGRLayer *)hLayer)->GetNextFeature();
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                   int nMaxFeatures )
+
+{
+    poBatch->Reset();
+
+    if( !poBatch->IsCompatibleWith(GetLayerDefn()) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Batch not created from the current layer definition" );
+        return 0;
+    }
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        OGRFeature *poFeature = GetNextFeature();
+        if( poFeature == NULL )
+            break;
+
+        poBatch->AddFeature( poFeature );
+        delete poFeature;
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
+/************************************************************************/
+/*                     OGR_L_GetNextFeatureBatch()                      */
+/************************************************************************/
+
+int OGR_L_GetNextFeatureBatch( OGRLayerH hLayer, OGRFeatureBatchH hBatch,
+                               int nMaxFeatures )
+
+{
+    VALIDATE_POINTER1( hLayer, "OGR_L_GetNextFeatureBatch", 0 );
+    VALIDATE_POINTER1( hBatch, "OGR_L_GetNextFeatureBatch", 0 );
+
+    return ((OGRLayer *)hLayer)->GetNextFeatureBatch(
+        (OGRFeatureBatch *)hBatch, nMaxFeatures );
+}
+
 /************************************************************************/
 /*                       ConvertGeomsIfNecessary()                      */
 /************************************************************************/
@@ -1244,6 +1293,53 @@ void OGR_L_SetSpatialFilterRectEx( OGRLayerH hLayer,
                                                  dfMaxX, dfMaxY );
 }
 
+/************************************************************************/
+/*                       OGRLayerIsRectangle()                          */
+/*                                                                      */
+/*      Test if a filter geometry is an axis aligned rectangle.         */
+/************************************************************************/
+
+static bool OGRLayerIsRectangle( const OGRGeometry* poFilter )
+
+{
+    if( wkbFlatten(poFilter->getGeometryType()) != wkbPolygon )
+        return false;
+
+    const OGRPolygon *poPoly = static_cast<const OGRPolygon *>(poFilter);
+
+    if( poPoly->getNumInteriorRings() != 0 )
+        return false;
+
+    const OGRLinearRing *poRing = poPoly->getExteriorRing();
+    if (poRing == NULL)
+        return false;
+
+    if( poRing->getNumPoints() > 5 || poRing->getNumPoints() < 4 )
+        return false;
+
+    // If the ring has 5 points, the last should be the first.
+    if( poRing->getNumPoints() == 5
+        && ( poRing->getX(0) != poRing->getX(4)
+             || poRing->getY(0) != poRing->getY(4) ) )
+        return false;
+
+    // Polygon with first segment in "y" direction.
+    if( poRing->getX(0) == poRing->getX(1)
+        && poRing->getY(1) == poRing->getY(2)
+        && poRing->getX(2) == poRing->getX(3)
+        && poRing->getY(3) == poRing->getY(0) )
+        return true;
+
+    // Polygon with first segment in "x" direction.
+    if( poRing->getY(0) == poRing->getY(1)
+        && poRing->getX(1) == poRing->getX(2)
+        && poRing->getY(2) == poRing->getY(3)
+        && poRing->getX(3) == poRing->getX(0) )
+        return true;
+
+    return false;
+}
+
 /************************************************************************/
 /*                           InstallFilter()                            */
 /*                                                                      */
@@ -1280,6 +1376,9 @@ int OGRLayer::InstallFilter( OGRGeometry * poFilter )
         m_pPreparedFilterGeom = NULL;
     }
 
+    delete m_poIndexedFilterGeom;
+    m_poIndexedFilterGeom = NULL;
+
     if( poFilter != NULL )
         m_poFilterGeom = poFilter->clone();
 
@@ -1291,46 +1390,28 @@ int OGRLayer::InstallFilter( OGRGeometry * poFilter )
     if( m_poFilterGeom != NULL )
         m_poFilterGeom->getEnvelope( &m_sFilterEnvelope );
 
-    /* Compile geometry filter as a prepared geometry */
-    m_pPreparedFilterGeom = OGRCreatePreparedGeometry(m_poFilterGeom);
-
 /* -------------------------------------------------------------------- */
 /*      Now try to determine if the filter is really a rectangle.       */
 /* -------------------------------------------------------------------- */
-    if( wkbFlatten(m_poFilterGeom->getGeometryType()) != wkbPolygon )
-        return TRUE;
-
-    OGRPolygon *poPoly = (OGRPolygon *) m_poFilterGeom;
+    m_bFilterIsEnvelope = OGRLayerIsRectangle( m_poFilterGeom );
 
-    if( poPoly->getNumInteriorRings() != 0 )
-        return TRUE;
-
-    OGRLinearRing *poRing = poPoly->getExteriorRing();
-    if (poRing == NULL)
-        return TRUE;
-
-    if( poRing->getNumPoints() > 5 || poRing->getNumPoints() < 4 )
-        return TRUE;
-
-    // If the ring has 5 points, the last should be the first.
-    if( poRing->getNumPoints() == 5
-        && ( poRing->getX(0) != poRing->getX(4)
-             || poRing->getY(0) != poRing->getY(4) ) )
+/* -------------------------------------------------------------------- */
+/*      Compile geometry filter as a prepared geometry.  Rectangles     */
+/*      are better tested directly than through GEOS.  Without GEOS,    */
+/*      the filter is indexed so as to still test intersections         */
+/*      exactly.                                                        */
+/* -------------------------------------------------------------------- */
+    if( m_bFilterIsEnvelope )
+    {
+        m_poIndexedFilterGeom =
+            OGRIndexedPreparedGeometry::Create( m_poFilterGeom, true );
         return TRUE;
+    }
 
-    // Polygon with first segment in "y" direction.
-    if( poRing->getX(0) == poRing->getX(1)
-        && poRing->getY(1) == poRing->getY(2)
-        && poRing->getX(2) == poRing->getX(3)
-        && poRing->getY(3) == poRing->getY(0) )
-        m_bFilterIsEnvelope = TRUE;
-
-    // Polygon with first segment in "x" direction.
-    if( poRing->getY(0) == poRing->getY(1)
-        && poRing->getX(1) == poRing->getX(2)
-        && poRing->getY(2) == poRing->getY(3)
-        && poRing->getX(3) == poRing->getX(0) )
-        m_bFilterIsEnvelope = TRUE;
+    m_pPreparedFilterGeom = OGRCreatePreparedGeometry(m_poFilterGeom);
+    if( m_pPreparedFilterGeom == NULL && !OGRGeometryFactory::haveGEOS() )
+        m_poIndexedFilterGeom =
+            OGRIndexedPreparedGeometry::Create( m_poFilterGeom );
 
     return TRUE;
 }
@@ -1439,9 +1520,17 @@ int OGRLayer::FilterGeometry( OGRGeometry *poGeometry )
         }
 
 /* -------------------------------------------------------------------- */
-/*      Fallback to full intersect test (using GEOS) if we still        */
-/*      don't know for sure.                                            */
+/*      Fallback to full intersect test if we still don't know for      */
+/*      sure: with the rectangle or the indexed filter geometry if      */
+/*      they can handle this geometry type, and otherwise using GEOS.   */
 /* -------------------------------------------------------------------- */
+        if( m_poIndexedFilterGeom != NULL )
+        {
+            const int nRet = m_poIndexedFilterGeom->Intersects( poGeometry );
+            if( nRet >= 0 )
+                return nRet;
+        }
+
         if( OGRGeometryFactory::haveGEOS() )
         {
             //CPLDebug("OGRLayer", "GEOS intersection");
@@ -1480,6 +1569,10 @@ void OGR_L_ResetReading( OGRLayerH hLayer )
 /*      This is only intended to be called by driver layer              */
 /*      implementations but we don't make it protected so that the      */
 /*      datasources can do it too if that is more appropriate.          */
+/*                                                                      */
+/*      Attribute indexes are B+-trees stored in a .oix file, unless    */
+/*      MapInfo style .idm/.ind indexes already exist for the file or   */
+/*      are requested with OGR_ATTRIBUTE_INDEX_FORMAT=MAPINFO.          */
 /************************************************************************/
 
 //! @cond Doxygen_Suppress
@@ -1491,7 +1584,18 @@ OGRErr OGRLayer::InitializeIndexSupport( const char *pszFilename )
     if (m_poAttrIndex != NULL)
         return OGRERR_NONE;
 
-    m_poAttrIndex = OGRCreateDefaultLayerIndex();
+    VSIStatBufL sStat;
+    if( STARTS_WITH_CI(pszFilename, "<OGRMILayerAttrIndex>") ||
+        EQUAL(CPLGetConfigOption("OGR_ATTRIBUTE_INDEX_FORMAT", "BTREE"),
+              "MAPINFO") ||
+        VSIStatL(CPLResetExtension(pszFilename, "idm"), &sStat) == 0 )
+    {
+        m_poAttrIndex = OGRCreateDefaultLayerIndex();
+    }
+    else
+    {
+        m_poAttrIndex = OGRCreateBTreeLayerIndex();
+    }
 
     eErr = m_poAttrIndex->Initialize( pszFilename, this );
     if( eErr != OGRERR_NONE )
@@ -41,6 +41,7 @@
 #include "ogrgeojsonwriter.h"
 
 class OGRGeoJSONDataSource;
+class OGRGeoJSONReader;
 
 /************************************************************************/
 /*                           OGRGeoJSONLayer                            */
@@ -67,18 +68,38 @@ class OGRGeoJSONLayer : public OGRMemLayer
     virtual int         TestCapability( const char * pszCap ) override;
 
     virtual OGRErr      SyncToDisk() override;
+
+    virtual void        ResetReading() override;
+    virtual OGRFeature* GetNextFeature() override;
+    virtual OGRFeature* GetFeature( GIntBig nFID ) override;
+    virtual GIntBig     GetFeatureCount( int bForce = TRUE ) override;
+    virtual OGRErr      SetNextByIndex( GIntBig nIndex ) override;
     //
     // OGRGeoJSONLayer Interface
     //
     void SetFIDColumn( const char* pszFIDColumn );
     void AddFeature( OGRFeature* poFeature );
     void DetectGeometryType();
+    void SetStreamingReader( OGRGeoJSONReader* poReader,
+                             GIntBig nFeatureCount );
 
   private:
     OGRGeoJSONDataSource* poDS_;
     CPLString sFIDColumn_;
     bool bUpdated_;
     bool bOriginalIdModified_;
+
+    // Set when features are read from the file on demand rather than
+    // stored in the underlying memory layer.
+    OGRGeoJSONReader* poStreamingReader_;
+    GIntBig nStreamingFeatureCount_;
+
+    // Candidate features of the attribute filter, from attribute indexes.
+    bool bCheckedForMatchingFIDs_;
+    GIntBig* panMatchingFIDs_;
+    int iMatchingFID_;
+
+    void ClearMatchingFIDs();
 };
 
 /************************************************************************/
@@ -213,6 +234,9 @@ class OGRGeoJSONDataSource : public OGRDataSource
     void Clear();
     int ReadFromFile( GDALOpenInfo* poOpenInfo );
     int ReadFromService( const char* pszSource );
+    int OpenStreaming( GDALOpenInfo* poOpenInfo );
+    void SetReaderOptions( OGRGeoJSONReader& oReader,
+                           char** papszOpenOptionsIn );
     void LoadLayers(char** papszOpenOptions);
 };
 
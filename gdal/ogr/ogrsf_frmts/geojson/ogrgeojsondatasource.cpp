@@ -46,6 +46,7 @@
 #include "gdal_utils.h"
 #include "gdal.h"
 #include "gdal_priv.h"
+#include "ogr_attrind.h"
 #include "ogr_core.h"
 #include "ogr_feature.h"
 #include "ogr_geometry.h"
@@ -113,6 +114,8 @@ int OGRGeoJSONDataSource::Open( GDALOpenInfo* poOpenInfo,
     }
     else if( eGeoJSONSourceFile == nSrcType )
     {
+        if( poOpenInfo->eAccess == GA_ReadOnly && OpenStreaming( poOpenInfo ) )
+            return TRUE;
         if( !ReadFromFile( poOpenInfo ) )
             return FALSE;
     }
@@ -172,6 +175,11 @@ int OGRGeoJSONDataSource::Open( GDALOpenInfo* poOpenInfo,
         return FALSE;
     }
 
+    // Attribute indexes (CREATE INDEX) are stored next to single layer
+    // files.
+    if( eGeoJSONSourceFile == nSrcType && nLayers_ == 1 )
+        papoLayers_[0]->InitializeIndexSupport( poOpenInfo->pszFilename );
+
     return TRUE;
 }
 
@@ -561,6 +569,85 @@ int OGRGeoJSONDataSource::ReadFromFile( GDALOpenInfo* poOpenInfo )
     return TRUE;
 }
 
+/************************************************************************/
+/*                           OpenStreaming()                            */
+/*                                                                      */
+/*      Big FeatureCollection files are not ingested and parsed as a    */
+/*      whole, but read in streaming mode: a first pass establishes     */
+/*      the layer schema and features are then parsed one at a time     */
+/*      when they are requested. The threshold, in MB, is set by the    */
+/*      OGR_GEOJSON_MAX_OBJ_SIZE configuration option (0 to always      */
+/*      stream).                                                        */
+/************************************************************************/
+
+int OGRGeoJSONDataSource::OpenStreaming( GDALOpenInfo* poOpenInfo )
+{
+    if( poOpenInfo->fpL == NULL || poOpenInfo->pabyHeader == NULL )
+        return FALSE;
+
+    // Only plain objects can be FeatureCollections. Other flavours are
+    // detected from their header when possible, the others will fail the
+    // FeatureCollection check of the first pass.
+    const char* pszHeader =
+        reinterpret_cast<const char*>(poOpenInfo->pabyHeader);
+    if( poOpenInfo->nHeaderBytes >= 3 &&
+        poOpenInfo->pabyHeader[0] == 0xEF &&
+        poOpenInfo->pabyHeader[1] == 0xBB &&
+        poOpenInfo->pabyHeader[2] == 0xBF )
+    {
+        pszHeader += 3;
+    }
+    while( isspace(static_cast<unsigned char>(*pszHeader)) )
+        pszHeader++;
+    if( *pszHeader != '{' ||
+        strstr(pszHeader, "\"Topology\"") != NULL ||
+        strstr(pszHeader, "esriGeometry") != NULL ||
+        strstr(pszHeader, "esriFieldType") != NULL )
+    {
+        return FALSE;
+    }
+
+    const double dfMaxSizeMB =
+        CPLAtof(CPLGetConfigOption("OGR_GEOJSON_MAX_OBJ_SIZE", "200"));
+    if( dfMaxSizeMB > 0 )
+    {
+        if( VSIFSeekL(poOpenInfo->fpL, 0, SEEK_END) != 0 )
+            return FALSE;
+        const vsi_l_offset nFileSize = VSIFTellL(poOpenInfo->fpL);
+        VSIRewindL(poOpenInfo->fpL);
+        if( static_cast<double>(nFileSize) <= dfMaxSizeMB * 1024 * 1024 )
+            return FALSE;
+    }
+
+    VSILFILE* fp = VSIFOpenL(poOpenInfo->pszFilename, "rb");
+    if( fp == NULL )
+        return FALSE;
+
+    CPLDebug("GeoJSON", "Reading %s in streaming mode",
+             poOpenInfo->pszFilename);
+
+    SetDescription( poOpenInfo->pszFilename );
+    bUpdatable_ = false;
+
+    OGRGeoJSONReader* poReader = new OGRGeoJSONReader();
+    SetReaderOptions( *poReader, poOpenInfo->papszOpenOptions );
+    if( !poReader->FirstPassReadLayer( this, fp ) )
+    {
+        // Not a FeatureCollection, or invalid JSON: let the regular code
+        // path deal with it.
+        delete poReader;
+        CPLErrorReset();
+        return FALSE;
+    }
+
+    VSIFCloseL(poOpenInfo->fpL);
+    poOpenInfo->fpL = NULL;
+
+    pszName_ = CPLStrdup( poOpenInfo->pszFilename );
+
+    return TRUE;
+}
+
 /************************************************************************/
 /*                           ReadFromService()                          */
 /************************************************************************/
@@ -639,6 +726,39 @@ int OGRGeoJSONDataSource::ReadFromService( const char* pszSource )
     return TRUE;
 }
 
+/************************************************************************/
+/*                          SetReaderOptions()                          */
+/************************************************************************/
+
+void OGRGeoJSONDataSource::SetReaderOptions( OGRGeoJSONReader& oReader,
+                                             char** papszOpenOptionsIn )
+{
+    if( eGeometryAsCollection == flTransGeom_ )
+    {
+        oReader.SetPreserveGeometryType( false );
+        CPLDebug( "GeoJSON", "Geometry as OGRGeometryCollection type." );
+    }
+
+    if( eAttributesSkip == flTransAttrs_ )
+    {
+        oReader.SetSkipAttributes( true );
+        CPLDebug( "GeoJSON", "Skip all attributes." );
+    }
+
+    oReader.SetFlattenNestedAttributes(
+        CPLFetchBool(papszOpenOptionsIn, "FLATTEN_NESTED_ATTRIBUTES", false),
+        CSLFetchNameValueDef(papszOpenOptionsIn,
+                             "NESTED_ATTRIBUTE_SEPARATOR", "_")[0]);
+
+    const bool bDefaultNativeData = bUpdatable_;
+    oReader.SetStoreNativeData(
+        CPLFetchBool(papszOpenOptionsIn, "NATIVE_DATA", bDefaultNativeData));
+
+    oReader.SetArrayAsString(
+        CPLTestBool(CSLFetchNameValueDef(papszOpenOptionsIn, "ARRAY_AS_STRING",
+                CPLGetConfigOption("OGR_GEOJSON_ARRAY_AS_STRING", "NO"))));
+}
+
 /************************************************************************/
 /*                           LoadLayers()                               */
 /************************************************************************/
@@ -724,31 +844,7 @@ void OGRGeoJSONDataSource::LoadLayers(char** papszOpenOptionsIn)
 /*      Configure GeoJSON format translator.                            */
 /* -------------------------------------------------------------------- */
     OGRGeoJSONReader reader;
-
-    if( eGeometryAsCollection == flTransGeom_ )
-    {
-        reader.SetPreserveGeometryType( false );
-        CPLDebug( "GeoJSON", "Geometry as OGRGeometryCollection type." );
-    }
-
-    if( eAttributesSkip == flTransAttrs_ )
-    {
-        reader.SetSkipAttributes( true );
-        CPLDebug( "GeoJSON", "Skip all attributes." );
-    }
-
-    reader.SetFlattenNestedAttributes(
-        CPLFetchBool(papszOpenOptionsIn, "FLATTEN_NESTED_ATTRIBUTES", false),
-        CSLFetchNameValueDef(papszOpenOptionsIn,
-                             "NESTED_ATTRIBUTE_SEPARATOR", "_")[0]);
-
-    const bool bDefaultNativeData = bUpdatable_;
-    reader.SetStoreNativeData(
-        CPLFetchBool(papszOpenOptionsIn, "NATIVE_DATA", bDefaultNativeData));
-
-    reader.SetArrayAsString(
-        CPLTestBool(CSLFetchNameValueDef(papszOpenOptionsIn, "ARRAY_AS_STRING",
-                CPLGetConfigOption("OGR_GEOJSON_ARRAY_AS_STRING", "NO"))));
+    SetReaderOptions( reader, papszOpenOptionsIn );
 
 /* -------------------------------------------------------------------- */
 /*      Parse GeoJSON and build valid OGRLayer instance.                */
@@ -817,6 +913,10 @@ void OGRGeoJSONDataSource::FlushCache()
         {
             papoLayers_[i]->SetUpdated(false);
 
+            // Attribute indexes are not maintained.
+            if( papoLayers_[i]->GetIndex() != NULL )
+                papoLayers_[i]->GetIndex()->InvalidateIndexes();
+
             bool bOK = false;
 
             // Disable all filters.
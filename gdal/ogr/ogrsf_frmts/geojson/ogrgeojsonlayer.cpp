@@ -45,7 +45,9 @@
 #  endif
 #endif  // !DEBUG_VERBOSE
 
+#include "ogr_attrind.h"
 #include "ogr_geojson.h"
+#include "ogrgeojsonreader.h"
 
 // Remove annoying warnings Microsoft Visual C++:
 //   'class': assignment operator could not be generated.
@@ -75,7 +77,12 @@ OGRGeoJSONLayer::OGRGeoJSONLayer( const char* pszName,
     OGRMemLayer( pszName, poSRSIn, eGType),
     poDS_(poDS),
     bUpdated_(false),
-    bOriginalIdModified_(false)
+    bOriginalIdModified_(false),
+    poStreamingReader_(NULL),
+    nStreamingFeatureCount_(0),
+    bCheckedForMatchingFIDs_(false),
+    panMatchingFIDs_(NULL),
+    iMatchingFID_(0)
 {
     SetAdvertizeUTF8(true);
     SetUpdatable( poDS->IsUpdatable() );
@@ -85,7 +92,11 @@ OGRGeoJSONLayer::OGRGeoJSONLayer( const char* pszName,
 /*                          ~OGRGeoJSONLayer                            */
 /************************************************************************/
 
-OGRGeoJSONLayer::~OGRGeoJSONLayer() {}
+OGRGeoJSONLayer::~OGRGeoJSONLayer()
+{
+    delete poStreamingReader_;
+    CPLFree( panMatchingFIDs_ );
+}
 
 /************************************************************************/
 /*                           GetFIDColumn                               */
@@ -114,6 +125,14 @@ int OGRGeoJSONLayer::TestCapability( const char * pszCap )
 {
     if( EQUAL(pszCap, OLCCurveGeometries) )
         return FALSE;
+    if( poStreamingReader_ != NULL )
+    {
+        if( EQUAL(pszCap, OLCFastFeatureCount) )
+            return m_poFilterGeom == NULL && m_poAttrQuery == NULL;
+        if( EQUAL(pszCap, OLCStringsAsUTF8) )
+            return TRUE;
+        return FALSE;
+    }
     return OGRMemLayer::TestCapability(pszCap);
 }
 
@@ -127,6 +146,153 @@ OGRErr OGRGeoJSONLayer::SyncToDisk()
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                         SetStreamingReader()                         */
+/*                                                                      */
+/*      Switch the layer to reading its features from the file on       */
+/*      demand. The layer takes ownership of the reader.                */
+/************************************************************************/
+
+void OGRGeoJSONLayer::SetStreamingReader( OGRGeoJSONReader* poReader,
+                                          GIntBig nFeatureCount )
+{
+    poStreamingReader_ = poReader;
+    nStreamingFeatureCount_ = nFeatureCount;
+    SetUpdatable( false );
+    poStreamingReader_->ResetReading();
+}
+
+/************************************************************************/
+/*                            ResetReading()                            */
+/************************************************************************/
+
+void OGRGeoJSONLayer::ResetReading()
+{
+    ClearMatchingFIDs();
+    if( poStreamingReader_ != NULL )
+        poStreamingReader_->ResetReading();
+    else
+        OGRMemLayer::ResetReading();
+}
+
+/************************************************************************/
+/*                         ClearMatchingFIDs()                          */
+/************************************************************************/
+
+void OGRGeoJSONLayer::ClearMatchingFIDs()
+{
+    CPLFree( panMatchingFIDs_ );
+    panMatchingFIDs_ = NULL;
+    iMatchingFID_ = 0;
+    bCheckedForMatchingFIDs_ = false;
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONLayer::GetNextFeature()
+{
+    if( poStreamingReader_ == NULL )
+    {
+        // Use attribute indexes, if any, to only visit the features that
+        // may match the attribute filter. Indexes do not reflect changes
+        // made since the file was opened.
+        if( !bCheckedForMatchingFIDs_ )
+        {
+            bCheckedForMatchingFIDs_ = true;
+            if( m_poAttrIndex != NULL && HasBeenUpdated() )
+                m_poAttrIndex->InvalidateIndexes();
+            else if( m_poAttrQuery != NULL && m_poAttrIndex != NULL &&
+                     GetNextReadFID() == 0 )
+            {
+                panMatchingFIDs_ =
+                    m_poAttrQuery->EvaluateAgainstIndices( this, NULL );
+                iMatchingFID_ = 0;
+            }
+        }
+
+        if( panMatchingFIDs_ == NULL )
+            return OGRMemLayer::GetNextFeature();
+
+        while( panMatchingFIDs_[iMatchingFID_] != OGRNullFID )
+        {
+            OGRFeature* poFeature =
+                OGRMemLayer::GetFeature( panMatchingFIDs_[iMatchingFID_++] );
+            if( poFeature == NULL )
+                continue;
+
+            if( (m_poFilterGeom == NULL ||
+                 FilterGeometry(
+                     poFeature->GetGeomFieldRef(m_iGeomFieldFilter) ))
+                && m_poAttrQuery->Evaluate(poFeature) )
+            {
+                return poFeature;
+            }
+
+            delete poFeature;
+        }
+        return NULL;
+    }
+
+    while( true )
+    {
+        OGRFeature* poFeature = poStreamingReader_->GetNextFeature(this);
+        if( poFeature == NULL )
+            return NULL;
+
+        if( (m_poFilterGeom == NULL ||
+             FilterGeometry( poFeature->GetGeomFieldRef(m_iGeomFieldFilter) ))
+            && (m_poAttrQuery == NULL || m_poAttrQuery->Evaluate(poFeature)) )
+        {
+            return poFeature;
+        }
+
+        delete poFeature;
+    }
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONLayer::GetFeature( GIntBig nFID )
+{
+    if( poStreamingReader_ != NULL )
+        return OGRLayer::GetFeature(nFID);
+    return OGRMemLayer::GetFeature(nFID);
+}
+
+/************************************************************************/
+/*                          GetFeatureCount()                           */
+/************************************************************************/
+
+GIntBig OGRGeoJSONLayer::GetFeatureCount( int bForce )
+{
+    if( poStreamingReader_ != NULL )
+    {
+        if( m_poFilterGeom == NULL && m_poAttrQuery == NULL )
+            return nStreamingFeatureCount_;
+        return OGRLayer::GetFeatureCount(bForce);
+    }
+    return OGRMemLayer::GetFeatureCount(bForce);
+}
+
+/************************************************************************/
+/*                           SetNextByIndex()                           */
+/************************************************************************/
+
+OGRErr OGRGeoJSONLayer::SetNextByIndex( GIntBig nIndex )
+{
+    if( poStreamingReader_ != NULL )
+        return OGRLayer::SetNextByIndex(nIndex);
+
+    // Continue with a sequential read from the requested position.
+    ClearMatchingFIDs();
+    bCheckedForMatchingFIDs_ = true;
+    return OGRMemLayer::SetNextByIndex(nIndex);
+}
+
 /************************************************************************/
 /*                           AddFeature                                 */
 /************************************************************************/
@@ -188,7 +354,10 @@ void OGRGeoJSONLayer::AddFeature( OGRFeature* poFeature )
 
 void OGRGeoJSONLayer::DetectGeometryType()
 {
-    if( GetLayerDefn()->GetGeomType() != wkbUnknown )
+    // In streaming mode, the geometry type has been established during
+    // the first pass.
+    if( GetLayerDefn()->GetGeomType() != wkbUnknown ||
+        poStreamingReader_ != NULL )
         return;
 
     ResetReading();
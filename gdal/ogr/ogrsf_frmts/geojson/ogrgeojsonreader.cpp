@@ -33,6 +33,8 @@
 #include <json.h> // JSON-C
 #include <ogr_api.h>
 
+#include <algorithm>
+
 CPL_CVSID("$Id$");
 
 /************************************************************************/
@@ -41,6 +43,11 @@ CPL_CVSID("$Id$");
 
 OGRGeoJSONReader::OGRGeoJSONReader() :
     poGJObject_(NULL),
+    fpStreaming_(NULL),
+    poStreamingIterator_(NULL),
+    eStreamingFIDMode_(STREAMING_FID_SEQUENTIAL),
+    nStreamingFeatureIdx_(0),
+    bStreamingIdModifiedWarned_(false),
     bGeometryPreserve_(true),
     bAttributesSkip_(false),
     bFlattenNestedAttributes_(false),
@@ -67,6 +74,10 @@ OGRGeoJSONReader::~OGRGeoJSONReader()
     }
 
     poGJObject_ = NULL;
+
+    delete poStreamingIterator_;
+    if( fpStreaming_ != NULL )
+        VSIFCloseL(fpStreaming_);
 }
 
 /************************************************************************/
@@ -249,6 +260,638 @@ void OGRGeoJSONReader::ReadLayer( OGRGeoJSONDataSource* poDS,
     poDS->AddLayer(poLayer);
 }
 
+/************************************************************************/
+/*                      OGRGeoJSONFeatureIterator                       */
+/************************************************************************/
+
+static const size_t STREAMING_BUFFER_SIZE = 65536;
+
+OGRGeoJSONFeatureIterator::OGRGeoJSONFeatureIterator( VSILFILE* fp ) :
+    fp_(fp),
+    abyBuffer_(STREAMING_BUFFER_SIZE),
+    nBufferPos_(0),
+    nBufferSize_(0),
+    bError_(false),
+    bFirstIteration_(true),
+    bStartOfFile_(true),
+    nDepth_(0),
+    bInString_(false),
+    bEscaped_(false),
+    bExpectKey_(false),
+    bInKey_(false),
+    bAfterColon_(false),
+    bInFeatures_(false),
+    bInFeature_(false),
+    nGeomDepth_(0),
+    nSkipDepth_(0),
+    bLeafArray_(false),
+    bLeafHasValue_(false),
+    nLeafCommas_(0),
+    nMaxCoordDim_(0)
+{}
+
+/************************************************************************/
+/*                               Rewind()                               */
+/************************************************************************/
+
+void OGRGeoJSONFeatureIterator::Rewind()
+{
+    VSIRewindL(fp_);
+    nBufferPos_ = 0;
+    nBufferSize_ = 0;
+    bError_ = false;
+    bStartOfFile_ = true;
+    nDepth_ = 0;
+    osContainers_.clear();
+    bInString_ = false;
+    bEscaped_ = false;
+    bExpectKey_ = false;
+    bInKey_ = false;
+    bAfterColon_ = false;
+    bInFeatures_ = false;
+    bInFeature_ = false;
+    nGeomDepth_ = 0;
+    nSkipDepth_ = 0;
+    bLeafArray_ = false;
+    bLeafHasValue_ = false;
+    nLeafCommas_ = 0;
+    nMaxCoordDim_ = 0;
+    osFeature_.clear();
+}
+
+/************************************************************************/
+/*                        GetNextFeatureText()                          */
+/*                                                                      */
+/*      Scan the file until the end of the next object of the           */
+/*      "features" array of the top-level object.  Only string          */
+/*      boundaries, nesting levels and member names are tracked: the    */
+/*      returned text must still be parsed.                             */
+/************************************************************************/
+
+const char* OGRGeoJSONFeatureIterator::GetNextFeatureText(
+    bool bSkipCoordinates )
+{
+    if( bError_ )
+        return NULL;
+
+    osFeature_.clear();
+    nMaxCoordDim_ = 0;
+
+    while( true )
+    {
+        if( nBufferPos_ == nBufferSize_ )
+        {
+            nBufferSize_ = VSIFReadL(&abyBuffer_[0], 1, abyBuffer_.size(),
+                                     fp_);
+            nBufferPos_ = 0;
+            if( nBufferSize_ == 0 )
+            {
+                if( nDepth_ != 0 || bInString_ )
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "GeoJSON: unexpected end of file");
+                    bError_ = true;
+                }
+                bFirstIteration_ = false;
+                return NULL;
+            }
+            if( bStartOfFile_ )
+            {
+                bStartOfFile_ = false;
+                // Skip UTF-8 BOM (#5630).
+                const GByte* pabyData =
+                    reinterpret_cast<const GByte*>(&abyBuffer_[0]);
+                if( nBufferSize_ >= 3 && pabyData[0] == 0xEF &&
+                    pabyData[1] == 0xBB && pabyData[2] == 0xBF )
+                {
+                    nBufferPos_ = 3;
+                }
+            }
+        }
+
+        const char ch = abyBuffer_[nBufferPos_++];
+        bool bKeep = nSkipDepth_ == 0;
+
+        if( bInString_ )
+        {
+            if( bEscaped_ )
+                bEscaped_ = false;
+            else if( ch == '\\' )
+                bEscaped_ = true;
+            else if( ch == '"' )
+                bInString_ = bInKey_ = false;
+            else if( bInKey_ )
+                osKey_ += ch;
+        }
+        else if( !isspace(static_cast<unsigned char>(ch)) )
+        {
+            // First character of the value of the member osKey_.
+            if( bAfterColon_ )
+            {
+                bAfterColon_ = false;
+                if( nDepth_ == 1 && ch == '[' && EQUAL(osKey_, "features") )
+                {
+                    bInFeatures_ = true;
+                }
+                else if( bInFeature_ && nDepth_ == 3 && ch == '{' &&
+                         EQUAL(osKey_, "geometry") )
+                {
+                    nGeomDepth_ = 4;
+                }
+                else if( bSkipCoordinates && nGeomDepth_ > 0 &&
+                         nSkipDepth_ == 0 && ch == '[' &&
+                         EQUAL(osKey_, "coordinates") )
+                {
+                    nSkipDepth_ = nDepth_;
+                    bKeep = false;
+                    osFeature_ += "[]";
+                }
+            }
+
+            switch( ch )
+            {
+                case '"':
+                    bInString_ = true;
+                    if( bExpectKey_ )
+                    {
+                        bExpectKey_ = false;
+                        bInKey_ = true;
+                        osKey_.clear();
+                    }
+                    else if( nSkipDepth_ > 0 )
+                    {
+                        bLeafHasValue_ = true;
+                    }
+                    break;
+
+                case '{':
+                case '[':
+                    if( nDepth_ == 0 && ch != '{' )
+                    {
+                        CPLError(CE_Failure, CPLE_AppDefined,
+                                 "GeoJSON: top-level value is not an object");
+                        bError_ = true;
+                        return NULL;
+                    }
+                    if( bInFeatures_ && nDepth_ == 2 && ch == '{' )
+                        bInFeature_ = true;
+                    nDepth_++;
+                    osContainers_ += ch;
+                    bExpectKey_ = ch == '{';
+                    if( nSkipDepth_ > 0 )
+                    {
+                        bLeafArray_ = true;
+                        bLeafHasValue_ = false;
+                        nLeafCommas_ = 0;
+                    }
+                    break;
+
+                case '}':
+                case ']':
+                    if( nDepth_ == 0 )
+                    {
+                        CPLError(CE_Failure, CPLE_AppDefined,
+                                 "GeoJSON: unbalanced '%c'", ch);
+                        bError_ = true;
+                        return NULL;
+                    }
+                    nDepth_--;
+                    osContainers_.resize(nDepth_);
+                    bExpectKey_ = false;
+                    if( nSkipDepth_ > 0 )
+                    {
+                        // Innermost arrays of coordinates hold the values of
+                        // a position.
+                        if( bLeafArray_ && bLeafHasValue_ )
+                        {
+                            nMaxCoordDim_ =
+                                std::max(nMaxCoordDim_, nLeafCommas_ + 1);
+                        }
+                        bLeafArray_ = false;
+                        if( nDepth_ == nSkipDepth_ )
+                            nSkipDepth_ = 0;
+                    }
+                    if( nDepth_ < nGeomDepth_ )
+                        nGeomDepth_ = 0;
+                    if( bInFeature_ && nDepth_ == 2 )
+                    {
+                        bInFeature_ = false;
+                        osFeature_ += ch;
+                        return osFeature_.c_str();
+                    }
+                    if( bInFeatures_ && nDepth_ == 1 )
+                        bInFeatures_ = false;
+                    break;
+
+                case ',':
+                    bExpectKey_ = nDepth_ > 0 && osContainers_.back() == '{';
+                    if( nSkipDepth_ > 0 )
+                        nLeafCommas_++;
+                    break;
+
+                case ':':
+                    bAfterColon_ = true;
+                    break;
+
+                default:
+                    if( nSkipDepth_ > 0 )
+                        bLeafHasValue_ = true;
+                    break;
+            }
+        }
+
+        if( bInFeature_ )
+        {
+            if( bKeep )
+                osFeature_ += ch;
+        }
+        else if( bFirstIteration_ &&
+                 !(bInFeatures_ && nDepth_ == 2 && ch == ',') )
+        {
+            osSkeleton_ += ch;
+        }
+    }
+}
+
+/************************************************************************/
+/*                              FIDStats                                */
+/************************************************************************/
+
+OGRGeoJSONReader::FIDStats::FIDStats() :
+    nLast(-1),
+    nNegative(0),
+    bAnyNull(false),
+    bAnySet(false),
+    bIncreasing(true),
+    bFID64(false)
+{}
+
+void OGRGeoJSONReader::FIDStats::Add( GIntBig nFID )
+{
+    if( nFID == OGRNullFID )
+    {
+        bAnyNull = true;
+        return;
+    }
+    bAnySet = true;
+    if( nFID < OGRNullFID )
+    {
+        nNegative++;
+        return;
+    }
+    if( nFID <= nLast )
+        bIncreasing = false;
+    nLast = nFID;
+    if( !CPL_INT64_FITS_ON_INT32(nFID) )
+        bFID64 = true;
+}
+
+/************************************************************************/
+/*                   OGRGeoJSONGetStreamingGeomType()                   */
+/*                                                                      */
+/*      Type of the geometry that ReadGeometry() would return for a     */
+/*      geometry object whose coordinates have been skipped, given the  */
+/*      number of values of their positions.                            */
+/************************************************************************/
+
+static OGRwkbGeometryType OGRGeoJSONGetStreamingGeomType(
+    json_object* poObjGeom, int nCoordDim, bool bGeometryPreserve )
+{
+    if( poObjGeom == NULL ||
+        json_object_get_type(poObjGeom) != json_type_object )
+        return wkbNone;
+
+    OGRwkbGeometryType eType = wkbNone;
+    switch( OGRGeoJSONGetType( poObjGeom ) )
+    {
+        case GeoJSONObject::ePoint:
+            // A point needs at least x and y.
+            if( nCoordDim >= 2 )
+                eType = wkbPoint;
+            break;
+        case GeoJSONObject::eMultiPoint: eType = wkbMultiPoint; break;
+        case GeoJSONObject::eLineString: eType = wkbLineString; break;
+        case GeoJSONObject::eMultiLineString:
+            eType = wkbMultiLineString; break;
+        case GeoJSONObject::ePolygon: eType = wkbPolygon; break;
+        case GeoJSONObject::eMultiPolygon: eType = wkbMultiPolygon; break;
+        case GeoJSONObject::eGeometryCollection:
+            eType = wkbGeometryCollection; break;
+        default:
+            break;
+    }
+    if( eType == wkbNone )
+        return wkbNone;
+
+    if( eType != wkbGeometryCollection &&
+        OGRGeoJSONFindMemberByName( poObjGeom, "coordinates" ) == NULL )
+        return wkbNone;
+
+    if( !bGeometryPreserve )
+        eType = wkbGeometryCollection;
+    if( nCoordDim >= 3 )
+        eType = wkbSetZ(eType);
+    return eType;
+}
+
+/************************************************************************/
+/*                         FirstPassReadLayer()                         */
+/*                                                                      */
+/*      Build the layer of a FeatureCollection read from a file in      */
+/*      streaming mode: the file is scanned once to establish the       */
+/*      schema, geometry type and feature count, and features are then */
+/*      read on demand by GetNextFeature().  Geometries are not parsed  */
+/*      during that pass: only their type and the dimension of their   */
+/*      coordinates are collected.  The reader takes ownership of fp    */
+/*      and, on success, is owned by the created layer.                 */
+/************************************************************************/
+
+bool OGRGeoJSONReader::FirstPassReadLayer( OGRGeoJSONDataSource* poDS,
+                                           VSILFILE* fp )
+{
+    CPLAssert( fpStreaming_ == NULL );
+    fpStreaming_ = fp;
+    poStreamingIterator_ = new OGRGeoJSONFeatureIterator(fp);
+
+    // Only used to collect the fields, as the name and SRS of the layer are
+    // not known before the whole file has been read.
+    OGRGeoJSONLayer* poSchemaLayer =
+        new OGRGeoJSONLayer( OGRGeoJSONLayer::DefaultName, NULL,
+                             OGRGeoJSONLayer::DefaultGeometryType, poDS );
+
+    // Whether the FIDs come from the feature ids or from an "id" property
+    // used as FID column depends on the schema established at the end of
+    // the pass, so collect the properties of both.
+    FIDStats oFeatureIdStats;
+    FIDStats oPropertyIdStats;
+
+    GIntBig nFeatureCount = 0;
+    bool bFirstGeometry = true;
+    OGRwkbGeometryType eLayerGeomType = OGRGeoJSONLayer::DefaultGeometryType;
+    bool bSuccess = true;
+
+    const char* pszText = NULL;
+    while( (pszText = poStreamingIterator_->GetNextFeatureText(true)) != NULL )
+    {
+        json_object* poObj = NULL;
+        if( !OGRJSonParse(pszText, &poObj, false) )
+        {
+            bSuccess = false;
+            break;
+        }
+
+        if( !bAttributesSkip_ )
+        {
+            if( !GenerateFeatureDefn(poSchemaLayer, poObj) )
+                CPLDebug( "GeoJSON", "Create feature schema failure." );
+
+            // The GeoCouch flavour is not handled in streaming mode.
+            if( bIsGeocouchSpatiallistFormat )
+            {
+                json_object_put(poObj);
+                bSuccess = false;
+                break;
+            }
+
+            json_object* poObjId = OGRGeoJSONFindMemberByName( poObj, "id" );
+            oFeatureIdStats.Add( poObjId != NULL ?
+                static_cast<GIntBig>(json_object_get_int64(poObjId)) :
+                OGRNullFID );
+
+            // Same as OGRGeoJSONReaderSetField(): the last non null
+            // property matching the FID column wins.
+            GIntBig nPropertyId = OGRNullFID;
+            json_object* poObjProps =
+                OGRGeoJSONFindMemberByName( poObj, "properties" );
+            if( poObjProps != NULL &&
+                json_object_get_type(poObjProps) == json_type_object )
+            {
+                json_object_iter it;
+                it.key = NULL;
+                it.val = NULL;
+                it.entry = NULL;
+                json_object_object_foreachC( poObjProps, it )
+                {
+                    if( it.val != NULL && EQUAL(it.key, "id") )
+                        nPropertyId = json_object_get_int64(it.val);
+                }
+            }
+            oPropertyIdStats.Add( nPropertyId );
+        }
+
+        const OGRwkbGeometryType eGeomType = OGRGeoJSONGetStreamingGeomType(
+            OGRGeoJSONFindMemberByName( poObj, "geometry" ),
+            poStreamingIterator_->GetMaxCoordinateDimension(),
+            bGeometryPreserve_ );
+        if( eGeomType != wkbNone )
+        {
+            if( bFirstGeometry )
+            {
+                eLayerGeomType = eGeomType;
+                bFirstGeometry = false;
+            }
+            else if( eGeomType != eLayerGeomType &&
+                     eLayerGeomType != OGRGeoJSONLayer::DefaultGeometryType )
+            {
+                CPLDebug( "GeoJSON",
+                    "Detected layer of mixed-geometry type features." );
+                eLayerGeomType = OGRGeoJSONLayer::DefaultGeometryType;
+            }
+        }
+
+        json_object_put(poObj);
+        nFeatureCount++;
+    }
+
+    json_object* poSkeleton = NULL;
+    if( !bSuccess || poStreamingIterator_->HasError() ||
+        !OGRJSonParse(poStreamingIterator_->GetSkeleton().c_str(), &poSkeleton,
+                      false) ||
+        OGRGeoJSONGetType( poSkeleton ) != GeoJSONObject::eFeatureCollection )
+    {
+        if( poSkeleton != NULL )
+            json_object_put(poSkeleton);
+        delete poSchemaLayer;
+        return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Create the layer, as ReadLayer() does.                          */
+/* -------------------------------------------------------------------- */
+    OGRSpatialReference* poSRS = OGRGeoJSONReadSpatialReference( poSkeleton );
+    if( poSRS == NULL )
+    {
+        // If there is none defined, we use 4326.
+        poSRS = new OGRSpatialReference();
+        poSRS->SetFromUserInput(SRS_WKT_WGS84);
+    }
+
+    CPLErrorReset();
+
+    const char* pszName = NULL;
+    json_object* poName = CPL_json_object_object_get(poSkeleton, "name");
+    if( poName != NULL && json_object_get_type(poName) == json_type_string )
+    {
+        pszName = json_object_get_string(poName);
+    }
+    else
+    {
+        pszName = CPLGetBasename(poDS->GetDescription());
+    }
+    if( pszName[0] == '\0' )
+        pszName = OGRGeoJSONLayer::DefaultName;
+
+    OGRGeoJSONLayer* poLayer =
+      new OGRGeoJSONLayer( pszName, poSRS, eLayerGeomType, poDS );
+    poSRS->Release();
+
+    OGRFeatureDefn* poSchemaDefn = poSchemaLayer->GetLayerDefn();
+    for( int i = 0; i < poSchemaDefn->GetFieldCount(); i++ )
+        poLayer->GetLayerDefn()->AddFieldDefn( poSchemaDefn->GetFieldDefn(i) );
+    delete poSchemaLayer;
+    if( !bAttributesSkip_ )
+        FinalizeLayerDefn( poLayer );
+
+    json_object* poDescription =
+                    CPL_json_object_object_get(poSkeleton, "description");
+    if( poDescription != NULL &&
+        json_object_get_type(poDescription) == json_type_string )
+    {
+        poLayer->SetMetadataItem("DESCRIPTION",
+                                 json_object_get_string(poDescription));
+    }
+
+    // The "features" array of the skeleton is empty, so this only collects
+    // the native data of the collection.
+    ReadFeatureCollection( poLayer, poSkeleton );
+    json_object_put(poSkeleton);
+
+/* -------------------------------------------------------------------- */
+/*      Features are not stored, so the FIDs given by ReadFeature()     */
+/*      are made unique on the fly as OGRGeoJSONLayer::AddFeature()     */
+/*      does. This is only needed if they are neither all unset nor     */
+/*      all increasing.                                                 */
+/* -------------------------------------------------------------------- */
+    FIDStats oNoFIDStats;
+    const FIDStats* psFIDStats = &oNoFIDStats;
+    if( bFoundFeatureId )
+        psFIDStats = &oFeatureIdStats;
+    else if( poLayer->GetFIDColumn()[0] != '\0' )
+        psFIDStats = &oPropertyIdStats;
+
+    if( !psFIDStats->bAnySet )
+        eStreamingFIDMode_ = STREAMING_FID_SEQUENTIAL;
+    else if( !psFIDStats->bAnyNull && psFIDStats->bIncreasing )
+        eStreamingFIDMode_ = STREAMING_FID_ORIGINAL;
+    else
+        eStreamingFIDMode_ = STREAMING_FID_UNIQUIFY;
+
+    if( psFIDStats->nNegative > 0 )
+    {
+        // Such features are rejected by OGRMemLayer::SetFeature().
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "negative FID are not supported");
+        nFeatureCount -= psFIDStats->nNegative;
+    }
+    if( psFIDStats->bFID64 )
+        poLayer->SetMetadataItem(OLMD_FID64, "YES");
+
+    if( CPLGetLastErrorType() != CE_Warning )
+        CPLErrorReset();
+
+    poLayer->SetStreamingReader( this, nFeatureCount );
+    poDS->AddLayer(poLayer);
+
+    return true;
+}
+
+/************************************************************************/
+/*                            ResetReading()                            */
+/************************************************************************/
+
+void OGRGeoJSONReader::ResetReading()
+{
+    CPLAssert( poStreamingIterator_ != NULL );
+    poStreamingIterator_->Rewind();
+    nStreamingFeatureIdx_ = 0;
+    oSetStreamingUsedFIDs_.clear();
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONReader::GetNextFeature( OGRGeoJSONLayer* poLayer )
+{
+    CPLAssert( poStreamingIterator_ != NULL );
+
+    while( true )
+    {
+        const char* pszText = poStreamingIterator_->GetNextFeatureText();
+        if( pszText == NULL )
+            return NULL;
+
+        json_object* poObj = NULL;
+        if( !OGRJSonParse(pszText, &poObj, false) )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "GeoJSON: cannot parse feature " CPL_FRMT_GIB,
+                     nStreamingFeatureIdx_);
+            return NULL;
+        }
+
+        OGRFeature* poFeature = ReadFeature( poLayer, poObj );
+        json_object_put(poObj);
+
+        GIntBig nFID = poFeature->GetFID();
+        if( nFID < OGRNullFID )
+        {
+            // Rejected by the layer in the regular code path.
+            delete poFeature;
+            continue;
+        }
+
+        if( eStreamingFIDMode_ == STREAMING_FID_SEQUENTIAL )
+        {
+            nFID = nStreamingFeatureIdx_;
+        }
+        else if( eStreamingFIDMode_ == STREAMING_FID_UNIQUIFY )
+        {
+            // Same logic as OGRGeoJSONLayer::AddFeature().
+            if( nFID != OGRNullFID &&
+                oSetStreamingUsedFIDs_.find(nFID) !=
+                    oSetStreamingUsedFIDs_.end() )
+            {
+                if( !bStreamingIdModifiedWarned_ )
+                {
+                    CPLError(
+                        CE_Warning, CPLE_AppDefined,
+                        "Several features with id = " CPL_FRMT_GIB " have "
+                        "been found. Altering it to be unique. This warning "
+                        "will not be emitted for this layer",
+                        nFID );
+                    bStreamingIdModifiedWarned_ = true;
+                }
+                nFID = OGRNullFID;
+            }
+            if( nFID == OGRNullFID )
+            {
+                nFID = nStreamingFeatureIdx_;
+                while( oSetStreamingUsedFIDs_.find(nFID) !=
+                           oSetStreamingUsedFIDs_.end() )
+                {
+                    nFID++;
+                }
+            }
+            oSetStreamingUsedFIDs_.insert(nFID);
+        }
+        poFeature->SetFID( nFID );
+        nStreamingFeatureIdx_++;
+
+        return poFeature;
+    }
+}
+
 /************************************************************************/
 /*                    OGRGeoJSONReadSpatialReference                    */
 /************************************************************************/
@@ -479,9 +1122,19 @@ bool OGRGeoJSONReader::GenerateLayerDefn( OGRGeoJSONLayer* poLayer,
         }
     }
 
-/* -------------------------------------------------------------------- */
+    FinalizeLayerDefn( poLayer );
+
+    return bSuccess;
+}
+
+/************************************************************************/
+/*                         FinalizeLayerDefn()                          */
+/*                                                                      */
 /*      Validate and add FID column if necessary.                       */
-/* -------------------------------------------------------------------- */
+/************************************************************************/
+
+void OGRGeoJSONReader::FinalizeLayerDefn( OGRGeoJSONLayer* poLayer )
+{
     OGRFeatureDefn* poLayerDefn = poLayer->GetLayerDefn();
     CPLAssert( NULL != poLayerDefn );
 
@@ -499,8 +1152,6 @@ bool OGRGeoJSONReader::GenerateLayerDefn( OGRGeoJSONLayer* poLayer,
             }
         }
     }
-
-    return bSuccess;
 }
 
 /************************************************************************/
@@ -37,6 +37,7 @@
 #include "ogr_json_header.h"
 
 #include <set>
+#include <vector>
 
 /************************************************************************/
 /*                         FORWARD DECLARATIONS                         */
@@ -83,6 +84,69 @@ struct GeoJSONObject
     };
 };
 
+/************************************************************************/
+/*                      OGRGeoJSONFeatureIterator                       */
+/************************************************************************/
+
+// Returns in turn the text of each member of the "features" array of a
+// top-level FeatureCollection object, so that features can be read from a
+// file without loading the whole document in memory.
+class OGRGeoJSONFeatureIterator
+{
+  public:
+    explicit OGRGeoJSONFeatureIterator( VSILFILE* fp );
+
+    void Rewind();
+    // With bSkipCoordinates, the "coordinates" arrays of the geometry are
+    // scanned but replaced by empty arrays in the returned text.
+    const char* GetNextFeatureText( bool bSkipCoordinates = false );
+    bool HasError() const { return bError_; }
+
+    // Largest number of values of the innermost arrays of the coordinates
+    // skipped in the last returned feature.
+    int GetMaxCoordinateDimension() const { return nMaxCoordDim_; }
+
+    // Text of the top-level object with the members of its "features"
+    // array removed. Only complete after a first iteration over the file.
+    const CPLString& GetSkeleton() const { return osSkeleton_; }
+
+  private:
+    VSILFILE* fp_;
+    std::vector<char> abyBuffer_;
+    size_t nBufferPos_;
+    size_t nBufferSize_;
+    bool bError_;
+    bool bFirstIteration_;
+    bool bStartOfFile_;
+
+    CPLString osSkeleton_;
+    CPLString osFeature_;
+    CPLString osKey_;
+
+    int nDepth_;
+    // Kind ('{' or '[') of the containers enclosing the current position.
+    CPLString osContainers_;
+    bool bInString_;
+    bool bEscaped_;
+    bool bExpectKey_;
+    bool bInKey_;
+    bool bAfterColon_;
+    bool bInFeatures_;
+    bool bInFeature_;
+
+    // Depth of the content of the geometry object of the current
+    // feature, and of the coordinates array being skipped, or 0.
+    int nGeomDepth_;
+    int nSkipDepth_;
+    bool bLeafArray_;
+    bool bLeafHasValue_;
+    int nLeafCommas_;
+    int nMaxCoordDim_;
+
+    OGRGeoJSONFeatureIterator( const OGRGeoJSONFeatureIterator& );
+    OGRGeoJSONFeatureIterator& operator=( const OGRGeoJSONFeatureIterator& );
+};
+
 /************************************************************************/
 /*                           OGRGeoJSONReader                           */
 /************************************************************************/
@@ -109,9 +173,45 @@ class OGRGeoJSONReader
 
     json_object* GetJSonObject() { return poGJObject_; }
 
+    // Streaming mode.
+    bool FirstPassReadLayer( OGRGeoJSONDataSource* poDS, VSILFILE* fp );
+    void ResetReading();
+    OGRFeature* GetNextFeature( OGRGeoJSONLayer* poLayer );
+
   private:
     json_object* poGJObject_;
 
+    // Properties of the FIDs given by ReadFeature() to the successive
+    // features, collected during the first pass of streaming mode.
+    struct FIDStats
+    {
+        GIntBig nLast;
+        GIntBig nNegative;  // FIDs < OGRNullFID, rejected by the layer
+        bool bAnyNull;      // some FIDs are OGRNullFID
+        bool bAnySet;       // some FIDs are not OGRNullFID
+        bool bIncreasing;   // FIDs >= 0 are strictly increasing
+        bool bFID64;
+
+        FIDStats();
+        void Add( GIntBig nFID );
+    };
+
+    // How the FIDs given by ReadFeature() are turned into the ones of the
+    // layer in streaming mode, to match OGRGeoJSONLayer::AddFeature().
+    enum StreamingFIDMode
+    {
+        STREAMING_FID_SEQUENTIAL,   // no FID: feature index
+        STREAMING_FID_ORIGINAL,     // unique FIDs: kept
+        STREAMING_FID_UNIQUIFY      // replay OGRGeoJSONLayer::AddFeature()
+    };
+
+    VSILFILE* fpStreaming_;
+    OGRGeoJSONFeatureIterator* poStreamingIterator_;
+    StreamingFIDMode eStreamingFIDMode_;
+    GIntBig nStreamingFeatureIdx_;
+    std::set<GIntBig> oSetStreamingUsedFIDs_;
+    bool bStreamingIdModifiedWarned_;
+
     bool bGeometryPreserve_;
     bool bAttributesSkip_;
     bool bFlattenNestedAttributes_;
@@ -139,6 +239,7 @@ class OGRGeoJSONReader
     // Translation utilities.
     //
     bool GenerateLayerDefn( OGRGeoJSONLayer* poLayer, json_object* poGJObject );
+    void FinalizeLayerDefn( OGRGeoJSONLayer* poLayer );
     bool GenerateFeatureDefn( OGRGeoJSONLayer* poLayer, json_object* poObj );
     static bool AddFeature( OGRGeoJSONLayer* poLayer, OGRGeometry* poGeometry );
     static bool AddFeature( OGRGeoJSONLayer* poLayer, OGRFeature* poFeature );
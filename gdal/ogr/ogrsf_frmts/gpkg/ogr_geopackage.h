@@ -34,7 +34,9 @@
 #include "ogr_sqlite.h"
 #include "gpkgmbtilescommon.h"
 #include "ogrsqliteutility.h"
+#include "cpl_worker_thread_pool.h"
 
+#include <deque>
 #include <vector>
 
 #define UNKNOWN_SRID   -2
@@ -49,6 +51,15 @@ typedef enum
     NOT_REGISTERED,
 } GPKGASpatialVariant;
 
+typedef struct
+{
+    GIntBig nId;
+    double  dfMinX;
+    double  dfMinY;
+    double  dfMaxX;
+    double  dfMaxY;
+} GPKGRTreeEntry;
+
 // Requirement 2
 static const GUInt32 GP10_APPLICATION_ID = 0x47503130U;
 static const GUInt32 GP11_APPLICATION_ID = 0x47503131U;
@@ -293,6 +304,8 @@ class GDALGeoPackageRasterBand CPL_FINAL: public GDALGPKGMBTilesLikeRasterBand
 /*                           OGRGeoPackageLayer                         */
 /************************************************************************/
 
+class OGRGeoPackageRowChunk;
+
 class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
 {
   protected:
@@ -310,13 +323,34 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
     int                 iGeomCol;
     int                *panFieldOrdinals;
 
+    // Multi-threaded reading: rows are stepped by the calling thread and
+    // converted to features by worker threads, by chunks.
+    int                 m_nWorkerThreads;
+    CPLWorkerThreadPool *m_poWorkerPool;
+    std::deque<OGRGeoPackageRowChunk*> m_apoRowChunks;
+    std::vector<OGRGeoPackageRowChunk*> m_apoFreeRowChunks;
+    size_t              m_nConvertedRowChunks;
+    bool                m_bRowChunksEOF;
+
     void                ClearStatement();
     virtual OGRErr      ResetStatement() = 0;
 
     void                BuildFeatureDefn( const char *pszLayerName,
                                            sqlite3_stmt *hStmt );
 
+    bool                IsGeometryBlobOutsideFilter( const GByte* pabyGpkg,
+                                                     int nBytes ) const;
+    bool                IsRowOutsideFilter( sqlite3_stmt* hStmt ) const;
+
+    template<class RowReader> void TranslateRow( const RowReader& oRow,
+                                                 OGRFeature* poFeature );
     OGRFeature*         TranslateFeature(sqlite3_stmt* hStmt);
+    OGRFeature*         GetNextFeatureThreaded();
+    bool                FillRowChunks();
+    void                DiscardRowChunks();
+    static void         TranslateRowChunkFunc( void* pData );
+    void                TranslateFeatureToBatch(sqlite3_stmt* hStmt,
+                                            OGRFeatureBatch* poBatch);
 
   public:
 
@@ -366,11 +400,19 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
     // m_bHasSpatialIndex cannot be bool.  -1 is unset.
     int                         m_bHasSpatialIndex;
     bool                        m_bDropRTreeTable;
+    // SQL of the RTree insert trigger, when it has been suspended during
+    // insertions. The entries of the new features are then accumulated
+    // until FlushPendingRTreeEntries()
+    CPLString                   m_osSuspendedRTreeInsertTrigger;
+    std::vector<GPKGRTreeEntry> m_aoPendingRTreeEntries;
     bool                        m_abHasGeometryExtension[wkbTriangle+1];
     bool                        m_bPreservePrecision;
     bool                        m_bTruncateFields;
     bool                        m_bDeferredCreation;
     int                         m_iFIDAsRegularColumnIndex;
+    bool                        m_bBatchEOF;
+    GByte                      *m_pabyGeomBlob;     // reused across features
+    size_t                      m_nGeomBlobAlloc;
 
     CPLString                   m_osIdentifierLCO;
     CPLString                   m_osDescriptionLCO;
@@ -387,6 +429,8 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
     CPLString           BuildSelectFieldList(const std::vector<OGRFieldDefn*>& apoFields);
     OGRErr              RecreateTable(const CPLString& osColumnsForCreate,
                                       const CPLString& osFieldListForSelect);
+    bool                PopulateRTree(const char* pszTableName);
+    void                SuspendRTreeInsertTrigger();
 #ifdef ENABLE_GPKG_OGR_CONTENTS
     void                CreateTriggers(const char* pszTableName = NULL);
     void                DisableTriggers(bool bNullifyFeatureCount = true);
@@ -418,6 +462,8 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
     OGRErr              SetAttributeFilter( const char *pszQuery ) override;
     OGRErr              SyncToDisk() override;
     OGRFeature*         GetNextFeature() override;
+    int                 GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                         int nMaxFeatures ) override;
     OGRFeature*         GetFeature(GIntBig nFID) override;
     OGRErr              StartTransaction() override;
     OGRErr              CommitTransaction() override;
@@ -446,6 +492,7 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
     void                CreateSpatialIndexIfNecessary();
     bool                CreateSpatialIndex(const char* pszTableName = NULL);
     bool                DropSpatialIndex(bool bCalledFromSQLFunction = false);
+    bool                FlushPendingRTreeEntries();
 
     virtual char **     GetMetadata( const char *pszDomain = NULL ) override;
     virtual const char *GetMetadataItem( const char * pszName,
@@ -5145,20 +5145,21 @@ static bool OGRGeoPackageGetHeader( sqlite3_context* pContext,
     }
     else if( !(psHeader->bExtentHasXY) && bNeedExtent )
     {
-        OGRGeometry *poGeom = GPkgGeometryToOGR(pabyBLOB, nBLOBLen, NULL);
-        if( poGeom == NULL || poGeom->IsEmpty() )
+        // Compute the extent from the WKB, without building the geometry.
+        OGRWKBGeometryView oView;
+        if( oView.Init(pabyBLOB + psHeader->nHeaderLen,
+                       nBLOBLen - psHeader->nHeaderLen) != OGRERR_NONE ||
+            oView.IsEmpty() )
         {
             sqlite3_result_null(pContext);
-            delete poGeom;
             return false;
         }
         OGREnvelope sEnvelope;
-        poGeom->getEnvelope(&sEnvelope);
+        oView.getEnvelope(&sEnvelope);
         psHeader->MinX = sEnvelope.MinX;
         psHeader->MaxX = sEnvelope.MaxX;
         psHeader->MinY = sEnvelope.MinY;
         psHeader->MaxY = sEnvelope.MaxY;
-        delete poGeom;
     }
     return true;
 }
@@ -5858,6 +5859,7 @@ OGRErr GDALGeoPackageDataset::CommitTransaction()
         for( int i = 0; i < m_nLayers; i++ )
         {
             m_papoLayers[i]->RunDeferredCreationIfNecessary();
+            m_papoLayers[i]->FlushPendingRTreeEntries();
         }
     }
 
@@ -34,6 +34,121 @@
 
 CPL_CVSID("$Id$");
 
+// Number of rows converted by a worker thread job.
+#define GPKG_ROWS_PER_CHUNK 512
+
+/************************************************************************/
+/*                         OGRGeoPackageRowChunk                        */
+/*                                                                      */
+/*      Copy of the values of consecutive rows of the query statement,  */
+/*      and the features built from them by a worker thread.            */
+/************************************************************************/
+
+typedef struct
+{
+    int     nType;      // SQLITE_xxx, SQLITE_NULL for columns not fetched
+    int     nBytes;
+    GIntBig nInt;
+    double  dfVal;
+    size_t  nOffset;    // offset of text or blob values in abyData
+} OGRGeoPackageRowValue;
+
+class OGRGeoPackageRowChunk
+{
+  public:
+    OGRGeoPackageLayer                 *poLayer;
+    int                                 nCols;
+    int                                 nRows;
+    std::vector<GIntBig>                anFIDs;
+    std::vector<OGRGeoPackageRowValue>  asValues;
+    std::vector<GByte>                  abyData;
+    std::vector<OGRFeature*>            apoFeatures;
+    size_t                              iNextFeature;
+
+    OGRGeoPackageRowChunk() : poLayer(NULL), nCols(0), nRows(0),
+                              iNextFeature(0) {}
+    ~OGRGeoPackageRowChunk() { Clear(); }
+
+    void Clear()
+    {
+        for( size_t i = iNextFeature; i < apoFeatures.size(); i++ )
+            delete apoFeatures[i];
+        apoFeatures.clear();
+        iNextFeature = 0;
+        nRows = 0;
+        anFIDs.clear();
+        asValues.clear();
+        abyData.clear();
+    }
+};
+
+/************************************************************************/
+/*                      OGRGeoPackageStmtRowReader                      */
+/************************************************************************/
+
+class OGRGeoPackageStmtRowReader
+{
+    sqlite3_stmt *m_hStmt;
+
+  public:
+    explicit OGRGeoPackageStmtRowReader( sqlite3_stmt* hStmt ) :
+        m_hStmt(hStmt) {}
+
+    int GetType( int iCol ) const
+        { return sqlite3_column_type(m_hStmt, iCol); }
+    int GetInt( int iCol ) const
+        { return sqlite3_column_int(m_hStmt, iCol); }
+    GIntBig GetInt64( int iCol ) const
+        { return sqlite3_column_int64(m_hStmt, iCol); }
+    double GetDouble( int iCol ) const
+        { return sqlite3_column_double(m_hStmt, iCol); }
+    const GByte* GetBlob( int iCol, int& nBytes ) const
+    {
+        // coverity[tainted_data_return]
+        const GByte* pabyData = static_cast<const GByte*>(
+                                    sqlite3_column_blob(m_hStmt, iCol));
+        nBytes = sqlite3_column_bytes(m_hStmt, iCol);
+        return pabyData;
+    }
+    const char* GetText( int iCol ) const
+        { return reinterpret_cast<const char*>(
+                                    sqlite3_column_text(m_hStmt, iCol)); }
+};
+
+/************************************************************************/
+/*                     OGRGeoPackageChunkRowReader                      */
+/************************************************************************/
+
+class OGRGeoPackageChunkRowReader
+{
+    const OGRGeoPackageRowChunk *m_poChunk;
+    const OGRGeoPackageRowValue *m_pasValues;
+
+  public:
+    OGRGeoPackageChunkRowReader( const OGRGeoPackageRowChunk* poChunk,
+                                 int iRow ) :
+        m_poChunk(poChunk),
+        m_pasValues(&poChunk->asValues[
+                        static_cast<size_t>(iRow) * poChunk->nCols]) {}
+
+    int GetType( int iCol ) const { return m_pasValues[iCol].nType; }
+    int GetInt( int iCol ) const
+        { return static_cast<int>(m_pasValues[iCol].nInt); }
+    GIntBig GetInt64( int iCol ) const { return m_pasValues[iCol].nInt; }
+    double GetDouble( int iCol ) const { return m_pasValues[iCol].dfVal; }
+    const GByte* GetBlob( int iCol, int& nBytes ) const
+    {
+        nBytes = m_pasValues[iCol].nBytes;
+        return m_poChunk->abyData.empty() ? NULL :
+                    m_poChunk->abyData.data() + m_pasValues[iCol].nOffset;
+    }
+    const char* GetText( int iCol ) const
+    {
+        return reinterpret_cast<const char*>(
+                    &m_poChunk->abyData[m_pasValues[iCol].nOffset]);
+    }
+};
+
 /************************************************************************/
 /*                      OGRGeoPackageLayer()                            */
 /************************************************************************/
@@ -47,7 +162,11 @@ OGRGeoPackageLayer::OGRGeoPackageLayer(GDALGeoPackageDataset *poDS) :
     m_pszFidColumn(NULL),
     iFIDCol(-1),
     iGeomCol(-1),
-    panFieldOrdinals(NULL)
+    panFieldOrdinals(NULL),
+    m_nWorkerThreads(-1),
+    m_poWorkerPool(NULL),
+    m_nConvertedRowChunks(0),
+    m_bRowChunksEOF(false)
 {}
 
 /************************************************************************/
@@ -56,6 +175,10 @@ OGRGeoPackageLayer::OGRGeoPackageLayer(GDALGeoPackageDataset *poDS) :
 
 OGRGeoPackageLayer::~OGRGeoPackageLayer()
 {
+    DiscardRowChunks();
+    for( size_t i = 0; i < m_apoFreeRowChunks.size(); i++ )
+        delete m_apoFreeRowChunks[i];
+    delete m_poWorkerPool;
 
     CPLFree( m_pszFidColumn );
 
@@ -77,6 +200,8 @@ void OGRGeoPackageLayer::ResetReading()
 {
     ClearStatement();
     iNextShapeId = 0;
+    // The number of threads will be evaluated again.
+    m_nWorkerThreads = -1;
 }
 
 /************************************************************************/
@@ -86,6 +211,8 @@ void OGRGeoPackageLayer::ResetReading()
 void OGRGeoPackageLayer::ClearStatement()
 
 {
+    DiscardRowChunks();
+
     if( m_poQueryStatement != NULL )
     {
         CPLDebug( "GPKG", "finalize %p", m_poQueryStatement );
@@ -94,6 +221,85 @@ void OGRGeoPackageLayer::ClearStatement()
     }
 }
 
+/************************************************************************/
+/*                    IsGeometryBlobOutsideFilter()                     */
+/*                                                                      */
+/*      Returns true if the envelope of a GeoPackage geometry blob,     */
+/*      read from its header or computed from its WKB, does not         */
+/*      intersect the envelope of the spatial filter.                   */
+/************************************************************************/
+
+bool OGRGeoPackageLayer::IsGeometryBlobOutsideFilter( const GByte* pabyGpkg,
+                                                      int nBytes ) const
+{
+    GPkgHeader oHeader;
+    if( pabyGpkg == NULL ||
+        GPkgHeaderFromWKB(pabyGpkg, nBytes, &oHeader) != OGRERR_NONE ||
+        oHeader.bEmpty )
+    {
+        return false;
+    }
+
+    double dfMinX = 0.0;
+    double dfMinY = 0.0;
+    double dfMaxX = 0.0;
+    double dfMaxY = 0.0;
+    if( oHeader.bExtentHasXY )
+    {
+        dfMinX = oHeader.MinX;
+        dfMinY = oHeader.MinY;
+        dfMaxX = oHeader.MaxX;
+        dfMaxY = oHeader.MaxY;
+    }
+    else
+    {
+        // Points are generally written without envelope: compute it from
+        // the WKB, without building the geometry.
+        OGRWKBGeometryView oView;
+        if( oHeader.bExtended ||
+            oView.Init(pabyGpkg + oHeader.nHeaderLen,
+                       nBytes - oHeader.nHeaderLen) != OGRERR_NONE ||
+            oView.IsEmpty() )
+        {
+            return false;
+        }
+        OGREnvelope sEnvelope;
+        oView.getEnvelope(&sEnvelope);
+        dfMinX = sEnvelope.MinX;
+        dfMinY = sEnvelope.MinY;
+        dfMaxX = sEnvelope.MaxX;
+        dfMaxY = sEnvelope.MaxY;
+    }
+
+    return dfMaxX < m_sFilterEnvelope.MinX ||
+           dfMaxY < m_sFilterEnvelope.MinY ||
+           m_sFilterEnvelope.MaxX < dfMinX ||
+           m_sFilterEnvelope.MaxY < dfMinY;
+}
+
+/************************************************************************/
+/*                         IsRowOutsideFilter()                         */
+/*                                                                      */
+/*      Whether the current row can be discarded by the spatial filter  */
+/*      without building its geometry.                                  */
+/************************************************************************/
+
+bool OGRGeoPackageLayer::IsRowOutsideFilter( sqlite3_stmt* hStmt ) const
+{
+    if( m_poFilterGeom == NULL || m_iGeomFieldFilter != 0 || iGeomCol < 0 ||
+        m_poFeatureDefn->GetGeomFieldDefn(0)->IsIgnored() ||
+        sqlite3_column_type(hStmt, iGeomCol) != SQLITE_BLOB )
+    {
+        return false;
+    }
+
+    // coverity[tainted_data_return]
+    const GByte* pabyGpkg = static_cast<const GByte*>(
+                                    sqlite3_column_blob(hStmt, iGeomCol));
+    return IsGeometryBlobOutsideFilter(pabyGpkg,
+                                       sqlite3_column_bytes(hStmt, iGeomCol));
+}
+
 /************************************************************************/
 /*                           GetNextFeature()                           */
 /************************************************************************/
@@ -101,6 +307,32 @@ void OGRGeoPackageLayer::ClearStatement()
 OGRFeature *OGRGeoPackageLayer::GetNextFeature()
 
 {
+    if( m_nWorkerThreads < 0 )
+    {
+        // Features are read ahead, which is only safe if the table
+        // cannot be modified in the meantime.
+        m_nWorkerThreads = 1;
+        if( !m_poDS->GetUpdate() )
+        {
+            m_nWorkerThreads = CPLGetNumThreadsOption("OGR_GPKG_NUM_THREADS",
+                            CPLGetNumThreadsOption("GDAL_NUM_THREADS", 1));
+        }
+        if( m_nWorkerThreads > 1 && m_poWorkerPool == NULL )
+        {
+            m_poWorkerPool = new CPLWorkerThreadPool();
+            if( !m_poWorkerPool->Setup(m_nWorkerThreads, NULL, NULL) )
+            {
+                delete m_poWorkerPool;
+                m_poWorkerPool = NULL;
+                m_nWorkerThreads = 1;
+            }
+        }
+        if( m_poWorkerPool != NULL )
+            m_nWorkerThreads = m_poWorkerPool->GetThreadCount();
+    }
+    if( m_nWorkerThreads > 1 )
+        return GetNextFeatureThreaded();
+
     for( ; true; )
     {
         if( m_poQueryStatement == NULL )
@@ -136,6 +368,13 @@ OGRFeature *OGRGeoPackageLayer::GetNextFeature()
             bDoStep = true;
         }
 
+        if( IsRowOutsideFilter(m_poQueryStatement) )
+        {
+            iNextShapeId++;
+            m_nFeaturesRead++;
+            continue;
+        }
+
         OGRFeature *poFeature = TranslateFeature(m_poQueryStatement);
 
         if( (m_poFilterGeom == NULL
@@ -148,6 +387,285 @@ OGRFeature *OGRGeoPackageLayer::GetNextFeature()
     }
 }
 
+/************************************************************************/
+/*                       GetNextFeatureThreaded()                       */
+/*                                                                      */
+/*      Return the features converted by the worker threads. The        */
+/*      spatial and attribute filters are evaluated here.               */
+/************************************************************************/
+
+OGRFeature *OGRGeoPackageLayer::GetNextFeatureThreaded()
+
+{
+    for( ; true; )
+    {
+        while( m_nConvertedRowChunks > 0 )
+        {
+            OGRGeoPackageRowChunk* poChunk = m_apoRowChunks.front();
+            if( poChunk->iNextFeature < poChunk->apoFeatures.size() )
+            {
+                OGRFeature* poFeature =
+                    poChunk->apoFeatures[poChunk->iNextFeature];
+                poChunk->apoFeatures[poChunk->iNextFeature] = NULL;
+                poChunk->iNextFeature++;
+
+                if( (m_poFilterGeom == NULL
+                    || FilterGeometry(
+                            poFeature->GetGeomFieldRef(m_iGeomFieldFilter) ) )
+                    && (m_poAttrQuery == NULL
+                        || m_poAttrQuery->Evaluate( poFeature )) )
+                    return poFeature;
+
+                delete poFeature;
+                continue;
+            }
+
+            poChunk->Clear();
+            m_apoFreeRowChunks.push_back(poChunk);
+            m_apoRowChunks.pop_front();
+            m_nConvertedRowChunks--;
+        }
+
+        if( m_apoRowChunks.empty() && !FillRowChunks() )
+        {
+            // Next call will restart reading, as in the single threaded
+            // case.
+            m_bRowChunksEOF = false;
+            return NULL;
+        }
+
+        m_poWorkerPool->WaitCompletion();
+        m_nConvertedRowChunks = m_apoRowChunks.size();
+
+        // Keep the worker threads busy while the features are consumed.
+        FillRowChunks();
+    }
+}
+
+/************************************************************************/
+/*                           FillRowChunks()                            */
+/*                                                                      */
+/*      Step the query statement to copy the values of the next rows    */
+/*      into chunks, and submit their conversion to the worker          */
+/*      threads. Returns false if no row could be read.                 */
+/************************************************************************/
+
+bool OGRGeoPackageLayer::FillRowChunks()
+
+{
+    if( m_bRowChunksEOF )
+        return false;
+
+    if( m_poQueryStatement == NULL )
+    {
+        ResetStatement();
+        if (m_poQueryStatement == NULL)
+            return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Determine how each column will be read.                         */
+/* -------------------------------------------------------------------- */
+    const int nCols = sqlite3_column_count(m_poQueryStatement);
+    std::vector<int> anColTypes(nCols, SQLITE_NULL);
+    if( iGeomCol >= 0 && !m_poFeatureDefn->GetGeomFieldDefn(0)->IsIgnored() )
+        anColTypes[iGeomCol] = SQLITE_BLOB;
+    for( int iField = 0; iField < m_poFeatureDefn->GetFieldCount(); iField++ )
+    {
+        OGRFieldDefn *poFieldDefn = m_poFeatureDefn->GetFieldDefn( iField );
+        if ( poFieldDefn->IsIgnored() )
+            continue;
+        int nColType = SQLITE_TEXT;
+        switch( poFieldDefn->GetType() )
+        {
+            case OFTInteger:
+            case OFTInteger64:
+                nColType = SQLITE_INTEGER;
+                break;
+            case OFTReal:
+                nColType = SQLITE_FLOAT;
+                break;
+            case OFTBinary:
+                nColType = SQLITE_BLOB;
+                break;
+            default:
+                break;
+        }
+        anColTypes[panFieldOrdinals[iField]] = nColType;
+    }
+
+    const int nMaxChunks = 2 * m_nWorkerThreads;
+    std::vector<void*> apoChunks;
+    while( static_cast<int>(apoChunks.size()) < nMaxChunks &&
+           !m_bRowChunksEOF )
+    {
+        OGRGeoPackageRowChunk* poChunk = NULL;
+        if( m_apoFreeRowChunks.empty() )
+            poChunk = new OGRGeoPackageRowChunk();
+        else
+        {
+            poChunk = m_apoFreeRowChunks.back();
+            m_apoFreeRowChunks.pop_back();
+        }
+        poChunk->poLayer = this;
+        poChunk->nCols = nCols;
+
+        while( poChunk->nRows < GPKG_ROWS_PER_CHUNK )
+        {
+            if( bDoStep )
+            {
+                int rc = sqlite3_step( m_poQueryStatement );
+                if( rc != SQLITE_ROW )
+                {
+                    if ( rc != SQLITE_DONE )
+                    {
+                        sqlite3_reset(m_poQueryStatement);
+                        CPLError( CE_Failure, CPLE_AppDefined,
+                                "In GetNextRawFeature(): sqlite3_step() : %s",
+                                sqlite3_errmsg(m_poDS->GetDB()) );
+                    }
+
+                    // Do not call ClearStatement() that would discard
+                    // the pending chunks.
+                    sqlite3_finalize( m_poQueryStatement );
+                    m_poQueryStatement = NULL;
+                    m_bRowChunksEOF = true;
+                    break;
+                }
+            }
+            else
+            {
+                bDoStep = true;
+            }
+
+            GIntBig nFID = iNextShapeId;
+            if( iFIDCol >= 0 )
+            {
+                nFID = sqlite3_column_int64( m_poQueryStatement, iFIDCol );
+                if( m_pszFidColumn == NULL && nFID == 0 )
+                {
+                    // Miht be the case for views with joins.
+                    nFID = iNextShapeId;
+                }
+            }
+            iNextShapeId++;
+            m_nFeaturesRead++;
+
+            if( IsRowOutsideFilter(m_poQueryStatement) )
+                continue;
+
+            poChunk->anFIDs.push_back(nFID);
+            const size_t nValueOffset = poChunk->asValues.size();
+            poChunk->asValues.resize(nValueOffset + nCols);
+            OGRGeoPackageRowValue* pasValues = &poChunk->asValues[nValueOffset];
+            for( int iCol = 0; iCol < nCols; iCol++ )
+            {
+                OGRGeoPackageRowValue& sValue = pasValues[iCol];
+                sValue.nType = SQLITE_NULL;
+                if( anColTypes[iCol] == SQLITE_NULL )
+                    continue;
+                sValue.nType = sqlite3_column_type(m_poQueryStatement, iCol);
+                if( sValue.nType == SQLITE_NULL )
+                    continue;
+                switch( anColTypes[iCol] )
+                {
+                    case SQLITE_INTEGER:
+                        sValue.nInt =
+                            sqlite3_column_int64(m_poQueryStatement, iCol);
+                        break;
+
+                    case SQLITE_FLOAT:
+                        sValue.dfVal =
+                            sqlite3_column_double(m_poQueryStatement, iCol);
+                        break;
+
+                    default:
+                    {
+                        // Text values are nul terminated.
+                        const GByte* pabyData =
+                            anColTypes[iCol] == SQLITE_BLOB ?
+                            static_cast<const GByte*>(
+                                sqlite3_column_blob(m_poQueryStatement, iCol)) :
+                            sqlite3_column_text(m_poQueryStatement, iCol);
+                        const int nBytes =
+                            sqlite3_column_bytes(m_poQueryStatement, iCol);
+                        sValue.nBytes = nBytes;
+                        sValue.nOffset = poChunk->abyData.size();
+                        if( pabyData != NULL )
+                        {
+                            poChunk->abyData.insert(poChunk->abyData.end(),
+                                                    pabyData,
+                                                    pabyData + nBytes);
+                        }
+                        if( anColTypes[iCol] == SQLITE_TEXT )
+                            poChunk->abyData.push_back(0);
+                        break;
+                    }
+                }
+            }
+            poChunk->nRows++;
+        }
+
+        if( poChunk->nRows == 0 )
+        {
+            m_apoFreeRowChunks.push_back(poChunk);
+            continue;
+        }
+        m_apoRowChunks.push_back(poChunk);
+        apoChunks.push_back(poChunk);
+    }
+
+    if( apoChunks.empty() )
+        return false;
+    m_poWorkerPool->SubmitJobs(TranslateRowChunkFunc, apoChunks);
+    return true;
+}
+
+/************************************************************************/
+/*                       TranslateRowChunkFunc()                        */
+/*                                                                      */
+/*      Run by a worker thread to build the features of a chunk.        */
+/************************************************************************/
+
+void OGRGeoPackageLayer::TranslateRowChunkFunc( void* pData )
+
+{
+    OGRGeoPackageRowChunk* poChunk =
+        static_cast<OGRGeoPackageRowChunk*>(pData);
+    OGRGeoPackageLayer* poLayer = poChunk->poLayer;
+
+    poChunk->apoFeatures.resize(poChunk->nRows);
+    for( int iRow = 0; iRow < poChunk->nRows; iRow++ )
+    {
+        OGRFeature *poFeature = new OGRFeature( poLayer->m_poFeatureDefn );
+        poFeature->SetFID( poChunk->anFIDs[iRow] );
+        poLayer->TranslateRow(OGRGeoPackageChunkRowReader(poChunk, iRow),
+                              poFeature);
+        poChunk->apoFeatures[iRow] = poFeature;
+    }
+}
+
+/************************************************************************/
+/*                          DiscardRowChunks()                          */
+/************************************************************************/
+
+void OGRGeoPackageLayer::DiscardRowChunks()
+
+{
+    if( !m_apoRowChunks.empty() )
+    {
+        m_poWorkerPool->WaitCompletion();
+        for( size_t i = 0; i < m_apoRowChunks.size(); i++ )
+        {
+            m_apoRowChunks[i]->Clear();
+            m_apoFreeRowChunks.push_back(m_apoRowChunks[i]);
+        }
+        m_apoRowChunks.clear();
+    }
+    m_nConvertedRowChunks = 0;
+    m_bRowChunksEOF = false;
+}
+
 /************************************************************************/
 /*                         TranslateFeature()                           */
 /************************************************************************/
@@ -179,19 +697,37 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
 
     m_nFeaturesRead++;
 
+    TranslateRow(OGRGeoPackageStmtRowReader(hStmt), poFeature);
+
+    return poFeature;
+}
+
+/************************************************************************/
+/*                            TranslateRow()                            */
+/*                                                                      */
+/*      Set the geometry and fields of a feature from a row, read       */
+/*      either from the statement or from a chunk. Must not modify      */
+/*      the layer state, as it is run by the worker threads.            */
+/************************************************************************/
+
+template<class RowReader>
+void OGRGeoPackageLayer::TranslateRow( const RowReader& oRow,
+                                       OGRFeature* poFeature )
+
+{
 /* -------------------------------------------------------------------- */
 /*      Process Geometry if we have a column.                           */
 /* -------------------------------------------------------------------- */
     if( iGeomCol >= 0 )
     {
         OGRGeomFieldDefn* poGeomFieldDefn = m_poFeatureDefn->GetGeomFieldDefn(0);
-        if ( sqlite3_column_type(hStmt, iGeomCol) != SQLITE_NULL &&
+        if ( oRow.GetType(iGeomCol) != SQLITE_NULL &&
             !poGeomFieldDefn->IsIgnored() )
         {
             OGRSpatialReference* poSrs = poGeomFieldDefn->GetSpatialRef();
-            int iGpkgSize = sqlite3_column_bytes(hStmt, iGeomCol);
-            // coverity[tainted_data_return]
-            GByte *pabyGpkg = (GByte *)sqlite3_column_blob(hStmt, iGeomCol);
+            int iGpkgSize = 0;
+            GByte *pabyGpkg = const_cast<GByte*>(
+                                    oRow.GetBlob(iGeomCol, iGpkgSize));
             OGRGeometry *poGeom = GPkgGeometryToOGR(pabyGpkg, iGpkgSize, NULL);
             if ( poGeom == NULL )
             {
@@ -219,7 +755,7 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
 
         const int iRawField = panFieldOrdinals[iField];
 
-        if( sqlite3_column_type( hStmt, iRawField ) == SQLITE_NULL )
+        if( oRow.GetType( iRawField ) == SQLITE_NULL )
         {
             poFeature->SetFieldNull( iField );
             continue;
@@ -228,17 +764,158 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
         switch( poFieldDefn->GetType() )
         {
             case OFTInteger:
-                poFeature->SetField( iField,
+                poFeature->SetField( iField, oRow.GetInt( iRawField ) );
+                break;
+
+            case OFTInteger64:
+                poFeature->SetField( iField, oRow.GetInt64( iRawField ) );
+                break;
+
+            case OFTReal:
+                poFeature->SetField( iField, oRow.GetDouble( iRawField ) );
+                break;
+
+            case OFTBinary:
+            {
+                int nBytes = 0;
+                const GByte* pabyData = oRow.GetBlob( iRawField, nBytes );
+                poFeature->SetField( iField, nBytes,
+                                     const_cast<GByte*>(pabyData) );
+                break;
+            }
+
+            case OFTDate:
+            {
+                const char* pszTxt = oRow.GetText( iRawField );
+                int nYear, nMonth, nDay;
+                if( sscanf(pszTxt, "%d-%d-%d", &nYear, &nMonth, &nDay) == 3 )
+                    poFeature->SetField(iField, nYear, nMonth, nDay, 0, 0, 0, 0);
+                break;
+            }
+
+            case OFTDateTime:
+            {
+                const char* pszTxt = oRow.GetText( iRawField );
+                OGRField sField;
+                if( OGRParseXMLDateTime(pszTxt, &sField) )
+                    poFeature->SetField(iField, &sField);
+                break;
+            }
+
+            case OFTTime:
+            case OFTString:
+                poFeature->SetField( iField, oRow.GetText( iRawField ) );
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+/************************************************************************/
+/*                      TranslateFeatureToBatch()                       */
+/*                                                                      */
+/*      Same as TranslateFeature(), but append the current row to a     */
+/*      batch. Geometry blobs whose WKB is already ISO WKB in little    */
+/*      endian order are copied as such, without building an           */
+/*      OGRGeometry.                                                    */
+/************************************************************************/
+
+void OGRGeoPackageLayer::TranslateFeatureToBatch( sqlite3_stmt* hStmt,
+                                                  OGRFeatureBatch* poBatch )
+
+{
+    poBatch->AddFeature();
+
+    GIntBig nFID = iNextShapeId;
+    if( iFIDCol >= 0 )
+    {
+        nFID = sqlite3_column_int64( hStmt, iFIDCol );
+        if( m_pszFidColumn == NULL && nFID == 0 )
+        {
+            // Miht be the case for views with joins.
+            nFID = iNextShapeId;
+        }
+    }
+    poBatch->SetFID( nFID );
+
+    iNextShapeId++;
+
+    m_nFeaturesRead++;
+
+/* -------------------------------------------------------------------- */
+/*      Process Geometry if we have a column.                           */
+/* -------------------------------------------------------------------- */
+    if( iGeomCol >= 0 &&
+        sqlite3_column_type(hStmt, iGeomCol) != SQLITE_NULL &&
+        !m_poFeatureDefn->GetGeomFieldDefn(0)->IsIgnored() )
+    {
+        const int iGpkgSize = sqlite3_column_bytes(hStmt, iGeomCol);
+        // coverity[tainted_data_return]
+        const GByte *pabyGpkg = static_cast<const GByte*>(
+                                    sqlite3_column_blob(hStmt, iGeomCol));
+        GPkgHeader oHeader;
+        GUInt32 nWKBType = 0;
+        if( GPkgHeaderFromWKB(pabyGpkg, iGpkgSize, &oHeader) == OGRERR_NONE &&
+            !oHeader.bExtended &&
+            static_cast<size_t>(iGpkgSize) >= oHeader.nHeaderLen + 5 &&
+            pabyGpkg[oHeader.nHeaderLen] == wkbNDR )
+        {
+            memcpy(&nWKBType, pabyGpkg + oHeader.nHeaderLen + 1, 4);
+            CPL_LSBPTR32(&nWKBType);
+        }
+        if( nWKBType != 0 && nWKBType < 4000 )
+        {
+            poBatch->SetGeomFieldWKB(0, pabyGpkg + oHeader.nHeaderLen,
+                                     iGpkgSize - oHeader.nHeaderLen);
+        }
+        else
+        {
+            OGRGeometry *poGeom = GPkgGeometryToOGR(pabyGpkg, iGpkgSize, NULL);
+            if ( poGeom == NULL )
+            {
+                // Try also spatialite geometry blobs
+                if( OGRSQLiteLayer::ImportSpatiaLiteGeometry( pabyGpkg, iGpkgSize,
+                                                              &poGeom ) != OGRERR_NONE )
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined, "Unable to read geometry");
+                }
+            }
+            poBatch->SetGeomField(0, poGeom);
+            delete poGeom;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      set the fields.                                                 */
+/* -------------------------------------------------------------------- */
+    for( int iField = 0; iField < m_poFeatureDefn->GetFieldCount(); iField++ )
+    {
+        OGRFieldDefn *poFieldDefn = m_poFeatureDefn->GetFieldDefn( iField );
+        if ( poFieldDefn->IsIgnored() )
+            continue;
+
+        const int iRawField = panFieldOrdinals[iField];
+
+        if( sqlite3_column_type( hStmt, iRawField ) == SQLITE_NULL )
+            continue;
+
+        switch( poFieldDefn->GetType() )
+        {
+            case OFTInteger:
+                poBatch->SetField( iField,
                     sqlite3_column_int( hStmt, iRawField ) );
                 break;
 
             case OFTInteger64:
-                poFeature->SetField( iField,
-                    sqlite3_column_int64( hStmt, iRawField ) );
+                poBatch->SetField( iField,
+                    static_cast<GIntBig>(
+                        sqlite3_column_int64( hStmt, iRawField ) ) );
                 break;
 
             case OFTReal:
-                poFeature->SetField( iField,
+                poBatch->SetField( iField,
                     sqlite3_column_double( hStmt, iRawField ) );
                 break;
 
@@ -248,8 +925,7 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
                 // coverity[tainted_data_return]
                 const GByte* pabyData = reinterpret_cast<const GByte*>(
                     sqlite3_column_blob( hStmt, iRawField ) );
-                poFeature->SetField( iField, nBytes,
-                                     const_cast<GByte*>(pabyData) );
+                poBatch->SetField( iField, nBytes, pabyData );
                 break;
             }
 
@@ -258,7 +934,14 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
                 const char* pszTxt = (const char*)sqlite3_column_text( hStmt, iRawField );
                 int nYear, nMonth, nDay;
                 if( sscanf(pszTxt, "%d-%d-%d", &nYear, &nMonth, &nDay) == 3 )
-                    poFeature->SetField(iField, nYear, nMonth, nDay, 0, 0, 0, 0);
+                {
+                    OGRField sField;
+                    memset(&sField, 0, sizeof(sField));
+                    sField.Date.Year = static_cast<GInt16>(nYear);
+                    sField.Date.Month = static_cast<GByte>(nMonth);
+                    sField.Date.Day = static_cast<GByte>(nDay);
+                    poBatch->SetField(iField, &sField);
+                }
                 break;
             }
 
@@ -267,21 +950,29 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
                 const char* pszTxt = (const char*)sqlite3_column_text( hStmt, iRawField );
                 OGRField sField;
                 if( OGRParseXMLDateTime(pszTxt, &sField) )
-                    poFeature->SetField(iField, &sField);
+                    poBatch->SetField(iField, &sField);
                 break;
             }
 
             case OFTString:
-                poFeature->SetField( iField,
-                        (const char *) sqlite3_column_text( hStmt, iRawField ) );
+            {
+                const char* pszTxt = reinterpret_cast<const char*>(
+                    sqlite3_column_text( hStmt, iRawField ) );
+                poBatch->SetFieldString( iField, pszTxt,
+                    sqlite3_column_bytes( hStmt, iRawField ) );
+                break;
+            }
+
+            case OFTTime:
+                // Parsed from its text representation, as in TranslateRow().
+                poBatch->SetField( iField, reinterpret_cast<const char*>(
+                    sqlite3_column_text( hStmt, iRawField ) ) );
                 break;
 
             default:
                 break;
         }
     }
-
-    return poFeature;
 }
 
 /************************************************************************/
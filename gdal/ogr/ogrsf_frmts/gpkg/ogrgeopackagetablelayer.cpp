@@ -33,6 +33,10 @@
 #include "cpl_time.h"
 #include "ogr_p.h"
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
 CPL_CVSID("$Id$");
 
 static const char UNSUPPORTED_OP_READ_ONLY[] =
@@ -204,11 +208,14 @@ OGRErr OGRGeoPackageTableLayer::FeatureBindParameters( OGRFeature *poFeature,
         OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
         if ( poGeom )
         {
-            GByte *pabyWkb = NULL;
+            // The blob is written in a buffer owned by the layer, which
+            // remains valid until the statement has been stepped.
             size_t szWkb = 0;
-            pabyWkb = GPkgGeometryFromOGR(poGeom, m_iSrs, &szWkb);
+            GByte *pabyWkb = GPkgGeometryFromOGR(poGeom, m_iSrs, &szWkb,
+                                                 &m_pabyGeomBlob,
+                                                 &m_nGeomBlobAlloc);
             err = sqlite3_bind_blob(poStmt, nColCount++, pabyWkb,
-                                    static_cast<int>(szWkb), CPLFree);
+                                    static_cast<int>(szWkb), SQLITE_STATIC);
             MY_CPLAssert( err == SQLITE_OK );
 
             CreateGeometryExtensionIfNecessary(poGeom);
@@ -268,6 +275,10 @@ OGRErr OGRGeoPackageTableLayer::FeatureBindParameters( OGRFeature *poFeature,
                 {
                     const char *pszVal = poFeature->GetFieldAsString(i);
                     int nValLengthBytes = (int)strlen(pszVal);
+                    // String values are owned by the feature, which outlives
+                    // the statement execution, so no copy is needed.
+                    const bool bOwnedByFeature =
+                        poFieldDefn->GetType() == OFTString;
                     char szVal[32];
                     int nYear, nMonth, nDay, nHour, nMinute, nSecond, nTZFlag;
                     CPLString osTemp;
@@ -340,7 +351,8 @@ OGRErr OGRGeoPackageTableLayer::FeatureBindParameters( OGRFeature *poFeature,
                             }
                         }
                     }
-                    err = sqlite3_bind_text(poStmt, nColCount++, pszVal, nValLengthBytes, SQLITE_TRANSIENT);
+                    err = sqlite3_bind_text(poStmt, nColCount++, pszVal, nValLengthBytes,
+                        (bOwnedByFeature && osTemp.empty()) ? SQLITE_STATIC : SQLITE_TRANSIENT);
                     MY_CPLAssert( err == SQLITE_OK );
                     break;
                 }
@@ -988,6 +1000,9 @@ OGRGeoPackageTableLayer::OGRGeoPackageTableLayer(
     m_bTruncateFields(false),
     m_bDeferredCreation(false),
     m_iFIDAsRegularColumnIndex(-1),
+    m_bBatchEOF(false),
+    m_pabyGeomBlob(NULL),
+    m_nGeomBlobAlloc(0),
     m_bHasReadMetadataFromStorage(false),
     m_bHasTriedDetectingFID64(false),
     m_eASPatialVariant(GPKG_ATTRIBUTES)
@@ -1031,6 +1046,8 @@ OGRGeoPackageTableLayer::~OGRGeoPackageTableLayer()
 
     if ( m_poInsertStatement )
         sqlite3_finalize(m_poInsertStatement);
+
+    CPLFree( m_pabyGeomBlob );
 }
 
 /************************************************************************/
@@ -1505,6 +1522,8 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
         }
     }
 
+    SuspendRTreeInsertTrigger();
+
     /* If there's a unset field with a default value, then we must create */
     /* a specific INSERT statement to avoid unset fields to be bound to NULL */
     if( m_poInsertStatement && (bHasDefaultValue || m_bInsertStatementWithFID != (poFeature->GetFID() != OGRNullFID)) )
@@ -1569,16 +1588,29 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
         m_poInsertStatement = NULL;
     }
 
+    /* Read the latest FID value */
+    GIntBig nFID = sqlite3_last_insert_rowid(m_poDS->GetDB());
+
     /* Update the layer extents with this new object */
     if( IsGeomFieldSet(poFeature) )
     {
         OGREnvelope oEnv;
-        poFeature->GetGeomFieldRef(0)->getEnvelope(&oEnv);
+        const OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
+        poGeom->getEnvelope(&oEnv);
         UpdateExtent(&oEnv);
-    }
 
-    /* Read the latest FID value */
-    GIntBig nFID = sqlite3_last_insert_rowid(m_poDS->GetDB());
+        /* Do the job of the suspended RTree insert trigger */
+        if( !m_osSuspendedRTreeInsertTrigger.empty() && !poGeom->IsEmpty() )
+        {
+            GPKGRTreeEntry sEntry;
+            sEntry.nId = nFID;
+            sEntry.dfMinX = oEnv.MinX;
+            sEntry.dfMinY = oEnv.MinY;
+            sEntry.dfMaxX = oEnv.MaxX;
+            sEntry.dfMaxY = oEnv.MaxY;
+            m_aoPendingRTreeEntries.push_back(sEntry);
+        }
+    }
     if( nFID || poFeature->GetFID() == 0 )
     {
         poFeature->SetFID(nFID);
@@ -1638,6 +1670,8 @@ OGRErr OGRGeoPackageTableLayer::ISetFeature( OGRFeature *poFeature )
     if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
         return OGRERR_FAILURE;
 
+    FlushPendingRTreeEntries();
+
     /* Old version of SQLite have issues with some of the spatial index triggers */
 #if SQLITE_VERSION_NUMBER < 3007008
     if( HasSpatialIndex() )
@@ -1772,6 +1806,7 @@ void OGRGeoPackageTableLayer::ResetReading()
         return;
 
     OGRGeoPackageLayer::ResetReading();
+    m_bBatchEOF = false;
 
     if ( m_poInsertStatement )
     {
@@ -1797,6 +1832,9 @@ OGRErr OGRGeoPackageTableLayer::ResetStatement()
 {
     ClearStatement();
 
+    /* The spatial filter might use the RTree */
+    FlushPendingRTreeEntries();
+
     /* There is no active query statement set up, */
     /* so job #1 is to prepare the statement. */
     /* Append the attribute filter, if there is one */
@@ -1886,6 +1924,86 @@ OGRFeature* OGRGeoPackageTableLayer::GetNextFeature()
     return poFeature;
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRGeoPackageTableLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                                  int nMaxFeatures )
+{
+    // Spatial filtering needs the geometries, and attribute filters that
+    // could not be translated to SQL need OGRFeature.
+    // Rows already read ahead by GetNextFeature() in multi-threaded mode
+    // must be returned first.
+    if( m_poFilterGeom != NULL || m_poAttrQuery != NULL ||
+        !m_apoRowChunks.empty() )
+        return OGRLayer::GetNextFeatureBatch(poBatch, nMaxFeatures);
+
+    poBatch->Reset();
+
+    if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
+        return 0;
+
+    if( !poBatch->IsCompatibleWith(m_poFeatureDefn) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Batch not created from the current layer definition" );
+        return 0;
+    }
+
+    // The previous batch reached the end of the result set: report it,
+    // as GetNextFeature() would return NULL.
+    if( m_bBatchEOF )
+    {
+        m_bBatchEOF = false;
+        return 0;
+    }
+
+    CreateSpatialIndexIfNecessary();
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        if( m_poQueryStatement == NULL )
+        {
+            ResetStatement();
+            if (m_poQueryStatement == NULL)
+                break;
+        }
+
+        if( bDoStep )
+        {
+            int rc = sqlite3_step( m_poQueryStatement );
+            if( rc != SQLITE_ROW )
+            {
+                if ( rc != SQLITE_DONE )
+                {
+                    sqlite3_reset(m_poQueryStatement);
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                            "In GetNextFeatureBatch(): sqlite3_step() : %s",
+                            sqlite3_errmsg(m_poDS->GetDB()) );
+                }
+
+                ClearStatement();
+                m_bBatchEOF = poBatch->GetFeatureCount() > 0;
+                break;
+            }
+        }
+        else
+        {
+            bDoStep = true;
+        }
+
+        TranslateFeatureToBatch(m_poQueryStatement, poBatch);
+        if( m_iFIDAsRegularColumnIndex >= 0 )
+        {
+            poBatch->SetField(m_iFIDAsRegularColumnIndex,
+                        poBatch->GetFIDs()[poBatch->GetFeatureCount() - 1]);
+        }
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                        GetFeature()                                  */
 /************************************************************************/
@@ -1961,6 +2079,8 @@ OGRErr OGRGeoPackageTableLayer::DeleteFeature(GIntBig nFID)
     if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
         return OGRERR_FAILURE;
 
+    FlushPendingRTreeEntries();
+
 #ifdef ENABLE_GPKG_OGR_CONTENTS
     if( m_bOGRFeatureCountTriggersEnabled )
     {
@@ -2008,6 +2128,8 @@ OGRErr OGRGeoPackageTableLayer::SyncToDisk()
     CreateTriggers();
 #endif
 
+    FlushPendingRTreeEntries();
+
     if( !m_bDropRTreeTable )
     {
         CreateSpatialIndexIfNecessary();
@@ -2053,6 +2175,8 @@ OGRErr OGRGeoPackageTableLayer::RollbackTransaction()
 
 GIntBig OGRGeoPackageTableLayer::GetFeatureCount( int /*bForce*/ )
 {
+    FlushPendingRTreeEntries();
+
 #ifdef ENABLE_GPKG_OGR_CONTENTS
     if( m_poFilterGeom == NULL && m_pszAttrQueryString == NULL )
     {
@@ -2304,93 +2428,283 @@ void OGRGeoPackageTableLayer::CreateSpatialIndexIfNecessary()
 }
 
 /************************************************************************/
-/*                       CreateSpatialIndex()                           */
+/*                          GPKGBulkLoadRTree()                         */
 /************************************************************************/
 
+/* Content of a cell of a node of the SQLite rtree (see */
+/* sqlite/ext/rtree/rtree.c): the rowid for a leaf, the child node number */
+/* otherwise, followed by minx, maxx, miny, maxy as 32 bit floats */
 typedef struct
 {
     GIntBig nId;
-    double  dfMinX;
-    double  dfMinY;
-    double  dfMaxX;
-    double  dfMaxY;
-} GPKGRTreeEntry;
+    float   afCoords[4];
+} GPKGRTreeCell;
 
-bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
+static const int knRTreeBytesPerCell = 8 + 4 * 4;
+
+/* Float rounding done by rtreeValueDown() and rtreeValueUp() of rtree.c */
+static float GPKGRTreeValueDown( double d )
 {
-    OGRErr err;
+    float f = static_cast<float>(d);
+    if( f > d )
+        f = static_cast<float>(d * (d < 0 ? (1.0 + 1.0 / 8388608.0) :
+                                            (1.0 - 1.0 / 8388608.0)));
+    return f;
+}
 
-    if( !CheckUpdatableTable("CreateSpatialIndex") )
-        return false;
+static float GPKGRTreeValueUp( double d )
+{
+    float f = static_cast<float>(d);
+    if( f < d )
+        f = static_cast<float>(d * (d < 0 ? (1.0 - 1.0 / 8388608.0) :
+                                            (1.0 + 1.0 / 8388608.0)));
+    return f;
+}
 
-    if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
-        return false;
+static bool GPKGRTreeCellCenterXLess( const GPKGRTreeCell& a,
+                                      const GPKGRTreeCell& b )
+{
+    return a.afCoords[0] + a.afCoords[1] < b.afCoords[0] + b.afCoords[1];
+}
 
-    m_bDeferredSpatialIndexCreation = false;
+static bool GPKGRTreeCellCenterYLess( const GPKGRTreeCell& a,
+                                      const GPKGRTreeCell& b )
+{
+    return a.afCoords[2] + a.afCoords[3] < b.afCoords[2] + b.afCoords[3];
+}
 
-    if( m_pszFidColumn == NULL )
-        return false;
+/* Order the cells with the Sort-Tile-Recursive algorithm, so that each */
+/* run of nNodeCapacity consecutive cells forms a compact node */
+static void GPKGRTreeSortTileRecursive( std::vector<GPKGRTreeCell>& asCells,
+                                        size_t nNodeCapacity )
+{
+    const size_t nNodes = (asCells.size() + nNodeCapacity - 1) / nNodeCapacity;
+    const size_t nSlices = static_cast<size_t>(
+                            ceil(sqrt(static_cast<double>(nNodes))));
+    const size_t nSliceSize =
+        ((nNodes + nSlices - 1) / nSlices) * nNodeCapacity;
 
-    if( HasSpatialIndex() )
+    std::sort( asCells.begin(), asCells.end(), GPKGRTreeCellCenterXLess );
+    for( size_t i = 0; i < asCells.size(); i += nSliceSize )
     {
-        CPLError(CE_Failure, CPLE_AppDefined, "Spatial index already existing");
-        return false;
+        std::sort( asCells.begin() + i,
+                   asCells.begin() + std::min(i + nSliceSize, asCells.size()),
+                   GPKGRTreeCellCenterYLess );
     }
+}
 
-    if( m_poFeatureDefn->GetGeomFieldCount() == 0 )
+static void GPKGRTreeEncodeNode( std::vector<GByte>& abyNode, int nDepth,
+                                 const GPKGRTreeCell* pasCells, int nCells )
+{
+    std::fill( abyNode.begin(), abyNode.end(), static_cast<GByte>(0) );
+    GUInt16 nVal16 = static_cast<GUInt16>(nDepth);
+    CPL_MSBPTR16(&nVal16);
+    memcpy( &abyNode[0], &nVal16, 2 );
+    nVal16 = static_cast<GUInt16>(nCells);
+    CPL_MSBPTR16(&nVal16);
+    memcpy( &abyNode[2], &nVal16, 2 );
+    GByte* pabyCell = &abyNode[4];
+    for( int i = 0; i < nCells; i++ )
+    {
+        GIntBig nId = pasCells[i].nId;
+        CPL_MSBPTR64(&nId);
+        memcpy( pabyCell, &nId, 8 );
+        for( int j = 0; j < 4; j++ )
+        {
+            float fVal = pasCells[i].afCoords[j];
+            CPL_MSBPTR32(&fVal);
+            memcpy( pabyCell + 8 + 4 * j, &fVal, 4 );
+        }
+        pabyCell += knRTreeBytesPerCell;
+    }
+}
+
+static bool GPKGRTreeInsertPair( sqlite3* hDB, sqlite3_stmt* hStmt,
+                                 GIntBig nVal1, GIntBig nVal2 )
+{
+    sqlite3_reset(hStmt);
+    sqlite3_bind_int64(hStmt, 1, nVal1);
+    sqlite3_bind_int64(hStmt, 2, nVal2);
+    const int rc = sqlite3_step(hStmt);
+    if( rc != SQLITE_OK && rc != SQLITE_DONE )
     {
-        CPLError(CE_Failure, CPLE_AppDefined, "No geometry column");
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "failed to execute insertion in RTree : %s",
+                  sqlite3_errmsg(hDB) );
         return false;
     }
-    if( m_poDS->CreateExtensionsTableIfNecessary() != OGRERR_NONE )
-        return false;
-
-    const char* pszT = (pszTableName) ? pszTableName : m_pszTableName;
-    const char* pszC = m_poFeatureDefn->GetGeomFieldDefn(0)->GetNameRef();
-    const char* pszI = GetFIDColumn();
+    return true;
+}
 
-    m_osRTreeName = "rtree_";
-    m_osRTreeName += pszT;
-    m_osRTreeName += "_";
-    m_osRTreeName += pszC;
-    m_osFIDForRTree = m_pszFidColumn;
+/* Build a packed RTree from the entries, and write its nodes directly */
+/* into the shadow tables of the (empty or not) rtree virtual table, */
+/* which is much faster than inserting the entries one at a time. */
+/* aoEntries is emptied. */
+static bool GPKGBulkLoadRTree( sqlite3* hDB, const char* pszRTreeName,
+                               std::vector<GPKGRTreeEntry>& aoEntries )
+{
+    /* The node size is determined at the creation of the virtual table */
+    /* and is the one of the root node */
+    char* pszSQL = sqlite3_mprintf(
+        "SELECT length(data) FROM \"%w_node\" WHERE nodeno = 1",
+        pszRTreeName);
+    OGRErr err = OGRERR_NONE;
+    const int nNodeSize = SQLGetInteger(hDB, pszSQL, &err);
+    sqlite3_free(pszSQL);
+    const int nNodeCapacity = (nNodeSize - 4) / knRTreeBytesPerCell;
+    if( err != OGRERR_NONE || nNodeCapacity < 2 )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Cannot determine node size of %s", pszRTreeName );
+        return false;
+    }
 
-    m_poDS->SoftStartTransaction();
+    std::vector<GPKGRTreeCell> asCells;
+    asCells.reserve( aoEntries.size() );
+    for( size_t i = 0; i < aoEntries.size(); i++ )
+    {
+        GPKGRTreeCell sCell;
+        sCell.nId = aoEntries[i].nId;
+        sCell.afCoords[0] = GPKGRTreeValueDown(aoEntries[i].dfMinX);
+        sCell.afCoords[1] = GPKGRTreeValueUp(aoEntries[i].dfMaxX);
+        sCell.afCoords[2] = GPKGRTreeValueDown(aoEntries[i].dfMinY);
+        sCell.afCoords[3] = GPKGRTreeValueUp(aoEntries[i].dfMaxY);
+        asCells.push_back(sCell);
+    }
+    std::vector<GPKGRTreeEntry>().swap(aoEntries);
 
-    char* pszSQL;
-    /* Create virtual table */
-    if( !m_bDropRTreeTable )
+    const char* const apszShadowTables[] = { "node", "parent", "rowid" };
+    for( size_t i = 0; i < CPL_ARRAYSIZE(apszShadowTables); i++ )
     {
-        pszSQL = sqlite3_mprintf(
-                    "CREATE VIRTUAL TABLE \"%w\" USING rtree(id, minx, maxx, miny, maxy)",
-                    m_osRTreeName.c_str() );
-        err = SQLCommand(m_poDS->GetDB(), pszSQL);
+        pszSQL = sqlite3_mprintf("DELETE FROM \"%w_%s\"",
+                                 pszRTreeName, apszShadowTables[i]);
+        err = SQLCommand(hDB, pszSQL);
         sqlite3_free(pszSQL);
         if( err != OGRERR_NONE )
-        {
-            m_poDS->SoftRollbackTransaction();
             return false;
-        }
     }
-    m_bDropRTreeTable = false;
 
-    /* Populate the RTree */
-#ifdef NO_PROGRESSIVE_RTREE_INSERTION
+    sqlite3_stmt* hNodeStmt = NULL;
+    sqlite3_stmt* hParentStmt = NULL;
+    sqlite3_stmt* hRowidStmt = NULL;
     pszSQL = sqlite3_mprintf(
-        "INSERT INTO \"%w\" "
-        "SELECT \"%w\", ST_MinX(\"%w\"), ST_MaxX(\"%w\"), "
-        "ST_MinY(\"%w\"), ST_MaxY(\"%w\") FROM \"%w\" "
-        "WHERE \"%w\" NOT NULL AND NOT ST_IsEmpty(\"%w\")",
-        m_osRTreeName.c_str(), pszI, pszC, pszC, pszC, pszC, pszT, pszC, pszC );
-    err = SQLCommand(m_poDS->GetDB(), pszSQL);
+        "INSERT INTO \"%w_node\" (nodeno, data) VALUES (?, ?)", pszRTreeName);
+    int rc = sqlite3_prepare_v2(hDB, pszSQL, -1, &hNodeStmt, NULL);
     sqlite3_free(pszSQL);
-    if( err != OGRERR_NONE )
+    if( rc == SQLITE_OK )
     {
-        m_poDS->SoftRollbackTransaction();
-        return false;
+        pszSQL = sqlite3_mprintf(
+            "INSERT INTO \"%w_parent\" (nodeno, parentnode) VALUES (?, ?)",
+            pszRTreeName);
+        rc = sqlite3_prepare_v2(hDB, pszSQL, -1, &hParentStmt, NULL);
+        sqlite3_free(pszSQL);
     }
-#else
-    pszSQL = sqlite3_mprintf(
+    if( rc == SQLITE_OK )
+    {
+        pszSQL = sqlite3_mprintf(
+            "INSERT INTO \"%w_rowid\" (rowid, nodeno) VALUES (?, ?)",
+            pszRTreeName);
+        rc = sqlite3_prepare_v2(hDB, pszSQL, -1, &hRowidStmt, NULL);
+        sqlite3_free(pszSQL);
+    }
+    bool bRet = (rc == SQLITE_OK);
+    if( !bRet )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "failed to prepare SQL: %s", sqlite3_errmsg(hDB) );
+    }
+
+    /* Build the tree from the leaves up to the root, which is node 1 */
+    std::vector<GByte> abyNode( nNodeSize );
+    GIntBig nNextNodeNo = 2;
+    int nDepth = 0;
+    while( bRet )
+    {
+        const bool bRoot = asCells.size() <= static_cast<size_t>(nNodeCapacity);
+        if( !bRoot )
+            GPKGRTreeSortTileRecursive( asCells, nNodeCapacity );
+
+        std::vector<GPKGRTreeCell> asParentCells;
+        for( size_t i = 0; bRet && (i < asCells.size() || bRoot); i += nNodeCapacity )
+        {
+            const int nCells = static_cast<int>(
+                std::min(asCells.size() - i, static_cast<size_t>(nNodeCapacity)));
+            const GIntBig nNodeNo = bRoot ? 1 : nNextNodeNo++;
+            GPKGRTreeEncodeNode( abyNode, bRoot ? nDepth : 0,
+                                 nCells ? &asCells[i] : NULL, nCells );
+
+            sqlite3_reset(hNodeStmt);
+            sqlite3_bind_int64(hNodeStmt, 1, nNodeNo);
+            sqlite3_bind_blob(hNodeStmt, 2, &abyNode[0], nNodeSize,
+                              SQLITE_STATIC);
+            rc = sqlite3_step(hNodeStmt);
+            if( rc != SQLITE_OK && rc != SQLITE_DONE )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "failed to execute insertion in RTree : %s",
+                          sqlite3_errmsg(hDB) );
+                bRet = false;
+                break;
+            }
+
+            GPKGRTreeCell sParentCell;
+            sParentCell.nId = nNodeNo;
+            for( int j = 0; bRet && j < nCells; j++ )
+            {
+                const GPKGRTreeCell& sCell = asCells[i + j];
+                bRet = GPKGRTreeInsertPair( hDB,
+                                    nDepth == 0 ? hRowidStmt : hParentStmt,
+                                    sCell.nId, nNodeNo );
+                if( j == 0 )
+                {
+                    memcpy( sParentCell.afCoords, sCell.afCoords,
+                            sizeof(sCell.afCoords) );
+                }
+                else
+                {
+                    sParentCell.afCoords[0] = std::min(sParentCell.afCoords[0],
+                                                       sCell.afCoords[0]);
+                    sParentCell.afCoords[1] = std::max(sParentCell.afCoords[1],
+                                                       sCell.afCoords[1]);
+                    sParentCell.afCoords[2] = std::min(sParentCell.afCoords[2],
+                                                       sCell.afCoords[2]);
+                    sParentCell.afCoords[3] = std::max(sParentCell.afCoords[3],
+                                                       sCell.afCoords[3]);
+                }
+            }
+            if( bRoot )
+                break;
+            asParentCells.push_back(sParentCell);
+        }
+        if( bRoot )
+            break;
+
+        asCells.swap(asParentCells);
+        nDepth++;
+    }
+
+    sqlite3_finalize(hNodeStmt);
+    sqlite3_finalize(hParentStmt);
+    sqlite3_finalize(hRowidStmt);
+
+    if( bRet )
+    {
+        CPLDebug("GPKG", "%s bulk loaded with a depth of %d",
+                 pszRTreeName, nDepth);
+    }
+    return bRet;
+}
+
+/************************************************************************/
+/*                           PopulateRTree()                            */
+/************************************************************************/
+
+bool OGRGeoPackageTableLayer::PopulateRTree(const char* pszT)
+{
+    const char* pszC = m_poFeatureDefn->GetGeomFieldDefn(0)->GetNameRef();
+    const char* pszI = GetFIDColumn();
+
+    char* pszSQL = sqlite3_mprintf(
         "SELECT \"%w\", ST_MinX(\"%w\"), ST_MaxX(\"%w\"), "
         "ST_MinY(\"%w\"), ST_MaxY(\"%w\") FROM \"%w\" "
         "WHERE \"%w\" NOT NULL AND NOT ST_IsEmpty(\"%w\")",
@@ -2402,13 +2716,12 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
         CPLError( CE_Failure, CPLE_AppDefined,
                     "failed to prepare SQL: %s", pszSQL);
         sqlite3_free(pszSQL);
-        m_poDS->SoftRollbackTransaction();
         return false;
     }
     sqlite3_free(pszSQL);
 
     pszSQL = sqlite3_mprintf(
-        "INSERT INTO \"%w\" VALUES (?,?,?,?,?)",
+        "INSERT OR REPLACE INTO \"%w\" VALUES (?,?,?,?,?)",
         m_osRTreeName.c_str());
     sqlite3_stmt* hInsertStmt = NULL;
     if ( sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hInsertStmt, NULL)
@@ -2418,12 +2731,20 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
                     "failed to prepare SQL: %s", pszSQL);
         sqlite3_free(pszSQL);
         sqlite3_finalize(hIterStmt);
-        m_poDS->SoftRollbackTransaction();
         return false;
     }
     sqlite3_free(pszSQL);
 
-    // Insert entries in RTree by chuncks of 100000
+    // Collect all entries to bulk load the RTree, unless they would take
+    // too much memory. Otherwise insert them by chunks of 100000
+    bool bBulkLoad =
+        CPLTestBool(CPLGetConfigOption("OGR_GPKG_RTREE_BULK_LOAD", "YES"));
+    const GIntBig nUsableRAM = CPLGetUsablePhysicalRAM();
+    const size_t nMaxBulkLoadEntries = nUsableRAM > 0 ?
+        static_cast<size_t>(std::min(static_cast<GUIntBig>(nUsableRAM / 4 /
+                            (sizeof(GPKGRTreeEntry) + sizeof(GPKGRTreeCell))),
+                            static_cast<GUIntBig>(INT_MAX))) :
+        static_cast<size_t>(10 * 1000 * 1000);
     std::vector<GPKGRTreeEntry> aoEntries;
     GUIntBig nEntryCount = 0;
     const size_t nChunkSize = 100000;
@@ -2453,11 +2774,25 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
                       sqlite3_errmsg( m_poDS->GetDB() ) );
             sqlite3_finalize(hIterStmt);
             sqlite3_finalize(hInsertStmt);
-            m_poDS->SoftRollbackTransaction();
             return false;
         }
 
-        if( aoEntries.size() == nChunkSize || bFinished )
+        if( bBulkLoad && aoEntries.size() == nMaxBulkLoadEntries )
+        {
+            CPLDebug("GPKG", "Too many features to bulk load %s",
+                     m_osRTreeName.c_str());
+            bBulkLoad = false;
+        }
+
+        if( bBulkLoad && bFinished )
+        {
+            sqlite3_finalize(hIterStmt);
+            sqlite3_finalize(hInsertStmt);
+            return GPKGBulkLoadRTree(m_poDS->GetDB(), m_osRTreeName,
+                                     aoEntries);
+        }
+
+        if( !bBulkLoad && (aoEntries.size() >= nChunkSize || bFinished) )
         {
             for( size_t i = 0; i < aoEntries.size(); ++i )
             {
@@ -2476,7 +2811,6 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
                               sqlite3_errmsg( m_poDS->GetDB() ) );
                     sqlite3_finalize(hIterStmt);
                     sqlite3_finalize(hInsertStmt);
-                    m_poDS->SoftRollbackTransaction();
                     return false;
                 }
             }
@@ -2493,6 +2827,204 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
 
     sqlite3_finalize(hIterStmt);
     sqlite3_finalize(hInsertStmt);
+    return true;
+}
+
+/************************************************************************/
+/*                      SuspendRTreeInsertTrigger()                     */
+/*                                                                      */
+/*      Within a transaction, the RTree insert trigger is dropped at    */
+/*      the first insertion, and the entries of the new features are    */
+/*      accumulated, to be inserted all at once by                      */
+/*      FlushPendingRTreeEntries(), at the latest when the transaction   */
+/*      is committed.                                                   */
+/************************************************************************/
+
+void OGRGeoPackageTableLayer::SuspendRTreeInsertTrigger()
+{
+    if( !m_osSuspendedRTreeInsertTrigger.empty() ||
+        !m_poDS->IsInTransaction() || !HasSpatialIndex() ||
+        !CPLTestBool(CPLGetConfigOption("OGR_GPKG_DEFER_RTREE_UPDATE", "YES")) )
+        return;
+
+    char* pszSQL = sqlite3_mprintf(
+        "SELECT sql FROM sqlite_master WHERE type = 'trigger' "
+        "AND name = '%q_insert'", m_osRTreeName.c_str());
+    SQLResult oResult;
+    OGRErr err = SQLQuery(m_poDS->GetDB(), pszSQL, &oResult);
+    sqlite3_free(pszSQL);
+    const char* pszTriggerSQL = (err == OGRERR_NONE && oResult.nRowCount == 1) ?
+                                    SQLResultGetValue(&oResult, 0, 0) : NULL;
+    if( pszTriggerSQL != NULL )
+    {
+        pszSQL = sqlite3_mprintf("DROP TRIGGER \"%w_insert\"",
+                                 m_osRTreeName.c_str());
+        if( SQLCommand(m_poDS->GetDB(), pszSQL) == OGRERR_NONE )
+        {
+            CPLDebug("GPKG", "Suspending %s_insert trigger",
+                     m_osRTreeName.c_str());
+            m_osSuspendedRTreeInsertTrigger = pszTriggerSQL;
+        }
+        sqlite3_free(pszSQL);
+    }
+    SQLResultFree(&oResult);
+}
+
+/************************************************************************/
+/*                      FlushPendingRTreeEntries()                      */
+/************************************************************************/
+
+bool OGRGeoPackageTableLayer::FlushPendingRTreeEntries()
+{
+    if( m_osSuspendedRTreeInsertTrigger.empty() )
+        return true;
+
+    bool bRet = true;
+    if( !m_aoPendingRTreeEntries.empty() )
+    {
+        // If there are more new entries than existing ones, rebuild the
+        // whole RTree, otherwise insert them one at a time.
+        char* pszSQL = sqlite3_mprintf("SELECT COUNT(*) FROM \"%w_rowid\"",
+                                       m_osRTreeName.c_str());
+        const GIntBig nExisting =
+            SQLGetInteger64(m_poDS->GetDB(), pszSQL, NULL);
+        sqlite3_free(pszSQL);
+        if( static_cast<GIntBig>(m_aoPendingRTreeEntries.size()) >= nExisting &&
+            CPLTestBool(CPLGetConfigOption("OGR_GPKG_RTREE_BULK_LOAD", "YES")) )
+        {
+            CPLDebug("GPKG", "Rebuilding %s", m_osRTreeName.c_str());
+            m_aoPendingRTreeEntries.clear();
+            bRet = PopulateRTree(m_pszTableName);
+        }
+        else
+        {
+            pszSQL = sqlite3_mprintf(
+                "INSERT OR REPLACE INTO \"%w\" VALUES (?,?,?,?,?)",
+                m_osRTreeName.c_str());
+            sqlite3_stmt* hInsertStmt = NULL;
+            if ( sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1,
+                                    &hInsertStmt, NULL) != SQLITE_OK )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "failed to prepare SQL: %s", pszSQL);
+                bRet = false;
+            }
+            sqlite3_free(pszSQL);
+
+            for( size_t i = 0; bRet && i < m_aoPendingRTreeEntries.size(); ++i )
+            {
+                const GPKGRTreeEntry& sEntry = m_aoPendingRTreeEntries[i];
+                sqlite3_reset(hInsertStmt);
+                sqlite3_bind_int64(hInsertStmt,1,sEntry.nId);
+                sqlite3_bind_double(hInsertStmt,2,sEntry.dfMinX);
+                sqlite3_bind_double(hInsertStmt,3,sEntry.dfMaxX);
+                sqlite3_bind_double(hInsertStmt,4,sEntry.dfMinY);
+                sqlite3_bind_double(hInsertStmt,5,sEntry.dfMaxY);
+                const int sqlite_err = sqlite3_step(hInsertStmt);
+                if ( sqlite_err != SQLITE_OK && sqlite_err != SQLITE_DONE )
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                              "failed to execute insertion in RTree : %s",
+                              sqlite3_errmsg( m_poDS->GetDB() ) );
+                    bRet = false;
+                }
+            }
+            sqlite3_finalize(hInsertStmt);
+            m_aoPendingRTreeEntries.clear();
+        }
+    }
+
+    CPLDebug("GPKG", "Restoring %s_insert trigger", m_osRTreeName.c_str());
+    if( SQLCommand(m_poDS->GetDB(), m_osSuspendedRTreeInsertTrigger)
+                                                            != OGRERR_NONE )
+        bRet = false;
+    m_osSuspendedRTreeInsertTrigger.clear();
+    return bRet;
+}
+
+/************************************************************************/
+/*                       CreateSpatialIndex()                           */
+/************************************************************************/
+
+bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
+{
+    OGRErr err;
+
+    if( !CheckUpdatableTable("CreateSpatialIndex") )
+        return false;
+
+    if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
+        return false;
+
+    m_bDeferredSpatialIndexCreation = false;
+
+    if( m_pszFidColumn == NULL )
+        return false;
+
+    if( HasSpatialIndex() )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Spatial index already existing");
+        return false;
+    }
+
+    if( m_poFeatureDefn->GetGeomFieldCount() == 0 )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "No geometry column");
+        return false;
+    }
+    if( m_poDS->CreateExtensionsTableIfNecessary() != OGRERR_NONE )
+        return false;
+
+    const char* pszT = (pszTableName) ? pszTableName : m_pszTableName;
+    const char* pszC = m_poFeatureDefn->GetGeomFieldDefn(0)->GetNameRef();
+    const char* pszI = GetFIDColumn();
+
+    m_osRTreeName = "rtree_";
+    m_osRTreeName += pszT;
+    m_osRTreeName += "_";
+    m_osRTreeName += pszC;
+    m_osFIDForRTree = m_pszFidColumn;
+
+    m_poDS->SoftStartTransaction();
+
+    char* pszSQL;
+    /* Create virtual table */
+    if( !m_bDropRTreeTable )
+    {
+        pszSQL = sqlite3_mprintf(
+                    "CREATE VIRTUAL TABLE \"%w\" USING rtree(id, minx, maxx, miny, maxy)",
+                    m_osRTreeName.c_str() );
+        err = SQLCommand(m_poDS->GetDB(), pszSQL);
+        sqlite3_free(pszSQL);
+        if( err != OGRERR_NONE )
+        {
+            m_poDS->SoftRollbackTransaction();
+            return false;
+        }
+    }
+    m_bDropRTreeTable = false;
+
+    /* Populate the RTree */
+#ifdef NO_PROGRESSIVE_RTREE_INSERTION
+    pszSQL = sqlite3_mprintf(
+        "INSERT INTO \"%w\" "
+        "SELECT \"%w\", ST_MinX(\"%w\"), ST_MaxX(\"%w\"), "
+        "ST_MinY(\"%w\"), ST_MaxY(\"%w\") FROM \"%w\" "
+        "WHERE \"%w\" NOT NULL AND NOT ST_IsEmpty(\"%w\")",
+        m_osRTreeName.c_str(), pszI, pszC, pszC, pszC, pszC, pszT, pszC, pszC );
+    err = SQLCommand(m_poDS->GetDB(), pszSQL);
+    sqlite3_free(pszSQL);
+    if( err != OGRERR_NONE )
+    {
+        m_poDS->SoftRollbackTransaction();
+        return false;
+    }
+#else
+    if( !PopulateRTree(pszT) )
+    {
+        m_poDS->SoftRollbackTransaction();
+        return false;
+    }
 #endif
 
     CPLString osSQL;
@@ -2881,6 +3413,8 @@ bool OGRGeoPackageTableLayer::DropSpatialIndex(bool bCalledFromSQLFunction)
         return false;
     }
 
+    FlushPendingRTreeEntries();
+
     const char* pszT = m_pszTableName;
     const char* pszC = m_poFeatureDefn->GetGeomFieldDefn(0)->GetNameRef();
     char* pszSQL = sqlite3_mprintf(
@@ -3696,6 +4230,8 @@ CPLErr OGRGeoPackageTableLayer::SetMetadataItem( const char * pszName,
 OGRErr OGRGeoPackageTableLayer::RecreateTable(const CPLString& osColumnsForCreate,
                                               const CPLString& osFieldListForSelect)
 {
+    FlushPendingRTreeEntries();
+
 /* -------------------------------------------------------------------- */
 /*      Save existing related triggers and index                        */
 /* -------------------------------------------------------------------- */
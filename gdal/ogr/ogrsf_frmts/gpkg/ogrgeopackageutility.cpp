@@ -203,6 +203,16 @@ const char* GPkgFieldFromOGR(OGRFieldType eType, OGRFieldSubType eSubType,
 
 GByte* GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId,
                            size_t *pnWkbLen)
+{
+    return GPkgGeometryFromOGR(poGeometry, iSrsId, pnWkbLen, NULL, NULL);
+}
+
+/* Same as above, but if ppabyBuffer is not NULL, the blob is written in */
+/* *ppabyBuffer, which is grown as needed and remains owned by the caller. */
+/* This avoids an allocation per geometry when writing many features. */
+GByte* GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId,
+                           size_t *pnWkbLen,
+                           GByte** ppabyBuffer, size_t* pnBufferAlloc)
 {
     CPLAssert( poGeometry != NULL );
 
@@ -225,7 +235,24 @@ GByte* GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId,
 
     /* Total BLOB size is header + WKB size */
     size_t nWkbLen = nHeaderLen + poGeometry->WkbSize();
-    GByte *pabyWkb = (GByte *)CPLMalloc(nWkbLen);
+    GByte *pabyWkb = NULL;
+    if( ppabyBuffer != NULL )
+    {
+        if( nWkbLen > *pnBufferAlloc )
+        {
+            GByte* pabyNewBuffer = (GByte *)
+                VSI_REALLOC_VERBOSE(*ppabyBuffer, nWkbLen);
+            if( pabyNewBuffer == NULL )
+                return NULL;
+            *ppabyBuffer = pabyNewBuffer;
+            *pnBufferAlloc = nWkbLen;
+        }
+        pabyWkb = *ppabyBuffer;
+    }
+    else
+    {
+        pabyWkb = (GByte *)CPLMalloc(nWkbLen);
+    }
     if (pnWkbLen)
         *pnWkbLen = nWkbLen;
 
@@ -304,7 +331,8 @@ GByte* GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId,
     err = poGeometry->exportToWkb(eByteOrder, pabyPtr, wkbVariantIso);
     if ( err != OGRERR_NONE )
     {
-        CPLFree(pabyWkb);
+        if( ppabyBuffer == NULL )
+            CPLFree(pabyWkb);
         return NULL;
     }
 
@@ -56,6 +56,17 @@ public:
     virtual OGRErr RemoveEntry( OGRField *psKey, GIntBig nFID ) = 0;
 
     virtual OGRErr Clear() = 0;
+
+    // Range and prefix lookups. The returned FIDs may be a superset of the
+    // exact matches, in no particular order.
+    virtual int       SupportsRangeQueries();
+    virtual GIntBig  *GetRangeMatches( const OGRField *psMin, int bMinIncluded,
+                                       const OGRField *psMax, int bMaxIncluded,
+                                       GIntBig* panFIDList, int* nFIDCount,
+                                       int* nLength );
+    virtual GIntBig  *GetPrefixMatches( const char *pszPrefix,
+                                        GIntBig* panFIDList, int* nFIDCount,
+                                        int* nLength );
 };
 
 /************************************************************************/
@@ -73,6 +84,13 @@ protected:
 
                 OGRLayerAttrIndex();
 
+    void        ClearLayerFilters( char **ppszAttrQuery,
+                                   OGRGeometry **ppoFilterGeom,
+                                   int *piGeomField );
+    void        RestoreLayerFilters( char *pszAttrQuery,
+                                     OGRGeometry *poFilterGeom,
+                                     int iGeomField );
+
 public:
     virtual     ~OGRLayerAttrIndex();
 
@@ -86,9 +104,12 @@ public:
     virtual OGRErr RemoveFromIndex( OGRFeature *poFeature ) = 0;
 
     virtual OGRAttrIndex *GetFieldIndex( int iField ) = 0;
+
+    virtual void   InvalidateIndexes();
 };
 
 OGRLayerAttrIndex CPL_DLL *OGRCreateDefaultLayerIndex();
+OGRLayerAttrIndex CPL_DLL *OGRCreateBTreeLayerIndex();
 
 //! @endcond
 
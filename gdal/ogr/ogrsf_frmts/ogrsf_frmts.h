@@ -52,6 +52,7 @@
 
 class OGRLayerAttrIndex;
 class OGRSFDriver;
+class OGRIndexedPreparedGeometry;
 
 /************************************************************************/
 /*                               OGRLayer                               */
@@ -68,6 +69,8 @@ class OGRSFDriver;
 class CPL_DLL OGRLayer : public GDALMajorObject
 {
   private:
+    friend class OGRLayerAttrIndex;
+
     void         ConvertGeomsIfNecessary( OGRFeature *poFeature );
 
   protected:
@@ -75,6 +78,7 @@ class CPL_DLL OGRLayer : public GDALMajorObject
     int          m_bFilterIsEnvelope;
     OGRGeometry *m_poFilterGeom;
     OGRPreparedGeometry *m_pPreparedFilterGeom; /* m_poFilterGeom compiled as a prepared geometry */
+    OGRIndexedPreparedGeometry *m_poIndexedFilterGeom; /* m_poFilterGeom when it is a rectangle, or exact filter without GEOS */
     OGREnvelope  m_sFilterEnvelope;
     int          m_iGeomFieldFilter; // specify the index on which the spatial
                                      // filter is active.
@@ -107,6 +111,8 @@ class CPL_DLL OGRLayer : public GDALMajorObject
 
     virtual void        ResetReading() = 0;
     virtual OGRFeature *GetNextFeature() CPL_WARN_UNUSED_RESULT = 0;
+    virtual int         GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                         int nMaxFeatures );
     virtual OGRErr      SetNextByIndex( GIntBig nIndex );
     virtual OGRFeature *GetFeature( GIntBig nFID )  CPL_WARN_UNUSED_RESULT;
 
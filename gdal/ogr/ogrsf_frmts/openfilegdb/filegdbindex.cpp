@@ -30,6 +30,7 @@
 #include "cpl_string.h"
 #include "cpl_time.h"
 #include <algorithm>
+#include <vector>
 
 CPL_CVSID("$Id$");
 
@@ -252,6 +253,50 @@ class FileGDBIndexIterator CPL_FINAL : public FileGDBIterator
                                                        double& dfSum, int& nCount) override;
 };
 
+/************************************************************************/
+/*                      FileGDBSpatialIndexIterator                     */
+/************************************************************************/
+
+/* Iterates over the rows whose cells in the .spx spatial index intersect */
+/* a filter envelope. The .spx file is a B-tree with the same page layout */
+/* as the .atx attribute indexes, whose 64 bit keys encode a grid level */
+/* and the column and row of a cell of that grid. A feature is listed */
+/* once for each cell it touches, so the result is a list of candidates */
+/* that must still be checked against the filter. */
+
+class FileGDBSpatialIndexIterator CPL_FINAL : public FileGDBIterator
+{
+        FileGDBTable        *poParent;
+        VSILFILE            *fpSpx;
+        GUInt32              nMaxPerPages;
+        GUInt32              nOffsetFirstValInPage;
+        GUInt32              nIndexDepth;
+        GByte                abyPage[MAX_DEPTH + 1][FGDB_PAGE_SIZE];
+
+        std::vector<int>     anRows;
+        size_t               iCurRow;
+
+        int                  CollectRows(GUInt32 nPage, GUInt32 iLevel,
+                                         GUInt64 nMinKey, GUInt64 nMaxKey,
+                                         GUInt32 nMinRow, GUInt32 nMaxRow);
+
+                             explicit FileGDBSpatialIndexIterator(
+                                                FileGDBTable* poParent);
+        int                  SetEnvelope(const OGREnvelope& sFilterEnvelope);
+
+    public:
+        virtual             ~FileGDBSpatialIndexIterator();
+
+        static FileGDBIterator*      Build(FileGDBTable* poParent,
+                                           const OGREnvelope& sFilterEnvelope);
+
+        virtual FileGDBTable        *GetTable() override { return poParent; }
+        virtual void                 Reset() override { iCurRow = 0; }
+        virtual int                  GetNextRowSortedByFID() override;
+        virtual int                  GetRowCount() override
+                                    { return static_cast<int>(anRows.size()); }
+};
+
 /************************************************************************/
 /*                            GetMinValue()                             */
 /************************************************************************/
@@ -336,6 +381,16 @@ FileGDBIterator* FileGDBIterator::BuildIsNotNull(FileGDBTable* poParent,
     return poIter;
 }
 
+/************************************************************************/
+/*                            BuildSpatial()                            */
+/************************************************************************/
+
+FileGDBIterator* FileGDBIterator::BuildSpatial(FileGDBTable* poParent,
+                                               const OGREnvelope& sFilterEnvelope)
+{
+    return FileGDBSpatialIndexIterator::Build(poParent, sFilterEnvelope);
+}
+
 /************************************************************************/
 /*                              BuildNot()                              */
 /************************************************************************/
@@ -1838,4 +1893,241 @@ int FileGDBIndexIterator::GetMinMaxSumCount(double& dfMin, double& dfMax,
     return TRUE;
 }
 
+/************************************************************************/
+/*                             GetUInt64()                              */
+/************************************************************************/
+
+static GUInt64 GetUInt64(const GByte* pBaseAddr, int iOffset)
+{
+    GUInt64 nVal;
+    memcpy(&nVal, pBaseAddr + sizeof(nVal) * iOffset, sizeof(nVal));
+    CPL_LSBPTR64(&nVal);
+    return nVal;
+}
+
+/************************************************************************/
+/*                     FileGDBSpatialIndexIterator()                    */
+/************************************************************************/
+
+FileGDBSpatialIndexIterator::FileGDBSpatialIndexIterator(
+                                                    FileGDBTable* poParentIn) :
+    poParent(poParentIn),
+    fpSpx(NULL),
+    nMaxPerPages(0),
+    nOffsetFirstValInPage(0),
+    nIndexDepth(0),
+    iCurRow(0)
+{
+}
+
+/************************************************************************/
+/*                    ~FileGDBSpatialIndexIterator()                    */
+/************************************************************************/
+
+FileGDBSpatialIndexIterator::~FileGDBSpatialIndexIterator()
+{
+    if( fpSpx )
+        VSIFCloseL(fpSpx);
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/************************************************************************/
+
+FileGDBIterator* FileGDBSpatialIndexIterator::Build(
+                                        FileGDBTable* poParent,
+                                        const OGREnvelope& sFilterEnvelope)
+{
+    FileGDBSpatialIndexIterator* poIterator =
+                new FileGDBSpatialIndexIterator(poParent);
+    if( poIterator->SetEnvelope(sFilterEnvelope) )
+    {
+        return poIterator;
+    }
+    delete poIterator;
+    return NULL;
+}
+
+/************************************************************************/
+/*                         GetCellCoordinate()                          */
+/************************************************************************/
+
+/* Cell numbers are offset by 2^29 so that negative coordinates map to */
+/* positive values, and stored on 31 bits in the key. */
+static const GUInt32 SPX_CELL_OFFSET = 1U << 29;
+static const GUInt32 SPX_CELL_MAX = (1U << 31) - 1;
+
+static GUInt32 GetCellCoordinate(double dfVal, double dfGridRes, int nDelta)
+{
+    const double dfCell = floor(dfVal / dfGridRes) + SPX_CELL_OFFSET + nDelta;
+    if( !(dfCell > 0) )
+        return 0;
+    if( dfCell > SPX_CELL_MAX )
+        return SPX_CELL_MAX;
+    return static_cast<GUInt32>(dfCell);
+}
+
+/************************************************************************/
+/*                            SetEnvelope()                             */
+/************************************************************************/
+
+int FileGDBSpatialIndexIterator::SetEnvelope(const OGREnvelope& sFilterEnvelope)
+{
+    const int errorRetValue = FALSE;
+
+    const int iGeomField = poParent->GetGeomFieldIdx();
+    if( iGeomField < 0 )
+        return FALSE;
+    const FileGDBGeomField* poGeomField =
+        reinterpret_cast<const FileGDBGeomField*>(poParent->GetField(iGeomField));
+    const std::vector<double>& adfGridRes =
+                                poGeomField->GetSpatialIndexGridResolution();
+    /* Point layers have a zero grid size and all their keys set to 0 */
+    if( adfGridRes.empty() || !(adfGridRes[0] > 0) )
+        return FALSE;
+
+    const char* pszSpxName = CPLFormFilename(
+        CPLGetPath(poParent->GetFilename().c_str()),
+        CPLGetBasename(poParent->GetFilename().c_str()), "spx");
+    fpSpx = VSIFOpenL( pszSpxName, "rb" );
+    if( fpSpx == NULL )
+        return FALSE;
+
+    VSIFSeekL(fpSpx, 0, SEEK_END);
+    vsi_l_offset nFileSize = VSIFTellL(fpSpx);
+    returnErrorIf(nFileSize < FGDB_PAGE_SIZE + 22 );
+
+    VSIFSeekL(fpSpx, nFileSize - 22, SEEK_SET);
+    GByte abyTrailer[22];
+    returnErrorIf(VSIFReadL( abyTrailer, 22, 1, fpSpx ) != 1 );
+    returnErrorIf(abyTrailer[0] != sizeof(GUInt64));
+
+    nMaxPerPages = (FGDB_PAGE_SIZE - 12) / (4 + abyTrailer[0]);
+    nOffsetFirstValInPage = 12 + nMaxPerPages * 4;
+
+    GUInt32 nMagic1 = GetUInt32(abyTrailer + 2, 0);
+    returnErrorIf(nMagic1 != 1 );
+
+    nIndexDepth = GetUInt32(abyTrailer + 6, 0);
+    returnErrorIf(!(nIndexDepth >= 1 && nIndexDepth <= MAX_DEPTH + 1) );
+
+    /* Only the encoding of the cells of the finest grid (level 0) has */
+    /* been confirmed on real datasets. Features registered in the */
+    /* coarser grids are all considered as candidates. */
+    const double dfGridRes = adfGridRes[0];
+    const GUInt32 nMinX = GetCellCoordinate(sFilterEnvelope.MinX, dfGridRes, -1);
+    const GUInt32 nMaxX = GetCellCoordinate(sFilterEnvelope.MaxX, dfGridRes, 1);
+    const GUInt32 nMinY = GetCellCoordinate(sFilterEnvelope.MinY, dfGridRes, -1);
+    const GUInt32 nMaxY = GetCellCoordinate(sFilterEnvelope.MaxY, dfGridRes, 1);
+
+    for( size_t iGrid = 0; iGrid < adfGridRes.size(); iGrid++ )
+    {
+        const GUInt64 nLevel = static_cast<GUInt64>(iGrid) << 62;
+        GUInt64 nMinKey, nMaxKey;
+        GUInt32 nMinRow, nMaxRow;
+        if( iGrid == 0 )
+        {
+            nMinKey = nLevel | (static_cast<GUInt64>(nMinX) << 31);
+            nMaxKey = nLevel | (static_cast<GUInt64>(nMaxX) << 31) |
+                      SPX_CELL_MAX;
+            nMinRow = nMinY;
+            nMaxRow = nMaxY;
+        }
+        else
+        {
+            nMinKey = nLevel;
+            nMaxKey = nLevel | ((static_cast<GUInt64>(1) << 62) - 1);
+            nMinRow = 0;
+            nMaxRow = SPX_CELL_MAX;
+        }
+        if( !CollectRows(1, 0, nMinKey, nMaxKey, nMinRow, nMaxRow) )
+            return FALSE;
+    }
+
+    std::sort(anRows.begin(), anRows.end());
+    anRows.erase(std::unique(anRows.begin(), anRows.end()), anRows.end());
+
+    CPLDebug("OpenFileGDB", "Using spatial index of %s: %d candidate rows",
+             poParent->GetFilename().c_str(), static_cast<int>(anRows.size()));
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                            CollectRows()                             */
+/************************************************************************/
+
+int FileGDBSpatialIndexIterator::CollectRows(GUInt32 nPage, GUInt32 iLevel,
+                                             GUInt64 nMinKey, GUInt64 nMaxKey,
+                                             GUInt32 nMinRow, GUInt32 nMaxRow)
+{
+    const int errorRetValue = FALSE;
+    GByte* pabyPage = abyPage[iLevel];
+    VSIFSeekL(fpSpx, static_cast<vsi_l_offset>(nPage - 1) * FGDB_PAGE_SIZE,
+              SEEK_SET);
+    returnErrorIf(VSIFReadL( pabyPage, FGDB_PAGE_SIZE, 1, fpSpx ) != 1 );
+
+    const GUInt32 nCount = GetUInt32(pabyPage + 4, 0);
+    returnErrorIf(nCount > nMaxPerPages);
+
+    if( iLevel + 1 == nIndexDepth )
+    {
+        const int nTotalRecordCount = poParent->GetTotalRecordCount();
+        for( GUInt32 i = 0; i < nCount; i++ )
+        {
+            const GUInt64 nKey =
+                GetUInt64(pabyPage + nOffsetFirstValInPage, i);
+            const GUInt32 nRow = static_cast<GUInt32>(nKey & SPX_CELL_MAX);
+            if( nKey < nMinKey || nKey > nMaxKey ||
+                nRow < nMinRow || nRow > nMaxRow )
+            {
+                continue;
+            }
+            const GUInt32 nFID = GetUInt32(pabyPage + 12, i);
+            returnErrorIf(nFID < 1 ||
+                          nFID > static_cast<GUInt32>(nTotalRecordCount));
+            anRows.push_back(static_cast<int>(nFID - 1));
+        }
+        return TRUE;
+    }
+
+    /* Sub-page i holds keys between the (i-1)th and ith values of the */
+    /* page, the last sub-page holding the keys after the last value */
+    returnErrorIf(nCount == 0);
+    for( GUInt32 i = 0; i <= nCount; i++ )
+    {
+        if( i > 0 &&
+            GetUInt64(pabyPage + nOffsetFirstValInPage, i - 1) > nMaxKey )
+        {
+            break;
+        }
+        if( i < nCount &&
+            GetUInt64(pabyPage + nOffsetFirstValInPage, i) < nMinKey )
+        {
+            continue;
+        }
+        const GUInt32 nSubPage = GetUInt32(pabyPage + 8, i);
+        returnErrorIf(nSubPage < 2);
+        if( !CollectRows(nSubPage, iLevel + 1, nMinKey, nMaxKey,
+                         nMinRow, nMaxRow) )
+        {
+            return FALSE;
+        }
+        /* The recursive call has overwritten the page of the next level */
+        /* only, so pabyPage is still valid. */
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                        GetNextRowSortedByFID()                       */
+/************************************************************************/
+
+int FileGDBSpatialIndexIterator::GetNextRowSortedByFID()
+{
+    if( iCurRow < anRows.size() )
+        return anRows[iCurRow++];
+    return -1;
+}
+
 }; /* namespace OpenFileGDB */
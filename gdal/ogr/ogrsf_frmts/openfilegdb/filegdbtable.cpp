@@ -1019,7 +1019,8 @@ int FileGDBTable::Open(const char* pszFilename,
                 /* Purely empiric logic ! */
                 /* Well, it seems that in practice there are 1 or 3 doubles */
                 /* here. When there are 3, the first one is zmin and the second */
-                /* one is zmax */
+                /* one is zmax. Then comes the number of spatial index grids */
+                /* followed by their cell size */
                 int nCountDoubles = 0;
                 while( true )
                 {
@@ -1032,6 +1033,11 @@ int FileGDBTable::Open(const char* pszFilename,
                         pabyIter += 5;
                         nRemaining -= 5;
                         returnErrorIf(nRemaining < (GUInt32)(nToSkip * 8) );
+                        for( int j = 0; j < nToSkip; j++ )
+                        {
+                            poField->adfSpatialIndexGridResolution.push_back(
+                                GetFloat64(pabyIter, j));
+                        }
                         nCountDoubles += nToSkip;
                         pabyIter += nToSkip * 8;
                         nRemaining -= nToSkip * 8;
@@ -144,6 +144,7 @@ class FileGDBGeomField: public FileGDBField
         double            dfXMax;
         double            dfYMax;
         int               bHas3D;
+        std::vector<double> adfSpatialIndexGridResolution;
 
     public:
         explicit          FileGDBGeomField(FileGDBTable* poParent);
@@ -173,6 +174,9 @@ class FileGDBGeomField: public FileGDBField
         double             GetMTolerance() const { return dfMTolerance; }
 
         int                Has3D() const { return bHas3D; }
+
+        const std::vector<double>& GetSpatialIndexGridResolution() const
+                                    { return adfSpatialIndexGridResolution; }
 };
 
 /************************************************************************/
@@ -366,6 +370,8 @@ class FileGDBIterator
                                                     int nFieldIdx,
                                                     int bAscending);
         static FileGDBIterator*      BuildNot(FileGDBIterator* poIterBase);
+        static FileGDBIterator*      BuildSpatial(FileGDBTable* poParent,
+                                                  const OGREnvelope& sFilterEnvelope);
         static FileGDBIterator*      BuildAnd(FileGDBIterator* poIter1,
                                               FileGDBIterator* poIter2);
         static FileGDBIterator*      BuildOr(FileGDBIterator* poIter1,
@@ -75,6 +75,9 @@ class OGROpenFileGDBLayer : public OGRLayer
     int               BuildLayerDefinition();
     int               BuildGeometryColumnGDBv10();
     OGRFeature       *GetCurrentFeature();
+    void              AddToSpatialIndex( const OGRField* psField, int iRow );
+    OGRGeometry      *GetCurrentGeometry( const OGRField* psField );
+    void              AddCurrentFeatureToBatch( OGRFeatureBatch* poBatch );
 
     FileGDBOGRGeometryConverter* m_poGeomConverter;
 
@@ -90,6 +93,7 @@ class OGROpenFileGDBLayer : public OGRLayer
     CPLQuadTree        *m_pQuadTree;
     void              **m_pahFilteredFeatures;
     int                 m_nFilteredFeatureCount;
+    int                 m_bFilteredFeaturesFromSPX;
     static void         GetBoundsFuncEx(const void* hFeature,
                                         CPLRectObj* pBounds,
                                         void* pQTUserData);
@@ -128,6 +132,8 @@ public:
 
   virtual void        ResetReading() override;
   virtual OGRFeature* GetNextFeature() override;
+  virtual int         GetNextFeatureBatch( OGRFeatureBatch* poBatch,
+                                           int nMaxFeatures ) override;
   virtual OGRFeature* GetFeature( GIntBig nFeatureId ) override;
   virtual OGRErr      SetNextByIndex( GIntBig nIndex ) override;
 
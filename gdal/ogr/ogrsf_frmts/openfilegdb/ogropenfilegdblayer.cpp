@@ -155,7 +155,8 @@ OGROpenFileGDBLayer::OGROpenFileGDBLayer( const char* pszGDBFilename,
     m_eSpatialIndexState(SPI_IN_BUILDING),
     m_pQuadTree(NULL),
     m_pahFilteredFeatures(NULL),
-    m_nFilteredFeatureCount(-1)
+    m_nFilteredFeatureCount(-1),
+    m_bFilteredFeaturesFromSPX(FALSE)
 {
     // TODO(rouault): What error on compiler versions?  r33032 does not say.
 
@@ -827,6 +828,7 @@ void OGROpenFileGDBLayer::SetSpatialFilter( OGRGeometry *poGeom )
         }
     }
 
+    m_bFilteredFeaturesFromSPX = FALSE;
     if( poGeom != NULL )
     {
         if( m_eSpatialIndexState == SPI_COMPLETED )
@@ -847,6 +849,44 @@ void OGROpenFileGDBLayer::SetSpatialFilter( OGRGeometry *poGeom )
                 std::sort(panStart, panStart + m_nFilteredFeatureCount);
             }
         }
+        else
+        {
+            CPLFree(m_pahFilteredFeatures);
+            m_pahFilteredFeatures = NULL;
+            m_nFilteredFeatureCount = -1;
+
+            /* Use the .spx file to restrict the rows to read to the ones */
+            /* that are registered in the cells covered by the filter */
+            FileGDBIterator* poSpatialIterator = NULL;
+            if( m_poIterator == NULL &&
+                CPLTestBool(CPLGetConfigOption(
+                                "OPENFILEGDB_USE_SPATIAL_INDEX", "YES")) )
+            {
+                poSpatialIterator = FileGDBIterator::BuildSpatial(
+                                            m_poLyrTable, m_sFilterEnvelope);
+            }
+            if( poSpatialIterator != NULL )
+            {
+                const int nCount = poSpatialIterator->GetRowCount();
+                m_pahFilteredFeatures = static_cast<void**>(
+                    VSI_MALLOC_VERBOSE(sizeof(void*) * (nCount + 1)));
+                if( m_pahFilteredFeatures != NULL )
+                {
+                    for( int i = 0; i < nCount; i++ )
+                    {
+                        m_pahFilteredFeatures[i] = (void*)(size_t)
+                            poSpatialIterator->GetNextRowSortedByFID();
+                    }
+                    m_nFilteredFeatureCount = nCount;
+                    m_bFilteredFeaturesFromSPX = TRUE;
+
+                    /* The in-memory index would only see the candidate rows */
+                    if( m_eSpatialIndexState == SPI_IN_BUILDING )
+                        m_eSpatialIndexState = SPI_INVALID;
+                }
+                delete poSpatialIterator;
+            }
+        }
         m_poLyrTable->InstallFilterEnvelope(&m_sFilterEnvelope);
     }
     else
@@ -1397,6 +1437,61 @@ OGRErr OGROpenFileGDBLayer::SetAttributeFilter( const char* pszFilter )
     return eErr;
 }
 
+/***********************************************************************/
+/*                         AddToSpatialIndex()                         */
+/***********************************************************************/
+
+void OGROpenFileGDBLayer::AddToSpatialIndex( const OGRField* psField,
+                                             int iRow )
+{
+    OGREnvelope sFeatureEnvelope;
+    if( m_poLyrTable->GetFeatureExtent(psField,
+                                       &sFeatureEnvelope) )
+    {
+        CPLRectObj sBounds;
+        sBounds.minx = sFeatureEnvelope.MinX;
+        sBounds.miny = sFeatureEnvelope.MinY;
+        sBounds.maxx = sFeatureEnvelope.MaxX;
+        sBounds.maxy = sFeatureEnvelope.MaxY;
+        CPLQuadTreeInsertWithBounds(m_pQuadTree,
+                                    (void*)(size_t)iRow,
+                                    &sBounds);
+    }
+}
+
+/***********************************************************************/
+/*                        GetCurrentGeometry()                         */
+/*                                                                     */
+/*      Decode the geometry of the current row, promoted to the        */
+/*      multi type advertized by the layer.                            */
+/***********************************************************************/
+
+OGRGeometry* OGROpenFileGDBLayer::GetCurrentGeometry( const OGRField* psField )
+{
+    OGRGeometry* poGeom = m_poGeomConverter->GetAsGeometry(psField);
+    if( poGeom != NULL )
+    {
+        OGRwkbGeometryType eFlattenType = wkbFlatten(poGeom->getGeometryType());
+        if( eFlattenType == wkbPolygon )
+            poGeom = OGRGeometryFactory::forceToMultiPolygon(poGeom);
+        else if( eFlattenType == wkbCurvePolygon)
+        {
+            OGRMultiSurface* poMS = new OGRMultiSurface();
+            poMS->addGeometryDirectly( poGeom );
+            poGeom = poMS;
+        }
+        else if( eFlattenType == wkbLineString )
+            poGeom = OGRGeometryFactory::forceToMultiLineString(poGeom);
+        else if (eFlattenType == wkbCompoundCurve)
+        {
+            OGRMultiCurve* poMC = new OGRMultiCurve();
+            poMC->addGeometryDirectly( poGeom );
+            poGeom = poMC;
+        }
+    }
+    return poGeom;
+}
+
 /***********************************************************************/
 /*                         GetCurrentFeature()                         */
 /***********************************************************************/
@@ -1421,21 +1516,7 @@ OGRFeature* OGROpenFileGDBLayer::GetCurrentFeature()
             if( psField != NULL )
             {
                 if( m_eSpatialIndexState == SPI_IN_BUILDING )
-                {
-                    OGREnvelope sFeatureEnvelope;
-                    if( m_poLyrTable->GetFeatureExtent(psField,
-                                                       &sFeatureEnvelope) )
-                    {
-                        CPLRectObj sBounds;
-                        sBounds.minx = sFeatureEnvelope.MinX;
-                        sBounds.miny = sFeatureEnvelope.MinY;
-                        sBounds.maxx = sFeatureEnvelope.MaxX;
-                        sBounds.maxy = sFeatureEnvelope.MaxY;
-                        CPLQuadTreeInsertWithBounds(m_pQuadTree,
-                                                    (void*)(size_t)iRow,
-                                                    &sBounds);
-                    }
-                }
+                    AddToSpatialIndex(psField, iRow);
 
                 if( m_poFilterGeom != NULL &&
                     m_eSpatialIndexState != SPI_COMPLETED &&
@@ -1445,27 +1526,9 @@ OGRFeature* OGROpenFileGDBLayer::GetCurrentFeature()
                     return NULL;
                 }
 
-                OGRGeometry* poGeom = m_poGeomConverter->GetAsGeometry(psField);
+                OGRGeometry* poGeom = GetCurrentGeometry(psField);
                 if( poGeom != NULL )
                 {
-                    OGRwkbGeometryType eFlattenType = wkbFlatten(poGeom->getGeometryType());
-                    if( eFlattenType == wkbPolygon )
-                        poGeom = OGRGeometryFactory::forceToMultiPolygon(poGeom);
-                    else if( eFlattenType == wkbCurvePolygon)
-                    {
-                        OGRMultiSurface* poMS = new OGRMultiSurface();
-                        poMS->addGeometryDirectly( poGeom );
-                        poGeom = poMS;
-                    }
-                    else if( eFlattenType == wkbLineString )
-                        poGeom = OGRGeometryFactory::forceToMultiLineString(poGeom);
-                    else if (eFlattenType == wkbCompoundCurve)
-                    {
-                        OGRMultiCurve* poMC = new OGRMultiCurve();
-                        poMC->addGeometryDirectly( poGeom );
-                        poGeom = poMC;
-                    }
-
                     poGeom->assignSpatialReference(
                         m_poFeatureDefn->GetGeomFieldDefn(0)->GetSpatialRef() );
 
@@ -1610,6 +1673,122 @@ OGRFeature* OGROpenFileGDBLayer::GetNextFeature()
     }
 }
 
+/***********************************************************************/
+/*                     AddCurrentFeatureToBatch()                      */
+/*                                                                     */
+/*      Same as GetCurrentFeature(), without spatial filter, but       */
+/*      append the current row to a batch. Field values point into     */
+/*      the row buffer of the table and are directly copied into the   */
+/*      columns of the batch.                                          */
+/***********************************************************************/
+
+void OGROpenFileGDBLayer::AddCurrentFeatureToBatch( OGRFeatureBatch* poBatch )
+{
+    const int iRow = m_poLyrTable->GetCurRow();
+    poBatch->AddFeature();
+    poBatch->SetFID(iRow + 1);
+
+    int iOGRIdx = 0;
+    for(int iGDBIdx=0;iGDBIdx<m_poLyrTable->GetFieldCount();iGDBIdx++)
+    {
+        if( iGDBIdx == m_iGeomFieldIdx )
+        {
+            if( m_poFeatureDefn->GetGeomFieldDefn(0)->IsIgnored() )
+            {
+                if( m_eSpatialIndexState == SPI_IN_BUILDING )
+                    m_eSpatialIndexState = SPI_INVALID;
+                continue;
+            }
+
+            const OGRField* psField = m_poLyrTable->GetFieldValue(iGDBIdx);
+            if( psField != NULL )
+            {
+                if( m_eSpatialIndexState == SPI_IN_BUILDING )
+                    AddToSpatialIndex(psField, iRow);
+
+                OGRGeometry* poGeom = GetCurrentGeometry(psField);
+                poBatch->SetGeomField(0, poGeom);
+                delete poGeom;
+            }
+        }
+        else
+        {
+            if( !m_poFeatureDefn->GetFieldDefn(iOGRIdx)->IsIgnored() )
+            {
+                const OGRField* psField = m_poLyrTable->GetFieldValue(iGDBIdx);
+                if( psField != NULL )
+                {
+                    if( iGDBIdx == m_iFieldToReadAsBinary )
+                        poBatch->SetField(iOGRIdx, (const char*) psField->Binary.paData);
+                    else
+                        poBatch->SetField(iOGRIdx, psField);
+                }
+            }
+            iOGRIdx ++;
+        }
+    }
+
+    if( m_poLyrTable->HasDeletedFeaturesListed() )
+    {
+        poBatch->SetField(m_poFeatureDefn->GetFieldCount() - 1,
+                          m_poLyrTable->IsCurRowDeleted());
+    }
+}
+
+/***********************************************************************/
+/*                       GetNextFeatureBatch()                         */
+/***********************************************************************/
+
+int OGROpenFileGDBLayer::GetNextFeatureBatch( OGRFeatureBatch* poBatch,
+                                              int nMaxFeatures )
+{
+    if( !BuildLayerDefinition() )
+    {
+        poBatch->Reset();
+        return 0;
+    }
+
+    // Filtered reads go through OGRFeature to evaluate the filters.
+    if( m_poFilterGeom != NULL || m_poAttrQuery != NULL ||
+        m_nFilteredFeatureCount >= 0 || m_poIterator != NULL )
+    {
+        return OGRLayer::GetNextFeatureBatch(poBatch, nMaxFeatures);
+    }
+
+    poBatch->Reset();
+    if( m_bEOF )
+        return 0;
+
+    if( !poBatch->IsCompatibleWith(m_poFeatureDefn) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Batch not created from the current layer definition" );
+        return 0;
+    }
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        if( m_iCurFeat == m_poLyrTable->GetTotalRecordCount() )
+            break;
+        m_iCurFeat = m_poLyrTable->GetAndSelectNextNonEmptyRow(m_iCurFeat);
+        if( m_iCurFeat < 0 )
+        {
+            m_bEOF = TRUE;
+            break;
+        }
+        m_iCurFeat ++;
+        AddCurrentFeatureToBatch(poBatch);
+        if( m_eSpatialIndexState == SPI_IN_BUILDING &&
+            m_iCurFeat == m_poLyrTable->GetTotalRecordCount() )
+        {
+            CPLDebug("OpenFileGDB", "SPI_COMPLETED");
+            m_eSpatialIndexState = SPI_COMPLETED;
+        }
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /***********************************************************************/
 /*                          GetFeature()                               */
 /***********************************************************************/
@@ -1656,6 +1835,9 @@ OGRErr OGROpenFileGDBLayer::SetNextByIndex( GIntBig nIndex )
     if( m_eSpatialIndexState == SPI_IN_BUILDING )
         m_eSpatialIndexState = SPI_INVALID;
 
+    if( m_bFilteredFeaturesFromSPX )
+        return OGRLayer::SetNextByIndex(nIndex);
+
     if( m_nFilteredFeatureCount >= 0 )
     {
         if( nIndex < 0 || nIndex >= m_nFilteredFeatureCount )
@@ -1714,6 +1896,9 @@ GIntBig OGROpenFileGDBLayer::GetFeatureCount( int bForce )
     }
     else if( m_nFilteredFeatureCount >= 0 && m_poAttrQuery == NULL )
     {
+        /* Rows found in the .spx are only candidates */
+        if( m_bFilteredFeaturesFromSPX )
+            return OGRLayer::GetFeatureCount(bForce);
         return m_nFilteredFeatureCount;
     }
 
@@ -1823,7 +2008,7 @@ int OGROpenFileGDBLayer::TestCapability( const char * pszCap )
     {
         return ( m_poLyrTable->GetValidRecordCount() ==
                  m_poLyrTable->GetTotalRecordCount() &&
-                 m_poIterator == NULL );
+                 m_poIterator == NULL && !m_bFilteredFeaturesFromSPX );
     }
     else if( EQUAL(pszCap,OLCRandomRead) )
     {
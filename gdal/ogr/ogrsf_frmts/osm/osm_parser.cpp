@@ -30,14 +30,17 @@
 #include "gpb.h"
 
 #include "cpl_conv.h"
+#include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 
 #ifdef HAVE_EXPAT
 #include "ogr_expat.h"
 #endif
 
 #include <algorithm>
+#include <vector>
 
 CPL_CVSID("$Id$");
 
@@ -62,6 +65,8 @@ static void INIT_INFO( OSMInfo *sInfo )
     sInfo->pszUserSID = NULL;
 }
 
+typedef struct _OSMDecodeJob OSMDecodeJob;
+
 /************************************************************************/
 /*                            _OSMContext                               */
 /************************************************************************/
@@ -133,6 +138,23 @@ struct _OSMContext
     NotifyRelationFunc  pfnNotifyRelation;
     NotifyBoundsFunc    pfnNotifyBounds;
     void               *user_data;
+
+    // Multi-threaded PBF decoding: blobs are read ahead by the main thread
+    // and decoded by the pool into a ring of jobs, whose notifications are
+    // replayed in file order by OSM_ProcessBlock(). The pool is created on
+    // the first read of a block. nBytesRead remains the end offset of the
+    // block being notified, and nBytesReadAhead is the file position.
+    bool                bJobsCreated;
+    CPLWorkerThreadPool *poWTP;
+    GUIntBig            nBytesReadAhead;
+    OSMDecodeJob      **papsJobs;
+    int                 nJobs;
+    int                 iFirstJob;
+    int                 nJobsInFlight;
+    bool                bReadAheadEOF;
+    bool                bReadAheadError;
+    CPLMutex           *hJobMutex;
+    CPLCond            *hJobCond;
 };
 
 /************************************************************************/
@@ -2180,6 +2202,520 @@ static OSMRetCode XML_ProcessBlock(OSMContext* psCtxt)
 
 #endif
 
+/************************************************************************/
+/*                           PBF_ReadBlob()                             */
+/*                                                                      */
+/*      Read the next blob of the file into *ppabyBlob, which is grown  */
+/*      if needed, and add the number of bytes read to *pnBytesRead.    */
+/************************************************************************/
+
+static OSMRetCode PBF_ReadBlob( OSMContext* psCtxt,
+                                GUIntBig* pnBytesRead,
+                                GByte** ppabyBlob,
+                                unsigned int* pnBlobSizeAllocated,
+                                unsigned int* pnBlobSize,
+                                BlobType* peType )
+{
+    bool nRet = false;
+    GByte abyHeaderSize[4];
+    unsigned int nBlobSize = 0;
+    BlobType eType;
+
+    if( VSIFReadL(abyHeaderSize, 4, 1, psCtxt->fp) != 1 )
+    {
+        return OSM_EOF;
+    }
+    const unsigned int nHeaderSize =
+        (abyHeaderSize[0] << 24) | (abyHeaderSize[1] << 16) |
+        (abyHeaderSize[2] << 8) | abyHeaderSize[3];
+
+    *pnBytesRead += 4;
+
+    /* printf("nHeaderSize = %d\n", nHeaderSize); */
+    if( nHeaderSize > 64 * 1024 )
+        GOTO_END_ERROR;
+    if( VSIFReadL(*ppabyBlob, 1, nHeaderSize, psCtxt->fp) != nHeaderSize )
+        GOTO_END_ERROR;
+
+    *pnBytesRead += nHeaderSize;
+
+    memset(*ppabyBlob + nHeaderSize, 0, EXTRA_BYTES);
+    nRet = ReadBlobHeader(*ppabyBlob, *ppabyBlob + nHeaderSize,
+                          &nBlobSize, &eType);
+    if( !nRet || eType == BLOB_UNKNOWN )
+        GOTO_END_ERROR;
+
+    if( nBlobSize > 64*1024*1024 )
+        GOTO_END_ERROR;
+    if( nBlobSize > *pnBlobSizeAllocated )
+    {
+        *pnBlobSizeAllocated =
+            std::max(*pnBlobSizeAllocated * 2, nBlobSize);
+        GByte* pabyBlobNew = static_cast<GByte *>(
+            VSI_REALLOC_VERBOSE(*ppabyBlob,
+                                *pnBlobSizeAllocated + EXTRA_BYTES));
+        if( pabyBlobNew == NULL )
+            GOTO_END_ERROR;
+        *ppabyBlob = pabyBlobNew;
+    }
+    if( VSIFReadL(*ppabyBlob, 1, nBlobSize, psCtxt->fp) != nBlobSize )
+        GOTO_END_ERROR;
+
+    *pnBytesRead += nBlobSize;
+
+    memset(*ppabyBlob + nBlobSize, 0, EXTRA_BYTES);
+
+    *pnBlobSize = nBlobSize;
+    *peType = eType;
+    return OSM_OK;
+
+end_error:
+
+    return OSM_ERROR;
+}
+
+/************************************************************************/
+/*                            _OSMDecodeJob                             */
+/************************************************************************/
+
+typedef enum
+{
+    EVENT_NODES,
+    EVENT_WAY,
+    EVENT_RELATION,
+    EVENT_BOUNDS
+} OSMEventType;
+
+typedef struct
+{
+    OSMEventType eType;
+    size_t       nFirst;
+    size_t       nCount;
+} OSMEvent;
+
+// Decoding of a blob by a worker thread. The notifications emitted while
+// decoding are recorded, with the tags, node references and members they
+// point to copied as the decoding buffers are reused between objects.
+// Strings still point into the blob, which stays owned by the job until
+// the notifications have been replayed.
+struct _OSMDecodeJob
+{
+    OSMContext      *psParentCtxt;
+    OSMContext       sCtxt;
+    unsigned int     nBlobSize;
+    BlobType         eType;
+    GUIntBig         nBytesReadEnd;
+    bool             bRet;
+    bool             bDone;
+
+    std::vector<OSMEvent>    asEvents;
+    std::vector<OSMNode>     asNodes;
+    std::vector<size_t>      anNodeTagsIdx;
+    std::vector<OSMWay>      asWays;
+    std::vector<size_t>      anWayTagsIdx;
+    std::vector<size_t>      anWayNodeRefsIdx;
+    std::vector<OSMRelation> asRelations;
+    std::vector<size_t>      anRelationTagsIdx;
+    std::vector<size_t>      anRelationMembersIdx;
+    std::vector<OSMTag>      asTags;
+    std::vector<GIntBig>     anNodeRefs;
+    std::vector<OSMMember>   asMembers;
+    double                   adfBounds[4];
+};
+
+/************************************************************************/
+/*                          PBF_AddEvent()                              */
+/************************************************************************/
+
+static void PBF_AddEvent( OSMDecodeJob* psJob, OSMEventType eType,
+                          size_t nFirst, size_t nCount )
+{
+    // Merge with the previous event if possible, as the nodes of dense
+    // node groups and of plain nodes are notified in successive calls.
+    if( !psJob->asEvents.empty() )
+    {
+        OSMEvent& sLast = psJob->asEvents.back();
+        if( sLast.eType == eType && eType != EVENT_BOUNDS &&
+            sLast.nFirst + sLast.nCount == nFirst )
+        {
+            sLast.nCount += nCount;
+            return;
+        }
+    }
+    OSMEvent sEvent;
+    sEvent.eType = eType;
+    sEvent.nFirst = nFirst;
+    sEvent.nCount = nCount;
+    psJob->asEvents.push_back(sEvent);
+}
+
+/************************************************************************/
+/*                       PBF_RecordNodesFunc()                          */
+/************************************************************************/
+
+static void PBF_RecordNodesFunc( unsigned int nNodes, OSMNode* pasNodes,
+                                 OSMContext* /* psCtxt */, void* user_data )
+{
+    OSMDecodeJob* psJob = static_cast<OSMDecodeJob *>(user_data);
+    PBF_AddEvent(psJob, EVENT_NODES, psJob->asNodes.size(), nNodes);
+    for( unsigned int i = 0; i < nNodes; i++ )
+    {
+        psJob->asNodes.push_back(pasNodes[i]);
+        psJob->anNodeTagsIdx.push_back(psJob->asTags.size());
+        psJob->asTags.insert(psJob->asTags.end(), pasNodes[i].pasTags,
+                             pasNodes[i].pasTags + pasNodes[i].nTags);
+    }
+}
+
+/************************************************************************/
+/*                        PBF_RecordWayFunc()                           */
+/************************************************************************/
+
+static void PBF_RecordWayFunc( OSMWay* psWay,
+                               OSMContext* /* psCtxt */, void* user_data )
+{
+    OSMDecodeJob* psJob = static_cast<OSMDecodeJob *>(user_data);
+    PBF_AddEvent(psJob, EVENT_WAY, psJob->asWays.size(), 1);
+    psJob->asWays.push_back(*psWay);
+    psJob->anWayTagsIdx.push_back(psJob->asTags.size());
+    psJob->asTags.insert(psJob->asTags.end(), psWay->pasTags,
+                         psWay->pasTags + psWay->nTags);
+    psJob->anWayNodeRefsIdx.push_back(psJob->anNodeRefs.size());
+    psJob->anNodeRefs.insert(psJob->anNodeRefs.end(), psWay->panNodeRefs,
+                             psWay->panNodeRefs + psWay->nRefs);
+}
+
+/************************************************************************/
+/*                      PBF_RecordRelationFunc()                        */
+/************************************************************************/
+
+static void PBF_RecordRelationFunc( OSMRelation* psRelation,
+                                    OSMContext* /* psCtxt */,
+                                    void* user_data )
+{
+    OSMDecodeJob* psJob = static_cast<OSMDecodeJob *>(user_data);
+    PBF_AddEvent(psJob, EVENT_RELATION, psJob->asRelations.size(), 1);
+    psJob->asRelations.push_back(*psRelation);
+    psJob->anRelationTagsIdx.push_back(psJob->asTags.size());
+    psJob->asTags.insert(psJob->asTags.end(), psRelation->pasTags,
+                         psRelation->pasTags + psRelation->nTags);
+    psJob->anRelationMembersIdx.push_back(psJob->asMembers.size());
+    psJob->asMembers.insert(psJob->asMembers.end(), psRelation->pasMembers,
+                            psRelation->pasMembers + psRelation->nMembers);
+}
+
+/************************************************************************/
+/*                       PBF_RecordBoundsFunc()                         */
+/************************************************************************/
+
+static void PBF_RecordBoundsFunc( double dfXMin, double dfYMin,
+                                  double dfXMax, double dfYMax,
+                                  OSMContext* /* psCtxt */, void* user_data )
+{
+    OSMDecodeJob* psJob = static_cast<OSMDecodeJob *>(user_data);
+    PBF_AddEvent(psJob, EVENT_BOUNDS, 0, 1);
+    psJob->adfBounds[0] = dfXMin;
+    psJob->adfBounds[1] = dfYMin;
+    psJob->adfBounds[2] = dfXMax;
+    psJob->adfBounds[3] = dfYMax;
+}
+
+/************************************************************************/
+/*                          PBF_DecodeJob()                             */
+/************************************************************************/
+
+static void PBF_DecodeJob( void* pData )
+{
+    OSMDecodeJob* psJob = static_cast<OSMDecodeJob *>(pData);
+
+    psJob->bRet = ReadBlob(psJob->sCtxt.pabyBlob, psJob->nBlobSize,
+                           psJob->eType, &psJob->sCtxt);
+
+    OSMContext* psCtxt = psJob->psParentCtxt;
+    CPLAcquireMutex(psCtxt->hJobMutex, 1000.0);
+    psJob->bDone = true;
+    CPLCondBroadcast(psCtxt->hJobCond);
+    CPLReleaseMutex(psCtxt->hJobMutex);
+}
+
+/************************************************************************/
+/*                         PBF_ReplayJob()                              */
+/************************************************************************/
+
+static void PBF_ReplayJob( OSMContext* psCtxt, OSMDecodeJob* psJob )
+{
+    for( size_t iEvent = 0; iEvent < psJob->asEvents.size(); iEvent++ )
+    {
+        const OSMEvent& sEvent = psJob->asEvents[iEvent];
+        const size_t nLast = sEvent.nFirst + sEvent.nCount;
+        switch( sEvent.eType )
+        {
+            case EVENT_NODES:
+            {
+                for( size_t i = sEvent.nFirst; i < nLast; i++ )
+                {
+                    psJob->asNodes[i].pasTags =
+                        psJob->asNodes[i].nTags ?
+                            &psJob->asTags[psJob->anNodeTagsIdx[i]] : NULL;
+                }
+                psCtxt->pfnNotifyNodes(
+                    static_cast<unsigned int>(sEvent.nCount),
+                    &psJob->asNodes[sEvent.nFirst],
+                    psCtxt, psCtxt->user_data);
+                break;
+            }
+
+            case EVENT_WAY:
+            {
+                for( size_t i = sEvent.nFirst; i < nLast; i++ )
+                {
+                    OSMWay* psWay = &psJob->asWays[i];
+                    psWay->pasTags = psWay->nTags ?
+                        &psJob->asTags[psJob->anWayTagsIdx[i]] : NULL;
+                    psWay->panNodeRefs = psWay->nRefs ?
+                        &psJob->anNodeRefs[psJob->anWayNodeRefsIdx[i]] : NULL;
+                    psCtxt->pfnNotifyWay(psWay, psCtxt, psCtxt->user_data);
+                }
+                break;
+            }
+
+            case EVENT_RELATION:
+            {
+                for( size_t i = sEvent.nFirst; i < nLast; i++ )
+                {
+                    OSMRelation* psRelation = &psJob->asRelations[i];
+                    psRelation->pasTags = psRelation->nTags ?
+                        &psJob->asTags[psJob->anRelationTagsIdx[i]] : NULL;
+                    psRelation->pasMembers = psRelation->nMembers ?
+                        &psJob->asMembers[psJob->anRelationMembersIdx[i]] :
+                        NULL;
+                    psCtxt->pfnNotifyRelation(psRelation, psCtxt,
+                                              psCtxt->user_data);
+                }
+                break;
+            }
+
+            case EVENT_BOUNDS:
+            {
+                psCtxt->pfnNotifyBounds(psJob->adfBounds[0],
+                                        psJob->adfBounds[1],
+                                        psJob->adfBounds[2],
+                                        psJob->adfBounds[3],
+                                        psCtxt, psCtxt->user_data);
+                break;
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                         PBF_ClearJob()                               */
+/************************************************************************/
+
+static void PBF_ClearJob( OSMDecodeJob* psJob )
+{
+    psJob->asEvents.clear();
+    psJob->asNodes.clear();
+    psJob->anNodeTagsIdx.clear();
+    psJob->asWays.clear();
+    psJob->anWayTagsIdx.clear();
+    psJob->anWayNodeRefsIdx.clear();
+    psJob->asRelations.clear();
+    psJob->anRelationTagsIdx.clear();
+    psJob->anRelationMembersIdx.clear();
+    psJob->asTags.clear();
+    psJob->anNodeRefs.clear();
+    psJob->asMembers.clear();
+}
+
+/************************************************************************/
+/*                         PBF_CreateJobs()                             */
+/************************************************************************/
+
+static void PBF_CreateJobs( OSMContext* psCtxt )
+{
+    psCtxt->bJobsCreated = true;
+
+    const int nThreads = CPLGetNumThreadsOption("OSM_NUM_THREADS", 1);
+    if( nThreads <= 1 )
+        return;
+
+    psCtxt->poWTP = new CPLWorkerThreadPool();
+    if( !psCtxt->poWTP->Setup(nThreads, NULL, NULL) )
+    {
+        delete psCtxt->poWTP;
+        psCtxt->poWTP = NULL;
+        return;
+    }
+    CPLDebug("OSM", "Using %d threads for PBF decoding", nThreads);
+
+    psCtxt->hJobMutex = CPLCreateMutex();
+    CPLReleaseMutex(psCtxt->hJobMutex);
+    psCtxt->hJobCond = CPLCreateCond();
+    psCtxt->nBytesReadAhead = psCtxt->nBytesRead;
+
+    // Read ahead a few more blobs than there are threads, so that workers
+    // do not wait while the main thread notifies the decoded objects.
+    psCtxt->nJobs = 2 * nThreads;
+    psCtxt->papsJobs = static_cast<OSMDecodeJob **>(
+        CPLCalloc(psCtxt->nJobs, sizeof(OSMDecodeJob*)));
+    for( int i = 0; i < psCtxt->nJobs; i++ )
+    {
+        OSMDecodeJob* psJob = new OSMDecodeJob();
+        psJob->psParentCtxt = psCtxt;
+        memset(&psJob->sCtxt, 0, sizeof(OSMContext));
+        psJob->sCtxt.bPBF = true;
+        psJob->sCtxt.pfnNotifyNodes = PBF_RecordNodesFunc;
+        psJob->sCtxt.pfnNotifyWay = PBF_RecordWayFunc;
+        psJob->sCtxt.pfnNotifyRelation = PBF_RecordRelationFunc;
+        psJob->sCtxt.pfnNotifyBounds = PBF_RecordBoundsFunc;
+        psJob->sCtxt.user_data = psJob;
+        psJob->sCtxt.nBlobSizeAllocated = psCtxt->nBlobSizeAllocated;
+        psJob->sCtxt.pabyBlob = static_cast<GByte *>(
+            CPLMalloc(psJob->sCtxt.nBlobSizeAllocated + EXTRA_BYTES));
+        psJob->nBlobSize = 0;
+        psJob->eType = BLOB_UNKNOWN;
+        psJob->nBytesReadEnd = 0;
+        psJob->bRet = false;
+        psJob->bDone = false;
+        psCtxt->papsJobs[i] = psJob;
+    }
+}
+
+/************************************************************************/
+/*                       PBF_WaitAllJobs()                              */
+/************************************************************************/
+
+static void PBF_WaitAllJobs( OSMContext* psCtxt )
+{
+    if( psCtxt->poWTP == NULL )
+        return;
+    psCtxt->poWTP->WaitCompletion();
+    psCtxt->nBytesReadAhead = 0;
+    psCtxt->iFirstJob = 0;
+    psCtxt->nJobsInFlight = 0;
+    psCtxt->bReadAheadEOF = false;
+    psCtxt->bReadAheadError = false;
+}
+
+/************************************************************************/
+/*                       PBF_DestroyJobs()                              */
+/************************************************************************/
+
+static void PBF_DestroyJobs( OSMContext* psCtxt )
+{
+    if( psCtxt->poWTP == NULL )
+        return;
+    PBF_WaitAllJobs(psCtxt);
+    delete psCtxt->poWTP;
+    psCtxt->poWTP = NULL;
+    for( int i = 0; i < psCtxt->nJobs; i++ )
+    {
+        OSMDecodeJob* psJob = psCtxt->papsJobs[i];
+        VSIFree(psJob->sCtxt.pabyBlob);
+        VSIFree(psJob->sCtxt.pabyUncompressed);
+        VSIFree(psJob->sCtxt.panStrOff);
+        VSIFree(psJob->sCtxt.pasNodes);
+        VSIFree(psJob->sCtxt.pasTags);
+        VSIFree(psJob->sCtxt.pasMembers);
+        VSIFree(psJob->sCtxt.panNodeRefs);
+        delete psJob;
+    }
+    CPLFree(psCtxt->papsJobs);
+    psCtxt->papsJobs = NULL;
+    CPLDestroyCond(psCtxt->hJobCond);
+    CPLDestroyMutex(psCtxt->hJobMutex);
+}
+
+/************************************************************************/
+/*                      PBF_ProcessBlockMT()                            */
+/************************************************************************/
+
+static OSMRetCode PBF_ProcessBlockMT(OSMContext* psCtxt)
+{
+    // Submit the decoding of the next blobs.
+    while( psCtxt->nJobsInFlight < psCtxt->nJobs &&
+           !psCtxt->bReadAheadEOF && !psCtxt->bReadAheadError )
+    {
+        OSMDecodeJob* psJob = psCtxt->papsJobs[
+            (psCtxt->iFirstJob + psCtxt->nJobsInFlight) % psCtxt->nJobs];
+        const OSMRetCode eRet =
+            PBF_ReadBlob(psCtxt, &psCtxt->nBytesReadAhead,
+                         &psJob->sCtxt.pabyBlob,
+                         &psJob->sCtxt.nBlobSizeAllocated,
+                         &psJob->nBlobSize, &psJob->eType);
+        if( eRet == OSM_EOF )
+        {
+            psCtxt->bReadAheadEOF = true;
+            break;
+        }
+        if( eRet == OSM_ERROR )
+        {
+            // Report the error once the previous blobs have been notified.
+            psCtxt->bReadAheadError = true;
+            break;
+        }
+        PBF_ClearJob(psJob);
+        psJob->nBytesReadEnd = psCtxt->nBytesReadAhead;
+        psJob->bDone = false;
+        psJob->bRet = false;
+        psCtxt->poWTP->SubmitJob(PBF_DecodeJob, psJob);
+        psCtxt->nJobsInFlight++;
+    }
+
+    if( psCtxt->nJobsInFlight == 0 )
+    {
+        psCtxt->nBytesRead = psCtxt->nBytesReadAhead;
+        return psCtxt->bReadAheadError ? OSM_ERROR : OSM_EOF;
+    }
+
+    // Notify the objects of the oldest blob, in file order.
+    OSMDecodeJob* psJob = psCtxt->papsJobs[psCtxt->iFirstJob];
+    CPLAcquireMutex(psCtxt->hJobMutex, 1000.0);
+    while( !psJob->bDone )
+        CPLCondWait(psCtxt->hJobCond, psCtxt->hJobMutex);
+    CPLReleaseMutex(psCtxt->hJobMutex);
+
+    psCtxt->iFirstJob = (psCtxt->iFirstJob + 1) % psCtxt->nJobs;
+    psCtxt->nJobsInFlight--;
+
+    // Progress is reported up to the block being notified, not up to the
+    // blocks read ahead.
+    psCtxt->nBytesRead = psJob->nBytesReadEnd;
+
+    if( !psJob->bRet )
+        return OSM_ERROR;
+
+    PBF_ReplayJob(psCtxt, psJob);
+    return OSM_OK;
+}
+
+/************************************************************************/
+/*                          PBF_ProcessBlock()                          */
+/************************************************************************/
+
+static OSMRetCode PBF_ProcessBlock(OSMContext* psCtxt)
+{
+    if( !psCtxt->bJobsCreated )
+        PBF_CreateJobs(psCtxt);
+    if( psCtxt->poWTP != NULL )
+        return PBF_ProcessBlockMT(psCtxt);
+
+    unsigned int nBlobSize = 0;
+    BlobType eType = BLOB_UNKNOWN;
+    const OSMRetCode eRet =
+        PBF_ReadBlob(psCtxt, &psCtxt->nBytesRead,
+                     &psCtxt->pabyBlob, &psCtxt->nBlobSizeAllocated,
+                     &nBlobSize, &eType);
+    if( eRet != OSM_OK )
+        return eRet;
+
+    if( !ReadBlob(psCtxt->pabyBlob, nBlobSize, eType, psCtxt) )
+        return OSM_ERROR;
+
+    return OSM_OK;
+}
+
 /************************************************************************/
 /*                              OSM_Open()                              */
 /************************************************************************/
@@ -2325,6 +2861,8 @@ void OSM_Close(OSMContext* psCtxt)
     if( psCtxt == NULL )
         return;
 
+    PBF_DestroyJobs(psCtxt);
+
 #ifdef HAVE_EXPAT
     if( !psCtxt->bPBF )
     {
@@ -2352,6 +2890,8 @@ void OSM_Close(OSMContext* psCtxt)
 
 void OSM_ResetReading( OSMContext* psCtxt )
 {
+    PBF_WaitAllJobs(psCtxt);
+
     VSIFSeekL(psCtxt->fp, 0, SEEK_SET);
 
     psCtxt->nBytesRead = 0;
@@ -2384,72 +2924,6 @@ void OSM_ResetReading( OSMContext* psCtxt )
 /*                          OSM_ProcessBlock()                          */
 /************************************************************************/
 
-static OSMRetCode PBF_ProcessBlock(OSMContext* psCtxt)
-{
-    bool nRet = false;
-    GByte abyHeaderSize[4];
-    unsigned int nBlobSize = 0;
-    BlobType eType;
-
-    if( VSIFReadL(abyHeaderSize, 4, 1, psCtxt->fp) != 1 )
-    {
-        return OSM_EOF;
-    }
-    const unsigned int nHeaderSize =
-        (abyHeaderSize[0] << 24) | (abyHeaderSize[1] << 16) |
-        (abyHeaderSize[2] << 8) | abyHeaderSize[3];
-
-    psCtxt->nBytesRead += 4;
-
-    /* printf("nHeaderSize = %d\n", nHeaderSize); */
-    if( nHeaderSize > 64 * 1024 )
-        GOTO_END_ERROR;
-    if( VSIFReadL(psCtxt->pabyBlob, 1, nHeaderSize, psCtxt->fp) != nHeaderSize )
-        GOTO_END_ERROR;
-
-    psCtxt->nBytesRead += nHeaderSize;
-
-    memset(psCtxt->pabyBlob + nHeaderSize, 0, EXTRA_BYTES);
-    nRet = ReadBlobHeader(psCtxt->pabyBlob, psCtxt->pabyBlob + nHeaderSize,
-                          &nBlobSize, &eType);
-    if( !nRet || eType == BLOB_UNKNOWN )
-        GOTO_END_ERROR;
-
-    if( nBlobSize > 64*1024*1024 )
-        GOTO_END_ERROR;
-    if( nBlobSize > psCtxt->nBlobSizeAllocated )
-    {
-        psCtxt->nBlobSizeAllocated =
-            std::max(psCtxt->nBlobSizeAllocated * 2, nBlobSize);
-        GByte* pabyBlobNew = static_cast<GByte *>(
-            VSI_REALLOC_VERBOSE(psCtxt->pabyBlob,
-                                psCtxt->nBlobSizeAllocated + EXTRA_BYTES));
-        if( pabyBlobNew == NULL )
-            GOTO_END_ERROR;
-        psCtxt->pabyBlob = pabyBlobNew;
-    }
-    if( VSIFReadL(psCtxt->pabyBlob, 1, nBlobSize, psCtxt->fp) != nBlobSize )
-        GOTO_END_ERROR;
-
-    psCtxt->nBytesRead += nBlobSize;
-
-    memset(psCtxt->pabyBlob + nBlobSize, 0, EXTRA_BYTES);
-    nRet = ReadBlob(psCtxt->pabyBlob, nBlobSize, eType,
-                    psCtxt);
-    if( !nRet )
-        GOTO_END_ERROR;
-
-    return OSM_OK;
-
-end_error:
-
-    return OSM_ERROR;
-}
-
-/************************************************************************/
-/*                          OSM_ProcessBlock()                          */
-/************************************************************************/
-
 OSMRetCode OSM_ProcessBlock( OSMContext* psCtxt )
 {
 #ifdef HAVE_EXPAT
@@ -33,8 +33,11 @@
 
 #include "ogrsf_frmts.h"
 #include "libpq-fe.h"
+#include "cpl_multiproc.h"
 #include "cpl_string.h"
 
+#include <vector>
+
 #include "ogrpgutility.h"
 #include "ogr_pgdump.h"
 
@@ -76,6 +79,8 @@
 #define NUMERICOID              1700
 #define NUMERICARRAYOID         1231
 
+#define POSTGRES_EPOCH_JDATE 2451545 /* == date2j(2000, 1, 1) */
+
 CPLString OGRPGEscapeString(PGconn *hPGConn,
                             const char* pszStrValue, int nMaxLength = -1,
                             const char* pszTableName = "",
@@ -185,6 +190,10 @@ class OGRPGLayer : public OGRLayer
 
     int                 nResultOffset;
 
+    int                 bPrefetch;
+    int                 bPrefetchPending;
+    PGresult           *hPrefetchResult;
+
     int                 bWkbAsOid;
 
     char                *pszFIDColumn;
@@ -197,6 +206,12 @@ class OGRPGLayer : public OGRLayer
 
     void                SetInitialQueryCursor();
     void                CloseCursor();
+    int                 CanDecodeBinaryResult( PGresult* hResult );
+
+    void                StartPrefetch();
+    void                CollectPrefetch();
+    void                DiscardPrefetch();
+    static void         CollectPrefetchFunc( void* pUserData );
 
     virtual CPLString   GetFromClauseForGetExtent() = 0;
     OGRErr              RunGetExtentRequest( OGREnvelope *psExtent, int bForce,
@@ -283,6 +298,22 @@ class OGRPGTableLayer : public OGRPGLayer
     OGRErr              CreateFeatureViaInsert( OGRFeature *poFeature );
     CPLString           BuildCopyFields();
 
+    /* COPY data is accumulated in a buffer, and sent by a worker thread */
+    /* while the next one is filled */
+    int                 bCopyBinary;
+    std::vector<Oid>    anCopyTypeOIDs;
+    std::vector<GByte>  abyCopyBuffer;
+    std::vector<GByte>  abyCopyBufferInFlight;
+    CPLJoinableThread  *hCopyThread;
+    int                 nCopyThreadResult;
+
+    int                 PrepareBinaryCopy();
+    OGRErr              AppendBinaryCopyRecord( OGRFeature *poFeature );
+    OGRErr              FlushCopyBuffer( bool bAsync );
+    OGRErr              WaitCopyThread();
+    static void         CopyThreadFunc( void* pUserData );
+    static void         WaitCopyThreadFunc( void* pUserData );
+
     int                 bHasWarnedIncompatibleGeom;
     void                CheckGeomTypeCompatibility(int iGeomField, OGRGeometry* poGeom);
 
@@ -475,6 +506,9 @@ class OGRPGDataSource : public OGRDataSource
 
     OGRPGTableLayer     *poLayerInCopyMode;
 
+    OGRPGPendingQueryFunc pfnPendingQueryFunc;
+    void               *pPendingQueryUserData;
+
     static void                OGRPGDecodeVersionString(PGver* psVersion, const char* pszVer);
 
     CPLString           osCurrentSchema;
@@ -513,6 +547,10 @@ class OGRPGDataSource : public OGRDataSource
 
     PGconn              *GetPGConn() { return hPGConn; }
 
+    void                SetPendingQuery( OGRPGPendingQueryFunc pfnFunc,
+                                         void* pUserData );
+    void                FinishPendingQuery();
+
     int                 FetchSRSId( OGRSpatialReference * poSRS );
     OGRSpatialReference *FetchSRS( int nSRSId );
     static OGRErr              InitializeMetadataTables();
@@ -62,6 +62,8 @@ OGRPGDataSource::OGRPGDataSource() :
     panSRID(NULL),
     papoSRS(NULL),
     poLayerInCopyMode(NULL),
+    pfnPendingQueryFunc(NULL),
+    pPendingQueryUserData(NULL),
     // Actual value will be auto-detected if PostGIS >= 2.0 detected.
     nUndefinedSRID(-1),
     pszForcedTables(NULL),
@@ -115,7 +117,7 @@ OGRPGDataSource::~OGRPGDataSource()
         if( pszClosingStatements != NULL )
         {
             PGresult *hResult =
-                OGRPG_PQexec( hPGConn, pszClosingStatements, TRUE );
+                OGRPG_PQexec(this, pszClosingStatements, TRUE );
             OGRPGClearResult(hResult);
         }
 
@@ -157,7 +159,7 @@ CPLString OGRPGDataSource::GetCurrentSchema()
     /* -------------------------------------------- */
     /*          Get the current schema              */
     /* -------------------------------------------- */
-    PGresult    *hResult = OGRPG_PQexec(hPGConn,"SELECT current_schema()");
+    PGresult    *hResult = OGRPG_PQexec(this,"SELECT current_schema()");
     if ( hResult && PQntuples(hResult) == 1 && !PQgetisnull(hResult,0,0) )
     {
         osCurrentSchema = PQgetvalue(hResult,0,0);
@@ -350,10 +352,8 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
 /* -------------------------------------------------------------------- */
     if( STARTS_WITH_CI(pszNewName, "PGB:") )
     {
-#if defined(BINARY_CURSOR_ENABLED)
         bUseBinaryCursor = TRUE;
-        CPLDebug("PG","BINARY cursor is used for geometry fetching");
-#endif
+        CPLDebug("PG","BINARY cursor is used for feature fetching");
     }
     else
     if( !STARTS_WITH_CI(pszNewName, "PG:") )
@@ -504,7 +504,7 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
 /* -------------------------------------------------------------------- */
     if( pszPreludeStatements != NULL )
     {
-        PGresult    *hResult = OGRPG_PQexec( hPGConn, pszPreludeStatements, TRUE );
+        PGresult    *hResult = OGRPG_PQexec(this, pszPreludeStatements, TRUE );
         if( !hResult || PQresultStatus(hResult) != PGRES_COMMAND_OK )
         {
             OGRPGClearResult( hResult );
@@ -565,14 +565,14 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
     {
         CPLString osCommand;
         osCommand.Printf("SET search_path='%s',public", osActiveSchema.c_str());
-        PGresult    *hResult = OGRPG_PQexec(hPGConn, osCommand );
+        PGresult    *hResult = OGRPG_PQexec(this, osCommand );
 
         if( !hResult || PQresultStatus(hResult) != PGRES_COMMAND_OK )
         {
             OGRPGClearResult( hResult );
             CPLDebug("PG","Command \"%s\" failed. Trying without 'public'.",osCommand.c_str());
             osCommand.Printf("SET search_path='%s'", osActiveSchema.c_str());
-            PGresult    *hResult2 = OGRPG_PQexec(hPGConn, osCommand );
+            PGresult    *hResult2 = OGRPG_PQexec(this, osCommand );
 
             if( !hResult2 || PQresultStatus(hResult2) != PGRES_COMMAND_OK )
             {
@@ -595,7 +595,7 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
     sPostgreSQLVersion.nMinor = -1;
     sPostgreSQLVersion.nRelease = -1;
 
-    PGresult* hResult = OGRPG_PQexec(hPGConn, "SELECT version()" );
+    PGresult* hResult = OGRPG_PQexec(this, "SELECT version()" );
     if( hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK
         && PQntuples(hResult) > 0 )
     {
@@ -608,7 +608,6 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
         if( pszSpace != NULL && isdigit(pszSpace[1]) )
         {
             OGRPGDecodeVersionString(&sPostgreSQLVersion, pszSpace + 1);
-#if defined(BINARY_CURSOR_ENABLED)
             if (sPostgreSQLVersion.nMajor == 7 && sPostgreSQLVersion.nMinor < 4)
             {
                 /* We don't support BINARY CURSOR for PostgreSQL < 7.4. */
@@ -616,7 +615,6 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
                 CPLDebug("PG","BINARY cursor will finally NOT be used because version < 7.4");
                 bUseBinaryCursor = FALSE;
             }
-#endif
         }
     }
     OGRPGClearResult(hResult);
@@ -626,7 +624,7 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
 /*      Test if standard_conforming_strings is recognized               */
 /* -------------------------------------------------------------------- */
 
-    hResult = OGRPG_PQexec(hPGConn, "SHOW standard_conforming_strings" );
+    hResult = OGRPG_PQexec(this, "SHOW standard_conforming_strings" );
     if( hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK
         && PQntuples(hResult) == 1 )
     {
@@ -639,18 +637,17 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
 /* -------------------------------------------------------------------- */
 /*      Test if time binary format is int8 or float8                    */
 /* -------------------------------------------------------------------- */
-#if defined(BINARY_CURSOR_ENABLED)
     if (bUseBinaryCursor)
     {
         SoftStartTransaction();
 
-        hResult = OGRPG_PQexec(hPGConn, "DECLARE gettimebinaryformat BINARY CURSOR FOR SELECT CAST ('00:00:01' AS time)");
+        hResult = OGRPG_PQexec(this, "DECLARE gettimebinaryformat BINARY CURSOR FOR SELECT CAST ('00:00:01' AS time)");
 
         if( hResult && PQresultStatus(hResult) == PGRES_COMMAND_OK )
         {
             OGRPGClearResult( hResult );
 
-            hResult = OGRPG_PQexec(hPGConn, "FETCH ALL IN gettimebinaryformat" );
+            hResult = OGRPG_PQexec(this, "FETCH ALL IN gettimebinaryformat" );
 
             if( hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK  && PQntuples(hResult) == 1 )
             {
@@ -685,12 +682,20 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
 
         OGRPGClearResult( hResult );
 
-        hResult = OGRPG_PQexec(hPGConn, "CLOSE gettimebinaryformat");
+        hResult = OGRPG_PQexec(this, "CLOSE gettimebinaryformat");
         OGRPGClearResult( hResult );
 
         SoftCommitTransaction();
+
+        /* Timestamps are only decoded from their int8 representation, */
+        /* which is the default since PostgreSQL 8.4 */
+        if( !bBinaryTimeFormatIsInt8 )
+        {
+            CPLDebug("PG","BINARY cursor will finally NOT be used because "
+                     "time binary format is not int8");
+            bUseBinaryCursor = FALSE;
+        }
     }
-#endif
 
 #ifdef notdef
     /* This would be the quickest fix... instead, ogrpglayer has been updated to support */
@@ -699,7 +704,7 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
     {
         // Starting with PostgreSQL 9.0, the default output format for values
         // of type bytea is hex, whereas we traditionally expect escape.
-        hResult = OGRPG_PQexec(hPGConn, "SET bytea_output TO escape");
+        hResult = OGRPG_PQexec(this, "SET bytea_output TO escape");
         OGRPGClearResult( hResult );
     }
 #endif
@@ -709,7 +714,7 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
 /*      PostGIS Geometry type.  If so, disable sequential scanning      */
 /*      so we will get the value of the gist indexes.                   */
 /* -------------------------------------------------------------------- */
-    hResult = OGRPG_PQexec(hPGConn,
+    hResult = OGRPG_PQexec(this,
                         "SELECT oid, typname FROM pg_type WHERE typname IN ('geometry', 'geography')" );
 
     if( hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK
@@ -744,7 +749,7 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
 
     if( bHavePostGIS )
     {
-        hResult = OGRPG_PQexec(hPGConn, "SELECT postgis_version()" );
+        hResult = OGRPG_PQexec(this, "SELECT postgis_version()" );
         if( hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK
             && PQntuples(hResult) > 0 )
         {
@@ -759,7 +764,7 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
         if (sPostGISVersion.nMajor == 0 && sPostGISVersion.nMinor < 8)
         {
             // Turning off sequential scans for PostGIS < 0.8
-            hResult = OGRPG_PQexec(hPGConn, "SET ENABLE_SEQSCAN = OFF");
+            hResult = OGRPG_PQexec(this, "SET ENABLE_SEQSCAN = OFF");
 
             CPLDebug( "PG", "SET ENABLE_SEQSCAN=OFF" );
         }
@@ -767,13 +772,13 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
         {
             // PostGIS >=0.8 is correctly integrated with query planner,
             // thus PostgreSQL will use indexes whenever appropriate.
-            hResult = OGRPG_PQexec(hPGConn, "SET ENABLE_SEQSCAN = ON");
+            hResult = OGRPG_PQexec(this, "SET ENABLE_SEQSCAN = ON");
         }
         OGRPGClearResult( hResult );
     }
 
-    m_bHasGeometryColumns = OGRPG_Check_Table_Exists(hPGConn, "geometry_columns");
-    m_bHasSpatialRefSys = OGRPG_Check_Table_Exists(hPGConn, "spatial_ref_sys");
+    m_bHasGeometryColumns = OGRPG_Check_Table_Exists(this, "geometry_columns");
+    m_bHasSpatialRefSys = OGRPG_Check_Table_Exists(this, "spatial_ref_sys");
 
 /* -------------------------------------------------------------------- */
 /*      Find out "unknown SRID" value                                   */
@@ -781,7 +786,7 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
 
     if (sPostGISVersion.nMajor >= 2)
     {
-        hResult = OGRPG_PQexec(hPGConn,
+        hResult = OGRPG_PQexec(this,
                         "SELECT ST_Srid('POINT EMPTY'::GEOMETRY)" );
 
         if( hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK
@@ -914,7 +919,7 @@ void OGRPGDataSource::LoadTables()
               "GROUP BY c.relname, n.nspname, c.relkind, a.attname, t.typname, dim, srid, geomtyp, a.attnotnull, c.oid, a.attnum, d.description "
               "ORDER BY c.oid, a.attnum",
               pszAllowedRelations);
-        PGresult *hResult = OGRPG_PQexec(hPGConn, osCommand.c_str());
+        PGresult *hResult = OGRPG_PQexec(this, osCommand.c_str());
 
         if( !hResult || PQresultStatus(hResult) != PGRES_TUPLES_OK )
         {
@@ -1085,7 +1090,7 @@ void OGRPGDataSource::LoadTables()
                                 "WHERE (c.relkind in (%s) AND c.relname !~ '^pg_' AND c.relnamespace=n.oid)",
                                 pszAllowedRelations);
 
-        PGresult *hResult = OGRPG_PQexec(hPGConn, osCommand.c_str());
+        PGresult *hResult = OGRPG_PQexec(this, osCommand.c_str());
 
         if( !hResult || PQresultStatus(hResult) != PGRES_TUPLES_OK )
         {
@@ -1188,7 +1193,7 @@ void OGRPGDataSource::LoadTables()
         /*      Fetch inherited tables                                        */
         /* ------------------------------------------------------------------ */
             hResult = OGRPG_PQexec(
-                hPGConn,
+                this,
                 "SELECT c1.relname AS derived, c2.relname AS parent, n.nspname "
                 "FROM pg_class c1, pg_class c2, pg_namespace n, pg_inherits i "
                 "WHERE i.inhparent = c2.oid AND i.inhrelid = c1.oid AND "
@@ -1421,14 +1426,14 @@ OGRErr OGRPGDataSource::DeleteLayer( int iLayer )
             "f_table_schema='%s'",
             osTableName.c_str(), osSchemaName.c_str() );
 
-        PGresult *hResult = OGRPG_PQexec( hPGConn, osCommand.c_str() );
+        PGresult *hResult = OGRPG_PQexec(this, osCommand.c_str() );
         OGRPGClearResult( hResult );
     }
 
     osCommand.Printf("DROP TABLE %s.%s CASCADE",
                      OGRPGEscapeColumnName(osSchemaName).c_str(),
                      OGRPGEscapeColumnName(osTableName).c_str() );
-    PGresult *hResult = OGRPG_PQexec( hPGConn, osCommand.c_str() );
+    PGresult *hResult = OGRPG_PQexec(this, osCommand.c_str() );
     OGRPGClearResult( hResult );
 
     SoftCommitTransaction();
@@ -1805,7 +1810,7 @@ OGRPGDataSource::ICreateLayer( const char * pszLayerName,
                 "DELETE FROM geometry_columns WHERE f_table_name = %s AND f_table_schema = %s",
                 pszEscapedTableNameSingleQuote, pszEscapedSchemaNameSingleQuote );
 
-        hResult = OGRPG_PQexec(hPGConn, osCommand.c_str());
+        hResult = OGRPG_PQexec(this, osCommand.c_str());
         OGRPGClearResult( hResult );
     }
 
@@ -1816,7 +1821,7 @@ OGRPGDataSource::ICreateLayer( const char * pszLayerName,
         osCommand = osCreateTable;
         osCommand += " )";
 
-        hResult = OGRPG_PQexec(hPGConn, osCommand.c_str());
+        hResult = OGRPG_PQexec(this, osCommand.c_str());
         if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
@@ -1851,7 +1856,7 @@ OGRPGDataSource::ICreateLayer( const char * pszLayerName,
                     OGRPGEscapeString(hPGConn, pszGFldName).c_str(),
                     nSRSId, pszGeometryType, dim );
 
-            hResult = OGRPG_PQexec(hPGConn, osCommand.c_str());
+            hResult = OGRPG_PQexec(this, osCommand.c_str());
 
             if( !hResult
                 || PQresultStatus(hResult) != PGRES_TUPLES_OK )
@@ -1889,7 +1894,7 @@ OGRPGDataSource::ICreateLayer( const char * pszLayerName,
                             OGRPGEscapeColumnName(pszTableName).c_str(),
                             OGRPGEscapeColumnName(pszGFldName).c_str());
 
-            hResult = OGRPG_PQexec(hPGConn, osCommand.c_str());
+            hResult = OGRPG_PQexec(this, osCommand.c_str());
 
             if( !hResult
                 || PQresultStatus(hResult) != PGRES_COMMAND_OK )
@@ -2176,7 +2181,7 @@ OGRSpatialReference *OGRPGDataSource::FetchSRS( int nId )
              "SELECT srtext FROM spatial_ref_sys "
              "WHERE srid = %d",
              nId );
-    hResult = OGRPG_PQexec(hPGConn, osCommand.c_str() );
+    hResult = OGRPG_PQexec(this, osCommand.c_str() );
 
     if( hResult
         && PQresultStatus(hResult) == PGRES_TUPLES_OK
@@ -2266,7 +2271,7 @@ int OGRPGDataSource::FetchSRSId( OGRSpatialReference * poSRS )
                             "auth_name = '%s' AND auth_srid = %d",
                             pszAuthorityName,
                             nAuthorityCode );
-            PGresult *hResult = OGRPG_PQexec(hPGConn, osCommand.c_str());
+            PGresult *hResult = OGRPG_PQexec(this, osCommand.c_str());
 
             if( hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK
                 && PQntuples(hResult) > 0 )
@@ -2299,7 +2304,7 @@ int OGRPGDataSource::FetchSRSId( OGRSpatialReference * poSRS )
     osCommand.Printf(
              "SELECT srid FROM spatial_ref_sys WHERE srtext = %s",
              osWKT.c_str() );
-    PGresult *hResult = OGRPG_PQexec(hPGConn, osCommand.c_str() );
+    PGresult *hResult = OGRPG_PQexec(this, osCommand.c_str() );
     CPLFree( pszWKT );  // CM:  Added to prevent mem leaks
     pszWKT = NULL;      // CM:  Added
 
@@ -2336,7 +2341,7 @@ int OGRPGDataSource::FetchSRSId( OGRSpatialReference * poSRS )
 /* -------------------------------------------------------------------- */
 /*      Get the current maximum srid in the srs table.                  */
 /* -------------------------------------------------------------------- */
-    hResult = OGRPG_PQexec(hPGConn, "SELECT MAX(srid) FROM spatial_ref_sys" );
+    hResult = OGRPG_PQexec(this, "SELECT MAX(srid) FROM spatial_ref_sys" );
 
     int nSRSId;
     if( hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK )
@@ -2382,7 +2387,7 @@ int OGRPGDataSource::FetchSRSId( OGRSpatialReference * poSRS )
     CPLFree( pszProj4 );
     CPLFree( pszWKT);
 
-    hResult = OGRPG_PQexec(hPGConn, osCommand.c_str() );
+    hResult = OGRPG_PQexec(this, osCommand.c_str() );
     OGRPGClearResult( hResult );
 
     return nSRSId;
@@ -2649,9 +2654,8 @@ OGRErr OGRPGDataSource::DoTransactionCommand(const char* pszCommand)
 {
     OGRErr      eErr = OGRERR_NONE;
     PGresult    *hResult = NULL;
-    PGconn      *l_hPGConn = GetPGConn();
 
-    hResult = OGRPG_PQexec(l_hPGConn, pszCommand);
+    hResult = OGRPG_PQexec(this, pszCommand);
     osDebugLastTransactionCommand = pszCommand;
 
     if( !hResult || PQresultStatus(hResult) != PGRES_COMMAND_OK )
@@ -2850,7 +2854,7 @@ OGRLayer * OGRPGDataSource::ExecuteSQL( const char *pszSQLCommand,
         /* For something that is not a select or a select without table, do not */
         /* run under transaction (CREATE DATABASE, VACCUUM don't like transactions) */
 
-        hResult = OGRPG_PQexec(hPGConn, pszSQLCommand, TRUE /* multiple allowed */ );
+        hResult = OGRPG_PQexec(this, pszSQLCommand, TRUE /* multiple allowed */ );
         if (hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK)
         {
             CPLDebug( "PG", "Command Results Tuples = %d", PQntuples(hResult) );
@@ -2878,7 +2882,7 @@ OGRLayer * OGRPGDataSource::ExecuteSQL( const char *pszSQLCommand,
         osCommand.Printf( "DECLARE %s CURSOR for %s",
                             "executeSQLCursor", pszSQLCommand );
 
-        hResult = OGRPG_PQexec(hPGConn, osCommand );
+        hResult = OGRPG_PQexec(this, osCommand );
 
 /* -------------------------------------------------------------------- */
 /*      Do we have a tuple result? If so, instantiate a results         */
@@ -2891,14 +2895,14 @@ OGRLayer * OGRPGDataSource::ExecuteSQL( const char *pszSQLCommand,
             OGRPGClearResult( hResult );
 
             osCommand.Printf( "FETCH 0 in %s", "executeSQLCursor" );
-            hResult = OGRPG_PQexec(hPGConn, osCommand );
+            hResult = OGRPG_PQexec(this, osCommand );
 
             poLayer = new OGRPGResultLayer( this, pszSQLCommand, hResult );
 
             OGRPGClearResult( hResult );
 
             osCommand.Printf( "CLOSE %s", "executeSQLCursor" );
-            hResult = OGRPG_PQexec(hPGConn, osCommand );
+            hResult = OGRPG_PQexec(this, osCommand );
             OGRPGClearResult( hResult );
 
             SoftCommitTransaction();
@@ -2958,3 +2962,35 @@ OGRErr OGRPGDataSource::EndCopy( )
     else
         return OGRERR_NONE;
 }
+
+/************************************************************************/
+/*                          SetPendingQuery()                           */
+/*                                                                      */
+/*      Register the callback that collects the result of the           */
+/*      asynchronous query in flight on the connection, or unregister   */
+/*      it if pfnFunc is NULL.                                          */
+/************************************************************************/
+
+void OGRPGDataSource::SetPendingQuery( OGRPGPendingQueryFunc pfnFunc,
+                                       void* pUserData )
+{
+    pfnPendingQueryFunc = pfnFunc;
+    pPendingQueryUserData = pfnFunc ? pUserData : NULL;
+}
+
+/************************************************************************/
+/*                         FinishPendingQuery()                         */
+/************************************************************************/
+
+void OGRPGDataSource::FinishPendingQuery()
+{
+    if( pfnPendingQueryFunc == NULL )
+        return;
+
+    // Unregister first, as the callback may emit requests itself.
+    OGRPGPendingQueryFunc pfnFunc = pfnPendingQueryFunc;
+    void* pUserData = pPendingQueryUserData;
+    pfnPendingQueryFunc = NULL;
+    pPendingQueryUserData = NULL;
+    pfnFunc(pUserData);
+}
@@ -87,6 +87,9 @@ OGRPGLayer::OGRPGLayer() :
     hCursorResult(NULL),
     bInvalidated(FALSE),
     nResultOffset(0),
+    bPrefetch(CPLTestBool(CPLGetConfigOption("OGR_PG_CURSOR_PREFETCH", "NO"))),
+    bPrefetchPending(FALSE),
+    hPrefetchResult(NULL),
     bWkbAsOid(FALSE),
     pszFIDColumn(NULL),
     bCanUseBinaryCursor(TRUE),
@@ -133,7 +136,8 @@ OGRPGLayer::~OGRPGLayer()
 
 void OGRPGLayer::CloseCursor()
 {
-    PGconn      *hPGConn = poDS->GetPGConn();
+
+    DiscardPrefetch();
 
     if( hCursorResult != NULL )
     {
@@ -145,7 +149,7 @@ void OGRPGLayer::CloseCursor()
         /* In case of interleaving read in different layers we might have */
         /* close the transaction, and thus implicitly the cursor, so be */
         /* quiet about errors. This is potentially an issue by the way */
-        hCursorResult = OGRPG_PQexec(hPGConn, osCommand.c_str(), FALSE, TRUE);
+        hCursorResult = OGRPG_PQexec(poDS, osCommand.c_str(), FALSE, TRUE);
         OGRPGClearResult( hCursorResult );
 
         poDS->SoftCommitTransaction();
@@ -179,7 +183,6 @@ void OGRPGLayer::ResetReading()
     bInvalidated = FALSE;
 }
 
-#if defined(BINARY_CURSOR_ENABLED)
 /************************************************************************/
 /*                    OGRPGGetStrFromBinaryNumeric()                    */
 /************************************************************************/
@@ -316,14 +319,69 @@ OGRPGGetStrFromBinaryNumeric(NumericVar *var)
         return str;
 }
 
+/************************************************************************/
+/*                      OGRPGGetBinaryArrayData()                       */
+/************************************************************************/
+
+/* Parse the header of a one dimensional array in binary representation */
+/* (see array_send() in pgsql/src/backend/utils/adt/arrayfuncs.c) and */
+/* return a pointer to its first element, or NULL if it is not valid. */
+
+static const char* OGRPGGetBinaryArrayData( const char* pData, int nLength,
+                                            int* pnCount )
+{
+    *pnCount = 0;
+    if( nLength < 3 * 4 )
+        return NULL;
+
+    int nDims;
+    memcpy( &nDims, pData, sizeof(int) );
+    CPL_MSBPTR32( &nDims );
+    if( nDims == 0 ) // empty array
+        return pData + 3 * 4;
+    if( nDims != 1 || nLength < 5 * 4 )
+        return NULL;
+
+    int nCount;
+    memcpy( &nCount, pData + 3 * 4, sizeof(int) );
+    CPL_MSBPTR32( &nCount );
+    // Each element takes at least its 4-byte length.
+    if( nCount < 0 || nCount > (nLength - 5 * 4) / 4 )
+        return NULL;
+
+    *pnCount = nCount;
+    return pData + 5 * 4;
+}
+
+/************************************************************************/
+/*                   OGRPGGetBinaryArrayElement()                       */
+/************************************************************************/
+
+/* Return the size of the array element at *ppData (-1 for NULL) and */
+/* advance *ppData to its value. */
+
+static int OGRPGGetBinaryArrayElement( const char** ppData, const char* pEnd )
+{
+    if( pEnd - *ppData < 4 )
+        return -1;
+    int nSize;
+    memcpy( &nSize, *ppData, sizeof(int) );
+    CPL_MSBPTR32( &nSize );
+    *ppData += sizeof(int);
+    if( nSize > pEnd - *ppData )
+    {
+        *ppData = pEnd;
+        return -1;
+    }
+    return nSize;
+}
+
 /************************************************************************/
 /*                         OGRPGj2date()                            */
 /************************************************************************/
 
 /* Coming from j2date() in pgsql/src/backend/utils/adt/datetime.c */
 
-#define POSTGRES_EPOCH_JDATE 2451545 /* == date2j(2000, 1, 1) */
-
 static
 void OGRPGj2date(int jd, int *year, int *month, int *day)
 {
@@ -375,7 +433,7 @@ OGRPGdt2timeInt8(GIntBig jd, int *hour, int *min, int *sec, double *fsec)
     *min = (int) (time / USECS_PER_MIN);
     time -=  (GIntBig) (*min) * USECS_PER_MIN;
     *sec = (int)time / USECS_PER_SEC;
-    *fsec = (double)(time - *sec * USECS_PER_SEC);
+    *fsec = (double)(time - *sec * USECS_PER_SEC) / USECS_PER_SEC;
 }  /* dt2time() */
 
 static
@@ -438,7 +496,6 @@ int OGRPGTimeStamp2DMYHMS(GIntBig dt, int *year, int *month, int *day,
     return 0;
 }
 
-#endif // defined(BINARY_CURSOR_ENABLED)
 
 /************************************************************************/
 /*                   TokenizeStringListFromText()                       */
@@ -594,9 +651,7 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
     {
         int     iOGRField;
 
-#if defined(BINARY_CURSOR_ENABLED)
         int nTypeOID = PQftype(hResult, iField);
-#endif
         const char* pszFieldName = PQfname(hResult,iField);
 
 /* -------------------------------------------------------------------- */
@@ -604,7 +659,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
 /* -------------------------------------------------------------------- */
         if( pszFIDColumn != NULL && EQUAL(pszFieldName,pszFIDColumn) )
         {
-#if defined(BINARY_CURSOR_ENABLED)
             if ( PQfformat( hResult, iField ) == 1 ) // Binary data representation
             {
                 if ( nTypeOID == INT4OID)
@@ -630,7 +684,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif /* defined(BINARY_CURSOR_ENABLED) */
             {
                 char* pabyData = PQgetvalue(hResult,iRecord,iField);
                 /* ogr_pg_20 may crash if PostGIS is unavailable and we don't test pabyData */
@@ -666,7 +719,7 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                     continue;
 
                 OGRGeometry * poGeom = NULL;
-                if( !poDS->bUseBinaryCursor && nLength >= 4 &&
+                if( PQfformat( hResult, iField ) == 0 && nLength >= 4 &&
                     /* escaped byea data */
                     (STARTS_WITH(pszVal, "\\000") || STARTS_WITH(pszVal, "\\001") ||
                     /* hex bytea data (PostgreSQL >= 9.0) */
@@ -686,8 +739,7 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
 
                 continue;
             }
-            else if ( !poDS->bUseBinaryCursor &&
-                      STARTS_WITH_CI(pszFieldName, "EWKBBase64") )
+            else if ( STARTS_WITH_CI(pszFieldName, "EWKBBase64") )
             {
                 GByte* pabyData = (GByte*)PQgetvalue( hResult,
                                                         iRecord, iField);
@@ -710,7 +762,7 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
 
                 continue;
             }
-            else if ( poDS->bUseBinaryCursor ||
+            else if ( PQfformat( hResult, iField ) == 1 ||
                       EQUAL(pszFieldName,"ST_AsEWKB") ||
                       EQUAL(pszFieldName,"AsEWKB") )
             {
@@ -726,7 +778,7 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
 
                 OGRGeometry * poGeom = NULL;
 
-                if( !poDS->bUseBinaryCursor &&
+                if( PQfformat( hResult, iField ) == 0 &&
                     (STARTS_WITH(pabyData, "\\x00") || STARTS_WITH(pabyData, "\\x01") ||
                      STARTS_WITH(pabyData, "\\000") || STARTS_WITH(pabyData, "\\001")) )
                 {
@@ -808,16 +860,12 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
             }
             else
             {
-#if defined(BINARY_CURSOR_ENABLED)
-                if (poDS->bUseBinaryCursor
-                    && PQfformat( hResult, iField ) == 1
-                   )
+                if ( PQfformat( hResult, iField ) == 1 )
                 {
                     int nLength = PQgetlength(hResult, iRecord, iField);
                     poGeometry = OGRGeometryFromEWKB(pabyData, nLength, NULL,
                                                      poDS->sPostGISVersion.nMajor < 2 );
                 }
-#endif
                 if (poGeometry == NULL)
                 {
                     poGeometry = BYTEAToGeometry( (const char*)pabyData,
@@ -855,46 +903,37 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
         {
             int *panList, nCount, i;
 
-#if defined(BINARY_CURSOR_ENABLED)
             if ( PQfformat( hResult, iField ) == 1 ) // Binary data representation
             {
                 if (nTypeOID == INT2ARRAYOID || nTypeOID == INT4ARRAYOID)
                 {
-                    char * pData = PQgetvalue( hResult, iRecord, iField );
-
-                    // goto number of array elements
-                    pData += 3 * sizeof(int);
-                    memcpy( &nCount, pData, sizeof(int) );
-                    CPL_MSBPTR32( &nCount );
-
-                    panList = (int *) CPLCalloc(sizeof(int),nCount);
+                    const int nLength = PQgetlength(hResult, iRecord, iField);
+                    const char * pEnd =
+                        PQgetvalue( hResult, iRecord, iField ) + nLength;
+                    const char * pData = OGRPGGetBinaryArrayData(
+                        PQgetvalue( hResult, iRecord, iField ), nLength, &nCount );
 
-                    // goto first array element
-                    pData += 2 * sizeof(int);
+                    panList = (int *) CPLCalloc(sizeof(int),MAX(1,nCount));
 
                     for( i = 0; i < nCount; i++ )
                     {
-                        // get element size
-                        int nSize = *(int *)(pData);
-                        CPL_MSBPTR32( &nSize );
-                        pData += sizeof(int);
+                        const int nSize = OGRPGGetBinaryArrayElement(&pData, pEnd);
 
-                        if (nTypeOID == INT4ARRAYOID  )
+                        if (nTypeOID == INT4ARRAYOID && nSize == sizeof(int) )
                         {
-                            CPLAssert( nSize == sizeof(int) );
                             memcpy( &panList[i], pData, nSize );
                             CPL_MSBPTR32(&panList[i]);
                         }
-                        else
+                        else if( nTypeOID == INT2ARRAYOID && nSize == sizeof(GInt16) )
                         {
-                            CPLAssert( nSize == sizeof(GInt16) );
                             GInt16 nVal;
                             memcpy( &nVal, pData, nSize );
                             CPL_MSBPTR16(&nVal);
                             panList[i] = nVal;
                         }
 
-                        pData += nSize;
+                        if( nSize > 0 )
+                            pData += nSize;
                     }
                 }
                 else
@@ -904,7 +943,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif
             {
                 char **papszTokens = CSLTokenizeStringComplex(
                     PQgetvalue( hResult, iRecord, iField ),
@@ -934,37 +972,30 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
             int nCount = 0;
             GIntBig *panList = NULL;
 
-#if defined(BINARY_CURSOR_ENABLED)
             if ( PQfformat( hResult, iField ) == 1 ) // Binary data representation
             {
                 if (nTypeOID == INT8ARRAYOID)
                 {
-                    char * pData = PQgetvalue( hResult, iRecord, iField );
+                    const int nLength = PQgetlength(hResult, iRecord, iField);
+                    const char * pEnd =
+                        PQgetvalue( hResult, iRecord, iField ) + nLength;
+                    const char * pData = OGRPGGetBinaryArrayData(
+                        PQgetvalue( hResult, iRecord, iField ), nLength, &nCount );
 
-                    // goto number of array elements
-                    pData += 3 * sizeof(int);
-                    memcpy( &nCount, pData, sizeof(int) );
-                    CPL_MSBPTR32( &nCount );
-
-                    panList = (GIntBig *) CPLCalloc(sizeof(GIntBig),nCount);
-
-                    // goto first array element
-                    pData += 2 * sizeof(int);
+                    panList = (GIntBig *) CPLCalloc(sizeof(GIntBig),MAX(1,nCount));
 
                     for( int i = 0; i < nCount; i++ )
                     {
-                        // get element size
-                        int nSize = *(int *)(pData);
-                        CPL_MSBPTR32( &nSize );
-
-                        CPLAssert( nSize == sizeof(GIntBig) );
+                        const int nSize = OGRPGGetBinaryArrayElement(&pData, pEnd);
 
-                        pData += sizeof(int);
-
-                        memcpy( &panList[i], pData, nSize );
-                        CPL_MSBPTR64(&panList[i]);
+                        if( nSize == sizeof(GIntBig) )
+                        {
+                            memcpy( &panList[i], pData, nSize );
+                            CPL_MSBPTR64(&panList[i]);
+                        }
 
-                        pData += nSize;
+                        if( nSize > 0 )
+                            pData += nSize;
                     }
                 }
                 else
@@ -974,7 +1005,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif
             {
                 char **papszTokens = CSLTokenizeStringComplex(
                     PQgetvalue( hResult, iRecord, iField ),
@@ -1004,50 +1034,38 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
             int nCount, i;
             double *padfList = NULL;
 
-#if defined(BINARY_CURSOR_ENABLED)
             if ( PQfformat( hResult, iField ) == 1 ) // Binary data representation
             {
                 if (nTypeOID == FLOAT8ARRAYOID || nTypeOID == FLOAT4ARRAYOID)
                 {
-                    char * pData = PQgetvalue( hResult, iRecord, iField );
-
-                    // goto number of array elements
-                    pData += 3 * sizeof(int);
-                    memcpy( &nCount, pData, sizeof(int) );
-                    CPL_MSBPTR32( &nCount );
+                    const int nLength = PQgetlength(hResult, iRecord, iField);
+                    const char * pEnd =
+                        PQgetvalue( hResult, iRecord, iField ) + nLength;
+                    const char * pData = OGRPGGetBinaryArrayData(
+                        PQgetvalue( hResult, iRecord, iField ), nLength, &nCount );
 
-                    padfList = (double *) CPLCalloc(sizeof(double),nCount);
-
-                    // goto first array element
-                    pData += 2 * sizeof(int);
+                    padfList = (double *) CPLCalloc(sizeof(double),MAX(1,nCount));
 
                     for( i = 0; i < nCount; i++ )
                     {
-                        // get element size
-                        int nSize = *(int *)(pData);
-                        CPL_MSBPTR32( &nSize );
-
-                        pData += sizeof(int);
+                        const int nSize = OGRPGGetBinaryArrayElement(&pData, pEnd);
 
-                        if (nTypeOID == FLOAT8ARRAYOID)
+                        if (nTypeOID == FLOAT8ARRAYOID && nSize == sizeof(double))
                         {
-                            CPLAssert( nSize == sizeof(double) );
-
                             memcpy( &padfList[i], pData, nSize );
                             CPL_MSBPTR64(&padfList[i]);
                         }
-                        else
+                        else if( nTypeOID == FLOAT4ARRAYOID && nSize == sizeof(float) )
                         {
                             float fVal;
-                            CPLAssert( nSize == sizeof(float) );
-
                             memcpy( &fVal, pData, nSize );
                             CPL_MSBPTR32(&fVal);
 
                             padfList[i] = fVal;
                         }
 
-                        pData += nSize;
+                        if( nSize > 0 )
+                            pData += nSize;
                     }
                 }
                 else
@@ -1057,7 +1075,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif
             {
                 char **papszTokens = CSLTokenizeStringComplex(
                     PQgetvalue( hResult, iRecord, iField ),
@@ -1079,49 +1096,34 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
         {
             char **papszTokens = NULL;
 
-#if defined(BINARY_CURSOR_ENABLED)
             if ( PQfformat( hResult, iField ) == 1 ) // Binary data representation
             {
-                char * pData = PQgetvalue( hResult, iRecord, iField );
-                int nCount, i;
-
-                // goto number of array elements
-                pData += 3 * sizeof(int);
-                memcpy( &nCount, pData, sizeof(int) );
-                CPL_MSBPTR32( &nCount );
-
-                // goto first array element
-                pData += 2 * sizeof(int);
-
-                for( i = 0; i < nCount; i++ )
+                const int nLength = PQgetlength(hResult, iRecord, iField);
+                const char * pEnd =
+                    PQgetvalue( hResult, iRecord, iField ) + nLength;
+                int nCount = 0;
+                const char * pData = OGRPGGetBinaryArrayData(
+                    PQgetvalue( hResult, iRecord, iField ), nLength, &nCount );
+
+                for( int i = 0; i < nCount; i++ )
                 {
-                    // get element size
-                    int nSize = *(int *)(pData);
-                    CPL_MSBPTR32( &nSize );
-
-                    pData += sizeof(int);
+                    const int nSize = OGRPGGetBinaryArrayElement(&pData, pEnd);
 
                     if (nSize <= 0)
                         papszTokens = CSLAddString(papszTokens, "");
                     else
                     {
-                        if (pData[nSize] == '\0')
-                            papszTokens = CSLAddString(papszTokens, pData);
-                        else
-                        {
-                            char* pszToken = (char*) CPLMalloc(nSize + 1);
-                            memcpy(pszToken, pData, nSize);
-                            pszToken[nSize] = '\0';
-                            papszTokens = CSLAddString(papszTokens, pszToken);
-                            CPLFree(pszToken);
-                        }
+                        char* pszToken = (char*) CPLMalloc(nSize + 1);
+                        memcpy(pszToken, pData, nSize);
+                        pszToken[nSize] = '\0';
+                        papszTokens = CSLAddString(papszTokens, pszToken);
+                        CPLFree(pszToken);
 
                         pData += nSize;
                     }
                 }
             }
             else
-#endif
             {
                 papszTokens =
                         OGRPGTokenizeStringListFromText(PQgetvalue(hResult, iRecord, iField ));
@@ -1138,7 +1140,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                  || eOGRType == OFTTime
                  || eOGRType == OFTDateTime )
         {
-#if defined(BINARY_CURSOR_ENABLED)
             if ( PQfformat( hResult, iField ) == 1 ) // Binary data
             {
                 if ( nTypeOID == DATEOID )
@@ -1188,7 +1189,8 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                     CPL_MSBPTR32(&nVal[1]);
                     llVal = (GIntBig) ((((GUIntBig)nVal[0]) << 32) | nVal[1]);
                     if (OGRPGTimeStamp2DMYHMS(llVal, &nYear, &nMonth, &nDay, &nHour, &nMinute, &dfSecond) == 0)
-                        poFeature->SetField( iOGRField, nYear, nMonth, nDay, nHour, nMinute, (float)dfSecond, 100);
+                        poFeature->SetField( iOGRField, nYear, nMonth, nDay, nHour, nMinute, (float)dfSecond,
+                                             nTypeOID == TIMESTAMPTZOID ? 100 : 0);
                 }
                 else if ( nTypeOID == TEXTOID )
                 {
@@ -1206,7 +1208,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif
             {
                 OGRField  sFieldValue;
 
@@ -1219,7 +1220,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
         }
         else if( eOGRType == OFTBinary )
         {
-#if defined(BINARY_CURSOR_ENABLED)
             if ( PQfformat( hResult, iField ) == 1)
             {
                 int nLength = PQgetlength(hResult, iRecord, iField);
@@ -1227,7 +1227,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 poFeature->SetField( iOGRField, nLength, pabyData );
             }
             else
-#endif  /* defined(BINARY_CURSOR_ENABLED) */
             {
                 int nLength = PQgetlength(hResult, iRecord, iField);
                 const char* pszBytea = (const char*) PQgetvalue( hResult, iRecord, iField );
@@ -1238,7 +1237,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
         }
         else
         {
-#if defined(BINARY_CURSOR_ENABLED)
             if ( PQfformat( hResult, iField ) == 1 &&
                  eOGRType != OFTString ) // Binary data
             {
@@ -1331,7 +1329,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif /* defined(BINARY_CURSOR_ENABLED) */
             {
                 if ( eOGRType == OFTInteger &&
                      poFeatureDefn->GetFieldDefn(iOGRField)->GetWidth() == 1)
@@ -1444,16 +1441,16 @@ void OGRPGLayer::SetInitialQueryCursor()
 
     poDS->SoftStartTransaction();
 
-#if defined(BINARY_CURSOR_ENABLED)
-    if ( poDS->bUseBinaryCursor && bCanUseBinaryCursor )
+    const bool bBinaryCursor =
+        CPL_TO_BOOL(poDS->bUseBinaryCursor && bCanUseBinaryCursor);
+    if ( bBinaryCursor )
         osCommand.Printf( "DECLARE %s BINARY CURSOR for %s",
                             pszCursorName, pszQueryStatement );
     else
-#endif
         osCommand.Printf( "DECLARE %s CURSOR for %s",
                             pszCursorName, pszQueryStatement );
 
-    hCursorResult = OGRPG_PQexec(hPGConn, osCommand );
+    hCursorResult = OGRPG_PQexec(poDS, osCommand );
     if ( !hCursorResult || PQresultStatus(hCursorResult) != PGRES_COMMAND_OK )
     {
         CPLError( CE_Failure, CPLE_AppDefined,
@@ -1463,7 +1460,7 @@ void OGRPGLayer::SetInitialQueryCursor()
     OGRPGClearResult( hCursorResult );
 
     osCommand.Printf( "FETCH %d in %s", nCursorPage, pszCursorName );
-    hCursorResult = OGRPG_PQexec(hPGConn, osCommand );
+    hCursorResult = OGRPG_PQexec(poDS, osCommand );
 
     CreateMapFromFieldNameToIndex(hCursorResult,
                                   poFeatureDefn,
@@ -1471,6 +1468,212 @@ void OGRPGLayer::SetInitialQueryCursor()
                                   m_panMapFieldNameToGeomIndex);
 
     nResultOffset = 0;
+
+/* -------------------------------------------------------------------- */
+/*      Fallback to a text cursor if some columns have a binary         */
+/*      representation that RecordToFeature() cannot decode.            */
+/* -------------------------------------------------------------------- */
+    if( bBinaryCursor && !CanDecodeBinaryResult(hCursorResult) )
+    {
+        CPLDebug("PG", "Layer %s: BINARY cursor will finally NOT be used "
+                 "because of unhandled column types", GetName());
+        bCanUseBinaryCursor = FALSE;
+        CloseCursor();
+        SetInitialQueryCursor();
+        return;
+    }
+
+    StartPrefetch();
+}
+
+/************************************************************************/
+/*                       CanDecodeBinaryResult()                        */
+/*                                                                      */
+/*      Check that RecordToFeature() knows how to decode the binary     */
+/*      representation of all the columns of a result.                 */
+/************************************************************************/
+
+int OGRPGLayer::CanDecodeBinaryResult( PGresult* hResult )
+{
+    if( hResult == NULL || PQresultStatus(hResult) != PGRES_TUPLES_OK )
+        return TRUE;
+
+    for( int iField = 0; iField < PQnfields(hResult); iField++ )
+    {
+        if( PQfformat( hResult, iField ) != 1 )
+            continue;
+
+        const Oid nTypeOID = PQftype(hResult, iField);
+        if( pszFIDColumn != NULL &&
+            EQUAL(PQfname(hResult, iField), pszFIDColumn) )
+        {
+            if( nTypeOID != INT4OID && nTypeOID != INT8OID )
+                return FALSE;
+            continue;
+        }
+
+        const int iOGRGeomField = m_panMapFieldNameToGeomIndex[iField];
+        if( iOGRGeomField >= 0 )
+        {
+            // EWKB for PostGIS types, WKB for bytea.
+            if( nTypeOID != poDS->GetGeometryOID() &&
+                nTypeOID != poDS->GetGeographyOID() &&
+                nTypeOID != BYTEAOID )
+                return FALSE;
+            continue;
+        }
+
+        const int iOGRField = m_panMapFieldNameToIndex[iField];
+        if( iOGRField < 0 )
+            continue;
+
+        const OGRFieldType eType =
+            poFeatureDefn->GetFieldDefn(iOGRField)->GetType();
+        bool bOK = false;
+        switch( nTypeOID )
+        {
+            case CHAROID:
+            case NAMEOID:
+            case BPCHAROID:
+            case VARCHAROID:
+                bOK = eType == OFTString;
+                break;
+
+            case TEXTOID:
+                bOK = eType == OFTString || eType == OFTDate ||
+                      eType == OFTTime || eType == OFTDateTime;
+                break;
+
+            case TEXTARRAYOID:
+            case BPCHARARRAYOID:
+            case VARCHARARRAYOID:
+                bOK = eType == OFTStringList;
+                break;
+
+            case BYTEAOID:
+                bOK = eType == OFTBinary;
+                break;
+
+            case BOOLOID:
+            case INT2OID:
+            case INT4OID:
+            case INT8OID:
+            case FLOAT4OID:
+            case FLOAT8OID:
+            case NUMERICOID:
+                bOK = eType == OFTInteger || eType == OFTInteger64 ||
+                      eType == OFTReal;
+                break;
+
+            case INT2ARRAYOID:
+            case INT4ARRAYOID:
+                bOK = eType == OFTIntegerList;
+                break;
+
+            case INT8ARRAYOID:
+                bOK = eType == OFTInteger64List;
+                break;
+
+            case FLOAT4ARRAYOID:
+            case FLOAT8ARRAYOID:
+                bOK = eType == OFTRealList;
+                break;
+
+            case DATEOID:
+            case TIMEOID:
+            case TIMESTAMPOID:
+                bOK = eType == OFTDate || eType == OFTTime ||
+                      eType == OFTDateTime;
+                break;
+
+            default:
+                break;
+        }
+        if( !bOK )
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                           StartPrefetch()                            */
+/*                                                                      */
+/*      Asynchronously issue the FETCH of the next page of the          */
+/*      cursor, so that the server can produce it while the current     */
+/*      one is consumed.                                                */
+/************************************************************************/
+
+void OGRPGLayer::StartPrefetch()
+{
+    if( !bPrefetch || bPrefetchPending || hPrefetchResult != NULL ||
+        hCursorResult == NULL ||
+        PQresultStatus(hCursorResult) != PGRES_TUPLES_OK ||
+        PQntuples(hCursorResult) != nCursorPage )
+        return;
+
+    PGconn      *hPGConn = poDS->GetPGConn();
+    CPLString   osCommand;
+
+    /* Only one request can be in flight on a connection */
+    poDS->FinishPendingQuery();
+
+    osCommand.Printf( "FETCH %d in %s", nCursorPage, pszCursorName );
+    if( !PQsendQueryParams(hPGConn, osCommand, 0, NULL, NULL, NULL, NULL, 0) )
+    {
+        CPLDebug("PG", "PQsendQueryParams(%s) failed: %s",
+                 osCommand.c_str(), PQerrorMessage(hPGConn));
+        return;
+    }
+#ifdef DEBUG
+    CPLDebug("PG", "PQsendQueryParams(%s)", osCommand.c_str());
+#endif
+
+    bPrefetchPending = TRUE;
+    poDS->SetPendingQuery(CollectPrefetchFunc, this);
+}
+
+/************************************************************************/
+/*                          CollectPrefetch()                           */
+/************************************************************************/
+
+void OGRPGLayer::CollectPrefetchFunc( void* pUserData )
+{
+    static_cast<OGRPGLayer*>(pUserData)->CollectPrefetch();
+}
+
+void OGRPGLayer::CollectPrefetch()
+{
+    if( !bPrefetchPending )
+        return;
+    bPrefetchPending = FALSE;
+
+    PGconn      *hPGConn = poDS->GetPGConn();
+    PGresult    *hResult = NULL;
+    while( (hResult = PQgetResult(hPGConn)) != NULL )
+    {
+        if( hPrefetchResult == NULL )
+            hPrefetchResult = hResult;
+        else
+            PQclear(hResult);
+    }
+
+    if( hPrefetchResult == NULL ||
+        PQresultStatus(hPrefetchResult) != PGRES_TUPLES_OK )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "%s", PQerrorMessage( hPGConn ) );
+    }
+}
+
+/************************************************************************/
+/*                          DiscardPrefetch()                           */
+/************************************************************************/
+
+void OGRPGLayer::DiscardPrefetch()
+{
+    if( bPrefetchPending )
+        poDS->FinishPendingQuery();
+    OGRPGClearResult( hPrefetchResult );
 }
 
 /************************************************************************/
@@ -1524,10 +1727,27 @@ OGRFeature *OGRPGLayer::GetNextRawFeature()
     {
         OGRPGClearResult( hCursorResult );
 
-        osCommand.Printf( "FETCH %d in %s", nCursorPage, pszCursorName );
-        hCursorResult = OGRPG_PQexec(hPGConn, osCommand );
+        if( bPrefetchPending )
+            poDS->FinishPendingQuery();
+        if( hPrefetchResult != NULL )
+        {
+            hCursorResult = hPrefetchResult;
+            hPrefetchResult = NULL;
+        }
+        else
+        {
+            osCommand.Printf( "FETCH %d in %s", nCursorPage, pszCursorName );
+            hCursorResult = OGRPG_PQexec(poDS, osCommand );
+        }
 
         nResultOffset = 0;
+
+        StartPrefetch();
+    }
+    else if( bPrefetchPending && (nResultOffset % 64) == 0 )
+    {
+        /* Let libpq read the prefetched rows that have already arrived */
+        PQconsumeInput(hPGConn);
     }
 
 /* -------------------------------------------------------------------- */
@@ -1586,7 +1806,6 @@ OGRErr OGRPGLayer::SetNextByIndex( GIntBig nIndex )
         return OGRERR_NONE;
     }
 
-    PGconn      *hPGConn = poDS->GetPGConn();
     CPLString   osCommand;
 
     if (hCursorResult == NULL )
@@ -1595,9 +1814,10 @@ OGRErr OGRPGLayer::SetNextByIndex( GIntBig nIndex )
     }
 
     OGRPGClearResult( hCursorResult );
+    DiscardPrefetch();
 
     osCommand.Printf( "FETCH ABSOLUTE " CPL_FRMT_GIB " in %s", nIndex+1, pszCursorName );
-    hCursorResult = OGRPG_PQexec(hPGConn, osCommand );
+    hCursorResult = OGRPG_PQexec(poDS, osCommand );
 
     if (PQresultStatus(hCursorResult) != PGRES_TUPLES_OK ||
         PQntuples(hCursorResult) != 1)
@@ -1766,6 +1986,7 @@ OGRGeometry *OGRPGLayer::OIDToGeometry( Oid oid )
         return NULL;
 
     PGconn *hPGConn = poDS->GetPGConn();
+    poDS->FinishPendingQuery();
     const int fd = lo_open( hPGConn, oid, INV_READ );
     if( fd < 0 )
         return NULL;
@@ -1795,6 +2016,7 @@ Oid OGRPGLayer::GeometryToOID( OGRGeometry * poGeometry )
 
 {
     PGconn *hPGConn = poDS->GetPGConn();
+    poDS->FinishPendingQuery();
     const int nWkbSize = poGeometry->WkbSize();
 
     GByte *pabyWKB = (GByte *) CPLMalloc(nWkbSize);
@@ -1933,10 +2155,9 @@ OGRErr OGRPGLayer::RunGetExtentRequest( OGREnvelope *psExtent,
     if ( psExtent == NULL )
         return OGRERR_FAILURE;
 
-    PGconn      *hPGConn = poDS->GetPGConn();
     PGresult    *hResult = NULL;
 
-    hResult = OGRPG_PQexec( hPGConn, osCommand, FALSE, bErrorAsDebug );
+    hResult = OGRPG_PQexec(poDS, osCommand, FALSE, bErrorAsDebug );
     if( ! hResult || PQresultStatus(hResult) != PGRES_TUPLES_OK || PQgetisnull(hResult,0,0) )
     {
         OGRPGClearResult( hResult );
@@ -2198,12 +2419,10 @@ int OGRPGLayer::ReadResultDefinition(PGresult *hInitialResultIn)
         else if ( nTypeOID == TIMESTAMPOID ||
                   nTypeOID == TIMESTAMPTZOID )
         {
-#if defined(BINARY_CURSOR_ENABLED)
             /* We can't deserialize properly timestamp with time zone */
             /* with binary cursors */
             if (nTypeOID == TIMESTAMPTZOID)
                 bCanUseBinaryCursor = FALSE;
-#endif
 
             oField.SetType( OFTDateTime );
         }
@@ -89,7 +89,7 @@ OGRPGResultLayer::OGRPGResultLayer( OGRPGDataSource *poDSIn,
     if( !osRequest.empty() )
     {
         osRequest = "SELECT attnum, attrelid FROM pg_attribute WHERE attnotnull = 't' AND (" + osRequest + ")";
-        PGresult* hResult = OGRPG_PQexec(poDS->GetPGConn(), osRequest );
+        PGresult* hResult = OGRPG_PQexec(poDS, osRequest );
         if( hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK)
         {
             int iCol;
@@ -122,7 +122,7 @@ OGRPGResultLayer::OGRPGResultLayer( OGRPGDataSource *poDSIn,
             CPLString osGetTableName;
             osGetTableName.Printf("SELECT c.relname, n.nspname FROM pg_class c "
                                   "JOIN pg_namespace n ON c.relnamespace=n.oid WHERE c.oid = %d ", tableOID);
-            PGresult* hTableNameResult = OGRPG_PQexec(poDS->GetPGConn(), osGetTableName );
+            PGresult* hTableNameResult = OGRPG_PQexec(poDS, osGetTableName );
             if( hTableNameResult && PQresultStatus(hTableNameResult) == PGRES_TUPLES_OK)
             {
                 if ( PQntuples(hTableNameResult) > 0 )
@@ -191,7 +191,6 @@ GIntBig OGRPGResultLayer::GetFeatureCount( int bForce )
     if( TestCapability(OLCFastFeatureCount) == FALSE )
         return OGRPGLayer::GetFeatureCount( bForce );
 
-    PGconn              *hPGConn = poDS->GetPGConn();
     PGresult            *hResult = NULL;
     CPLString           osCommand;
     int                 nCount = 0;
@@ -200,7 +199,7 @@ GIntBig OGRPGResultLayer::GetFeatureCount( int bForce )
         "SELECT count(*) FROM (%s) AS ogrpgcount",
         pszQueryStatement );
 
-    hResult = OGRPG_PQexec(hPGConn, osCommand);
+    hResult = OGRPG_PQexec(poDS, osCommand);
     if( hResult != NULL && PQresultStatus(hResult) == PGRES_TUPLES_OK )
         nCount = atoi(PQgetvalue(hResult,0,0));
     else
@@ -400,7 +399,7 @@ void OGRPGResultLayer::ResolveSRID(OGRPGGeomFieldDefn* poGFldDefn)
             osGetSRID += pszRawStatement;
             osGetSRID += ") AS ogrpggetsrid LIMIT 1";
 
-            PGresult* hSRSIdResult = OGRPG_PQexec(poDS->GetPGConn(), osGetSRID );
+            PGresult* hSRSIdResult = OGRPG_PQexec(poDS, osGetSRID );
 
             nSRSId = poDS->GetUndefinedSRID();
 
@@ -40,6 +40,9 @@ CPL_CVSID("$Id$");
 
 #define USE_COPY_UNSET  -10
 
+/* Size of the COPY data sent at once */
+#define PG_COPY_BATCH_SIZE  (1024 * 1024)
+
 #define UNSUPPORTED_OP_READ_ONLY "%s : unsupported operation on a read-only datasource."
 
 /************************************************************************/
@@ -142,6 +145,9 @@ OGRPGTableLayer::OGRPGTableLayer( OGRPGDataSource *poDSIn,
     bCopyActive(FALSE),
     bFIDColumnInCopyFields(FALSE),
     bFirstInsertion(TRUE),
+    bCopyBinary(FALSE),
+    hCopyThread(NULL),
+    nCopyThreadResult(1),
     bHasWarnedIncompatibleGeom(FALSE),
     // Just in provision for people yelling about broken backward compatibility.
     bRetrieveFID(CPLTestBool(
@@ -204,7 +210,7 @@ OGRPGTableLayer::~OGRPGTableLayer()
 
 {
     if( bDeferredCreation ) RunDeferredCreationIfNecessary();
-    if( bCopyActive ) EndCopy();
+    if( bCopyActive || hCopyThread != NULL ) EndCopy();
     CPLFree( pszSqlTableName );
     CPLFree( pszTableName );
     CPLFree( pszSqlGeomParentTableName );
@@ -246,7 +252,7 @@ char ** OGRPGTableLayer::GetMetadata(const char* pszDomain)
             "WHERE c.relname = %s AND n.nspname = %s AND c.relkind in ('r', 'v') ",
             OGRPGEscapeString(hPGConn, pszTableName).c_str(),
             OGRPGEscapeString(hPGConn, pszSchemaName).c_str());
-        PGresult* hResult = OGRPG_PQexec(hPGConn, osCommand.c_str() );
+        PGresult* hResult = OGRPG_PQexec(poDS, osCommand.c_str() );
 
         const char* pszDesc = NULL;
         if ( hResult && PGRES_TUPLES_OK == PQresultStatus(hResult) &&
@@ -296,7 +302,7 @@ CPLErr OGRPGTableLayer::SetMetadata(char** papszMD, const char* pszDomain)
                            pszSqlTableName,
                            l_pszDescription && l_pszDescription[0] != '\0' ?
                               OGRPGEscapeString(hPGConn, l_pszDescription).c_str() : "NULL" );
-        PGresult* hResult = OGRPG_PQexec(hPGConn, osCommand.c_str() );
+        PGresult* hResult = OGRPG_PQexec(poDS, osCommand.c_str() );
         OGRPGClearResult( hResult );
 
         CPLFree(pszDescription);
@@ -425,7 +431,7 @@ int OGRPGTableLayer::ReadTableDefinition()
               pszTypnameEqualsAnyClause, pszEscapedTableNameSingleQuote,
               pszAttnumEqualAnyIndkey, osSchemaClause.c_str() );
 
-    PGresult *hResult = OGRPG_PQexec(hPGConn, osCommand.c_str() );
+    PGresult *hResult = OGRPG_PQexec(poDS, osCommand.c_str() );
 
     if ( hResult && PGRES_TUPLES_OK == PQresultStatus(hResult) )
     {
@@ -474,7 +480,7 @@ int OGRPGTableLayer::ReadTableDefinition()
                 "ORDER BY a.attnum",
                 pszEscapedTableNameSingleQuote, osSchemaClause.c_str());
 
-    hResult = OGRPG_PQexec(hPGConn, osCommand.c_str() );
+    hResult = OGRPG_PQexec(poDS, osCommand.c_str() );
 
     if( !hResult || PQresultStatus(hResult) != PGRES_TUPLES_OK )
     {
@@ -584,7 +590,7 @@ int OGRPGTableLayer::ReadTableDefinition()
                  "ORDER BY a.attnum",
                  pszEscapedTableNameSingleQuote, osSchemaClause.c_str());
 
-        hResult = OGRPG_PQexec(hPGConn, osCommand.c_str() );
+        hResult = OGRPG_PQexec(poDS, osCommand.c_str() );
         if( !hResult || PQresultStatus(hResult) != PGRES_TUPLES_OK )
         {
             OGRPGClearResult( hResult );
@@ -651,7 +657,7 @@ int OGRPGTableLayer::ReadTableDefinition()
         osCommand += CPLString().Printf(" AND f_table_schema = %s",
                                             OGRPGEscapeString(hPGConn,pszSchemaName).c_str());
 
-        hResult = OGRPG_PQexec(hPGConn,osCommand);
+        hResult = OGRPG_PQexec(poDS,osCommand);
 
         if ( hResult && PQntuples(hResult) == 1 && !PQgetisnull(hResult,0,0) )
         {
@@ -697,7 +703,7 @@ int OGRPGTableLayer::ReadTableDefinition()
                             OGRPGEscapeString(hPGConn, pszSchemaName).c_str() );
 
             OGRPGClearResult( hResult );
-            hResult = OGRPG_PQexec(hPGConn, osCommand.c_str() );
+            hResult = OGRPG_PQexec(poDS, osCommand.c_str() );
 
             if ( hResult && PQntuples( hResult ) == 1 && !PQgetisnull( hResult,0,0 ) )
             {
@@ -1020,7 +1026,6 @@ CPLString OGRPGTableLayer::BuildFields()
         }
         else if ( poGeomFieldDefn->ePostgisType == GEOM_TYPE_GEOGRAPHY )
         {
-#if defined(BINARY_CURSOR_ENABLED)
             if ( poDS->bUseBinaryCursor )
             {
                 osFieldList += "ST_AsBinary(";
@@ -1030,7 +1035,6 @@ CPLString OGRPGTableLayer::BuildFields()
                     CPLSPrintf("AsBinary_%s", poGeomFieldDefn->GetNameRef()));
             }
             else
-#endif
             if (CPLTestBool(CPLGetConfigOption("PG_USE_BASE64", "NO")))
             {
                 osFieldList += "encode(ST_AsEWKB(";
@@ -1065,7 +1069,6 @@ CPLString OGRPGTableLayer::BuildFields()
         if( !osFieldList.empty() )
             osFieldList += ", ";
 
-#if defined(BINARY_CURSOR_ENABLED)
         /* With a binary cursor, it is not possible to get the time zone */
         /* of a timestamptz column. So we fallback to asking it in text mode */
         if ( poDS->bUseBinaryCursor &&
@@ -1076,7 +1079,6 @@ CPLString OGRPGTableLayer::BuildFields()
             osFieldList += " AS text)";
         }
         else
-#endif
         {
             osFieldList += OGRPGEscapeColumnName(pszName);
         }
@@ -1157,7 +1159,7 @@ OGRErr OGRPGTableLayer::DeleteFeature( GIntBig nFID )
 /* -------------------------------------------------------------------- */
     OGRErr eErr;
 
-    hResult = OGRPG_PQexec(hPGConn, osCommand);
+    hResult = OGRPG_PQexec(poDS, osCommand);
 
     if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
     {
@@ -1395,7 +1397,7 @@ OGRErr OGRPGTableLayer::ISetFeature( OGRFeature *poFeature )
 /* -------------------------------------------------------------------- */
 /*      Execute the update.                                             */
 /* -------------------------------------------------------------------- */
-    hResult = OGRPG_PQexec(hPGConn, osCommand);
+    hResult = OGRPG_PQexec(poDS, osCommand);
     if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
     {
         CPLError( CE_Failure, CPLE_AppDefined,
@@ -1479,7 +1481,7 @@ OGRErr OGRPGTableLayer::ICreateFeature( OGRFeature *poFeature )
                         pszSqlTableName,
                         OGRPGEscapeColumnName(pszFIDColumn).c_str() );
         PGconn              *hPGConn = poDS->GetPGConn();
-        PGresult* hResult = OGRPG_PQexec(hPGConn, osCommand);
+        PGresult* hResult = OGRPG_PQexec(poDS, osCommand);
         if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
@@ -1501,11 +1503,10 @@ OGRErr OGRPGTableLayer::ICreateFeature( OGRFeature *poFeature )
         bFirstInsertion = FALSE;
         if( CPLTestBool(CPLGetConfigOption("OGR_TRUNCATE", "NO")) )
         {
-            PGconn *hPGConn = poDS->GetPGConn();
             CPLString osCommand;
 
             osCommand.Printf("TRUNCATE TABLE %s", pszSqlTableName );
-            PGresult *hResult = OGRPG_PQexec( hPGConn, osCommand.c_str() );
+            PGresult *hResult = OGRPG_PQexec(poDS, osCommand.c_str() );
             OGRPGClearResult( hResult );
         }
     }
@@ -1866,7 +1867,7 @@ OGRErr OGRPGTableLayer::CreateFeatureViaInsert( OGRFeature *poFeature )
 /* -------------------------------------------------------------------- */
 /*      Execute the insert.                                             */
 /* -------------------------------------------------------------------- */
-    PGresult *hResult = OGRPG_PQexec(hPGConn, osCommand);
+    PGresult *hResult = OGRPG_PQexec(poDS, osCommand);
     if (bReturnRequested && PQresultStatus(hResult) == PGRES_TUPLES_OK &&
         PQntuples(hResult) == 1 && PQnfields(hResult) == 1 )
     {
@@ -1913,6 +1914,14 @@ OGRErr OGRPGTableLayer::CreateFeatureViaCopy( OGRFeature *poFeature )
     /* Tell the datasource we are now planning to copy data */
     poDS->StartCopy( this );
 
+    if( bCopyBinary )
+    {
+        OGRErr eErr = AppendBinaryCopyRecord( poFeature );
+        if( eErr == OGRERR_NONE && abyCopyBuffer.size() >= PG_COPY_BATCH_SIZE )
+            eErr = FlushCopyBuffer( true );
+        return eErr;
+    }
+
     /* First process geometry */
     for( i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
     {
@@ -1963,31 +1972,803 @@ OGRErr OGRPGTableLayer::CreateFeatureViaCopy( OGRFeature *poFeature )
     /* Add end of line marker */
     osCommand += "\n";
 
+#ifdef DEBUG_VERBOSE
+    CPLDebug("PG", "PQputCopyData(%s)", osCommand.c_str());
+#endif
+
     /* ------------------------------------------------------------ */
-    /*      Execute the copy.                                       */
+    /*      Queue the line, and send the buffer if it is full.      */
     /* ------------------------------------------------------------ */
+    abyCopyBuffer.insert( abyCopyBuffer.end(),
+                          osCommand.begin(), osCommand.end() );
 
-    OGRErr result = OGRERR_NONE;
+    if( abyCopyBuffer.size() >= PG_COPY_BATCH_SIZE )
+        return FlushCopyBuffer( true );
 
-    int copyResult = PQputCopyData(hPGConn, osCommand.c_str(),
-                                   static_cast<int>(osCommand.size()));
-#ifdef DEBUG_VERBOSE
-    CPLDebug("PG", "PQputCopyData(%s)", osCommand.c_str());
-#endif
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                  Binary COPY encoding functions                      */
+/************************************************************************/
+
+static void OGRPGCopyAppendInt16( std::vector<GByte>& abyBuf, GInt16 nVal )
+{
+    CPL_MSBPTR16( &nVal );
+    const GByte* pabyVal = reinterpret_cast<const GByte*>(&nVal);
+    abyBuf.insert( abyBuf.end(), pabyVal, pabyVal + sizeof(nVal) );
+}
+
+static void OGRPGCopyAppendInt32( std::vector<GByte>& abyBuf, GInt32 nVal )
+{
+    CPL_MSBPTR32( &nVal );
+    const GByte* pabyVal = reinterpret_cast<const GByte*>(&nVal);
+    abyBuf.insert( abyBuf.end(), pabyVal, pabyVal + sizeof(nVal) );
+}
+
+static void OGRPGCopyAppendInt64( std::vector<GByte>& abyBuf, GIntBig nVal )
+{
+    CPL_MSBPTR64( &nVal );
+    const GByte* pabyVal = reinterpret_cast<const GByte*>(&nVal);
+    abyBuf.insert( abyBuf.end(), pabyVal, pabyVal + sizeof(nVal) );
+}
+
+static void OGRPGCopyAppendFloat32( std::vector<GByte>& abyBuf, float fVal )
+{
+    CPL_MSBPTR32( &fVal );
+    const GByte* pabyVal = reinterpret_cast<const GByte*>(&fVal);
+    abyBuf.insert( abyBuf.end(), pabyVal, pabyVal + sizeof(fVal) );
+}
+
+static void OGRPGCopyAppendFloat64( std::vector<GByte>& abyBuf, double dfVal )
+{
+    CPL_MSBPTR64( &dfVal );
+    const GByte* pabyVal = reinterpret_cast<const GByte*>(&dfVal);
+    abyBuf.insert( abyBuf.end(), pabyVal, pabyVal + sizeof(dfVal) );
+}
+
+/* Set the length of the value that starts after the 4 bytes at nLenOffset */
+static void OGRPGCopyPatchLength( std::vector<GByte>& abyBuf, size_t nLenOffset )
+{
+    GInt32 nLen = static_cast<GInt32>(abyBuf.size() - nLenOffset - 4);
+    CPL_MSBPTR32( &nLen );
+    memcpy( &abyBuf[nLenOffset], &nLen, 4 );
+}
+
+/************************************************************************/
+/*                      OGRPGCopyAppendNumeric()                        */
+/*                                                                      */
+/*      Encode a decimal number given as text in the binary            */
+/*      representation of the NUMERIC type (see numeric_send() in       */
+/*      pgsql/src/backend/utils/adt/numeric.c): groups of 4 decimal     */
+/*      digits, aligned on the decimal point.                           */
+/************************************************************************/
+
+static bool OGRPGCopyAppendNumeric( std::vector<GByte>& abyBuf,
+                                    const char* pszVal )
+{
+    while( *pszVal == ' ' )
+        pszVal++;
+
+    if( EQUAL(pszVal, "NaN") )
+    {
+        OGRPGCopyAppendInt16( abyBuf, 0 );
+        OGRPGCopyAppendInt16( abyBuf, 0 );
+        OGRPGCopyAppendInt16( abyBuf, static_cast<GInt16>(0xC000) );
+        OGRPGCopyAppendInt16( abyBuf, 0 );
+        return true;
+    }
+
+    bool bNegative = false;
+    if( *pszVal == '-' || *pszVal == '+' )
+    {
+        bNegative = (*pszVal == '-');
+        pszVal++;
+    }
+
+    std::string osInt;
+    std::string osFrac;
+    for( ; *pszVal >= '0' && *pszVal <= '9'; pszVal++ )
+        osInt += *pszVal;
+    if( *pszVal == '.' )
+    {
+        for( pszVal++; *pszVal >= '0' && *pszVal <= '9'; pszVal++ )
+            osFrac += *pszVal;
+    }
+    int nExp = 0;
+    if( *pszVal == 'e' || *pszVal == 'E' )
+    {
+        nExp = atoi(pszVal + 1);
+        pszVal++;
+        if( *pszVal == '-' || *pszVal == '+' )
+            pszVal++;
+        while( *pszVal >= '0' && *pszVal <= '9' )
+            pszVal++;
+    }
+    if( *pszVal != '\0' || (osInt.empty() && osFrac.empty()) ||
+        nExp > 1000 || nExp < -1000 )
+    {
+        return false;
+    }
+
+    /* Apply the exponent by moving the decimal point */
+    if( nExp > 0 )
+    {
+        const size_t nMove = std::min(static_cast<size_t>(nExp), osFrac.size());
+        osInt += osFrac.substr(0, nMove);
+        osFrac = osFrac.substr(nMove);
+        osInt += std::string(nExp - nMove, '0');
+    }
+    else if( nExp < 0 )
+    {
+        const size_t nMove = std::min(static_cast<size_t>(-nExp), osInt.size());
+        osFrac = osInt.substr(osInt.size() - nMove) + osFrac;
+        osInt.resize(osInt.size() - nMove);
+        osFrac = std::string(-nExp - nMove, '0') + osFrac;
+    }
+
+    const int nDScale = static_cast<int>(osFrac.size());
+
+    /* Align both parts on groups of 4 digits */
+    osInt = std::string((4 - osInt.size() % 4) % 4, '0') + osInt;
+    osFrac += std::string((4 - osFrac.size() % 4) % 4, '0');
+
+    std::vector<GInt16> anDigits;
+    const std::string osDigits(osInt + osFrac);
+    for( size_t i = 0; i < osDigits.size(); i += 4 )
+        anDigits.push_back( static_cast<GInt16>(atoi(osDigits.substr(i, 4).c_str())) );
+    int nWeight = static_cast<int>(osInt.size() / 4) - 1;
+
+    /* Strip leading and trailing zero groups */
+    size_t nFirst = 0;
+    while( nFirst < anDigits.size() && anDigits[nFirst] == 0 )
+    {
+        nFirst++;
+        nWeight--;
+    }
+    size_t nLast = anDigits.size();
+    while( nLast > nFirst && anDigits[nLast-1] == 0 )
+        nLast--;
+    if( nFirst == nLast )
+    {
+        nWeight = 0;
+        bNegative = false;
+    }
+
+    OGRPGCopyAppendInt16( abyBuf, static_cast<GInt16>(nLast - nFirst) );
+    OGRPGCopyAppendInt16( abyBuf, static_cast<GInt16>(nWeight) );
+    OGRPGCopyAppendInt16( abyBuf, static_cast<GInt16>(bNegative ? 0x4000 : 0) );
+    OGRPGCopyAppendInt16( abyBuf, static_cast<GInt16>(nDScale) );
+    for( size_t i = nFirst; i < nLast; i++ )
+        OGRPGCopyAppendInt16( abyBuf, anDigits[i] );
+    return true;
+}
+
+/************************************************************************/
+/*                          OGRPGDate2J()                               */
+/************************************************************************/
+
+/* Coming from date2j() in pgsql/src/backend/utils/adt/datetime.c */
+
+static int OGRPGDate2J( int y, int m, int d )
+{
+    if( m > 2 )
+    {
+        m += 1;
+        y += 4800;
+    }
+    else
+    {
+        m += 13;
+        y += 4799;
+    }
 
+    const int century = y / 100;
+    int julian = y * 365 - 32167;
+    julian += y / 4 - century + century / 4;
+    julian += 7834 * m / 256 + d;
+
+    return julian;
+}
+
+/************************************************************************/
+/*                     OGRPGCopyCanEncodeBinary()                       */
+/************************************************************************/
+
+static bool OGRPGCopyCanEncodeBinary( OGRFieldType eType, Oid nTypeOID,
+                                      bool bIntegerDatetimes )
+{
+    switch( eType )
+    {
+        case OFTInteger:
+        case OFTInteger64:
+            return nTypeOID == BOOLOID || nTypeOID == INT2OID ||
+                   nTypeOID == INT4OID || nTypeOID == INT8OID ||
+                   nTypeOID == FLOAT4OID || nTypeOID == FLOAT8OID ||
+                   nTypeOID == NUMERICOID;
+        case OFTReal:
+            return nTypeOID == FLOAT4OID || nTypeOID == FLOAT8OID ||
+                   nTypeOID == NUMERICOID;
+        case OFTString:
+            return nTypeOID == TEXTOID || nTypeOID == VARCHAROID ||
+                   nTypeOID == BPCHAROID;
+        case OFTBinary:
+            return nTypeOID == BYTEAOID;
+        case OFTDate:
+            return nTypeOID == DATEOID;
+        case OFTTime:
+            return nTypeOID == TIMEOID && bIntegerDatetimes;
+        case OFTDateTime:
+            /* timestamptz is left to the text format, where the server */
+            /* interprets values of unknown time zone in the time zone of */
+            /* the session.  timestamp ignores the time zone in both. */
+            return nTypeOID == TIMESTAMPOID && bIntegerDatetimes;
+        case OFTIntegerList:
+            return nTypeOID == INT2ARRAYOID || nTypeOID == INT4ARRAYOID ||
+                   nTypeOID == INT8ARRAYOID;
+        case OFTInteger64List:
+            return nTypeOID == INT8ARRAYOID;
+        case OFTRealList:
+            return nTypeOID == FLOAT4ARRAYOID || nTypeOID == FLOAT8ARRAYOID;
+        case OFTStringList:
+            return nTypeOID == TEXTARRAYOID || nTypeOID == VARCHARARRAYOID;
+        default:
+            return false;
+    }
+}
+
+/************************************************************************/
+/*                        PrepareBinaryCopy()                           */
+/*                                                                      */
+/*      Check that all the columns of the COPY have a type whose        */
+/*      binary representation we can produce from the OGR field, and    */
+/*      store their OIDs in the order of BuildCopyFields().             */
+/************************************************************************/
+
+int OGRPGTableLayer::PrepareBinaryCopy()
+{
+    anCopyTypeOIDs.clear();
+
+    if( poDS->sPostgreSQLVersion.nMajor < 9 ||
+        !CPLTestBool(CPLGetConfigOption("PG_USE_COPY_BINARY", "NO")) )
+        return FALSE;
+
+    PGconn *hPGConn = poDS->GetPGConn();
+    CPLString osCommand;
+    osCommand.Printf(
+        "SELECT a.attname, a.atttypid FROM pg_attribute a "
+        "WHERE a.attrelid = %s::regclass AND a.attnum > 0 "
+        "AND NOT a.attisdropped",
+        OGRPGEscapeString(hPGConn, pszSqlTableName).c_str());
+    PGresult *hResult = OGRPG_PQexec(poDS, osCommand );
+    if( !hResult || PQresultStatus(hResult) != PGRES_TUPLES_OK )
+    {
+        OGRPGClearResult( hResult );
+        return FALSE;
+    }
+    std::map<CPLString, Oid> oMapColumnTypes;
+    for( int i = 0; i < PQntuples(hResult); i++ )
+    {
+        oMapColumnTypes[PQgetvalue(hResult, i, 0)] =
+            static_cast<Oid>(atoi(PQgetvalue(hResult, i, 1)));
+    }
+    OGRPGClearResult( hResult );
+
+    const char* pszIntegerDatetimes =
+        PQparameterStatus(hPGConn, "integer_datetimes");
+    const bool bIntegerDatetimes =
+        pszIntegerDatetimes != NULL && EQUAL(pszIntegerDatetimes, "on");
+
+    for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
+    {
+        OGRPGGeomFieldDefn* poGeomFieldDefn =
+            poFeatureDefn->myGetGeomFieldDefn(i);
+        const Oid nTypeOID = oMapColumnTypes[poGeomFieldDefn->GetNameRef()];
+        if( poGeomFieldDefn->ePostgisType == GEOM_TYPE_WKB )
+        {
+            if( nTypeOID != BYTEAOID )
+                return FALSE;
+        }
+        else if( poDS->sPostGISVersion.nMajor < 2 ||
+                 (nTypeOID != poDS->GetGeometryOID() &&
+                  nTypeOID != poDS->GetGeographyOID()) )
+        {
+            return FALSE;
+        }
+        anCopyTypeOIDs.push_back(nTypeOID);
+    }
+
+    int nFIDIndex = -1;
+    if( bFIDColumnInCopyFields )
+    {
+        const Oid nTypeOID = oMapColumnTypes[pszFIDColumn];
+        if( nTypeOID != INT4OID && nTypeOID != INT8OID )
+            return FALSE;
+        anCopyTypeOIDs.push_back(nTypeOID);
+        nFIDIndex = poFeatureDefn->GetFieldIndex( pszFIDColumn );
+    }
+
+    for( int i = 0; i < poFeatureDefn->GetFieldCount(); i++ )
+    {
+        if( i == nFIDIndex )
+            continue;
+        OGRFieldDefn* poFieldDefn = poFeatureDefn->GetFieldDefn(i);
+        const Oid nTypeOID = oMapColumnTypes[poFieldDefn->GetNameRef()];
+        if( !OGRPGCopyCanEncodeBinary(poFieldDefn->GetType(), nTypeOID,
+                                      bIntegerDatetimes) )
+        {
+            CPLDebug("PG", "Binary COPY not used because of column %s",
+                     poFieldDefn->GetNameRef());
+            return FALSE;
+        }
+        anCopyTypeOIDs.push_back(nTypeOID);
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                      AppendBinaryCopyRecord()                        */
+/************************************************************************/
+
+OGRErr OGRPGTableLayer::AppendBinaryCopyRecord( OGRFeature *poFeature )
+{
+    const size_t nRecordStart = abyCopyBuffer.size();
+    size_t iCol = 0;
+
+    OGRPGCopyAppendInt16( abyCopyBuffer,
+                          static_cast<GInt16>(anCopyTypeOIDs.size()) );
+
+    /* First process geometry */
+    for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++, iCol++ )
+    {
+        OGRPGGeomFieldDefn* poGeomFieldDefn =
+            poFeatureDefn->myGetGeomFieldDefn(i);
+        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(i);
+        if( poGeom == NULL )
+        {
+            OGRPGCopyAppendInt32( abyCopyBuffer, -1 );
+            continue;
+        }
+
+        CheckGeomTypeCompatibility(i, poGeom);
+
+        poGeom->closeRings();
+        poGeom->set3D(poGeomFieldDefn->GeometryTypeFlags & OGRGeometry::OGR_G_3D);
+        poGeom->setMeasured(poGeomFieldDefn->GeometryTypeFlags & OGRGeometry::OGR_G_MEASURED);
+
+        /* EWKB as in OGRGeometryToHexEWKB(), or WKB for bytea columns */
+        const bool bEWKB = poGeomFieldDefn->ePostgisType != GEOM_TYPE_WKB;
+        const int nSRSId = bEWKB ? poGeomFieldDefn->nSRSId : 0;
+        const int nWkbSize = poGeom->WkbSize();
+        const size_t nLenOffset = abyCopyBuffer.size();
+        abyCopyBuffer.resize( nLenOffset + 4 + nWkbSize + (nSRSId > 0 ? 4 : 0) );
+        GByte* pabyWKB = &abyCopyBuffer[nLenOffset + 4];
+
+        const bool bEmptyPoint =
+            (poDS->sPostGISVersion.nMajor > 2 ||
+             (poDS->sPostGISVersion.nMajor == 2 &&
+              poDS->sPostGISVersion.nMinor >= 2)) &&
+            wkbFlatten(poGeom->getGeometryType()) == wkbPoint &&
+            poGeom->IsEmpty();
+        if( poGeom->exportToWkb( wkbNDR, pabyWKB,
+                                 bEmptyPoint ? wkbVariantIso :
+                                 (poDS->sPostGISVersion.nMajor < 2) ?
+                                    wkbVariantPostGIS1 : wkbVariantOldOgc )
+                                                            != OGRERR_NONE )
+        {
+            abyCopyBuffer.resize( nRecordStart );
+            return OGRERR_FAILURE;
+        }
+
+        if( nSRSId > 0 )
+        {
+            /* Insert the SRID after the geometry type */
+            memmove( pabyWKB + 9, pabyWKB + 5, nWkbSize - 5 );
+            GUInt32 nGeomType;
+            memcpy( &nGeomType, pabyWKB + 1, 4 );
+            nGeomType |= CPL_LSBWORD32( 0x20000000 ); // wkbSRID flag
+            memcpy( pabyWKB + 1, &nGeomType, 4 );
+            const GUInt32 nGSRSId = CPL_LSBWORD32( nSRSId );
+            memcpy( pabyWKB + 5, &nGSRSId, 4 );
+        }
+
+        OGRPGCopyPatchLength( abyCopyBuffer, nLenOffset );
+    }
+
+    /* Next process the field id column */
+    int nFIDIndex = -1;
+    if( bFIDColumnInCopyFields )
+    {
+        nFIDIndex = poFeatureDefn->GetFieldIndex( pszFIDColumn );
+        const GIntBig nFID = poFeature->GetFID();
+        if( nFID == OGRNullFID )
+        {
+            OGRPGCopyAppendInt32( abyCopyBuffer, -1 );
+        }
+        else if( anCopyTypeOIDs[iCol] == INT8OID )
+        {
+            OGRPGCopyAppendInt32( abyCopyBuffer, 8 );
+            OGRPGCopyAppendInt64( abyCopyBuffer, nFID );
+        }
+        else if( nFID == static_cast<int>(nFID) )
+        {
+            OGRPGCopyAppendInt32( abyCopyBuffer, 4 );
+            OGRPGCopyAppendInt32( abyCopyBuffer, static_cast<int>(nFID) );
+        }
+        else
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "FID " CPL_FRMT_GIB " is out of range of column %s",
+                      nFID, pszFIDColumn );
+            abyCopyBuffer.resize( nRecordStart );
+            return OGRERR_FAILURE;
+        }
+        iCol++;
+    }
+
+    /* Now process the remaining fields */
+    for( int i = 0; i < poFeatureDefn->GetFieldCount(); i++ )
+    {
+        if( i == nFIDIndex )
+            continue;
+
+        const Oid nTypeOID = anCopyTypeOIDs[iCol++];
+
+        if( !poFeature->IsFieldSetAndNotNull( i ) )
+        {
+            OGRPGCopyAppendInt32( abyCopyBuffer, -1 );
+            continue;
+        }
+
+        OGRFieldDefn* poFieldDefn = poFeatureDefn->GetFieldDefn(i);
+        const size_t nLenOffset = abyCopyBuffer.size();
+        OGRPGCopyAppendInt32( abyCopyBuffer, 0 );
+
+        bool bOK = true;
+        switch( nTypeOID )
+        {
+            case BOOLOID:
+                abyCopyBuffer.push_back(
+                    poFeature->GetFieldAsInteger64(i) != 0 ? 1 : 0 );
+                break;
+
+            case INT2OID:
+            case INT4OID:
+            {
+                const GIntBig nVal = poFeature->GetFieldAsInteger64(i);
+                if( nTypeOID == INT2OID &&
+                    nVal == static_cast<GInt16>(nVal) )
+                {
+                    OGRPGCopyAppendInt16( abyCopyBuffer,
+                                          static_cast<GInt16>(nVal) );
+                }
+                else if( nTypeOID == INT4OID &&
+                         nVal == static_cast<GInt32>(nVal) )
+                {
+                    OGRPGCopyAppendInt32( abyCopyBuffer,
+                                          static_cast<GInt32>(nVal) );
+                }
+                else
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                              "Value " CPL_FRMT_GIB " of field %s is out "
+                              "of range", nVal, poFieldDefn->GetNameRef() );
+                    bOK = false;
+                }
+                break;
+            }
+
+            case INT8OID:
+                OGRPGCopyAppendInt64( abyCopyBuffer,
+                                      poFeature->GetFieldAsInteger64(i) );
+                break;
+
+            case FLOAT4OID:
+                OGRPGCopyAppendFloat32( abyCopyBuffer,
+                    static_cast<float>(poFeature->GetFieldAsDouble(i)) );
+                break;
+
+            case FLOAT8OID:
+                OGRPGCopyAppendFloat64( abyCopyBuffer,
+                                        poFeature->GetFieldAsDouble(i) );
+                break;
+
+            case NUMERICOID:
+                /* Use the same text formatting as the text COPY */
+                bOK = OGRPGCopyAppendNumeric( abyCopyBuffer,
+                                              poFeature->GetFieldAsString(i) );
+                if( !bOK )
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                              "Value %s of field %s cannot be written as "
+                              "numeric", poFeature->GetFieldAsString(i),
+                              poFieldDefn->GetNameRef() );
+                }
+                break;
+
+            case TEXTOID:
+            case VARCHAROID:
+            case BPCHAROID:
+            {
+                const char *pszStrValue = poFeature->GetFieldAsString(i);
+                size_t nLen = strlen(pszStrValue);
+                const int nMaxWidth = poFieldDefn->GetWidth();
+                if( nMaxWidth > 0 )
+                {
+                    /* Truncate to nMaxWidth UTF-8 characters */
+                    int iUTFChar = 0;
+                    for( size_t iChar = 0; iChar < nLen; iChar++ )
+                    {
+                        if( (pszStrValue[iChar] & 0xc0) != 0x80 )
+                        {
+                            if( iUTFChar == nMaxWidth )
+                            {
+                                CPLDebug( "PG",
+                                    "Truncated %s field value, it was too long.",
+                                    poFieldDefn->GetNameRef() );
+                                nLen = iChar;
+                                break;
+                            }
+                            iUTFChar++;
+                        }
+                    }
+                }
+                abyCopyBuffer.insert( abyCopyBuffer.end(),
+                                      pszStrValue, pszStrValue + nLen );
+                break;
+            }
+
+            case BYTEAOID:
+            {
+                int nLen = 0;
+                const GByte* pabyData = poFeature->GetFieldAsBinary(i, &nLen);
+                abyCopyBuffer.insert( abyCopyBuffer.end(),
+                                      pabyData, pabyData + nLen );
+                break;
+            }
+
+            case DATEOID:
+            case TIMEOID:
+            case TIMESTAMPOID:
+            {
+                int nYear = 0;
+                int nMonth = 0;
+                int nDay = 0;
+                int nHour = 0;
+                int nMinute = 0;
+                float fSecond = 0.0f;
+                int nTZFlag = 0;
+                /* The time zone is ignored, as the server does for */
+                /* timestamp without time zone */
+                poFeature->GetFieldAsDateTime( i, &nYear, &nMonth, &nDay,
+                                               &nHour, &nMinute, &fSecond,
+                                               &nTZFlag );
+                const int nDays = OGRPGDate2J(nYear, nMonth, nDay) -
+                                  POSTGRES_EPOCH_JDATE;
+                /* OGR datetimes have a millisecond precision */
+                GIntBig nTime =
+                    (static_cast<GIntBig>(nHour) * 3600 + nMinute * 60) *
+                        1000000 +
+                    static_cast<GIntBig>(floor(fSecond * 1000 + 0.5)) * 1000;
+                if( nTypeOID == DATEOID )
+                {
+                    OGRPGCopyAppendInt32( abyCopyBuffer, nDays );
+                    break;
+                }
+                if( nTypeOID == TIMEOID )
+                {
+                    OGRPGCopyAppendInt64( abyCopyBuffer, nTime );
+                    break;
+                }
+                OGRPGCopyAppendInt64( abyCopyBuffer,
+                    static_cast<GIntBig>(nDays) * 86400 * 1000000 + nTime );
+                break;
+            }
+
+            case INT2ARRAYOID:
+            case INT4ARRAYOID:
+            case INT8ARRAYOID:
+            case FLOAT4ARRAYOID:
+            case FLOAT8ARRAYOID:
+            case TEXTARRAYOID:
+            case VARCHARARRAYOID:
+            {
+                Oid nElemTypeOID = INT4OID;
+                int nCount = 0;
+                const int* panValues = NULL;
+                const GIntBig* panValues64 = NULL;
+                const double* padfValues = NULL;
+                char** papszValues = NULL;
+                if( nTypeOID == INT2ARRAYOID || nTypeOID == INT4ARRAYOID ||
+                    (nTypeOID == INT8ARRAYOID &&
+                     poFieldDefn->GetType() == OFTIntegerList) )
+                {
+                    panValues = poFeature->GetFieldAsIntegerList(i, &nCount);
+                    nElemTypeOID = nTypeOID == INT2ARRAYOID ? INT2OID :
+                                   nTypeOID == INT4ARRAYOID ? INT4OID : INT8OID;
+                }
+                else if( nTypeOID == INT8ARRAYOID )
+                {
+                    panValues64 = poFeature->GetFieldAsInteger64List(i, &nCount);
+                    nElemTypeOID = INT8OID;
+                }
+                else if( nTypeOID == FLOAT4ARRAYOID ||
+                         nTypeOID == FLOAT8ARRAYOID )
+                {
+                    padfValues = poFeature->GetFieldAsDoubleList(i, &nCount);
+                    nElemTypeOID = nTypeOID == FLOAT4ARRAYOID ? FLOAT4OID :
+                                                                FLOAT8OID;
+                }
+                else
+                {
+                    papszValues = poFeature->GetFieldAsStringList(i);
+                    nCount = CSLCount(papszValues);
+                    nElemTypeOID = nTypeOID == TEXTARRAYOID ? TEXTOID :
+                                                              VARCHAROID;
+                }
+
+                /* See array_recv() in pgsql/src/backend/utils/adt/arrayfuncs.c */
+                OGRPGCopyAppendInt32( abyCopyBuffer, nCount > 0 ? 1 : 0 );
+                OGRPGCopyAppendInt32( abyCopyBuffer, 0 ); // no NULL
+                OGRPGCopyAppendInt32( abyCopyBuffer, nElemTypeOID );
+                if( nCount > 0 )
+                {
+                    OGRPGCopyAppendInt32( abyCopyBuffer, nCount );
+                    OGRPGCopyAppendInt32( abyCopyBuffer, 1 ); // lower bound
+                }
+                for( int j = 0; bOK && j < nCount; j++ )
+                {
+                    if( panValues != NULL && nElemTypeOID == INT2OID )
+                    {
+                        bOK = panValues[j] == static_cast<GInt16>(panValues[j]);
+                        OGRPGCopyAppendInt32( abyCopyBuffer, 2 );
+                        OGRPGCopyAppendInt16( abyCopyBuffer,
+                                        static_cast<GInt16>(panValues[j]) );
+                    }
+                    else if( panValues != NULL && nElemTypeOID == INT4OID )
+                    {
+                        OGRPGCopyAppendInt32( abyCopyBuffer, 4 );
+                        OGRPGCopyAppendInt32( abyCopyBuffer, panValues[j] );
+                    }
+                    else if( panValues != NULL )
+                    {
+                        OGRPGCopyAppendInt32( abyCopyBuffer, 8 );
+                        OGRPGCopyAppendInt64( abyCopyBuffer, panValues[j] );
+                    }
+                    else if( panValues64 != NULL )
+                    {
+                        OGRPGCopyAppendInt32( abyCopyBuffer, 8 );
+                        OGRPGCopyAppendInt64( abyCopyBuffer, panValues64[j] );
+                    }
+                    else if( padfValues != NULL && nElemTypeOID == FLOAT4OID )
+                    {
+                        OGRPGCopyAppendInt32( abyCopyBuffer, 4 );
+                        OGRPGCopyAppendFloat32( abyCopyBuffer,
+                                        static_cast<float>(padfValues[j]) );
+                    }
+                    else if( padfValues != NULL )
+                    {
+                        OGRPGCopyAppendInt32( abyCopyBuffer, 8 );
+                        OGRPGCopyAppendFloat64( abyCopyBuffer, padfValues[j] );
+                    }
+                    else
+                    {
+                        const size_t nLen = strlen(papszValues[j]);
+                        OGRPGCopyAppendInt32( abyCopyBuffer,
+                                              static_cast<GInt32>(nLen) );
+                        abyCopyBuffer.insert( abyCopyBuffer.end(),
+                                              papszValues[j],
+                                              papszValues[j] + nLen );
+                    }
+                }
+                if( !bOK )
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                              "Value of field %s is out of range",
+                              poFieldDefn->GetNameRef() );
+                }
+                break;
+            }
+
+            default:
+                CPLAssert(false);
+                bOK = false;
+                break;
+        }
+
+        if( !bOK )
+        {
+            abyCopyBuffer.resize( nRecordStart );
+            return OGRERR_FAILURE;
+        }
+        OGRPGCopyPatchLength( abyCopyBuffer, nLenOffset );
+    }
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          FlushCopyBuffer()                           */
+/*                                                                      */
+/*      Send the accumulated COPY data. In asynchronous mode, this is   */
+/*      done by a worker thread so that the next buffer can be filled   */
+/*      meanwhile.                                                      */
+/************************************************************************/
+
+OGRErr OGRPGTableLayer::FlushCopyBuffer( bool bAsync )
+{
+    OGRErr eErr = WaitCopyThread();
+    if( abyCopyBuffer.empty() )
+        return eErr;
+
+    abyCopyBufferInFlight.swap( abyCopyBuffer );
+    abyCopyBuffer.resize( 0 );
+
+    if( bAsync )
+    {
+        hCopyThread = CPLCreateJoinableThread( CopyThreadFunc, this );
+        if( hCopyThread != NULL )
+        {
+            /* Make sure that nobody uses the connection until the data */
+            /* is sent */
+            poDS->SetPendingQuery( WaitCopyThreadFunc, this );
+            return eErr;
+        }
+    }
+
+    CopyThreadFunc( this );
+    OGRErr eErr2 = WaitCopyThread();
+    return eErr != OGRERR_NONE ? eErr : eErr2;
+}
+
+/************************************************************************/
+/*                          CopyThreadFunc()                            */
+/************************************************************************/
+
+void OGRPGTableLayer::CopyThreadFunc( void* pUserData )
+{
+    OGRPGTableLayer* poLayer = static_cast<OGRPGTableLayer*>(pUserData);
+    poLayer->nCopyThreadResult = PQputCopyData(
+        poLayer->poDS->GetPGConn(),
+        reinterpret_cast<const char*>(&poLayer->abyCopyBufferInFlight[0]),
+        static_cast<int>(poLayer->abyCopyBufferInFlight.size()) );
+}
+
+/************************************************************************/
+/*                          WaitCopyThread()                            */
+/************************************************************************/
+
+void OGRPGTableLayer::WaitCopyThreadFunc( void* pUserData )
+{
+    CPL_IGNORE_RET_VAL(
+        static_cast<OGRPGTableLayer*>(pUserData)->WaitCopyThread() );
+}
+
+OGRErr OGRPGTableLayer::WaitCopyThread()
+{
+    PGconn *hPGConn = poDS->GetPGConn();
+    if( hCopyThread != NULL )
+    {
+        CPLJoinThread( hCopyThread );
+        hCopyThread = NULL;
+        poDS->SetPendingQuery( NULL, NULL );
+    }
+    abyCopyBufferInFlight.resize( 0 );
+
+    const int copyResult = nCopyThreadResult;
+    nCopyThreadResult = 1;
     switch (copyResult)
     {
     case 0:
         CPLError( CE_Failure, CPLE_AppDefined, "Writing COPY data blocked.");
-        result = OGRERR_FAILURE;
-        break;
+        return OGRERR_FAILURE;
     case -1:
         CPLError( CE_Failure, CPLE_AppDefined, "%s", PQerrorMessage(hPGConn) );
-        result = OGRERR_FAILURE;
-        break;
+        return OGRERR_FAILURE;
+    default:
+        return OGRERR_NONE;
     }
-
-    return result;
 }
 
 /************************************************************************/
@@ -2167,7 +2948,7 @@ OGRErr OGRPGTableLayer::CreateField( OGRFieldDefn *poFieldIn, int bApproxOK )
                         osFieldType.c_str() );
         osCommand += osNotNullDefault;
 
-        hResult = OGRPG_PQexec(hPGConn, osCommand);
+        hResult = OGRPG_PQexec(poDS, osCommand);
         if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
@@ -2225,7 +3006,7 @@ OGRErr OGRPGTableLayer::RunAddGeometryColumn( OGRPGGeomFieldDefn *poGeomField )
             OGRPGEscapeString(hPGConn, poGeomField->GetNameRef()).c_str(),
             poGeomField->nSRSId, pszGeometryType, suffix, dim );
 
-    PGresult *hResult = OGRPG_PQexec(hPGConn, osCommand.c_str());
+    PGresult *hResult = OGRPG_PQexec(poDS, osCommand.c_str());
 
     if( !hResult
         || PQresultStatus(hResult) != PGRES_TUPLES_OK )
@@ -2246,7 +3027,7 @@ OGRErr OGRPGTableLayer::RunAddGeometryColumn( OGRPGGeomFieldDefn *poGeomField )
                           pszSqlTableName,
                           OGRPGEscapeColumnName(poGeomField->GetNameRef()).c_str() );
 
-        hResult = OGRPG_PQexec(hPGConn, osCommand.c_str());
+        hResult = OGRPG_PQexec(poDS, osCommand.c_str());
         OGRPGClearResult( hResult );
     }
 
@@ -2259,7 +3040,6 @@ OGRErr OGRPGTableLayer::RunAddGeometryColumn( OGRPGGeomFieldDefn *poGeomField )
 
 OGRErr OGRPGTableLayer::RunCreateSpatialIndex( OGRPGGeomFieldDefn *poGeomField )
 {
-    PGconn *hPGConn = poDS->GetPGConn();
     CPLString osCommand;
 
     osCommand.Printf("CREATE INDEX %s ON %s USING GIST (%s)",
@@ -2268,7 +3048,7 @@ OGRErr OGRPGTableLayer::RunCreateSpatialIndex( OGRPGGeomFieldDefn *poGeomField )
                     pszSqlTableName,
                     OGRPGEscapeColumnName(poGeomField->GetNameRef()).c_str());
 
-    PGresult *hResult = OGRPG_PQexec(hPGConn, osCommand.c_str());
+    PGresult *hResult = OGRPG_PQexec(poDS, osCommand.c_str());
 
     if( !hResult
         || PQresultStatus(hResult) != PGRES_COMMAND_OK )
@@ -2420,7 +3200,7 @@ OGRErr OGRPGTableLayer::DeleteField( int iField )
     osCommand.Printf( "ALTER TABLE %s DROP COLUMN %s",
                       pszSqlTableName,
                       OGRPGEscapeColumnName(poFeatureDefn->GetFieldDefn(iField)->GetNameRef()).c_str() );
-    hResult = OGRPG_PQexec(hPGConn, osCommand);
+    hResult = OGRPG_PQexec(poDS, osCommand);
     if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
     {
         CPLError( CE_Failure, CPLE_AppDefined,
@@ -2505,7 +3285,7 @@ OGRErr OGRPGTableLayer::AlterFieldDefn( int iField, OGRFieldDefn* poNewFieldDefn
                         OGRPGEscapeColumnName(poFieldDefn->GetNameRef()).c_str(),
                         osFieldType.c_str() );
 
-        hResult = OGRPG_PQexec(hPGConn, osCommand);
+        hResult = OGRPG_PQexec(poDS, osCommand);
         if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
@@ -2536,7 +3316,7 @@ OGRErr OGRPGTableLayer::AlterFieldDefn( int iField, OGRFieldDefn* poNewFieldDefn
                     pszSqlTableName,
                     OGRPGEscapeColumnName(poFieldDefn->GetNameRef()).c_str() );
 
-        hResult = OGRPG_PQexec(hPGConn, osCommand);
+        hResult = OGRPG_PQexec(poDS, osCommand);
         if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
@@ -2571,7 +3351,7 @@ OGRErr OGRPGTableLayer::AlterFieldDefn( int iField, OGRFieldDefn* poNewFieldDefn
                     OGRPGEscapeColumnName(poFieldDefn->GetNameRef()).c_str(),
                     OGRPGCommonLayerGetPGDefault(poNewFieldDefn).c_str());
 
-        hResult = OGRPG_PQexec(hPGConn, osCommand);
+        hResult = OGRPG_PQexec(poDS, osCommand);
         if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
@@ -2610,7 +3390,7 @@ OGRErr OGRPGTableLayer::AlterFieldDefn( int iField, OGRFieldDefn* poNewFieldDefn
                             pszSqlTableName,
                             OGRPGEscapeColumnName(poFieldDefn->GetNameRef()).c_str(),
                             OGRPGEscapeColumnName(oField.GetNameRef()).c_str() );
-            hResult = OGRPG_PQexec(hPGConn, osCommand);
+            hResult = OGRPG_PQexec(poDS, osCommand);
             if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
             {
                 CPLError( CE_Failure, CPLE_AppDefined,
@@ -2668,27 +3448,28 @@ OGRFeature *OGRPGTableLayer::GetFeature( GIntBig nFeatureId )
 /* -------------------------------------------------------------------- */
     OGRFeature  *poFeature = NULL;
     PGresult    *hResult = NULL;
-    PGconn      *hPGConn = poDS->GetPGConn();
     CPLString    osFieldList = BuildFields();
     CPLString    osCommand;
 
     poDS->EndCopy();
     poDS->SoftStartTransaction();
 
+    /* A single row is fetched, so there is no point in using a binary */
+    /* cursor. RecordToFeature() decodes the text representation of the */
+    /* fields requested by BuildFields() in binary cursor mode as well. */
     osCommand.Printf(
-             "DECLARE getfeaturecursor %s for "
+             "DECLARE getfeaturecursor CURSOR for "
              "SELECT %s FROM %s WHERE %s = " CPL_FRMT_GIB,
-              ( poDS->bUseBinaryCursor ) ? "BINARY CURSOR" : "CURSOR",
              osFieldList.c_str(), pszSqlTableName, OGRPGEscapeColumnName(pszFIDColumn).c_str(),
              nFeatureId );
 
-    hResult = OGRPG_PQexec(hPGConn, osCommand.c_str() );
+    hResult = OGRPG_PQexec(poDS, osCommand.c_str() );
 
     if( hResult && PQresultStatus(hResult) == PGRES_COMMAND_OK )
     {
         OGRPGClearResult( hResult );
 
-        hResult = OGRPG_PQexec(hPGConn, "FETCH ALL in getfeaturecursor" );
+        hResult = OGRPG_PQexec(poDS, "FETCH ALL in getfeaturecursor" );
 
         if( hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK )
         {
@@ -2737,7 +3518,7 @@ OGRFeature *OGRPGTableLayer::GetFeature( GIntBig nFeatureId )
 /* -------------------------------------------------------------------- */
     OGRPGClearResult( hResult );
 
-    hResult = OGRPG_PQexec(hPGConn, "CLOSE getfeaturecursor");
+    hResult = OGRPG_PQexec(poDS, "CLOSE getfeaturecursor");
     OGRPGClearResult( hResult );
 
     poDS->SoftCommitTransaction();
@@ -2765,7 +3546,6 @@ GIntBig OGRPGTableLayer::GetFeatureCount( int bForce )
 /*      After all someone else could be adding records from another     */
 /*      application when working against a database.                    */
 /* -------------------------------------------------------------------- */
-    PGconn              *hPGConn = poDS->GetPGConn();
     PGresult            *hResult = NULL;
     CPLString           osCommand;
     GIntBig              nCount = 0;
@@ -2774,7 +3554,7 @@ GIntBig OGRPGTableLayer::GetFeatureCount( int bForce )
         "SELECT count(*) FROM %s %s",
         pszSqlTableName, osWHERE.c_str() );
 
-    hResult = OGRPG_PQexec(hPGConn, osCommand);
+    hResult = OGRPG_PQexec(poDS, osCommand);
     if( hResult != NULL && PQresultStatus(hResult) == PGRES_TUPLES_OK )
         nCount = CPLAtoGIntBig(PQgetvalue(hResult,0,0));
     else
@@ -2812,7 +3592,7 @@ void OGRPGTableLayer::ResolveSRID(OGRPGGeomFieldDefn* poGFldDefn)
     osCommand += CPLString().Printf(" AND f_table_schema = %s",
                                     OGRPGEscapeString(hPGConn, pszSchemaName).c_str());
 
-    hResult = OGRPG_PQexec(hPGConn, osCommand.c_str() );
+    hResult = OGRPG_PQexec(poDS, osCommand.c_str() );
 
     if( hResult
         && PQresultStatus(hResult) == PGRES_TUPLES_OK
@@ -2841,7 +3621,7 @@ void OGRPGTableLayer::ResolveSRID(OGRPGGeomFieldDefn* poGFldDefn)
         osGetSRID += pszSqlTableName;
         osGetSRID += " LIMIT 1";
 
-        hResult = OGRPG_PQexec(poDS->GetPGConn(), osGetSRID );
+        hResult = OGRPG_PQexec(poDS, osGetSRID );
         if( hResult
             && PQresultStatus(hResult) == PGRES_TUPLES_OK
             && PQntuples(hResult) == 1 )
@@ -2866,15 +3646,19 @@ OGRErr OGRPGTableLayer::StartCopy()
 
     CPLString osFields = BuildCopyFields();
 
+    abyCopyBuffer.resize( 0 );
+    bCopyBinary = PrepareBinaryCopy();
+
     size_t size = osFields.size() +  strlen(pszSqlTableName) + 100;
     char *pszCommand = (char *) CPLMalloc(size);
 
     snprintf( pszCommand, size,
-             "COPY %s (%s) FROM STDIN;",
+             bCopyBinary ? "COPY %s (%s) FROM STDIN WITH (FORMAT binary);" :
+                           "COPY %s (%s) FROM STDIN;",
              pszSqlTableName, osFields.c_str() );
 
     PGconn *hPGConn = poDS->GetPGConn();
-    PGresult *hResult = OGRPG_PQexec(hPGConn, pszCommand);
+    PGresult *hResult = OGRPG_PQexec(poDS, pszCommand);
 
     if ( !hResult || (PQresultStatus(hResult) != PGRES_COPY_IN))
     {
@@ -2887,6 +3671,17 @@ OGRErr OGRPGTableLayer::StartCopy()
     OGRPGClearResult( hResult );
     CPLFree( pszCommand );
 
+    if( bCopyBinary )
+    {
+        /* Signature, flags and header extension length */
+        static const GByte abySignature[] =
+            { 'P', 'G', 'C', 'O', 'P', 'Y', '\n', 0xFF, '\r', '\n', 0 };
+        abyCopyBuffer.insert( abyCopyBuffer.end(), abySignature,
+                              abySignature + sizeof(abySignature) );
+        OGRPGCopyAppendInt32( abyCopyBuffer, 0 );
+        OGRPGCopyAppendInt32( abyCopyBuffer, 0 );
+    }
+
     return OGRERR_NONE;
 }
 
@@ -2898,7 +3693,12 @@ OGRErr OGRPGTableLayer::EndCopy()
 
 {
     if( !bCopyActive )
+    {
+        /* The COPY could not be started: just discard what was queued */
+        CPL_IGNORE_RET_VAL(WaitCopyThread());
+        abyCopyBuffer.resize( 0 );
         return OGRERR_NONE;
+    }
     /*CPLDebug("PG", "OGRPGDataSource(%p)::EndCopy(%p)", poDS, this);*/
 
     /* This method is called from the datasource when
@@ -2906,9 +3706,16 @@ OGRErr OGRPGTableLayer::EndCopy()
     OGRErr result = OGRERR_NONE;
 
     PGconn *hPGConn = poDS->GetPGConn();
+
+    /* Send the remaining data, with the file trailer in binary mode */
+    if( bCopyBinary )
+        OGRPGCopyAppendInt16( abyCopyBuffer, -1 );
+    result = FlushCopyBuffer( false );
+
     CPLDebug( "PG", "PQputCopyEnd()" );
 
     bCopyActive = FALSE;
+    bCopyBinary = FALSE;
 
     int copyResult = PQputCopyEnd(hPGConn, NULL);
 
@@ -3191,7 +3998,7 @@ OGRErr OGRPGTableLayer::RunDeferredCreationIfNecessary()
 
     PGconn *hPGConn = poDS->GetPGConn();
 
-    PGresult *hResult = OGRPG_PQexec(hPGConn, osCommand.c_str());
+    PGresult *hResult = OGRPG_PQexec(poDS, osCommand.c_str());
     if( PQresultStatus(hResult) != PGRES_COMMAND_OK )
     {
         CPLError( CE_Failure, CPLE_AppDefined,
@@ -35,9 +35,13 @@ CPL_CVSID("$Id$");
 /*                         OGRPG_PQexec()                               */
 /************************************************************************/
 
-PGresult *OGRPG_PQexec(PGconn *conn, const char *query, int bMultipleCommandAllowed,
-                       int bErrorAsDebug)
+PGresult *OGRPG_PQexec(OGRPGDataSource *poDS, const char *query,
+                       int bMultipleCommandAllowed, int bErrorAsDebug)
 {
+    poDS->FinishPendingQuery();
+
+    PGconn *conn = poDS->GetPGConn();
+
     PGresult* hResult = bMultipleCommandAllowed
         ? PQexec(conn, query)
         : PQexecParams(conn, query, 0, NULL, NULL, NULL, NULL, 0);
@@ -90,12 +94,13 @@ PGresult *OGRPG_PQexec(PGconn *conn, const char *query, int bMultipleCommandAllo
 /*                       OGRPG_Check_Table_Exists()                     */
 /************************************************************************/
 
-bool OGRPG_Check_Table_Exists(PGconn *hPGConn, const char * pszTableName)
+bool OGRPG_Check_Table_Exists(OGRPGDataSource *poDS,
+                              const char * pszTableName)
 {
     CPLString osSQL;
     osSQL.Printf("SELECT 1 FROM information_schema.tables WHERE table_name = %s LIMIT 1",
-                 OGRPGEscapeString(hPGConn, pszTableName).c_str());
-    PGresult* hResult = OGRPG_PQexec(hPGConn, osSQL);
+                 OGRPGEscapeString(poDS->GetPGConn(), pszTableName).c_str());
+    PGresult* hResult = OGRPG_PQexec(poDS, osSQL);
     bool bRet = ( hResult && PQntuples(hResult) == 1 );
     if( !bRet )
         CPLDebug("PG", "Does not have %s table", pszTableName);
@@ -32,10 +32,19 @@
 
 #include "libpq-fe.h"
 
-PGresult *OGRPG_PQexec(PGconn *conn, const char *query,
+class OGRPGDataSource;
+
+PGresult *OGRPG_PQexec(OGRPGDataSource *poDS, const char *query,
                        int bMultipleCommandAllowed = FALSE,
                        int bErrorAsDebug = FALSE);
 
+/* An asynchronous query (PQsendQuery()) may be pending on a connection, */
+/* typically the prefetch of the next page of a cursor. Its owner */
+/* registers with OGRPGDataSource::SetPendingQuery() a callback that is */
+/* called to collect its result before any other request is emitted on */
+/* the connection. */
+typedef void (*OGRPGPendingQueryFunc)( void* pUserData );
+
 /************************************************************************/
 /*                            OGRPGClearResult                          */
 /*                                                                      */
@@ -53,7 +62,8 @@ inline void OGRPGClearResult( PGresult*& hResult )
     }
 }
 
-bool OGRPG_Check_Table_Exists(PGconn *hPGConn, const char * pszTableName);
+bool OGRPG_Check_Table_Exists(OGRPGDataSource *poDS,
+                              const char * pszTableName);
 
 #endif /* ndef OGRPGUTILITY_H_INCLUDED */
 
@@ -50,6 +50,10 @@
 OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                                OGRFeatureDefn * poDefn, int iShape,
                                SHPObject *psShape, const char *pszSHPEncoding );
+bool SHPReadOGRFeatureToBatch( SHPHandle hSHP, DBFHandle hDBF,
+                               OGRFeatureDefn * poDefn, int iShape,
+                               const char *pszSHPEncoding,
+                               OGRFeatureBatch *poBatch );
 OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape );
 OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
                                        SHPHandle hSHP, DBFHandle hDBF,
@@ -136,6 +140,32 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
 
     bool                bSbnSbxDeleted;
 
+    // In-memory index of the shape bounding boxes, built on the first
+    // spatial query when there is no .qix or .sbn, with 4 floats per shape
+    // and per block of consecutive shapes.
+    std::vector<float>  m_afMemIndexBounds;
+    std::vector<float>  m_afMemIndexBlockBounds;
+    bool                m_bCheckedForMemIndex;
+    bool                BuildMemSpatialIndex();
+    int                *SearchMemSpatialIndex( const OGREnvelope& sEnvelope,
+                                               int* pnCount );
+
+    // Bounding boxes of the shapes read ahead, to skip the shapes outside
+    // of the spatial filter during sequential reading.
+    bool                m_bUseBoundsPrefilter;
+    int                 m_iBoundsCacheFirst;
+    std::vector<int>    m_anBoundsCacheType;
+    std::vector<OGREnvelope> m_asBoundsCacheEnvelope;
+    bool                IsShapeOutsideFilter( int iShape );
+
+    void                ReadShapesBounds( int iFirstShape, int nShapes,
+                                          int* panSHPType,
+                                          OGREnvelope* pasEnvelopes );
+    void                ClearShapeBoundsIndex();
+
+    // Results of the attribute filter on the features of a batch.
+    std::vector<GByte>  m_abyBatchMatches;
+
     CPLString           ConvertCodePage( const char * );
     CPLString           osEncoding;
 
@@ -192,6 +222,9 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
 
     const char         *GetFullName() { return pszFullName; }
 
+    void                InitializeAttributeIndex();
+    void                InvalidateAttributeIndexes();
+
     OGRFeature *        FetchShape( int iShapeId );
     int                 GetFeatureCountWithSpatialFilterOnly();
 
@@ -207,6 +240,8 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
 
     void                ResetReading() override;
     OGRFeature *        GetNextFeature() override;
+    int                 GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                         int nMaxFeatures ) override;
     virtual OGRErr      SetNextByIndex( GIntBig nIndex ) override;
 
     OGRFeature         *GetFeature( GIntBig nFeatureId ) override;
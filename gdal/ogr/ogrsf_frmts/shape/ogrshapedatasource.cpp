@@ -1062,7 +1062,7 @@ OGRLayer * OGRShapeDataSource::ExecuteSQL( const char *pszStatement,
             OGRShapeLayer *poLayer = dynamic_cast<OGRShapeLayer *>(
                 GetLayerByName(papszTokens[3]));
             if( poLayer != NULL )
-                poLayer->InitializeIndexSupport( poLayer->GetFullName() );
+                poLayer->InitializeAttributeIndex();
         }
         CSLDestroy( papszTokens );
 
@@ -1167,6 +1167,7 @@ OGRErr OGRShapeDataSource::DeleteLayer( int iLayer )
     VSIUnlink( CPLResetExtension(pszFilename, "dbf") );
     VSIUnlink( CPLResetExtension(pszFilename, "prj") );
     VSIUnlink( CPLResetExtension(pszFilename, "qix") );
+    VSIUnlink( CPLResetExtension(pszFilename, "oix") );
 
     CPLFree( pszFilename );
 
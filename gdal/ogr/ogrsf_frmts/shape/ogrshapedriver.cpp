@@ -211,7 +211,7 @@ static CPLErr OGRShapeDriverDelete( const char *pszDataSource )
 
     static const char * const apszExtensions[] =
         { "shp", "shx", "dbf", "sbn", "sbx", "prj", "idm", "ind",
-          "qix", "cpg", NULL };
+          "qix", "cpg", "oix", NULL };
 
     if( VSI_ISREG(sStatBuf.st_mode)
         && (EQUAL(CPLGetExtension(pszDataSource), "shp")
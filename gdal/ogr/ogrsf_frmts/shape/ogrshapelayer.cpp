@@ -32,9 +32,20 @@
 #include "cpl_conv.h"
 #include "cpl_string.h"
 #include "cpl_time.h"
+#include "ogr_attrind.h"
 #include "ogr_p.h"
 
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+
+// Number of consecutive shapes grouped in a block of the in-memory index.
+#define SHAPE_MEM_INDEX_BLOCK_SIZE 64
+
+// Number of shapes whose bounding box is read ahead when scanning a layer
+// without index.
+#define SHAPE_BOUNDS_CACHE_SIZE 1024
 
 static const char UNSUPPORTED_OP_READ_ONLY[] =
     "%s : unsupported operation on a read-only datasource.";
@@ -73,6 +84,9 @@ OGRShapeLayer::OGRShapeLayer( OGRShapeDataSource* poDSIn,
     bCheckedForSBN(false),
     hSBN(NULL),
     bSbnSbxDeleted(false),
+    m_bCheckedForMemIndex(false),
+    m_bUseBoundsPrefilter(false),
+    m_iBoundsCacheFirst(0),
     bTruncationWarningEmitted(false),
     bHSHPWasNonNULL(hSHPIn != NULL),
     bHDBFWasNonNULL(hDBFIn != NULL),
@@ -466,6 +480,48 @@ bool OGRShapeLayer::CheckForSBN()
     return hSBN != NULL;
 }
 
+/************************************************************************/
+/*                      InitializeAttributeIndex()                      */
+/*                                                                      */
+/*      Attribute indexes are attached to the .dbf file, whose          */
+/*      modifications make them obsolete.                               */
+/************************************************************************/
+
+void OGRShapeLayer::InitializeAttributeIndex()
+
+{
+    if( m_poAttrIndex != NULL )
+        return;
+
+    CPLString osDBFFilename = pszFullName;
+    if( !EQUAL(CPLGetExtension(pszFullName), "dbf") )
+    {
+        osDBFFilename = CPLResetExtension( pszFullName, "dbf" );
+        VSIStatBufL sStat;
+        if( VSIStatL( osDBFFilename, &sStat ) != 0 )
+        {
+            const CPLString osDBFUpper =
+                CPLResetExtension( pszFullName, "DBF" );
+            if( VSIStatL( osDBFUpper, &sStat ) == 0 )
+                osDBFFilename = osDBFUpper;
+        }
+    }
+
+    InitializeIndexSupport( osDBFFilename );
+}
+
+/************************************************************************/
+/*                     InvalidateAttributeIndexes()                     */
+/************************************************************************/
+
+void OGRShapeLayer::InvalidateAttributeIndexes()
+
+{
+    InitializeAttributeIndex();
+    if( m_poAttrIndex != NULL )
+        m_poAttrIndex->InvalidateIndexes();
+}
+
 /************************************************************************/
 /*                            ScanIndices()                             */
 /*                                                                      */
@@ -477,6 +533,7 @@ bool OGRShapeLayer::ScanIndices()
 
 {
     iMatchingFID = 0;
+    m_bUseBoundsPrefilter = false;
 
 /* -------------------------------------------------------------------- */
 /*      Utilize attribute index if appropriate.                         */
@@ -485,7 +542,7 @@ bool OGRShapeLayer::ScanIndices()
     {
         CPLAssert( panMatchingFIDs == NULL );
 
-        InitializeIndexSupport( pszFullName );
+        InitializeAttributeIndex();
 
         panMatchingFIDs =
             m_poAttrQuery->EvaluateAgainstIndices( this, NULL );
@@ -568,6 +625,27 @@ bool OGRShapeLayer::ScanIndices()
         m_poFilterGeomLastValid = m_poFilterGeom->clone();
     }
 
+/* -------------------------------------------------------------------- */
+/*      Otherwise use an in-memory index of the bounding boxes of the   */
+/*      shapes, built on the first spatial query.                       */
+/* -------------------------------------------------------------------- */
+    else if( bTryQIXorSBN && panSpatialFIDs == NULL &&
+             BuildMemSpatialIndex() )
+    {
+        panSpatialFIDs = SearchMemSpatialIndex( oSpatialFilterEnvelope,
+                                                &nSpatialFIDCount );
+
+        CPLDebug( "SHAPE", "Used in-memory spatial index, got %d matches.",
+                  nSpatialFIDCount );
+
+        delete m_poFilterGeomLastValid;
+        m_poFilterGeomLastValid = m_poFilterGeom->clone();
+    }
+
+    // Without index, shapes are rejected from their bounding box only.
+    if( bTryQIXorSBN && panSpatialFIDs == NULL )
+        m_bUseBoundsPrefilter = true;
+
 /* -------------------------------------------------------------------- */
 /*      Use spatial index if appropriate.                               */
 /* -------------------------------------------------------------------- */
@@ -615,6 +693,375 @@ bool OGRShapeLayer::ScanIndices()
     return true;
 }
 
+/************************************************************************/
+/*                          ReadShapesBounds()                          */
+/*                                                                      */
+/*      Read the type and the bounding box of consecutive shapes from   */
+/*      their record header, without reading their vertices. The       */
+/*      headers of neighbouring records are fetched with a single read. */
+/*      The bounding box of a point is the point itself. The type is    */
+/*      set to -1 for shapes whose header could not be read.            */
+/************************************************************************/
+
+void OGRShapeLayer::ReadShapesBounds( int iFirstShape, int nShapes,
+                                      int* panSHPType,
+                                      OGREnvelope* pasEnvelopes )
+
+{
+    // Record header, shape type and bounding box (or point coordinates).
+    const unsigned int nHeaderSize = 8 + 4 + 8 * 4;
+    const unsigned int nBufSize = 65536;
+    std::vector<GByte> abyBuf(nBufSize);
+    vsi_l_offset nBufOffset = 0;
+    size_t nBufLen = 0;
+
+    for( int i = 0; i < nShapes; i++ )
+    {
+        const int iShape = iFirstShape + i;
+        panSHPType[i] = -1;
+
+        // Offset not yet known in the lazy shx loading case.
+        const unsigned int nOffset = hSHP->panRecOffset[iShape];
+        if( nOffset == 0 )
+            continue;
+        const size_t nNeeded =
+            8 + std::min(nHeaderSize - 8, hSHP->panRecSize[iShape]);
+        if( nNeeded < 8 + 4 )
+            continue;
+
+        if( nOffset < nBufOffset || nOffset + nNeeded > nBufOffset + nBufLen )
+        {
+            // Read the headers of the following records as well, as long
+            // as they fit in the buffer.
+            size_t nToRead = nHeaderSize;
+            for( int j = i + 1; j < nShapes; j++ )
+            {
+                const unsigned int nOtherOffset =
+                    hSHP->panRecOffset[iFirstShape + j];
+                if( nOtherOffset < nOffset ||
+                    nOtherOffset - nOffset > nBufSize - nHeaderSize )
+                    break;
+                nToRead = nOtherOffset - nOffset + nHeaderSize;
+            }
+
+            nBufOffset = nOffset;
+            nBufLen = 0;
+            if( hSHP->sHooks.FSeek( hSHP->fpSHP, nOffset, 0 ) != 0 )
+                continue;
+            nBufLen = hSHP->sHooks.FRead( &abyBuf[0], 1, nToRead,
+                                          hSHP->fpSHP );
+            if( nBufLen < nNeeded )
+                continue;
+        }
+
+        const GByte* pabyRec = &abyBuf[0] + (nOffset - nBufOffset) + 8;
+        int nSHPType = 0;
+        memcpy(&nSHPType, pabyRec, 4);
+        CPL_LSBPTR32(&nSHPType);
+        OGREnvelope& sEnvelope = pasEnvelopes[i];
+        if( nSHPType == SHPT_NULL )
+        {
+            // Nothing to read.
+        }
+        else if( nSHPType == SHPT_POINT || nSHPType == SHPT_POINTZ ||
+                 nSHPType == SHPT_POINTM )
+        {
+            if( nNeeded < 8 + 4 + 8 * 2 )
+                continue;
+            memcpy(&(sEnvelope.MinX), pabyRec + 4, 8);
+            memcpy(&(sEnvelope.MinY), pabyRec + 12, 8);
+            CPL_LSBPTR64(&(sEnvelope.MinX));
+            CPL_LSBPTR64(&(sEnvelope.MinY));
+            sEnvelope.MaxX = sEnvelope.MinX;
+            sEnvelope.MaxY = sEnvelope.MinY;
+        }
+        else
+        {
+            if( nNeeded < nHeaderSize )
+                continue;
+            memcpy(&(sEnvelope.MinX), pabyRec + 4, 8);
+            memcpy(&(sEnvelope.MinY), pabyRec + 12, 8);
+            memcpy(&(sEnvelope.MaxX), pabyRec + 20, 8);
+            memcpy(&(sEnvelope.MaxY), pabyRec + 28, 8);
+            CPL_LSBPTR64(&(sEnvelope.MinX));
+            CPL_LSBPTR64(&(sEnvelope.MinY));
+            CPL_LSBPTR64(&(sEnvelope.MaxX));
+            CPL_LSBPTR64(&(sEnvelope.MaxY));
+        }
+        panSHPType[i] = nSHPType;
+    }
+}
+
+/************************************************************************/
+/*                        OGRShapeBoundsUsable()                        */
+/*                                                                      */
+/*      Whether a shape can be rejected by a spatial filter from the    */
+/*      bounding box of its header. As in FetchShape(), degenerate      */
+/*      bounds of non-point shapes, and null shapes, are not trusted.   */
+/************************************************************************/
+
+static bool OGRShapeBoundsUsable( int nSHPType, const OGREnvelope& sEnvelope )
+{
+    if( nSHPType < 0 || nSHPType == SHPT_NULL )
+        return false;
+    if( nSHPType == SHPT_POINT || nSHPType == SHPT_POINTZ ||
+        nSHPType == SHPT_POINTM )
+        return true;
+    return sEnvelope.MinX != sEnvelope.MaxX &&
+           sEnvelope.MinY != sEnvelope.MaxY;
+}
+
+/************************************************************************/
+/*                   OGRShapeFloatDown() / OGRShapeFloatUp()            */
+/*                                                                      */
+/*      Round a double to a float that is not greater (resp. lesser).   */
+/************************************************************************/
+
+static float OGRShapeFloatDown( double dfVal )
+{
+    if( !(dfVal >= -FLT_MAX) )  // also NaN
+        return -std::numeric_limits<float>::infinity();
+    if( dfVal > FLT_MAX )
+        return FLT_MAX;
+    float fVal = static_cast<float>(dfVal);
+    if( fVal > dfVal )
+        fVal = std::nextafter(fVal, -std::numeric_limits<float>::infinity());
+    return fVal;
+}
+
+static float OGRShapeFloatUp( double dfVal )
+{
+    if( !(dfVal <= FLT_MAX) )  // also NaN
+        return std::numeric_limits<float>::infinity();
+    if( dfVal < -FLT_MAX )
+        return -FLT_MAX;
+    float fVal = static_cast<float>(dfVal);
+    if( fVal < dfVal )
+        fVal = std::nextafter(fVal, std::numeric_limits<float>::infinity());
+    return fVal;
+}
+
+/************************************************************************/
+/*                        BuildMemSpatialIndex()                        */
+/*                                                                      */
+/*      Build an in-memory index from the bounding boxes stored in the  */
+/*      record headers: 4 floats per shape, rounded outwards, and the   */
+/*      union of the bounding boxes of blocks of consecutive shapes.    */
+/*      Shapes whose bounding box cannot be trusted get an infinite     */
+/*      one.                                                            */
+/************************************************************************/
+
+bool OGRShapeLayer::BuildMemSpatialIndex()
+
+{
+    if( m_bCheckedForMemIndex )
+        return !m_afMemIndexBounds.empty();
+    m_bCheckedForMemIndex = true;
+
+    const int nShapes = std::min(nTotalShapeCount, hSHP->nRecords);
+    if( nShapes == 0 ||
+        !CPLTestBool(CPLGetConfigOption("SHAPE_IN_MEMORY_SPATIAL_INDEX",
+                                        "YES")) )
+    {
+        return false;
+    }
+
+    // Do not read all the record headers in the lazy shx loading case
+    // (/vsicurl/), and limit the memory used to a fraction of the RAM.
+    if( hSHP->panRecOffset[0] == 0 )
+        return false;
+    const GIntBig nMemLimit = CPLGetUsablePhysicalRAM() / 4;
+    const GIntBig nMemNeeded = static_cast<GIntBig>(nShapes) * 4 *
+                                    static_cast<GIntBig>(sizeof(float));
+    if( nMemLimit > 0 && nMemNeeded > nMemLimit )
+    {
+        CPLDebug("SHAPE", "Too many shapes for an in-memory spatial index");
+        return false;
+    }
+
+    const int nBlocks = (nShapes + SHAPE_MEM_INDEX_BLOCK_SIZE - 1) /
+                                                SHAPE_MEM_INDEX_BLOCK_SIZE;
+    try
+    {
+        m_afMemIndexBounds.resize(static_cast<size_t>(nShapes) * 4);
+        m_afMemIndexBlockBounds.resize(static_cast<size_t>(nBlocks) * 4);
+    }
+    catch( const std::bad_alloc& )
+    {
+        ClearShapeBoundsIndex();
+        m_bCheckedForMemIndex = true;
+        return false;
+    }
+
+    const float fInf = std::numeric_limits<float>::infinity();
+    const int nChunkSize = 4096;
+    std::vector<int> anSHPType(nChunkSize);
+    std::vector<OGREnvelope> asEnvelopes(nChunkSize);
+    for( int iFirst = 0; iFirst < nShapes; iFirst += nChunkSize )
+    {
+        const int nCount = std::min(nChunkSize, nShapes - iFirst);
+        ReadShapesBounds( iFirst, nCount, &anSHPType[0], &asEnvelopes[0] );
+        for( int i = 0; i < nCount; i++ )
+        {
+            float* pafBounds = &m_afMemIndexBounds[
+                                        static_cast<size_t>(iFirst + i) * 4];
+            if( OGRShapeBoundsUsable(anSHPType[i], asEnvelopes[i]) )
+            {
+                pafBounds[0] = OGRShapeFloatDown(asEnvelopes[i].MinX);
+                pafBounds[1] = OGRShapeFloatDown(asEnvelopes[i].MinY);
+                pafBounds[2] = OGRShapeFloatUp(asEnvelopes[i].MaxX);
+                pafBounds[3] = OGRShapeFloatUp(asEnvelopes[i].MaxY);
+            }
+            else
+            {
+                pafBounds[0] = -fInf;
+                pafBounds[1] = -fInf;
+                pafBounds[2] = fInf;
+                pafBounds[3] = fInf;
+            }
+        }
+    }
+
+    for( int iBlock = 0; iBlock < nBlocks; iBlock++ )
+    {
+        float* pafBlockBounds = &m_afMemIndexBlockBounds[
+                                            static_cast<size_t>(iBlock) * 4];
+        pafBlockBounds[0] = fInf;
+        pafBlockBounds[1] = fInf;
+        pafBlockBounds[2] = -fInf;
+        pafBlockBounds[3] = -fInf;
+        const int iEnd = std::min(nShapes,
+                                  (iBlock + 1) * SHAPE_MEM_INDEX_BLOCK_SIZE);
+        for( int iShape = iBlock * SHAPE_MEM_INDEX_BLOCK_SIZE;
+             iShape < iEnd; iShape++ )
+        {
+            const float* pafBounds =
+                &m_afMemIndexBounds[static_cast<size_t>(iShape) * 4];
+            pafBlockBounds[0] = std::min(pafBlockBounds[0], pafBounds[0]);
+            pafBlockBounds[1] = std::min(pafBlockBounds[1], pafBounds[1]);
+            pafBlockBounds[2] = std::max(pafBlockBounds[2], pafBounds[2]);
+            pafBlockBounds[3] = std::max(pafBlockBounds[3], pafBounds[3]);
+        }
+    }
+
+    CPLDebug("SHAPE", "Built in-memory spatial index of %d shapes", nShapes);
+
+    return true;
+}
+
+/************************************************************************/
+/*                       SearchMemSpatialIndex()                        */
+/*                                                                      */
+/*      Return the sorted ids of the shapes whose bounding box          */
+/*      intersects the passed envelope, in an array to free with free() */
+/*      as the result of SHPSearchDiskTreeEx().                         */
+/************************************************************************/
+
+int *OGRShapeLayer::SearchMemSpatialIndex( const OGREnvelope& sEnvelope,
+                                           int* pnCount )
+
+{
+    const int nShapes = static_cast<int>(m_afMemIndexBounds.size() / 4);
+    const int nBlocks = static_cast<int>(m_afMemIndexBlockBounds.size() / 4);
+    std::vector<int> anIds;
+
+    for( int iBlock = 0; iBlock < nBlocks; iBlock++ )
+    {
+        const float* pafBlockBounds =
+            &m_afMemIndexBlockBounds[static_cast<size_t>(iBlock) * 4];
+        if( pafBlockBounds[2] < sEnvelope.MinX ||
+            pafBlockBounds[3] < sEnvelope.MinY ||
+            sEnvelope.MaxX < pafBlockBounds[0] ||
+            sEnvelope.MaxY < pafBlockBounds[1] )
+            continue;
+
+        const int iEnd = std::min(nShapes,
+                                  (iBlock + 1) * SHAPE_MEM_INDEX_BLOCK_SIZE);
+        for( int iShape = iBlock * SHAPE_MEM_INDEX_BLOCK_SIZE;
+             iShape < iEnd; iShape++ )
+        {
+            const float* pafBounds =
+                &m_afMemIndexBounds[static_cast<size_t>(iShape) * 4];
+            if( !(pafBounds[2] < sEnvelope.MinX ||
+                  pafBounds[3] < sEnvelope.MinY ||
+                  sEnvelope.MaxX < pafBounds[0] ||
+                  sEnvelope.MaxY < pafBounds[1]) )
+            {
+                anIds.push_back(iShape);
+            }
+        }
+    }
+
+    *pnCount = static_cast<int>(anIds.size());
+    int* panIds = static_cast<int *>(
+                        malloc(sizeof(int) * std::max<size_t>(1, anIds.size())));
+    if( panIds == NULL )
+    {
+        *pnCount = 0;
+        return NULL;
+    }
+    if( !anIds.empty() )
+        memcpy(panIds, &anIds[0], sizeof(int) * anIds.size());
+    return panIds;
+}
+
+/************************************************************************/
+/*                        IsShapeOutsideFilter()                        */
+/*                                                                      */
+/*      Whether the bounding box of the header of a shape does not      */
+/*      intersect the spatial filter. The bounding boxes of the next    */
+/*      shapes are read at the same time.                               */
+/************************************************************************/
+
+bool OGRShapeLayer::IsShapeOutsideFilter( int iShape )
+
+{
+    if( iShape < m_iBoundsCacheFirst ||
+        iShape >= m_iBoundsCacheFirst +
+                        static_cast<int>(m_anBoundsCacheType.size()) )
+    {
+        if( iShape >= hSHP->nRecords )
+            return false;
+        const int nCount = std::min(SHAPE_BOUNDS_CACHE_SIZE,
+                                    hSHP->nRecords - iShape);
+        m_anBoundsCacheType.resize(nCount);
+        m_asBoundsCacheEnvelope.resize(nCount);
+        m_iBoundsCacheFirst = iShape;
+        ReadShapesBounds( iShape, nCount, &m_anBoundsCacheType[0],
+                          &m_asBoundsCacheEnvelope[0] );
+    }
+
+    const int nSHPType = m_anBoundsCacheType[iShape - m_iBoundsCacheFirst];
+    const OGREnvelope& sEnvelope =
+                    m_asBoundsCacheEnvelope[iShape - m_iBoundsCacheFirst];
+    if( !OGRShapeBoundsUsable(nSHPType, sEnvelope) )
+        return false;
+
+    return m_sFilterEnvelope.MaxX < sEnvelope.MinX
+        || m_sFilterEnvelope.MaxY < sEnvelope.MinY
+        || sEnvelope.MaxX < m_sFilterEnvelope.MinX
+        || sEnvelope.MaxY < m_sFilterEnvelope.MinY;
+}
+
+/************************************************************************/
+/*                       ClearShapeBoundsIndex()                        */
+/*                                                                      */
+/*      Invalidate the in-memory spatial index, the bounding boxes read */
+/*      ahead and the cached spatial query result, when shapes are      */
+/*      modified.                                                       */
+/************************************************************************/
+
+void OGRShapeLayer::ClearShapeBoundsIndex()
+{
+    ClearSpatialFIDs();
+    m_afMemIndexBounds.clear();
+    m_afMemIndexBlockBounds.clear();
+    m_bCheckedForMemIndex = false;
+    m_anBoundsCacheType.clear();
+    m_asBoundsCacheEnvelope.clear();
+    m_iBoundsCacheFirst = 0;
+}
+
 /************************************************************************/
 /*                            ResetReading()                            */
 /************************************************************************/
@@ -746,6 +1193,15 @@ OGRFeature *OGRShapeLayer::FetchShape( int iShapeId )
 
     if( m_poFilterGeom != NULL && hSHP != NULL )
     {
+        // During a sequential scan without index, first check the
+        // bounding box of the record header, to avoid reading the
+        // vertices of the shapes outside of the filter.
+        if( m_bUseBoundsPrefilter && panMatchingFIDs == NULL &&
+            IsShapeOutsideFilter(iShapeId) )
+        {
+            return NULL;
+        }
+
         SHPObject *psShape = SHPReadObject( hSHP, iShapeId );
 
         // do not trust degenerate bounds on non-point geometries
@@ -870,6 +1326,84 @@ OGRFeature *OGRShapeLayer::GetNextFeature()
     }
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRShapeLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                        int nMaxFeatures )
+
+{
+    // Spatial filtering needs an OGRFeature.
+    if( m_poFilterGeom != NULL )
+        return OGRLayer::GetNextFeatureBatch( poBatch, nMaxFeatures );
+
+    poBatch->Reset();
+
+    if( !TouchLayer() )
+        return 0;
+
+    if( !poBatch->IsCompatibleWith( poFeatureDefn ) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Batch not created from the current layer definition" );
+        return 0;
+    }
+
+    // Attribute indices are used by GetNextFeature().
+    if( m_poAttrQuery != NULL && iNextShapeId == 0 && panMatchingFIDs == NULL )
+        ScanIndices();
+    if( panMatchingFIDs != NULL )
+        return OGRLayer::GetNextFeatureBatch( poBatch, nMaxFeatures );
+
+    bool bIOError = false;
+    while( !bIOError && poBatch->GetFeatureCount() < nMaxFeatures &&
+           iNextShapeId < nTotalShapeCount )
+    {
+        const int nFirstNewFeature = poBatch->GetFeatureCount();
+        while( poBatch->GetFeatureCount() < nMaxFeatures &&
+               iNextShapeId < nTotalShapeCount )
+        {
+            if( hDBF )
+            {
+                if( DBFIsRecordDeleted( hDBF, iNextShapeId ) )
+                {
+                    iNextShapeId++;
+                    continue;
+                }
+                if( VSIFEofL(VSI_SHP_GetVSIL(hDBF->fp)) )
+                {
+                    bIOError = true;
+                    break;
+                }
+            }
+
+            if( SHPReadOGRFeatureToBatch( hSHP, hDBF, poFeatureDefn,
+                                          iNextShapeId, osEncoding, poBatch ) )
+            {
+                m_nFeaturesRead++;
+            }
+            iNextShapeId++;
+        }
+
+        // Evaluate the attribute filter on the rows just read, and remove
+        // the ones that do not match it.
+        if( m_poAttrQuery != NULL &&
+            poBatch->GetFeatureCount() > nFirstNewFeature )
+        {
+            m_abyBatchMatches.resize( poBatch->GetFeatureCount() );
+            std::fill( m_abyBatchMatches.begin(),
+                       m_abyBatchMatches.begin() + nFirstNewFeature,
+                       static_cast<GByte>(TRUE) );
+            m_poAttrQuery->EvaluateBatch( poBatch, &m_abyBatchMatches[0],
+                                          nFirstNewFeature );
+            poBatch->Compact( &m_abyBatchMatches[0] );
+        }
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                             GetFeature()                             */
 /************************************************************************/
@@ -929,6 +1463,8 @@ OGRErr OGRShapeLayer::ISetFeature( OGRFeature *poFeature )
     bHeaderDirty = true;
     if( CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
+    ClearShapeBoundsIndex();
+    InvalidateAttributeIndexes();
 
     unsigned int nOffset = 0;
     unsigned int nSize = 0;
@@ -1000,6 +1536,8 @@ OGRErr OGRShapeLayer::DeleteFeature( GIntBig nFID )
     bHeaderDirty = true;
     if( CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
+    ClearShapeBoundsIndex();
+    InvalidateAttributeIndexes();
     m_eNeedRepack = YES;
 
     return OGRERR_NONE;
@@ -1032,6 +1570,8 @@ OGRErr OGRShapeLayer::ICreateFeature( OGRFeature *poFeature )
     bHeaderDirty = true;
     if( CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
+    ClearShapeBoundsIndex();
+    InvalidateAttributeIndexes();
 
     poFeature->SetFID( OGRNullFID );
 
@@ -1366,10 +1906,11 @@ int OGRShapeLayer::GetFeatureCountWithSpatialFilterOnly()
             else
             {
 /* -------------------------------------------------------------------- */
-/*      Fallback to full intersect test (using GEOS) if we still        */
-/*      don't know for sure.                                            */
+/*      Fallback to full intersect test if we still don't know for      */
+/*      sure.                                                           */
 /* -------------------------------------------------------------------- */
-                if( OGRGeometryFactory::haveGEOS() )
+                if( OGRGeometryFactory::haveGEOS() ||
+                    m_poIndexedFilterGeom != NULL )
                 {
                     // Read the full geometry.
                     if( poGeometry == NULL )
@@ -1383,19 +1924,7 @@ int OGRShapeLayer::GetFeatureCountWithSpatialFilterOnly()
                             psShape = NULL;
                         }
                     }
-                    if( poGeometry == NULL )
-                    {
-                        nFeatureCount++;
-                    }
-                    else if( m_pPreparedFilterGeom != NULL )
-                    {
-                        if( OGRPreparedGeometryIntersects(m_pPreparedFilterGeom,
-                                                          poGeometry) )
-                        {
-                            nFeatureCount++;
-                        }
-                    }
-                    else if( m_poFilterGeom->Intersects( poGeometry ) )
+                    if( poGeometry == NULL || FilterGeometry( poGeometry ) )
                         nFeatureCount++;
                 }
                 else
@@ -1559,7 +2088,7 @@ int OGRShapeLayer::TestCapability( const char * pszCap )
 
         if( m_poAttrQuery != NULL )
         {
-            InitializeIndexSupport( pszFullName );
+            InitializeAttributeIndex();
             return m_poAttrQuery->CanUseIndex(this);
         }
         return TRUE;
@@ -1671,6 +2200,8 @@ OGRErr OGRShapeLayer::CreateField( OGRFieldDefn *poFieldDefn, int bApproxOK )
         bDBFJustCreated = true;
     }
 
+    InvalidateAttributeIndexes();
+
     CPLErrorReset();
 
     if( poFeatureDefn->GetFieldCount() == 255 )
@@ -1891,6 +2422,8 @@ OGRErr OGRShapeLayer::DeleteField( int iField )
         return OGRERR_FAILURE;
     }
 
+    InvalidateAttributeIndexes();
+
     if( DBFDeleteField( hDBF, iField ) )
     {
         TruncateDBF();
@@ -1925,6 +2458,8 @@ OGRErr OGRShapeLayer::ReorderFields( int* panMap )
     if( eErr != OGRERR_NONE )
         return eErr;
 
+    InvalidateAttributeIndexes();
+
     if( DBFReorderFields( hDBF, panMap ) )
     {
         return poFeatureDefn->ReorderFieldDefns( panMap );
@@ -1958,6 +2493,8 @@ OGRErr OGRShapeLayer::AlterFieldDefn( int iField, OGRFieldDefn* poNewFieldDefn,
         return OGRERR_FAILURE;
     }
 
+    InvalidateAttributeIndexes();
+
     OGRFieldDefn* poFieldDefn = poFeatureDefn->GetFieldDefn(iField);
     OGRFieldType eType = poFieldDefn->GetType();
 
@@ -2212,7 +2749,12 @@ OGRErr OGRShapeLayer::SyncToDisk()
             SHPWriteHeader( hSHP );
 
         if( hDBF != NULL )
+        {
             DBFUpdateHeader( hDBF );
+            // Nothing left to write on close, so that the .dbf is not
+            // touched after its attribute indexes have been built.
+            hDBF->bUpdated = FALSE;
+        }
 
         bHeaderDirty = false;
     }
@@ -3020,6 +3562,8 @@ OGRErr OGRShapeLayer::Repack()
     if( hDBF != NULL )
         nTotalShapeCount = hDBF->nRecords;
     bSHPNeedsRepack = false;
+    ClearShapeBoundsIndex();
+    InvalidateAttributeIndexes();
     m_eNeedRepack = NO;
 
     return OGRERR_NONE;
@@ -3054,6 +3598,8 @@ OGRErr OGRShapeLayer::ResizeDBF()
         return OGRERR_FAILURE;
     }
 
+    InvalidateAttributeIndexes();
+
     /* Look which columns must be examined */
     int *panColMap = static_cast<int *>(
         CPLMalloc(poFeatureDefn->GetFieldCount() * sizeof(int)));
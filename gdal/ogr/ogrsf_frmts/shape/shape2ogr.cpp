@@ -1174,6 +1174,42 @@ OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
     return poDefn;
 }
 
+/************************************************************************/
+/*                      SHPSetGeometryDimension()                       */
+/*                                                                      */
+/*      Set/unset the Z and M flags of a geometry read from a shape     */
+/*      according to the geometry type of the layer.                    */
+/************************************************************************/
+
+static void SHPSetGeometryDimension( OGRGeometry *poGeometry,
+                                     OGRFeatureDefn *poDefn )
+{
+    const OGRwkbGeometryType eMyGeomType =
+        poDefn->GetGeomFieldDefn(0)->GetType();
+
+    if( eMyGeomType != wkbUnknown )
+    {
+        OGRwkbGeometryType eGeomInType =
+            poGeometry->getGeometryType();
+        if( wkbHasZ(eMyGeomType) && !wkbHasZ(eGeomInType) )
+        {
+            poGeometry->set3D(TRUE);
+        }
+        else if( !wkbHasZ(eMyGeomType) && wkbHasZ(eGeomInType) )
+        {
+            poGeometry->set3D(FALSE);
+        }
+        if( wkbHasM(eMyGeomType) && !wkbHasM(eGeomInType) )
+        {
+            poGeometry->setMeasured(TRUE);
+        }
+        else if( !wkbHasM(eMyGeomType) && wkbHasM(eGeomInType) )
+        {
+            poGeometry->setMeasured(FALSE);
+        }
+    }
+}
+
 /************************************************************************/
 /*                         SHPReadOGRFeature()                          */
 /************************************************************************/
@@ -1225,33 +1261,7 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
             // It is NOT required here to test poGeometry == NULL.
 
             if( poGeometry )
-            {
-                // Set/unset flags.
-                const OGRwkbGeometryType eMyGeomType =
-                    poFeature->GetDefnRef()->GetGeomFieldDefn(0)->GetType();
-
-                if( eMyGeomType != wkbUnknown )
-                {
-                    OGRwkbGeometryType eGeomInType =
-                        poGeometry->getGeometryType();
-                    if( wkbHasZ(eMyGeomType) && !wkbHasZ(eGeomInType) )
-                    {
-                        poGeometry->set3D(TRUE);
-                    }
-                    else if( !wkbHasZ(eMyGeomType) && wkbHasZ(eGeomInType) )
-                    {
-                        poGeometry->set3D(FALSE);
-                    }
-                    if( wkbHasM(eMyGeomType) && !wkbHasM(eGeomInType) )
-                    {
-                        poGeometry->setMeasured(TRUE);
-                    }
-                    else if( !wkbHasM(eMyGeomType) && wkbHasM(eGeomInType) )
-                    {
-                        poGeometry->setMeasured(FALSE);
-                    }
-                }
-            }
+                SHPSetGeometryDimension( poGeometry, poDefn );
 
             poFeature->SetGeometryDirectly( poGeometry );
         }
@@ -1363,6 +1373,126 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
     return poFeature;
 }
 
+/************************************************************************/
+/*                      SHPReadOGRFeatureToBatch()                      */
+/*                                                                      */
+/*      Same as SHPReadOGRFeature(), but append the shape to a batch    */
+/*      instead of creating an OGRFeature. The geometry still goes      */
+/*      through an OGRGeometry, as rings must be organized into         */
+/*      polygons, but the attributes are directly copied from the DBF   */
+/*      record buffer into the columns of the batch.                    */
+/************************************************************************/
+
+bool SHPReadOGRFeatureToBatch( SHPHandle hSHP, DBFHandle hDBF,
+                               OGRFeatureDefn * poDefn, int iShape,
+                               const char *pszSHPEncoding,
+                               OGRFeatureBatch *poBatch )
+
+{
+    if( iShape < 0
+        || (hSHP != NULL && iShape >= hSHP->nRecords)
+        || (hDBF != NULL && iShape >= hDBF->nRecords) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Attempt to read shape with feature id (%d) out of available"
+                  " range.", iShape );
+        return false;
+    }
+
+    poBatch->AddFeature();
+    poBatch->SetFID( iShape );
+
+    if( hSHP != NULL && !poDefn->IsGeometryIgnored() )
+    {
+        OGRGeometry* poGeometry = SHPReadOGRObject( hSHP, iShape, NULL );
+        if( poGeometry )
+        {
+            SHPSetGeometryDimension( poGeometry, poDefn );
+            poBatch->SetGeomField( 0, poGeometry );
+            delete poGeometry;
+        }
+    }
+
+    for( int iField = 0;
+         hDBF != NULL && iField < poDefn->GetFieldCount();
+         iField++ )
+    {
+        const OGRFieldDefn * const poFieldDefn = poDefn->GetFieldDefn(iField);
+        if( poFieldDefn->IsIgnored() )
+            continue;
+
+        switch( poFieldDefn->GetType() )
+        {
+          case OFTString:
+          {
+              const char * const pszFieldVal =
+                  DBFReadStringAttribute( hDBF, iShape, iField );
+              if( pszFieldVal != NULL && pszFieldVal[0] != '\0' )
+              {
+                if( pszSHPEncoding[0] != '\0' )
+                {
+                    char * const pszUTF8Field =
+                        CPLRecode( pszFieldVal, pszSHPEncoding, CPL_ENC_UTF8);
+                    poBatch->SetField( iField, pszUTF8Field );
+                    CPLFree( pszUTF8Field );
+                }
+                else
+                    poBatch->SetField( iField, pszFieldVal );
+              }
+              break;
+          }
+          case OFTInteger:
+          case OFTInteger64:
+          case OFTReal:
+          {
+              if( !DBFIsAttributeNULL( hDBF, iShape, iField ) )
+              {
+                  poBatch->SetField(
+                      iField,
+                      DBFReadStringAttribute( hDBF, iShape, iField ) );
+              }
+              break;
+          }
+          case OFTDate:
+          {
+              if( DBFIsAttributeNULL( hDBF, iShape, iField ) )
+                  continue;
+
+              const char* const pszDateValue =
+                  DBFReadStringAttribute(hDBF,iShape,iField);
+              if( pszDateValue[0] == '\0' )
+                  continue;
+
+              OGRField sFld;
+              memset( &sFld, 0, sizeof(sFld) );
+
+              if( strlen(pszDateValue) >= 10 &&
+                  pszDateValue[2] == '/' && pszDateValue[5] == '/' )
+              {
+                  sFld.Date.Month = static_cast<GByte>(atoi(pszDateValue + 0));
+                  sFld.Date.Day   = static_cast<GByte>(atoi(pszDateValue + 3));
+                  sFld.Date.Year  = static_cast<GInt16>(atoi(pszDateValue + 6));
+              }
+              else
+              {
+                  const int nFullDate = atoi(pszDateValue);
+                  sFld.Date.Year = static_cast<GInt16>(nFullDate / 10000);
+                  sFld.Date.Month = static_cast<GByte>((nFullDate / 100) % 100);
+                  sFld.Date.Day = static_cast<GByte>(nFullDate % 100);
+              }
+
+              poBatch->SetField( iField, &sFld );
+          }
+          break;
+
+          default:
+            CPLAssert( false );
+        }
+    }
+
+    return true;
+}
+
 /************************************************************************/
 /*                             GrowField()                              */
 /************************************************************************/
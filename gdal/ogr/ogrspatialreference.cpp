@@ -7220,6 +7220,8 @@ void OSRCleanup( void )
 
 {
     CleanupESRIDatumMappingTable();
+    OSRCleanupEPSGCache();
+    OSRCleanupDictIndexes();
     CSVDeaccess( NULL );
     OCTCleanupProjMutex();
     CleanupSRSWGS84Thread();
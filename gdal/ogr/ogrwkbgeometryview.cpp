@@ -0,0 +1,614 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  OGRWKBGeometryView: read-only access to a WKB geometry.
+ * Author:   agent, <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "ogr_p.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "ogr_core.h"
+#include "ogr_geometry.h"
+
+CPL_CVSID("$Id$")
+
+/************************************************************************/
+/*                         OGRWKBGeometryView()                         */
+/************************************************************************/
+
+OGRWKBGeometryView::OGRWKBGeometryView() :
+    m_pabyData(NULL),
+    m_nSize(0),
+    m_nWkbSize(0),
+    m_eGeomType(wkbUnknown),
+    m_nPointCount(0),
+    m_nOffset(0),
+    m_nDepth(0),
+    m_bError(false),
+    m_pabyCoords(NULL),
+    m_nPointsLeft(0),
+    m_nDim(2),
+    m_bHasZ(false),
+    m_bHasM(false),
+    m_bSwap(false),
+    m_bIsPoint(false),
+    m_bIsCircular(false)
+{
+}
+
+/************************************************************************/
+/*                          ReadGeometryType()                          */
+/*                                                                      */
+/*      Decode the geometry type of a WKB header, with a fast path      */
+/*      for the usual OGC and ISO codes.                                */
+/************************************************************************/
+
+static bool ReadGeometryType( const GByte* pabyData, bool& bSwap,
+                              OGRwkbGeometryType& eFlatType,
+                              bool& bHasZ, bool& bHasM )
+{
+    const int nByteOrder = DB2_V72_FIX_BYTE_ORDER(pabyData[0]);
+    if( nByteOrder != wkbNDR && nByteOrder != wkbXDR )
+        return false;
+    bSwap = OGR_SWAP(static_cast<OGRwkbByteOrder>(nByteOrder));
+
+    GUInt32 nRawType = 0;
+    memcpy(&nRawType, pabyData + 1, 4);
+    if( bSwap )
+        CPL_SWAP32PTR(&nRawType);
+    if( nRawType < 4000 )
+    {
+        eFlatType = static_cast<OGRwkbGeometryType>(nRawType % 1000);
+        bHasZ = nRawType / 1000 == 1 || nRawType / 1000 == 3;
+        bHasM = nRawType / 1000 == 2 || nRawType / 1000 == 3;
+        return true;
+    }
+
+    OGRwkbGeometryType eGeomType = wkbUnknown;
+    if( OGRReadWKBGeometryType(const_cast<GByte*>(pabyData), wkbVariantIso,
+                               &eGeomType) != OGRERR_NONE )
+    {
+        return false;
+    }
+    eFlatType = wkbFlatten(eGeomType);
+    bHasZ = CPL_TO_BOOL(OGR_GT_HasZ(eGeomType));
+    bHasM = CPL_TO_BOOL(OGR_GT_HasM(eGeomType));
+    return true;
+}
+
+/************************************************************************/
+/*                                Init()                                */
+/************************************************************************/
+
+/**
+ * \brief Attach the view to a WKB buffer.
+ *
+ * The buffer is validated once, and must remain valid as long as the view
+ * is used. It is not copied. No error is emitted: the caller decides how
+ * to report an invalid geometry. ISO, PostGIS 1 and old-style OGC (25D bit)
+ * geometry type codes are recognized, as with
+ * OGRGeometryFactory::createFromWkb().
+ *
+ * @param pabyData WKB buffer.
+ * @param nSize size of the buffer in bytes. It may be larger than the WKB
+ * geometry (see WkbSize()).
+ *
+ * @return OGRERR_NONE, OGRERR_NOT_ENOUGH_DATA or OGRERR_CORRUPT_DATA.
+ */
+
+OGRErr OGRWKBGeometryView::Init( const GByte* pabyData, size_t nSize )
+{
+    m_pabyData = pabyData;
+    m_nSize = nSize;
+    m_nWkbSize = 0;
+    m_nPointCount = 0;
+    m_eGeomType = wkbUnknown;
+
+    if( pabyData == NULL || nSize < 5 )
+    {
+        m_pabyData = NULL;
+        return OGRERR_NOT_ENOUGH_DATA;
+    }
+
+    bool bSwap = false;
+    OGRwkbGeometryType eFlatType = wkbUnknown;
+    bool bHasZ = false;
+    bool bHasM = false;
+    if( !ReadGeometryType(pabyData, bSwap, eFlatType, bHasZ, bHasM) )
+    {
+        m_pabyData = NULL;
+        return OGRERR_CORRUPT_DATA;
+    }
+    m_eGeomType = OGR_GT_SetModifier(eFlatType, bHasZ, bHasM);
+
+/* -------------------------------------------------------------------- */
+/*      Walk the whole structure to validate it and count points.       */
+/* -------------------------------------------------------------------- */
+    ResetReading();
+    while( NextPointArray() )
+    {
+        if( m_bIsPoint && IsEmptyPoint() )
+            continue;
+        m_nPointCount += m_nPointsLeft;
+    }
+    if( m_bError )
+    {
+        const bool bTruncated = m_nOffset > m_nSize;
+        m_pabyData = NULL;
+        m_nPointCount = 0;
+        return bTruncated ? OGRERR_NOT_ENOUGH_DATA : OGRERR_CORRUPT_DATA;
+    }
+    m_nWkbSize = m_nOffset;
+    ResetReading();
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                            ResetReading()                            */
+/************************************************************************/
+
+/** \brief Restart point iteration from the first point. */
+
+void OGRWKBGeometryView::ResetReading()
+{
+    m_nOffset = 0;
+    m_bError = false;
+    m_pabyCoords = NULL;
+    m_nPointsLeft = 0;
+    m_nDepth = 0;
+    if( m_pabyData != NULL )
+    {
+        // The top level geometry is handled as a single part collection.
+        m_asLevels[0].nRemaining = 1;
+        m_asLevels[0].bRings = false;
+        m_asLevels[0].bHasZ = false;
+        m_asLevels[0].bHasM = false;
+        m_asLevels[0].bSwap = false;
+        m_asLevels[0].nDim = 2;
+        m_nDepth = 1;
+    }
+}
+
+/************************************************************************/
+/*                             ReadUInt32()                             */
+/************************************************************************/
+
+bool OGRWKBGeometryView::ReadUInt32( bool bSwap, GUInt32& nVal )
+{
+    if( m_nSize - m_nOffset < 4 )
+    {
+        m_nOffset = m_nSize + 1;
+        m_bError = true;
+        return false;
+    }
+    memcpy(&nVal, m_pabyData + m_nOffset, 4);
+    if( bSwap )
+        CPL_SWAP32PTR(&nVal);
+    m_nOffset += 4;
+    return true;
+}
+
+/************************************************************************/
+/*                           SetPointArray()                            */
+/************************************************************************/
+
+bool OGRWKBGeometryView::SetPointArray( GUInt32 nCount, int nDim, bool bHasZ,
+                                        bool bHasM, bool bSwap,
+                                        bool bIsPoint )
+{
+    const size_t nPointSize = nDim * sizeof(double);
+    if( nCount > (m_nSize - m_nOffset) / nPointSize )
+    {
+        m_nOffset = m_nSize + 1;
+        m_bError = true;
+        return false;
+    }
+    m_pabyCoords = m_pabyData + m_nOffset;
+    m_nPointsLeft = nCount;
+    m_nDim = nDim;
+    m_bHasZ = bHasZ;
+    m_bHasM = bHasM;
+    m_bSwap = bSwap;
+    m_bIsPoint = bIsPoint;
+    m_bIsCircular = false;
+    m_nOffset += nCount * nPointSize;
+    return true;
+}
+
+/************************************************************************/
+/*                           NextPointArray()                           */
+/*                                                                      */
+/*      Move to the next run of coordinates (a point, a linestring or   */
+/*      a ring), and return false at the end of the geometry or on      */
+/*      error (m_bError set).                                           */
+/************************************************************************/
+
+bool OGRWKBGeometryView::NextPointArray()
+{
+    m_pabyCoords = NULL;
+    m_nPointsLeft = 0;
+    while( m_nDepth > 0 )
+    {
+        Level& sLevel = m_asLevels[m_nDepth - 1];
+        if( sLevel.nRemaining == 0 )
+        {
+            m_nDepth--;
+            continue;
+        }
+        sLevel.nRemaining--;
+
+        if( sLevel.bRings )
+        {
+            GUInt32 nCount = 0;
+            if( !ReadUInt32(sLevel.bSwap, nCount) ||
+                !SetPointArray(nCount, sLevel.nDim, sLevel.bHasZ,
+                               sLevel.bHasM, sLevel.bSwap, false) )
+            {
+                return false;
+            }
+            if( nCount == 0 )
+                continue;
+            return true;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Sub-geometry header.                                            */
+/* -------------------------------------------------------------------- */
+        if( m_nSize - m_nOffset < 5 )
+        {
+            m_nOffset = m_nSize + 1;
+            m_bError = true;
+            return false;
+        }
+        bool bSwap = false;
+        OGRwkbGeometryType eFlatType = wkbUnknown;
+        bool bHasZ = false;
+        bool bHasM = false;
+        if( !ReadGeometryType(m_pabyData + m_nOffset, bSwap, eFlatType,
+                              bHasZ, bHasM) )
+        {
+            m_bError = true;
+            return false;
+        }
+        m_nOffset += 5;
+        const int nDim = 2 + (bHasZ ? 1 : 0) + (bHasM ? 1 : 0);
+
+        switch( eFlatType )
+        {
+            case wkbPoint:
+                if( !SetPointArray(1, nDim, bHasZ, bHasM, bSwap, true) )
+                    return false;
+                return true;
+
+            case wkbLineString:
+            case wkbCircularString:
+            {
+                GUInt32 nCount = 0;
+                if( !ReadUInt32(bSwap, nCount) ||
+                    !SetPointArray(nCount, nDim, bHasZ, bHasM, bSwap, false) )
+                {
+                    return false;
+                }
+                if( nCount == 0 )
+                    continue;
+                m_bIsCircular = eFlatType == wkbCircularString;
+                return true;
+            }
+
+            case wkbPolygon:
+            case wkbTriangle:
+            case wkbMultiPoint:
+            case wkbMultiLineString:
+            case wkbMultiPolygon:
+            case wkbGeometryCollection:
+            case wkbCompoundCurve:
+            case wkbCurvePolygon:
+            case wkbMultiCurve:
+            case wkbMultiSurface:
+            case wkbPolyhedralSurface:
+            case wkbTIN:
+            {
+                const bool bRings = eFlatType == wkbPolygon ||
+                                    eFlatType == wkbTriangle;
+                GUInt32 nCount = 0;
+                if( !ReadUInt32(bSwap, nCount) )
+                    return false;
+                // Each ring takes at least 4 bytes, each part 5.
+                if( nCount > (m_nSize - m_nOffset) / (bRings ? 4 : 5) )
+                {
+                    m_nOffset = m_nSize + 1;
+                    m_bError = true;
+                    return false;
+                }
+                if( m_nDepth == MAX_DEPTH )
+                {
+                    m_bError = true;
+                    return false;
+                }
+                Level& sNewLevel = m_asLevels[m_nDepth];
+                sNewLevel.nRemaining = nCount;
+                sNewLevel.bRings = bRings;
+                sNewLevel.bHasZ = bHasZ;
+                sNewLevel.bHasM = bHasM;
+                sNewLevel.bSwap = bSwap;
+                sNewLevel.nDim = nDim;
+                m_nDepth++;
+                continue;
+            }
+
+            default:
+                m_bError = true;
+                return false;
+        }
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                         ReadDouble(), ReadXY()                       */
+/************************************************************************/
+
+static inline void ReadDouble( const GByte* pabyData, bool bSwap,
+                               double& dfVal )
+{
+    memcpy(&dfVal, pabyData, 8);
+    if( bSwap )
+        CPL_SWAPDOUBLE(&dfVal);
+}
+
+static inline void ReadXY( const GByte* pabyCoords, bool bSwap,
+                           double& dfX, double& dfY )
+{
+    memcpy(&dfX, pabyCoords, 8);
+    memcpy(&dfY, pabyCoords + 8, 8);
+    if( bSwap )
+    {
+        CPL_SWAPDOUBLE(&dfX);
+        CPL_SWAPDOUBLE(&dfY);
+    }
+}
+
+/************************************************************************/
+/*                     ExtendEnvelopeWithCircular()                     */
+/*                                                                      */
+/*      Same as OGRCircularString::ExtendEnvelopeWithCircular(), on     */
+/*      the points of the WKB.                                          */
+/************************************************************************/
+
+static void ExtendEnvelopeWithCircular( const GByte* pabyCoords,
+                                        GUInt32 nPointCount, size_t nStride,
+                                        bool bSwap, OGREnvelope3D* psEnvelope )
+{
+    if( nPointCount < 3 || (nPointCount % 2) == 0 )
+        return;
+
+    for( GUInt32 i = 0; i < nPointCount - 2; i += 2 )
+    {
+        double x0 = 0.0;
+        double y0 = 0.0;
+        double x1 = 0.0;
+        double y1 = 0.0;
+        double x2 = 0.0;
+        double y2 = 0.0;
+        ReadXY(pabyCoords + i * nStride, bSwap, x0, y0);
+        ReadXY(pabyCoords + (i + 1) * nStride, bSwap, x1, y1);
+        ReadXY(pabyCoords + (i + 2) * nStride, bSwap, x2, y2);
+        OGRExtendEnvelopeWithCircularArc(x0, y0, x1, y1, x2, y2,
+                                         psEnvelope);
+    }
+}
+
+/************************************************************************/
+/*                            IsEmptyPoint()                            */
+/*                                                                      */
+/*      Whether the current point array is an empty point, encoded      */
+/*      with NaN coordinates.                                           */
+/************************************************************************/
+
+bool OGRWKBGeometryView::IsEmptyPoint() const
+{
+    double dfX = 0.0;
+    double dfY = 0.0;
+    ReadXY(m_pabyCoords, m_bSwap, dfX, dfY);
+    return CPLIsNan(dfX) && CPLIsNan(dfY);
+}
+
+/************************************************************************/
+/*                              IsEmpty()                               */
+/************************************************************************/
+
+/** \brief Whether the geometry has no point (or the view is not
+ * initialized). */
+
+OGRBoolean OGRWKBGeometryView::IsEmpty() const
+{
+    return m_nPointCount == 0;
+}
+
+/************************************************************************/
+/*                            GetNextPoint()                            */
+/************************************************************************/
+
+/**
+ * \brief Fetch the next point of the geometry.
+ *
+ * All points of all parts and rings are returned in WKB order, except
+ * empty points. Nothing is allocated.
+ *
+ * @param pdfX location where to store the X coordinate.
+ * @param pdfY location where to store the Y coordinate.
+ * @param pdfZ location where to store the Z coordinate (0 if the part has no
+ * Z), or NULL.
+ * @param pdfM location where to store the M value (0 if the part has no M),
+ * or NULL.
+ * @return false when there is no more point.
+ */
+
+bool OGRWKBGeometryView::GetNextPoint( double* pdfX, double* pdfY,
+                                       double* pdfZ, double* pdfM )
+{
+    while( m_nPointsLeft == 0 )
+    {
+        if( !NextPointArray() )
+            return false;
+        if( m_bIsPoint && IsEmptyPoint() )
+            m_nPointsLeft = 0;
+    }
+
+    ReadXY(m_pabyCoords, m_bSwap, *pdfX, *pdfY);
+    if( pdfZ )
+    {
+        *pdfZ = 0.0;
+        if( m_bHasZ )
+            ReadDouble(m_pabyCoords + 16, m_bSwap, *pdfZ);
+    }
+    if( pdfM )
+    {
+        *pdfM = 0.0;
+        if( m_bHasM )
+            ReadDouble(m_pabyCoords + (m_bHasZ ? 24 : 16), m_bSwap, *pdfM);
+    }
+    m_pabyCoords += m_nDim * sizeof(double);
+    m_nPointsLeft--;
+    return true;
+}
+
+/************************************************************************/
+/*                            getEnvelope()                             */
+/************************************************************************/
+
+/**
+ * \brief Compute the 2D envelope of the geometry, directly from the WKB.
+ *
+ * Same result as OGRGeometry::getEnvelope() on the imported geometry.
+ * The envelope is reset (all 0) if the geometry is empty.
+ */
+
+void OGRWKBGeometryView::getEnvelope( OGREnvelope* psEnvelope ) const
+{
+    OGREnvelope3D sEnvelope3D;
+    ComputeEnvelope(&sEnvelope3D, false);
+    psEnvelope->MinX = sEnvelope3D.MinX;
+    psEnvelope->MaxX = sEnvelope3D.MaxX;
+    psEnvelope->MinY = sEnvelope3D.MinY;
+    psEnvelope->MaxY = sEnvelope3D.MaxY;
+}
+
+/**
+ * \brief Compute the 3D envelope of the geometry, directly from the WKB.
+ *
+ * Z bounds are 0 if the geometry has no Z.
+ */
+
+void OGRWKBGeometryView::getEnvelope( OGREnvelope3D* psEnvelope ) const
+{
+    ComputeEnvelope(psEnvelope, true);
+}
+
+/************************************************************************/
+/*                          ComputeEnvelope()                           */
+/************************************************************************/
+
+void OGRWKBGeometryView::ComputeEnvelope( OGREnvelope3D* psEnvelope,
+                                          bool b3D ) const
+{
+    *psEnvelope = OGREnvelope3D();
+    if( m_nPointCount == 0 )
+    {
+        psEnvelope->MinX = 0.0;
+        psEnvelope->MaxX = 0.0;
+        psEnvelope->MinY = 0.0;
+        psEnvelope->MaxY = 0.0;
+        psEnvelope->MinZ = 0.0;
+        psEnvelope->MaxZ = 0.0;
+        return;
+    }
+
+    // Iterate with another view, so that the reading position is left
+    // unchanged.
+    OGRWKBGeometryView oView;
+    oView.m_pabyData = m_pabyData;
+    oView.m_nSize = m_nWkbSize;
+    oView.ResetReading();
+    bool bHasZ = false;
+    while( oView.NextPointArray() )
+    {
+        if( oView.m_bIsPoint && oView.IsEmptyPoint() )
+            continue;
+        const GByte* pabyCoords = oView.m_pabyCoords;
+        const size_t nStride = oView.m_nDim * sizeof(double);
+        const bool bZ = b3D && oView.m_bHasZ;
+        bHasZ |= bZ;
+        const bool bSwap = oView.m_bSwap;
+        double dfMinX = psEnvelope->MinX;
+        double dfMaxX = psEnvelope->MaxX;
+        double dfMinY = psEnvelope->MinY;
+        double dfMaxY = psEnvelope->MaxY;
+        for( GUInt32 i = 0; i < oView.m_nPointsLeft; i++ )
+        {
+            double dfX = 0.0;
+            double dfY = 0.0;
+            ReadXY(pabyCoords + i * nStride, bSwap, dfX, dfY);
+            dfMinX = std::min(dfMinX, dfX);
+            dfMaxX = std::max(dfMaxX, dfX);
+            dfMinY = std::min(dfMinY, dfY);
+            dfMaxY = std::max(dfMaxY, dfY);
+        }
+        if( bZ )
+        {
+            double dfMinZ = psEnvelope->MinZ;
+            double dfMaxZ = psEnvelope->MaxZ;
+            for( GUInt32 i = 0; i < oView.m_nPointsLeft; i++ )
+            {
+                double dfZ = 0.0;
+                ReadDouble(pabyCoords + i * nStride + 16, bSwap, dfZ);
+                dfMinZ = std::min(dfMinZ, dfZ);
+                dfMaxZ = std::max(dfMaxZ, dfZ);
+            }
+            psEnvelope->MinZ = dfMinZ;
+            psEnvelope->MaxZ = dfMaxZ;
+        }
+        psEnvelope->MinX = dfMinX;
+        psEnvelope->MaxX = dfMaxX;
+        psEnvelope->MinY = dfMinY;
+        psEnvelope->MaxY = dfMaxY;
+        if( oView.m_bIsCircular )
+        {
+            ExtendEnvelopeWithCircular(oView.m_pabyCoords,
+                                       oView.m_nPointsLeft, nStride,
+                                       oView.m_bSwap, psEnvelope);
+        }
+    }
+    if( !bHasZ )
+    {
+        psEnvelope->MinZ = 0.0;
+        psEnvelope->MaxZ = 0.0;
+    }
+}
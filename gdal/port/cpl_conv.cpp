@@ -73,6 +73,7 @@
 #endif
 #include <string>
 
+#include "cpl_atomic_ops.h"
 #include "cpl_config.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
@@ -85,6 +86,9 @@ CPL_CVSID("$Id$");
 
 static CPLMutex *hConfigMutex = NULL;
 static volatile char **g_papszConfigOptions = NULL;
+// Incremented each time a configuration option is set, so that callers
+// can cache the values they are interested in.
+static volatile int g_nConfigOptionsGeneration = 0;
 
 // Used by CPLOpenShared() and friends.
 static CPLMutex *hSharedFileMutex = NULL;
@@ -1701,6 +1705,7 @@ void CPLSetConfigOptions(const char* const * papszConfigOptions)
     CSLDestroy(const_cast<char**>(g_papszConfigOptions));
     g_papszConfigOptions = const_cast<volatile char**>(
             CSLDuplicate(const_cast<char**>(papszConfigOptions)));
+    CPLAtomicInc(&g_nConfigOptionsGeneration);
 }
 
 /************************************************************************/
@@ -1773,6 +1778,7 @@ CPLSetConfigOption( const char *pszKey, const char *pszValue )
     g_papszConfigOptions = const_cast<volatile char **>(
         CSLSetNameValue(
             const_cast<char **>(g_papszConfigOptions), pszKey, pszValue));
+    CPLAtomicInc(&g_nConfigOptionsGeneration);
 }
 
 /************************************************************************/
@@ -1829,6 +1835,7 @@ CPLSetThreadLocalConfigOption( const char *pszKey, const char *pszValue )
 
     CPLSetTLSWithFreeFunc(CTLS_CONFIGOPTIONS, papszTLConfigOptions,
                           CPLSetThreadLocalTLSFreeFunc);
+    CPLAtomicInc(&g_nConfigOptionsGeneration);
 }
 
 /************************************************************************/
@@ -1885,6 +1892,28 @@ void CPLSetThreadLocalConfigOptions(const char* const * papszConfigOptions)
     papszTLConfigOptions = CSLDuplicate(const_cast<char**>(papszConfigOptions));
     CPLSetTLSWithFreeFunc(CTLS_CONFIGOPTIONS, papszTLConfigOptions,
                           CPLSetThreadLocalTLSFreeFunc);
+    CPLAtomicInc(&g_nConfigOptionsGeneration);
+}
+
+/************************************************************************/
+/*                   CPLGetConfigOptionsGeneration()                    */
+/************************************************************************/
+
+/**
+  * Return a counter that is incremented each time a configuration option
+  * is set or cleared, globally or in any thread.
+  *
+  * This allows callers in hot code paths to cache the values of the
+  * configuration options they use, and to fetch them again only when the
+  * counter changes. Changes of environment variables made after the
+  * values have been cached are not detected.
+  *
+  * @return the current value of the counter.
+  * @since GDAL 2.3
+  */
+int CPLGetConfigOptionsGeneration()
+{
+    return CPLAtomicAdd(&g_nConfigOptionsGeneration, 0);
 }
 
 /************************************************************************/
@@ -1911,6 +1940,7 @@ void CPL_STDCALL CPLFreeConfig()
     }
     CPLDestroyMutex(hConfigMutex);
     hConfigMutex = NULL;
+    CPLAtomicInc(&g_nConfigOptionsGeneration);
 }
 
 /************************************************************************/
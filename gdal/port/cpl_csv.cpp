@@ -42,13 +42,42 @@
 #include "cpl_multiproc.h"
 #include "gdal_csv.h"
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Restrict to 64bit processors because they are guaranteed to have SSE2.
+#if defined(__x86_64) || defined(_M_X64)
+#define USE_SSE2
+#include <emmintrin.h>
+#endif
+
 CPL_CVSID("$Id$");
 
+/* ==================================================================== */
+/*      A CSVKeyIndex is a hashed index from the values of one key      */
+/*      field of an ingested table to the first line holding that      */
+/*      value.  It is built the first time the table is searched on     */
+/*      this key field with this comparison criteria.                   */
+/* ==================================================================== */
+typedef struct
+{
+    int         iLine;
+    bool        bNonUniqueKey;
+} CSVKeyIndexEntry;
+
+typedef struct
+{
+    int                 iKeyField;
+    CSVCompareCriteria  eCriteria;
+    std::unordered_map<int, CSVKeyIndexEntry> oMapInteger;
+    std::unordered_map<std::string, CSVKeyIndexEntry> oMapString;
+} CSVKeyIndex;
+
 /* ==================================================================== */
 /*      The CSVTable is a persistent set of info about an open CSV      */
-/*      table.  While it doesn't currently maintain a record index,     */
-/*      or in-memory copy of the table, it could be changed to do so    */
-/*      in the future.                                                  */
+/*      table.  Once ingested, it holds an in-memory copy of the        */
+/*      table, and hashed indexes on the key fields searched so far.    */
 /* ==================================================================== */
 typedef struct ctb {
     VSILFILE   *fp;
@@ -64,6 +93,10 @@ typedef struct ctb {
     char      **papszLines;
     int        *panLineIndex;
     char       *pszRawData;
+
+    /* Hashed indexes on key fields of the ingested lines */
+    int          nKeyIndexCount;
+    CSVKeyIndex **papsKeyIndexes;
 } CSVTable;
 
 static void CSVDeaccessInternal( CSVTable **ppsCSVTableList, bool bCanUseTLS,
@@ -114,18 +147,33 @@ static CSVTable *CSVAccess( const char * pszFilename )
     }
 
 /* -------------------------------------------------------------------- */
-/*      Is the table already in the list.                               */
+/*      Is the table already in the list.  Callers generally pass the   */
+/*      filename returned by CSVFilename(), that is the pszFilename     */
+/*      of the table once it is open, so check that first.              */
 /* -------------------------------------------------------------------- */
     for( CSVTable *psTable = *ppsCSVTableList;
          psTable != NULL;
          psTable = psTable->psNext )
+    {
+        if( psTable->pszFilename == pszFilename )
+            return psTable;
+    }
+
+    CSVTable *psPrevTable = NULL;
+    for( CSVTable *psTable = *ppsCSVTableList;
+         psTable != NULL;
+         psPrevTable = psTable, psTable = psTable->psNext )
     {
         if( EQUAL(psTable->pszFilename, pszFilename) )
         {
-            /*
-             * Eventually we should consider promoting to the front of
-             * the list to accelerate frequently accessed tables.
-             */
+            // Promote to the front of the list to accelerate frequently
+            // accessed tables.
+            if( psPrevTable != NULL )
+            {
+                psPrevTable->psNext = psTable->psNext;
+                psTable->psNext = *ppsCSVTableList;
+                *ppsCSVTableList = psTable;
+            }
             return psTable;
         }
     }
@@ -232,6 +280,9 @@ static void CSVDeaccessInternal( CSVTable **ppsCSVTableList, bool bCanUseTLS,
     CPLFree( psTable->panLineIndex );
     CPLFree( psTable->pszRawData );
     CPLFree( psTable->papszLines );
+    for( int i = 0; i < psTable->nKeyIndexCount; i++ )
+        delete psTable->papsKeyIndexes[i];
+    CPLFree( psTable->papsKeyIndexes );
 
     CPLFree( psTable );
 
@@ -253,99 +304,203 @@ void CSVDeaccess( const char * pszFilename )
 }
 
 /************************************************************************/
-/*                            CSVSplitLine()                            */
+/*                      CSVFindDelimiterOrQuote()                       */
 /*                                                                      */
-/*      Tokenize a CSV line into fields in the form of a string         */
-/*      list.  This is used instead of the CPLTokenizeString()          */
-/*      because it provides correct CSV escaping and quoting            */
-/*      semantics.                                                      */
+/*      Return a pointer to the first delimiter or double quote         */
+/*      character in [pszStr, pszEnd[, or pszEnd if there is none.      */
 /************************************************************************/
 
-static char **CSVSplitLine( const char *pszString, char chDelimiter )
+static const char *CSVFindDelimiterOrQuote( const char *pszStr,
+                                            const char *pszEnd,
+                                            char chDelimiter )
+{
+#ifdef USE_SSE2
+    // Test 16 bytes at a time. The scalar loop below locates the exact
+    // position inside the first block that has a match.
+    const __m128i xmmDelimiter = _mm_set1_epi8(chDelimiter);
+    const __m128i xmmQuote = _mm_set1_epi8('"');
+    while( pszEnd - pszStr >= 16 )
+    {
+        const __m128i xmmChars =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(pszStr));
+        const __m128i xmmMatch =
+            _mm_or_si128(_mm_cmpeq_epi8(xmmChars, xmmDelimiter),
+                         _mm_cmpeq_epi8(xmmChars, xmmQuote));
+        if( _mm_movemask_epi8(xmmMatch) != 0 )
+            break;
+        pszStr += 16;
+    }
+#endif
+    for( ; pszStr < pszEnd; pszStr++ )
+    {
+        if( *pszStr == chDelimiter || *pszStr == '"' )
+            return pszStr;
+    }
+    return pszEnd;
+}
 
+/************************************************************************/
+/*                        CSVSplitLineInPlace()                         */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+/**
+ * Tokenize a CSV line into fields, without any per-field allocation.
+ *
+ * The field values are unescaped in place inside pszLine, which is thus
+ * modified, and apszTokens is filled with pointers to the start of each
+ * field, followed by a terminating NULL pointer, so that &apszTokens[0]
+ * can be used as a read-only string list as long as pszLine is alive.
+ *
+ * Unquoted parts of the line are scanned by spans rather than character by
+ * character, which makes the common case of lines with few quotes fast.
+ *
+ * @param pszLine line to split (modified).
+ * @param chDelimiter field delimiter.
+ * @param bKeepLeadingAndClosingQuotes whether opening and closing quotes of
+ *        quoted fields must be kept in the field values.
+ * @param bMergeDelimiter whether consecutive delimiters must be considered
+ *        as a single one.
+ * @param apszTokens vector receiving the field pointers. Its previous content
+ *        is discarded, but its capacity is reused.
+ * @return the number of fields.
+ * @since GDAL 2.3
+ */
+int CSVSplitLineInPlace( char *pszLine, char chDelimiter,
+                         bool bKeepLeadingAndClosingQuotes,
+                         bool bMergeDelimiter,
+                         std::vector<char *> &apszTokens )
 {
+    apszTokens.clear();
 
-    char *pszToken = static_cast<char *>( VSI_CALLOC_VERBOSE( 10, 1 ) );
-    if( pszToken == NULL )
-        return NULL;
+    const size_t nLen = strlen(pszLine);
+    char * const pszEnd = pszLine + nLen;
+    const char chLast = nLen > 0 ? pszEnd[-1] : '\0';
 
-    int nTokenMax = 10;
-    char **papszRetList = NULL;
+    // Unescaped field values are never longer than their escaped form, so
+    // they can be written back into the line, behind the read position.
+    const char *pszRead = pszLine;
+    char *pszWrite = pszLine;
 
-    while( pszString != NULL && *pszString != '\0' )
+    while( pszRead < pszEnd )
     {
+        char * const pszToken = pszWrite;
         bool bInString = false;
-        int nTokenLen = 0;
 
-        /* Try to find the next delimiter, marking end of token */
-        for( ; *pszString != '\0'; pszString++ )
+        while( pszRead < pszEnd )
         {
-
-            /* End if this is a delimiter skip it and break. */
-            if( !bInString && *pszString == chDelimiter )
+            const char *pszStop = NULL;
+            if( bInString )
             {
-                pszString++;
-                break;
+                pszStop = static_cast<const char *>(
+                    memchr(pszRead, '"', pszEnd - pszRead));
+                if( pszStop == NULL )
+                    pszStop = pszEnd;
             }
-
-            if( *pszString == '"' )
+            else
             {
-                if( !bInString || pszString[1] != '"' )
-                {
-                    bInString = !bInString;
-                    continue;
-                }
-                else  /* doubled quotes in string resolve to one quote */
-                {
-                    pszString++;
-                }
+                pszStop = CSVFindDelimiterOrQuote(pszRead, pszEnd,
+                                                  chDelimiter);
             }
 
-            if( nTokenLen >= nTokenMax-2 )
+            const size_t nSpan = pszStop - pszRead;
+            if( pszWrite != pszRead )
+                memmove(pszWrite, pszRead, nSpan);
+            pszWrite += nSpan;
+            pszRead = pszStop;
+
+            if( pszRead == pszEnd )
+                break;
+
+            if( !bInString && *pszRead == chDelimiter )
             {
-                nTokenMax = nTokenMax * 2 + 10;
-                char* pszTokenNew = static_cast<char *>(
-                    VSI_REALLOC_VERBOSE( pszToken, nTokenMax ) );
-                if( pszTokenNew == NULL )
+                pszRead++;
+                if( bMergeDelimiter )
                 {
-                    VSIFree(pszToken);
-                    CSLDestroy(papszRetList);
-                    return NULL;
+                    while( *pszRead == chDelimiter )
+                        pszRead++;
                 }
-                pszToken = pszTokenNew;
+                break;
             }
 
-            pszToken[nTokenLen] = *pszString;
-            nTokenLen++;
+            // *pszRead is a double quote.
+            if( bInString && pszRead[1] == '"' )
+            {
+                // Doubled quotes in string resolve to one quote.
+                *pszWrite++ = '"';
+                pszRead += 2;
+            }
+            else
+            {
+                bInString = !bInString;
+                if( bKeepLeadingAndClosingQuotes )
+                    *pszWrite++ = '"';
+                pszRead++;
+            }
         }
 
-        pszToken[nTokenLen] = '\0';
-        char** papszRetListNew = CSLAddStringMayFail( papszRetList, pszToken );
-        if( papszRetListNew == NULL )
-        {
-            VSIFree(pszToken);
-            CSLDestroy(papszRetList);
-            return NULL;
-        }
-        papszRetList = papszRetListNew;
+        *pszWrite = '\0';
+        pszWrite++;
+        apszTokens.push_back(pszToken);
+
+        // If the last token is an empty token, then we have to catch
+        // it now, otherwise we won't reenter the loop and it will be lost.
+        if( pszRead == pszEnd && chLast == chDelimiter )
+            apszTokens.push_back(pszEnd);
+    }
+
+    const int nTokens = static_cast<int>(apszTokens.size());
+    apszTokens.push_back(NULL);
+    return nTokens;
+}
+//! @endcond
+
+/************************************************************************/
+/*                            CSVSplitLine()                            */
+/*                                                                      */
+/*      Tokenize a CSV line into fields in the form of a string         */
+/*      list.  This is used instead of the CPLTokenizeString()          */
+/*      because it provides correct CSV escaping and quoting            */
+/*      semantics.                                                      */
+/************************************************************************/
+
+static char **CSVSplitLine( const char *pszString, char chDelimiter )
 
-        /* If the last token is an empty token, then we have to catch
-         * it now, otherwise we won't reenter the loop and it will be lost.
-         */
-        if( *pszString == '\0' && *(pszString-1) == chDelimiter )
+{
+    char *pszWorkLine = VSI_STRDUP_VERBOSE( pszString );
+    if( pszWorkLine == NULL )
+        return NULL;
+
+    std::vector<char *> apszTokens;
+    const int nTokens =
+        CSVSplitLineInPlace( pszWorkLine, chDelimiter, false, false,
+                             apszTokens );
+    if( nTokens == 0 )
+    {
+        VSIFree( pszWorkLine );
+        return NULL;
+    }
+
+    char **papszRetList = static_cast<char **>(
+        VSI_CALLOC_VERBOSE( nTokens + 1, sizeof(char *) ) );
+    if( papszRetList == NULL )
+    {
+        VSIFree( pszWorkLine );
+        return NULL;
+    }
+
+    for( int i = 0; i < nTokens; i++ )
+    {
+        papszRetList[i] = VSI_STRDUP_VERBOSE( apszTokens[i] );
+        if( papszRetList[i] == NULL )
         {
-            papszRetListNew = CSLAddStringMayFail( papszRetList, "" );
-            if( papszRetListNew == NULL )
-            {
-                VSIFree(pszToken);
-                CSLDestroy(papszRetList);
-                return NULL;
-            }
-            papszRetList = papszRetListNew;
+            CSLDestroy( papszRetList );
+            VSIFree( pszWorkLine );
+            return NULL;
         }
     }
 
-    VSIFree( pszToken );
+    VSIFree( pszWorkLine );
 
     return papszRetList;
 }
@@ -477,9 +632,9 @@ static void CSVIngest( const char *pszFilename )
     psTable->nLineCount = iLine;
 
 /* -------------------------------------------------------------------- */
-/*      Allocate and populate index array.  Ensure they are in          */
-/*      ascending order so that binary searches can be done on the      */
-/*      array.                                                          */
+/*      Allocate and populate index array.  When they are in            */
+/*      ascending order, they are used to build the hashed index on     */
+/*      the first column without splitting the lines.                   */
 /* -------------------------------------------------------------------- */
     psTable->panLineIndex = static_cast<int *>(
         VSI_MALLOC_VERBOSE( sizeof(int) * psTable->nLineCount ) );
@@ -865,56 +1020,171 @@ char **CSVScanLinesL( VSILFILE *fp, int iKeyField, const char * pszValue,
 }
 
 /************************************************************************/
-/*                        CSVScanLinesIndexed()                         */
+/*                          CSVGetIndexKey()                            */
 /*                                                                      */
-/*      Read the file scanline for lines where the key field equals     */
-/*      the indicated value with the suggested comparison criteria.     */
-/*      Return the first matching line split into fields.               */
+/*      Normalize a string key value so that values that compare        */
+/*      equal with the given criteria get the same hash key.            */
 /************************************************************************/
 
-static char **
-CSVScanLinesIndexed( CSVTable *psTable, int nKeyValue )
+static std::string CSVGetIndexKey( const char *pszValue,
+                                   CSVCompareCriteria eCriteria )
 
 {
-    CPLAssert( psTable->panLineIndex != NULL );
+    std::string osKey(pszValue);
+    if( eCriteria == CC_ApproxString )
+    {
+        for( size_t i = 0; i < osKey.size(); i++ )
+            osKey[i] = static_cast<char>(
+                tolower(static_cast<unsigned char>(osKey[i])));
+    }
+    return osKey;
+}
+
+/************************************************************************/
+/*                         CSVAddToKeyIndex()                           */
+/************************************************************************/
+
+template<class KeyType> static void
+CSVAddToKeyIndex( std::unordered_map<KeyType, CSVKeyIndexEntry>& oMap,
+                  const KeyType& oKey, int iLine )
+
+{
+    CSVKeyIndexEntry sEntry;
+    sEntry.iLine = iLine;
+    sEntry.bNonUniqueKey = false;
+    std::pair<typename std::unordered_map<KeyType,
+                                          CSVKeyIndexEntry>::iterator,
+              bool> oRes = oMap.insert(
+                  std::pair<KeyType, CSVKeyIndexEntry>(oKey, sEntry));
+    // If a key is not unique, keep the first instance of it.
+    if( !oRes.second )
+        oRes.first->second.bNonUniqueKey = true;
+}
+
+/************************************************************************/
+/*                         CSVGetKeyIndex()                             */
+/*                                                                      */
+/*      Fetch the hashed index of the ingested lines of a table on a    */
+/*      key field, building it if this is the first search on this      */
+/*      key field with this criteria.                                   */
+/************************************************************************/
+
+static CSVKeyIndex *CSVGetKeyIndex( CSVTable *psTable, int iKeyField,
+                                    CSVCompareCriteria eCriteria )
+
+{
+    for( int i = 0; i < psTable->nKeyIndexCount; i++ )
+    {
+        CSVKeyIndex *psIndex = psTable->papsKeyIndexes[i];
+        if( psIndex->iKeyField == iKeyField &&
+            psIndex->eCriteria == eCriteria )
+            return psIndex;
+    }
+
+    CSVKeyIndex **papsNewIndexes = static_cast<CSVKeyIndex **>(
+        VSI_REALLOC_VERBOSE( psTable->papsKeyIndexes,
+                             sizeof(CSVKeyIndex*) *
+                                (psTable->nKeyIndexCount + 1) ) );
+    if( papsNewIndexes == NULL )
+        return NULL;
+    psTable->papsKeyIndexes = papsNewIndexes;
+
+    CSVKeyIndex *psIndex = new CSVKeyIndex;
+    psIndex->iKeyField = iKeyField;
+    psIndex->eCriteria = eCriteria;
+    psTable->papsKeyIndexes[psTable->nKeyIndexCount++] = psIndex;
 
 /* -------------------------------------------------------------------- */
-/*      Find target record with binary search.                          */
+/*      The values of the first column have already been computed if    */
+/*      the table is sorted on it.                                      */
 /* -------------------------------------------------------------------- */
-    int iTop = psTable->nLineCount-1;
-    int iBottom = 0;
-    int iResult = -1;
+    if( iKeyField == 0 && eCriteria == CC_Integer
+        && psTable->panLineIndex != NULL )
+    {
+        psIndex->oMapInteger.reserve( psTable->nLineCount );
+        for( int iLine = 0; iLine < psTable->nLineCount; iLine++ )
+            CSVAddToKeyIndex( psIndex->oMapInteger,
+                              psTable->panLineIndex[iLine], iLine );
+        return psIndex;
+    }
 
-    while( iTop >= iBottom )
+/* -------------------------------------------------------------------- */
+/*      Otherwise split all lines once.                                 */
+/* -------------------------------------------------------------------- */
+    if( eCriteria == CC_Integer )
+        psIndex->oMapInteger.reserve( psTable->nLineCount );
+    else
+        psIndex->oMapString.reserve( psTable->nLineCount );
+
+    for( int iLine = 0; iLine < psTable->nLineCount; iLine++ )
     {
-        const int iMiddle = (iTop + iBottom) / 2;
-        if( psTable->panLineIndex[iMiddle] > nKeyValue )
-            iTop = iMiddle - 1;
-        else if( psTable->panLineIndex[iMiddle] < nKeyValue )
-            iBottom = iMiddle + 1;
-        else
+        char **papszFields = CSVSplitLine( psTable->papszLines[iLine], ',' );
+        if( CSLCount( papszFields ) >= iKeyField+1 )
         {
-            iResult = iMiddle;
-            // if a key is not unique, select the first instance of it.
-            while( iResult > 0
-                   && psTable->panLineIndex[iResult-1] == nKeyValue )
-            {
-                psTable->bNonUniqueKey = true;
-                iResult--;
-            }
-            break;
+            if( eCriteria == CC_Integer )
+                CSVAddToKeyIndex( psIndex->oMapInteger,
+                                  atoi(papszFields[iKeyField]), iLine );
+            else
+                CSVAddToKeyIndex( psIndex->oMapString,
+                                  CSVGetIndexKey(papszFields[iKeyField],
+                                                 eCriteria),
+                                  iLine );
         }
+        CSLDestroy( papszFields );
     }
 
-    if( iResult == -1 )
+    return psIndex;
+}
+
+/************************************************************************/
+/*                        CSVScanLinesIndexed()                         */
+/*                                                                      */
+/*      Find the first ingested line where the key field equals the     */
+/*      indicated value with the suggested comparison criteria, using   */
+/*      a hashed index on the key field.  Return the line split into    */
+/*      fields.                                                         */
+/************************************************************************/
+
+static char **
+CSVScanLinesIndexed( CSVTable *psTable, int iKeyField, const char * pszValue,
+                     CSVCompareCriteria eCriteria )
+
+{
+    CSVKeyIndex *psIndex = CSVGetKeyIndex( psTable, iKeyField, eCriteria );
+    if( psIndex == NULL )
         return NULL;
 
+    const CSVKeyIndexEntry *psEntry = NULL;
+    if( eCriteria == CC_Integer )
+    {
+        std::unordered_map<int, CSVKeyIndexEntry>::const_iterator oIter =
+            psIndex->oMapInteger.find( atoi(pszValue) );
+        if( oIter != psIndex->oMapInteger.end() )
+            psEntry = &(oIter->second);
+    }
+    else
+    {
+        std::unordered_map<std::string, CSVKeyIndexEntry>::const_iterator
+            oIter = psIndex->oMapString.find(
+                CSVGetIndexKey(pszValue, eCriteria) );
+        if( oIter != psIndex->oMapString.end() )
+            psEntry = &(oIter->second);
+    }
+
 /* -------------------------------------------------------------------- */
-/*      Parse target line, and update iLastLine indicator.              */
+/*      Leave iLastLine as a full scan would have done.                 */
 /* -------------------------------------------------------------------- */
-    psTable->iLastLine = iResult;
+    if( psEntry == NULL )
+    {
+        psTable->iLastLine = psTable->nLineCount - 1;
+        return NULL;
+    }
+
+    if( psEntry->bNonUniqueKey )
+        psTable->bNonUniqueKey = true;
+    psTable->iLastLine = psEntry->iLine;
 
-    return CSVSplitLine( psTable->papszLines[iResult], ',' );
+    return CSVSplitLine( psTable->papszLines[psEntry->iLine], ',' );
 }
 
 /************************************************************************/
@@ -936,11 +1206,11 @@ CSVScanLinesIngested( CSVTable *psTable, int iKeyField, const char * pszValue,
     const int nTestValue = atoi(pszValue);
 
 /* -------------------------------------------------------------------- */
-/*      Short cut for indexed files.                                    */
+/*      Use a hashed index when searching from the start of the         */
+/*      table.                                                          */
 /* -------------------------------------------------------------------- */
-    if( iKeyField == 0 && eCriteria == CC_Integer
-        && psTable->panLineIndex != NULL )
-        return CSVScanLinesIndexed( psTable, nTestValue );
+    if( psTable->iLastLine < 0 )
+        return CSVScanLinesIndexed( psTable, iKeyField, pszValue, eCriteria );
 
 /* -------------------------------------------------------------------- */
 /*      Scan from in-core lines.                                        */
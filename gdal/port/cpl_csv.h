@@ -75,4 +75,17 @@ void CPL_DLL SetCSVFilenameHook( const char *(*)(const char *) );
 
 CPL_C_END
 
+#if defined(__cplusplus) && !defined(CPL_SUPRESS_CPLUSPLUS)
+
+#include <vector>
+
+//! @cond Doxygen_Suppress
+int CPL_DLL CSVSplitLineInPlace( char *pszLine, char chDelimiter,
+                                 bool bKeepLeadingAndClosingQuotes,
+                                 bool bMergeDelimiter,
+                                 std::vector<char *> &apszTokens );
+//! @endcond
+
+#endif /* def __cplusplus && !CPL_SUPRESS_CPLUSPLUS */
+
 #endif /* ndef CPL_CSV_H_INCLUDED */
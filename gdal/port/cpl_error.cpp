@@ -37,6 +37,7 @@
 
 #include <algorithm>
 
+#include "cpl_atomic_ops.h"
 #include "cpl_config.h"
 #include "cpl_conv.h"
 #include "cpl_multiproc.h"
@@ -51,6 +52,9 @@ CPL_CVSID("$Id$");
 static CPLMutex *hErrorMutex = NULL;
 static void *pErrorHandlerUserData = NULL;
 static CPLErrorHandler pfnErrorHandler = CPLDefaultErrorHandler;
+// Whether pfnErrorHandler is CPLQuietErrorHandler. Only modified with
+// hErrorMutex held, but read atomically without it.
+static volatile int gnQuietErrorHandler = FALSE;
 static bool gbCatchDebug = true;
 
 static const int DEFAULT_LAST_ERR_MSG_SIZE =
@@ -75,11 +79,31 @@ typedef struct {
     CPLErrorHandlerNode *psHandlerStack;
     int     nLastErrMsgMax;
     int     nFailureIntoWarning;
+
+    // Cached configuration options, valid while nConfigGeneration is equal
+    // to CPLGetConfigOptionsGeneration().
+    int     nConfigGeneration;
+    int     nDebugMode;
+    bool    bAccumErrorMsg;
+    bool    bLogErrors;
+    int     nMaxRepeatedErrorReports;
+
+    // Last reported error, to detect repeated errors.
+    const char *pszRepeatedErrFmt;
+    CPLErr  eRepeatedErrType;
+    CPLErrorNum nRepeatedErrNo;
+    int     nRepeatedErrCount;
+
     char    szLastErrMsg[DEFAULT_LAST_ERR_MSG_SIZE];
     // Do not add anything here. szLastErrMsg must be the last field.
     // See CPLRealloc() below.
 } CPLErrorContext;
 
+// Values of CPLErrorContext::nDebugMode
+static const int DEBUG_MODE_OFF = 0;       // CPL_DEBUG not set
+static const int DEBUG_MODE_ALL = 1;       // CPL_DEBUG=ON or empty
+static const int DEBUG_MODE_CATEGORY = 2;  // CPL_DEBUG=list of categories
+
 static const CPLErrorContext sNoErrorContext =
 {
     0,
@@ -87,6 +111,15 @@ static const CPLErrorContext sNoErrorContext =
     NULL,
     0,
     0,
+    -1,
+    DEBUG_MODE_OFF,
+    false,
+    false,
+    0,
+    NULL,
+    CE_None,
+    0,
+    0,
     ""
 };
 
@@ -97,6 +130,15 @@ static const CPLErrorContext sWarningContext =
     NULL,
     0,
     0,
+    -1,
+    DEBUG_MODE_OFF,
+    false,
+    false,
+    0,
+    NULL,
+    CE_None,
+    0,
+    0,
     "A warning was emitted"
 };
 
@@ -107,6 +149,15 @@ static const CPLErrorContext sFailureContext =
     NULL,
     0,
     0,
+    -1,
+    DEBUG_MODE_OFF,
+    false,
+    false,
+    0,
+    NULL,
+    CE_None,
+    0,
+    0,
     "A failure was emitted"
 };
 
@@ -139,12 +190,103 @@ static CPLErrorContext *CPLGetErrorContext()
         }
         psCtx->eLastErrType = CE_None;
         psCtx->nLastErrMsgMax = sizeof(psCtx->szLastErrMsg);
+        psCtx->nConfigGeneration = -1;
         CPLSetTLS( CTLS_ERRORCONTEXT, psCtx, TRUE );
     }
 
     return psCtx;
 }
 
+/************************************************************************/
+/*                      CPLErrorUpdateConfigCache()                     */
+/*                                                                      */
+/*      Fetching configuration options involves a mutex and string      */
+/*      comparisons, which is too costly to be done on each CPLError()  */
+/*      and CPLDebug() call, so do it only when they have changed.      */
+/************************************************************************/
+
+static void CPLErrorUpdateConfigCache( CPLErrorContext *psCtx )
+{
+    const int nGeneration = CPLGetConfigOptionsGeneration();
+    if( psCtx->nConfigGeneration == nGeneration )
+        return;
+    psCtx->nConfigGeneration = nGeneration;
+
+    const char *pszDebug = CPLGetConfigOption("CPL_DEBUG", NULL);
+    if( pszDebug == NULL )
+        psCtx->nDebugMode = DEBUG_MODE_OFF;
+    else if( EQUAL(pszDebug, "ON") || EQUAL(pszDebug, "") )
+        psCtx->nDebugMode = DEBUG_MODE_ALL;
+    else
+        psCtx->nDebugMode = DEBUG_MODE_CATEGORY;
+
+    psCtx->bAccumErrorMsg =
+        EQUAL(CPLGetConfigOption("CPL_ACCUM_ERROR_MSG", ""), "ON");
+    psCtx->bLogErrors = CPLGetConfigOption("CPL_LOG_ERRORS", NULL) != NULL;
+    psCtx->nMaxRepeatedErrorReports =
+        atoi(CPLGetConfigOption("CPL_MAX_REPEATED_ERROR_REPORTS", "0"));
+}
+
+/************************************************************************/
+/*                        CPLInvokeErrorHandler()                       */
+/************************************************************************/
+
+static void CPLInvokeErrorHandler( CPLErrorContext *psCtx, CPLErr eErrClass,
+                                   CPLErrorNum err_no, const char *pszMsg )
+{
+    if( psCtx->psHandlerStack != NULL )
+    {
+        psCtx->psHandlerStack->pfnHandler(eErrClass, err_no, pszMsg);
+    }
+    else if( CPLAtomicAdd(&gnQuietErrorHandler, 0) )
+    {
+        // Nothing to do, and no need to take the mutex.
+    }
+    else
+    {
+        CPLMutexHolderD( &hErrorMutex );
+        if( pfnErrorHandler != NULL )
+            pfnErrorHandler(eErrClass, err_no, pszMsg);
+    }
+}
+
+/************************************************************************/
+/*                       CPLFlushRepeatedErrors()                       */
+/*                                                                      */
+/*      End the current run of repeated errors, and report the number   */
+/*      of them that were not passed to the error handler.  Returns     */
+/*      the error context, which may have been reallocated by the       */
+/*      handler, or NULL.                                               */
+/************************************************************************/
+
+static CPLErrorContext *CPLFlushRepeatedErrors( CPLErrorContext *psCtx )
+{
+    const int nNotReported =
+        psCtx->nRepeatedErrCount - psCtx->nMaxRepeatedErrorReports;
+    const CPLErr ePrevErrClass = psCtx->eRepeatedErrType;
+    const CPLErrorNum nPrevErrNo = psCtx->nRepeatedErrNo;
+
+    psCtx->pszRepeatedErrFmt = NULL;
+    psCtx->eRepeatedErrType = CE_None;
+    psCtx->nRepeatedErrNo = CPLE_None;
+    psCtx->nRepeatedErrCount = 0;
+
+    if( psCtx->nMaxRepeatedErrorReports <= 0 || nNotReported <= 0 )
+        return psCtx;
+
+    char szMsg[128] = {};
+    snprintf(szMsg, sizeof(szMsg),
+             "%d other message(s) similar to the previous one "
+             "were not reported.", nNotReported);
+    CPLInvokeErrorHandler(psCtx, ePrevErrClass, nPrevErrNo, szMsg);
+
+    // The handler might have emitted errors itself.
+    psCtx = CPLGetErrorContext();
+    if( psCtx == NULL || IS_PREFEFINED_ERROR_CTX(psCtx) )
+        return NULL;
+    return psCtx;
+}
+
 /************************************************************************/
 /*                         CPLGetErrorHandlerUserData()                 */
 /************************************************************************/
@@ -201,6 +343,15 @@ void* CPL_STDCALL CPLGetErrorHandlerUserData(void)
  * handler choose to handle an error, the error number, and message will
  * be stored for recovery with CPLGetLastErrorNo() and CPLGetLastErrorMsg().
  *
+ * If the CPL_MAX_REPEATED_ERROR_REPORTS configuration option is set to a
+ * positive value N, only the first N consecutive errors of a thread that
+ * share the same class, number and format string are passed to the error
+ * handler (the error state is still updated for all of them). The number
+ * of errors that were not reported is passed to the error handler when a
+ * different error is emitted, when CPLErrorReset() is called, or when an
+ * error handler is pushed or popped. This is useful when processing large datasets
+ * where a driver emits the same warning for each feature. (GDAL >= 2.3)
+ *
  * @param eErrClass one of CE_Warning, CE_Failure or CE_Fatal.
  * @param err_no the error number (CPLE_*) from cpl_error.h.
  * @param fmt a printf() style format string.  Any additional arguments
@@ -262,6 +413,38 @@ void CPLErrorV( CPLErr eErrClass, CPLErrorNum err_no, const char *fmt,
     if( psCtx->nFailureIntoWarning > 0 && eErrClass == CE_Failure )
         eErrClass = CE_Warning;
 
+    CPLErrorUpdateConfigCache(psCtx);
+
+/* -------------------------------------------------------------------- */
+/*      If CPL_MAX_REPEATED_ERROR_REPORTS is set, only report the       */
+/*      first occurrences of consecutive errors emitted with the same   */
+/*      class, number and format string.  Their count is reported when  */
+/*      a different error is emitted (see CPLFlushRepeatedErrors()).    */
+/* -------------------------------------------------------------------- */
+    bool bSuppressed = false;
+    if( psCtx->nMaxRepeatedErrorReports > 0 && eErrClass != CE_Fatal )
+    {
+        if( fmt == psCtx->pszRepeatedErrFmt &&
+            eErrClass == psCtx->eRepeatedErrType &&
+            err_no == psCtx->nRepeatedErrNo )
+        {
+            psCtx->nRepeatedErrCount++;
+            bSuppressed =
+                psCtx->nRepeatedErrCount > psCtx->nMaxRepeatedErrorReports;
+        }
+        else
+        {
+            psCtx = CPLFlushRepeatedErrors(psCtx);
+            if( psCtx == NULL )
+                return;
+
+            psCtx->pszRepeatedErrFmt = fmt;
+            psCtx->eRepeatedErrType = eErrClass;
+            psCtx->nRepeatedErrNo = err_no;
+            psCtx->nRepeatedErrCount = 1;
+        }
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Expand the error message                                        */
 /* -------------------------------------------------------------------- */
@@ -280,8 +463,7 @@ void CPLErrorV( CPLErr eErrClass, CPLErrorNum err_no, const char *fmt,
 /*      rather than just replacing the last error message.              */
 /* -------------------------------------------------------------------- */
         int nPreviousSize = 0;
-        if( psCtx->psHandlerStack != NULL &&
-            EQUAL(CPLGetConfigOption( "CPL_ACCUM_ERROR_MSG", "" ), "ON"))
+        if( psCtx->psHandlerStack != NULL && psCtx->bAccumErrorMsg )
         {
             nPreviousSize = static_cast<int>(strlen(psCtx->szLastErrMsg));
             if( nPreviousSize )
@@ -352,23 +534,16 @@ void CPLErrorV( CPLErr eErrClass, CPLErrorNum err_no, const char *fmt,
     psCtx->nLastErrNo = err_no;
     psCtx->eLastErrType = eErrClass;
 
-    if( CPLGetConfigOption("CPL_LOG_ERRORS", NULL) != NULL )
+    if( bSuppressed )
+        return;
+
+    if( psCtx->bLogErrors )
         CPLDebug( "CPLError", "%s", psCtx->szLastErrMsg );
 
 /* -------------------------------------------------------------------- */
 /*      Invoke the current error handler.                               */
 /* -------------------------------------------------------------------- */
-    if( psCtx->psHandlerStack != NULL )
-    {
-        psCtx->psHandlerStack->pfnHandler(eErrClass, err_no,
-                                          psCtx->szLastErrMsg);
-    }
-    else
-    {
-        CPLMutexHolderD( &hErrorMutex );
-        if( pfnErrorHandler != NULL )
-            pfnErrorHandler(eErrClass, err_no, psCtx->szLastErrMsg);
-    }
+    CPLInvokeErrorHandler(psCtx, eErrClass, err_no, psCtx->szLastErrMsg);
 
     if( eErrClass == CE_Fatal )
         abort();
@@ -492,16 +667,17 @@ void CPLDebug( const char * pszCategory,
     CPLErrorContext *psCtx = CPLGetErrorContext();
     if( psCtx == NULL || IS_PREFEFINED_ERROR_CTX(psCtx) )
         return;
-    const char *pszDebug = CPLGetConfigOption("CPL_DEBUG", NULL);
 
 /* -------------------------------------------------------------------- */
 /*      Does this message pass our current criteria?                    */
 /* -------------------------------------------------------------------- */
-    if( pszDebug == NULL )
+    CPLErrorUpdateConfigCache(psCtx);
+    if( psCtx->nDebugMode == DEBUG_MODE_OFF )
         return;
 
-    if( !EQUAL(pszDebug, "ON") && !EQUAL(pszDebug, "") )
+    if( psCtx->nDebugMode == DEBUG_MODE_CATEGORY )
     {
+        const char *pszDebug = CPLGetConfigOption("CPL_DEBUG", "");
         const size_t nLen = strlen(pszCategory);
 
         size_t i = 0;
@@ -662,6 +838,13 @@ void CPL_STDCALL CPLErrorReset()
         return;
     }
 
+    if( psCtx->nRepeatedErrCount > 0 )
+    {
+        psCtx = CPLFlushRepeatedErrors(psCtx);
+        if( psCtx == NULL )
+            return;
+    }
+
     psCtx->nLastErrNo = CPLE_None;
     psCtx->szLastErrMsg[0] = '\0';
     psCtx->eLastErrType = CE_None;
@@ -1010,6 +1193,10 @@ CPLSetErrorHandlerEx( CPLErrorHandler pfnErrorHandlerNew, void* pUserData )
         else
             pfnErrorHandler = pfnErrorHandlerNew;
 
+        const int bQuiet = pfnErrorHandler == CPLQuietErrorHandler;
+        CPLAtomicAdd(&gnQuietErrorHandler,
+                     bQuiet - CPLAtomicAdd(&gnQuietErrorHandler, 0));
+
         pErrorHandlerUserData = pUserData;
     }
 
@@ -1115,6 +1302,14 @@ void CPL_STDCALL CPLPushErrorHandlerEx( CPLErrorHandler pfnErrorHandlerNew,
         return;
     }
 
+    // Report pending repeated errors to the handler that filtered them.
+    if( psCtx->nRepeatedErrCount > 0 )
+    {
+        psCtx = CPLFlushRepeatedErrors(psCtx);
+        if( psCtx == NULL )
+            return;
+    }
+
     CPLErrorHandlerNode *psNode = static_cast<CPLErrorHandlerNode *>(
         CPLMalloc( sizeof(CPLErrorHandlerNode) ) );
     psNode->psNext = psCtx->psHandlerStack;
@@ -1148,6 +1343,14 @@ void CPL_STDCALL CPLPopErrorHandler()
         return;
     }
 
+    // Report pending repeated errors to the handler that filtered them.
+    if( psCtx->nRepeatedErrCount > 0 )
+    {
+        psCtx = CPLFlushRepeatedErrors(psCtx);
+        if( psCtx == NULL )
+            return;
+    }
+
     if( psCtx->psHandlerStack != NULL )
     {
         CPLErrorHandlerNode     *psNode = psCtx->psHandlerStack;
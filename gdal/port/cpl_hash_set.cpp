@@ -33,35 +33,58 @@
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
-#include "cpl_list.h"
 
 CPL_CVSID("$Id$");
 
+/*
+ * The hash set uses open addressing with linear probing: elements are
+ * stored directly in a power-of-two sized array of buckets, together with
+ * their (scrambled) hash value, so that no allocation is done per inserted
+ * element and that probing is cache friendly. Removal shifts back the
+ * following elements of the probe sequence instead of leaving tombstones.
+ */
+
+typedef struct
+{
+    /* Scrambled hash value of the element, or 0 for an empty bucket */
+    unsigned long nHash;
+    void         *pData;
+} CPLHashSetBucket;
+
 struct _CPLHashSet
 {
     CPLHashSetHashFunc    fnHashFunc;
     CPLHashSetEqualFunc   fnEqualFunc;
     CPLHashSetFreeEltFunc fnFreeEltFunc;
-    CPLList**             tabList;
+    CPLHashSetBucket*     pasBuckets;
     int                   nSize;
-    int                   nIndiceAllocatedSize;
     int                   nAllocatedSize;
-    CPLList              *psRecyclingList;
-    int                   nRecyclingListSize;
     bool                  bRehash;
-#ifdef HASH_DEBUG
-    int                   nCollisions;
-#endif
 };
 
-static const int anPrimes[] =
+static const int MIN_ALLOCATED_SIZE = 64;
+static const int MAX_ALLOCATED_SIZE = 1 << 30;
+
+/************************************************************************/
+/*                       CPLHashSetScrambleHash()                       */
+/*                                                                      */
+/*      Bucket indices are taken from the low bits of the hash, so mix  */
+/*      the bits of user hash values, which are often pointers or       */
+/*      small integers.                                                 */
+/************************************************************************/
+
+static unsigned long CPLHashSetScrambleHash( unsigned long nHash )
 {
-    53, 97, 193, 389, 769, 1543, 3079, 6151,
-    12289, 24593, 49157, 98317, 196613, 393241,
-    786433, 1572869, 3145739, 6291469, 12582917,
-    25165843, 50331653, 100663319, 201326611,
-    402653189, 805306457, 1610612741
-};
+    GUIntBig nVal = static_cast<GUIntBig>(nHash);
+    nVal ^= nVal >> 33;
+    nVal *= (static_cast<GUIntBig>(0xff51afd7U) << 32) | 0xed558ccdU;
+    nVal ^= nVal >> 33;
+    nVal *= (static_cast<GUIntBig>(0xc4ceb9feU) << 32) | 0x1a85ec53U;
+    nVal ^= nVal >> 33;
+    const unsigned long nRet = static_cast<unsigned long>(nVal);
+    // 0 is reserved for empty buckets.
+    return nRet != 0 ? nRet : 1;
+}
 
 /************************************************************************/
 /*                          CPLHashSetNew()                             */
@@ -97,15 +120,10 @@ CPLHashSet* CPLHashSetNew( CPLHashSetHashFunc fnHashFunc,
     set->fnEqualFunc = fnEqualFunc ? fnEqualFunc : CPLHashSetEqualPointer;
     set->fnFreeEltFunc = fnFreeEltFunc;
     set->nSize = 0;
-    set->tabList = static_cast<CPLList**>(CPLCalloc(sizeof(CPLList*), 53));
-    set->nIndiceAllocatedSize = 0;
-    set->nAllocatedSize = 53;
-    set->psRecyclingList = NULL;
-    set->nRecyclingListSize = 0;
+    set->pasBuckets = static_cast<CPLHashSetBucket*>(
+        CPLCalloc(sizeof(CPLHashSetBucket), MIN_ALLOCATED_SIZE));
+    set->nAllocatedSize = MIN_ALLOCATED_SIZE;
     set->bRehash = false;
-#ifdef HASH_DEBUG
-    set->nCollisions = 0;
-#endif
     return set;
 }
 
@@ -129,65 +147,24 @@ int CPLHashSetSize( const CPLHashSet* set )
     return set->nSize;
 }
 
-/************************************************************************/
-/*                       CPLHashSetGetNewListElt()                      */
-/************************************************************************/
-
-static CPLList* CPLHashSetGetNewListElt( CPLHashSet* set )
-{
-    if( set->psRecyclingList )
-    {
-        CPLList* psRet = set->psRecyclingList;
-        psRet->pData = NULL;
-        set->nRecyclingListSize--;
-        set->psRecyclingList = psRet->psNext;
-        return psRet;
-    }
-
-    return static_cast<CPLList *>(CPLMalloc(sizeof(CPLList)));
-}
-
-/************************************************************************/
-/*                       CPLHashSetReturnListElt()                      */
-/************************************************************************/
-
-static void CPLHashSetReturnListElt( CPLHashSet* set, CPLList* psList )
-{
-    if( set->nRecyclingListSize < 128 )
-    {
-        psList->psNext = set->psRecyclingList;
-        set->psRecyclingList = psList;
-        set->nRecyclingListSize++;
-    }
-    else
-    {
-        CPLFree(psList);
-    }
-}
-
 /************************************************************************/
 /*                   CPLHashSetClearInternal()                          */
 /************************************************************************/
 
-static void CPLHashSetClearInternal( CPLHashSet* set, bool bFinalize )
+static void CPLHashSetClearInternal( CPLHashSet* set )
 {
     CPLAssert(set != NULL);
     for( int i = 0; i < set->nAllocatedSize; i++ )
     {
-        CPLList* cur = set->tabList[i];
-        while( cur )
+        if( set->pasBuckets[i].nHash != 0 )
         {
             if( set->fnFreeEltFunc )
-                set->fnFreeEltFunc(cur->pData);
-            CPLList* psNext = cur->psNext;
-            if( bFinalize )
-                CPLFree(cur);
-            else
-                CPLHashSetReturnListElt(set, cur);
-            cur = psNext;
+                set->fnFreeEltFunc(set->pasBuckets[i].pData);
+            set->pasBuckets[i].nHash = 0;
+            set->pasBuckets[i].pData = NULL;
         }
-        set->tabList[i] = NULL;
     }
+    set->nSize = 0;
     set->bRehash = false;
 }
 
@@ -206,9 +183,8 @@ static void CPLHashSetClearInternal( CPLHashSet* set, bool bFinalize )
 
 void CPLHashSetDestroy( CPLHashSet* set )
 {
-    CPLHashSetClearInternal(set, true);
-    CPLFree(set->tabList);
-    CPLListDestroy(set->psRecyclingList);
+    CPLHashSetClearInternal(set);
+    CPLFree(set->pasBuckets);
     CPLFree(set);
 }
 
@@ -228,15 +204,14 @@ void CPLHashSetDestroy( CPLHashSet* set )
 
 void CPLHashSetClear( CPLHashSet* set )
 {
-    CPLHashSetClearInternal(set, false);
-    set->tabList = static_cast<CPLList**>(
-        CPLRealloc(set->tabList, sizeof(CPLList*) * 53));
-    set->nIndiceAllocatedSize = 0;
-    set->nAllocatedSize = 53;
-#ifdef HASH_DEBUG
-    set->nCollisions = 0;
-#endif
-    set->nSize = 0;
+    CPLHashSetClearInternal(set);
+    if( set->nAllocatedSize != MIN_ALLOCATED_SIZE )
+    {
+        CPLFree(set->pasBuckets);
+        set->pasBuckets = static_cast<CPLHashSetBucket*>(
+            CPLCalloc(sizeof(CPLHashSetBucket), MIN_ALLOCATED_SIZE));
+        set->nAllocatedSize = MIN_ALLOCATED_SIZE;
+    }
 }
 
 /************************************************************************/
@@ -268,13 +243,10 @@ void CPLHashSetForeach( CPLHashSet* set,
 
     for( int i = 0; i < set->nAllocatedSize; i++ )
     {
-        CPLList* cur = set->tabList[i];
-        while( cur )
+        if( set->pasBuckets[i].nHash != 0 &&
+            !fnIterFunc(set->pasBuckets[i].pData, user_data) )
         {
-            if( !fnIterFunc(cur->pData, user_data) )
-                return;
-
-            cur = cur->psNext;
+            return;
         }
     }
 }
@@ -283,56 +255,102 @@ void CPLHashSetForeach( CPLHashSet* set,
 /*                        CPLHashSetRehash()                            */
 /************************************************************************/
 
-static void CPLHashSetRehash( CPLHashSet* set )
+static void CPLHashSetRehash( CPLHashSet* set, int nNewAllocatedSize )
 {
-    int nNewAllocatedSize = anPrimes[set->nIndiceAllocatedSize];
-    CPLList** newTabList = static_cast<CPLList **>(
-        CPLCalloc(sizeof(CPLList*), nNewAllocatedSize));
-#ifdef HASH_DEBUG
-    CPLDebug("CPLHASH", "hashSet=%p, nSize=%d, nCollisions=%d, "
-             "fCollisionRate=%.02f",
-             set, set->nSize, set->nCollisions,
-             set->nCollisions * 100.0 / set->nSize);
-    set->nCollisions = 0;
-#endif
+    CPLHashSetBucket* pasNewBuckets = static_cast<CPLHashSetBucket*>(
+        CPLCalloc(sizeof(CPLHashSetBucket), nNewAllocatedSize));
+    const unsigned long nNewMask =
+        static_cast<unsigned long>(nNewAllocatedSize - 1);
     for( int i = 0; i < set->nAllocatedSize; i++ )
     {
-        CPLList* cur = set->tabList[i];
-        while( cur )
-        {
-            const unsigned long nNewHashVal =
-                set->fnHashFunc(cur->pData) % nNewAllocatedSize;
-#ifdef HASH_DEBUG
-            if( newTabList[nNewHashVal] )
-                set->nCollisions++;
-#endif
-            CPLList* psNext = cur->psNext;
-            cur->psNext = newTabList[nNewHashVal];
-            newTabList[nNewHashVal] = cur;
-            cur = psNext;
-        }
+        const unsigned long nHash = set->pasBuckets[i].nHash;
+        if( nHash == 0 )
+            continue;
+        unsigned long nIdx = nHash & nNewMask;
+        while( pasNewBuckets[nIdx].nHash != 0 )
+            nIdx = (nIdx + 1) & nNewMask;
+        pasNewBuckets[nIdx] = set->pasBuckets[i];
     }
-    CPLFree(set->tabList);
-    set->tabList = newTabList;
+    CPLFree(set->pasBuckets);
+    set->pasBuckets = pasNewBuckets;
     set->nAllocatedSize = nNewAllocatedSize;
     set->bRehash = false;
 }
 
 /************************************************************************/
-/*                        CPLHashSetFindPtr()                           */
+/*                      CPLHashSetShrinkIfNeeded()                      */
 /************************************************************************/
 
-static void** CPLHashSetFindPtr( CPLHashSet* set, const void* elt )
+static void CPLHashSetShrinkIfNeeded( CPLHashSet* set )
 {
-    const unsigned long nHashVal = set->fnHashFunc(elt) % set->nAllocatedSize;
-    CPLList* cur = set->tabList[nHashVal];
-    while( cur )
+    int nNewAllocatedSize = set->nAllocatedSize;
+    while( nNewAllocatedSize > MIN_ALLOCATED_SIZE &&
+           set->nSize < nNewAllocatedSize / 8 )
     {
-        if( set->fnEqualFunc(cur->pData, elt) )
-            return &cur->pData;
-        cur = cur->psNext;
+        nNewAllocatedSize /= 2;
     }
-    return NULL;
+    if( nNewAllocatedSize != set->nAllocatedSize )
+        CPLHashSetRehash(set, nNewAllocatedSize);
+    set->bRehash = false;
+}
+
+/************************************************************************/
+/*                        CPLHashSetFindIdx()                           */
+/*                                                                      */
+/*      Return the index of the bucket of the element, or -1.           */
+/************************************************************************/
+
+static int CPLHashSetFindIdx( const CPLHashSet* set, const void* elt,
+                              unsigned long nHash )
+{
+    const unsigned long nMask =
+        static_cast<unsigned long>(set->nAllocatedSize - 1);
+    unsigned long nIdx = nHash & nMask;
+    // Bound the probing by the table size, as the table may be full when
+    // it has reached MAX_ALLOCATED_SIZE.
+    for( int i = 0; i < set->nAllocatedSize; i++ )
+    {
+        const CPLHashSetBucket* psBucket = &set->pasBuckets[nIdx];
+        if( psBucket->nHash == 0 )
+            return -1;
+        if( psBucket->nHash == nHash &&
+            set->fnEqualFunc(psBucket->pData, elt) )
+        {
+            return static_cast<int>(nIdx);
+        }
+        nIdx = (nIdx + 1) & nMask;
+    }
+    return -1;
+}
+
+/************************************************************************/
+/*                        CPLHashSetReserve()                           */
+/************************************************************************/
+
+/**
+ * Reserve room in a hash set for a number of elements.
+ *
+ * This avoids the successive rehashing of the set when a large number of
+ * elements is going to be inserted.
+ *
+ * @param set the hash set
+ * @param nElts the total number of elements the set is expected to hold.
+ *
+ * @since GDAL 2.3
+ */
+
+void CPLHashSetReserve( CPLHashSet* set, int nElts )
+{
+    CPLAssert(set != NULL);
+    int nNewAllocatedSize = set->nAllocatedSize;
+    while( nNewAllocatedSize < MAX_ALLOCATED_SIZE &&
+           static_cast<GIntBig>(nElts) * 4 >
+               static_cast<GIntBig>(nNewAllocatedSize) * 3 )
+    {
+        nNewAllocatedSize *= 2;
+    }
+    if( nNewAllocatedSize != set->nAllocatedSize )
+        CPLHashSetRehash(set, nNewAllocatedSize);
 }
 
 /************************************************************************/
@@ -355,34 +373,43 @@ static void** CPLHashSetFindPtr( CPLHashSet* set, const void* elt )
 int CPLHashSetInsert( CPLHashSet* set, void* elt )
 {
     CPLAssert(set != NULL);
-    void** pElt = CPLHashSetFindPtr(set, elt);
-    if( pElt )
+    const unsigned long nHash = CPLHashSetScrambleHash(set->fnHashFunc(elt));
+    const int nExistingIdx = CPLHashSetFindIdx(set, elt, nHash);
+    if( nExistingIdx >= 0 )
     {
+        CPLHashSetBucket* psBucket = &set->pasBuckets[nExistingIdx];
         if( set->fnFreeEltFunc )
-            set->fnFreeEltFunc(*pElt);
+            set->fnFreeEltFunc(psBucket->pData);
 
-        *pElt = elt;
+        psBucket->pData = elt;
         return FALSE;
     }
 
-    if( set->nSize >= 2 * set->nAllocatedSize / 3 ||
-        (set->bRehash && set->nIndiceAllocatedSize > 0 &&
-         set->nSize <= set->nAllocatedSize / 2) )
+    // Keep the load factor under 3/4.
+    if( static_cast<GIntBig>(set->nSize + 1) * 4 >
+            static_cast<GIntBig>(set->nAllocatedSize) * 3 &&
+        set->nAllocatedSize < MAX_ALLOCATED_SIZE )
+    {
+        CPLHashSetRehash(set, set->nAllocatedSize * 2);
+    }
+    else if( set->bRehash )
     {
-        set->nIndiceAllocatedSize++;
-        CPLHashSetRehash(set);
+        CPLHashSetShrinkIfNeeded(set);
     }
 
-    const unsigned long nHashVal = set->fnHashFunc(elt) % set->nAllocatedSize;
-#ifdef HASH_DEBUG
-    if( set->tabList[nHashVal] )
-        set->nCollisions++;
-#endif
+    if( set->nSize == set->nAllocatedSize )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory, "CPLHashSetInsert(): set is full");
+        return FALSE;
+    }
 
-    CPLList* new_elt = CPLHashSetGetNewListElt(set);
-    new_elt->pData = elt;
-    new_elt->psNext = set->tabList[nHashVal];
-    set->tabList[nHashVal] = new_elt;
+    const unsigned long nMask =
+        static_cast<unsigned long>(set->nAllocatedSize - 1);
+    unsigned long nIdx = nHash & nMask;
+    while( set->pasBuckets[nIdx].nHash != 0 )
+        nIdx = (nIdx + 1) & nMask;
+    set->pasBuckets[nIdx].nHash = nHash;
+    set->pasBuckets[nIdx].pData = elt;
     set->nSize++;
 
     return TRUE;
@@ -405,9 +432,10 @@ int CPLHashSetInsert( CPLHashSet* set, void* elt )
 void* CPLHashSetLookup( CPLHashSet* set, const void* elt )
 {
     CPLAssert(set != NULL);
-    void** pElt = CPLHashSetFindPtr(set, elt);
-    if( pElt )
-        return *pElt;
+    const int nIdx = CPLHashSetFindIdx(
+        set, elt, CPLHashSetScrambleHash(set->fnHashFunc(elt)));
+    if( nIdx >= 0 )
+        return set->pasBuckets[nIdx].pData;
 
     return NULL;
 }
@@ -421,42 +449,57 @@ bool CPLHashSetRemoveInternal( CPLHashSet* set, const void* elt,
                                bool bDeferRehash )
 {
     CPLAssert(set != NULL);
-    if( set->nIndiceAllocatedSize > 0 && set->nSize <= set->nAllocatedSize / 2 )
+    if( set->bRehash && !bDeferRehash )
+        CPLHashSetShrinkIfNeeded(set);
+
+    const int nFoundIdx = CPLHashSetFindIdx(
+        set, elt, CPLHashSetScrambleHash(set->fnHashFunc(elt)));
+    if( nFoundIdx < 0 )
+        return false;
+
+    if( set->fnFreeEltFunc )
+        set->fnFreeEltFunc(set->pasBuckets[nFoundIdx].pData);
+
+    // Shift back the following elements of the probe sequence that would
+    // not be reachable any more once the bucket is emptied. The hole is
+    // always emptied, so the loop ends even if the table was full.
+    const unsigned long nMask =
+        static_cast<unsigned long>(set->nAllocatedSize - 1);
+    unsigned long nHoleIdx = static_cast<unsigned long>(nFoundIdx);
+    set->pasBuckets[nHoleIdx].nHash = 0;
+    set->pasBuckets[nHoleIdx].pData = NULL;
+    unsigned long nIdx = nHoleIdx;
+    while( true )
     {
-        set->nIndiceAllocatedSize--;
-        if( bDeferRehash )
-            set->bRehash = true;
-        else
-            CPLHashSetRehash(set);
+        nIdx = (nIdx + 1) & nMask;
+        const unsigned long nHash = set->pasBuckets[nIdx].nHash;
+        if( nHash == 0 )
+            break;
+        const unsigned long nHomeIdx = nHash & nMask;
+        // Can the element stay where it is, i.e. is its home bucket
+        // cyclically in ]nHoleIdx, nIdx] ?
+        const bool bStay = nHoleIdx <= nIdx ?
+            (nHoleIdx < nHomeIdx && nHomeIdx <= nIdx) :
+            (nHoleIdx < nHomeIdx || nHomeIdx <= nIdx);
+        if( !bStay )
+        {
+            set->pasBuckets[nHoleIdx] = set->pasBuckets[nIdx];
+            set->pasBuckets[nIdx].nHash = 0;
+            set->pasBuckets[nIdx].pData = NULL;
+            nHoleIdx = nIdx;
+        }
     }
+    set->nSize--;
 
-    int nHashVal = static_cast<int>(set->fnHashFunc(elt) % set->nAllocatedSize);
-    CPLList* cur = set->tabList[nHashVal];
-    CPLList* prev = NULL;
-    while( cur )
+    if( set->nAllocatedSize > MIN_ALLOCATED_SIZE &&
+        set->nSize < set->nAllocatedSize / 8 )
     {
-        if( set->fnEqualFunc(cur->pData, elt) )
-        {
-            if( prev )
-                prev->psNext = cur->psNext;
-            else
-                set->tabList[nHashVal] = cur->psNext;
-
-            if( set->fnFreeEltFunc )
-                set->fnFreeEltFunc(cur->pData);
-
-            CPLHashSetReturnListElt(set, cur);
-#ifdef HASH_DEBUG
-            if( set->tabList[nHashVal] )
-                set->nCollisions--;
-#endif
-            set->nSize--;
-            return true;
-        }
-        prev = cur;
-        cur = cur->psNext;
+        if( bDeferRehash )
+            set->bRehash = true;
+        else
+            CPLHashSetShrinkIfNeeded(set);
     }
-    return false;
+    return true;
 }
 
 /************************************************************************/
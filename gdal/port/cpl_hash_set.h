@@ -42,6 +42,9 @@
  * according to a comparison function. Operations on the hash set, such as
  * insertion, removal or lookup, are supposed to be fast if an efficient
  * "hash" function is provided.
+ *
+ * Starting with GDAL 2.3, elements are stored with open addressing, so no
+ * allocation is done per inserted element.
  */
 
 CPL_C_START
@@ -75,6 +78,8 @@ void         CPL_DLL CPLHashSetClear(CPLHashSet* set);
 
 int          CPL_DLL CPLHashSetSize(const CPLHashSet* set);
 
+void         CPL_DLL CPLHashSetReserve(CPLHashSet* set, int nElts);
+
 void         CPL_DLL CPLHashSetForeach(CPLHashSet* set,
                                        CPLHashSetIterEltFunc fnIterFunc,
                                        void* user_data);
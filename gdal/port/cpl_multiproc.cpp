@@ -410,6 +410,55 @@ static void CPLCleanupTLSList( void **papTLSList )
     CPLFree( papTLSList );
 }
 
+/************************************************************************/
+/*                         CPLParseNumThreads()                         */
+/************************************************************************/
+
+/**
+ * Return the number of threads set by a string value.
+ *
+ * The value may be a number of threads, or ALL_CPUS to use the number
+ * of CPUs. The result is between 1 and 128.
+ *
+ * @param pszValue value to parse, or NULL.
+ * @param nDefault value returned when pszValue is NULL.
+ *
+ * @return the number of threads.
+ * @since GDAL 2.3
+ */
+
+int CPLParseNumThreads( const char* pszValue, int nDefault )
+
+{
+    if( pszValue == NULL )
+        return nDefault;
+    const int nThreads = EQUAL(pszValue, "ALL_CPUS") ?
+                                CPLGetNumCPUs() : atoi(pszValue);
+    return std::max(1, std::min(nThreads, 128));
+}
+
+/************************************************************************/
+/*                       CPLGetNumThreadsOption()                       */
+/************************************************************************/
+
+/**
+ * Return the number of threads set by a configuration option.
+ *
+ * The value of the option is parsed with CPLParseNumThreads().
+ *
+ * @param pszOption name of the configuration option.
+ * @param nDefault value returned when the option is not set.
+ *
+ * @return the number of threads.
+ * @since GDAL 2.3
+ */
+
+int CPLGetNumThreadsOption( const char* pszOption, int nDefault )
+
+{
+    return CPLParseNumThreads(CPLGetConfigOption(pszOption, NULL), nDefault);
+}
+
 #if defined(CPL_MULTIPROC_STUB)
 /************************************************************************/
 /* ==================================================================== */
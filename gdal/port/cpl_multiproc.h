@@ -100,6 +100,8 @@ void  CPL_DLL CPLSleep( double dfWaitInSeconds );
 const char CPL_DLL *CPLGetThreadingModel( void );
 
 int CPL_DLL CPLGetNumCPUs( void );
+int CPL_DLL CPLParseNumThreads( const char* pszValue, int nDefault );
+int CPL_DLL CPLGetNumThreadsOption( const char* pszOption, int nDefault );
 
 typedef struct _CPLLock CPLLock;
 
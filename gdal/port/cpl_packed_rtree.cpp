@@ -0,0 +1,710 @@
+/******************************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Static packed R-tree, bulk loaded from an array of rectangles.
+ * Author:   agent, <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "cpl_packed_rtree.h"
+
+#include <climits>
+#include <cstring>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_vsi.h"
+
+CPL_CVSID("$Id$");
+
+/*
+ * Layout of the tree (same as the one of the "flatbush" library):
+ * - the nItems first slots of asBoxes / anIndices are the leaves, sorted
+ *   along a Hilbert curve, whose anIndices[] is the index of the feature in
+ *   the array passed to CPLPackedRTreeCreate().
+ * - the following slots are the upper levels of the tree, from bottom to
+ *   top. For them, anIndices[] is the slot of the first child, and the node
+ *   has up to nNodeSize consecutive children within the lower level.
+ * - anLevelBounds[i] is the slot just after the last node of level i
+ *   (level 0 being the leaves). The root is the last slot.
+ */
+
+struct _CPLPackedRTree
+{
+    int                     nItems;
+    int                     nNodeSize;
+    int                     nNumNodes;
+    std::vector<int>        anLevelBounds;
+    std::vector<CPLRectObj> asBoxes;
+    std::vector<int>        anIndices;
+
+    _CPLPackedRTree() : nItems(0), nNodeSize(0), nNumNodes(0) {}
+};
+
+static const char szSignature[] = "CPLPRT01";
+static const int nSignatureSize = 8;
+
+/************************************************************************/
+/*                         CPLPackedRTreeOverlap()                      */
+/************************************************************************/
+
+static bool CPLPackedRTreeOverlap( const CPLRectObj* a, const CPLRectObj* b )
+{
+    return !(a->minx > b->maxx || a->maxx < b->minx ||
+             a->miny > b->maxy || a->maxy < b->miny);
+}
+
+/************************************************************************/
+/*                        ComputeLevelBounds()                          */
+/************************************************************************/
+
+static bool ComputeLevelBounds( CPLPackedRTree* psTree )
+{
+    psTree->anLevelBounds.clear();
+    if( psTree->nItems == 0 )
+    {
+        psTree->nNumNodes = 0;
+        return true;
+    }
+
+    GIntBig nNumNodes = psTree->nItems;
+    int n = psTree->nItems;
+    psTree->anLevelBounds.push_back(n);
+    do
+    {
+        n = (n + psTree->nNodeSize - 1) / psTree->nNodeSize;
+        nNumNodes += n;
+        if( nNumNodes > INT_MAX )
+            return false;
+        psTree->anLevelBounds.push_back(static_cast<int>(nNumNodes));
+    } while( n != 1 );
+
+    psTree->nNumNodes = static_cast<int>(nNumNodes);
+    return true;
+}
+
+/************************************************************************/
+/*                           HilbertXYToIndex()                         */
+/*                                                                      */
+/*      Fast Hilbert curve index of a point of a 65536x65536 grid.      */
+/*      See https://github.com/rawrunprotected/hilbert_curves           */
+/************************************************************************/
+
+static GUInt32 HilbertXYToIndex( GUInt32 x, GUInt32 y )
+{
+    GUInt32 a = x ^ y;
+    GUInt32 b = 0xFFFF ^ a;
+    GUInt32 c = 0xFFFF ^ (x | y);
+    GUInt32 d = x & (y ^ 0xFFFF);
+
+    GUInt32 A = a | (b >> 1);
+    GUInt32 B = (a >> 1) ^ a;
+    GUInt32 C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    GUInt32 D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+    a = A; b = B; c = C; d = D;
+    A = ((a & (a >> 2)) ^ (b & (b >> 2)));
+    B = ((a & (b >> 2)) ^ (b & ((a ^ b) >> 2)));
+    C ^= ((a & (c >> 2)) ^ (b & (d >> 2)));
+    D ^= ((b & (c >> 2)) ^ ((a ^ b) & (d >> 2)));
+
+    a = A; b = B; c = C; d = D;
+    A = ((a & (a >> 4)) ^ (b & (b >> 4)));
+    B = ((a & (b >> 4)) ^ (b & ((a ^ b) >> 4)));
+    C ^= ((a & (c >> 4)) ^ (b & (d >> 4)));
+    D ^= ((b & (c >> 4)) ^ ((a ^ b) & (d >> 4)));
+
+    a = A; b = B; c = C; d = D;
+    C ^= ((a & (c >> 8)) ^ (b & (d >> 8)));
+    D ^= ((b & (c >> 8)) ^ ((a ^ b) & (d >> 8)));
+
+    a = C ^ (C >> 1);
+    b = D ^ (D >> 1);
+
+    GUInt32 i0 = x ^ y;
+    GUInt32 i1 = b | (0xFFFF ^ (i0 | a));
+
+    i0 = (i0 | (i0 << 8)) & 0x00FF00FF;
+    i0 = (i0 | (i0 << 4)) & 0x0F0F0F0F;
+    i0 = (i0 | (i0 << 2)) & 0x33333333;
+    i0 = (i0 | (i0 << 1)) & 0x55555555;
+
+    i1 = (i1 | (i1 << 8)) & 0x00FF00FF;
+    i1 = (i1 | (i1 << 4)) & 0x0F0F0F0F;
+    i1 = (i1 | (i1 << 2)) & 0x33333333;
+    i1 = (i1 | (i1 << 1)) & 0x55555555;
+
+    return (i1 << 1) | i0;
+}
+
+/************************************************************************/
+/*                         CPLPackedRTreeCreate()                       */
+/************************************************************************/
+
+/**
+ * Build a packed R-tree from an array of rectangles.
+ *
+ * The rectangles are copied, so the array can be freed once the tree is
+ * built. Features are then identified by their index in the array.
+ *
+ * @param pasRects array of nRects rectangles.
+ * @param nRects number of rectangles (may be 0).
+ * @param nNodeSize maximum number of children per node, or 0 to use
+ *                  CPL_PACKED_RTREE_DEFAULT_NODE_SIZE.
+ * @return a new tree to free with CPLPackedRTreeDestroy(), or NULL in case
+ *         of error.
+ * @since GDAL 2.3
+ */
+
+CPLPackedRTree *CPLPackedRTreeCreate( const CPLRectObj* pasRects,
+                                      int nRects,
+                                      int nNodeSize )
+{
+    if( nNodeSize == 0 )
+        nNodeSize = CPL_PACKED_RTREE_DEFAULT_NODE_SIZE;
+    if( nRects < 0 || (nRects > 0 && pasRects == NULL) ||
+        nNodeSize < 2 || nNodeSize > 65535 )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid arguments to CPLPackedRTreeCreate()");
+        return NULL;
+    }
+
+    CPLPackedRTree* psTree = new CPLPackedRTree();
+    psTree->nItems = nRects;
+    psTree->nNodeSize = nNodeSize;
+    if( !ComputeLevelBounds(psTree) )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported, "Too many rectangles");
+        delete psTree;
+        return NULL;
+    }
+    if( nRects == 0 )
+        return psTree;
+
+    try
+    {
+        psTree->asBoxes.resize(psTree->nNumNodes);
+        psTree->anIndices.resize(psTree->nNumNodes);
+
+        // Sort the rectangles along the Hilbert curve of their center.
+        CPLRectObj sExtent = pasRects[0];
+        for( int i = 1; i < nRects; i++ )
+        {
+            sExtent.minx = std::min(sExtent.minx, pasRects[i].minx);
+            sExtent.miny = std::min(sExtent.miny, pasRects[i].miny);
+            sExtent.maxx = std::max(sExtent.maxx, pasRects[i].maxx);
+            sExtent.maxy = std::max(sExtent.maxy, pasRects[i].maxy);
+        }
+        const double dfWidth = sExtent.maxx - sExtent.minx;
+        const double dfHeight = sExtent.maxy - sExtent.miny;
+        const double dfHilbertMax = 65535.0;
+
+        std::vector< std::pair<GUInt32, int> > aoSortKeys(nRects);
+        for( int i = 0; i < nRects; i++ )
+        {
+            const double dfX = dfWidth > 0 ?
+                ((pasRects[i].minx + pasRects[i].maxx) / 2 - sExtent.minx) /
+                    dfWidth * dfHilbertMax : 0.0;
+            const double dfY = dfHeight > 0 ?
+                ((pasRects[i].miny + pasRects[i].maxy) / 2 - sExtent.miny) /
+                    dfHeight * dfHilbertMax : 0.0;
+            aoSortKeys[i].first = HilbertXYToIndex(
+                static_cast<GUInt32>(std::max(0.0, std::min(dfX, dfHilbertMax))),
+                static_cast<GUInt32>(std::max(0.0, std::min(dfY, dfHilbertMax))));
+            aoSortKeys[i].second = i;
+        }
+        std::sort(aoSortKeys.begin(), aoSortKeys.end());
+
+        for( int i = 0; i < nRects; i++ )
+        {
+            psTree->asBoxes[i] = pasRects[aoSortKeys[i].second];
+            psTree->anIndices[i] = aoSortKeys[i].second;
+        }
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate packed R-tree");
+        delete psTree;
+        return NULL;
+    }
+
+    // Generate the nodes of the upper levels.
+    int iPos = 0;
+    int iNewNode = nRects;
+    for( size_t iLevel = 0; iLevel + 1 < psTree->anLevelBounds.size();
+         iLevel++ )
+    {
+        const int nEnd = psTree->anLevelBounds[iLevel];
+        while( iPos < nEnd )
+        {
+            const int iFirstChild = iPos;
+            CPLRectObj sBox = psTree->asBoxes[iPos];
+            const int nChildEnd = std::min(iPos + nNodeSize, nEnd);
+            for( iPos++; iPos < nChildEnd; iPos++ )
+            {
+                const CPLRectObj& sChild = psTree->asBoxes[iPos];
+                sBox.minx = std::min(sBox.minx, sChild.minx);
+                sBox.miny = std::min(sBox.miny, sChild.miny);
+                sBox.maxx = std::max(sBox.maxx, sChild.maxx);
+                sBox.maxy = std::max(sBox.maxy, sChild.maxy);
+            }
+            psTree->asBoxes[iNewNode] = sBox;
+            psTree->anIndices[iNewNode] = iFirstChild;
+            iNewNode++;
+        }
+    }
+    CPLAssert(iNewNode == psTree->nNumNodes);
+
+    return psTree;
+}
+
+/************************************************************************/
+/*                        CPLPackedRTreeDestroy()                       */
+/************************************************************************/
+
+/**
+ * Destroy a packed R-tree.
+ *
+ * @param hTree tree to destroy (may be NULL).
+ * @since GDAL 2.3
+ */
+
+void CPLPackedRTreeDestroy( CPLPackedRTree* hTree )
+{
+    delete hTree;
+}
+
+/************************************************************************/
+/*                    CPLPackedRTreeGetFeatureCount()                   */
+/************************************************************************/
+
+/**
+ * Return the number of features indexed by the tree.
+ *
+ * @param hTree the tree.
+ * @since GDAL 2.3
+ */
+
+int CPLPackedRTreeGetFeatureCount( const CPLPackedRTree* hTree )
+{
+    return hTree->nItems;
+}
+
+/************************************************************************/
+/*                       CPLPackedRTreeGetExtent()                      */
+/************************************************************************/
+
+/**
+ * Return the extent of all the features indexed by the tree.
+ *
+ * The extent is set to all zeros if the tree is empty.
+ *
+ * @param hTree the tree.
+ * @param psExtent extent to fill.
+ * @since GDAL 2.3
+ */
+
+void CPLPackedRTreeGetExtent( const CPLPackedRTree* hTree,
+                              CPLRectObj* psExtent )
+{
+    if( hTree->nNumNodes == 0 )
+        memset(psExtent, 0, sizeof(CPLRectObj));
+    else
+        *psExtent = hTree->asBoxes[hTree->nNumNodes - 1];
+}
+
+/************************************************************************/
+/*                        CPLPackedRTreeSearch()                        */
+/************************************************************************/
+
+static void CPLPackedRTreeSearchInternal( const CPLPackedRTree* hTree,
+                                          const CPLRectObj* pAoi,
+                                          std::vector<int>& anStack,
+                                          std::vector<int>& anResults )
+{
+    if( hTree->nNumNodes == 0 )
+        return;
+
+    const std::vector<int>& anLevelBounds = hTree->anLevelBounds;
+    anStack.clear();
+    int iNode = hTree->nNumNodes - 1;
+    size_t iLevel = anLevelBounds.size() - 1;
+    while( true )
+    {
+        // Find the upper bound of the level of the node.
+        while( iLevel > 0 && anLevelBounds[iLevel - 1] > iNode )
+            iLevel--;
+        while( anLevelBounds[iLevel] <= iNode )
+            iLevel++;
+        const int nEnd = std::min(iNode + hTree->nNodeSize,
+                                  anLevelBounds[iLevel]);
+        const bool bLeaves = iNode < hTree->nItems;
+        for( int iPos = iNode; iPos < nEnd; iPos++ )
+        {
+            if( !CPLPackedRTreeOverlap(&hTree->asBoxes[iPos], pAoi) )
+                continue;
+            if( bLeaves )
+                anResults.push_back(hTree->anIndices[iPos]);
+            else
+                anStack.push_back(hTree->anIndices[iPos]);
+        }
+        if( anStack.empty() )
+            break;
+        iNode = anStack.back();
+        anStack.pop_back();
+    }
+}
+
+/**
+ * Search the features whose rectangle intersects an area of interest.
+ *
+ * Rectangles that only touch the area of interest are also returned, as
+ * with CPLQuadTreeSearch().
+ *
+ * @param hTree the tree.
+ * @param pAoi the area of interest.
+ * @param pnFeatureCount pointer to the number of returned features.
+ * @return an array of feature indices, to free with CPLFree(), or NULL if
+ *         no feature intersects.
+ * @since GDAL 2.3
+ */
+
+int *CPLPackedRTreeSearch( const CPLPackedRTree* hTree,
+                           const CPLRectObj* pAoi,
+                           int* pnFeatureCount )
+{
+    std::vector<int> anStack;
+    std::vector<int> anResults;
+    CPLPackedRTreeSearchInternal(hTree, pAoi, anStack, anResults);
+
+    *pnFeatureCount = static_cast<int>(anResults.size());
+    if( anResults.empty() )
+        return NULL;
+    int* panRet = static_cast<int*>(
+        VSI_MALLOC2_VERBOSE(anResults.size(), sizeof(int)));
+    if( panRet == NULL )
+    {
+        *pnFeatureCount = 0;
+        return NULL;
+    }
+    memcpy(panRet, &anResults[0], anResults.size() * sizeof(int));
+    return panRet;
+}
+
+/************************************************************************/
+/*                      CPLPackedRTreeSearchBatch()                     */
+/************************************************************************/
+
+/**
+ * Search the features intersecting several areas of interest at once.
+ *
+ * The results are returned in a compressed layout: the features
+ * intersecting pasAois[i] are (*ppanFeatures)[(*ppanOffsets)[i]] to
+ * (*ppanFeatures)[(*ppanOffsets)[i+1]-1]. *ppanOffsets has nAois+1 values.
+ *
+ * @param hTree the tree.
+ * @param pasAois array of nAois areas of interest.
+ * @param nAois number of areas of interest.
+ * @param ppanFeatures pointer to the array of feature indices, to free with
+ *                     CPLFree().
+ * @param ppanOffsets pointer to the array of offsets, to free with
+ *                    CPLFree().
+ * @return TRUE in case of success.
+ * @since GDAL 2.3
+ */
+
+int CPLPackedRTreeSearchBatch( const CPLPackedRTree* hTree,
+                               const CPLRectObj* pasAois,
+                               int nAois,
+                               int** ppanFeatures,
+                               int** ppanOffsets )
+{
+    *ppanFeatures = NULL;
+    *ppanOffsets = NULL;
+    if( nAois < 0 )
+        return FALSE;
+
+    int* panOffsets = static_cast<int*>(
+        VSI_MALLOC2_VERBOSE(static_cast<size_t>(nAois) + 1, sizeof(int)));
+    if( panOffsets == NULL )
+        return FALSE;
+
+    // Reuse the same stack and result vector for all queries.
+    std::vector<int> anStack;
+    std::vector<int> anResults;
+    try
+    {
+        for( int i = 0; i < nAois; i++ )
+        {
+            panOffsets[i] = static_cast<int>(anResults.size());
+            CPLPackedRTreeSearchInternal(hTree, &pasAois[i], anStack,
+                                         anResults);
+            if( anResults.size() > static_cast<size_t>(INT_MAX) )
+            {
+                CPLError(CE_Failure, CPLE_NotSupported, "Too many results");
+                CPLFree(panOffsets);
+                return FALSE;
+            }
+        }
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory, "Cannot allocate results");
+        CPLFree(panOffsets);
+        return FALSE;
+    }
+    panOffsets[nAois] = static_cast<int>(anResults.size());
+
+    int* panFeatures = static_cast<int*>(
+        VSI_MALLOC2_VERBOSE(std::max(static_cast<size_t>(1), anResults.size()),
+                            sizeof(int)));
+    if( panFeatures == NULL )
+    {
+        CPLFree(panOffsets);
+        return FALSE;
+    }
+    if( !anResults.empty() )
+        memcpy(panFeatures, &anResults[0], anResults.size() * sizeof(int));
+
+    *ppanFeatures = panFeatures;
+    *ppanOffsets = panOffsets;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                           WriteInt32Array()                          */
+/************************************************************************/
+
+static bool WriteInt32Array( VSILFILE* fp, const int* panValues, size_t nCount )
+{
+#ifdef CPL_MSB
+    for( size_t i = 0; i < nCount; i++ )
+    {
+        GInt32 nVal = panValues[i];
+        CPL_LSBPTR32(&nVal);
+        if( VSIFWriteL(&nVal, sizeof(nVal), 1, fp) != 1 )
+            return false;
+    }
+    return true;
+#else
+    return VSIFWriteL(panValues, sizeof(int), nCount, fp) == nCount;
+#endif
+}
+
+/************************************************************************/
+/*                           ReadInt32Array()                           */
+/************************************************************************/
+
+static bool ReadInt32Array( VSILFILE* fp, int* panValues, size_t nCount )
+{
+    if( VSIFReadL(panValues, sizeof(int), nCount, fp) != nCount )
+        return false;
+#ifdef CPL_MSB
+    for( size_t i = 0; i < nCount; i++ )
+        CPL_LSBPTR32(&panValues[i]);
+#endif
+    return true;
+}
+
+/************************************************************************/
+/*                          CPLPackedRTreeSave()                        */
+/************************************************************************/
+
+/**
+ * Save a packed R-tree to a file.
+ *
+ * The file is made of a signature, the number of features, the node size,
+ * the number of nodes, the number of levels and the level bounds, as little
+ * endian 32 bit integers, followed by the rectangles of all nodes (4 little
+ * endian doubles each) and their indices (little endian 32 bit integers).
+ *
+ * @param hTree the tree.
+ * @param pszFilename the filename (may be any VSI filename).
+ * @return TRUE in case of success.
+ * @since GDAL 2.3
+ */
+
+int CPLPackedRTreeSave( const CPLPackedRTree* hTree, const char* pszFilename )
+{
+    VSILFILE* fp = VSIFOpenL(pszFilename, "wb");
+    if( fp == NULL )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s", pszFilename);
+        return FALSE;
+    }
+
+    bool bOK = VSIFWriteL(szSignature, nSignatureSize, 1, fp) == 1;
+    const int anHeader[4] = {
+        hTree->nItems, hTree->nNodeSize, hTree->nNumNodes,
+        static_cast<int>(hTree->anLevelBounds.size()) };
+    bOK &= WriteInt32Array(fp, anHeader, 4);
+    if( !hTree->anLevelBounds.empty() )
+    {
+        bOK &= WriteInt32Array(fp, &hTree->anLevelBounds[0],
+                               hTree->anLevelBounds.size());
+    }
+    if( hTree->nNumNodes > 0 )
+    {
+#ifdef CPL_MSB
+        for( int i = 0; bOK && i < hTree->nNumNodes; i++ )
+        {
+            double adfBox[4] = { hTree->asBoxes[i].minx,
+                                 hTree->asBoxes[i].miny,
+                                 hTree->asBoxes[i].maxx,
+                                 hTree->asBoxes[i].maxy };
+            for( int j = 0; j < 4; j++ )
+                CPL_LSBPTR64(&adfBox[j]);
+            bOK &= VSIFWriteL(adfBox, sizeof(adfBox), 1, fp) == 1;
+        }
+#else
+        bOK &= VSIFWriteL(&hTree->asBoxes[0], sizeof(CPLRectObj),
+                          hTree->nNumNodes, fp) ==
+               static_cast<size_t>(hTree->nNumNodes);
+#endif
+        bOK &= WriteInt32Array(fp, &hTree->anIndices[0], hTree->nNumNodes);
+    }
+    bOK &= VSIFCloseL(fp) == 0;
+
+    if( !bOK )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot write %s", pszFilename);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                          CPLPackedRTreeLoad()                        */
+/************************************************************************/
+
+/**
+ * Load a packed R-tree saved with CPLPackedRTreeSave().
+ *
+ * @param pszFilename the filename (may be any VSI filename).
+ * @return a new tree to free with CPLPackedRTreeDestroy(), or NULL in case
+ *         of error.
+ * @since GDAL 2.3
+ */
+
+CPLPackedRTree *CPLPackedRTreeLoad( const char* pszFilename )
+{
+    VSILFILE* fp = VSIFOpenL(pszFilename, "rb");
+    if( fp == NULL )
+    {
+        CPLError(CE_Failure, CPLE_OpenFailed, "Cannot open %s", pszFilename);
+        return NULL;
+    }
+
+    char szReadSignature[nSignatureSize] = { 0 };
+    int anHeader[4] = { 0, 0, 0, 0 };
+    if( VSIFReadL(szReadSignature, nSignatureSize, 1, fp) != 1 ||
+        memcmp(szReadSignature, szSignature, nSignatureSize) != 0 ||
+        !ReadInt32Array(fp, anHeader, 4) )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "%s is not a packed R-tree file", pszFilename);
+        VSIFCloseL(fp);
+        return NULL;
+    }
+
+    CPLPackedRTree* psTree = new CPLPackedRTree();
+    psTree->nItems = anHeader[0];
+    psTree->nNodeSize = anHeader[1];
+    bool bOK = psTree->nItems >= 0 && psTree->nNodeSize >= 2 &&
+               psTree->nNodeSize <= 65535 && ComputeLevelBounds(psTree) &&
+               psTree->nNumNodes == anHeader[2] &&
+               static_cast<int>(psTree->anLevelBounds.size()) == anHeader[3];
+
+    // Check the counts of the header against the file size before
+    // allocating anything from them.
+    if( bOK )
+    {
+        const vsi_l_offset nHeaderEnd = VSIFTellL(fp);
+        const vsi_l_offset nExpectedSize =
+            nHeaderEnd +
+            static_cast<vsi_l_offset>(psTree->anLevelBounds.size()) *
+                sizeof(int) +
+            static_cast<vsi_l_offset>(psTree->nNumNodes) *
+                (sizeof(CPLRectObj) + sizeof(int));
+        bOK = VSIFSeekL(fp, 0, SEEK_END) == 0 &&
+              VSIFTellL(fp) >= nExpectedSize &&
+              VSIFSeekL(fp, nHeaderEnd, SEEK_SET) == 0;
+    }
+
+    if( bOK && psTree->nNumNodes > 0 )
+    {
+        try
+        {
+            std::vector<int> anLevelBounds(psTree->anLevelBounds.size());
+            psTree->asBoxes.resize(psTree->nNumNodes);
+            psTree->anIndices.resize(psTree->nNumNodes);
+            bOK = ReadInt32Array(fp, &anLevelBounds[0], anLevelBounds.size()) &&
+                  anLevelBounds == psTree->anLevelBounds &&
+                  VSIFReadL(&psTree->asBoxes[0], sizeof(CPLRectObj),
+                            psTree->nNumNodes, fp) ==
+                      static_cast<size_t>(psTree->nNumNodes) &&
+                  ReadInt32Array(fp, &psTree->anIndices[0], psTree->nNumNodes);
+        }
+        catch( const std::bad_alloc& )
+        {
+            bOK = false;
+        }
+    }
+
+    if( bOK )
+    {
+#ifdef CPL_MSB
+        for( int i = 0; i < psTree->nNumNodes; i++ )
+        {
+            CPL_LSBPTR64(&psTree->asBoxes[i].minx);
+            CPL_LSBPTR64(&psTree->asBoxes[i].miny);
+            CPL_LSBPTR64(&psTree->asBoxes[i].maxx);
+            CPL_LSBPTR64(&psTree->asBoxes[i].maxy);
+        }
+#endif
+        // Check that indices cannot lead to out of bounds accesses.
+        for( int i = 0; bOK && i < psTree->nNumNodes; i++ )
+        {
+            const int nIdx = psTree->anIndices[i];
+            bOK = nIdx >= 0 &&
+                  nIdx < (i < psTree->nItems ? psTree->nItems : i);
+        }
+    }
+    VSIFCloseL(fp);
+
+    if( !bOK )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "%s is a corrupted packed R-tree file", pszFilename);
+        delete psTree;
+        return NULL;
+    }
+    return psTree;
+}
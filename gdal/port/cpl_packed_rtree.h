@@ -0,0 +1,86 @@
+/******************************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Static packed R-tree, bulk loaded from an array of rectangles.
+ * Author:   agent, <agent at local>
+ *
+ ******************************************************************************
+ * Copyright (c) 2026, agent <agent at local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef CPL_PACKED_RTREE_H_INCLUDED
+#define CPL_PACKED_RTREE_H_INCLUDED
+
+#include "cpl_port.h"
+#include "cpl_quad_tree.h"
+
+/**
+ * \file cpl_packed_rtree.h
+ *
+ * Static packed R-tree implementation.
+ *
+ * Contrary to the quad tree of cpl_quad_tree.h, the packed R-tree cannot be
+ * modified once built. All the rectangles are known at creation time, sorted
+ * along a Hilbert curve and packed bottom-up into nodes that are stored in a
+ * single flat array. This makes building and querying much faster than
+ * inserting features one at a time, and the tree can be saved to and loaded
+ * back from disk without any processing.
+ *
+ * Features are identified by their index in the array of rectangles passed
+ * at creation time.
+ *
+ * @since GDAL 2.3
+ */
+
+CPL_C_START
+
+/** Opaque type for a packed R-tree */
+typedef struct _CPLPackedRTree CPLPackedRTree;
+
+/** Default maximum number of children of a node */
+#define CPL_PACKED_RTREE_DEFAULT_NODE_SIZE 16
+
+CPLPackedRTree CPL_DLL *CPLPackedRTreeCreate( const CPLRectObj* pasRects,
+                                              int nRects,
+                                              int nNodeSize );
+void           CPL_DLL  CPLPackedRTreeDestroy( CPLPackedRTree* hTree );
+
+int            CPL_DLL  CPLPackedRTreeGetFeatureCount(
+                                              const CPLPackedRTree* hTree );
+void           CPL_DLL  CPLPackedRTreeGetExtent( const CPLPackedRTree* hTree,
+                                                 CPLRectObj* psExtent );
+
+int            CPL_DLL *CPLPackedRTreeSearch( const CPLPackedRTree* hTree,
+                                              const CPLRectObj* pAoi,
+                                              int* pnFeatureCount );
+int            CPL_DLL  CPLPackedRTreeSearchBatch( const CPLPackedRTree* hTree,
+                                                   const CPLRectObj* pasAois,
+                                                   int nAois,
+                                                   int** ppanFeatures,
+                                                   int** ppanOffsets );
+
+int            CPL_DLL  CPLPackedRTreeSave( const CPLPackedRTree* hTree,
+                                            const char* pszFilename );
+CPLPackedRTree CPL_DLL *CPLPackedRTreeLoad( const char* pszFilename );
+
+CPL_C_END
+
+#endif /* CPL_PACKED_RTREE_H_INCLUDED */
@@ -40,6 +40,7 @@
 #include "cpl_multiproc.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
@@ -150,6 +151,7 @@ class VSIArchiveEntryFileOffset
 {
     public:
         virtual ~VSIArchiveEntryFileOffset();
+        virtual VSIArchiveEntryFileOffset* Clone() const = 0;
 };
 
 typedef struct
@@ -168,6 +170,9 @@ public:
     vsi_l_offset nFileSize;
     int nEntries;
     VSIArchiveEntry* entries;
+    /* Maps a stripped file name to its index in entries. Only used for */
+    /* exact lookups, so a hash map is enough. */
+    std::unordered_map<std::string, int> oMapFileNameToIdx;
 
     VSIArchiveContent() : mTime(0), nFileSize(0), nEntries(0), entries(NULL) {}
     ~VSIArchiveContent();
@@ -200,6 +205,19 @@ protected:
     virtual std::vector<CPLString> GetExtensions() = 0;
     virtual VSIArchiveReader* CreateReader(const char* pszArchiveFileName) = 0;
 
+    /* Hooks used by the optional persistent index of archive content. */
+    /* An empty string means that the offset cannot be serialized. */
+    virtual CPLString SerializeFileOffset(
+        const VSIArchiveEntryFileOffset* /* pOffset */ ) { return CPLString(); }
+    virtual VSIArchiveEntryFileOffset* DeserializeFileOffset(
+        const char* /* pszOffset */ ) { return NULL; }
+
+    CPLString GetIndexFilename( const char* archiveFilename );
+    VSIArchiveContent* LoadIndex( const char* archiveFilename,
+                                  const VSIStatBufL& sStat );
+    void SaveIndex( const char* archiveFilename,
+                    const VSIArchiveContent* content );
+
 public:
     VSIArchiveFilesystemHandler();
     virtual ~VSIArchiveFilesystemHandler();
@@ -214,7 +232,7 @@ public:
     virtual const VSIArchiveContent* GetContentOfArchive(const char* archiveFilename, VSIArchiveReader* poReader = NULL);
     virtual char* SplitFilename(const char *pszFilename, CPLString &osFileInArchive, int bCheckMainFileExists);
     virtual VSIArchiveReader* OpenArchiveFile(const char* archiveFilename, const char* fileInArchiveName);
-    virtual int FindFileInArchive(const char* archiveFilename, const char* fileInArchiveName, const VSIArchiveEntry** archiveEntry);
+    virtual int FindFileInArchive(const char* archiveFilename, const char* fileInArchiveName, VSIArchiveEntry* psEntryCopy);
 };
 
 #endif /* #ifndef DOXYGEN_SKIP */
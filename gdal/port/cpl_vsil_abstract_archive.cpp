@@ -37,12 +37,14 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
+#include "cpl_sha256.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 
@@ -149,6 +151,230 @@ static CPLString GetStrippedFilename(const CPLString& osFileName,
     return osRet;
 }
 
+/************************************************************************/
+/*                          GetIndexFilename()                          */
+/*                                                                      */
+/*      Return the name of the file in which the index of the content   */
+/*      of the archive is persisted, or an empty string if persistent   */
+/*      indexes are not enabled through CPL_VSIL_ARCHIVE_INDEX_DIR.     */
+/************************************************************************/
+
+CPLString VSIArchiveFilesystemHandler::GetIndexFilename(
+    const char* archiveFilename )
+{
+    const char* pszIndexDir =
+        CPLGetConfigOption("CPL_VSIL_ARCHIVE_INDEX_DIR", NULL);
+    if( pszIndexDir == NULL || pszIndexDir[0] == '\0' )
+        return CPLString();
+
+    // Key the index on the handler prefix and the archive name, so that
+    // /vsizip/ and /vsitar/ never share an index file.
+    CPLString osKey(GetPrefix());
+    osKey += "/";
+    osKey += archiveFilename;
+    GByte abyHash[CPL_SHA256_HASH_SIZE];
+    CPL_SHA256(osKey.c_str(), osKey.size(), abyHash);
+
+    CPLString osHash;
+    for( int i = 0; i < CPL_SHA256_HASH_SIZE; i++ )
+        osHash += CPLSPrintf("%02x", abyHash[i]);
+
+    return CPLFormFilename(pszIndexDir, osHash, "idx");
+}
+
+/************************************************************************/
+/*                             LoadIndex()                              */
+/*                                                                      */
+/*      The index is a text file with a header made of a signature,    */
+/*      the archive filename, its size, its modification time and the  */
+/*      number of entries, followed by one line per entry with the      */
+/*      format "is_dir size mtime serialized_offset filename".          */
+/************************************************************************/
+
+VSIArchiveContent* VSIArchiveFilesystemHandler::LoadIndex(
+    const char* archiveFilename, const VSIStatBufL& sStat )
+{
+    const CPLString osIndexFilename(GetIndexFilename(archiveFilename));
+    if( osIndexFilename.empty() )
+        return NULL;
+
+    VSILFILE* fp = VSIFOpenL(osIndexFilename, "rb");
+    if( fp == NULL )
+        return NULL;
+
+    const char* pszLine = CPLReadLineL(fp);
+    if( pszLine == NULL || strcmp(pszLine, "GDAL_VSIARCHIVE_INDEX 1") != 0 )
+    {
+        VSIFCloseL(fp);
+        return NULL;
+    }
+    pszLine = CPLReadLineL(fp);
+    if( pszLine == NULL || strcmp(pszLine, archiveFilename) != 0 )
+    {
+        VSIFCloseL(fp);
+        return NULL;
+    }
+    pszLine = CPLReadLineL(fp);
+    if( pszLine == NULL ||
+        CPLScanUIntBig(pszLine, static_cast<int>(strlen(pszLine))) !=
+            static_cast<GUIntBig>(sStat.st_size) )
+    {
+        VSIFCloseL(fp);
+        return NULL;
+    }
+    pszLine = CPLReadLineL(fp);
+    if( pszLine == NULL ||
+        CPLAtoGIntBig(pszLine) != static_cast<GIntBig>(sStat.st_mtime) )
+    {
+        CPLDebug("VSIArchive", "Index %s is outdated",
+                 osIndexFilename.c_str());
+        VSIFCloseL(fp);
+        return NULL;
+    }
+    pszLine = CPLReadLineL(fp);
+    const int nEntries = pszLine ? atoi(pszLine) : -1;
+    if( nEntries <= 0 || nEntries > 100 * 1000 * 1000 )
+    {
+        VSIFCloseL(fp);
+        return NULL;
+    }
+
+    VSIArchiveContent* content = new VSIArchiveContent;
+    content->mTime = sStat.st_mtime;
+    content->nFileSize = static_cast<vsi_l_offset>(sStat.st_size);
+    content->entries = static_cast<VSIArchiveEntry *>(
+        VSI_CALLOC_VERBOSE(nEntries, sizeof(VSIArchiveEntry)));
+    if( content->entries == NULL )
+    {
+        delete content;
+        VSIFCloseL(fp);
+        return NULL;
+    }
+
+    bool bOK = true;
+    for( int i = 0; bOK && i < nEntries; i++ )
+    {
+        pszLine = CPLReadLineL(fp);
+        char** papszTokens =
+            pszLine ? CSLTokenizeString2(pszLine, " ", 0) : NULL;
+        if( CSLCount(papszTokens) < 5 )
+        {
+            bOK = false;
+        }
+        else
+        {
+            // The filename is what remains after the 4 first tokens, and
+            // may itself contain spaces.
+            const char* pszFilename = pszLine;
+            for( int iToken = 0; iToken < 4; iToken++ )
+            {
+                pszFilename = strchr(pszFilename, ' ');
+                pszFilename++;
+            }
+
+            VSIArchiveEntry* entry = &content->entries[i];
+            entry->bIsDir = atoi(papszTokens[0]);
+            entry->uncompressed_size = CPLScanUIntBig(
+                papszTokens[1], static_cast<int>(strlen(papszTokens[1])));
+            entry->nModifiedTime = CPLAtoGIntBig(papszTokens[2]);
+            if( strcmp(papszTokens[3], "-") != 0 )
+            {
+                entry->file_pos = DeserializeFileOffset(papszTokens[3]);
+                if( entry->file_pos == NULL )
+                    bOK = false;
+            }
+            else if( !entry->bIsDir )
+            {
+                bOK = false;
+            }
+            entry->fileName = CPLStrdup(pszFilename);
+            content->nEntries++;
+            content->oMapFileNameToIdx[pszFilename] = i;
+        }
+        CSLDestroy(papszTokens);
+    }
+    VSIFCloseL(fp);
+
+    if( !bOK )
+    {
+        CPLDebug("VSIArchive", "Index %s is corrupted",
+                 osIndexFilename.c_str());
+        delete content;
+        return NULL;
+    }
+
+    CPLDebug("VSIArchive", "Content of %s loaded from index %s",
+             archiveFilename, osIndexFilename.c_str());
+    return content;
+}
+
+/************************************************************************/
+/*                             SaveIndex()                              */
+/************************************************************************/
+
+void VSIArchiveFilesystemHandler::SaveIndex(
+    const char* archiveFilename, const VSIArchiveContent* content )
+{
+    const CPLString osIndexFilename(GetIndexFilename(archiveFilename));
+    if( osIndexFilename.empty() || strchr(archiveFilename, '\n') != NULL )
+        return;
+
+    std::vector<CPLString> aosOffsets;
+    for( int i = 0; i < content->nEntries; i++ )
+    {
+        const VSIArchiveEntry* entry = &content->entries[i];
+        if( strchr(entry->fileName, '\n') != NULL )
+            return;
+        if( entry->file_pos == NULL )
+        {
+            aosOffsets.push_back("-");
+            continue;
+        }
+        const CPLString osOffset(SerializeFileOffset(entry->file_pos));
+        if( osOffset.empty() || osOffset.find(' ') != std::string::npos )
+            return;
+        aosOffsets.push_back(osOffset);
+    }
+
+    // Write in a temporary file first, so that concurrent processes never
+    // see a partially written index.
+    const CPLString osTmpFilename(
+        CPLSPrintf("%s." CPL_FRMT_GIB ".tmp", osIndexFilename.c_str(),
+                   CPLGetPID()));
+    VSILFILE* fp = VSIFOpenL(osTmpFilename, "wb");
+    if( fp == NULL )
+    {
+        CPLDebug("VSIArchive", "Cannot create %s", osTmpFilename.c_str());
+        return;
+    }
+
+    bool bOK = true;
+    bOK &= VSIFPrintfL(fp, "GDAL_VSIARCHIVE_INDEX 1\n") > 0;
+    bOK &= VSIFPrintfL(fp, "%s\n", archiveFilename) > 0;
+    bOK &= VSIFPrintfL(fp, CPL_FRMT_GUIB "\n",
+                       static_cast<GUIntBig>(content->nFileSize)) > 0;
+    bOK &= VSIFPrintfL(fp, CPL_FRMT_GIB "\n",
+                       static_cast<GIntBig>(content->mTime)) > 0;
+    bOK &= VSIFPrintfL(fp, "%d\n", content->nEntries) > 0;
+    for( int i = 0; bOK && i < content->nEntries; i++ )
+    {
+        const VSIArchiveEntry* entry = &content->entries[i];
+        bOK &= VSIFPrintfL(fp, "%d " CPL_FRMT_GUIB " " CPL_FRMT_GIB " %s %s\n",
+                           entry->bIsDir ? 1 : 0,
+                           static_cast<GUIntBig>(entry->uncompressed_size),
+                           entry->nModifiedTime,
+                           aosOffsets[i].c_str(),
+                           entry->fileName) > 0;
+    }
+    bOK &= VSIFCloseL(fp) == 0;
+
+    if( !bOK || VSIRename(osTmpFilename, osIndexFilename) != 0 )
+    {
+        CPLDebug("VSIArchive", "Cannot write %s", osIndexFilename.c_str());
+        VSIUnlink(osTmpFilename);
+    }
+}
+
 /************************************************************************/
 /*                       GetContentOfArchive()                          */
 /************************************************************************/
@@ -156,12 +382,13 @@ static CPLString GetStrippedFilename(const CPLString& osFileName,
 const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
     const char* archiveFilename, VSIArchiveReader* poReader )
 {
-    CPLMutexHolder oHolder( &hMutex );
-
+    // Stat the archive before taking the lock, as this may involve I/O.
     VSIStatBufL sStat;
     if( VSIStatL(archiveFilename, &sStat) != 0 )
         return NULL;
 
+    CPLMutexHolder oHolder( &hMutex );
+
     if( oFileList.find(archiveFilename) != oFileList.end() )
     {
         VSIArchiveContent* content = oFileList[archiveFilename];
@@ -180,6 +407,15 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
         }
     }
 
+    {
+        VSIArchiveContent* content = LoadIndex(archiveFilename, sStat);
+        if( content != NULL )
+        {
+            oFileList[archiveFilename] = content;
+            return content;
+        }
+    }
+
     bool bMustClose = poReader == NULL;
     if( poReader == NULL )
     {
@@ -202,7 +438,7 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
     content->entries = NULL;
     oFileList[archiveFilename] = content;
 
-    std::set<CPLString> oSet;
+    std::unordered_map<std::string, int>& oMap = content->oMapFileNameToIdx;
 
     do
     {
@@ -213,10 +449,8 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
         if( osStrippedFilename.empty() )
             continue;
 
-        if( oSet.find(osStrippedFilename) == oSet.end() )
+        if( oMap.find(osStrippedFilename) == oMap.end() )
         {
-            oSet.insert(osStrippedFilename);
-
             // Add intermediate directory structure.
             const char* pszBegin = osStrippedFilename.c_str();
             for( const char* pszIter = pszBegin; *pszIter; pszIter++ )
@@ -225,9 +459,9 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
                 {
                     char* pszStrippedFileName2 = CPLStrdup(osStrippedFilename);
                     pszStrippedFileName2[pszIter - pszBegin] = 0;
-                    if( oSet.find(pszStrippedFileName2) == oSet.end() )
+                    if( oMap.find(pszStrippedFileName2) == oMap.end() )
                     {
-                        oSet.insert(pszStrippedFileName2);
+                        oMap[pszStrippedFileName2] = content->nEntries;
 
                         content->entries = static_cast<VSIArchiveEntry *>(
                             CPLRealloc(
@@ -259,6 +493,8 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
                 }
             }
 
+            oMap[osStrippedFilename] = content->nEntries;
+
             content->entries = static_cast<VSIArchiveEntry *>(
                 CPLRealloc(content->entries,
                            sizeof(VSIArchiveEntry) * (content->nEntries + 1)));
@@ -285,33 +521,47 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
     if( bMustClose )
         delete(poReader);
 
+    SaveIndex(archiveFilename, content);
+
     return content;
 }
 
 /************************************************************************/
 /*                        FindFileInArchive()                           */
+/*                                                                      */
+/*      The cached content of the archive may be invalidated by         */
+/*      another thread as soon as hMutex is released, so the entry is   */
+/*      returned as a copy: its fileName is NULL, and its file_pos, if  */
+/*      not NULL, is a clone that must be deleted by the caller.        */
 /************************************************************************/
 
 int
 VSIArchiveFilesystemHandler::FindFileInArchive(
     const char* archiveFilename,
     const char* fileInArchiveName,
-    const VSIArchiveEntry** archiveEntry )
+    VSIArchiveEntry* psEntryCopy )
 {
     if( fileInArchiveName == NULL )
         return FALSE;
 
+    CPLMutexHolder oHolder( &hMutex );
+
     const VSIArchiveContent* content = GetContentOfArchive(archiveFilename);
     if( content )
     {
-        for( int i = 0; i < content->nEntries; i++ )
+        std::unordered_map<std::string, int>::const_iterator oIter =
+            content->oMapFileNameToIdx.find(fileInArchiveName);
+        if( oIter != content->oMapFileNameToIdx.end() )
         {
-            if( strcmp(fileInArchiveName, content->entries[i].fileName) == 0)
+            if( psEntryCopy )
             {
-                if( archiveEntry )
-                    *archiveEntry = &content->entries[i];
-                return TRUE;
+                const VSIArchiveEntry& oEntry = content->entries[oIter->second];
+                *psEntryCopy = oEntry;
+                psEntryCopy->fileName = NULL;
+                psEntryCopy->file_pos =
+                    oEntry.file_pos ? oEntry.file_pos->Clone() : NULL;
             }
+            return TRUE;
         }
     }
     return FALSE;
@@ -591,6 +841,7 @@ VSIArchiveFilesystemHandler::OpenArchiveFile( const char* archiveFilename,
             msg.Printf("Support only 1 file in archive file %s when "
                        "no explicit in-archive filename is specified",
                        archiveFilename);
+            CPLMutexHolder oHolder( &hMutex );
             const VSIArchiveContent* content =
                 GetContentOfArchive(archiveFilename, poReader);
             if( content )
@@ -615,47 +866,51 @@ VSIArchiveFilesystemHandler::OpenArchiveFile( const char* archiveFilename,
         // Optimization: instead of iterating over all files which can be
         // slow on .tar.gz files, try reading the first one first.
         // This can help if it is really huge.
+        bool bIsCached = false;
         {
             CPLMutexHolder oHolder( &hMutex );
+            bIsCached = oFileList.find(archiveFilename) != oFileList.end();
+        }
 
-            if( oFileList.find(archiveFilename) == oFileList.end() )
+        if( !bIsCached )
+        {
+            if( poReader->GotoFirstFile() == FALSE )
             {
-                if( poReader->GotoFirstFile() == FALSE )
-                {
-                    delete(poReader);
-                    return NULL;
-                }
+                delete(poReader);
+                return NULL;
+            }
 
-                const CPLString osFileName = poReader->GetFileName();
-                bool bIsDir = false;
-                const CPLString osStrippedFilename =
-                            GetStrippedFilename(osFileName, bIsDir);
-                if( !osStrippedFilename.empty() )
+            const CPLString osFileName = poReader->GetFileName();
+            bool bIsDir = false;
+            const CPLString osStrippedFilename =
+                        GetStrippedFilename(osFileName, bIsDir);
+            if( !osStrippedFilename.empty() )
+            {
+                const bool bMatch = strcmp(osStrippedFilename,
+                                           fileInArchiveName) == 0;
+                if( bMatch )
                 {
-                    const bool bMatch = strcmp(osStrippedFilename,
-                                               fileInArchiveName) == 0;
-                    if( bMatch )
+                    if( bIsDir )
                     {
-                        if( bIsDir )
-                        {
-                            delete(poReader);
-                            return NULL;
-                        }
-                        return poReader;
+                        delete(poReader);
+                        return NULL;
                     }
+                    return poReader;
                 }
             }
         }
 
-        const VSIArchiveEntry* archiveEntry = NULL;
+        VSIArchiveEntry sEntry;
         if( FindFileInArchive(archiveFilename, fileInArchiveName,
-                              &archiveEntry) == FALSE ||
-            archiveEntry->bIsDir )
+                              &sEntry) == FALSE )
         {
             delete(poReader);
             return NULL;
         }
-        if( !poReader->GotoFileOffset(archiveEntry->file_pos) )
+        const bool bOK = !sEntry.bIsDir &&
+                         poReader->GotoFileOffset(sEntry.file_pos);
+        delete sEntry.file_pos;
+        if( !bOK )
         {
             delete poReader;
             return NULL;
@@ -687,13 +942,15 @@ int VSIArchiveFilesystemHandler::Stat( const char *pszFilename,
                  archiveFilename, osFileInArchive.c_str());
 #endif
 
-        const VSIArchiveEntry* archiveEntry = NULL;
-        if( FindFileInArchive(archiveFilename, osFileInArchive, &archiveEntry) )
+        VSIArchiveEntry sEntry;
+        if( FindFileInArchive(archiveFilename, osFileInArchive, &sEntry) )
         {
+            delete sEntry.file_pos;
+
             // Patching st_size with uncompressed file size.
-            pStatBuf->st_size = archiveEntry->uncompressed_size;
-            pStatBuf->st_mtime = (time_t)archiveEntry->nModifiedTime;
-            if( archiveEntry->bIsDir )
+            pStatBuf->st_size = sEntry.uncompressed_size;
+            pStatBuf->st_mtime = (time_t)sEntry.nModifiedTime;
+            if( sEntry.bIsDir )
                 pStatBuf->st_mode = S_IFDIR;
             else
                 pStatBuf->st_mode = S_IFREG;
@@ -797,6 +1054,8 @@ char** VSIArchiveFilesystemHandler::ReadDirEx( const char *pszDirname,
 
     CPLStringList oDir;
 
+    CPLMutexHolder oHolder( &hMutex );
+
     const VSIArchiveContent* content = GetContentOfArchive(archiveFilename);
     if( !content )
     {
@@ -1820,6 +1820,11 @@ public:
             m_file_pos.pos_in_zip_directory = file_pos.pos_in_zip_directory;
             m_file_pos.num_of_file = file_pos.num_of_file;
         }
+
+        virtual VSIArchiveEntryFileOffset* Clone() const override
+        {
+            return new VSIZipEntryFileOffset(m_file_pos);
+        }
 };
 
 /************************************************************************/
@@ -1975,6 +1980,10 @@ public:
     virtual std::vector<CPLString> GetExtensions() override;
     virtual VSIArchiveReader* CreateReader( const char* pszZipFileName )
         override;
+    virtual CPLString SerializeFileOffset(
+        const VSIArchiveEntryFileOffset* pOffset ) override;
+    virtual VSIArchiveEntryFileOffset* DeserializeFileOffset(
+        const char* pszOffset ) override;
 
     virtual VSIVirtualHandle *Open( const char *pszFilename,
                                     const char *pszAccess,
@@ -2103,6 +2112,39 @@ VSIArchiveReader* VSIZipFilesystemHandler::CreateReader(
     return poReader;
 }
 
+/************************************************************************/
+/*                        SerializeFileOffset()                         */
+/************************************************************************/
+
+CPLString VSIZipFilesystemHandler::SerializeFileOffset(
+    const VSIArchiveEntryFileOffset* pOffset )
+{
+    const VSIZipEntryFileOffset* pZipEntryOffset =
+        static_cast<const VSIZipEntryFileOffset*>(pOffset);
+    return CPLString().Printf(
+        CPL_FRMT_GUIB "," CPL_FRMT_GUIB,
+        static_cast<GUIntBig>(pZipEntryOffset->m_file_pos.pos_in_zip_directory),
+        static_cast<GUIntBig>(pZipEntryOffset->m_file_pos.num_of_file));
+}
+
+/************************************************************************/
+/*                       DeserializeFileOffset()                        */
+/************************************************************************/
+
+VSIArchiveEntryFileOffset* VSIZipFilesystemHandler::DeserializeFileOffset(
+    const char* pszOffset )
+{
+    const char* pszComma = strchr(pszOffset, ',');
+    if( pszComma == NULL )
+        return NULL;
+    unz_file_pos file_pos;
+    file_pos.pos_in_zip_directory = static_cast<uLong64>(
+        CPLScanUIntBig(pszOffset, static_cast<int>(pszComma - pszOffset)));
+    file_pos.num_of_file = static_cast<uLong64>(
+        CPLScanUIntBig(pszComma + 1, static_cast<int>(strlen(pszComma + 1))));
+    return new VSIZipEntryFileOffset(file_pos);
+}
+
 /************************************************************************/
 /*                                 Open()                               */
 /************************************************************************/
@@ -2616,6 +2658,10 @@ void VSIZipWriteHandle::StartNewFile( VSIZipWriteHandle* poSubFile )
  *
  * Directory listing is available through VSIReadDir().
  *
+ * Starting with GDAL 2.3, the list of files of an archive can be persisted
+ * in the directory pointed by the CPL_VSIL_ARCHIVE_INDEX_DIR configuration
+ * option (see VSIInstallTarFileHandler()).
+ *
  * Since GDAL 1.8.0, write capabilities are available. They allow creating
  * a new zip file and adding new files to an already existing (or just created)
  * zip file. Read and write operations cannot be interleaved : the new zip must
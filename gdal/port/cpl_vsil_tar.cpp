@@ -85,6 +85,11 @@ public:
         {
         }
 #endif
+
+        virtual VSIArchiveEntryFileOffset* Clone() const override
+        {
+            return new VSITarEntryFileOffset(*this);
+        }
 };
 
 /************************************************************************/
@@ -389,6 +394,10 @@ public:
     virtual const char* GetPrefix() override { return "/vsitar"; }
     virtual std::vector<CPLString> GetExtensions() override;
     virtual VSIArchiveReader* CreateReader(const char* pszTarFileName) override;
+    virtual CPLString SerializeFileOffset(
+        const VSIArchiveEntryFileOffset* pOffset ) override;
+    virtual VSIArchiveEntryFileOffset* DeserializeFileOffset(
+        const char* pszOffset ) override;
 
     virtual VSIVirtualHandle *Open( const char *pszFilename,
                                     const char *pszAccess,
@@ -441,6 +450,38 @@ VSIArchiveReader* VSITarFilesystemHandler::CreateReader(const char* pszTarFileNa
     return poReader;
 }
 
+/************************************************************************/
+/*                        SerializeFileOffset()                         */
+/************************************************************************/
+
+CPLString VSITarFilesystemHandler::SerializeFileOffset(
+    const VSIArchiveEntryFileOffset* pOffset )
+{
+    const VSITarEntryFileOffset* pTarEntryOffset =
+        static_cast<const VSITarEntryFileOffset*>(pOffset);
+#ifdef HAVE_FUZZER_FRIENDLY_ARCHIVE
+    // Offsets of fuzzer friendly archives are not worth persisting.
+    if( !pTarEntryOffset->m_osFileName.empty() )
+        return CPLString();
+#endif
+    return CPLString().Printf(CPL_FRMT_GUIB, pTarEntryOffset->m_nOffset);
+}
+
+/************************************************************************/
+/*                       DeserializeFileOffset()                        */
+/************************************************************************/
+
+VSIArchiveEntryFileOffset* VSITarFilesystemHandler::DeserializeFileOffset(
+    const char* pszOffset )
+{
+    const GUIntBig nOffset =
+        CPLScanUIntBig(pszOffset, static_cast<int>(strlen(pszOffset)));
+    // Entries always start after a 512 byte header.
+    if( nOffset < 512 )
+        return NULL;
+    return new VSITarEntryFileOffset(nOffset);
+}
+
 /************************************************************************/
 /*                                 Open()                               */
 /************************************************************************/
@@ -532,6 +573,13 @@ VSIVirtualHandle* VSITarFilesystemHandler::Open( const char *pszFilename,
  *
  * Directory listing is available through VSIReadDir().
  *
+ * Listing the content of a big archive requires reading all its headers.
+ * Starting with GDAL 2.3, if the CPL_VSIL_ARCHIVE_INDEX_DIR configuration
+ * option is set to an existing directory, the list of files of the archive
+ * is saved there the first time it is established, and reused by later
+ * processes as long as the size and modification time of the archive are
+ * unchanged.
+ *
  * @since GDAL 1.8.0
  */
 